@@ -45,6 +45,7 @@ const char* const MEDIA_MIME_VIDEO_H265 = "video/hevc";
 const char* const MEDIA_MIME_VIDEO_MPEG4 = "video/mpeg4";
 
 const char* const MEDIA_MIME_CONTAINER_MP4 = "video/mp4";
+const char* const MEDIA_MIME_CONTAINER_MPEGTS = "video/mp2t";
 
 bool IsAudioMime(const std::string& mime)
 {
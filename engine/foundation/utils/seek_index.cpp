@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "SeekIndex"
+
+#include "foundation/utils/seek_index.h"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "securec.h"
+#include "foundation/log.h"
+#include "foundation/osal/filesystem/file_system.h"
+#include "foundation/osal/thread/scoped_lock.h"
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t MAGIC = 0x58495348;         // "HSIX" in little endian
+constexpr size_t HEAD_HASH_BYTES = 64 * 1024;  // 64 KiB: holds the headers of usual containers
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+constexpr size_t MAX_NAME_LENGTH = 64;         // 64: three 16 digit numbers, separators and suffix
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fileSize;
+    int64_t mtime;
+    uint64_t headHash;
+    uint64_t count;
+    uint64_t checksum; // over the entries
+};
+static_assert(sizeof(Header) % sizeof(int64_t) == 0, "entries must stay aligned after the header");
+static_assert(sizeof(SeekIndex::Entry) == 24, "the entry layout is part of the sidecar format"); // 24: 3 words
+
+using Entry = SeekIndex::Entry;
+
+struct Directory {
+    OSAL::Mutex mutex {};
+    std::string path {};
+};
+
+Directory& GetDirectory()
+{
+    static Directory directory;
+    return directory;
+}
+
+uint64_t HashBytes(const uint8_t* data, size_t size)
+{
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// fnv-1a over 64 bit words, entries are made of them
+uint64_t HashEntries(const Entry* entries, size_t count)
+{
+    uint64_t hash = FNV_OFFSET;
+    auto words = reinterpret_cast<const uint64_t*>(entries);
+    for (size_t i = 0; i < count * sizeof(Entry) / sizeof(uint64_t); i++) {
+        hash = (hash ^ words[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool Less(const Entry& left, const Entry& right)
+{
+    return left.track != right.track ? left.track < right.track : left.pts < right.pts;
+}
+
+const Entry* FindIn(const Entry* begin, const Entry* end, uint32_t track, int64_t pts, bool backward)
+{
+    Entry key {pts, 0, track, 0};
+    if (backward) {
+        auto it = std::upper_bound(begin, end, key, Less);
+        return (it == begin || (it - 1)->track != track) ? nullptr : it - 1;
+    }
+    auto it = std::lower_bound(begin, end, key, Less);
+    return (it == end || it->track != track) ? nullptr : it;
+}
+
+bool Contains(const Entry* begin, const Entry* end, const Entry& entry)
+{
+    auto it = std::lower_bound(begin, end, entry, Less);
+    return it != end && !Less(entry, *it);
+}
+
+std::string SidecarPath(const SeekIndex::FileIdentity& identity)
+{
+    auto& directory = GetDirectory();
+    OSAL::ScopedLock lock(directory.mutex);
+    if (directory.path.empty()) {
+        return {};
+    }
+    char name[MAX_NAME_LENGTH] = {0};
+    auto length = snprintf_s(name, sizeof(name), sizeof(name) - 1, "/%016" PRIx64 "_%016" PRIx64 "_%016" PRIx64
+                             ".hsidx", identity.size, static_cast<uint64_t>(identity.mtime), identity.headHash);
+    FALSE_RETURN_V(length > 0, {});
+    return directory.path + name;
+}
+
+// a writer of its own, so concurrent closes of the same file, even by other processes, do not share a temp file
+std::string TempPath(const std::string& path)
+{
+    static std::atomic<uint32_t> sequence {0};
+#ifdef _WIN32
+    auto pid = _getpid();
+#else
+    auto pid = getpid();
+#endif
+    return path + "." + std::to_string(pid) + "_" + std::to_string(sequence++) + ".tmp";
+}
+
+// the entries of a sidecar read into data, nullptr if it does not belong to identity or is damaged
+const Entry* Validate(const uint8_t* data, size_t size, const SeekIndex::FileIdentity& identity, size_t& count)
+{
+    Header header {};
+    FALSE_RETURN_V(size >= sizeof(Header) && memcpy_s(&header, sizeof(header), data, sizeof(Header)) == EOK, nullptr);
+    FALSE_RETURN_V_MSG_W(header.magic == MAGIC && header.version == SeekIndex::VERSION, nullptr,
+                         "unknown seek index format " PUBLIC_LOG_U32, header.version);
+    FALSE_RETURN_V_MSG_W(header.fileSize == identity.size && header.mtime == identity.mtime &&
+                         header.headHash == identity.headHash, nullptr, "seek index of another file");
+    size_t bytes = size - sizeof(Header);
+    FALSE_RETURN_V_MSG_W(bytes % sizeof(Entry) == 0 && header.count == bytes / sizeof(Entry), nullptr,
+                         "truncated seek index");
+    FALSE_RETURN_V_MSG_W(header.count <= SeekIndex::MAX_ENTRIES, nullptr, "oversized seek index");
+    auto entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    count = bytes / sizeof(Entry);
+    FALSE_RETURN_V_MSG_W(HashEntries(entries, count) == header.checksum, nullptr, "damaged seek index");
+    auto unordered = std::adjacent_find(entries, entries + count,
+                                        [](const Entry& left, const Entry& right) { return !Less(left, right); });
+    FALSE_RETURN_V_MSG_W(unordered == entries + count, nullptr, "unordered seek index");
+    return entries;
+}
+} // namespace
+
+void SeekIndex::SetDirectory(const std::string& directory)
+{
+    auto& current = GetDirectory();
+    OSAL::ScopedLock lock(current.mutex);
+    current.path = directory;
+    while (current.path.size() > 1 && current.path.back() == '/') {
+        current.path.pop_back();
+    }
+}
+
+bool SeekIndex::GetFileIdentity(const std::string& uri, FileIdentity& identity)
+{
+    const std::string scheme = "file://";
+    std::string path = uri;
+    if (path.compare(0, scheme.size(), scheme) == 0) {
+        path = path.substr(scheme.size());
+    } else if (path.find("://") != std::string::npos) {
+        return false;
+    }
+    struct stat fileStat {};
+    FALSE_RETURN_V(!path.empty() && stat(path.c_str(), &fileStat) == 0 && S_ISREG(fileStat.st_mode), false);
+    std::vector<uint8_t> head(std::min(static_cast<size_t>(fileStat.st_size), HEAD_HASH_BYTES));
+    auto file = std::fopen(path.c_str(), "rb");
+    FALSE_RETURN_V(file != nullptr, false);
+    auto read = std::fread(head.data(), 1, head.size(), file);
+    (void)std::fclose(file);
+    FALSE_RETURN_V(read == head.size(), false);
+    identity.size = static_cast<uint64_t>(fileStat.st_size);
+    identity.mtime = static_cast<int64_t>(fileStat.st_mtime);
+    identity.headHash = HashBytes(head.data(), head.size());
+    return true;
+}
+
+SeekIndex::~SeekIndex()
+{
+    Close();
+}
+
+bool SeekIndex::Open(const std::string& uri)
+{
+    Close();
+    FileIdentity identity;
+    if (!GetFileIdentity(uri, identity)) {
+        return false;
+    }
+    auto path = SidecarPath(identity);
+    if (path.empty()) {
+        return false;
+    }
+    OSAL::ScopedLock lock(mutex_);
+    identity_ = identity;
+    bound_ = true;
+    if (!Load(path)) {
+        return false;
+    }
+    MEDIA_LOG_I("loaded " PUBLIC_LOG_ZU " seek index entries from " PUBLIC_LOG_S, loadedCount_, path.c_str());
+    return true;
+}
+
+void SeekIndex::Close()
+{
+    OSAL::ScopedLock lock(mutex_);
+    if (bound_ && !added_.empty()) {
+        auto path = SidecarPath(identity_);
+        if (!path.empty() && !Save(path)) {
+            MEDIA_LOG_W("failed to save seek index " PUBLIC_LOG_S, path.c_str());
+        }
+    }
+    Unmap();
+    added_.clear();
+    identity_ = {};
+    bound_ = false;
+}
+
+void SeekIndex::Add(uint32_t track, int64_t pts, int64_t position)
+{
+    if (pts < 0 || position < 0) {
+        return;
+    }
+    OSAL::ScopedLock lock(mutex_);
+    Entry entry {pts, position, track, 0};
+    if (!bound_ || loadedCount_ + added_.size() >= MAX_ENTRIES || Contains(loaded_, loaded_ + loadedCount_, entry)) {
+        return;
+    }
+    // demuxing goes forward, so entries are mostly appended
+    auto it = std::lower_bound(added_.begin(), added_.end(), entry, Less);
+    if (it == added_.end() || Less(entry, *it)) {
+        added_.insert(it, entry);
+    }
+}
+
+bool SeekIndex::Find(uint32_t track, int64_t pts, bool backward, Entry& entry) const
+{
+    OSAL::ScopedLock lock(mutex_);
+    auto loaded = FindIn(loaded_, loaded_ + loadedCount_, track, pts, backward);
+    auto added = FindIn(added_.data(), added_.data() + added_.size(), track, pts, backward);
+    if (loaded == nullptr || added == nullptr) {
+        auto found = loaded ? loaded : added;
+        FALSE_RETURN_V(found != nullptr, false);
+        entry = *found;
+        return true;
+    }
+    // both are on the same side of pts, the closer one is the later one backward and the earlier one forward
+    entry = (Less(*loaded, *added) == backward) ? *added : *loaded;
+    return true;
+}
+
+std::vector<SeekIndex::Entry> SeekIndex::GetEntries(uint32_t track) const
+{
+    OSAL::ScopedLock lock(mutex_);
+    auto byTrack = [](const Entry& left, const Entry& right) { return left.track < right.track; };
+    Entry key {0, 0, track, 0};
+    auto loaded = std::equal_range(loaded_, loaded_ + loadedCount_, key, byTrack);
+    auto added = std::equal_range(added_.begin(), added_.end(), key, byTrack);
+    std::vector<Entry> entries;
+    entries.reserve((loaded.second - loaded.first) + (added.second - added.first));
+    std::merge(loaded.first, loaded.second, added.first, added.second, std::back_inserter(entries), Less);
+    return entries;
+}
+
+size_t SeekIndex::GetCount() const
+{
+    OSAL::ScopedLock lock(mutex_);
+    return loadedCount_ + added_.size();
+}
+
+std::string SeekIndex::GetSidecarPath() const
+{
+    OSAL::ScopedLock lock(mutex_);
+    return bound_ ? SidecarPath(identity_) : std::string();
+}
+
+bool SeekIndex::Load(const std::string& path)
+{
+#ifdef _WIN32
+    auto file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t block[4096]; // 4096: read size
+    size_t read = 0;
+    while ((read = std::fread(block, 1, sizeof(block), file)) > 0) {
+        data.insert(data.end(), block, block + read);
+    }
+    (void)std::fclose(file);
+    size_t count = 0;
+    auto entries = Validate(data.data(), data.size(), identity_, count);
+    FALSE_RETURN_V(entries != nullptr, false);
+    loadedCopy_.assign(entries, entries + count);
+    loaded_ = loadedCopy_.data();
+    loadedCount_ = count;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false; // not indexed yet
+    }
+    struct stat fileStat {};
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0 &&
+        static_cast<size_t>(fileStat.st_size) <= sizeof(Header) + MAX_ENTRIES * sizeof(Entry)) {
+        mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    (void)close(fd);
+    FALSE_RETURN_V_MSG_W(mapping != MAP_FAILED, false, "failed to map seek index " PUBLIC_LOG_S, path.c_str());
+    size_t count = 0;
+    auto entries = Validate(static_cast<const uint8_t*>(mapping), static_cast<size_t>(fileStat.st_size), identity_,
+                            count);
+    if (entries == nullptr) {
+        (void)munmap(mapping, static_cast<size_t>(fileStat.st_size));
+        return false;
+    }
+    mapping_ = mapping;
+    mappingSize_ = static_cast<size_t>(fileStat.st_size);
+    loaded_ = entries;
+    loadedCount_ = count;
+#endif
+    return true;
+}
+
+bool SeekIndex::Save(const std::string& path) const
+{
+    std::vector<Entry> entries;
+    entries.reserve(loadedCount_ + added_.size());
+    std::merge(loaded_, loaded_ + loadedCount_, added_.begin(), added_.end(), std::back_inserter(entries), Less);
+    Header header {MAGIC, VERSION, identity_.size, identity_.mtime, identity_.headHash, entries.size(),
+                   HashEntries(entries.data(), entries.size())};
+    auto directory = path.substr(0, path.rfind('/'));
+    FALSE_RETURN_V(OSAL::FileSystem::IsDirectory(directory) || OSAL::FileSystem::MakeMultipleDir(directory), false);
+    // written aside and renamed, so a reader never maps a partial sidecar
+    auto tmpPath = TempPath(path);
+    auto file = std::fopen(tmpPath.c_str(), "wb");
+    FALSE_RETURN_V(file != nullptr, false);
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(entries.data(), sizeof(Entry), entries.size(), file) == entries.size();
+    written = (std::fclose(file) == 0) && written;
+#ifdef _WIN32
+    (void)std::remove(path.c_str()); // rename does not replace there
+#endif
+    if (!written || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        (void)std::remove(tmpPath.c_str());
+        return false;
+    }
+    MEDIA_LOG_I("saved " PUBLIC_LOG_ZU " seek index entries to " PUBLIC_LOG_S, entries.size(), path.c_str());
+    return true;
+}
+
+void SeekIndex::Unmap()
+{
+#ifndef _WIN32
+    if (mapping_ != nullptr) {
+        (void)munmap(mapping_, mappingSize_);
+    }
+#endif
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    loadedCopy_.clear();
+    loaded_ = nullptr;
+    loadedCount_ = 0;
+}
+} // namespace Media
+} // namespace OHOS
@@ -16,9 +16,12 @@
 #ifndef HISTREAMER_FOUNDATION_BUFFER_POOL_H
 #define HISTREAMER_FOUNDATION_BUFFER_POOL_H
 
+#include <array>
 #include <atomic>
-#include <list>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <vector>
 #include "foundation/osal/thread/condition_variable.h"
 #include "foundation/osal/thread/mutex.h"
 #include "foundation/osal/thread/scoped_lock.h"
@@ -27,10 +30,18 @@
 
 namespace OHOS {
 namespace Media {
+/**
+ * Pool of preallocated buffers.
+ *
+ * The free buffers are kept in a lock-free stack of slots. Every slot also carries the storage of the control block
+ * of the shared_ptr it is handed out with, and the deleter of that shared_ptr pushes the slot back, so neither
+ * acquiring nor releasing a buffer allocates memory. A handed out buffer keeps the pool alive until it is released.
+ */
 template <typename T>
 class BufferPool : public std::enable_shared_from_this<BufferPool<T>> {
 public:
-    explicit BufferPool<T>(size_t poolSize) : poolSize_(poolSize), isActive_(true), allocInProgress(false)
+    explicit BufferPool<T>(size_t poolSize)
+        : poolSize_(poolSize), isActive_(true), allocInProgress(false), freeHead_(PackHead(INVALID_SLOT, 0))
     {
     }
 
@@ -59,24 +70,39 @@ public:
         if (msgSize_ == msgSize && align == align_) {
             return;
         }
+        OSAL::ScopedLock lock(mutex_);
         metaType_ = type;
         msgSize_ = msgSize;
         align_ = align;
-        freeBuffers_.clear();
-        for (size_t i = 0; i < poolSize_; ++i) {
-            auto buf = new Plugin::Buffer(type);
-            buf->AllocMemory(nullptr, msgSize);
-            freeBuffers_.emplace_back(std::unique_ptr<T>(buf));
+        // the free buffers are reallocated, the ones handed out keep their memory
+        std::vector<Slot*> slots;
+        for (Slot* slot = PopFree(); slot != nullptr; slot = PopFree()) {
+            slot->buffer.reset(NewBuffer());
+            slots.push_back(slot);
+        }
+        while (slotCount_ < poolSize_) {
+            Slot* slot = NewSlot(std::unique_ptr<T>(NewBuffer()));
+            if (slot == nullptr) {
+                break;
+            }
+            slots.push_back(slot);
+        }
+        for (auto slot : slots) {
+            PushFree(slot);
         }
     }
 
     bool Append(std::unique_ptr<T> buffer)
     {
         OSAL::ScopedLock lock(mutex_);
-        if (!isActive_ || freeBuffers_.size() >= poolSize_) {
+        if (!isActive_ || freeCount_.load() >= poolSize_) {
             return false;
         }
-        freeBuffers_.emplace_back(std::move(buffer));
+        Slot* slot = NewSlot(std::move(buffer));
+        if (slot == nullptr) {
+            return false;
+        }
+        PushFree(slot);
         cv_.NotifyOne();
         return true;
     }
@@ -90,57 +116,57 @@ public:
         isActive_ = active;
     }
 
-    void RecycleBuffer(std::unique_ptr<T> buffer) const
-    {
-        OSAL::ScopedLock lock(mutex_);
-        freeBuffers_.emplace_back(std::move(buffer));
-        cv_.NotifyOne();
-    }
-
     std::shared_ptr<T> AllocateBuffer()
     {
-        OSAL::ScopedLock lock(mutex_);
-        allocInProgress = true;
-        if (freeBuffers_.empty() && isActive_) {
-            cv_.Wait(lock, [this] { return !isActive_ || !freeBuffers_.empty(); });
+        if (!isActive_) {
+            return nullptr;
         }
-        std::shared_ptr<T> buffer;
-        if (isActive_) {
-            buffer = AllocateBufferUnprotected();
+        Slot* slot = PopFree();
+        if (slot == nullptr) {
+            OSAL::ScopedLock lock(mutex_);
+            allocInProgress = true;
+            waiters_++;
+            cv_.Wait(lock, [this, &slot] { return !isActive_ || (slot = PopFree()) != nullptr; });
+            waiters_--;
+            allocInProgress = false;
+            cvFinishAlloc_.NotifyOne();
+        }
+        if (slot != nullptr && !isActive_) {
+            Recycle(slot);
+            slot = nullptr;
         }
-        allocInProgress = false;
-        cvFinishAlloc_.NotifyOne();
-        return buffer;
+        return slot != nullptr ? Wrap(slot) : nullptr;
     }
 
     std::shared_ptr<T> AllocateBufferNonBlocking()
     {
-        OSAL::ScopedLock lock(mutex_);
-        if (freeBuffers_.empty() || !isActive_) {
+        if (!isActive_) {
             return nullptr;
         }
-        return AllocateBufferUnprotected();
+        Slot* slot = PopFree();
+        return slot != nullptr ? Wrap(slot) : nullptr;
     }
 
     std::shared_ptr<T> AllocateAppendBufferNonBlocking()
     {
-        OSAL::ScopedLock lock(mutex_);
         if (!isActive_) {
             return nullptr;
         }
-        if (freeBuffers_.empty()) {
+        Slot* slot = PopFree();
+        if (slot == nullptr) {
+            OSAL::ScopedLock lock(mutex_);
+            slot = NewSlot(std::unique_ptr<T>(NewBuffer()));
+            if (slot == nullptr) {
+                return nullptr;
+            }
             poolSize_++;
-            auto buf = new Plugin::Buffer(metaType_);
-            buf->AllocMemory(nullptr, msgSize_);
-            freeBuffers_.emplace_back(std::unique_ptr<T>(buf));
         }
-        return AllocateBufferUnprotected();
+        return Wrap(slot);
     }
 
     size_t Size() const
     {
-        OSAL::ScopedLock lock(mutex_);
-        return freeBuffers_.size();
+        return freeCount_.load();
     }
 
     size_t Capacity() const
@@ -150,24 +176,165 @@ public:
 
     bool Empty() const
     {
-        OSAL::ScopedLock lock(mutex_);
-        return freeBuffers_.empty();
+        return freeCount_.load() == 0;
     }
 
 private:
-    std::shared_ptr<T> AllocateBufferUnprotected()
-    {
-        std::weak_ptr<BufferPool<T>> weakRef(this->shared_from_this());
-        std::shared_ptr<T> sptr(freeBuffers_.front().release(), [weakRef](T* ptr) {
-            auto pool = weakRef.lock();
-            if (pool) {
-                pool->RecycleBuffer(std::unique_ptr<T>(ptr));
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+    static constexpr uint32_t SLOT_CHUNK_SIZE = 16;
+    static constexpr size_t MAX_SLOT_CHUNKS = 256;
+    // enough for a shared_ptr control block with deleter and allocator
+    static constexpr size_t CONTROL_BLOCK_SIZE = 128;
+
+    struct Slot {
+        std::unique_ptr<T> buffer {nullptr};
+        uint32_t index {INVALID_SLOT};
+        std::atomic<uint32_t> next {INVALID_SLOT};
+        std::atomic<bool> controlBlockInUse {false};
+        alignas(std::max_align_t) uint8_t controlBlock[CONTROL_BLOCK_SIZE];
+    };
+
+    /**
+     * Places the control block of a handed out shared_ptr in its slot. The storage may still be occupied when a
+     * recycled slot is handed out again, because weak_ptr outlive the buffer or the previous control block is being
+     * destroyed, the control block then falls back to the heap.
+     */
+    template <typename U>
+    struct ControlBlockAllocator {
+        using value_type = U;
+
+        template <typename V>
+        struct rebind {
+            using other = ControlBlockAllocator<V>;
+        };
+
+        ControlBlockAllocator(std::shared_ptr<BufferPool<T>> owner, Slot* recycledSlot)
+            : pool(std::move(owner)), slot(recycledSlot)
+        {
+        }
+
+        template <typename V>
+        ControlBlockAllocator(const ControlBlockAllocator<V>& other) // NOLINT: allocators convert implicitly
+            : pool(other.pool), slot(other.slot)
+        {
+        }
+
+        U* allocate(size_t n)
+        {
+            static_assert(sizeof(U) <= CONTROL_BLOCK_SIZE && alignof(U) <= alignof(std::max_align_t),
+                          "control block does not fit in the slot");
+            if (n == 1 && !slot->controlBlockInUse.exchange(true)) {
+                return reinterpret_cast<U*>(slot->controlBlock);
+            }
+            return std::allocator<U>().allocate(n);
+        }
+
+        void deallocate(U* ptr, size_t n)
+        {
+            if (reinterpret_cast<uint8_t*>(ptr) == slot->controlBlock) {
+                slot->controlBlockInUse.store(false);
             } else {
-                delete ptr;
+                std::allocator<U>().deallocate(ptr, n);
+            }
+        }
+
+        template <typename V>
+        bool operator==(const ControlBlockAllocator<V>& other) const
+        {
+            return slot == other.slot;
+        }
+
+        template <typename V>
+        bool operator!=(const ControlBlockAllocator<V>& other) const
+        {
+            return slot != other.slot;
+        }
+
+        std::shared_ptr<BufferPool<T>> pool;
+        Slot* slot;
+    };
+
+    struct Recycler {
+        void operator()(T*) const
+        {
+            pool->Recycle(slot);
+        }
+
+        BufferPool<T>* pool;
+        Slot* slot;
+    };
+
+    static uint64_t PackHead(uint32_t index, uint32_t tag)
+    {
+        return (static_cast<uint64_t>(tag) << 32) | index; // 32: tag in the high half against ABA
+    }
+
+    std::shared_ptr<T> Wrap(Slot* slot)
+    {
+        return std::shared_ptr<T>(slot->buffer.get(), Recycler {this, slot},
+                                  ControlBlockAllocator<T>(this->shared_from_this(), slot));
+    }
+
+    T* NewBuffer() const
+    {
+        auto buf = new Plugin::Buffer(metaType_);
+        buf->AllocMemory(nullptr, msgSize_);
+        return buf;
+    }
+
+    // called with mutex_ held
+    Slot* NewSlot(std::unique_ptr<T> buffer)
+    {
+        if (slotCount_ >= SLOT_CHUNK_SIZE * MAX_SLOT_CHUNKS) {
+            return nullptr;
+        }
+        auto& chunk = slotChunks_[slotCount_ / SLOT_CHUNK_SIZE];
+        if (chunk == nullptr) {
+            chunk.reset(new Slot[SLOT_CHUNK_SIZE]);
+        }
+        Slot* slot = &chunk[slotCount_ % SLOT_CHUNK_SIZE];
+        slot->buffer = std::move(buffer);
+        slot->index = slotCount_++;
+        return slot;
+    }
+
+    Slot* GetSlot(uint32_t index) const
+    {
+        return &slotChunks_[index / SLOT_CHUNK_SIZE][index % SLOT_CHUNK_SIZE];
+    }
+
+    void PushFree(Slot* slot)
+    {
+        uint64_t head = freeHead_.load();
+        uint64_t newHead;
+        do {
+            slot->next.store(static_cast<uint32_t>(head));
+            newHead = PackHead(slot->index, static_cast<uint32_t>(head >> 32) + 1); // 32: tag
+        } while (!freeHead_.compare_exchange_weak(head, newHead));
+        freeCount_++;
+    }
+
+    Slot* PopFree()
+    {
+        uint64_t head = freeHead_.load();
+        while (static_cast<uint32_t>(head) != INVALID_SLOT) {
+            Slot* slot = GetSlot(static_cast<uint32_t>(head));
+            uint64_t newHead = PackHead(slot->next.load(), static_cast<uint32_t>(head >> 32) + 1); // 32: tag
+            if (freeHead_.compare_exchange_weak(head, newHead)) {
+                freeCount_--;
+                return slot;
             }
-        });
-        freeBuffers_.pop_front();
-        return sptr;
+        }
+        return nullptr;
+    }
+
+    void Recycle(Slot* slot)
+    {
+        PushFree(slot);
+        if (waiters_.load() > 0) {
+            OSAL::ScopedLock lock(mutex_);
+            cv_.NotifyOne();
+        }
     }
 
     void FinishAllocInProgress()
@@ -181,13 +348,17 @@ private:
     mutable OSAL::Mutex mutex_;
     mutable OSAL::ConditionVariable cv_;
     mutable OSAL::ConditionVariable cvFinishAlloc_;
-    mutable std::list<std::unique_ptr<T>> freeBuffers_;
     size_t poolSize_ {0};
     size_t msgSize_ {0};
     size_t align_ {0}; // 0: use default alignment.
     std::atomic<bool> isActive_;
     std::atomic<bool> allocInProgress;
-    Plugin::BufferMetaType metaType_;
+    Plugin::BufferMetaType metaType_ {Plugin::BufferMetaType::AUDIO};
+    std::array<std::unique_ptr<Slot[]>, MAX_SLOT_CHUNKS> slotChunks_ {};
+    uint32_t slotCount_ {0};
+    std::atomic<uint64_t> freeHead_;
+    std::atomic<size_t> freeCount_ {0};
+    std::atomic<uint32_t> waiters_ {0};
 };
 } // namespace Media
 } // namespace OHOS
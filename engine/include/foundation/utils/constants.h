@@ -55,6 +55,7 @@ extern const char* const MEDIA_MIME_VIDEO_MPEG4;
 
 // container mime
 extern const char* const MEDIA_MIME_CONTAINER_MP4;
+extern const char* const MEDIA_MIME_CONTAINER_MPEGTS;
 
 bool IsAudioMime(const std::string& mime);
 bool IsVideoMime(const std::string& mime);
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_FOUNDATION_SEEK_INDEX_H
+#define HISTREAMER_FOUNDATION_SEEK_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "foundation/osal/thread/mutex.h"
+
+namespace OHOS {
+namespace Media {
+/**
+ * Sync frame index of a local media file, kept in a sidecar file so that the next open of the same file seeks
+ * without scanning for sync frames again.
+ *
+ * Entries map the pts of a sync frame of a track to the byte position of the packet that starts it. They are added
+ * while demuxing and looked up by binary search. The sidecar lives in the directory set by SetDirectory, which the
+ * demuxers do for Tag::SEEK_INDEX_DIR, and is named after the identity of the file: its size, modification time and a
+ * hash of its head. It is memory mapped on Open and rewritten on Close if entries were added. A sidecar holds at most
+ * MAX_ENTRIES entries, later sync frames are not indexed. A sidecar whose magic, version, identity, length, order or
+ * checksum does not match is ignored as a whole, the index then starts empty. The caller owns the directory and
+ * clears it.
+ */
+class SeekIndex {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t MAX_ENTRIES = 64 * 1024; // 64 * 1024: 1.5 MiB, a sync frame a second of 18 hours
+
+    struct Entry {
+        int64_t pts;       // ns, the time a demuxer seeks by
+        int64_t position;  // byte position in the file
+        uint32_t track;
+        uint32_t reserved; // 0, keeps entries 8 byte aligned
+    };
+
+    struct FileIdentity {
+        uint64_t size {0};
+        int64_t mtime {0};     // seconds
+        uint64_t headHash {0}; // fnv-1a of the first 64 KiB
+    };
+
+    /// directory of the sidecars, an empty one, the default, disables loading and saving
+    static void SetDirectory(const std::string& directory);
+
+    /// identity of the local file at uri, a path or a file uri, false for other uris
+    static bool GetFileIdentity(const std::string& uri, FileIdentity& identity);
+
+    SeekIndex() = default;
+    ~SeekIndex();
+    SeekIndex(const SeekIndex&) = delete;
+    SeekIndex& operator=(const SeekIndex&) = delete;
+
+    /// bind the index to the file at uri and load its sidecar, false if there is no valid one
+    bool Open(const std::string& uri);
+
+    /// save the sidecar if entries were added since Open and drop all the entries
+    void Close();
+
+    /// record a sync frame, entries already known are ignored
+    void Add(uint32_t track, int64_t pts, int64_t position);
+
+    /// the last entry of track at or before pts if backward, the first one at or after pts otherwise
+    bool Find(uint32_t track, int64_t pts, bool backward, Entry& entry) const;
+
+    /// entries of track by ascending pts
+    std::vector<Entry> GetEntries(uint32_t track) const;
+
+    size_t GetCount() const;
+
+    /// path of the sidecar of the file bound by Open, empty if there is none
+    std::string GetSidecarPath() const;
+
+private:
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+    void Unmap();
+
+    mutable OSAL::Mutex mutex_ {};
+    FileIdentity identity_ {};
+    bool bound_ {false};
+    const Entry* loaded_ {nullptr}; // sorted by track then pts
+    size_t loadedCount_ {0};
+    void* mapping_ {nullptr};
+    size_t mappingSize_ {0};
+    std::vector<Entry> loadedCopy_ {}; // holds the loaded entries where files can not be mapped
+    std::vector<Entry> added_ {};      // sorted by track then pts, none of them is loaded
+};
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_FOUNDATION_SEEK_INDEX_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_FOUNDATION_SPSC_QUEUE_H
+#define HISTREAMER_FOUNDATION_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace OHOS {
+namespace Media {
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : slots_(RoundUpPowerOfTwo(capacity)), mask_(slots_.size() - 1)
+    {
+    }
+
+    ~SpscQueue() = default;
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t Capacity() const
+    {
+        return slots_.size();
+    }
+
+    /// approximate size, exact only when called from producer or consumer while the peer is idle
+    size_t Size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const
+    {
+        return Size() == 0;
+    }
+
+    /// producer side, returns false if the queue is full
+    bool TryPush(T value)
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= slots_.size()) {
+            return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// consumer side, returns nullptr if the queue is empty. The element stays valid until Pop.
+    T* Front()
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    /// consumer side, returns false if the queue is empty
+    bool TryPop(T& value)
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots_[head & mask_]);
+        slots_[head & mask_] = T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// consumer side
+    void Clear()
+    {
+        T dropped;
+        while (TryPop(dropped)) {
+        }
+    }
+
+private:
+    static size_t RoundUpPowerOfTwo(size_t value)
+    {
+        size_t ret = 1;
+        while (ret < value) {
+            ret <<= 1;
+        }
+        return ret;
+    }
+
+    std::vector<T> slots_;
+    const size_t mask_;
+    alignas(64) std::atomic<size_t> head_ {0}; // 64: cache line, written by consumer only
+    alignas(64) std::atomic<size_t> tail_ {0}; // 64: cache line, written by producer only
+};
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_FOUNDATION_SPSC_QUEUE_H
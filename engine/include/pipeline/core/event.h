@@ -36,7 +36,8 @@ enum struct EventType : uint32_t {
     EVENT_DECODER_ERROR,
     EVENT_RESOLUTION_CHANGE,
     EVENT_VIDEO_RENDERING_START,
-    EVENT_IS_LIVE_STREAM
+    EVENT_IS_LIVE_STREAM,
+    EVENT_AUDIO_SPLICED, // int64_t, offset of the pts of the next item spliced into the audio sink, HST_TIME_BASE
 };
 
 struct Event {
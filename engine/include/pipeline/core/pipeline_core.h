@@ -21,6 +21,7 @@
 #include <functional>
 #include <initializer_list>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <stack>
@@ -63,7 +64,20 @@ public:
     ErrorCode LinkPorts(std::shared_ptr<OutPort> port1, std::shared_ptr<InPort> port2) override;
 
     void InitFilters(const std::vector<Filter*>& filters);
+    /**
+     * Initializes filters out of the pipeline, like the ones prepared for the next item of a playlist. They link to
+     * the filters of the pipeline and report their events to its receiver, but their EVENT_READY is dropped instead
+     * of counted toward the readiness of the pipeline, until they are adopted.
+     */
+    void InitStandbyFilters(const std::vector<Filter*>& filters);
+    /**
+     * Filters initialized by InitStandbyFilters join the pipeline with the links they have. They are not initialized
+     * again.
+     */
+    ErrorCode AdoptFilters(std::initializer_list<Filter*> filtersIn);
 private:
+    std::vector<Filter*> InsertFilters(std::initializer_list<Filter*> filtersIn);
+    bool IsStandbyFilter(const std::string& name);
     void ReorderFilters();
 
     void NotifyEvent(const Event& event);
@@ -75,6 +89,8 @@ private:
     EventReceiver* eventReceiver_ {nullptr};
     FilterCallback* filterCallback_ {nullptr};
     std::vector<Filter*> filtersToRemove_ {};
+    OSAL::Mutex standbyMutex_ {};
+    std::set<std::string> standbyFilters_ {}; // names of the filters initialized but not adopted yet
 };
 } // namespace Pipeline
 } // namespace Media
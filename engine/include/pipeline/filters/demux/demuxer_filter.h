@@ -17,6 +17,7 @@
 #define MEDIA_PIPELINE_DEMUXER_FILTER_H
 
 #include <atomic>
+#include <map>
 #include <string>
 #include "foundation/osal/thread/mutex.h"
 #include "foundation/osal/thread/task.h"
@@ -149,6 +150,7 @@ private:
 
     std::string pluginName_;
     std::shared_ptr<Plugin::Demuxer> plugin_;
+    std::map<Plugin::Tag, Plugin::Any> pluginParameters_ {}; // applied to every plugin the filter creates
     std::atomic<DemuxerState> pluginState_;
     std::shared_ptr<Plugin::Allocator> pluginAllocator_;
     std::shared_ptr<DataSourceImpl> dataSource_;
@@ -24,6 +24,7 @@ namespace OHOS {
 namespace Media {
 namespace Pipeline {
 class DataSpliter;
+class MuxerInterleaver;
 class MuxerFilter : public FilterBase {
 public:
     explicit MuxerFilter(std::string name);
@@ -44,10 +45,13 @@ public:
     ErrorCode AddTrack(std::shared_ptr<InPort>& trackPort);
     ErrorCode SetMaxDuration(uint64_t maxDuration);
     ErrorCode SetMaxSize(uint64_t maxSize);
+    /// max timestamp distance a track may lag behind others before frames are written without it
+    ErrorCode SetMaxInterleaveDelta(int64_t maxDelta);
     ErrorCode StartNextSegment();
     ErrorCode SendEos();
     ErrorCode PushData(const std::string& inPort, const AVBufferPtr& buffer, int64_t offset) override;
     ErrorCode Start() override;
+    ErrorCode Stop() override;
 private:
     class MuxerDataSink : public Plugin::DataSinkHelper {
     public:
@@ -59,6 +63,7 @@ private:
         int32_t trackId;
         std::string inPort;
         bool eos;
+        size_t interleaveIndex;
     };
 
     int32_t GetTrackIdByInPort(const std::shared_ptr<InPort>& inPort);
@@ -70,7 +75,9 @@ private:
     ErrorCode AddTrackThenConfigure(const std::pair<std::string, Plugin::Meta>& metaPair);
 
     bool AllTracksEos();
-    void UpdateEosState(const std::string& inPort);
+    void UpdateEosState(uint32_t trackId);
+    void WriteInterleavedFrame(const AVBufferPtr& buffer);
+    void FinishMuxing();
 
     std::string containerMime_ {};
     std::vector<TrackInfo> trackInfos_ {};
@@ -81,9 +88,10 @@ private:
     std::vector<std::pair<std::string, Plugin::Meta>> metaCache_ {};
     bool hasWriteHeader_ {false};
     std::shared_ptr<MuxerDataSink> muxerDataSink_;
+    std::shared_ptr<MuxerInterleaver> interleaver_;
 
     OSAL::Mutex pushDataMutex_;
-    bool eos_ {false};
+    std::atomic<bool> eos_ {false};
     std::atomic<int> eosTrackCnt {0};
 };
 } // Pipeline
@@ -17,6 +17,7 @@
 #define MEDIA_PIPELINE_AUDIO_SINK_FILTER_H
 
 #include <atomic>
+#include <string>
 
 #include "foundation/osal/thread/condition_variable.h"
 #include "foundation/osal/thread/mutex.h"
@@ -68,6 +69,22 @@ public:
     void FlushEnd() override;
     ErrorCode SetVolume(float volume);
 
+    /**
+     * In port to link the next item of a gapless playlist to. Its buffers wait there while the item on the active in
+     * port plays, and take over at the end of stream of it, with their pts moved to follow its last sample. The next
+     * item has to come in the sample format, rate and channels of the active one, the plugin plays on without being
+     * prepared again.
+     *
+     * @return the in port which is not active
+     */
+    PInPort GetStandbyInPort();
+
+    /// in port of the item which plays, the default one until an item is spliced in, and again after a stop
+    PInPort GetActiveInPort();
+
+    /// the item on the standby in port is spliced in only while enabled, disabling drops its buffers waiting there
+    void SetSpliceEnabled(bool enabled);
+
 protected:
     ErrorCode DoSyncWrite(const AVBufferPtr& buffer) override;
 
@@ -78,6 +95,17 @@ private:
     ErrorCode ConfigureToPreparePlugin(const std::shared_ptr<const Plugin::Meta>& meta);
     ErrorCode SetVolumeToPlugin();
     void OnEvent(const Plugin::PluginEvent& event) override;
+    void SetOutputChannelParams(Plugin::Meta& downstreamParams);
+    void ResetSplice();
+    bool IsStandbyPort(const std::string& inPort);
+    bool NegotiateStandby(const std::shared_ptr<const Plugin::Capability>& upstreamCap,
+                          Plugin::Capability& negotiatedCap, Plugin::Meta& downstreamParams);
+    bool ConfigureStandby(const std::shared_ptr<const Plugin::Meta>& meta);
+    void UpdateItemFormat(const Plugin::Meta& meta);
+    bool WaitUntilActive(const std::string& inPort);
+    bool SpliceOnEos();
+    bool RetimeBuffer(const AVBufferPtr& buffer);
+    void UpdateItemEnd(const AVBufferPtr& buffer);
 
     int64_t latestBufferPts_ {HST_TIME_NONE};
     int64_t latestBufferDuration_ {0};
@@ -99,6 +127,20 @@ private:
     int64_t lastReportedClockTime_ {HST_TIME_NONE};
 
     bool forceUpdateTimeAnchorNextTime_ {false};
+
+    // gapless splicing of the item on the standby in port, after the one on the active in port
+    OSAL::Mutex spliceMutex_ {};
+    OSAL::ConditionVariable spliceCondition_ {};
+    std::string activeInPort_ {PORT_NAME_DEFAULT};
+    bool spliceEnabled_ {false};
+    bool spliceArmed_ {false}; // the standby in port is configured, it takes over at the next end of stream
+    std::shared_ptr<const Plugin::Meta> standbyMeta_ {};
+    bool retimeNextBuffer_ {false};
+    int64_t itemOffset_ {0}; // added to the pts of the active item, once items are spliced
+    int64_t itemEndPts_ {HST_TIME_NONE}; // end of the last sample written
+    uint32_t sampleRate_ {0};
+    uint32_t channels_ {0};
+    Plugin::AudioSampleFormat sampleFormat_ {Plugin::AudioSampleFormat::NONE};
 };
 } // namespace Pipeline
 } // namespace Media
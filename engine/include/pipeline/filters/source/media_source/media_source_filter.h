@@ -16,6 +16,7 @@
 #ifndef MEDIA_PIPELINE_MEDIA_SOURCE_FILTER_H
 #define MEDIA_PIPELINE_MEDIA_SOURCE_FILTER_H
 
+#include <map>
 #include <memory>
 #include <string>
 
@@ -47,6 +48,8 @@ public:
     ErrorCode Prepare() override;
     ErrorCode Start() override;
     ErrorCode Stop() override;
+    ErrorCode SetParameter(int32_t key, const Plugin::Any& value) override;
+    ErrorCode GetParameter(int32_t key, Plugin::Any& value) override;
     void FlushStart() override;
     void FlushEnd() override;
     Plugin::Seekable GetSeekable() const;
@@ -78,6 +81,7 @@ private:
     size_t bufferSize_;
     std::shared_ptr<Plugin::Source> plugin_;
     std::shared_ptr<Allocator> pluginAllocator_;
+    std::map<Plugin::Tag, Plugin::Any> pluginParameters_ {}; // applied to every plugin the filter creates
     bool isPluginReady_ {false};
     bool isAboveWaterline_ {false};
 };
@@ -55,6 +55,11 @@ const std::map<Tag, std::tuple<const char*, const ValueType&, const char*>> g_ta
     {Tag::WATERLINE_HIGH, {"waterline_h",              g_u32Def,           "uint32_t"}},
     {Tag::WATERLINE_LOW, {"waterline_l",               g_u32Def,           "uint32_t"}},
     {Tag::SRC_INPUT_TYPE, {"src_input_typ",            g_srcInputTypedef,  "SrcInputType"}},
+    {Tag::HTTP_CACHE_MEMORY_LIMIT, {"http_cache_mem_limit", g_u64Def,      "uint64_t"}},
+    {Tag::HTTP_CACHE_DISK_LIMIT, {"http_cache_disk_limit", g_u64Def,       "uint64_t"}},
+    {Tag::HTTP_CACHE_DISK_PATH, {"http_cache_disk_path", g_emptyString,    "string"}},
+    {Tag::HTTP_CACHE_BYTES_SAVED, {"http_cache_bytes_saved", g_u64Def,     "uint64_t"}},
+    {Tag::SEEK_INDEX_DIR, {"seek_index_dir",           g_emptyString,      "string"}},
     {Tag::MEDIA_TYPE, {"media_type",                   g_mediaTypeDef,      "MediaType"}},
     {Tag::MEDIA_TITLE, {"title",                       g_emptyString,      "string"}},
     {Tag::MEDIA_ARTIST, {"artist",                     g_emptyString,      "string"}},
@@ -82,6 +87,8 @@ const std::map<Tag, std::tuple<const char*, const ValueType&, const char*>> g_ta
     {Tag::AUDIO_SAMPLE_PER_FRAME, {"sample_per_frame", g_u32Def,           "uint32_t"}},
     {Tag::AUDIO_OUTPUT_CHANNELS, {"output_channels",   g_u32Def,           "uint32_t"}},
     {Tag::AUDIO_OUTPUT_CHANNEL_LAYOUT, {"output_channel_layout", g_channelLayoutDef, "AudioChannelLayout"}},
+    {Tag::AUDIO_SKIP_SAMPLES, {"skip_samples",         g_u32Def,           "uint32_t"}},
+    {Tag::AUDIO_DISCARD_PADDING, {"discard_padding",   g_u32Def,           "uint32_t"}},
     {Tag::AUDIO_MPEG_VERSION, {"ad_mpeg_ver",          g_u32Def,           "uint32_t"}},
     {Tag::AUDIO_MPEG_LAYER, {"ad_mpeg_layer",          g_u32Def,           "uint32_t"}},
 
@@ -98,6 +105,11 @@ const std::map<Tag, std::tuple<const char*, const ValueType&, const char*>> g_ta
     {Tag::VIDEO_BIT_STREAM_FORMAT, {"vd_bit_stream_fmt", g_vdBitStreamFmtDef, "VideoBitStreamFormat"}},
     {Tag::BITS_PER_CODED_SAMPLE, {"bits_per_coded_sample", g_u32Def,       "uint32_t"}},
     {Tag::MEDIA_START_TIME, {"med_start_time",         g_d64Def,           "int64_t"}},
+    {Tag::MEDIA_SEEK_TARGET, {"med_seek_target",       g_d64Def,           "int64_t"}},
+    {Tag::MEDIA_FRAME_DURATION, {"med_frame_duration", g_d64Def,           "int64_t"}},
+    {Tag::MEDIA_SOURCE_READS, {"med_source_reads",     g_u64Def,           "uint64_t"}},
+    {Tag::MEDIA_SOURCE_READ_BYTES, {"med_source_read_bytes", g_u64Def,     "uint64_t"}},
+    {Tag::MEDIA_SOURCE_READS_PER_SECOND, {"med_source_reads_per_sec", g_doubleDef, "double"}},
     {Tag::VIDEO_H264_PROFILE, {"h264_profile",         g_vdH264ProfileDef, "VideoH264Profile"}},
     {Tag::VIDEO_H264_LEVEL, {"vd_level",               g_u32Def,           "uint32_t"}},
     {Tag::APP_TOKEN_ID, {"apptoken_id",                g_u32Def,           "uint32_t"}},
@@ -34,6 +34,8 @@ namespace Plugin {
 #define BUFFER_FLAG_EOS 0x00000001
 /// Video Key Frame Flag
 #define BUFFER_FLAG_KEY_FRAME 0x00000002
+/// Decoding Timestamp Valid Flag, the dts of buffers without it is taken to be their pts
+#define BUFFER_FLAG_DTS_VALID 0x00000004
 
 // Align value template
 template <typename T>
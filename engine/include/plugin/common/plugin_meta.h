@@ -81,6 +81,8 @@ public:
         tag == Tag::AUDIO_SAMPLE_RATE or
         tag == Tag::AUDIO_SAMPLE_PER_FRAME or
         tag == Tag::AUDIO_OUTPUT_CHANNELS or
+        tag == Tag::AUDIO_SKIP_SAMPLES or
+        tag == Tag::AUDIO_DISCARD_PADDING or
         tag == Tag::AUDIO_MPEG_VERSION or
         tag == Tag::AUDIO_MPEG_LAYER or
         tag == Tag::AUDIO_AAC_LEVEL or
@@ -95,14 +97,22 @@ public:
         tag == Tag::MEDIA_DURATION or
         tag == Tag::MEDIA_BITRATE or
         tag == Tag::MEDIA_START_TIME or
+        tag == Tag::MEDIA_SEEK_TARGET or
+        tag == Tag::MEDIA_FRAME_DURATION or
         tag == Tag::USER_FRAME_PTS or
         tag == Tag::USER_PUSH_DATA_TIME, int64_t);
 
     DEFINE_INSERT_GET_FUNC(
         tag == Tag::MEDIA_FILE_SIZE or
-        tag == Tag::MEDIA_POSITION, uint64_t);
+        tag == Tag::MEDIA_POSITION or
+        tag == Tag::MEDIA_SOURCE_READS or
+        tag == Tag::MEDIA_SOURCE_READ_BYTES or
+        tag == Tag::HTTP_CACHE_MEMORY_LIMIT or
+        tag == Tag::HTTP_CACHE_DISK_LIMIT or
+        tag == Tag::HTTP_CACHE_BYTES_SAVED, uint64_t);
     DEFINE_INSERT_GET_FUNC(
-        tag == Tag::VIDEO_CAPTURE_RATE, double);
+        tag == Tag::VIDEO_CAPTURE_RATE or
+        tag == Tag::MEDIA_SOURCE_READS_PER_SECOND, double);
     DEFINE_INSERT_GET_FUNC(
         tag == Tag::MIME or
         tag == Tag::MEDIA_FILE_URI or
@@ -120,6 +130,8 @@ public:
         tag == Tag::USER_TIME_SYNC_RESULT or
         tag == Tag::USER_AV_SYNC_GROUP_INFO or
         tag == Tag::USER_SHARED_MEMORY_FD or
+        tag == Tag::HTTP_CACHE_DISK_PATH or
+        tag == Tag::SEEK_INDEX_DIR or
         tag == Tag::MEDIA_LYRICS, std::string);
     Meta& operator=(const Meta& other)
     {
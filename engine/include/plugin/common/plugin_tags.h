@@ -111,6 +111,11 @@ enum struct Tag : uint32_t {
     VIDEO_SCALE_TYPE,                 ///< VideoScaleType, video scale type
     INPUT_MEMORY_TYPE,                ///< @see MemoryType
     OUTPUT_MEMORY_TYPE,               ///< @see MemoryType
+    HTTP_CACHE_MEMORY_LIMIT,          ///< uint64_t, bytes the process wide http cache keeps in memory
+    HTTP_CACHE_DISK_LIMIT,            ///< uint64_t, bytes the http cache keeps on disk, 0 disables the disk tier
+    HTTP_CACHE_DISK_PATH,             ///< std::string, dir of the disk tier of the http cache
+    HTTP_CACHE_BYTES_SAVED,           ///< uint64_t, read only, bytes served from the http cache, not downloaded
+    SEEK_INDEX_DIR,                   ///< std::string, dir of the sidecar seek indexes of local files, empty disables
 
     /* -------------------- media tag -------------------- */
     MEDIA_TITLE = SECTION_MEDIA_START + 1, ///< string
@@ -135,6 +140,11 @@ enum struct Tag : uint32_t {
     MEDIA_SEEKABLE,                        ///< enum Seekable: Seekable status of the media
     MEDIA_PLAYBACK_SPEED,                  ///< double, playback speed
     MEDIA_TYPE,                            ///< enum MediaType: Auido Video Subtitle...
+    MEDIA_SEEK_TARGET,                     ///< int64_t, time an accurate seek resumes at, skip frames before it
+    MEDIA_FRAME_DURATION,                  ///< int64_t, duration of demuxed frames, {@link HST_TIME_BASE}
+    MEDIA_SOURCE_READS,                    ///< uint64_t, read only, reads a demuxer issued to its data source
+    MEDIA_SOURCE_READ_BYTES,               ///< uint64_t, read only, bytes returned by those reads
+    MEDIA_SOURCE_READS_PER_SECOND,         ///< double, read only, data source reads per second of media handed out
 
     /* -------------------- audio universal tag -------------------- */
     AUDIO_CHANNELS = SECTION_AUDIO_UNIVERSAL_START + 1, ///< uint32_t, stream channel num
@@ -144,6 +154,8 @@ enum struct Tag : uint32_t {
     AUDIO_SAMPLE_PER_FRAME,                             ///< uint32_t, sample per frame
     AUDIO_OUTPUT_CHANNELS,                              ///< uint32_t, sink output channel num
     AUDIO_OUTPUT_CHANNEL_LAYOUT,                        ///< @see AudioChannelLayout, sink output channel layout
+    AUDIO_SKIP_SAMPLES,                                 ///< uint32_t, samples to drop from the front, encoder delay
+    AUDIO_DISCARD_PADDING,                              ///< uint32_t, samples to drop from the end, encoder padding
 
     /* -------------------- audio specific tag -------------------- */
     AUDIO_SPECIFIC_MPEG_START = MAKE_AUDIO_SPECIFIC_START(AudioFormat::MPEG),
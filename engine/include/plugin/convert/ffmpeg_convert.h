@@ -73,13 +73,21 @@ struct ScalePara {
     int32_t align {16};
 };
 
+/**
+ * Converts video frames between pixel formats and sizes. Frames that keep their size in formats the video convert
+ * kernels know (yuv420p, nv12, nv21 and 4 byte rgb) are converted by the kernels, libswscale is only used to resize.
+ */
 struct Scale {
 public:
     Status Init(const ScalePara& scalePara, uint8_t** dstData, int32_t* dstLineSize);
     Status Convert(uint8_t** srcData, const int32_t* srcLineSize, uint8_t** dstData, int32_t* dstLineSize);
 private:
+    Status DirectConvert(uint8_t** srcData, const int32_t* srcLineSize, uint8_t** dstData, const int32_t* dstLineSize);
+
     ScalePara scalePara_ {};
     std::shared_ptr<SwsContext> swsCtx_ {nullptr};
+    bool isDirect_ {false};
+    std::vector<uint8_t> chromaCache_ {};
 };
 #endif
 } // namespace Ffmpeg
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_PLUGIN_VIDEO_CONVERT_H
+#define HISTREAMER_PLUGIN_VIDEO_CONVERT_H
+
+#include <cstdint>
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+/**
+ * Pixel conversion kernels of the video path that need no resizing, so no libswscale.
+ *
+ * The instruction set is chosen once at runtime: avx2 or ssse3 if the cpu supports them, sse2 on x86 otherwise,
+ * neon on arm, plain c elsewhere. All kernels accept any count, the tail of a row is converted by the c version.
+ */
+namespace VideoConvert {
+// channel of a 4 byte pixel, as the values of a channel order
+enum Channel : uint8_t {
+    R = 0,
+    G = 1,
+    B = 2,
+    A = 3,
+};
+
+// copy height rows of widthBytes bytes between planes of any strides
+void CopyPlane(const uint8_t* src, int32_t srcStride, uint8_t* dst, int32_t dstStride, int32_t widthBytes,
+               int32_t height);
+
+// dst gets first[0] second[0] first[1] second[1] ..., count samples of each plane, e.g. the uv row of nv12
+void InterleavePlanes(const uint8_t* first, const uint8_t* second, uint8_t* dst, int32_t count);
+
+// inverse of InterleavePlanes
+void DeinterleavePlane(const uint8_t* src, uint8_t* first, uint8_t* second, int32_t count);
+
+// count pixels of 4 bytes, byte i of a dst pixel is byte order[i] of the src pixel, e.g. {2, 1, 0, 3} for rgba to bgra
+void ShufflePixels(const uint8_t* src, uint8_t* dst, const uint8_t (&order)[4], int32_t count);
+
+/**
+ * One row of width pixels of 8 bit yuv 4:2:0 to 4 byte pixels, u and v hold (width + 1) / 2 samples.
+ * Byte i of a dst pixel is channel order[i], alpha is opaque. Uses bt.601 limited range as libswscale does by default,
+ * chroma is not interpolated.
+ */
+void YuvRowToRgb(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, const uint8_t (&order)[4],
+                 int32_t width);
+
+// name of the instruction set the kernels run on, for logs and benchmarks
+const char* GetInstructionSet();
+} // namespace VideoConvert
+} // namespace Plugin
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_PLUGIN_VIDEO_CONVERT_H
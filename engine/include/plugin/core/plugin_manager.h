@@ -44,6 +44,11 @@ public:
 
     std::vector<std::string> ListPlugins(PluginType pluginType, CodecMode preferredCodecMode = CodecMode::HARDWARE);
 
+    std::vector<std::string> ListPluginsByInputMime(PluginType pluginType, const std::string& mime,
+                                                    CodecMode preferredCodecMode = CodecMode::HARDWARE);
+
+    uint64_t GetRegisterGeneration();
+
     std::shared_ptr<PluginInfo> GetPluginInfo(PluginType type, const std::string& name);
 
     std::shared_ptr<Source> CreateSourcePlugin(const std::string& name);
@@ -17,8 +17,6 @@
 
 #include "pipeline/core/compatible_check.h"
 #include <algorithm>
-#include <functional>
-#include <map>
 #include "foundation/log.h"
 #include "plugin/common/plugin_attr_desc.h"
 
@@ -28,94 +26,41 @@ namespace Pipeline {
 static constexpr uint8_t ALLOW_FIXED = 1 << 0;
 static constexpr uint8_t ALLOW_INTERVAL = 1 << 1;
 static constexpr uint8_t ALLOW_DISCRETE = 1 << 2;
+static constexpr uint8_t ALLOW_FIXED_DISCRETE = ALLOW_FIXED | ALLOW_DISCRETE;
+static constexpr uint8_t ALLOW_ALL = ALLOW_FIXED | ALLOW_INTERVAL | ALLOW_DISCRETE;
 
-static inline bool IsFixedAllowed(uint8_t flags)
+static constexpr bool IsFixedAllowed(uint8_t flags)
 {
     return ALLOW_FIXED & flags;
 }
 
-static inline bool IsIntervalAllowed(uint8_t flags)
+static constexpr bool IsIntervalAllowed(uint8_t flags)
 {
     return ALLOW_INTERVAL & flags;
 }
 
-static inline bool IsDiscreteAllowed(uint8_t flags)
+static constexpr bool IsDiscreteAllowed(uint8_t flags)
 {
     return ALLOW_DISCRETE & flags;
 }
 
-template<typename T>
-bool CapabilityValueCheck(CapabilityID key, std::pair<const Plugin::ValueType&, const Plugin::ValueType&> inVals,
-                          uint8_t flags, std::function<int(T,T)> cmpFunc, Plugin::ValueType& outValue);
-
-template <typename T>
-bool FixInvalDiscCapValCheck(CapabilityID key, const Plugin::ValueType& val1, const Plugin::ValueType& val2,
-                             Plugin::ValueType& outValue)
-{
-    return CapabilityValueCheck<T>(key, {val1, val2}, ALLOW_FIXED | ALLOW_INTERVAL | ALLOW_DISCRETE,
-        [](T a, T b) {
-        return a - b;
-        }, outValue);
-}
-
-template <typename T, typename U>
-bool FixDiscCapValCheck(CapabilityID key, const Plugin::ValueType& val1, const Plugin::ValueType& val2,
-                        Plugin::ValueType& outValue)
-{
-    return CapabilityValueCheck<T>(key, {val1, val2}, ALLOW_FIXED | ALLOW_DISCRETE, [](T a, T b) {
-        return static_cast<U>(a) - static_cast<U>(b);
-    }, outValue);
-}
-
-static std::vector<CapabilityID> g_allCapabilityId = {
-    CapabilityID::AUDIO_SAMPLE_RATE, // 0
-    CapabilityID::AUDIO_CHANNELS, // 1
-    CapabilityID::AUDIO_CHANNEL_LAYOUT, // 2
-    CapabilityID::AUDIO_SAMPLE_FORMAT, // 3
-    CapabilityID::AUDIO_MPEG_VERSION, // 4
-    CapabilityID::AUDIO_MPEG_LAYER, // 5
-    CapabilityID::AUDIO_AAC_PROFILE, // 6
-    CapabilityID::AUDIO_AAC_LEVEL, // 7
-    CapabilityID::AUDIO_AAC_STREAM_FORMAT, // 8
-    CapabilityID::VIDEO_PIXEL_FORMAT, // 9
-    CapabilityID::VIDEO_BIT_STREAM_FORMAT, // 10
-    CapabilityID::MEDIA_BITRATE, // 11
-};
-
-template <typename T>
-bool ExtractFixedCap(const Plugin::ValueType& value, Plugin::ValueType& fixedValue);
-static std::map<CapabilityID, std::function<bool(const Plugin::ValueType&, Plugin::ValueType&)>> g_capExtrMap = {
-    {g_allCapabilityId[0], ExtractFixedCap<uint32_t>}, // 0
-    {g_allCapabilityId[1], ExtractFixedCap<uint32_t>}, // 1
-    {g_allCapabilityId[2], ExtractFixedCap<Plugin::AudioChannelLayout>}, // 2
-    {g_allCapabilityId[3], ExtractFixedCap<Plugin::AudioSampleFormat>}, // 3
-    {g_allCapabilityId[4], ExtractFixedCap<uint32_t>}, // 4
-    {g_allCapabilityId[5], ExtractFixedCap<uint32_t>}, // 5
-    {g_allCapabilityId[6], ExtractFixedCap<Plugin::AudioAacProfile>}, // 6
-    {g_allCapabilityId[7], ExtractFixedCap<uint32_t>}, // 7
-    {g_allCapabilityId[8], ExtractFixedCap<Plugin::AudioAacStreamFormat>}, // 8
-    {g_allCapabilityId[9], ExtractFixedCap<Plugin::VideoPixelFormat>}, // 9
-    {g_allCapabilityId[10], ExtractFixedCap<Plugin::VideoBitStreamFormat>}, // 10
-    {g_allCapabilityId[11], ExtractFixedCap<int64_t>}, // 11
-};
-using CheckFunc = std::function<bool(Capability::Key key, const Plugin::ValueType& val1, const Plugin::ValueType& val2,
-        Plugin::ValueType& outValue)>;
-static std::map<CapabilityID, CheckFunc> g_capabilityValueCheckMap = {
-    {g_allCapabilityId[0], FixInvalDiscCapValCheck<uint32_t>}, // 0
-    {g_allCapabilityId[1], FixInvalDiscCapValCheck<uint32_t>}, // 1
-    {g_allCapabilityId[2], FixDiscCapValCheck<Plugin::AudioChannelLayout, uint64_t>}, // 2
-    {g_allCapabilityId[3], FixDiscCapValCheck<Plugin::AudioSampleFormat, uint8_t>}, // 3
-    {g_allCapabilityId[4], FixInvalDiscCapValCheck<uint32_t>}, // 4
-    {g_allCapabilityId[5], FixInvalDiscCapValCheck<uint32_t>}, // 5
-    {g_allCapabilityId[6], FixDiscCapValCheck<Plugin::AudioAacProfile, uint8_t>}, // 6
-    {g_allCapabilityId[7], FixInvalDiscCapValCheck<uint32_t>}, // 7
-    {g_allCapabilityId[8], FixDiscCapValCheck<Plugin::AudioAacStreamFormat, uint8_t>}, // 8
-    {g_allCapabilityId[9], FixDiscCapValCheck<Plugin::VideoPixelFormat, uint32_t>}, // 9
-    {g_allCapabilityId[10], FixDiscCapValCheck<Plugin::VideoBitStreamFormat, uint32_t>}, // 10
-    {g_allCapabilityId[11], FixInvalDiscCapValCheck<int64_t>}, // 11
+/**
+ * three-way comparison of capability values, enums are compared as their underlying type U. It is a type rather than
+ * a std::function so that every check below is specialised and inlined for the value type of the key.
+ */
+template <typename T, typename U = T>
+struct CapValueCompare {
+    int operator()(const T& val1, const T& val2) const
+    {
+        auto lhs = static_cast<U>(val1);
+        auto rhs = static_cast<U>(val2);
+        if (lhs < rhs) {
+            return -1;
+        }
+        return lhs > rhs ? 1 : 0;
+    }
 };
 
-
 static bool StringEqIgnoreCase(const std::string& s1, const std::string& s2)
 {
     if (s1.length() == s2.length()) {
@@ -157,8 +102,8 @@ bool IsSubsetMime(const std::string& subset, const std::string& universe)
     return true;
 }
 
-template <typename T>
-T Max(T val1, T val2, std::function<int(T, T)> compareFunc)
+template <typename T, typename Cmp>
+T Max(const T& val1, const T& val2, Cmp compareFunc)
 {
     if (compareFunc(val1, val2) >= 0) {
         return val1;
@@ -166,8 +111,8 @@ T Max(T val1, T val2, std::function<int(T, T)> compareFunc)
     return val2;
 }
 
-template <typename T>
-T Min(T val1, T val2, std::function<int(T, T)> compareFunc)
+template <typename T, typename Cmp>
+T Min(const T& val1, const T& val2, Cmp compareFunc)
 {
     if (compareFunc(val1, val2) <= 0) {
         return val1;
@@ -175,9 +120,9 @@ T Min(T val1, T val2, std::function<int(T, T)> compareFunc)
     return val2;
 }
 
-template <typename T>
+template <typename T, typename Cmp>
 bool FFCapabilityCheck(const Plugin::FixedCapability<T>& v1, const Plugin::FixedCapability<T>& v2,
-                       std::function<int(T,T)>& cmpFunc, Plugin::ValueType& outValue)
+                       Cmp cmpFunc, Plugin::ValueType& outValue)
 {
     if (cmpFunc(v1, v2) == 0) {
         outValue = v1;
@@ -186,9 +131,9 @@ bool FFCapabilityCheck(const Plugin::FixedCapability<T>& v1, const Plugin::Fixed
     return false;
 }
 
-template <typename T>
+template <typename T, typename Cmp>
 bool FICapabilityCheck(const Plugin::FixedCapability<T>& v1, const Plugin::IntervalCapability<T>& v2,
-                       const std::function<int(T,T)>& cmpFunc, Plugin::ValueType& outValue)
+                       Cmp cmpFunc, Plugin::ValueType& outValue)
 {
     T max = Max(v2.first, v2.second, cmpFunc);
     T min = Min(v2.first, v2.second, cmpFunc);
@@ -199,9 +144,9 @@ bool FICapabilityCheck(const Plugin::FixedCapability<T>& v1, const Plugin::Inter
     return false;
 }
 
-template <typename T>
+template <typename T, typename Cmp>
 bool FDCapabilityCheck(const Plugin::FixedCapability<T>& v1, const Plugin::DiscreteCapability<T>& v2,
-                       const std::function<int(T,T)>& cmpFunc, Plugin::ValueType& outValue)
+                       Cmp cmpFunc, Plugin::ValueType& outValue)
 {
     if (std::any_of(v2.begin(), v2.end(), [&v1, &cmpFunc](const T& tmp){return cmpFunc(tmp, v1) == 0;})) {
         outValue = v1;
@@ -210,9 +155,9 @@ bool FDCapabilityCheck(const Plugin::FixedCapability<T>& v1, const Plugin::Discr
     return false;
 }
 
-template <typename T>
+template <typename T, typename Cmp>
 bool IICapabilityCheck(const Plugin::IntervalCapability<T>& v1, const Plugin::IntervalCapability<T>& v2,
-                       const std::function<int(T,T)>& cmpFunc, Plugin::ValueType& outValue)
+                       Cmp cmpFunc, Plugin::ValueType& outValue)
 {
     T max1 = Max(v1.first, v1.second, cmpFunc);
     T min1 = Min(v1.first, v1.second, cmpFunc);
@@ -231,9 +176,9 @@ bool IICapabilityCheck(const Plugin::IntervalCapability<T>& v1, const Plugin::In
     return true;
 }
 
-template <typename T>
+template <typename T, typename Cmp>
 bool IDCapabilityCheck(const Plugin::IntervalCapability<T>& v1, const Plugin::DiscreteCapability<T>& v2,
-                       const std::function<int(T,T)>& cmpFunc, Plugin::ValueType& outValue)
+                       Cmp cmpFunc, Plugin::ValueType& outValue)
 {
     Plugin::DiscreteCapability<T> tmpOut;
     for (const auto& oneValue : v2) {
@@ -247,14 +192,14 @@ bool IDCapabilityCheck(const Plugin::IntervalCapability<T>& v1, const Plugin::Di
     if (tmpOut.size() == 1) {
         outValue = Plugin::FixedCapability<T>(tmpOut[0]);
     } else {
-        outValue = Plugin::DiscreteCapability<T>(tmpOut);
+        outValue = std::move(tmpOut);
     }
     return true;
 }
 
-template <typename T>
+template <typename T, typename Cmp>
 bool DDCapabilityCheck(const Plugin::DiscreteCapability<T>& v1, const Plugin::DiscreteCapability<T>& v2,
-                       const std::function<int(T,T)>& cmpFunc, Plugin::ValueType& outValue)
+                       Cmp cmpFunc, Plugin::ValueType& outValue)
 {
     Plugin::DiscreteCapability<T> tmpOut;
     for (const auto& cap1 : v1) {
@@ -268,7 +213,7 @@ bool DDCapabilityCheck(const Plugin::DiscreteCapability<T>& v1, const Plugin::Di
     if (tmpOut.size() == 1) {
         outValue = Plugin::FixedCapability<T>(tmpOut[0]);
     } else {
-        outValue = Plugin::DiscreteCapability<T>(tmpOut);
+        outValue = std::move(tmpOut);
     }
     return true;
 }
@@ -291,77 +236,167 @@ void LogOutIncorrectType(CapabilityID key, uint8_t flags)
     }
 }
 
-template <typename T>
+// the values are reached through AnyCast on a pointer, which checks the type once and copies nothing
+template <typename T, typename Cmp, uint8_t flags>
 bool FixedNumericalCapabilityCheck(CapabilityID key, const T& value2, const Plugin::ValueType& value1,
-                                   uint8_t flags, std::function<int(T, T)> cmpFunc, Plugin::ValueType& outValue)
+                                   Plugin::ValueType& outValue)
 {
-    if (Plugin::Any::IsSameTypeWith<T>(value1)) {
-        return FFCapabilityCheck(value2, Plugin::AnyCast<T>(value1), cmpFunc, outValue);
+    if (auto fixed = Plugin::AnyCast<T>(&value1)) {
+        return FFCapabilityCheck(value2, *fixed, Cmp(), outValue);
     }
-    if (IsIntervalAllowed(flags) && Plugin::Any::IsSameTypeWith<Plugin::IntervalCapability<T>>(value1)) {
-        return FICapabilityCheck(value2, Plugin::AnyCast<Plugin::IntervalCapability<T>>(value1), cmpFunc, outValue);
+    if (IsIntervalAllowed(flags)) {
+        if (auto interval = Plugin::AnyCast<Plugin::IntervalCapability<T>>(&value1)) {
+            return FICapabilityCheck(value2, *interval, Cmp(), outValue);
+        }
     }
-    if (IsDiscreteAllowed(flags) && Plugin::Any::IsSameTypeWith<Plugin::DiscreteCapability<T>>(value1)) {
-        return FDCapabilityCheck(value2, Plugin::AnyCast<Plugin::DiscreteCapability<T>>(value1), cmpFunc, outValue);
+    if (IsDiscreteAllowed(flags)) {
+        if (auto discrete = Plugin::AnyCast<Plugin::DiscreteCapability<T>>(&value1)) {
+            return FDCapabilityCheck(value2, *discrete, Cmp(), outValue);
+        }
     }
     LogOutIncorrectType(key, flags);
     return false;
 }
 
-template <typename T>
+template <typename T, typename Cmp, uint8_t flags>
 bool IntervalNumericalCapabilityCheck(CapabilityID key, const Plugin::IntervalCapability<T>& value2,
-    const Plugin::ValueType& value1, uint8_t flags, std::function<int(T, T)> cmpFunc, Plugin::ValueType& outValue)
+                                      const Plugin::ValueType& value1, Plugin::ValueType& outValue)
 {
-    if (IsFixedAllowed(flags) && Plugin::Any::IsSameTypeWith<T>(value1)) {
-        return FICapabilityCheck(Plugin::AnyCast<T>(value1), value2, cmpFunc, outValue);
+    if (IsFixedAllowed(flags)) {
+        if (auto fixed = Plugin::AnyCast<T>(&value1)) {
+            return FICapabilityCheck(*fixed, value2, Cmp(), outValue);
+        }
     }
-    if (Plugin::Any::IsSameTypeWith<Plugin::IntervalCapability<T>>(value1)) {
-        return IICapabilityCheck(Plugin::AnyCast<Plugin::IntervalCapability<T>>(value1), value2, cmpFunc, outValue);
+    if (auto interval = Plugin::AnyCast<Plugin::IntervalCapability<T>>(&value1)) {
+        return IICapabilityCheck(*interval, value2, Cmp(), outValue);
     }
-    if (IsDiscreteAllowed(flags) && Plugin::Any::IsSameTypeWith<Plugin::DiscreteCapability<T>>(value1)) {
-        return IDCapabilityCheck(value2, Plugin::AnyCast<Plugin::DiscreteCapability<T>>(value1), cmpFunc, outValue);
+    if (IsDiscreteAllowed(flags)) {
+        if (auto discrete = Plugin::AnyCast<Plugin::DiscreteCapability<T>>(&value1)) {
+            return IDCapabilityCheck(value2, *discrete, Cmp(), outValue);
+        }
     }
     LogOutIncorrectType(key, flags);
     return false;
 }
 
-template <typename T>
+template <typename T, typename Cmp, uint8_t flags>
 bool DiscreteNumericalCapabilityCheck(CapabilityID key, const Plugin::DiscreteCapability<T>& value2,
-    const Plugin::ValueType& value1, uint8_t flags, std::function<int(T, T)> cmpFunc, Plugin::ValueType& outValue)
+                                      const Plugin::ValueType& value1, Plugin::ValueType& outValue)
 {
-    if (IsFixedAllowed(flags) && Plugin::Any::IsSameTypeWith<T>(value1)) {
-        return FDCapabilityCheck(Plugin::AnyCast<T>(value1), value2, cmpFunc, outValue);
+    if (IsFixedAllowed(flags)) {
+        if (auto fixed = Plugin::AnyCast<T>(&value1)) {
+            return FDCapabilityCheck(*fixed, value2, Cmp(), outValue);
+        }
     }
-    if (IsIntervalAllowed(flags) && Plugin::Any::IsSameTypeWith<Plugin::IntervalCapability<T>>(value1)) {
-        return IDCapabilityCheck(Plugin::AnyCast<Plugin::IntervalCapability<T>>(value1), value2, cmpFunc, outValue);
+    if (IsIntervalAllowed(flags)) {
+        if (auto interval = Plugin::AnyCast<Plugin::IntervalCapability<T>>(&value1)) {
+            return IDCapabilityCheck(*interval, value2, Cmp(), outValue);
+        }
     }
-    if (Plugin::Any::IsSameTypeWith<Plugin::DiscreteCapability<T>>(value1)) {
-        return DDCapabilityCheck(Plugin::AnyCast<Plugin::DiscreteCapability<T>>(value1), value2, cmpFunc, outValue);
+    if (auto discrete = Plugin::AnyCast<Plugin::DiscreteCapability<T>>(&value1)) {
+        return DDCapabilityCheck(*discrete, value2, Cmp(), outValue);
     }
     LogOutIncorrectType(key, flags);
     return false;
 }
 
-template<typename T>
-bool CapabilityValueCheck(CapabilityID key, std::pair<const Plugin::ValueType&, const Plugin::ValueType&> inVals,
-                          uint8_t flags, std::function<int(T,T)> cmpFunc, Plugin::ValueType& outValue)
+template <typename T, typename Cmp, uint8_t flags>
+bool CapabilityValueCheck(CapabilityID key, const Plugin::ValueType& val1, const Plugin::ValueType& val2,
+                          Plugin::ValueType& outValue)
 {
-    if (IsFixedAllowed(flags) && Plugin::Any::IsSameTypeWith<Plugin::FixedCapability<T>>(inVals.first)) {
-        return FixedNumericalCapabilityCheck<T>(key,
-            Plugin::AnyCast<Plugin::FixedCapability<T>>(inVals.first), inVals.second, flags, cmpFunc,outValue);
+    if (IsFixedAllowed(flags)) {
+        if (auto fixed = Plugin::AnyCast<Plugin::FixedCapability<T>>(&val1)) {
+            return FixedNumericalCapabilityCheck<T, Cmp, flags>(key, *fixed, val2, outValue);
+        }
     }
-    if (IsIntervalAllowed(flags) && Plugin::Any::IsSameTypeWith<Plugin::IntervalCapability<T>>(inVals.first)) {
-        return IntervalNumericalCapabilityCheck(key,
-            Plugin::AnyCast<Plugin::IntervalCapability<T>>(inVals.first), inVals.second, flags, cmpFunc, outValue);
+    if (IsIntervalAllowed(flags)) {
+        if (auto interval = Plugin::AnyCast<Plugin::IntervalCapability<T>>(&val1)) {
+            return IntervalNumericalCapabilityCheck<T, Cmp, flags>(key, *interval, val2, outValue);
+        }
     }
-    if (IsDiscreteAllowed(flags) && Plugin::Any::IsSameTypeWith<Plugin::DiscreteCapability<T>>(inVals.first)) {
-        return DiscreteNumericalCapabilityCheck(key,
-            Plugin::AnyCast<Plugin::DiscreteCapability<T>>(inVals.first), inVals.second, flags, cmpFunc, outValue);
+    if (IsDiscreteAllowed(flags)) {
+        if (auto discrete = Plugin::AnyCast<Plugin::DiscreteCapability<T>>(&val1)) {
+            return DiscreteNumericalCapabilityCheck<T, Cmp, flags>(key, *discrete, val2, outValue);
+        }
     }
     LogOutIncorrectType(key, flags);
     return false;
 }
 
+template <typename T>
+bool ExtractFixedCap(const Plugin::ValueType& value, Plugin::ValueType& fixedValue)
+{
+    if (auto fixed = Plugin::AnyCast<Plugin::FixedCapability<T>>(&value)) {
+        fixedValue = *fixed;
+        return true;
+    } else if (auto interval = Plugin::AnyCast<Plugin::IntervalCapability<T>>(&value)) {
+        fixedValue = interval->first;
+        return true;
+    } else if (auto discrete = Plugin::AnyCast<Plugin::DiscreteCapability<T>>(&value)) {
+        if (!discrete->empty()) {
+            fixedValue = discrete->front();
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+bool FixInvalDiscCapValCheck(CapabilityID key, const Plugin::ValueType& val1, const Plugin::ValueType& val2,
+                             Plugin::ValueType& outValue)
+{
+    return CapabilityValueCheck<T, CapValueCompare<T>, ALLOW_ALL>(key, val1, val2, outValue);
+}
+
+template <typename T, typename U>
+bool FixDiscCapValCheck(CapabilityID key, const Plugin::ValueType& val1, const Plugin::ValueType& val2,
+                        Plugin::ValueType& outValue)
+{
+    return CapabilityValueCheck<T, CapValueCompare<T, U>, ALLOW_FIXED_DISCRETE>(key, val1, val2, outValue);
+}
+
+using CheckFunc = bool (*)(CapabilityID key, const Plugin::ValueType& val1, const Plugin::ValueType& val2,
+    Plugin::ValueType& outValue);
+using ExtractFunc = bool (*)(const Plugin::ValueType& value, Plugin::ValueType& fixedValue);
+
+/// the value type of every capability key, resolved at compile time into plain function pointers
+struct CapabilityKeyOps {
+    CapabilityID key;
+    CheckFunc check;
+    ExtractFunc extract;
+};
+
+static constexpr CapabilityKeyOps g_capabilityKeyOps[] = {
+    {CapabilityID::AUDIO_SAMPLE_RATE, FixInvalDiscCapValCheck<uint32_t>, ExtractFixedCap<uint32_t>},
+    {CapabilityID::AUDIO_CHANNELS, FixInvalDiscCapValCheck<uint32_t>, ExtractFixedCap<uint32_t>},
+    {CapabilityID::AUDIO_CHANNEL_LAYOUT, FixDiscCapValCheck<Plugin::AudioChannelLayout, uint64_t>,
+        ExtractFixedCap<Plugin::AudioChannelLayout>},
+    {CapabilityID::AUDIO_SAMPLE_FORMAT, FixDiscCapValCheck<Plugin::AudioSampleFormat, uint8_t>,
+        ExtractFixedCap<Plugin::AudioSampleFormat>},
+    {CapabilityID::AUDIO_MPEG_VERSION, FixInvalDiscCapValCheck<uint32_t>, ExtractFixedCap<uint32_t>},
+    {CapabilityID::AUDIO_MPEG_LAYER, FixInvalDiscCapValCheck<uint32_t>, ExtractFixedCap<uint32_t>},
+    {CapabilityID::AUDIO_AAC_PROFILE, FixDiscCapValCheck<Plugin::AudioAacProfile, uint8_t>,
+        ExtractFixedCap<Plugin::AudioAacProfile>},
+    {CapabilityID::AUDIO_AAC_LEVEL, FixInvalDiscCapValCheck<uint32_t>, ExtractFixedCap<uint32_t>},
+    {CapabilityID::AUDIO_AAC_STREAM_FORMAT, FixDiscCapValCheck<Plugin::AudioAacStreamFormat, uint8_t>,
+        ExtractFixedCap<Plugin::AudioAacStreamFormat>},
+    {CapabilityID::VIDEO_PIXEL_FORMAT, FixDiscCapValCheck<Plugin::VideoPixelFormat, uint32_t>,
+        ExtractFixedCap<Plugin::VideoPixelFormat>},
+    {CapabilityID::VIDEO_BIT_STREAM_FORMAT, FixDiscCapValCheck<Plugin::VideoBitStreamFormat, uint32_t>,
+        ExtractFixedCap<Plugin::VideoBitStreamFormat>},
+    {CapabilityID::MEDIA_BITRATE, FixInvalDiscCapValCheck<int64_t>, ExtractFixedCap<int64_t>},
+};
+
+static const CapabilityKeyOps* FindCapabilityKeyOps(CapabilityID key)
+{
+    for (const auto& ops : g_capabilityKeyOps) {
+        if (ops.key == key) {
+            return &ops;
+        }
+    }
+    return nullptr;
+}
+
 bool MergeCapabilityKeys(const Capability& originCap, const Capability& otherCap, Capability& resCap)
 {
     resCap.keys.clear();
@@ -373,13 +408,14 @@ bool MergeCapabilityKeys(const Capability& originCap, const Capability& otherCap
             continue;
         }
         // if key is in otherCap, calculate the intersections
-        if (g_capabilityValueCheckMap.count(pairKey.first) == 0) {
+        auto ops = FindCapabilityKeyOps(pairKey.first);
+        if (ops == nullptr) {
             MEDIA_LOG_W("capability " PUBLIC_LOG_S " cannot be applied, may be update the check map?",
                         Plugin::Tag2String(static_cast<Plugin::Tag>(pairKey.first)));
             continue;
         }
         Plugin::ValueType tmp;
-        if (g_capabilityValueCheckMap.at(pairKey.first)(pairKey.first, pairKey.second, oIte->second, tmp)) {
+        if (ops->check(pairKey.first, pairKey.second, oIte->second, tmp)) {
             resCap.keys[pairKey.first] = tmp;
         } else {
             //  if no intersections return false
@@ -423,26 +459,6 @@ bool ApplyCapabilitySet(const Capability& originCap, const CapabilitySet& capabi
     return false;
 }
 
-template <typename T>
-bool ExtractFixedCap(const Plugin::ValueType& value, Plugin::ValueType& fixedValue)
-{
-    if (Plugin::Any::IsSameTypeWith<Plugin::FixedCapability<T>>(value)) {
-        fixedValue = Plugin::AnyCast<Plugin::FixedCapability<T>>(value);
-        return true;
-    } else if (Plugin::Any::IsSameTypeWith<Plugin::IntervalCapability<T>>(value)) {
-        auto tmp = Plugin::AnyCast<Plugin::IntervalCapability<T>>(value);
-        fixedValue = tmp.first;
-        return true;
-    } else if (Plugin::Any::IsSameTypeWith<Plugin::DiscreteCapability<T>>(value)) {
-        auto tmp = Plugin::AnyCast<Plugin::DiscreteCapability<T>>(value);
-        if (!tmp.empty()) {
-            fixedValue = tmp[0];
-            return true;
-        }
-    }
-    return false;
-}
-
 std::shared_ptr<Capability> MetaToCapability(const Plugin::Meta& meta)
 {
     auto ret = std::make_shared<Capability>();
@@ -450,10 +466,10 @@ std::shared_ptr<Capability> MetaToCapability(const Plugin::Meta& meta)
     if (meta.Get<Plugin::Tag::MIME>(mime)) {
         ret->mime = mime;
     }
-    for (const auto& key : g_allCapabilityId) {
+    for (const auto& ops : g_capabilityKeyOps) {
         Plugin::ValueType tmp;
-        if (meta.GetData(static_cast<Plugin::Tag>(key), tmp)) {
-            ret->keys[key] = tmp;
+        if (meta.GetData(static_cast<Plugin::Tag>(ops.key), tmp)) {
+            ret->keys[ops.key] = tmp;
         }
     }
     return ret;
@@ -465,10 +481,10 @@ bool MergeMetaWithCapability(const Plugin::Meta& meta, const Capability& cap, Pl
     // change meta into capability firstly
     Capability metaCap;
     metaCap.mime = cap.mime;
-    for (const auto& key : g_allCapabilityId) {
+    for (const auto& ops : g_capabilityKeyOps) {
         Plugin::ValueType tmp;
-        if (meta.GetData(static_cast<Plugin::Tag>(key), tmp)) {
-            metaCap.keys[key] = tmp;
+        if (meta.GetData(static_cast<Plugin::Tag>(ops.key), tmp)) {
+            metaCap.keys[ops.key] = tmp;
         }
     }
     Capability resCap;
@@ -479,12 +495,12 @@ bool MergeMetaWithCapability(const Plugin::Meta& meta, const Capability& cap, Pl
     resMeta = meta;
     resMeta.Set<Plugin::Tag::MIME>(cap.mime);
     for (const auto& oneCap : resCap.keys) {
-        if (g_capExtrMap.count(oneCap.first) == 0) {
+        auto ops = FindCapabilityKeyOps(oneCap.first);
+        if (ops == nullptr) {
             continue;
         }
-        auto func = g_capExtrMap[oneCap.first];
         Plugin::ValueType tmp;
-        if (func(oneCap.second, tmp)) {
+        if (ops->extract(oneCap.second, tmp)) {
             resMeta.SetData(static_cast<Plugin::Tag>(oneCap.first), tmp);
         }
     }
@@ -31,6 +31,7 @@ static const std::map<EventType, const char*> g_EventTypeMap = {
     {EventType::EVENT_RESOLUTION_CHANGE, "EVENT_RESOLUTION_CHANGE"},
     {EventType::EVENT_VIDEO_RENDERING_START, "EVENT_VIDEO_RENDERING_START"},
     {EventType::EVENT_IS_LIVE_STREAM, "EVENT_IS_LIVE_STREAM"},
+    {EventType::EVENT_AUDIO_SPLICED, "EVENT_AUDIO_SPLICED"},
 };
 
 const char* GetEventName(EventType type)
@@ -139,6 +139,32 @@ FilterState PipelineCore::GetState()
 
 ErrorCode PipelineCore::AddFilters(std::initializer_list<Filter*> filtersIn)
 {
+    auto filtersToAdd = InsertFilters(filtersIn);
+    if (filtersToAdd.empty()) {
+        MEDIA_LOG_I("filters already exists");
+        return ErrorCode::SUCCESS;
+    }
+    InitFilters(filtersToAdd);
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode PipelineCore::AdoptFilters(std::initializer_list<Filter*> filtersIn)
+{
+    for (auto& filterIn : filtersIn) {
+        FALSE_RETURN_V_MSG_E(filterIn->GetOwnerPipeline() == this, ErrorCode::ERROR_INVALID_OPERATION,
+                             "filter " PUBLIC_LOG_S " not initialized by this pipeline", filterIn->GetName().c_str());
+    }
+    (void)InsertFilters(filtersIn);
+    OSAL::ScopedLock lock(standbyMutex_);
+    for (auto& filterIn : filtersIn) {
+        standbyFilters_.erase(filterIn->GetName());
+    }
+    return ErrorCode::SUCCESS;
+}
+
+std::vector<Filter*> PipelineCore::InsertFilters(std::initializer_list<Filter*> filtersIn)
+{
+    OSAL::ScopedLock lock(mutex_);
     std::vector<Filter*> filtersToAdd;
     for (auto& filterIn : filtersIn) {
         bool matched = false;
@@ -152,20 +178,19 @@ ErrorCode PipelineCore::AddFilters(std::initializer_list<Filter*> filtersIn)
             filtersToAdd.push_back(filterIn);
         }
     }
-    if (filtersToAdd.empty()) {
-        MEDIA_LOG_I("filters already exists");
-        return ErrorCode::SUCCESS;
-    }
-    {
-        OSAL::ScopedLock lock(mutex_);
+    if (!filtersToAdd.empty()) {
         this->filters_.insert(this->filters_.end(), filtersToAdd.begin(), filtersToAdd.end());
     }
-    InitFilters(filtersToAdd);
-    return ErrorCode::SUCCESS;
+    return filtersToAdd;
 }
 
 ErrorCode PipelineCore::RemoveFilter(Filter* filter)
 {
+    {
+        OSAL::ScopedLock lock(standbyMutex_);
+        standbyFilters_.erase(filter->GetName());
+    }
+    OSAL::ScopedLock lock(mutex_);
     auto it = std::find_if(filters_.begin(), filters_.end(),
                            [&filter](const Filter* filterPtr) { return filterPtr == filter; });
     if (it != filters_.end()) {
@@ -226,6 +251,10 @@ void PipelineCore::OnEvent(const Event& event)
         NotifyEvent(event);
         return;
     }
+    if (IsStandbyFilter(event.srcFilter)) {
+        MEDIA_LOG_D("standby filter " PUBLIC_LOG_S " ready", event.srcFilter.c_str());
+        return;
+    }
 
     readyEventCnt_++;
     MEDIA_LOG_I("OnEvent readyCnt: " PUBLIC_LOG_ZU " / " PUBLIC_LOG_ZU, readyEventCnt_, filters_.size());
@@ -243,6 +272,23 @@ void PipelineCore::InitFilters(const std::vector<Filter*>& filters)
     }
 }
 
+void PipelineCore::InitStandbyFilters(const std::vector<Filter*>& filters)
+{
+    {
+        OSAL::ScopedLock lock(standbyMutex_);
+        for (auto& filter : filters) {
+            standbyFilters_.insert(filter->GetName());
+        }
+    }
+    InitFilters(filters);
+}
+
+bool PipelineCore::IsStandbyFilter(const std::string& name)
+{
+    OSAL::ScopedLock lock(standbyMutex_);
+    return standbyFilters_.count(name) != 0;
+}
+
 namespace {
 struct FilterNode {
     size_t inDegree {0};
@@ -17,8 +17,10 @@
 
 #include "plugin_utils.h"
 #include <cstdarg>
+#include <map>
 #include <sstream>
 #include "foundation/log.h"
+#include "foundation/osal/thread/scoped_lock.h"
 #include "foundation/pre_defines.h"
 #include "plugin/common/plugin_attr_desc.h"
 
@@ -282,6 +284,101 @@ std::map<Plugin::Tag, CapStrnessFunc> g_metaStrnessMap = {
     {Plugin::Tag::VIDEO_BIT_STREAM_FORMAT, MetaIDStringiness<Plugin::VideoBitStreamFormat>},
     {Plugin::Tag::BITS_PER_CODED_SAMPLE, MetaIDStringiness<uint32_t>},
 };
+
+using AvailablePlugins = std::vector<std::pair<std::shared_ptr<Plugin::PluginInfo>, Plugin::Capability>>;
+
+constexpr size_t MAX_NEGOTIATION_CACHE_SIZE = 64; // 64: links of a few graphs, dropped as a whole when full
+
+struct NegotiationCache {
+    OSAL::Mutex mutex {};
+    uint64_t generation {0};
+    std::map<std::string, AvailablePlugins> entries;
+};
+
+NegotiationCache& GetNegotiationCache()
+{
+    static NegotiationCache cache;
+    return cache;
+}
+
+void AppendScalar(std::string& key, const std::string& val)
+{
+    key.append(std::to_string(val.size())).append(":").append(val);
+}
+
+template <typename T>
+void AppendScalar(std::string& key, const T& val)
+{
+    key.append(std::to_string(static_cast<int64_t>(val)));
+}
+
+template <typename T>
+bool AppendCapValue(std::string& key, const Plugin::ValueType& val)
+{
+    if (Plugin::Any::IsSameTypeWith<Plugin::FixedCapability<T>>(val)) {
+        key.append("=");
+        AppendScalar(key, *Plugin::AnyCast<T>(&val));
+    } else if (Plugin::Any::IsSameTypeWith<Plugin::IntervalCapability<T>>(val)) {
+        auto item = Plugin::AnyCast<Plugin::IntervalCapability<T>>(&val);
+        key.append("[");
+        AppendScalar(key, item->first);
+        key.append(",");
+        AppendScalar(key, item->second);
+    } else if (Plugin::Any::IsSameTypeWith<Plugin::DiscreteCapability<T>>(val)) {
+        key.append("{");
+        for (const auto& item : *Plugin::AnyCast<Plugin::DiscreteCapability<T>>(&val)) {
+            AppendScalar(key, item);
+            key.append(",");
+        }
+    } else {
+        return false;
+    }
+    key.append(";");
+    return true;
+}
+
+/**
+ * Key of the negotiation cache, the whole upstream capability with exact values. Returns false if a value is of
+ * a type not listed here, such a capability is always negotiated against the plugins.
+ */
+bool NegotiationKey(const Plugin::Capability& upStreamCaps, Plugin::PluginType pluginType,
+                    Plugin::CodecMode preferredCodecMode, std::string& key)
+{
+    key.append(std::to_string(static_cast<int32_t>(pluginType))).append("|")
+        .append(std::to_string(static_cast<int32_t>(preferredCodecMode))).append("|");
+    AppendScalar(key, upStreamCaps.mime);
+    for (const auto& pairKey : upStreamCaps.keys) {
+        key.append("|").append(std::to_string(static_cast<uint32_t>(pairKey.first)));
+        const auto& val = pairKey.second;
+        bool appended = AppendCapValue<uint32_t>(key, val) || AppendCapValue<int32_t>(key, val) ||
+            AppendCapValue<int64_t>(key, val) || AppendCapValue<uint64_t>(key, val) ||
+            AppendCapValue<std::string>(key, val) || AppendCapValue<Plugin::AudioChannelLayout>(key, val) ||
+            AppendCapValue<Plugin::AudioSampleFormat>(key, val) || AppendCapValue<Plugin::AudioAacProfile>(key, val) ||
+            AppendCapValue<Plugin::AudioAacStreamFormat>(key, val) ||
+            AppendCapValue<Plugin::VideoPixelFormat>(key, val) ||
+            AppendCapValue<Plugin::VideoBitStreamFormat>(key, val);
+        if (!appended) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AvailablePlugins NegotiatePlugins(const Plugin::Capability& upStreamCaps, Plugin::PluginType pluginType,
+                                  Plugin::CodecMode preferredCodecMode)
+{
+    auto pluginNames = Plugin::PluginManager::Instance().ListPluginsByInputMime(pluginType, upStreamCaps.mime,
+                                                                               preferredCodecMode);
+    AvailablePlugins infos;
+    for (const auto& name : pluginNames) {
+        auto tmpInfo = Plugin::PluginManager::Instance().GetPluginInfo(pluginType, name);
+        Plugin::Capability cap;
+        if (tmpInfo != nullptr && Pipeline::ApplyCapabilitySet(upStreamCaps, tmpInfo->inCaps, cap)) {
+            infos.emplace_back(tmpInfo, cap);
+        }
+    }
+    return infos;
+}
 }
 
 namespace OHOS {
@@ -360,14 +457,30 @@ bool TranslateIntoParameter(const int& key, OHOS::Media::Plugin::Tag& tag)
 std::vector<std::pair<std::shared_ptr<Plugin::PluginInfo>, Plugin::Capability>> FindAvailablePlugins(
     const Plugin::Capability& upStreamCaps, Plugin::PluginType pluginType, Plugin::CodecMode preferredCodecMode)
 {
-    auto pluginNames = Plugin::PluginManager::Instance().ListPlugins(pluginType, preferredCodecMode);
-    std::vector<std::pair<std::shared_ptr<Plugin::PluginInfo>, Plugin::Capability>> infos;
-    for (const auto& name : pluginNames) {
-        auto tmpInfo = Plugin::PluginManager::Instance().GetPluginInfo(pluginType, name);
-        Capability cap;
-        if (ApplyCapabilitySet(upStreamCaps, tmpInfo->inCaps, cap)) {
-            infos.emplace_back(tmpInfo, cap);
+    std::string key;
+    if (!NegotiationKey(upStreamCaps, pluginType, preferredCodecMode, key)) {
+        return NegotiatePlugins(upStreamCaps, pluginType, preferredCodecMode);
+    }
+    auto& cache = GetNegotiationCache();
+    auto generation = Plugin::PluginManager::Instance().GetRegisterGeneration();
+    {
+        OSAL::ScopedLock lock(cache.mutex);
+        if (cache.generation != generation) {
+            cache.entries.clear();
+            cache.generation = generation;
+        }
+        auto ite = cache.entries.find(key);
+        if (ite != cache.entries.end()) {
+            return ite->second;
+        }
+    }
+    auto infos = NegotiatePlugins(upStreamCaps, pluginType, preferredCodecMode);
+    OSAL::ScopedLock lock(cache.mutex);
+    if (cache.generation == generation) {
+        if (cache.entries.size() >= MAX_NEGOTIATION_CACHE_SIZE) {
+            cache.entries.clear();
         }
+        cache.entries[key] = infos;
     }
     return infos;
 }
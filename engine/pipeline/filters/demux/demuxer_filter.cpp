@@ -193,16 +193,21 @@ void DemuxerFilter::FlushEnd()
     }
 }
 
+// parameters set before the media is known, e.g. the seek index dir, are kept and applied once its plugin is
 ErrorCode DemuxerFilter::SetParameter(int32_t key, const Plugin::Any& value)
 {
-    FALSE_RETURN_V_MSG(plugin_ != nullptr, ErrorCode::ERROR_INVALID_OPERATION, "plugin is nullptr");
-    return TranslatePluginStatus(plugin_->SetParameter(static_cast<Plugin::Tag>(key), value));
+    auto tag = static_cast<Plugin::Tag>(key);
+    pluginParameters_[tag] = value;
+    if (plugin_ == nullptr) {
+        return ErrorCode::SUCCESS;
+    }
+    return TranslatePluginStatus(plugin_->SetParameter(tag, value));
 }
 
 ErrorCode DemuxerFilter::GetParameter(int32_t key, Plugin::Any& value)
 {
     FALSE_RETURN_V_MSG(plugin_ != nullptr, ErrorCode::ERROR_INVALID_OPERATION, "plugin is nullptr");
-    return TranslatePluginStatus(plugin_->SetParameter(static_cast<Plugin::Tag>(key), value));
+    return TranslatePluginStatus(plugin_->GetParameter(static_cast<Plugin::Tag>(key), value));
 }
 
 ErrorCode DemuxerFilter::Prepare()
@@ -334,6 +339,10 @@ bool DemuxerFilter::InitPlugin(std::string pluginName)
         }
     }
     MEDIA_LOG_I("InitPlugin, " PUBLIC_LOG_S " used.", pluginName_.c_str());
+    for (const auto& parameter : pluginParameters_) {
+        (void)plugin_->SetParameter(parameter.first, parameter.second);
+    }
+    (void)plugin_->SetParameter(Plugin::Tag::MEDIA_FILE_URI, uri_); // lets the plugin find the seek index of the file
     (void)plugin_->SetDataSource(std::reinterpret_pointer_cast<Plugin::DataSourceHelper>(dataSource_));
     pluginState_ = DemuxerState::DEMUXER_STATE_PARSE_HEADER;
     return plugin_->Prepare() == Plugin::Status::OK;
@@ -559,10 +568,16 @@ void DemuxerFilter::UpdateStreamMeta(std::shared_ptr<Plugin::Meta>& streamMeta,
         FALSE_LOG(streamMeta->Set<Plugin::Tag::AUDIO_OUTPUT_CHANNEL_LAYOUT>(outputChannelLayout));
     } else if (type == Plugin::MediaType::VIDEO) {
         if (negotiatedCap.keys.count(Capability::Key::VIDEO_BIT_STREAM_FORMAT)) {
-            auto vecVdBitStreamFormat = Plugin::AnyCast<std::vector<Plugin::VideoBitStreamFormat>>(
-                negotiatedCap.keys[Capability::Key::VIDEO_BIT_STREAM_FORMAT]);
-            if (!vecVdBitStreamFormat.empty()) {
-                (void)plugin_->SetParameter(Tag::VIDEO_BIT_STREAM_FORMAT, vecVdBitStreamFormat[0]);
+            // a list if downstream takes several formats, the one format it takes otherwise
+            const auto& value = negotiatedCap.keys[Capability::Key::VIDEO_BIT_STREAM_FORMAT];
+            if (Plugin::Any::IsSameTypeWith<Plugin::VideoBitStreamFormat>(value)) {
+                (void)plugin_->SetParameter(Tag::VIDEO_BIT_STREAM_FORMAT,
+                                            Plugin::AnyCast<Plugin::VideoBitStreamFormat>(value));
+            } else {
+                auto vecVdBitStreamFormat = Plugin::AnyCast<std::vector<Plugin::VideoBitStreamFormat>>(value);
+                if (!vecVdBitStreamFormat.empty()) {
+                    (void)plugin_->SetParameter(Tag::VIDEO_BIT_STREAM_FORMAT, vecVdBitStreamFormat[0]);
+                }
             }
         }
     }
@@ -17,7 +17,10 @@
 
 #include "type_finder.h"
 #include <algorithm>
+#include <map>
 #include "foundation/log.h"
+#include "foundation/osal/thread/scoped_lock.h"
+#include "foundation/osal/thread/thread.h"
 #include "foundation/osal/utils/util.h"
 #include "foundation/utils/steady_clock.h"
 
@@ -25,6 +28,24 @@ namespace OHOS {
 namespace Media {
 namespace Pipeline {
 namespace {
+constexpr size_t PROBE_WINDOW_SIZE = 64 * 1024; // covers the head read by every demuxer sniffer
+constexpr size_t MAX_SNIFF_THREADS = 4;
+constexpr size_t MAX_SNIFF_CACHE_SIZE = 64;
+
+OSAL::Mutex g_sniffCacheMutex;
+std::map<uint64_t, std::string> g_sniffCache;
+
+uint64_t HashContent(const std::vector<uint8_t>& data, uint64_t mediaDataSize)
+{
+    constexpr uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+    constexpr uint64_t fnvPrime = 1099511628211ULL;
+    uint64_t hash = fnvOffsetBasis ^ mediaDataSize;
+    for (auto byte : data) {
+        hash = (hash ^ byte) * fnvPrime;
+    }
+    return hash;
+}
+
 std::string GetUriSuffix(const std::string& uri)
 {
     std::string suffix {""};
@@ -70,7 +91,11 @@ TypeFinder::TypeFinder()
       task_(nullptr),
       checkRange_(),
       peekRange_(),
-      typeFound_()
+      typeFound_(),
+      probeWindow_(),
+      probeWindowEos_(false),
+      sniffStats_(),
+      lastSniffStats_()
 {
     MEDIA_LOG_D("TypeFinder ctor called...");
 }
@@ -146,6 +171,11 @@ Plugin::Status TypeFinder::ReadAt(int64_t offset, std::shared_ptr<Plugin::Buffer
                     PUBLIC_LOG_D64, !buffer, expectedLen, offset);
         return Plugin::Status::ERROR_INVALID_PARAMETER;
     }
+    if (ReadProbeWindow(offset, buffer, expectedLen)) {
+        return Plugin::Status::OK;
+    }
+    OSAL::ScopedLock lock(readMutex_); // sniffers run concurrently, reads beyond the probe window are serialized
+    sniffStats_.sourceReads++;
     const int maxTryTimes = 3;
     int i = 0;
     while (!checkRange_(offset, expectedLen) && (i++ < maxTryTimes)) {
@@ -170,6 +200,12 @@ Plugin::Seekable TypeFinder::GetSeekable()
     return Plugin::Seekable::INVALID;
 }
 
+SniffStats TypeFinder::GetSniffStats() const
+{
+    OSAL::ScopedLock lock(readMutex_);
+    return lastSniffStats_;
+}
+
 void TypeFinder::DoTask()
 {
     if (sniffNeeded_) {
@@ -186,27 +222,127 @@ void TypeFinder::DoTask()
 std::string TypeFinder::SniffMediaType()
 {
     PROFILE_BEGIN("SniffMediaType begin.");
-    constexpr int probThresh = 50; // valid range [0, 100]
+    SteadyClock clock;
+    sniffStats_ = SniffStats {};
     std::string pluginName;
-    int maxProb = 0;
+    uint64_t contentKey = 0;
+    bool windowLoaded = LoadProbeWindow();
+    if (windowLoaded) {
+        contentKey = HashContent(probeWindow_, mediaDataSize_);
+        OSAL::ScopedLock lock(g_sniffCacheMutex);
+        auto ite = g_sniffCache.find(contentKey);
+        if (ite != g_sniffCache.end() && std::any_of(plugins_.begin(), plugins_.end(),
+            [&ite](const std::shared_ptr<Plugin::PluginInfo>& plugin) { return plugin->name == ite->second; })) {
+            pluginName = ite->second;
+            sniffStats_.cacheHit = true;
+        }
+    }
+    if (pluginName.empty()) {
+        pluginName = SniffConcurrently();
+        if (windowLoaded && !pluginName.empty()) {
+            OSAL::ScopedLock lock(g_sniffCacheMutex);
+            if (g_sniffCache.size() >= MAX_SNIFF_CACHE_SIZE) {
+                g_sniffCache.clear();
+            }
+            g_sniffCache[contentKey] = pluginName;
+        }
+    }
+    std::vector<uint8_t>().swap(probeWindow_);
+    probeWindowEos_ = false;
+    sniffStats_.elapsedUs = clock.ElapsedMicroseconds();
+    {
+        OSAL::ScopedLock lock(readMutex_);
+        lastSniffStats_ = sniffStats_;
+    }
+    MEDIA_LOG_I("SniffMediaType " PUBLIC_LOG_S " selected in " PUBLIC_LOG_D64 " us, sniffed plugin num = "
+                PUBLIC_LOG_U32 ", source reads = " PUBLIC_LOG_U32 ", cache hit = " PUBLIC_LOG_D32, pluginName.c_str(),
+                sniffStats_.elapsedUs, sniffStats_.sniffedPlugins, sniffStats_.sourceReads, sniffStats_.cacheHit);
+    PROFILE_END("SniffMediaType end, sniffed plugin num = " PUBLIC_LOG_U32, sniffStats_.sniffedPlugins);
+    return pluginName;
+}
+
+/**
+ * Run the sniffers of plugins_ on a few threads, they are claimed in priority order. Once one of them exceeds
+ * probThresh, the plugins after it are not sniffed any more, while those before it are all claimed already and still
+ * finish, so the result is the same as sniffing one by one.
+ */
+std::string TypeFinder::SniffConcurrently()
+{
+    constexpr int probThresh = 50; // valid range [0, 100]
     auto dataSource = shared_from_this();
-    int cnt = 0;
-    for (const auto& plugin : plugins_) {
-        auto prob = Plugin::PluginManager::Instance().Sniffer(plugin->name, dataSource);
-        ++cnt;
-        if (prob > probThresh) {
-            pluginName = plugin->name;
-            break;
+    const size_t total = plugins_.size();
+    std::vector<int32_t> probs(total, 0);
+    std::atomic<size_t> next {0};
+    std::atomic<size_t> stopAt {total};
+    std::atomic<uint32_t> cnt {0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < stopAt.load(); i = next++) {
+            probs[i] = Plugin::PluginManager::Instance().Sniffer(plugins_[i]->name, dataSource);
+            ++cnt;
+            if (probs[i] <= probThresh) {
+                continue;
+            }
+            size_t current = stopAt.load();
+            while (i < current && !stopAt.compare_exchange_weak(current, i)) {
+            }
         }
-        if (prob > maxProb) {
-            maxProb = prob;
-            pluginName = plugin->name;
+    };
+    {
+        std::vector<OSAL::Thread> helpers(std::min(total, MAX_SNIFF_THREADS) - (total > 0 ? 1 : 0));
+        for (auto& helper : helpers) {
+            helper.SetName("TypeFinderSniff");
+            helper.CreateThread(worker);
+        }
+        worker();
+    } // the helpers are joined here
+    sniffStats_.sniffedPlugins = cnt.load();
+    if (stopAt.load() < total) {
+        return plugins_[stopAt.load()]->name;
+    }
+    std::string pluginName;
+    int maxProb = 0;
+    for (size_t i = 0; i < total; ++i) {
+        if (probs[i] > maxProb) {
+            maxProb = probs[i];
+            pluginName = plugins_[i]->name;
         }
     }
-    PROFILE_END("SniffMediaType end, sniffed plugin num = " PUBLIC_LOG_D32, cnt);
     return pluginName;
 }
 
+/**
+ * Read the head of the media once, the sniffers are served from it instead of reading the source one by one.
+ */
+bool TypeFinder::LoadProbeWindow()
+{
+    size_t windowSize = PROBE_WINDOW_SIZE;
+    if (mediaDataSize_ > 0 && mediaDataSize_ < windowSize) {
+        windowSize = static_cast<size_t>(mediaDataSize_);
+    }
+    auto buffer = std::make_shared<AVBuffer>();
+    auto memory = buffer->AllocMemory(nullptr, windowSize);
+    sniffStats_.sourceReads++;
+    if (!checkRange_(0, windowSize) || !peekRange_(0, windowSize, buffer) || memory->GetSize() == 0) {
+        MEDIA_LOG_W("LoadProbeWindow failed, sniffers read the source directly");
+        return false;
+    }
+    probeWindow_.assign(memory->GetReadOnlyData(), memory->GetReadOnlyData() + memory->GetSize());
+    probeWindowEos_ = mediaDataSize_ > 0 && probeWindow_.size() >= mediaDataSize_;
+    return true;
+}
+
+bool TypeFinder::ReadProbeWindow(int64_t offset, std::shared_ptr<Plugin::Buffer>& buffer, size_t expectedLen)
+{
+    auto start = static_cast<uint64_t>(offset);
+    if (offset < 0 || start >= probeWindow_.size() ||
+        (start + expectedLen > probeWindow_.size() && !probeWindowEos_)) {
+        return false;
+    }
+    auto memory = buffer->IsEmpty() ? buffer->AllocMemory(nullptr, expectedLen) : buffer->GetMemory();
+    memory->Write(probeWindow_.data() + start, std::min<uint64_t>(expectedLen, probeWindow_.size() - start), 0);
+    return true;
+}
+
 std::string TypeFinder::GuessMediaType() const
 {
     std::string pluginName;
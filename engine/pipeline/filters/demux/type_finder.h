@@ -20,6 +20,8 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
+#include "foundation/osal/thread/mutex.h"
 #include "foundation/osal/thread/task.h"
 #include "pipeline/core/type_define.h"
 #include "plugin/core/plugin_manager.h"
@@ -27,6 +29,13 @@
 namespace OHOS {
 namespace Media {
 namespace Pipeline {
+struct SniffStats {
+    int64_t elapsedUs {0};     // time from the start of sniffing until a demuxer is selected
+    uint32_t sniffedPlugins {0};
+    uint32_t sourceReads {0};  // reads that reached the upstream source, the probe window included
+    bool cacheHit {false};
+};
+
 class TypeFinder : public std::enable_shared_from_this<TypeFinder>, public Plugin::DataSourceHelper {
 public:
     TypeFinder();
@@ -46,11 +55,20 @@ public:
 
     Plugin::Seekable GetSeekable() override;
 
+    /// statistics of the latest sniff, for verification
+    SniffStats GetSniffStats() const;
+
 private:
     void DoTask();
 
     std::string SniffMediaType();
 
+    std::string SniffConcurrently();
+
+    bool LoadProbeWindow();
+
+    bool ReadProbeWindow(int64_t offset, std::shared_ptr<Plugin::Buffer>& buffer, size_t expectedLen);
+
     std::string GuessMediaType() const;
 
     bool IsOffsetValid(int64_t offset) const;
@@ -71,6 +89,11 @@ private:
     std::function<bool(uint64_t, size_t)> checkRange_;
     std::function<bool(uint64_t, size_t, AVBufferPtr&)> peekRange_;
     std::function<void(std::string)> typeFound_;
+    std::vector<uint8_t> probeWindow_;
+    bool probeWindowEos_;
+    mutable OSAL::Mutex readMutex_;
+    SniffStats sniffStats_;     // of the sniff in progress, only the task thread and its sniffers touch it
+    SniffStats lastSniffStats_; // published under readMutex_ once a sniff has finished
 };
 } // namespace Pipeline
 } // namespace Media
@@ -17,11 +17,13 @@
 #define HST_LOG_TAG "MuxerFilter"
 
 #include "pipeline/filters/muxer/muxer_filter.h"
+#include <algorithm>
 #include "foundation/log.h"
 #include "pipeline/factory/filter_factory.h"
 #include "pipeline/filters/common/plugin_settings.h"
 #include "pipeline/filters/common/plugin_utils.h"
 #include "pipeline/filters/muxer/data_spliter.h"
+#include "pipeline/filters/muxer/muxer_interleaver.h"
 #include "plugin/common/plugin_attr_desc.h"
 
 namespace OHOS {
@@ -42,16 +44,38 @@ std::vector<std::shared_ptr<Plugin::PluginInfo>> Intersections(
     }
     return intersections;
 }
+
+// the cap of a track as the muxer plugins of the container take it, e.g. with the bit stream format they need
+bool FindTrackCap(const std::string& containerMime, const Plugin::Capability& upstreamCap,
+                  Plugin::Capability& trackCap)
+{
+    auto containerPlugins = FindAvailablePluginsByOutputMime(containerMime, Plugin::PluginType::MUXER);
+    for (const auto& available : FindAvailablePlugins(upstreamCap, Plugin::PluginType::MUXER)) {
+        for (const auto& info : containerPlugins) {
+            if (info->name == available.first->name) {
+                trackCap = available.second;
+                return true;
+            }
+        }
+    }
+    return false;
+}
 }
 static AutoRegisterFilter<MuxerFilter> g_registerFilterHelper("builtin.recorder.muxer");
 
 MuxerFilter::MuxerFilter(std::string name) : FilterBase(std::move(name)),
-    muxerDataSink_(std::make_shared<MuxerDataSink>())
+    muxerDataSink_(std::make_shared<MuxerDataSink>()),
+    interleaver_(std::make_shared<MuxerInterleaver>([this](const AVBufferPtr& buffer) {
+        WriteInterleavedFrame(buffer);
+    }))
 {
     filterType_ = FilterType::MUXER;
 }
 
-MuxerFilter::~MuxerFilter() {}
+MuxerFilter::~MuxerFilter()
+{
+    interleaver_->Stop();
+}
 void MuxerFilter::Init(EventReceiver* receiver, FilterCallback* callback)
 {
     this->eventReceiver_ = receiver;
@@ -105,6 +129,11 @@ bool MuxerFilter::Negotiate(const std::string& inPort,
         return false;
     }
     hasWriteHeader_ = false;
+    if (!FindTrackCap(containerMime_, *upstreamCap, negotiatedCap)) {
+        MEDIA_LOG_E("no muxer of " PUBLIC_LOG_S " takes track of " PUBLIC_LOG_S, containerMime_.c_str(),
+                    upstreamCap->mime.c_str());
+        return false;
+    }
     capabilityCache_.emplace_back(std::make_pair(inPort, *upstreamCap));
     if (capabilityCache_.size() < inPorts_.size()) {
         return true;
@@ -139,7 +168,8 @@ ErrorCode MuxerFilter::AddTrackThenConfigure(const std::pair<std::string, Plugin
         MEDIA_LOG_E("muxer plugin add track failed");
         return isTranSuccess;
     }
-    trackInfos_.emplace_back(TrackInfo{static_cast<int32_t>(trackId), metaPair.first, false});
+    trackInfos_.emplace_back(TrackInfo{static_cast<int32_t>(trackId), metaPair.first, false,
+                                       interleaver_->AddTrack()});
     auto parameterMap = PluginParameterTable::GetInstance().FindAllowedParameterMap(filterType_);
     for (const auto& keyPair : parameterMap) {
         Plugin::ValueType outValue;
@@ -163,6 +193,9 @@ ErrorCode MuxerFilter::AddTrackThenConfigure(const std::pair<std::string, Plugin
 ErrorCode MuxerFilter::ConfigureToStart()
 {
     ErrorCode ret;
+    trackInfos_.clear();
+    interleaver_->ClearTracks();
+    eosTrackCnt = 0;
     for (const auto& cache: metaCache_) {
         ret = AddTrackThenConfigure(cache);
         if (ret != ErrorCode::SUCCESS) {
@@ -246,6 +279,12 @@ ErrorCode MuxerFilter::SetMaxSize(uint64_t maxSize)
     return ErrorCode::SUCCESS;
 }
 
+ErrorCode MuxerFilter::SetMaxInterleaveDelta(int64_t maxDelta)
+{
+    interleaver_->SetMaxInterleaveDelta(maxDelta);
+    return ErrorCode::SUCCESS;
+}
+
 ErrorCode MuxerFilter::StartNextSegment()
 {
     return ErrorCode::SUCCESS;
@@ -253,8 +292,18 @@ ErrorCode MuxerFilter::StartNextSegment()
 
 ErrorCode MuxerFilter::SendEos()
 {
-    OSAL::ScopedLock lock(pushDataMutex_);
     MEDIA_LOG_I("SendEos entered.");
+    interleaver_->Drain();
+    FinishMuxing();
+    return ErrorCode::SUCCESS;
+}
+
+void MuxerFilter::FinishMuxing()
+{
+    OSAL::ScopedLock lock(pushDataMutex_);
+    if (eos_) {
+        return;
+    }
     eos_ = true;
     if (hasWriteHeader_ && plugin_) {
         plugin_->WriteTrailer();
@@ -264,18 +313,17 @@ ErrorCode MuxerFilter::SendEos()
     buf->flag |= BUFFER_FLAG_EOS;
     outPorts_[0]->PushData(buf, -1);
     metaCache_.clear();
-    return ErrorCode::SUCCESS;
 }
 
 bool MuxerFilter::AllTracksEos()
 {
     return static_cast<size_t>(eosTrackCnt.load()) == trackInfos_.size();
 }
-void MuxerFilter::UpdateEosState(const std::string& inPort)
+void MuxerFilter::UpdateEosState(uint32_t trackId)
 {
     int32_t eosCnt = 0;
     for (auto& item : trackInfos_) {
-        if (item.inPort == inPort) {
+        if (item.trackId == static_cast<int32_t>(trackId)) {
             item.eos = true;
         }
         if (item.eos) {
@@ -286,35 +334,52 @@ void MuxerFilter::UpdateEosState(const std::string& inPort)
 }
 
 ErrorCode MuxerFilter::PushData(const std::string& inPort, const AVBufferPtr& buffer, int64_t offset)
+{
+    if (state_ != FilterState::READY && state_ != FilterState::PAUSED && state_ != FilterState::RUNNING) {
+        MEDIA_LOG_W("pushing data to muxer when state is " PUBLIC_LOG_D32, static_cast<int>(state_.load()));
+        return ErrorCode::ERROR_INVALID_OPERATION;
+    }
+    if (eos_) {
+        MEDIA_LOG_D("SendEos exit");
+        return ErrorCode::SUCCESS;
+    }
+    auto ite = std::find_if(trackInfos_.begin(), trackInfos_.end(),
+                            [&inPort](const TrackInfo& info) { return info.inPort == inPort; });
+    if (ite == trackInfos_.end()) {
+        MEDIA_LOG_E("no track found for inPort " PUBLIC_LOG_S, inPort.c_str());
+        return ErrorCode::ERROR_INVALID_PARAMETER_VALUE;
+    }
+    buffer->trackID = static_cast<uint32_t>(ite->trackId);
+    // frames are written by the interleaver task, encoder threads return immediately
+    if (!interleaver_->PushFrame(ite->interleaveIndex, buffer)) {
+        return ErrorCode::ERROR_AGAIN;
+    }
+    return ErrorCode::SUCCESS;
+}
+
+void MuxerFilter::WriteInterleavedFrame(const AVBufferPtr& buffer)
 {
     {
         OSAL::ScopedLock lock(pushDataMutex_);
-        if (state_ != FilterState::READY && state_ != FilterState::PAUSED && state_ != FilterState::RUNNING) {
-            MEDIA_LOG_W("pushing data to muxer when state is " PUBLIC_LOG_D32, static_cast<int>(state_.load()));
-            return ErrorCode::ERROR_INVALID_OPERATION;
-        }
         if (eos_) {
-            MEDIA_LOG_D("SendEos exit");
-            return ErrorCode::SUCCESS;
+            return;
         }
-        // todo we should consider more tracks
         if (!hasWriteHeader_) {
             plugin_->WriteHeader();
             hasWriteHeader_ = true;
         }
-        if (buffer->GetMemory()->GetSize() != 0) {
+        if (buffer->GetMemory() != nullptr && buffer->GetMemory()->GetSize() != 0) {
             plugin_->WriteFrame(buffer);
         }
 
         if (buffer->flag & BUFFER_FLAG_EOS) {
             MEDIA_LOG_I("It is EOS buffer");
-            UpdateEosState(inPort);
+            UpdateEosState(buffer->trackID);
         }
     }
     if (AllTracksEos()) {
-        SendEos();
+        FinishMuxing();
     }
-    return ErrorCode::SUCCESS;
 }
 
 Plugin::Status MuxerFilter::MuxerDataSink::WriteAt(int64_t offset, const std::shared_ptr<Plugin::Buffer> &buffer)
@@ -328,8 +393,17 @@ Plugin::Status MuxerFilter::MuxerDataSink::WriteAt(int64_t offset, const std::sh
 ErrorCode MuxerFilter::Start()
 {
     eos_ = false;
+    interleaver_->Start();
     return FilterBase::Start();
 }
+
+ErrorCode MuxerFilter::Stop()
+{
+    interleaver_->Stop();
+    // frames queued before stop are still written, the trailer follows if all tracks have reached eos
+    interleaver_->Drain();
+    return FilterBase::Stop();
+}
 } // Pipeline
 } // Media
 } // OHOS
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "MuxerInterleaver"
+
+#include "pipeline/filters/muxer/muxer_interleaver.h"
+#include <algorithm>
+#include "foundation/cpp_ext/memory_ext.h"
+#include "foundation/log.h"
+#include "foundation/osal/thread/scoped_lock.h"
+
+namespace OHOS {
+namespace Media {
+namespace Pipeline {
+namespace {
+constexpr int WAIT_FRAME_TIMEOUT_MS = 10;
+
+bool HasPayload(const AVBufferPtr& buffer)
+{
+    return !buffer->IsEmpty() && buffer->GetMemory()->GetSize() != 0;
+}
+}
+
+MuxerInterleaver::MuxerInterleaver(FrameWriter writer, size_t queueCapacity)
+    : writer_(std::move(writer)), queueCapacity_(queueCapacity)
+{
+}
+
+MuxerInterleaver::~MuxerInterleaver()
+{
+    Stop();
+}
+
+size_t MuxerInterleaver::AddTrack()
+{
+    tracks_.emplace_back(CppExt::make_unique<TrackQueue>(queueCapacity_));
+    return tracks_.size() - 1;
+}
+
+void MuxerInterleaver::ClearTracks()
+{
+    OSAL::ScopedLock lock(writeMutex_);
+    tracks_.clear();
+    baseTimestamp_ = INT64_MIN;
+    lastWrittenTimestamp_ = INT64_MIN;
+    stats_ = InterleaverStats {};
+    producerStalls_ = 0;
+}
+
+void MuxerInterleaver::SetMaxInterleaveDelta(int64_t delta)
+{
+    maxInterleaveDelta_ = delta < 0 ? 0 : delta;
+}
+
+void MuxerInterleaver::Start()
+{
+    if (task_ == nullptr) {
+        task_ = CppExt::make_unique<OSAL::Task>("MuxerInterleaver", [this] { InterleaveLoop(); });
+    }
+    running_ = true;
+    task_->Start();
+}
+
+void MuxerInterleaver::Stop()
+{
+    running_ = false;
+    frameArrived_.NotifyAll();
+    {
+        OSAL::ScopedLock lock(spaceMutex_);
+        spaceFreed_.NotifyAll();
+    }
+    if (task_ != nullptr) {
+        task_->Stop();
+    }
+}
+
+bool MuxerInterleaver::PushFrame(size_t trackIndex, const AVBufferPtr& buffer)
+{
+    FALSE_RETURN_V(trackIndex < tracks_.size() && buffer != nullptr, false);
+    auto& track = *tracks_[trackIndex];
+    while (!track.queue.TryPush(buffer)) {
+        if (!running_) {
+            MEDIA_LOG_W("track " PUBLIC_LOG_ZU " queue is full while interleaver is not running", trackIndex);
+            return false;
+        }
+        producerStalls_++;
+        framePending_ = true;
+        frameArrived_.NotifyOne();
+        OSAL::ScopedLock lock(spaceMutex_);
+        spaceFreed_.Wait(lock, [this, &track] { return track.queue.Size() < track.queue.Capacity() || !running_; });
+    }
+    if (HasPayload(buffer)) {
+        track.lastPushedTimestamp = GetTimestamp(buffer);
+    }
+    framePending_ = true;
+    frameArrived_.NotifyOne();
+    return true;
+}
+
+void MuxerInterleaver::Drain()
+{
+    OSAL::ScopedLock lock(writeMutex_);
+    while (WriteNextFrameUnprotected(true)) {
+    }
+}
+
+InterleaverStats MuxerInterleaver::GetStats()
+{
+    OSAL::ScopedLock lock(writeMutex_);
+    auto stats = stats_;
+    stats.producerStalls = producerStalls_.load();
+    return stats;
+}
+
+int64_t MuxerInterleaver::GetTimestamp(const AVBufferPtr& buffer)
+{
+    // audio encoders only fill pts, whose dts equals to pts, a dts of 0 is a valid one if flagged
+    return (buffer->flag & BUFFER_FLAG_DTS_VALID) ? buffer->dts : buffer->pts;
+}
+
+void MuxerInterleaver::InterleaveLoop()
+{
+    {
+        OSAL::ScopedLock lock(writeMutex_);
+        while (running_ && WriteNextFrameUnprotected(false)) {
+        }
+    }
+    OSAL::ScopedLock lock(signalMutex_);
+    frameArrived_.WaitFor(lock, WAIT_FRAME_TIMEOUT_MS, [this] {
+        return framePending_.exchange(false) || !running_;
+    });
+}
+
+bool MuxerInterleaver::WriteNextFrameUnprotected(bool force)
+{
+    TrackQueue* candidate = nullptr;
+    int64_t candidateTimestamp = INT64_MAX;
+    int64_t newestTimestamp = INT64_MIN;
+    for (auto& track : tracks_) {
+        newestTimestamp = std::max(newestTimestamp, track->lastPushedTimestamp.load());
+        auto head = track->queue.Front();
+        if (head == nullptr) {
+            continue;
+        }
+        // an empty eos buffer carries no valid timestamp, it follows the last frame of its track
+        int64_t timestamp = (((*head)->flag & BUFFER_FLAG_EOS) && !HasPayload(*head)) ?
+            track->lastTimestamp : GetTimestamp(*head);
+        if (candidate == nullptr || timestamp < candidateTimestamp) {
+            candidate = track.get();
+            candidateTimestamp = timestamp;
+        }
+    }
+    if (candidate == nullptr) {
+        return false;
+    }
+    if (baseTimestamp_ == INT64_MIN) {
+        baseTimestamp_ = candidateTimestamp;
+    }
+    newestTimestamp = std::max(newestTimestamp, candidateTimestamp);
+    // eos without payload never precedes any frame of other tracks, no need to wait
+    if (!force && HasPayload(*candidate->queue.Front())) {
+        bool lagging = false;
+        for (auto& track : tracks_) {
+            if (track.get() == candidate || track->eos || track->queue.Front() != nullptr) {
+                continue;
+            }
+            auto lastTimestamp = track->lastTimestamp == INT64_MIN ? baseTimestamp_ : track->lastTimestamp;
+            if (newestTimestamp - lastTimestamp <= maxInterleaveDelta_.load()) {
+                // the track may still produce an earlier frame, wait for it
+                return false;
+            }
+            lagging = true;
+        }
+        if (lagging) {
+            stats_.forcedWrites++;
+        }
+    }
+    WriteFrameUnprotected(*candidate);
+    return true;
+}
+
+void MuxerInterleaver::WriteFrameUnprotected(TrackQueue& track)
+{
+    AVBufferPtr buffer;
+    if (!track.queue.TryPop(buffer)) {
+        return;
+    }
+    {
+        OSAL::ScopedLock lock(spaceMutex_); // the producer checks the free space under it, no wakeup gets lost
+        spaceFreed_.NotifyAll();
+    }
+    if (buffer->flag & BUFFER_FLAG_EOS) {
+        track.eos = true;
+    }
+    if (HasPayload(buffer)) {
+        auto timestamp = GetTimestamp(buffer);
+        if (lastWrittenTimestamp_ != INT64_MIN && timestamp < lastWrittenTimestamp_) {
+            stats_.maxDtsRegression = std::max(stats_.maxDtsRegression, lastWrittenTimestamp_ - timestamp);
+        }
+        lastWrittenTimestamp_ = std::max(lastWrittenTimestamp_, timestamp);
+        track.lastTimestamp = timestamp;
+        stats_.framesWritten++;
+    }
+    writer_(buffer);
+}
+} // Pipeline
+} // Media
+} // OHOS
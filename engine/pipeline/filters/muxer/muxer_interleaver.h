@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_PIPELINE_MUXER_INTERLEAVER_H
+#define HISTREAMER_PIPELINE_MUXER_INTERLEAVER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "foundation/osal/thread/condition_variable.h"
+#include "foundation/osal/thread/mutex.h"
+#include "foundation/osal/thread/task.h"
+#include "foundation/utils/spsc_queue.h"
+#include "pipeline/core/type_define.h"
+#include "plugin/common/plugin_time.h"
+
+namespace OHOS {
+namespace Media {
+namespace Pipeline {
+struct InterleaverStats {
+    uint64_t framesWritten {0};
+    /// times an encoder thread found its track queue full
+    uint64_t producerStalls {0};
+    /// times a frame was written without waiting for a track lagging more than max interleave delta
+    uint64_t forcedWrites {0};
+    /// max distance a written frame fell behind the latest timestamp already written, based on HST_TIME_BASE
+    int64_t maxDtsRegression {0};
+};
+
+/**
+ * Merges frames of several tracks into one stream ordered by decoding timestamp.
+ *
+ * Every track owns a lock-free queue which is filled by exactly one encoder thread, so encoder threads never
+ * contend with each other nor wait for the muxer I/O. A dedicated task pops the track head with the smallest
+ * timestamp and hands it to the writer. A frame is held back while another unfinished track has no pending
+ * frame, unless the newest queued frame is ahead of that track by more than the max interleave delta.
+ */
+class MuxerInterleaver {
+public:
+    using FrameWriter = std::function<void(const AVBufferPtr&)>;
+
+    explicit MuxerInterleaver(FrameWriter writer, size_t queueCapacity = DEFAULT_TRACK_QUEUE_SIZE);
+    ~MuxerInterleaver();
+
+    /// must be called before Start, returns the index used by PushFrame
+    size_t AddTrack();
+    void ClearTracks();
+    void SetMaxInterleaveDelta(int64_t delta);
+
+    void Start();
+    void Stop();
+
+    /// called by the single producer thread of the track, blocks while its queue is full until a frame leaves it
+    bool PushFrame(size_t trackIndex, const AVBufferPtr& buffer);
+
+    /// writes all pending frames in timestamp order without waiting for lagging tracks
+    void Drain();
+
+    InterleaverStats GetStats();
+
+    static constexpr size_t DEFAULT_TRACK_QUEUE_SIZE = 64;
+    static constexpr int64_t DEFAULT_MAX_INTERLEAVE_DELTA = 500 * HST_MSECOND;
+
+private:
+    struct TrackQueue {
+        explicit TrackQueue(size_t capacity) : queue(capacity) {}
+        SpscQueue<AVBufferPtr> queue;
+        std::atomic<bool> eos {false};
+        std::atomic<int64_t> lastPushedTimestamp {INT64_MIN};
+        int64_t lastTimestamp {INT64_MIN};
+    };
+
+    static int64_t GetTimestamp(const AVBufferPtr& buffer);
+
+    void InterleaveLoop();
+    bool WriteNextFrameUnprotected(bool force);
+    void WriteFrameUnprotected(TrackQueue& track);
+
+    FrameWriter writer_;
+    const size_t queueCapacity_;
+    std::vector<std::unique_ptr<TrackQueue>> tracks_ {};
+    std::atomic<int64_t> maxInterleaveDelta_ {DEFAULT_MAX_INTERLEAVE_DELTA};
+    std::atomic<bool> running_ {false};
+    std::atomic<bool> framePending_ {false};
+
+    OSAL::Mutex writeMutex_ {};
+    OSAL::Mutex signalMutex_ {};
+    OSAL::ConditionVariable frameArrived_ {};
+    OSAL::Mutex spaceMutex_ {};
+    OSAL::ConditionVariable spaceFreed_ {}; // signaled whenever a frame leaves a track queue
+    std::unique_ptr<OSAL::Task> task_ {};
+
+    int64_t baseTimestamp_ {INT64_MIN};
+    int64_t lastWrittenTimestamp_ {INT64_MIN};
+    InterleaverStats stats_ {};
+    std::atomic<uint64_t> producerStalls_ {0};
+};
+} // Pipeline
+} // Media
+} // OHOS
+#endif // HISTREAMER_PIPELINE_MUXER_INTERLEAVER_H
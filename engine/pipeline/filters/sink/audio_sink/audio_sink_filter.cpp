@@ -33,6 +33,7 @@ using namespace Plugin;
 namespace {
 constexpr int REPORT_DURATION = 20 * HST_MSECOND; // 20 ms
 constexpr int WAIT_PREROLLED_TIMEOUT = 80 * HST_MSECOND; // 80ms
+const std::string PORT_NAME_SPLICE = "splice";
 }
 static AutoRegisterFilter<AudioSinkFilter> g_registerFilterHelper("builtin.player.audiosink");
 
@@ -57,6 +58,50 @@ void AudioSinkFilter::Init(EventReceiver* receiver, FilterCallback* callback)
 {
     MediaSynchronousSink::Init(receiver, callback);
     outPorts_.clear();
+    inPorts_.push_back(std::make_shared<InPort>(this, PORT_NAME_SPLICE));
+    ResetSplice();
+}
+
+void AudioSinkFilter::ResetSplice()
+{
+    OSAL::ScopedLock lock(spliceMutex_);
+    activeInPort_ = PORT_NAME_DEFAULT;
+    spliceEnabled_ = false;
+    spliceArmed_ = false;
+    standbyMeta_.reset();
+    retimeNextBuffer_ = false;
+    itemOffset_ = 0;
+    itemEndPts_ = HST_TIME_NONE;
+    spliceCondition_.NotifyAll();
+}
+
+PInPort AudioSinkFilter::GetActiveInPort()
+{
+    OSAL::ScopedLock lock(spliceMutex_);
+    return GetInPort(activeInPort_);
+}
+
+PInPort AudioSinkFilter::GetStandbyInPort()
+{
+    OSAL::ScopedLock lock(spliceMutex_);
+    return GetInPort(activeInPort_ == PORT_NAME_DEFAULT ? PORT_NAME_SPLICE : PORT_NAME_DEFAULT);
+}
+
+void AudioSinkFilter::SetSpliceEnabled(bool enabled)
+{
+    OSAL::ScopedLock lock(spliceMutex_);
+    spliceEnabled_ = enabled;
+    if (!enabled) {
+        spliceArmed_ = false;
+        standbyMeta_.reset();
+        spliceCondition_.NotifyAll();
+    }
+}
+
+bool AudioSinkFilter::IsStandbyPort(const std::string& inPort)
+{
+    OSAL::ScopedLock lock(spliceMutex_);
+    return inPort != activeInPort_;
 }
 
 ErrorCode AudioSinkFilter::SetPluginParameter(Tag tag, const Plugin::ValueType& value)
@@ -122,6 +167,9 @@ bool AudioSinkFilter::Negotiate(const std::string& inPort,
                                 Plugin::Meta& downstreamParams)
 {
     MEDIA_LOG_I("audio sink negotiate started");
+    if (IsStandbyPort(inPort)) {
+        return NegotiateStandby(upstreamCap, negotiatedCap, downstreamParams);
+    }
     FALSE_LOG(const_cast<Plugin::Meta&>(upstreamParams).Get<Tag::MEDIA_SEEKABLE>(seekable_));
     PROFILE_BEGIN("Audio Sink Negotiate begin");
     auto candidatePlugins = FindAvailablePlugins(*upstreamCap, Plugin::PluginType::AUDIO_SINK);
@@ -151,6 +199,13 @@ bool AudioSinkFilter::Negotiate(const std::string& inPort,
         return plugin;
     });
     NOK_LOG(plugin_->SetParameter(Tag::MEDIA_SEEKABLE, seekable_));
+    SetOutputChannelParams(downstreamParams);
+    PROFILE_END("Audio Sink Negotiate end");
+    return res;
+}
+
+void AudioSinkFilter::SetOutputChannelParams(Plugin::Meta& downstreamParams)
+{
     Plugin::ValueType pluginValue;
     if (plugin_->GetParameter(Tag::AUDIO_OUTPUT_CHANNELS, pluginValue) == Plugin::Status::OK) {
         auto outputChannels = Plugin::AnyCast<uint32_t>(pluginValue);
@@ -162,8 +217,23 @@ bool AudioSinkFilter::Negotiate(const std::string& inPort,
         downstreamParams.Set<Tag::AUDIO_OUTPUT_CHANNEL_LAYOUT>(outputChanLayout);
         MEDIA_LOG_D("Get support outputChannelLayout: " PUBLIC_LOG_U64, outputChanLayout);
     }
-    PROFILE_END("Audio Sink Negotiate end");
-    return res;
+}
+
+bool AudioSinkFilter::NegotiateStandby(const std::shared_ptr<const Plugin::Capability>& upstreamCap,
+                                       Plugin::Capability& negotiatedCap, Plugin::Meta& downstreamParams)
+{
+    // the next item is played by the plugin of the active one, which must accept it as it is
+    FALSE_RETURN_V_MSG_E(plugin_ != nullptr && pluginInfo_ != nullptr, false, "no plugin to splice the next item in");
+    auto candidatePlugins = FindAvailablePlugins(*upstreamCap, Plugin::PluginType::AUDIO_SINK);
+    for (const auto& candidate : candidatePlugins) {
+        if (candidate.first->name == pluginInfo_->name) {
+            negotiatedCap = candidate.second;
+            SetOutputChannelParams(downstreamParams);
+            return true;
+        }
+    }
+    MEDIA_LOG_E("plugin " PUBLIC_LOG_S " can not play the next item", pluginInfo_->name.c_str());
+    return false;
 }
 
 bool AudioSinkFilter::Configure(const std::string& inPort, const std::shared_ptr<const Plugin::Meta>& upstreamMeta,
@@ -175,6 +245,9 @@ bool AudioSinkFilter::Configure(const std::string& inPort, const std::shared_ptr
         MEDIA_LOG_E("cannot configure decoder when no plugin available");
         return false;
     }
+    if (IsStandbyPort(inPort)) {
+        return ConfigureStandby(upstreamMeta);
+    }
     SetVolumeToPlugin();
     auto err = ConfigureToPreparePlugin(upstreamMeta);
     if (err != ErrorCode::SUCCESS) {
@@ -182,6 +255,7 @@ bool AudioSinkFilter::Configure(const std::string& inPort, const std::shared_ptr
         FilterBase::OnEvent({name_, EventType::EVENT_ERROR, err});
         return false;
     }
+    UpdateItemFormat(*upstreamMeta);
     UpdateMediaTimeRange(*upstreamMeta);
     state_ = FilterState::READY;
     FilterBase::OnEvent({name_, EventType::EVENT_READY});
@@ -190,6 +264,34 @@ bool AudioSinkFilter::Configure(const std::string& inPort, const std::shared_ptr
     return true;
 }
 
+bool AudioSinkFilter::ConfigureStandby(const std::shared_ptr<const Plugin::Meta>& meta)
+{
+    uint32_t sampleRate = 0;
+    uint32_t channels = 0;
+    auto sampleFormat = Plugin::AudioSampleFormat::NONE;
+    FALSE_LOG(meta->Get<Tag::AUDIO_SAMPLE_RATE>(sampleRate));
+    FALSE_LOG(meta->Get<Tag::AUDIO_CHANNELS>(channels));
+    FALSE_LOG(meta->Get<Tag::AUDIO_SAMPLE_FORMAT>(sampleFormat));
+    if (sampleRate != sampleRate_ || channels != channels_ || sampleFormat != sampleFormat_) {
+        MEDIA_LOG_W("next item of " PUBLIC_LOG_U32 " Hz, " PUBLIC_LOG_U32 " channels can not be spliced after "
+                    PUBLIC_LOG_U32 " Hz, " PUBLIC_LOG_U32 " channels", sampleRate, channels, sampleRate_, channels_);
+        return false;
+    }
+    OSAL::ScopedLock lock(spliceMutex_);
+    FALSE_RETURN_V_MSG_W(spliceEnabled_, false, "splice is disabled, the next item is dropped");
+    standbyMeta_ = meta;
+    spliceArmed_ = true;
+    MEDIA_LOG_I("next item is ready to be spliced in");
+    return true;
+}
+
+void AudioSinkFilter::UpdateItemFormat(const Plugin::Meta& meta)
+{
+    FALSE_LOG(meta.Get<Tag::AUDIO_SAMPLE_RATE>(sampleRate_));
+    FALSE_LOG(meta.Get<Tag::AUDIO_CHANNELS>(channels_));
+    FALSE_LOG(meta.Get<Tag::AUDIO_SAMPLE_FORMAT>(sampleFormat_));
+}
+
 ErrorCode AudioSinkFilter::ConfigureToPreparePlugin(const std::shared_ptr<const Plugin::Meta>& meta)
 {
     FAIL_RETURN_MSG(ConfigPluginWithMeta(*plugin_, *meta), "sink configuration failed.");
@@ -204,6 +306,10 @@ ErrorCode AudioSinkFilter::PushData(const std::string& inPort, const AVBufferPtr
         MEDIA_LOG_DD("audio sink is flushing ignore this buffer");
         return ErrorCode::SUCCESS;
     }
+    if (!WaitUntilActive(inPort)) {
+        MEDIA_LOG_I("drop buffer of the next item, it is not spliced in");
+        return ErrorCode::SUCCESS;
+    }
     if (state_.load() != FilterState::RUNNING) {
         pushThreadIsBlocking = true;
         MEDIA_LOG_I("audio sink push data wait.");
@@ -218,9 +324,17 @@ ErrorCode AudioSinkFilter::PushData(const std::string& inPort, const AVBufferPtr
                     isFlushing, static_cast<int>(state_.load()));
         return ErrorCode::SUCCESS;
     }
+    bool eos = (buffer->flag & BUFFER_FLAG_EOS) != 0;
+    if (eos && SpliceOnEos()) {
+        return ErrorCode::SUCCESS;
+    }
+    bool spliced = !eos && RetimeBuffer(buffer);
     DUMP_BUFFER2LOG("AudioSink Write", buffer, offset);
     FAIL_RETURN_MSG(WriteToPluginRefTimeSync(buffer), "audio sink write failed");
-    if ((buffer->flag & BUFFER_FLAG_EOS) != 0) {
+    if (spliced) {
+        FilterBase::OnEvent(Event{name_, EventType::EVENT_AUDIO_SPLICED, itemOffset_});
+    }
+    if (eos) {
         plugin_->Drain();
         Event event{
             .srcFilter = name_,
@@ -229,10 +343,72 @@ ErrorCode AudioSinkFilter::PushData(const std::string& inPort, const AVBufferPtr
         MEDIA_LOG_D("audio sink push data send event_complete");
         FilterBase::OnEvent(event);
     }
+    UpdateItemEnd(buffer);
     MEDIA_LOG_DD("audio sink push data end");
     return ErrorCode::SUCCESS;
 }
 
+bool AudioSinkFilter::WaitUntilActive(const std::string& inPort)
+{
+    OSAL::ScopedLock lock(spliceMutex_);
+    if (inPort == activeInPort_) {
+        return true;
+    }
+    MEDIA_LOG_I("next item waits on in port " PUBLIC_LOG_S, inPort.c_str());
+    spliceCondition_.Wait(lock, [this, &inPort] {
+        return inPort == activeInPort_ || !spliceArmed_ || state_ == FilterState::INITIALIZED;
+    });
+    return inPort == activeInPort_ && state_ != FilterState::INITIALIZED;
+}
+
+bool AudioSinkFilter::SpliceOnEos()
+{
+    OSAL::ScopedLock lock(spliceMutex_);
+    if (!spliceArmed_ || itemEndPts_ == HST_TIME_NONE) {
+        return false;
+    }
+    // neither drain nor complete, the plugin plays on with the buffers of the next item
+    activeInPort_ = (activeInPort_ == PORT_NAME_DEFAULT) ? PORT_NAME_SPLICE : PORT_NAME_DEFAULT;
+    spliceArmed_ = false;
+    retimeNextBuffer_ = true;
+    MEDIA_LOG_I("item ends at " PUBLIC_LOG_D64 ", next item goes on from in port " PUBLIC_LOG_S, itemEndPts_,
+                activeInPort_.c_str());
+    spliceCondition_.NotifyAll();
+    return true;
+}
+
+bool AudioSinkFilter::RetimeBuffer(const AVBufferPtr& buffer)
+{
+    if (!retimeNextBuffer_) {
+        buffer->pts += itemOffset_;
+        return false;
+    }
+    retimeNextBuffer_ = false;
+    // the first sample of the next item, the encoder delay trimmed by the decoder, follows the last one written
+    itemOffset_ = itemEndPts_ - buffer->pts;
+    buffer->pts = itemEndPts_;
+    int64_t duration = 0;
+    uint32_t trackId = 0;
+    FALSE_LOG(standbyMeta_->Get<Tag::TRACK_ID>(trackId));
+    auto end = standbyMeta_->Get<Tag::MEDIA_DURATION>(duration) ? itemEndPts_ + duration : INT64_MAX;
+    auto syncCenter = syncCenter_.lock();
+    if (syncCenter) {
+        syncCenter->SetMediaTimeRangeEnd(end, trackId);
+    }
+    MEDIA_LOG_I("next item spliced in with pts offset " PUBLIC_LOG_D64, itemOffset_);
+    return true;
+}
+
+void AudioSinkFilter::UpdateItemEnd(const AVBufferPtr& buffer)
+{
+    uint32_t bytesPerFrame = GetBytesPerSample(sampleFormat_) * channels_;
+    if ((buffer->flag & BUFFER_FLAG_EOS) != 0 || buffer->IsEmpty() || bytesPerFrame == 0 || sampleRate_ == 0) {
+        return;
+    }
+    auto frames = static_cast<int64_t>(buffer->GetMemory()->GetSize() / bytesPerFrame);
+    itemEndPts_ = buffer->pts + frames * HST_SECOND / sampleRate_;
+}
+
 ErrorCode AudioSinkFilter::Start()
 {
     MEDIA_LOG_I("start called");
@@ -262,6 +438,8 @@ ErrorCode AudioSinkFilter::Stop()
     if (plugin_ != nullptr) {
         plugin_->Stop();
     }
+    // the next prepare starts from the default in port, the item spliced in last is stopped with the pipeline
+    ResetSplice();
     if (pushThreadIsBlocking.load()) {
         startWorkingCondition_.NotifyOne();
     }
@@ -374,6 +552,7 @@ void AudioSinkFilter::ResetSyncInfo()
     lastReportedClockTime_ = HST_TIME_NONE;
     latestBufferPts_ = HST_TIME_NONE;
     latestBufferDuration_ = HST_TIME_NONE;
+    itemEndPts_ = HST_TIME_NONE;
 }
 
 void AudioSinkFilter::OnEvent(const Plugin::PluginEvent& event)
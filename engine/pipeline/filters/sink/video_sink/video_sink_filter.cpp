@@ -513,10 +513,13 @@ ErrorCode VideoSinkFilter::DoSyncWrite(const AVBufferPtr& buffer)
             if (syncCenter) {
                 render = syncCenter->UpdateTimeAnchor(nowCt + latency, buffer->pts, this);
             }
-            isFirstFrame_ = false;
-            OnEvent(Event{name_, EventType::EVENT_VIDEO_RENDERING_START, {}});
-            if (frameRateTask_) {
-                frameRateTask_->Start();
+            // frames before an accurate seek target are dropped, the first one rendered anchors the clock
+            if (render) {
+                isFirstFrame_ = false;
+                OnEvent(Event{name_, EventType::EVENT_VIDEO_RENDERING_START, {}});
+                if (frameRateTask_) {
+                    frameRateTask_->Start();
+                }
             }
         } else {
             shouldDrop = CheckBufferLatenessMayWait(buffer);
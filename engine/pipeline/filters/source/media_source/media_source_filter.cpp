@@ -106,11 +106,38 @@ ErrorCode MediaSourceFilter::InitPlugin(const std::shared_ptr<MediaSource>& sour
     if (err != ErrorCode::SUCCESS) {
         return err;
     }
+    for (const auto& parameter : pluginParameters_) {
+        if (plugin_->SetParameter(parameter.first, parameter.second) != Status::OK) {
+            MEDIA_LOG_D("plugin ignores parameter " PUBLIC_LOG_U32, static_cast<uint32_t>(parameter.first));
+        }
+    }
     plugin_->SetCallback(this);
     pluginAllocator_ = plugin_->GetAllocator();
     return TranslatePluginStatus(plugin_->SetSource(source));
 }
 
+// parameters set before the source are kept and applied once the plugin of the source is known
+ErrorCode MediaSourceFilter::SetParameter(int32_t key, const Plugin::Any& value)
+{
+    Tag tag = Tag::INVALID;
+    FALSE_RETURN_V_MSG_E(TranslateIntoParameter(key, tag), ErrorCode::ERROR_INVALID_PARAMETER_VALUE,
+                         "key " PUBLIC_LOG_D32 " is out of boundary", key);
+    pluginParameters_[tag] = value;
+    if (plugin_ == nullptr) {
+        return ErrorCode::SUCCESS;
+    }
+    return TranslatePluginStatus(plugin_->SetParameter(tag, value));
+}
+
+ErrorCode MediaSourceFilter::GetParameter(int32_t key, Plugin::Any& value)
+{
+    Tag tag = Tag::INVALID;
+    FALSE_RETURN_V_MSG_E(TranslateIntoParameter(key, tag), ErrorCode::ERROR_INVALID_PARAMETER_VALUE,
+                         "key " PUBLIC_LOG_D32 " is out of boundary", key);
+    FALSE_RETURN_V(plugin_ != nullptr, ErrorCode::ERROR_AGAIN);
+    return TranslatePluginStatus(plugin_->GetParameter(tag, value));
+}
+
 ErrorCode MediaSourceFilter::SetBufferSize(size_t size)
 {
     MEDIA_LOG_I("SetBufferSize, size: " PUBLIC_LOG_ZU, size);
@@ -12,8 +12,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include "foundation/log.h"
 #include "plugin/convert/ffmpeg_convert.h"
+#include "plugin/convert/video_convert.h"
 #include "securec.h"
 
 namespace OHOS {
@@ -107,21 +109,77 @@ Status Resample::Convert(const uint8_t* srcBuffer, const size_t srcLength, uint8
 }
 
 #if defined(VIDEO_SUPPORT)
+namespace {
+constexpr int32_t PIXEL_BYTES = 4;
+
+enum struct PixelLayout {
+    PLANAR_420,
+    SEMI_PLANAR_420,
+    PACKED_32,
+};
+
+struct PixelDesc {
+    AVPixelFormat format;
+    PixelLayout layout;
+    bool vFirst;                    // semi planar chroma starts with v
+    uint8_t channels[PIXEL_BYTES];  // packed channel of each byte
+};
+
+using Channel = VideoConvert::Channel;
+const PixelDesc PIXEL_DESCS[] = {
+    {AV_PIX_FMT_YUV420P, PixelLayout::PLANAR_420, false, {}},
+    {AV_PIX_FMT_NV12, PixelLayout::SEMI_PLANAR_420, false, {}},
+    {AV_PIX_FMT_NV21, PixelLayout::SEMI_PLANAR_420, true, {}},
+    {AV_PIX_FMT_RGBA, PixelLayout::PACKED_32, false, {Channel::R, Channel::G, Channel::B, Channel::A}},
+    {AV_PIX_FMT_BGRA, PixelLayout::PACKED_32, false, {Channel::B, Channel::G, Channel::R, Channel::A}},
+    {AV_PIX_FMT_ARGB, PixelLayout::PACKED_32, false, {Channel::A, Channel::R, Channel::G, Channel::B}},
+    {AV_PIX_FMT_ABGR, PixelLayout::PACKED_32, false, {Channel::A, Channel::B, Channel::G, Channel::R}},
+};
+
+const PixelDesc* FindPixelDesc(AVPixelFormat format)
+{
+    for (const auto& desc : PIXEL_DESCS) {
+        if (desc.format == format) {
+            return &desc;
+        }
+    }
+    return nullptr;
+}
+
+// same size, yuv to yuv or rgb, rgb to rgb, anything else needs sws
+bool IsDirectConvertible(const ScalePara& scalePara)
+{
+    if (scalePara.srcWidth != scalePara.dstWidth || scalePara.srcHeight != scalePara.dstHeight) {
+        return false;
+    }
+    const PixelDesc* src = FindPixelDesc(scalePara.srcFfFmt);
+    const PixelDesc* dst = FindPixelDesc(scalePara.dstFfFmt);
+    return src != nullptr && dst != nullptr &&
+           (src->layout != PixelLayout::PACKED_32 || dst->layout == PixelLayout::PACKED_32);
+}
+} // namespace
+
 Status Scale::Init(const ScalePara& scalePara, uint8_t** dstData, int32_t* dstLineSize)
 {
     scalePara_ = scalePara;
-    if (swsCtx_ != nullptr) {
+    if (swsCtx_ != nullptr || isDirect_) {
         return Status::OK;
     }
-    auto swsContext = sws_getContext(scalePara_.srcWidth, scalePara_.srcHeight, scalePara_.srcFfFmt,
-                                     scalePara_.dstWidth, scalePara_.dstHeight, scalePara_.dstFfFmt,
-                                     SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
-    FALSE_RETURN_V_MSG_E(swsContext != nullptr, Status::ERROR_UNKNOWN, "sws_getContext fail");
-    swsCtx_ = std::shared_ptr<SwsContext>(swsContext, [](struct SwsContext *ptr) {
-        if (ptr != nullptr) {
-            sws_freeContext(ptr);
-        }
-    });
+    isDirect_ = IsDirectConvertible(scalePara_);
+    if (isDirect_) {
+        chromaCache_.resize(static_cast<size_t>((scalePara_.srcWidth + 1) / 2) * 2); // 2: u and v of a chroma row
+        MEDIA_LOG_D("convert without sws, kernels: " PUBLIC_LOG_S, VideoConvert::GetInstructionSet());
+    } else {
+        auto swsContext = sws_getContext(scalePara_.srcWidth, scalePara_.srcHeight, scalePara_.srcFfFmt,
+                                         scalePara_.dstWidth, scalePara_.dstHeight, scalePara_.dstFfFmt,
+                                         SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+        FALSE_RETURN_V_MSG_E(swsContext != nullptr, Status::ERROR_UNKNOWN, "sws_getContext fail");
+        swsCtx_ = std::shared_ptr<SwsContext>(swsContext, [](struct SwsContext *ptr) {
+            if (ptr != nullptr) {
+                sws_freeContext(ptr);
+            }
+        });
+    }
     auto ret = av_image_alloc(dstData, dstLineSize, scalePara_.dstWidth, scalePara_.dstHeight,
                               scalePara_.dstFfFmt, scalePara_.align);
     FALSE_RETURN_V_MSG_E(ret >= 0, Status::ERROR_UNKNOWN, "could not allocate destination image" PUBLIC_LOG_D32, ret);
@@ -140,11 +198,88 @@ Status Scale::Init(const ScalePara& scalePara, uint8_t** dstData, int32_t* dstLi
 
 Status Scale::Convert(uint8_t** srcData, const int32_t* srcLineSize, uint8_t** dstData, int32_t* dstLineSize)
 {
+    if (isDirect_) {
+        return DirectConvert(srcData, srcLineSize, dstData, dstLineSize);
+    }
     auto res = sws_scale(swsCtx_.get(), srcData, srcLineSize, 0, scalePara_.srcHeight,
                          dstData, dstLineSize);
     FALSE_RETURN_V_MSG_E(res >= 0, Status::ERROR_UNKNOWN, "sws_scale fail: " PUBLIC_LOG_D32, res);
     return Status::OK;
 }
+
+Status Scale::DirectConvert(uint8_t** srcData, const int32_t* srcLineSize, uint8_t** dstData,
+                            const int32_t* dstLineSize)
+{
+    const PixelDesc* src = FindPixelDesc(scalePara_.srcFfFmt);
+    const PixelDesc* dst = FindPixelDesc(scalePara_.dstFfFmt);
+    FALSE_RETURN_V(src != nullptr && dst != nullptr, Status::ERROR_UNSUPPORTED_FORMAT);
+    int32_t width = scalePara_.srcWidth;
+    int32_t height = scalePara_.srcHeight;
+    if (src->layout == PixelLayout::PACKED_32) {
+        uint8_t order[PIXEL_BYTES];
+        for (int32_t i = 0; i < PIXEL_BYTES; i++) {
+            order[i] = static_cast<uint8_t>(std::find(src->channels, src->channels + PIXEL_BYTES, dst->channels[i]) -
+                                            src->channels);
+        }
+        for (int32_t row = 0; row < height; row++) {
+            VideoConvert::ShufflePixels(srcData[0] + row * srcLineSize[0], dstData[0] + row * dstLineSize[0],
+                                        order, width);
+        }
+        return Status::OK;
+    }
+    int32_t chromaWidth = (width + 1) / 2;   // 2: chroma is subsampled
+    int32_t chromaHeight = (height + 1) / 2; // 2: chroma is subsampled
+    uint8_t* cacheU = chromaCache_.data();
+    uint8_t* cacheV = chromaCache_.data() + chromaWidth;
+    if (dst->layout == PixelLayout::PACKED_32) {
+        const uint8_t* u = nullptr;
+        const uint8_t* v = nullptr;
+        for (int32_t row = 0; row < height; row++) {
+            int32_t chromaRow = row / 2; // 2: chroma is subsampled
+            if (src->layout == PixelLayout::PLANAR_420) {
+                u = srcData[1] + chromaRow * srcLineSize[1];
+                v = srcData[2] + chromaRow * srcLineSize[2]; // 2: v plane
+            } else if (row % 2 == 0) { // 2: a chroma row is shared by two rows
+                VideoConvert::DeinterleavePlane(srcData[1] + chromaRow * srcLineSize[1], src->vFirst ? cacheV : cacheU,
+                                  src->vFirst ? cacheU : cacheV, chromaWidth);
+                u = cacheU;
+                v = cacheV;
+            }
+            VideoConvert::YuvRowToRgb(srcData[0] + row * srcLineSize[0], u, v, dstData[0] + row * dstLineSize[0],
+                                      dst->channels, width);
+        }
+        return Status::OK;
+    }
+    VideoConvert::CopyPlane(srcData[0], srcLineSize[0], dstData[0], dstLineSize[0], width, height);
+    if (src->layout == dst->layout && src->vFirst == dst->vFirst) {
+        int32_t planes = src->layout == PixelLayout::PLANAR_420 ? 2 : 1; // 2: u and v planes
+        int32_t planeWidth = src->layout == PixelLayout::PLANAR_420 ? chromaWidth : chromaWidth * 2; // 2: u and v
+        for (int32_t i = 1; i <= planes; i++) {
+            VideoConvert::CopyPlane(srcData[i], srcLineSize[i], dstData[i], dstLineSize[i], planeWidth, chromaHeight);
+        }
+        return Status::OK;
+    }
+    for (int32_t row = 0; row < chromaHeight; row++) {
+        const uint8_t* u = cacheU;
+        const uint8_t* v = cacheV;
+        if (src->layout == PixelLayout::PLANAR_420) {
+            u = srcData[1] + row * srcLineSize[1];
+            v = srcData[2] + row * srcLineSize[2]; // 2: v plane
+        } else if (dst->layout == PixelLayout::PLANAR_420) {
+            uint8_t* dstU = dstData[1] + row * dstLineSize[1];
+            uint8_t* dstV = dstData[2] + row * dstLineSize[2]; // 2: v plane
+            VideoConvert::DeinterleavePlane(srcData[1] + row * srcLineSize[1], src->vFirst ? dstV : dstU,
+                                            src->vFirst ? dstU : dstV, chromaWidth);
+            continue;
+        } else {
+            VideoConvert::DeinterleavePlane(srcData[1] + row * srcLineSize[1], src->vFirst ? cacheV : cacheU,
+                                            src->vFirst ? cacheU : cacheV, chromaWidth);
+        }
+        VideoConvert::InterleavePlanes(dst->vFirst ? v : u, dst->vFirst ? u : v, dstData[1] + row * dstLineSize[1],
+                                       chromaWidth);
+    }
+    return Status::OK;
+}
 #endif
 } // namespace Ffmpeg
 } // namespace Plugin
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "plugin/convert/video_convert.h"
+#include "foundation/log.h"
+#include "securec.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VIDEO_CONVERT_X86
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VIDEO_CONVERT_NEON
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace VideoConvert {
+namespace {
+// bt.601 limited range coefficients with 6 fraction bits, small enough for 16 bit lanes
+constexpr int32_t Y_OFFSET = 16;
+constexpr int32_t UV_OFFSET = 128;
+constexpr int32_t Y_COEF = 74;    // 74: 1.164 * 64
+constexpr int32_t V_TO_R = 102;   // 102: 1.596 * 64
+constexpr int32_t U_TO_G = 25;    // 25: 0.391 * 64
+constexpr int32_t V_TO_G = 52;    // 52: 0.813 * 64
+constexpr int32_t U_TO_B = 129;   // 129: 2.018 * 64
+constexpr int32_t COEF_SHIFT = 6;
+constexpr int32_t COEF_ROUND = 32; // 32: half of 1 << COEF_SHIFT
+constexpr int32_t PIXEL_BYTES = 4;
+constexpr uint8_t OPAQUE = 0xff;
+
+struct Kernels {
+    void (*interleave)(const uint8_t*, const uint8_t*, uint8_t*, int32_t);
+    void (*deinterleave)(const uint8_t*, uint8_t*, uint8_t*, int32_t);
+    void (*shuffle)(const uint8_t*, uint8_t*, const uint8_t (&)[4], int32_t);
+    void (*yuvRow)(const uint8_t*, const uint8_t*, const uint8_t*, uint8_t*, const uint8_t (&)[4], int32_t);
+    const char* name;
+};
+
+inline uint8_t Clip(int32_t value)
+{
+    value = (value + COEF_ROUND) >> COEF_SHIFT;
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > UINT8_MAX ? UINT8_MAX : value));
+}
+
+void InterleaveC(const uint8_t* first, const uint8_t* second, uint8_t* dst, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++) {
+        dst[2 * i] = first[i];      // 2: two planes
+        dst[2 * i + 1] = second[i]; // 2: two planes
+    }
+}
+
+void DeinterleaveC(const uint8_t* src, uint8_t* first, uint8_t* second, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++) {
+        first[i] = src[2 * i];      // 2: two planes
+        second[i] = src[2 * i + 1]; // 2: two planes
+    }
+}
+
+void ShuffleC(const uint8_t* src, uint8_t* dst, const uint8_t (&order)[4], int32_t count)
+{
+    for (int32_t i = 0; i < count; i++, src += PIXEL_BYTES, dst += PIXEL_BYTES) {
+        uint8_t pixel[PIXEL_BYTES] = {src[0], src[1], src[2], src[3]}; // 2 3: bytes of the pixel, src may be dst
+        for (int32_t j = 0; j < PIXEL_BYTES; j++) {
+            dst[j] = pixel[order[j]];
+        }
+    }
+}
+
+void YuvRowC(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, const uint8_t (&order)[4],
+             int32_t width)
+{
+    for (int32_t i = 0; i < width; i++, dst += PIXEL_BYTES) {
+        int32_t yc = (y[i] - Y_OFFSET) * Y_COEF;
+        int32_t uc = u[i >> 1] - UV_OFFSET;
+        int32_t vc = v[i >> 1] - UV_OFFSET;
+        uint8_t pixel[PIXEL_BYTES] = {Clip(yc + V_TO_R * vc), Clip(yc - U_TO_G * uc - V_TO_G * vc),
+                                      Clip(yc + U_TO_B * uc), OPAQUE};
+        for (int32_t j = 0; j < PIXEL_BYTES; j++) {
+            dst[j] = pixel[order[j]];
+        }
+    }
+}
+
+#if defined(VIDEO_CONVERT_X86)
+constexpr int32_t SSE_BYTES = 16;
+#endif
+
+#if defined(VIDEO_CONVERT_X86) && defined(__SSE2__)
+void InterleaveSse2(const uint8_t* first, const uint8_t* second, uint8_t* dst, int32_t count)
+{
+    int32_t i = 0;
+    for (; i + SSE_BYTES <= count; i += SSE_BYTES) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi8(a, b)); // 2: two planes
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + SSE_BYTES), _mm_unpackhi_epi8(a, b)); // 2: planes
+    }
+    InterleaveC(first + i, second + i, dst + 2 * i, count - i); // 2: two planes
+}
+
+void DeinterleaveSse2(const uint8_t* src, uint8_t* first, uint8_t* second, int32_t count)
+{
+    const __m128i lowBytes = _mm_set1_epi16(0x00ff);
+    int32_t i = 0;
+    for (; i + SSE_BYTES <= count; i += SSE_BYTES) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i)); // 2: two planes
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i + SSE_BYTES)); // 2: two planes
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(first + i),
+                         _mm_packus_epi16(_mm_and_si128(a, lowBytes), _mm_and_si128(b, lowBytes)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(second + i),
+                         _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8))); // 8: high byte
+    }
+    DeinterleaveC(src + 2 * i, first + i, second + i, count - i); // 2: two planes
+}
+
+// r, g and b of 8 pixels from 16 bit y, u and v, in the fixed point of YuvRowC
+inline void YuvToRgbSse2(__m128i y, __m128i u, __m128i v, __m128i (&rgb)[3])
+{
+    const __m128i round = _mm_set1_epi16(COEF_ROUND);
+    __m128i yc = _mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(Y_OFFSET)), _mm_set1_epi16(Y_COEF));
+    __m128i uc = _mm_sub_epi16(u, _mm_set1_epi16(UV_OFFSET));
+    __m128i vc = _mm_sub_epi16(v, _mm_set1_epi16(UV_OFFSET));
+    __m128i r = _mm_adds_epi16(yc, _mm_mullo_epi16(vc, _mm_set1_epi16(V_TO_R)));
+    __m128i g = _mm_subs_epi16(_mm_subs_epi16(yc, _mm_mullo_epi16(uc, _mm_set1_epi16(U_TO_G))),
+                               _mm_mullo_epi16(vc, _mm_set1_epi16(V_TO_G)));
+    __m128i b = _mm_adds_epi16(yc, _mm_mullo_epi16(uc, _mm_set1_epi16(U_TO_B)));
+    rgb[0] = _mm_srai_epi16(_mm_adds_epi16(r, round), COEF_SHIFT);
+    rgb[1] = _mm_srai_epi16(_mm_adds_epi16(g, round), COEF_SHIFT);
+    rgb[2] = _mm_srai_epi16(_mm_adds_epi16(b, round), COEF_SHIFT); // 2: blue
+}
+
+void YuvRowSse2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, const uint8_t (&order)[4],
+                int32_t width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int32_t i = 0;
+    for (; i + SSE_BYTES <= width; i += SSE_BYTES) {
+        __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+        __m128i u8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + i / 2)); // 2: chroma is subsampled
+        __m128i v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + i / 2)); // 2: chroma is subsampled
+        // each chroma sample covers two pixels
+        u8 = _mm_unpacklo_epi8(u8, u8);
+        v8 = _mm_unpacklo_epi8(v8, v8);
+        __m128i low[3];
+        __m128i high[3];
+        YuvToRgbSse2(_mm_unpacklo_epi8(y8, zero), _mm_unpacklo_epi8(u8, zero), _mm_unpacklo_epi8(v8, zero), low);
+        YuvToRgbSse2(_mm_unpackhi_epi8(y8, zero), _mm_unpackhi_epi8(u8, zero), _mm_unpackhi_epi8(v8, zero), high);
+        __m128i channels[PIXEL_BYTES] = {_mm_packus_epi16(low[0], high[0]), _mm_packus_epi16(low[1], high[1]),
+                                         _mm_packus_epi16(low[2], high[2]), _mm_set1_epi8(-1)}; // 2: blue
+        __m128i c01Low = _mm_unpacklo_epi8(channels[order[0]], channels[order[1]]);
+        __m128i c01High = _mm_unpackhi_epi8(channels[order[0]], channels[order[1]]);
+        __m128i c23Low = _mm_unpacklo_epi8(channels[order[2]], channels[order[3]]);  // 2 3: last bytes
+        __m128i c23High = _mm_unpackhi_epi8(channels[order[2]], channels[order[3]]); // 2 3: last bytes
+        auto out = reinterpret_cast<__m128i*>(dst + i * PIXEL_BYTES);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(c01Low, c23Low));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(c01Low, c23Low));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(c01High, c23High)); // 2: pixels 8 to 11
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(c01High, c23High)); // 3: pixels 12 to 15
+    }
+    YuvRowC(y + i, u + i / 2, v + i / 2, dst + i * PIXEL_BYTES, order, width - i); // 2: chroma is subsampled
+}
+#endif
+
+#if defined(VIDEO_CONVERT_X86) && defined(__GNUC__)
+constexpr int32_t AVX_BYTES = 32;
+
+// byte shuffle mask of PIXEL_BYTES pixels, for pshufb
+__attribute__((target("ssse3"))) __m128i ShuffleMask(const uint8_t (&order)[4])
+{
+    alignas(SSE_BYTES) uint8_t mask[SSE_BYTES];
+    for (int32_t i = 0; i < SSE_BYTES; i++) {
+        mask[i] = static_cast<uint8_t>(i - i % PIXEL_BYTES + order[i % PIXEL_BYTES]);
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+__attribute__((target("ssse3"))) void ShuffleSsse3(const uint8_t* src, uint8_t* dst, const uint8_t (&order)[4],
+                                                   int32_t count)
+{
+    const __m128i mask = ShuffleMask(order);
+    constexpr int32_t pixels = SSE_BYTES / PIXEL_BYTES;
+    int32_t i = 0;
+    for (; i + pixels <= count; i += pixels) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * PIXEL_BYTES));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * PIXEL_BYTES), _mm_shuffle_epi8(data, mask));
+    }
+    ShuffleC(src + i * PIXEL_BYTES, dst + i * PIXEL_BYTES, order, count - i);
+}
+
+__attribute__((target("avx2"))) void ShuffleAvx2(const uint8_t* src, uint8_t* dst, const uint8_t (&order)[4],
+                                                 int32_t count)
+{
+    // pshufb works within 128 bit lanes, a lane holds whole pixels
+    const __m256i mask = _mm256_broadcastsi128_si256(ShuffleMask(order));
+    constexpr int32_t pixels = AVX_BYTES / PIXEL_BYTES;
+    int32_t i = 0;
+    for (; i + pixels <= count; i += pixels) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * PIXEL_BYTES));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * PIXEL_BYTES), _mm256_shuffle_epi8(data, mask));
+    }
+    ShuffleC(src + i * PIXEL_BYTES, dst + i * PIXEL_BYTES, order, count - i);
+}
+
+__attribute__((target("avx2"))) void InterleaveAvx2(const uint8_t* first, const uint8_t* second, uint8_t* dst,
+                                                    int32_t count)
+{
+    constexpr int lanes = 0xd8; // 0xd8: 64 bit words 0 2 1 3, unpack then works across the 128 bit lanes
+    int32_t i = 0;
+    for (; i + AVX_BYTES <= count; i += AVX_BYTES) {
+        __m256i a = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)), lanes);
+        __m256i b = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + i)), lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), _mm256_unpacklo_epi8(a, b)); // 2: two planes
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i + AVX_BYTES), // 2: two planes
+                            _mm256_unpackhi_epi8(a, b));
+    }
+    InterleaveC(first + i, second + i, dst + 2 * i, count - i); // 2: two planes
+}
+
+__attribute__((target("avx2"))) void DeinterleaveAvx2(const uint8_t* src, uint8_t* first, uint8_t* second,
+                                                      int32_t count)
+{
+    // each lane to 8 bytes of the first plane then 8 of the second
+    const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                           0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    constexpr int lanes = 0xd8; // 0xd8: 64 bit words 0 2 1 3, the first plane to the low lane
+    int32_t i = 0;
+    for (; i + AVX_BYTES <= count; i += AVX_BYTES) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 2 * i)); // 2: two planes
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 2 * i + AVX_BYTES)); // 2: two planes
+        a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, split), lanes);
+        b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, split), lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(first + i), _mm256_permute2x128_si256(a, b, 0x20)); // low
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(second + i), _mm256_permute2x128_si256(a, b, 0x31)); // high
+    }
+    DeinterleaveC(src + 2 * i, first + i, second + i, count - i); // 2: two planes
+}
+#endif
+
+#if defined(VIDEO_CONVERT_NEON)
+constexpr int32_t NEON_BYTES = 16;
+
+void InterleaveNeon(const uint8_t* first, const uint8_t* second, uint8_t* dst, int32_t count)
+{
+    int32_t i = 0;
+    for (; i + NEON_BYTES <= count; i += NEON_BYTES) {
+        uint8x16x2_t planes = {{vld1q_u8(first + i), vld1q_u8(second + i)}};
+        vst2q_u8(dst + 2 * i, planes); // 2: two planes
+    }
+    InterleaveC(first + i, second + i, dst + 2 * i, count - i); // 2: two planes
+}
+
+void DeinterleaveNeon(const uint8_t* src, uint8_t* first, uint8_t* second, int32_t count)
+{
+    int32_t i = 0;
+    for (; i + NEON_BYTES <= count; i += NEON_BYTES) {
+        uint8x16x2_t planes = vld2q_u8(src + 2 * i); // 2: two planes
+        vst1q_u8(first + i, planes.val[0]);
+        vst1q_u8(second + i, planes.val[1]);
+    }
+    DeinterleaveC(src + 2 * i, first + i, second + i, count - i); // 2: two planes
+}
+
+void ShuffleNeon(const uint8_t* src, uint8_t* dst, const uint8_t (&order)[4], int32_t count)
+{
+    int32_t i = 0;
+    for (; i + NEON_BYTES <= count; i += NEON_BYTES) {
+        uint8x16x4_t in = vld4q_u8(src + i * PIXEL_BYTES);
+        uint8x16x4_t out = {{in.val[order[0]], in.val[order[1]], in.val[order[2]], in.val[order[3]]}}; // 2 3: bytes
+        vst4q_u8(dst + i * PIXEL_BYTES, out);
+    }
+    ShuffleC(src + i * PIXEL_BYTES, dst + i * PIXEL_BYTES, order, count - i);
+}
+
+// r, g and b of 8 pixels in the fixed point of YuvRowC, vqrshrun rounds and clips as Clip does
+inline void YuvToRgbNeon(uint8x8_t y, uint8x8_t u, uint8x8_t v, uint8x8_t (&rgb)[3])
+{
+    int16x8_t yc = vmulq_n_s16(vreinterpretq_s16_u16(vsubl_u8(y, vdup_n_u8(Y_OFFSET))), Y_COEF);
+    int16x8_t uc = vreinterpretq_s16_u16(vsubl_u8(u, vdup_n_u8(UV_OFFSET)));
+    int16x8_t vc = vreinterpretq_s16_u16(vsubl_u8(v, vdup_n_u8(UV_OFFSET)));
+    rgb[0] = vqrshrun_n_s16(vqaddq_s16(yc, vmulq_n_s16(vc, V_TO_R)), COEF_SHIFT);
+    rgb[1] = vqrshrun_n_s16(vqsubq_s16(vqsubq_s16(yc, vmulq_n_s16(uc, U_TO_G)), vmulq_n_s16(vc, V_TO_G)), COEF_SHIFT);
+    rgb[2] = vqrshrun_n_s16(vqaddq_s16(yc, vmulq_n_s16(uc, U_TO_B)), COEF_SHIFT); // 2: blue
+}
+
+void YuvRowNeon(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, const uint8_t (&order)[4],
+                int32_t width)
+{
+    int32_t i = 0;
+    for (; i + NEON_BYTES <= width; i += NEON_BYTES) {
+        uint8x16_t y8 = vld1q_u8(y + i);
+        // each chroma sample covers two pixels
+        uint8x8_t u8 = vld1_u8(u + i / 2); // 2: chroma is subsampled
+        uint8x8_t v8 = vld1_u8(v + i / 2); // 2: chroma is subsampled
+        uint8x8x2_t uu = vzip_u8(u8, u8);
+        uint8x8x2_t vv = vzip_u8(v8, v8);
+        uint8x8_t low[3];
+        uint8x8_t high[3];
+        YuvToRgbNeon(vget_low_u8(y8), uu.val[0], vv.val[0], low);
+        YuvToRgbNeon(vget_high_u8(y8), uu.val[1], vv.val[1], high);
+        uint8x16_t channels[PIXEL_BYTES] = {vcombine_u8(low[0], high[0]), vcombine_u8(low[1], high[1]),
+                                            vcombine_u8(low[2], high[2]), vdupq_n_u8(OPAQUE)}; // 2: blue
+        uint8x16x4_t out = {{channels[order[0]], channels[order[1]], channels[order[2]], channels[order[3]]}};
+        vst4q_u8(dst + i * PIXEL_BYTES, out);
+    }
+    YuvRowC(y + i, u + i / 2, v + i / 2, dst + i * PIXEL_BYTES, order, width - i); // 2: chroma is subsampled
+}
+#endif
+
+Kernels SelectKernels()
+{
+    Kernels kernels {InterleaveC, DeinterleaveC, ShuffleC, YuvRowC, "c"};
+#if defined(VIDEO_CONVERT_X86) && defined(__SSE2__)
+    kernels = {InterleaveSse2, DeinterleaveSse2, ShuffleC, YuvRowSse2, "sse2"};
+#endif
+#if defined(VIDEO_CONVERT_X86) && defined(__GNUC__)
+    if (__builtin_cpu_supports("ssse3")) {
+        kernels.shuffle = ShuffleSsse3;
+        kernels.name = "ssse3";
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.interleave = InterleaveAvx2;
+        kernels.deinterleave = DeinterleaveAvx2;
+        kernels.shuffle = ShuffleAvx2;
+        kernels.name = "avx2";
+    }
+#endif
+#if defined(VIDEO_CONVERT_NEON)
+    kernels = {InterleaveNeon, DeinterleaveNeon, ShuffleNeon, YuvRowNeon, "neon"};
+#endif
+    MEDIA_LOG_I("video convert kernels use " PUBLIC_LOG_S, kernels.name);
+    return kernels;
+}
+
+const Kernels& GetKernels()
+{
+    static const Kernels kernels = SelectKernels();
+    return kernels;
+}
+} // namespace
+
+void CopyPlane(const uint8_t* src, int32_t srcStride, uint8_t* dst, int32_t dstStride, int32_t widthBytes,
+               int32_t height)
+{
+    if (srcStride == widthBytes && dstStride == widthBytes) {
+        (void)memcpy_s(dst, static_cast<size_t>(widthBytes) * height, src, static_cast<size_t>(widthBytes) * height);
+        return;
+    }
+    for (int32_t i = 0; i < height; i++, src += srcStride, dst += dstStride) {
+        (void)memcpy_s(dst, widthBytes, src, widthBytes);
+    }
+}
+
+void InterleavePlanes(const uint8_t* first, const uint8_t* second, uint8_t* dst, int32_t count)
+{
+    GetKernels().interleave(first, second, dst, count);
+}
+
+void DeinterleavePlane(const uint8_t* src, uint8_t* first, uint8_t* second, int32_t count)
+{
+    GetKernels().deinterleave(src, first, second, count);
+}
+
+void ShufflePixels(const uint8_t* src, uint8_t* dst, const uint8_t (&order)[4], int32_t count)
+{
+    GetKernels().shuffle(src, dst, order, count);
+}
+
+void YuvRowToRgb(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, const uint8_t (&order)[4],
+                 int32_t width)
+{
+    GetKernels().yuvRow(y, u, v, dst, order, width);
+}
+
+const char* GetInstructionSet()
+{
+    return GetKernels().name;
+}
+} // namespace VideoConvert
+} // namespace Plugin
+} // namespace Media
+} // namespace OHOS
@@ -30,6 +30,17 @@ std::vector<std::string> PluginManager::ListPlugins(PluginType pluginType, Codec
     return pluginRegister_->ListPlugins(pluginType, preferredCodecMode);
 }
 
+std::vector<std::string> PluginManager::ListPluginsByInputMime(PluginType pluginType, const std::string& mime,
+                                                               CodecMode preferredCodecMode)
+{
+    return pluginRegister_->ListPluginsByInputMime(pluginType, mime, preferredCodecMode);
+}
+
+uint64_t PluginManager::GetRegisterGeneration()
+{
+    return pluginRegister_->GetGeneration();
+}
+
 std::shared_ptr<PluginInfo> PluginManager::GetPluginInfo(PluginType type, const std::string& name)
 {
     auto regInfo = pluginRegister_->GetPluginRegInfo(type, name);
@@ -15,10 +15,13 @@
 #include "plugin/core/plugin_register.h"
 
 #include <algorithm>
+#include <cctype>
 #include <dirent.h>
+#include <set>
 
 #include "all_plugin_static.h"
 #include "foundation/log.h"
+#include "foundation/osal/thread/scoped_lock.h"
 #include "plugin/interface/audio_sink_plugin.h"
 #include "plugin/interface/codec_plugin.h"
 #include "plugin/interface/demuxer_plugin.h"
@@ -30,11 +33,27 @@
 
 using namespace OHOS::Media::Plugin;
 
+namespace {
+bool IsCodecType(PluginType type)
+{
+    return type == PluginType::AUDIO_DECODER || type == PluginType::VIDEO_DECODER
+        || type == PluginType::AUDIO_ENCODER || type == PluginType::VIDEO_ENCODER;
+}
+
+std::string ToLowerMime(const std::string& mime)
+{
+    std::string lower(mime);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    return lower;
+}
+} // namespace
+
 PluginRegister::~PluginRegister()
 {
     UnregisterAllPlugins();
     registerData_->registerNames.clear();
     registerData_->registerTable.clear();
+    registerData_->generation++;
 }
 
 Status PluginRegister::RegisterImpl::AddPackage(const PackageDef& def)
@@ -117,6 +136,7 @@ void PluginRegister::RegisterImpl::UpdateRegisterTableAndRegisterNames(const Plu
     } else {
         registerData->registerNames[def.pluginType].push_back(def.name);
     }
+    registerData->generation++;
 }
 
 bool PluginRegister::RegisterImpl::Verification(const PluginDefBase& definition)
@@ -304,9 +324,7 @@ Status PluginRegister::RegisterImpl::VideoSinkCapabilityConvert(std::shared_ptr<
 
 std::vector<std::string> PluginRegister::ListPlugins(PluginType type, CodecMode preferredCodecMode)
 {
-    if ((type == PluginType::AUDIO_DECODER || type == PluginType::VIDEO_DECODER
-        || type == PluginType::AUDIO_ENCODER || type == PluginType::VIDEO_ENCODER)
-        && preferredCodecMode != CodecMode::HARDWARE) {
+    if (IsCodecType(type) && preferredCodecMode != CodecMode::HARDWARE) {
         std::vector<std::string> pluginNames {registerData_->registerNames[type]};
         std::reverse(pluginNames.begin(), pluginNames.end());
         return pluginNames;
@@ -315,6 +333,69 @@ std::vector<std::string> PluginRegister::ListPlugins(PluginType type, CodecMode
     }
 }
 
+std::vector<std::string> PluginRegister::ListPluginsByInputMime(PluginType type, const std::string& mime,
+    CodecMode preferredCodecMode)
+{
+    std::vector<std::string> pluginNames;
+    auto devLinePos = mime.find_first_of('/');
+    if (devLinePos == 0 || devLinePos == std::string::npos) {
+        return pluginNames;
+    }
+    auto lowerMime = ToLowerMime(mime);
+    std::set<size_t> positions;
+    OSAL::ScopedLock lock(indexMutex_);
+    const auto& index = GetMimeIndex(type);
+    // same rules as IsSubsetMime: the exact mime, the major type with any sub type, or anything
+    for (const auto& key : {lowerMime, lowerMime.substr(0, devLinePos) + "/*", std::string("*")}) {
+        auto ite = index.positions.find(key);
+        if (ite != index.positions.end()) {
+            positions.insert(ite->second.begin(), ite->second.end());
+        }
+    }
+    const auto& names = registerData_->registerNames[type];
+    for (auto pos : positions) {
+        pluginNames.push_back(names[pos]);
+    }
+    if (IsCodecType(type) && preferredCodecMode != CodecMode::HARDWARE) {
+        std::reverse(pluginNames.begin(), pluginNames.end());
+    }
+    return pluginNames;
+}
+
+uint64_t PluginRegister::GetGeneration()
+{
+    return registerData_->generation;
+}
+
+const PluginRegister::MimeIndex& PluginRegister::GetMimeIndex(PluginType type)
+{
+    auto& index = mimeIndex_[type];
+    if (index.built && index.generation == registerData_->generation) {
+        return index;
+    }
+    index.positions.clear();
+    index.generation = registerData_->generation;
+    index.built = true;
+    const auto& names = registerData_->registerNames[type];
+    for (size_t pos = 0; pos < names.size(); ++pos) {
+        auto regInfo = GetPluginRegInfo(type, names[pos]);
+        if (regInfo == nullptr || regInfo->info == nullptr) {
+            continue;
+        }
+        std::set<std::string> mimes;
+        for (const auto& cap : regInfo->info->inCaps) {
+            auto devLinePos = cap.mime.find_first_of('/');
+            if (cap.mime == "*" || (devLinePos != 0 && devLinePos != std::string::npos)) {
+                mimes.insert(ToLowerMime(cap.mime));
+            }
+        }
+        for (const auto& mime : mimes) {
+            index.positions[mime].push_back(pos);
+        }
+    }
+    return index;
+}
+
 int PluginRegister::GetAllRegisteredPluginCount()
 {
     int count = 0;
@@ -427,6 +508,7 @@ void PluginRegister::DeletePlugin(std::map<std::string, std::shared_ptr<PluginRe
         }
     }
     registerData_->registerTable[type].erase(info->first);
+    registerData_->generation++;
     info = plugins.erase(info);
 }
 void PluginRegister::EraseRegisteredPluginsByLoader(const std::shared_ptr<PluginLoader>& loader)
@@ -20,6 +20,7 @@
 #include <map>
 #include <set>
 #include <utility>
+#include "foundation/osal/thread/mutex.h"
 #include "plugin/common/any.h"
 #include "plugin/core/plugin_loader.h"
 #include "plugin/core/plugin_info.h"
@@ -48,6 +49,17 @@ public:
     std::vector<std::string> ListPlugins(PluginType type, CodecMode preferredCodecMode = CodecMode::HARDWARE);
     int GetAllRegisteredPluginCount();
 
+    /**
+     * List the plugins of the type whose input capabilities may accept the mime, in the order of ListPlugins.
+     * Plugins are looked up by exact, major type wildcard and "*" input mime in a per type index, the capability
+     * keys of the returned plugins still need to be checked.
+     */
+    std::vector<std::string> ListPluginsByInputMime(PluginType type, const std::string& mime,
+        CodecMode preferredCodecMode = CodecMode::HARDWARE);
+
+    /// changes each time a plugin is registered or removed, results derived from the registry expire with it
+    uint64_t GetGeneration();
+
     std::shared_ptr<PluginRegInfo> GetPluginRegInfo(PluginType type, const std::string& name);
 
     void RegisterPlugins();
@@ -68,6 +80,7 @@ private:
     struct RegisterData {
         std::map<PluginType, std::vector<std::string>> registerNames;
         REGISTERED_TABLE registerTable;
+        uint64_t generation {0};
         bool IsPluginExist(PluginType type, const std::string& name);
     };
 
@@ -123,11 +136,20 @@ private:
         std::shared_ptr<RegisterData> registerData;
         std::shared_ptr<PackageDef> packageDef {nullptr};
     };
+    struct MimeIndex {
+        uint64_t generation {0};
+        bool built {false};
+        // lower case input mime (xx/xxx, xx/* or *) -> positions of the accepting plugins in registerNames
+        std::map<std::string, std::vector<size_t>> positions;
+    };
+    const MimeIndex& GetMimeIndex(PluginType type);
     void DeletePlugin(std::map<std::string, std::shared_ptr<PluginRegInfo>>& plugins,
         std::map<std::string, std::shared_ptr<PluginRegInfo>>::iterator& info);
     std::shared_ptr<RegisterData> registerData_ = std::make_shared<RegisterData>();
     std::vector<std::shared_ptr<PluginLoader>> registeredLoaders_;
     std::shared_ptr<RegisterImpl> staticPluginRegister_ = std::make_shared<RegisterImpl>(registerData_);
+    OSAL::Mutex indexMutex_ {};
+    std::map<PluginType, MimeIndex> mimeIndex_;
 };
 } // namespace Plugin
 } // namespace Media
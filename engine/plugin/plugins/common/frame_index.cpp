@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "FrameIndex"
+
+#include "frame_index.h"
+#include <algorithm>
+#include <map>
+#include "foundation/log.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace {
+struct CachedIndex {
+    std::weak_ptr<DataSource> source;
+    std::shared_ptr<FrameIndex> index;
+};
+std::mutex g_indexCacheMutex;
+std::map<const DataSource*, CachedIndex> g_indexCache;
+}
+
+FrameIndex::FrameIndex(uint32_t framesPerEntry) : framesPerEntry_(framesPerEntry > 0 ? framesPerEntry : 1)
+{
+    entries_.emplace_back(FramePosition {});
+}
+
+std::shared_ptr<FrameIndex> FrameIndex::Acquire(const std::shared_ptr<DataSource>& source)
+{
+    if (source == nullptr) {
+        return std::make_shared<FrameIndex>();
+    }
+    std::lock_guard<std::mutex> lock(g_indexCacheMutex);
+    for (auto ite = g_indexCache.begin(); ite != g_indexCache.end();) {
+        if (ite->second.source.expired()) {
+            ite = g_indexCache.erase(ite);
+        } else {
+            ++ite;
+        }
+    }
+    auto ite = g_indexCache.find(source.get());
+    if (ite != g_indexCache.end()) {
+        MEDIA_LOG_D("reuse cached frame index with " PUBLIC_LOG_ZU " entries", ite->second.index->GetEntryCount());
+        return ite->second.index;
+    }
+    auto index = std::make_shared<FrameIndex>();
+    g_indexCache[source.get()] = CachedIndex {source, index};
+    return index;
+}
+
+void FrameIndex::Reset(uint64_t firstFrameOffset)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    end_ = FramePosition {0, 0, firstFrameOffset};
+    entries_.clear();
+    entries_.emplace_back(end_);
+    complete_ = false;
+}
+
+void FrameIndex::AddFrame(const FramePosition& pos, uint32_t frameLength, uint32_t samples)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (complete_ || pos.frameNumber != end_.frameNumber) {
+        return;
+    }
+    if (pos.frameNumber % framesPerEntry_ == 0 && pos.frameNumber > entries_.back().frameNumber) {
+        entries_.emplace_back(pos);
+    }
+    end_.frameNumber = pos.frameNumber + 1;
+    end_.sampleIndex = pos.sampleIndex + samples;
+    end_.offset = pos.offset + frameLength;
+}
+
+void FrameIndex::SetComplete(uint64_t totalFrames)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (end_.frameNumber == totalFrames) {
+        complete_ = true;
+    }
+}
+
+bool FrameIndex::IsComplete() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return complete_;
+}
+
+FramePosition FrameIndex::GetStartPosition() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.front();
+}
+
+FramePosition FrameIndex::GetEndPosition() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return end_;
+}
+
+FramePosition FrameIndex::Lookup(uint64_t targetSample) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto ite = std::upper_bound(entries_.begin(), entries_.end(), targetSample,
+        [](uint64_t sample, const FramePosition& entry) { return sample < entry.sampleIndex; });
+    return ite == entries_.begin() ? entries_.front() : *(--ite);
+}
+
+size_t FrameIndex::GetEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+} // namespace Plugin
+} // namespace Media
+} // namespace OHOS
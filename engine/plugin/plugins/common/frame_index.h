@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_PLUGINS_COMMON_FRAME_INDEX_H
+#define HISTREAMER_PLUGINS_COMMON_FRAME_INDEX_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "plugin/common/plugin_time.h"
+#include "plugin/interface/demuxer_plugin.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+/// time of the sample at sampleIndex based on HST_TIME_BASE, split at whole seconds so that no product overflows
+inline int64_t SampleToTime(uint64_t sampleIndex, uint32_t sampleRate)
+{
+    if (sampleRate == 0) {
+        return 0;
+    }
+    uint64_t seconds = sampleIndex / sampleRate;
+    uint64_t remainder = sampleIndex % sampleRate;
+    return static_cast<int64_t>(seconds * HST_SECOND + remainder * HST_SECOND / sampleRate);
+}
+
+/// index of the sample presented at time based on HST_TIME_BASE, negative times map to the first sample
+inline uint64_t TimeToSample(int64_t time, uint32_t sampleRate)
+{
+    if (time <= 0) {
+        return 0;
+    }
+    auto seconds = static_cast<uint64_t>(time / HST_SECOND);
+    auto remainder = static_cast<uint64_t>(time % HST_SECOND);
+    return seconds * sampleRate + remainder * sampleRate / HST_SECOND;
+}
+
+struct FramePosition {
+    uint64_t frameNumber {0};
+    uint64_t sampleIndex {0};
+    uint64_t offset {0};
+};
+
+/**
+ * Sparse index of a stream of self-delimited audio frames, such as ADTS or mpeg audio, keeps the position of every
+ * N-th frame.
+ *
+ * The index only grows contiguously from the first frame of the stream. It is filled while frames are read or by a
+ * header-only scan, and is bisected to find the frame containing a sample. Indexes acquired for a data source are
+ * shared by all demuxers reading the same data source.
+ */
+class FrameIndex {
+public:
+    explicit FrameIndex(uint32_t framesPerEntry = DEFAULT_FRAMES_PER_ENTRY);
+    ~FrameIndex() = default;
+
+    static std::shared_ptr<FrameIndex> Acquire(const std::shared_ptr<DataSource>& source);
+
+    /// drop all the entries, the first frame of the stream is at firstFrameOffset
+    void Reset(uint64_t firstFrameOffset);
+
+    /// record the frame at pos, which is ignored if it does not directly follow the indexed region
+    void AddFrame(const FramePosition& pos, uint32_t frameLength, uint32_t samples);
+
+    /// mark the end of stream if all the totalFrames frames have been indexed
+    void SetComplete(uint64_t totalFrames);
+    bool IsComplete() const;
+
+    /// position of the first frame
+    FramePosition GetStartPosition() const;
+
+    /// position of the frame following the last indexed one
+    FramePosition GetEndPosition() const;
+
+    /// the last indexed entry whose sample index is not greater than targetSample, O(log n)
+    FramePosition Lookup(uint64_t targetSample) const;
+
+    size_t GetEntryCount() const;
+
+    static constexpr uint32_t DEFAULT_FRAMES_PER_ENTRY = 16;
+
+private:
+    const uint32_t framesPerEntry_;
+    mutable std::mutex mutex_ {};
+    std::vector<FramePosition> entries_ {};
+    FramePosition end_ {};
+    bool complete_ {false};
+};
+} // namespace Plugin
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_PLUGINS_COMMON_FRAME_INDEX_H
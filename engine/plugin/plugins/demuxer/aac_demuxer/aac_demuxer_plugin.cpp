@@ -25,6 +25,7 @@
 #include "foundation/osal/thread/scoped_lock.h"
 #include "foundation/osal/utils/util.h"
 #include "foundation/utils/constants.h"
+#include "plugin/common/plugin_time.h"
 
 namespace OHOS {
 namespace Media {
@@ -35,9 +36,13 @@ namespace {
     constexpr uint32_t GET_INFO_READ_LEN = 7;
     constexpr uint32_t MEDIA_IO_SIZE = 2048;
     constexpr uint32_t MAX_RANK = 100;
+    constexpr uint32_t ADTS_HEADER_SIZE = 7;
+    constexpr uint32_t SAMPLES_PER_RAW_DATA_BLOCK = 1024;
+    constexpr size_t SCAN_CHUNK_SIZE = 32 * 1024;
     uint32_t usedDataSize_ = 0;
     int samplingRateMap[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350};
     int IsAACPattern(const uint8_t *data);
+    uint32_t GetSamplesPerFrame(const uint8_t *data);
     int Sniff(const std::string& name, std::shared_ptr<DataSource> dataSource);
     Status RegisterPlugin(const std::shared_ptr<Register>& reg);
 }
@@ -68,6 +73,9 @@ Status AACDemuxerPlugin::SetDataSource(const std::shared_ptr<DataSource>& source
     }
     MEDIA_LOG_I("FileSize_ " PUBLIC_LOG_U64, fileSize_);
     isSeekable_ = fileSize_ > 0 ? true : false;
+    frameIndex_ = FrameIndex::Acquire(source);
+    frameNumber_ = 0;
+    currentSample_ = 0;
     return Status::OK;
 }
 
@@ -188,8 +196,12 @@ Status AACDemuxerPlugin::ReadFrame(Buffer& outBuffer, int32_t timeOutMs)
     std::shared_ptr<Memory> aacFrameData;
     Status retStatus = GetDataFromSource();
     if (retStatus != Status::OK) {
+        if (retStatus == Status::END_OF_STREAM && frameIndex_ != nullptr) {
+            frameIndex_->SetComplete(frameNumber_);
+        }
         return retStatus;
     }
+    uint64_t frameOffset = static_cast<uint64_t>(ioContext_.offset) - ioDataRemainSize_;
     status = AudioDemuxerAACProcess(inIoBuffer_, ioDataRemainSize_, &aacDemuxerRst_);
 
     if (outBuffer.IsEmpty()) {
@@ -200,6 +212,18 @@ Status AACDemuxerPlugin::ReadFrame(Buffer& outBuffer, int32_t timeOutMs)
     switch (status) {
         case 0:
             aacFrameData->Write(aacDemuxerRst_.frameBuffer, aacDemuxerRst_.frameLength);
+            if (aacDemuxerRst_.frameLength > 0) {
+                uint32_t samples = GetSamplesPerFrame(aacDemuxerRst_.frameBuffer);
+                outBuffer.pts = SampleToTime(currentSample_, aacDemuxerRst_.frameSampleRate);
+                outBuffer.duration =
+                    SampleToTime(currentSample_ + samples, aacDemuxerRst_.frameSampleRate) - outBuffer.pts;
+                if (isSeekable_ && frameIndex_ != nullptr) {
+                    frameIndex_->AddFrame({frameNumber_, currentSample_, frameOffset}, aacDemuxerRst_.frameLength,
+                                          samples);
+                }
+                frameNumber_++;
+                currentSample_ += samples;
+            }
             if (aacDemuxerRst_.frameBuffer) {
                 free(aacDemuxerRst_.frameBuffer);
                 aacDemuxerRst_.frameBuffer = nullptr;
@@ -221,9 +245,76 @@ Status AACDemuxerPlugin::ReadFrame(Buffer& outBuffer, int32_t timeOutMs)
 
 Status AACDemuxerPlugin::SeekTo(int32_t trackId, int64_t seekTime, SeekMode mode, int64_t& realSeekTime)
 {
+    FALSE_RETURN_V_MSG_E(isSeekable_ && frameIndex_ != nullptr && aacDemuxerRst_.frameSampleRate > 0,
+                         Status::ERROR_INVALID_OPERATION, "aac stream is not seekable");
+    uint64_t targetSample = TimeToSample(seekTime, aacDemuxerRst_.frameSampleRate);
+    FramePosition framePos;
+    FALSE_RETURN_V_MSG_E(FindFrame(targetSample, framePos), Status::ERROR_UNKNOWN, "no aac frame found for seek");
+    // every adts frame can be decoded independently, so the frame containing the target is always a sync point
+    ioContext_.offset = static_cast<int64_t>(framePos.offset);
+    ioContext_.eos = false;
+    ioDataRemainSize_ = 0;
+    usedDataSize_ = 0;
+    frameNumber_ = framePos.frameNumber;
+    currentSample_ = framePos.sampleIndex;
+    realSeekTime = SampleToTime(framePos.sampleIndex, aacDemuxerRst_.frameSampleRate);
+    MEDIA_LOG_D("seek to frame " PUBLIC_LOG_U64 " at offset " PUBLIC_LOG_U64, framePos.frameNumber, framePos.offset);
     return Status::OK;
 }
 
+bool AACDemuxerPlugin::FindFrame(uint64_t targetSample, FramePosition& framePos)
+{
+    auto end = frameIndex_->GetEndPosition();
+    if (targetSample < end.sampleIndex || frameIndex_->IsComplete()) {
+        return ScanFrames(frameIndex_->Lookup(targetSample), targetSample, framePos);
+    }
+    // beyond the indexed region, continue the index with a header-only scan
+    return ScanFrames(end, targetSample, framePos);
+}
+
+bool AACDemuxerPlugin::ScanFrames(const FramePosition& start, uint64_t targetSample, FramePosition& framePos)
+{
+    auto buffer = std::make_shared<Buffer>();
+    auto bufData = buffer->AllocMemory(nullptr, SCAN_CHUNK_SIZE);
+    FramePosition cur = start;
+    uint64_t chunkOffset = cur.offset;
+    size_t chunkSize = 0;
+    bool found = false;
+    while (cur.offset + ADTS_HEADER_SIZE <= fileSize_) {
+        if (cur.offset + ADTS_HEADER_SIZE > chunkOffset + chunkSize) {
+            bufData->Reset();
+            auto ret = ioContext_.dataSource->ReadAt(static_cast<int64_t>(cur.offset), buffer, SCAN_CHUNK_SIZE);
+            chunkOffset = cur.offset;
+            chunkSize = bufData->GetSize();
+            if (ret != Status::OK || chunkSize < ADTS_HEADER_SIZE) {
+                break;
+            }
+        }
+        const uint8_t* header = bufData->GetReadOnlyData() + (cur.offset - chunkOffset);
+        auto length = static_cast<uint32_t>(GetFrameLength(header));
+        if (!IsAACPattern(header) || length < ADTS_HEADER_SIZE) {
+            cur.offset++; // lost sync, search for the next frame header
+            continue;
+        }
+        if (cur.offset + length > fileSize_) {
+            break;
+        }
+        uint32_t samples = GetSamplesPerFrame(header);
+        frameIndex_->AddFrame(cur, length, samples);
+        framePos = cur;
+        found = true;
+        if (cur.sampleIndex + samples > targetSample) {
+            return true;
+        }
+        cur.frameNumber++;
+        cur.sampleIndex += samples;
+        cur.offset += length;
+    }
+    // reach the end of stream, seeking beyond the duration stops at the last frame
+    frameIndex_->SetComplete(cur.frameNumber);
+    return found;
+}
+
 Status AACDemuxerPlugin::Init()
 {
     inIoBuffer_ = static_cast<uint8_t *>(malloc(inIoBufferSize_));
@@ -250,6 +341,8 @@ Status AACDemuxerPlugin::Prepare()
 
 Status AACDemuxerPlugin::Reset()
 {
+    frameNumber_ = 0;
+    currentSample_ = 0;
     ioContext_.eos = false;
     ioContext_.dataSource.reset();
     ioContext_.offset = 0;
@@ -414,6 +507,11 @@ namespace {
         return data[0] == 0xff && (data[1] & 0xf0) == 0xf0 && (data[1] & 0x06) == 0x00; // 根据协议判断是否为AAC帧
     }
 
+    uint32_t GetSamplesPerFrame(const uint8_t *data)
+    {
+        return ((data[6] & 0x03) + 1) * SAMPLES_PER_RAW_DATA_BLOCK; // 6: number_of_raw_data_blocks_in_frame
+    }
+
     int Sniff(const std::string& name, std::shared_ptr<DataSource> dataSource)
     {
         auto buffer = std::make_shared<Buffer>();
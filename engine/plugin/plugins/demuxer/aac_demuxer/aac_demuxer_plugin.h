@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "plugin/interface/demuxer_plugin.h"
+#include "plugin/plugins/common/frame_index.h"
 
 namespace OHOS {
 namespace Media {
@@ -83,6 +84,8 @@ private:
     int AudioDemuxerAACPrepare(const uint8_t *buf, uint32_t len, AACDemuxerRst *rst);
     int AudioDemuxerAACProcess(const uint8_t *buffer, uint32_t bufferLen, AACDemuxerRst *rst);
     int AudioDemuxerAACFreeFrame(uint8_t *frame);
+    bool FindFrame(uint64_t targetSample, FramePosition& framePos);
+    bool ScanFrames(const FramePosition& start, uint64_t targetSample, FramePosition& framePos);
 
     AACDemuxerRst aacDemuxerRst_;
     IOContext ioContext_;
@@ -91,6 +94,9 @@ private:
     unsigned char *inIoBuffer_;
     int inIoBufferSize_;
     unsigned int ioDataRemainSize_;
+    std::shared_ptr<FrameIndex> frameIndex_ {nullptr};
+    uint64_t frameNumber_ {0};
+    uint64_t currentSample_ {0};
 };
 } // namespace AacDemuxer
 } // namespace Plugin
@@ -387,33 +387,46 @@ Status MiniMP4DemuxerPlugin::ReadFrame(Buffer &outBuffer, int32_t timeOutMs)
 
 Status MiniMP4DemuxerPlugin::SeekTo(int32_t trackId, int64_t seekTime, SeekMode mode, int64_t& realSeekTime)
 {
+    (void)trackId;
+    FALSE_RETURN_V(miniMP4_.track != nullptr && miniMP4_.track->timescale != 0, Status::ERROR_WRONG_STATE);
     unsigned int frameSize = 0;
     unsigned int timeStamp = 0;
     unsigned int duration = 0;
-    uint64_t offsetStart = MP4D_frame_offset(&miniMP4_, 0, 0, &frameSize, &timeStamp, &duration);
-    uint64_t offsetEnd =
-        MP4D_frame_offset(&miniMP4_, 0, miniMP4_.track->sample_count - 1, &frameSize, &timeStamp, &duration);
-    uint64_t targetPos = (Plugin::HstTime2Ms(seekTime) * static_cast<int64_t>(miniMP4_.track->avg_bitrate_bps)) / 8 +
-        offsetStart;
-    if (targetPos >= offsetEnd) {
-        sampleIndex_ = miniMP4_.track->sample_count;
-        return Status::OK;
-    }
-    sampleIndex_ = 0;
-    uint64_t tempPos = 0;
-    while (sampleIndex_ < miniMP4_.track->sample_count) {
-        tempPos = MP4D_frame_offset(&miniMP4_, 0, sampleIndex_, &frameSize, &timeStamp, &duration);
-        if (tempPos < targetPos) {
-            sampleIndex_++;
+    uint64_t timescale = miniMP4_.track->timescale;
+    uint64_t target = static_cast<uint64_t>(std::max<int64_t>(seekTime, 0)) * timescale / HST_SECOND;
+    // the samples are in time order and all of them are sync samples, so the sample table is searched by halves
+    unsigned int count = miniMP4_.track->sample_count;
+    unsigned int low = 0;
+    unsigned int high = count;
+    while (low < high) {
+        unsigned int mid = low + (high - low) / 2; // 2: halves
+        (void)MP4D_frame_offset(&miniMP4_, 0, mid, &frameSize, &timeStamp, &duration);
+        if (timeStamp < target) {
+            low = mid + 1;
         } else {
-            break;
+            high = mid;
+        }
+    }
+    // low is the first sample at or after the target, the one before is taken unless low is exact
+    if (low > 0 && mode != SeekMode::SEEK_NEXT_SYNC) {
+        bool exact = false;
+        if (low < count) {
+            (void)MP4D_frame_offset(&miniMP4_, 0, low, &frameSize, &timeStamp, &duration);
+            exact = timeStamp == target;
         }
+        low = exact ? low : low - 1;
+    }
+    if (low >= count) {
+        sampleIndex_ = count;
+        return Status::OK;
     }
-    ioContext_.offset = tempPos;
+    sampleIndex_ = low;
+    ioContext_.offset = static_cast<int64_t>(MP4D_frame_offset(&miniMP4_, 0, sampleIndex_, &frameSize, &timeStamp,
+                                                               &duration));
     ioDataRemainSize_ = 0;
     MEDIA_LOG_D("ioContext_.offset " PUBLIC_LOG_D32, static_cast<uint32_t>(ioContext_.offset));
     (void)memset_s(inIoBuffer_, inIoBufferSize_, 0x00, inIoBufferSize_);
-    realSeekTime = seekTime;
+    realSeekTime = static_cast<int64_t>(timeStamp * HST_SECOND / timescale);
     return Status::OK;
 }
 
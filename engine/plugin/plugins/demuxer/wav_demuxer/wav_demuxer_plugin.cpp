@@ -23,6 +23,7 @@
 #include "foundation/log.h"
 #include "foundation/utils/constants.h"
 #include "plugin/common/plugin_time.h"
+#include "plugin/plugins/common/frame_index.h"
 
 namespace OHOS {
 namespace Media {
@@ -31,8 +32,11 @@ namespace WavPlugin {
 namespace {
 constexpr uint8_t  MAX_RANK = 100;
 constexpr uint8_t  PROBE_READ_LENGTH  = 4;
-constexpr uint32_t WAV_PER_FRAME_SIZE = 8192;
 constexpr uint32_t WAV_HEAD_INFO_LEN = sizeof(WavHeadAttr);
+constexpr uint32_t WAV_DEFAULT_FRAME_DURATION_MS = 20;
+constexpr uint32_t WAV_MIN_FRAME_DURATION_MS = 10;
+constexpr uint32_t WAV_MAX_FRAME_DURATION_MS = 100;
+constexpr uint32_t WAV_READ_BLOCK_SIZE = 256 * 1024; // 256 KiB per ReadAt, split into frames without copying
 bool WavSniff(const uint8_t *inputBuf);
 std::map<uint32_t, AudioSampleFormat> g_WavAudioSampleFormatPacked = {
     {8, AudioSampleFormat::U8},
@@ -49,6 +53,11 @@ enum class WavAudioFormat {
 };
 int Sniff(const std::string& pluginName, std::shared_ptr<DataSource> dataSource);
 Status RegisterPlugin(const std::shared_ptr<Register>& reg);
+
+uint32_t SamplesPerFrame(uint32_t sampleRate, uint32_t durationMs)
+{
+    return std::max<uint32_t>(static_cast<uint64_t>(sampleRate) * durationMs / 1000, 1); // 1000 ms per second
+}
 }
 
 WavDemuxerPlugin::WavDemuxerPlugin(std::string name)
@@ -57,7 +66,8 @@ WavDemuxerPlugin::WavDemuxerPlugin(std::string name)
       ioContext_(),
       dataOffset_(0),
       seekable_(Seekable::INVALID),
-      wavHeadLength_(0)
+      wavHeadLength_(0),
+      frameDurationMs_(WAV_DEFAULT_FRAME_DURATION_MS)
 {
     MEDIA_LOG_I("WavDemuxerPlugin, plugin name: " PUBLIC_LOG_S, pluginName_.c_str());
 }
@@ -91,19 +101,26 @@ Status WavDemuxerPlugin::GetMediaInfo(MediaInfo& mediaInfo)
         wavHeadLength_ -= 12; // 12 = subChunk2ID(optional)+subChunk2Size(optional)+dataFactSize(optional)
     }
     MEDIA_LOG_D("wavHeadLength_ " PUBLIC_LOG_U32, wavHeadLength_);
+    blockAlign_ = wavHeader_.blockAlign;
+    if (blockAlign_ == 0) {
+        blockAlign_ = wavHeader_.bitsPerSample / 8 * wavHeader_.numChannels; // 8 bits per byte
+    }
+    FALSE_RETURN_V_MSG_E(blockAlign_ != 0 && wavHeader_.sampleRate != 0, Status::ERROR_UNSUPPORTED_FORMAT,
+                         "invalid wav header, blockAlign " PUBLIC_LOG_U32 ", sampleRate " PUBLIC_LOG_U32,
+                         blockAlign_, wavHeader_.sampleRate);
+    totalSamples_ = fileSize_ > wavHeadLength_ ? (fileSize_ - wavHeadLength_) / blockAlign_ : 0;
+    samplesPerFrame_ = SamplesPerFrame(wavHeader_.sampleRate, frameDurationMs_);
     dataOffset_ = wavHeadLength_;
+    currentSample_ = 0;
+    block_.reset();
+    blockSize_ = 0;
     mediaInfo.tracks.resize(1);
     if (wavHeader_.numChannels == 1) {
         mediaInfo.tracks[0].Set<Tag::AUDIO_CHANNEL_LAYOUT>(AudioChannelLayout::MONO);
     } else {
         mediaInfo.tracks[0].Set<Tag::AUDIO_CHANNEL_LAYOUT>(AudioChannelLayout::STEREO);
     }
-    int64_t duration = 0;
-    if (!Sec2HstTime((fileSize_ - wavHeadLength_) * 8 /     // 8
-        (wavHeader_.sampleRate * wavHeader_.bitsPerSample * wavHeader_.numChannels), duration)) {
-        MEDIA_LOG_E("value overflow!");
-    }
-    mediaInfo.tracks[0].Set<Tag::MEDIA_DURATION>(duration);
+    mediaInfo.tracks[0].Set<Tag::MEDIA_DURATION>(SampleToTime(totalSamples_, wavHeader_.sampleRate));
     mediaInfo.tracks[0].Set<Tag::MEDIA_TYPE>(MediaType::AUDIO);
     mediaInfo.tracks[0].Set<Tag::AUDIO_SAMPLE_RATE>(wavHeader_.sampleRate);
     mediaInfo.tracks[0].Set<Tag::MEDIA_BITRATE>((wavHeader_.byteRate) * 8); // 8  byte to bit
@@ -111,7 +128,7 @@ Status WavDemuxerPlugin::GetMediaInfo(MediaInfo& mediaInfo)
     mediaInfo.tracks[0].Set<Tag::TRACK_ID>(0);
     mediaInfo.tracks[0].Set<Tag::MIME>(MEDIA_MIME_AUDIO_RAW);
     mediaInfo.tracks[0].Set<Tag::AUDIO_MPEG_VERSION>(1);
-    mediaInfo.tracks[0].Set<Tag::AUDIO_SAMPLE_PER_FRAME>(WAV_PER_FRAME_SIZE);
+    mediaInfo.tracks[0].Set<Tag::AUDIO_SAMPLE_PER_FRAME>(samplesPerFrame_);
     if (wavHeader_.audioFormat == static_cast<uint16_t>(WavAudioFormat::WAVE_FORMAT_PCM)
         || wavHeader_.audioFormat == static_cast<uint16_t>(WavAudioFormat::WAVE_FORMAT_EXTENSIBLE)) {
         mediaInfo.tracks[0].Set<Tag::AUDIO_SAMPLE_FORMAT>
@@ -127,16 +144,69 @@ Status WavDemuxerPlugin::GetMediaInfo(MediaInfo& mediaInfo)
 
 Status WavDemuxerPlugin::ReadFrame(Buffer& outBuffer, int32_t timeOutMs)
 {
-    std::shared_ptr<Buffer> outBufferPtr(&outBuffer, [](Buffer *) {});
+    FALSE_RETURN_V_MSG_E(samplesPerFrame_ != 0, Status::ERROR_WRONG_STATE, "ReadFrame before GetMediaInfo");
+    if (currentSample_ >= totalSamples_) {
+        return Status::END_OF_STREAM;
+    }
+    if (dataOffset_ < blockOffset_ || dataOffset_ >= blockOffset_ + blockSize_) {
+        auto ret = FillBlock();
+        if (ret != Status::OK) {
+            return ret;
+        }
+    }
+    uint64_t frameSize = std::min(static_cast<uint64_t>(samplesPerFrame_) * blockAlign_,
+                                  blockOffset_ + blockSize_ - dataOffset_);
+    const uint8_t* frameData = block_->GetMemory()->GetReadOnlyData(dataOffset_ - blockOffset_);
     if (outBuffer.IsEmpty()) {
-        outBuffer.AllocMemory(nullptr, WAV_PER_FRAME_SIZE);
+        // the frame memory aliases the block, which stays alive until every frame cut from it is released
+        frameSize = frameSize / blockAlign_ * blockAlign_;
+        outBuffer.WrapMemoryPtr(std::shared_ptr<uint8_t>(block_, const_cast<uint8_t*>(frameData)),
+                                frameSize, frameSize);
+    } else {
+        auto memory = outBuffer.GetMemory();
+        frameSize = std::min<uint64_t>(frameSize, memory->GetCapacity()) / blockAlign_ * blockAlign_;
+        memory->Write(frameData, frameSize, 0);
+        readStats_.bytesCopied += frameSize;
     }
-    Status retResult = ioContext_.dataSource->ReadAt(dataOffset_, outBufferPtr, WAV_PER_FRAME_SIZE);
-    dataOffset_ +=  outBuffer.GetMemory()->GetSize();
-    if (retResult != Status::OK) {
+    if (frameSize == 0) {
+        MEDIA_LOG_E("no room for a whole sample, blockAlign " PUBLIC_LOG_U32, blockAlign_);
+        return Status::ERROR_NO_MEMORY;
+    }
+    uint64_t samples = frameSize / blockAlign_;
+    outBuffer.trackID = 0;
+    outBuffer.pts = SampleToTime(currentSample_, wavHeader_.sampleRate);
+    outBuffer.dts = outBuffer.pts;
+    outBuffer.duration = SampleToTime(currentSample_ + samples, wavHeader_.sampleRate) - outBuffer.pts;
+    currentSample_ += samples;
+    dataOffset_ += frameSize;
+    readStats_.framesOut++;
+    readStats_.samplesOut += samples;
+    return Status::OK;
+}
+
+Status WavDemuxerPlugin::FillBlock()
+{
+    uint64_t frameSize = static_cast<uint64_t>(samplesPerFrame_) * blockAlign_;
+    uint64_t blockCapacity = std::max<uint64_t>(WAV_READ_BLOCK_SIZE / frameSize, 1) * frameSize;
+    uint64_t dataEnd = wavHeadLength_ + totalSamples_ * blockAlign_;
+    auto readSize = static_cast<size_t>(std::min(blockCapacity, dataEnd - dataOffset_));
+    // frames handed out earlier may still alias the current block, it is only reused once all of them are released
+    if (block_ == nullptr || block_.use_count() > 1 || block_->GetMemory()->GetCapacity() < readSize) {
+        block_ = std::make_shared<Buffer>();
+        block_->AllocMemory(nullptr, blockCapacity);
+    }
+    block_->GetMemory()->Reset();
+    blockSize_ = 0;
+    Status status = ioContext_.dataSource->ReadAt(static_cast<int64_t>(dataOffset_), block_, readSize);
+    if (status != Status::OK) {
         MEDIA_LOG_E("Read Data Error");
+        return status;
     }
-    return retResult;
+    blockOffset_ = dataOffset_;
+    blockSize_ = block_->GetMemory()->GetSize();
+    readStats_.reads++;
+    readStats_.bytesRead += blockSize_;
+    return blockSize_ >= blockAlign_ ? Status::OK : Status::END_OF_STREAM;
 }
 
 Status WavDemuxerPlugin::SeekTo(int32_t trackId, int64_t seekTime, SeekMode mode, int64_t& realSeekTime)
@@ -144,18 +214,11 @@ Status WavDemuxerPlugin::SeekTo(int32_t trackId, int64_t seekTime, SeekMode mode
     if (fileSize_ <= 0 || seekable_ == Seekable::INVALID || seekable_ == Seekable::UNSEEKABLE) {
         return Status::ERROR_INVALID_OPERATION;
     }
-    auto blockAlign = wavHeader_.bitsPerSample / 8 * wavHeader_.numChannels; // blockAlign = wavHeader_.blockAlign
-    auto byteRate = blockAlign * wavHeader_.sampleRate; // byteRate = wavHeader_.byteRate
-
-    // time(sec) * byte per second= current time byte number
-    auto position = HstTime2Sec(seekTime)  * byteRate;
-
-    // current time byte number / blockAlign
-    // To round and position to the starting point of a complete sample.
-    if (blockAlign) {
-        position = position / blockAlign * blockAlign;
-    }
-    dataOffset_ = position;
+    FALSE_RETURN_V_MSG_E(samplesPerFrame_ != 0, Status::ERROR_WRONG_STATE, "SeekTo before GetMediaInfo");
+    // every sample is a seek point, so the target sample and its offset are exact whatever the mode is
+    currentSample_ = std::min(TimeToSample(std::max<int64_t>(seekTime, 0), wavHeader_.sampleRate), totalSamples_);
+    dataOffset_ = wavHeadLength_ + currentSample_ * blockAlign_;
+    realSeekTime = SampleToTime(currentSample_, wavHeader_.sampleRate);
     return Status::OK;
 }
 
@@ -164,16 +227,65 @@ Status WavDemuxerPlugin::Reset()
     dataOffset_ = 0;
     fileSize_ = 0;
     seekable_ = Seekable::SEEKABLE;
+    currentSample_ = 0;
+    totalSamples_ = 0;
+    block_.reset();
+    blockOffset_ = 0;
+    blockSize_ = 0;
+    readStats_ = WavReadStats {};
+    return Status::OK;
+}
+
+Status WavDemuxerPlugin::SetFrameDuration(uint32_t durationMs)
+{
+    FALSE_RETURN_V_MSG_E(durationMs >= WAV_MIN_FRAME_DURATION_MS && durationMs <= WAV_MAX_FRAME_DURATION_MS,
+                         Status::ERROR_INVALID_PARAMETER, "unsupported frame duration " PUBLIC_LOG_U32, durationMs);
+    frameDurationMs_ = durationMs;
+    if (wavHeader_.sampleRate != 0) {
+        samplesPerFrame_ = SamplesPerFrame(wavHeader_.sampleRate, frameDurationMs_);
+    }
     return Status::OK;
 }
 
+WavReadStats WavDemuxerPlugin::GetReadStats() const
+{
+    WavReadStats stats = readStats_;
+    if (stats.samplesOut > 0) {
+        stats.readsPerSecond = static_cast<double>(stats.reads) * wavHeader_.sampleRate / stats.samplesOut;
+    }
+    return stats;
+}
+
 Status WavDemuxerPlugin::GetParameter(Tag tag, ValueType &value)
 {
-    return Status::ERROR_UNIMPLEMENTED;
+    switch (tag) {
+        case Tag::MEDIA_FRAME_DURATION:
+            value = static_cast<int64_t>(frameDurationMs_) * HST_MSECOND;
+            return Status::OK;
+        case Tag::MEDIA_SOURCE_READS:
+            value = readStats_.reads;
+            return Status::OK;
+        case Tag::MEDIA_SOURCE_READ_BYTES:
+            value = readStats_.bytesRead;
+            return Status::OK;
+        case Tag::MEDIA_SOURCE_READS_PER_SECOND:
+            value = GetReadStats().readsPerSecond;
+            return Status::OK;
+        default:
+            return Status::ERROR_UNIMPLEMENTED;
+    }
 }
 
 Status WavDemuxerPlugin::SetParameter(Tag tag, const ValueType &value)
 {
+    if (tag == Tag::MEDIA_FRAME_DURATION) {
+        FALSE_RETURN_V_MSG_E(Any::IsSameTypeWith<int64_t>(value), Status::ERROR_MISMATCHED_TYPE,
+                             "frame duration should be int64_t");
+        auto duration = AnyCast<int64_t>(value);
+        FALSE_RETURN_V_MSG_E(duration > 0 && duration % HST_MSECOND == 0, Status::ERROR_INVALID_PARAMETER,
+                             "frame duration should be whole milliseconds");
+        return SetFrameDuration(static_cast<uint32_t>(std::min<int64_t>(duration / HST_MSECOND, UINT32_MAX)));
+    }
     return Status::ERROR_UNIMPLEMENTED;
 }
 
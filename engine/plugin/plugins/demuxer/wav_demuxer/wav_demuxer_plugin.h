@@ -48,6 +48,15 @@ struct WavHeadAttr {
     uint32_t subChunk3Size;  // 4 byte Sampled data length
 }; // 根据wav协议构建的结构体，轻易勿动
 
+struct WavReadStats {
+    uint64_t reads {0};          // ReadAt calls issued to the data source
+    uint64_t bytesRead {0};      // bytes returned by the data source
+    uint64_t bytesCopied {0};    // bytes copied into caller provided frame memory
+    uint64_t framesOut {0};      // frames handed out by ReadFrame
+    uint64_t samplesOut {0};     // samples carried by those frames
+    double readsPerSecond {0.0}; // ReadAt calls per second of media handed out
+};
+
 class WavDemuxerPlugin : public DemuxerPlugin {
 public:
     explicit WavDemuxerPlugin(std::string name);
@@ -67,18 +76,34 @@ public:
     Status UnselectTrack(int32_t trackId) override;
     Status GetSelectedTracks(std::vector<int32_t>& trackIds) override;
     Status GetDataFromSource();
+
+    /// duration of the frames handed out by ReadFrame, should be set before GetMediaInfo,
+    /// also reachable as Tag::MEDIA_FRAME_DURATION through SetParameter
+    Status SetFrameDuration(uint32_t durationMs);
+    WavReadStats GetReadStats() const;
 private:
     struct IOContext {
         std::shared_ptr<DataSource> dataSource {nullptr};
         int64_t offset {0};
         bool eos {false};
     };
+    Status FillBlock();
+
     uint64_t            fileSize_;
     IOContext           ioContext_;
-    uint32_t            dataOffset_;
+    uint64_t            dataOffset_;
     Seekable            seekable_;
     uint32_t            wavHeadLength_;
     WavHeadAttr         wavHeader_ {};
+    uint32_t            blockAlign_ {0};
+    uint32_t            frameDurationMs_;
+    uint32_t            samplesPerFrame_ {0};
+    uint64_t            totalSamples_ {0};
+    uint64_t            currentSample_ {0};
+    std::shared_ptr<Buffer> block_ {nullptr};
+    uint64_t            blockOffset_ {0};
+    size_t              blockSize_ {0};
+    WavReadStats        readStats_ {};
 };
 } // namespace WavPlugin
 } // namespace Plugin
@@ -22,6 +22,7 @@
 #include "foundation/utils/constants.h"
 #include "plugin/common/plugin_audio_tags.h"
 #include "plugin/common/plugin_caps_builder.h"
+#include "plugin/common/plugin_time.h"
 #include "plugins/ffmpeg_adapter/utils/ffmpeg_utils.h"
 
 namespace {
@@ -33,6 +34,9 @@ void SetCapMime(const AVCodec* codec, CapabilityBuilder& capBuilder);
 std::map<std::string, std::shared_ptr<const AVCodec>> codecMap;
 
 const size_t BUFFER_QUEUE_SIZE = 6;
+const int SKIP_SAMPLES_SIDE_DATA_SIZE = 10; // 10: le32 skip samples, le32 discard padding, u8 reasons
+const int DISCARD_PADDING_OFFSET = 4;       // 4: discard padding follows the le32 skip samples
+const int SKIP_REASON_OFFSET = 8;           // 8: the reasons follow the discard padding
 
 const std::set<AVCodecID> g_supportedCodec = {
     AV_CODEC_ID_MP3,
@@ -322,6 +326,8 @@ do { \
     }
     tmpCtx->workaround_bugs = static_cast<uint32_t>(tmpCtx->workaround_bugs) | static_cast<uint32_t>(FF_BUG_AUTODETECT);
     tmpCtx->err_recognition = 1;
+    // pts of the packets are in hst time, the decoder moves them forward by the encoder delay it trims
+    tmpCtx->pkt_timebase = {1, HST_SECOND};
     {
         OSAL::ScopedLock lock(avMutex_);
         avCodecContext_ = tmpCtx;
@@ -499,6 +505,24 @@ Status AudioFfmpegDecoderPlugin::SendOutputBuffer()
     return status;
 }
 
+void AudioFfmpegDecoderPlugin::AddSkipSamplesLocked(Buffer& inputBuffer)
+{
+    auto bufferMeta = inputBuffer.GetBufferMeta();
+    if (bufferMeta == nullptr || !bufferMeta->IsExist(Tag::AUDIO_SKIP_SAMPLES)) {
+        return;
+    }
+    // libavcodec drops the encoder delay and padding from the decoded frames, as the demuxer found them
+    auto sideData = av_packet_new_side_data(avPacket_.get(), AV_PKT_DATA_SKIP_SAMPLES, SKIP_SAMPLES_SIDE_DATA_SIZE);
+    FALSE_RETURN_MSG(sideData != nullptr, "alloc skip samples side data fail");
+    AV_WL32(sideData, Plugin::AnyCast<uint32_t>(bufferMeta->GetMeta(Tag::AUDIO_SKIP_SAMPLES)));
+    uint32_t discardPadding = 0;
+    if (bufferMeta->IsExist(Tag::AUDIO_DISCARD_PADDING)) {
+        discardPadding = Plugin::AnyCast<uint32_t>(bufferMeta->GetMeta(Tag::AUDIO_DISCARD_PADDING));
+    }
+    AV_WL32(sideData + DISCARD_PADDING_OFFSET, discardPadding);
+    AV_WL16(sideData + SKIP_REASON_OFFSET, 0);
+}
+
 Status AudioFfmpegDecoderPlugin::SendBufferLocked(const std::shared_ptr<Buffer>& inputBuffer)
 {
     if (inputBuffer && !(inputBuffer->flag & BUFFER_FLAG_EOS)) {
@@ -519,6 +543,7 @@ Status AudioFfmpegDecoderPlugin::SendBufferLocked(const std::shared_ptr<Buffer>&
         avPacket_->data = const_cast<uint8_t*>(ptr);
         avPacket_->size = bufferLength;
         avPacket_->pts = inputBuffer->pts;
+        AddSkipSamplesLocked(*inputBuffer);
     }
     auto ret = avcodec_send_packet(avCodecContext_.get(), avPacket_.get());
     av_packet_unref(avPacket_.get());
@@ -26,6 +26,7 @@
 extern "C" {
 #endif
 #include "libavcodec/avcodec.h"
+#include "libavutil/intreadwrite.h"
 #ifdef __cplusplus
 };
 #endif
@@ -93,6 +94,8 @@ private:
 
     Status SendBufferLocked(const std::shared_ptr<Buffer>& inputBuffer);
 
+    void AddSkipSamplesLocked(Buffer& inputBuffer);
+
     Status ReceiveFrameSucc(const std::shared_ptr<Buffer>& ioInfo);
 
     Status ReceiveBuffer();
@@ -44,8 +44,17 @@ namespace Media {
 namespace Plugin {
 namespace Ffmpeg {
 namespace {
+// sniffers of several sources run at the same time, lookups must not insert and go under the lock
+OSAL::Mutex g_inputFormatMutex {};
 std::map<std::string, std::shared_ptr<AVInputFormat>> g_pluginInputFormat;
 
+std::shared_ptr<AVInputFormat> FindInputFormat(const std::string& pluginName)
+{
+    OSAL::ScopedLock lock(g_inputFormatMutex);
+    auto ite = g_pluginInputFormat.find(pluginName);
+    return ite == g_pluginInputFormat.end() ? nullptr : ite->second;
+}
+
 std::map<AVMediaType, MediaType> g_MediaTypeMap = {
     {AVMEDIA_TYPE_AUDIO, MediaType::AUDIO},
     {AVMEDIA_TYPE_VIDEO, MediaType::VIDEO},
@@ -59,10 +68,44 @@ static const std::map<SeekMode, int32_t> seekModeToFfmpegSeekFlags = {
     { SeekMode::SEEK_PREVIOUS_SYNC, AVSEEK_FLAG_FRAME | AVSEEK_FLAG_BACKWARD },
     { SeekMode::SEEK_NEXT_SYNC, AVSEEK_FLAG_FRAME },
     { SeekMode::SEEK_CLOSEST_SYNC, AVSEEK_FLAG_FRAME | AVSEEK_FLAG_ANY },
-    { SeekMode::SEEK_CLOSEST, AVSEEK_FLAG_FRAME | AVSEEK_FLAG_ANY }
+    // decoding starts at the gop of the target, the frames before the target are skipped by the decoder
+    { SeekMode::SEEK_CLOSEST, AVSEEK_FLAG_FRAME | AVSEEK_FLAG_BACKWARD }
 };
+constexpr int SKIP_SAMPLES_SIDE_DATA_SIZE = 10; // 10: le32 skip samples, le32 discard padding, u8 reasons
+constexpr int DISCARD_PADDING_OFFSET = 4;      // 4: discard padding follows the le32 skip samples
+
 int Sniff(const std::string& pluginName, std::shared_ptr<DataSource> dataSource);
 
+/// encoder delay and padding of the packet, the decoder trims them for the items of a playlist to join gaplessly
+void SetSkipSamples(const AVPacket& pkt, Buffer& frameInfo)
+{
+#if LIBAVCODEC_VERSION_MAJOR < 59
+    int size = 0;
+#else
+    size_t size = 0;
+#endif
+    auto sideData = av_packet_get_side_data(&pkt, AV_PKT_DATA_SKIP_SAMPLES, &size);
+    if (sideData == nullptr || size < SKIP_SAMPLES_SIDE_DATA_SIZE) {
+        return;
+    }
+    frameInfo.GetBufferMeta()->SetMeta(Tag::AUDIO_SKIP_SAMPLES, static_cast<uint32_t>(AV_RL32(sideData)));
+    frameInfo.GetBufferMeta()->SetMeta(Tag::AUDIO_DISCARD_PADDING,
+                                       static_cast<uint32_t>(AV_RL32(sideData + DISCARD_PADDING_OFFSET)));
+}
+
+int GetIndexEntryCount(const AVStream& avStream)
+{
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 0)
+    return avformat_index_get_entries_count(&avStream);
+#elif LIBAVFORMAT_VERSION_INT == AV_VERSION_INT(58, 76, 100)
+    return avStream.nb_index_entries;
+#elif LIBAVFORMAT_VERSION_INT > AV_VERSION_INT(58, 64, 100)
+    return avStream.internal->nb_index_entries;
+#else
+    return avStream.nb_index_entries;
+#endif
+}
+
 Status RegisterPlugins(const std::shared_ptr<Register>& reg);
 static void FfmpegLogInit();
 } // namespace
@@ -107,13 +150,14 @@ Status FFmpegDemuxerPlugin::Init()
     MEDIA_LOG_D("Init called.");
     Reset();
     FfmpegLogInit();
-    pluginImpl_ = g_pluginInputFormat[pluginName_];
+    pluginImpl_ = FindInputFormat(pluginName_);
 
     return pluginImpl_ ? Status::OK : Status::ERROR_UNSUPPORTED_FORMAT;
 }
 
 Status FFmpegDemuxerPlugin::Deinit()
 {
+    seekIndex_.Close();
     avbsfContext_.reset();
     vdBitStreamFormat_ = VideoBitStreamFormat{VideoBitStreamFormat::UNKNOWN};
     return Status::OK;
@@ -135,6 +179,7 @@ Status FFmpegDemuxerPlugin::Reset()
     ioContext_.offset = 0;
     ioContext_.eos = false;
     selectedTrackIds_.clear();
+    seekIndex_.Close();
     avbsfContext_.reset();
     vdBitStreamFormat_ = VideoBitStreamFormat{VideoBitStreamFormat::UNKNOWN};
     return Status::OK;
@@ -169,6 +214,12 @@ Status FFmpegDemuxerPlugin::SetParameter(Tag tag, const ValueType& value)
         case Tag::VIDEO_BIT_STREAM_FORMAT:
             vdBitStreamFormat_ = Plugin::AnyCast<VideoBitStreamFormat>(value);
             break;
+        case Tag::MEDIA_FILE_URI:
+            uri_ = Plugin::AnyCast<std::string>(value);
+            break;
+        case Tag::SEEK_INDEX_DIR:
+            SeekIndex::SetDirectory(Plugin::AnyCast<std::string>(value));
+            break;
         default:
             break;
     }
@@ -254,13 +305,21 @@ bool FFmpegDemuxerPlugin::ConvertAVPacketToFrameInfo(const AVStream& avStream, A
     frameInfo.trackID = static_cast<uint32_t>(pkt.stream_index);
     int64_t pts = (pkt.pts > 0) ? pkt.pts : 0;
     frameInfo.pts = ConvertTimeFromFFmpeg(pts, avStream.time_base);
-    frameInfo.dts = static_cast<uint32_t>(pkt.dts);
+    if (pkt.dts != AV_NOPTS_VALUE) {
+        // negative before the first pts of streams with b frames
+        frameInfo.dts = ConvertTimeFromFFmpeg(pkt.dts, avStream.time_base);
+        frameInfo.flag |= BUFFER_FLAG_DTS_VALID;
+    }
+    if (static_cast<uint32_t>(pkt.flags) & static_cast<uint32_t>(AV_PKT_FLAG_KEY)) {
+        frameInfo.flag |= BUFFER_FLAG_KEY_FRAME;
+    }
     frameInfo.duration = ConvertTimeFromFFmpeg(pkt.duration, avStream.time_base);
     frameInfo.GetBufferMeta()->SetMeta(Tag::MEDIA_POSITION, static_cast<uint32_t>(pkt.pos));
 
     int frameSize = 0;
     if (avStream.codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
         frameSize = pkt.size;
+        SetSkipSamples(pkt, frameInfo);
     } else if (avStream.codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
         if (avStream.codecpar->codec_id == AV_CODEC_ID_RAWVIDEO) {
             MEDIA_LOG_W("unsupport raw video");
@@ -329,6 +388,9 @@ Status FFmpegDemuxerPlugin::ReadFrame(Buffer& info, int32_t timeOutMs)
         res = av_read_frame(formatContext_.get(), &pkt);
     } while (res >= 0 && !selectedTrackIds_.empty() && !IsSelectedTrack(pkt.stream_index));
     Status result = Status::ERROR_UNKNOWN;
+    if (res == 0) {
+        RecordSyncFrame(*(formatContext_->streams[pkt.stream_index]), pkt);
+    }
     if (res == 0 && ConvertAVPacketToFrameInfo(*(formatContext_->streams[pkt.stream_index]), pkt, info)) {
         result = Status::OK;
     } else {
@@ -343,7 +405,7 @@ Status FFmpegDemuxerPlugin::ReadFrame(Buffer& info, int32_t timeOutMs)
  * @param trackId  -1 for unspecified, >= 0 for specific trackid
  * @param seekTime
  * @param mode
- * @param realSeekTime
+ * @param realSeekTime time of the sync frame decoding starts at, the gop start of the target for SEEK_CLOSEST
  * @return operation result.
  */
 Status FFmpegDemuxerPlugin::SeekTo(int32_t trackId, int64_t seekTime, SeekMode mode, int64_t& realSeekTime)
@@ -525,9 +587,48 @@ bool FFmpegDemuxerPlugin::ParseMediaData()
         mediaInfo_->tracks.push_back(std::move(track));
     }
     SaveFileInfoToMetaInfo(mediaInfo_->general);
+    LoadSeekIndex();
     return true;
 }
 
+// sync frames indexed by an earlier playback of the file, for the video streams the container does not index, e.g. ts
+void FFmpegDemuxerPlugin::LoadSeekIndex()
+{
+    auto unindexed = [](const AVStream* avStream) {
+        return avStream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && GetIndexEntryCount(*avStream) == 0;
+    };
+    auto streams = formatContext_->streams;
+    if (uri_.empty() || std::none_of(streams, streams + formatContext_->nb_streams, unindexed) ||
+        !seekIndex_.Open(uri_)) {
+        return;
+    }
+    for (uint32_t i = 0; i < formatContext_->nb_streams; ++i) {
+        auto avStream = streams[i];
+        if (!unindexed(avStream)) {
+            continue;
+        }
+        for (const auto& entry : seekIndex_.GetEntries(i)) {
+            (void)av_add_index_entry(avStream, entry.position, ConvertTimeToFFmpeg(entry.pts, avStream->time_base),
+                                     0, 0, AVINDEX_KEYFRAME);
+        }
+    }
+}
+
+// sync frames of video are kept by the seek index, audio frames are all sync frames
+void FFmpegDemuxerPlugin::RecordSyncFrame(const AVStream& avStream, const AVPacket& pkt)
+{
+    if (avStream.codecpar->codec_type != AVMEDIA_TYPE_VIDEO ||
+        !(static_cast<uint32_t>(pkt.flags) & static_cast<uint32_t>(AV_PKT_FLAG_KEY))) {
+        return;
+    }
+    // by dts, as ffmpeg indexes and seeks
+    int64_t time = (pkt.dts != AV_NOPTS_VALUE) ? pkt.dts : pkt.pts;
+    if (time != AV_NOPTS_VALUE) {
+        seekIndex_.Add(static_cast<uint32_t>(pkt.stream_index), ConvertTimeFromFFmpeg(time, avStream.time_base),
+                       pkt.pos);
+    }
+}
+
 // ffmpeg provide buf, we write data
 int FFmpegDemuxerPlugin::AVReadPacket(void* opaque, uint8_t* buf, int bufSize) // NOLINT
 {
@@ -608,7 +709,7 @@ int Sniff(const std::string& pluginName, std::shared_ptr<DataSource> dataSource)
         MEDIA_LOG_E("Sniff failed due to empty plugin name or dataSource invalid.");
         return 0;
     }
-    auto plugin = g_pluginInputFormat[pluginName];
+    auto plugin = FindInputFormat(pluginName);
     if (!plugin || !plugin->read_probe) {
         MEDIA_LOG_DD("Sniff failed due to invalid plugin for " PUBLIC_LOG_S ".", pluginName.c_str());
         return 0;
@@ -685,8 +786,11 @@ Status RegisterPlugins(const std::shared_ptr<Register>& reg)
         regInfo.description = "adapter for ffmpeg demuxer plugin";
         regInfo.rank = 100; // 100
         SplitString(plugin->extensions, ',').swap(regInfo.extensions);
-        g_pluginInputFormat[pluginName] =
-            std::shared_ptr<AVInputFormat>(const_cast<AVInputFormat*>(plugin), [](void*) {});
+        {
+            OSAL::ScopedLock lock(g_inputFormatMutex);
+            g_pluginInputFormat[pluginName] =
+                std::shared_ptr<AVInputFormat>(const_cast<AVInputFormat*>(plugin), [](void*) {});
+        }
         regInfo.creator = [](const std::string& name) -> std::shared_ptr<DemuxerPlugin> {
             return std::make_shared<FFmpegDemuxerPlugin>(name);
         };
@@ -753,7 +857,10 @@ static void FfmpegLogInit()
 }
 } // namespace
 
-PLUGIN_DEFINITION(FFmpegDemuxer, LicenseType::LGPL, RegisterPlugins, [] { g_pluginInputFormat.clear(); });
+PLUGIN_DEFINITION(FFmpegDemuxer, LicenseType::LGPL, RegisterPlugins, [] {
+    OSAL::ScopedLock lock(g_inputFormatMutex);
+    g_pluginInputFormat.clear();
+});
 } // namespace Ffmpeg
 } // namespace Plugin
 } // namespace Media
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include "foundation/osal/thread/mutex.h"
+#include "foundation/utils/seek_index.h"
 #include "plugin/interface/demuxer_plugin.h"
 
 #ifdef __cplusplus
@@ -27,6 +28,7 @@ extern "C" {
 #endif
 #include "libavformat/avformat.h"
 #include "libavcodec/avcodec.h"
+#include "libavutil/intreadwrite.h"
 #ifdef __cplusplus
 }
 #endif
@@ -85,6 +87,10 @@ private:
 
     bool ParseMediaData();
 
+    void LoadSeekIndex();
+
+    void RecordSyncFrame(const AVStream& avStream, const AVPacket& pkt);
+
     bool ConvertAVPacketToFrameInfo(const AVStream& avStream, AVPacket& pkt, Buffer& frameInfo);
 
     static int AVReadPacket(void* opaque, uint8_t* buf, int bufSize); // NOLINT: void*
@@ -108,6 +114,8 @@ private:
     std::shared_ptr<Allocator> allocator_;
     std::unique_ptr<MediaInfo> mediaInfo_;
     std::vector<int32_t> selectedTrackIds_;
+    std::string uri_ {};
+    SeekIndex seekIndex_ {};
     OSAL::Mutex mutex_ {};
 };
 } // namespace Ffmpeg
@@ -17,8 +17,11 @@
 
 #include "ffmpeg_muxer_plugin.h"
 
+#include <algorithm>
 #include <functional>
+#include <map>
 #include <set>
+#include <vector>
 
 #include "foundation/log.h"
 #include "foundation/osal/thread/scoped_lock.h"
@@ -33,22 +36,41 @@ std::function<int32_t(uint32_t)> ui2iFunc = [](uint32_t i) {return i;};
 
 std::map<std::string, std::shared_ptr<AVOutputFormat>> g_pluginOutputFmt;
 
-std::set<std::string> g_supportedMuxer = {"mp4", "h264"};
+std::set<std::string> g_supportedMuxer = {"mp4", "mpegts", "h264"};
+
+// codecs muxed besides the default ones of the format, whose defaults are mpeg-2 for mpegts
+std::map<std::string, std::vector<AVCodecID>> g_muxerExtraCodecs = {
+    {"mpegts", {AV_CODEC_ID_AAC, AV_CODEC_ID_H264}},
+};
 
 bool IsMuxerSupported(const char* name)
 {
     return g_supportedMuxer.count(name) == 1;
 }
 
+bool IsCodecOfMuxer(const AVOutputFormat* fmt, AVCodecID codecId)
+{
+    if (codecId == fmt->audio_codec || codecId == fmt->video_codec || codecId == fmt->subtitle_codec) {
+        return true;
+    }
+    auto ite = g_muxerExtraCodecs.find(fmt->name);
+    return ite != g_muxerExtraCodecs.end() &&
+        std::find(ite->second.begin(), ite->second.end(), codecId) != ite->second.end();
+}
+
 bool UpdatePluginInCapability(AVCodecID codecId, CapabilitySet& capSet)
 {
     if (codecId != AV_CODEC_ID_NONE) {
         Capability cap;
         if (!FFCodecMap::CodecId2Cap(codecId, true, cap)) {
             return false;
-        } else {
-            capSet.emplace_back(cap);
         }
+        if (codecId == AV_CODEC_ID_H264) {
+            // the codec config of demuxed tracks is in annex-b, so are the packets that go with it
+            cap.AppendFixedKey<VideoBitStreamFormat>(Capability::Key::VIDEO_BIT_STREAM_FORMAT,
+                                                     VideoBitStreamFormat::ANNEXB);
+        }
+        capSet.emplace_back(cap);
     }
     return true;
 }
@@ -62,6 +84,12 @@ bool UpdatePluginCapability(const AVOutputFormat* oFmt, MuxerPluginDef& pluginDe
     UpdatePluginInCapability(oFmt->audio_codec, pluginDef.inCaps);
     UpdatePluginInCapability(oFmt->video_codec, pluginDef.inCaps);
     UpdatePluginInCapability(oFmt->subtitle_codec, pluginDef.inCaps);
+    auto ite = g_muxerExtraCodecs.find(oFmt->name);
+    if (ite != g_muxerExtraCodecs.end()) {
+        for (auto codecId : ite->second) {
+            UpdatePluginInCapability(codecId, pluginDef.inCaps);
+        }
+    }
     return true;
 }
 
@@ -113,20 +141,7 @@ Status SetCodecByMime(const AVOutputFormat* fmt, const std::string& mime, AVStre
     auto ptr = avcodec_find_encoder(id);
     FALSE_RETURN_V_MSG_E(ptr != nullptr, Status::ERROR_UNSUPPORTED_FORMAT,
                          "codec of mime " PUBLIC_LOG_S " is not founder as encoder", mime.c_str());
-    bool matched = true;
-    switch (ptr->type) {
-        case AVMEDIA_TYPE_VIDEO:
-            matched = id == fmt->video_codec;
-            break;
-        case AVMEDIA_TYPE_AUDIO:
-            matched = id == fmt->audio_codec;
-            break;
-        case AVMEDIA_TYPE_SUBTITLE:
-            matched = id == fmt->subtitle_codec;
-            break;
-        default:
-            matched = false;
-    }
+    bool matched = IsCodecOfMuxer(fmt, id);
     FALSE_RETURN_V_MSG_E(matched, Status::ERROR_UNSUPPORTED_FORMAT,  "codec of mime " PUBLIC_LOG_S
         " is not matched with " PUBLIC_LOG_S " muxer", mime.c_str(), fmt->name);
     stream->codecpar->codec_id = id;
@@ -181,10 +196,6 @@ Status SetParameterOfVdTrack(AVStream* stream, const Meta& meta)
     int64_t bitRate;
     VideoPixelFormat format;
     VideoH264Profile profile;
-    FALSE_RETURN_V(meta.Get<Tag::VIDEO_PIXEL_FORMAT>(format),
-                   Status::ERROR_INVALID_PARAMETER);
-    stream->codecpar->format = static_cast<int>(ConvertPixelFormatToFFmpeg(format));
-
     FALSE_RETURN_V(meta.Get<Tag::VIDEO_WIDTH>(width),
                    Status::ERROR_INVALID_PARAMETER);
     stream->codecpar->width = ui2iFunc(width);
@@ -193,17 +204,19 @@ Status SetParameterOfVdTrack(AVStream* stream, const Meta& meta)
                    Status::ERROR_INVALID_PARAMETER);
     stream->codecpar->height = ui2iFunc(height);
 
-    FALSE_RETURN_V(meta.Get<Tag::MEDIA_BITRATE>(bitRate),
-                   Status::ERROR_INVALID_PARAMETER);
-    stream->codecpar->bit_rate = bitRate;
-
-    FALSE_RETURN_V(meta.Get<Tag::VIDEO_H264_PROFILE>(profile),
-                   Status::ERROR_INVALID_PARAMETER);
-    stream->codecpar->profile = static_cast<int>(ConvH264ProfileToFfmpeg(profile));
-
-    FALSE_RETURN_V(meta.Get<Tag::VIDEO_H264_LEVEL>(level),
-                   Status::ERROR_INVALID_PARAMETER);
-    stream->codecpar->level = ui2iFunc(level);
+    // tracks copied from a demuxer only have what the container tells, the rest is in the codec config
+    if (meta.Get<Tag::VIDEO_PIXEL_FORMAT>(format)) {
+        stream->codecpar->format = static_cast<int>(ConvertPixelFormatToFFmpeg(format));
+    }
+    if (meta.Get<Tag::MEDIA_BITRATE>(bitRate)) {
+        stream->codecpar->bit_rate = bitRate;
+    }
+    if (meta.Get<Tag::VIDEO_H264_PROFILE>(profile)) {
+        stream->codecpar->profile = static_cast<int>(ConvH264ProfileToFfmpeg(profile));
+    }
+    if (meta.Get<Tag::VIDEO_H264_LEVEL>(level)) {
+        stream->codecpar->level = ui2iFunc(level);
+    }
     return Status::OK;
 }
 
@@ -459,7 +472,9 @@ Status FFmpegMuxerPlugin::WriteFrame(const std::shared_ptr<Plugin::Buffer>& buff
     cachePacket_->size = memory->GetSize();
     cachePacket_->stream_index = static_cast<int>(trackId);
     cachePacket_->pts = ConvertTimeToFFmpeg(buffer->pts, formatContext_->streams[trackId]->time_base);
-    cachePacket_->dts = cachePacket_->pts;
+    // copied video tracks keep their decoding order, encoders without b frames only fill pts
+    cachePacket_->dts = (buffer->flag & BUFFER_FLAG_DTS_VALID) ?
+        ConvertTimeToFFmpeg(buffer->dts, formatContext_->streams[trackId]->time_base) : cachePacket_->pts;
     cachePacket_->flags = 0;
     if (buffer->flag & BUFFER_FLAG_KEY_FRAME) {
         MEDIA_LOG_D("It is key frame");
@@ -14,76 +14,218 @@
  */
 
 #include "bit_reader.h"
+#include <algorithm>
 
 namespace OHOS {
 namespace Media {
 namespace Plugin {
 namespace Ffmpeg {
-BitReader::BitReader() : begin_(nullptr), cur_(nullptr), end_(nullptr)
+namespace {
+constexpr uint8_t BYTE_BITS = 8; // 8: bits per byte
+constexpr uint8_t EMULATION_PREVENTION_BYTE = 0x03;
+constexpr uint8_t EMULATION_PREVENTION_ZEROS = 2; // 2: 00 00 before 03
+constexpr uint8_t MAX_EXP_GOLOMB_ZEROS = 31; // 31: leading zeros of the largest 32 bits ue(v)
+constexpr size_t WORD_BYTES = 8; // 8: bytes per reservoir word
+
+uint64_t LoadBigEndian64(const uint8_t* ptr)
+{
+    uint64_t word = 0;
+    for (size_t i = 0; i < WORD_BYTES; ++i) {
+        word = (word << BYTE_BITS) | ptr[i];
+    }
+    return word;
+}
+} // namespace
+
+BitReader::BitReader() : begin_(nullptr), next_(nullptr), end_(nullptr)
 {
 }
 
-BitReader::BitReader(const uint8_t* buffer, size_t bufferSize) : begin_(buffer), cur_(buffer), end_(buffer + bufferSize)
+BitReader::BitReader(const uint8_t* buffer, size_t bufferSize)
+    : begin_(buffer), next_(buffer), end_(buffer + bufferSize)
 {
 }
 
-BitReader::BitReader(const uint8_t* begin, const uint8_t* end) : begin_(begin), cur_(begin), end_(end)
+BitReader::BitReader(const uint8_t* begin, const uint8_t* end) : begin_(begin), next_(begin), end_(end)
 {
 }
 
 BitReader::~BitReader()
 {
     begin_ = nullptr;
-    cur_ = nullptr;
+    next_ = nullptr;
     end_ = nullptr;
-    availBits_ = 8; // 8
+    ClearCache();
 }
 
 size_t BitReader::GetAvailableBits() const
 {
-    return (cur_ != end_) ? static_cast<std::size_t>(((end_ - cur_ - 1) * 8) + availBits_) : 0; // 8
+    return static_cast<size_t>(end_ - next_) * BYTE_BITS + cacheBits_;
 }
 
 const uint8_t* BitReader::GetCurrentPtr() const
 {
-    return cur_;
+    return next_ - (cacheBits_ + BYTE_BITS - 1) / BYTE_BITS;
+}
+
+bool BitReader::Refill(uint8_t bits)
+{
+    FillBytes();
+    return cacheBits_ >= bits;
+}
+
+void BitReader::FillBytes()
+{
+    if (!rbsp_ && static_cast<size_t>(end_ - next_) >= WORD_BYTES) {
+        // whole bytes which fit behind the cached bits, taken from one big endian word
+        uint8_t bytes = (CACHE_BITS - cacheBits_) / BYTE_BITS;
+        if (bytes == 0) {
+            return;
+        }
+        uint64_t word = LoadBigEndian64(next_);
+        uint8_t newBits = cacheBits_ + bytes * BYTE_BITS;
+        if (newBits < CACHE_BITS) {
+            word &= ~((UINT64_C(1) << (CACHE_BITS - bytes * BYTE_BITS)) - 1);
+        }
+        cache_ |= word >> cacheBits_;
+        cacheBits_ = newBits;
+        next_ += bytes;
+        return;
+    }
+    while (cacheBits_ <= CACHE_BITS - BYTE_BITS && next_ < end_) {
+        uint8_t byte = *next_++;
+        if (rbsp_) {
+            if (zeroBytes_ >= EMULATION_PREVENTION_ZEROS && byte == EMULATION_PREVENTION_BYTE) {
+                zeroBytes_ = 0;
+                continue;
+            }
+            zeroBytes_ = (byte == 0) ? zeroBytes_ + 1 : 0;
+        }
+        cache_ |= static_cast<uint64_t>(byte) << (CACHE_BITS - BYTE_BITS - cacheBits_);
+        cacheBits_ += BYTE_BITS;
+    }
+}
+
+bool BitReader::ReadLongBits(uint8_t bits, uint64_t& val)
+{
+    if (bits > CACHE_BITS) {
+        return false;
+    }
+    auto backup = *this;
+    uint32_t high = 0;
+    uint32_t low = 0;
+    uint8_t lowBits = bits / 2; // 2: read in two halves
+    if (!ReadBits(bits - lowBits, high) || !ReadBits(lowBits, low)) {
+        *this = backup;
+        return false;
+    }
+    val = (static_cast<uint64_t>(high) << lowBits) | low;
+    return true;
+}
+
+bool BitReader::ReadUe(uint32_t& val)
+{
+    // a 32 bits ue(v) has at most 31 leading zeros, they always fit in the reservoir after a refill
+    (void)Refill(MAX_EXP_GOLOMB_ZEROS + 1);
+    // a sentinel bit right after the cached bits bounds the count of leading zeros
+    uint64_t window = (cacheBits_ == CACHE_BITS) ? cache_ : (cache_ | (UINT64_C(1) << (CACHE_BITS - 1 - cacheBits_)));
+    if (window == 0) {
+        return false;
+    }
+    auto leadingZeros = static_cast<uint8_t>(__builtin_clzll(window));
+    if (leadingZeros >= cacheBits_ || leadingZeros > MAX_EXP_GOLOMB_ZEROS) {
+        return false;
+    }
+    uint8_t codeBits = leadingZeros * 2 + 1; // 2: zeros, then as many info bits after the marker
+    if (codeBits <= cacheBits_) {
+        val = static_cast<uint32_t>((cache_ >> (CACHE_BITS - codeBits)) - 1);
+        Consume(codeBits);
+        return true;
+    }
+    auto backup = *this;
+    Consume(leadingZeros);
+    uint64_t info = 0;
+    if (!ReadBits(leadingZeros + 1, info)) {
+        *this = backup;
+        return false;
+    }
+    val = static_cast<uint32_t>(info - 1);
+    return true;
+}
+
+bool BitReader::ReadSe(int32_t& val)
+{
+    uint32_t codeNum = 0;
+    if (!ReadUe(codeNum)) {
+        return false;
+    }
+    // 1, 2, 3, 4 ... -> 1, -1, 2, -2 ...
+    auto magnitude = static_cast<int64_t>((static_cast<uint64_t>(codeNum) + 1) / 2); // 2: pairs of +-k
+    val = static_cast<int32_t>((codeNum & 1) ? magnitude : -magnitude);
+    return true;
 }
 
 void BitReader::SkipBits(size_t bits)
 {
-    if (bits <= availBits_) {
-        availBits_ -= static_cast<uint8_t>(bits);
+    if (bits <= cacheBits_) {
+        Consume(static_cast<uint8_t>(bits));
         return;
     }
-    auto skipBits = bits;
-    cur_ += (1 + (skipBits -= availBits_) / 8); // 8
-    if (cur_ >= end_) {
-        cur_ = end_;
-        availBits_ = 0;
-    } else {
-        availBits_ = 8 - skipBits % 8; // 8
+    bits -= cacheBits_;
+    ClearCache();
+    if (!rbsp_) {
+        size_t bytes = std::min(bits / BYTE_BITS, static_cast<size_t>(end_ - next_));
+        next_ += bytes;
+        bits -= bytes * BYTE_BITS;
+    }
+    while (bits > 0) {
+        FillBytes();
+        if (cacheBits_ == 0) {
+            return;
+        }
+        auto toSkip = static_cast<uint8_t>(std::min(bits, static_cast<size_t>(cacheBits_)));
+        Consume(toSkip);
+        bits -= toSkip;
     }
 }
 
 bool BitReader::SeekTo(size_t bitPos)
 {
-    size_t bytePos = bitPos / 8; // 8
+    size_t bytePos = bitPos / BYTE_BITS;
     if (begin_ + bytePos >= end_) {
         return false;
     }
-    cur_ = begin_ + bytePos;
-    uint8_t skipBits = bitPos % 8; // 8
-    availBits_ = 8 - skipBits;     // 8
-    SkipBits(skipBits);
+    next_ = begin_ + bytePos;
+    ClearCache();
+    zeroBytes_ = 0;
+    // zeros right before the target still count towards an emulation prevention sequence
+    while (rbsp_ && zeroBytes_ < EMULATION_PREVENTION_ZEROS && next_ - zeroBytes_ > begin_ &&
+        *(next_ - zeroBytes_ - 1) == 0) {
+        ++zeroBytes_;
+    }
+    SkipBits(bitPos % BYTE_BITS);
     return true;
 }
 
+void BitReader::SetRbspMode(bool enable)
+{
+    rbsp_ = enable;
+    zeroBytes_ = 0;
+}
+
+void BitReader::ClearCache()
+{
+    cache_ = 0;
+    cacheBits_ = 0;
+}
+
 void BitReader::Reset(const uint8_t* begin, const uint8_t* end)
 {
     begin_ = begin;
-    cur_ = begin;
+    next_ = begin;
     end_ = end;
-    availBits_ = 8; // 8
+    ClearCache();
+    zeroBytes_ = 0;
 }
 } // namespace Ffmpeg
 } // namespace Plugin
@@ -17,12 +17,22 @@
 #define HISTREAMER_BIT_READER_H
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint> // NOLINT
+#include <type_traits>
 
 namespace OHOS {
 namespace Media {
 namespace Plugin {
 namespace Ffmpeg {
+/**
+ * Big endian bit reader over a byte buffer.
+ *
+ * Bits are served from a 64 bit reservoir refilled a word at a time, so reads, peeks and exp-Golomb codes cost a
+ * shift and a mask rather than a loop over bytes. In RBSP mode the emulation prevention bytes (0x03 in 00 00 03) of
+ * H.264/H.265 NAL units are dropped while refilling, positions (SeekTo, GetCurrentPtr, GetAvailableBits) then stay
+ * in terms of the escaped buffer and GetAvailableBits counts the emulation prevention bytes not reached yet.
+ */
 class BitReader {
 public:
     BitReader();
@@ -44,32 +54,38 @@ public:
 
     ~BitReader();
 
+    /// read up to 64 bits, nothing is consumed if fewer bits are left
     template <typename T, typename std::enable_if<std::is_unsigned<T>::value, bool>::type = true>
     bool ReadBits(uint8_t bits, T& val)
     {
-        if (GetAvailableBits() < bits) {
-            return false;
-        }
-        val = 0;
-        uint8_t remainBits = bits;
-        for (uint8_t toRead = 0; remainBits; remainBits -= toRead) {
-            if (availBits_ == 0) {
-                ++cur_;
-                availBits_ = 8; // 8
+        uint64_t tmp = 0;
+        if (bits > MAX_CACHED_READ_BITS) {
+            if (!ReadLongBits(bits, tmp)) {
+                return false;
+            }
+        } else {
+            if (cacheBits_ < bits && !Refill(bits)) {
+                return false;
             }
-            toRead = std::min(remainBits, availBits_);
-            uint8_t shift = availBits_ - toRead;
-            uint64_t mask = 0xFF >> (0x08 - toRead);
-            val = static_cast<T>((val << toRead) | static_cast<T>(((*cur_) >> shift) & mask));
-            availBits_ -= toRead;
+            tmp = (bits == 0) ? 0 : (cache_ >> (CACHE_BITS - bits));
+            Consume(bits);
         }
+        val = static_cast<T>(tmp);
         return true;
     }
 
+    /// ue(v), values beyond 32 bits are rejected
+    bool ReadUe(uint32_t& val);
+
+    /// se(v)
+    bool ReadSe(int32_t& val);
+
     size_t GetAvailableBits() const;
 
+    /// the byte holding the next bit to read
     const uint8_t* GetCurrentPtr() const;
 
+    /// constant time in raw mode, skipping beyond the end leaves the reader at the end
     void SkipBits(size_t bits);
 
     bool SeekTo(size_t bitPos);
@@ -77,8 +93,15 @@ public:
     template <typename T>
     bool PeekBits(uint8_t bits, T& val)
     {
-        auto tmp = *this;
-        return tmp.ReadBits<T>(bits, val);
+        if (bits > MAX_CACHED_READ_BITS) {
+            auto tmp = *this;
+            return tmp.ReadBits<T>(bits, val);
+        }
+        if (cacheBits_ < bits && !Refill(bits)) {
+            return false;
+        }
+        val = static_cast<T>((bits == 0) ? 0 : (cache_ >> (CACHE_BITS - bits)));
+        return true;
     }
 
     template <typename T>
@@ -93,13 +116,37 @@ public:
         Reset(reinterpret_cast<const uint8_t*>(begin), reinterpret_cast<const uint8_t*>(end)); // NOLINT: cast
     }
 
+    /// switch to reading the RBSP of a NAL unit, takes effect for the bytes not cached yet
+    void SetRbspMode(bool enable);
+
 private:
+    static constexpr uint8_t CACHE_BITS = 64; // 64: reservoir width
+    static constexpr uint8_t MAX_CACHED_READ_BITS = CACHE_BITS - 8; // 8: a refill may leave up to 7 bits unfilled
+
     void Reset(const uint8_t* begin, const uint8_t* end);
 
+    /// top up the reservoir, false if fewer than bits are left
+    bool Refill(uint8_t bits);
+
+    void FillBytes();
+
+    bool ReadLongBits(uint8_t bits, uint64_t& val);
+
+    void Consume(uint8_t bits)
+    {
+        cache_ = (bits >= CACHE_BITS) ? 0 : (cache_ << bits);
+        cacheBits_ -= bits;
+    }
+
+    void ClearCache();
+
     const uint8_t* begin_;
-    const uint8_t* cur_;
+    const uint8_t* next_;    // next byte to move into the reservoir
     const uint8_t* end_;
-    uint8_t availBits_{8};
+    uint64_t cache_ {0};     // unread bits, left aligned
+    uint8_t cacheBits_ {0};
+    bool rbsp_ {false};
+    uint8_t zeroBytes_ {0};  // consecutive zero bytes moved into the reservoir, rbsp mode only
 };
 } // namespace Ffmpeg
 } // namespace Plugin
@@ -56,6 +56,9 @@ bool FormatName2Cap(const std::string& fmtName, CapabilitySet& outCaps)
     if (fmtName == "mp4") {
         outCaps.emplace_back(Capability(MEDIA_MIME_CONTAINER_MP4));
         return true;
+    } else if (fmtName == "mpegts") {
+        outCaps.emplace_back(Capability(MEDIA_MIME_CONTAINER_MPEGTS));
+        return true;
     } else if (fmtName == "h264") {
         outCaps.emplace_back(Capability(MEDIA_MIME_VIDEO_H264));
         return true;
@@ -176,6 +176,14 @@ Status VideoFfmpegDecoderPlugin::Deinit()
 Status VideoFfmpegDecoderPlugin::SetParameter(Tag tag, const ValueType& value)
 {
     OSAL::ScopedLock l(avMutex_);
+    if (tag == Tag::MEDIA_SEEK_TARGET && Any::IsSameTypeWith<int64_t>(value)) {
+        seekTargetPts_ = AnyCast<int64_t>(value);
+        if (seekTargetPts_ == HST_TIME_NONE) {
+            videoDecParams_.erase(tag);
+            return Status::OK;
+        }
+        MEDIA_LOG_I("skip frames before " PUBLIC_LOG_D64, seekTargetPts_);
+    }
     if (videoDecParams_.count(tag)) {
         videoDecParams_[tag] = value;
     } else {
@@ -348,8 +356,11 @@ Status VideoFfmpegDecoderPlugin::Prepare()
 Status VideoFfmpegDecoderPlugin::ResetLocked()
 {
     videoDecParams_.clear();
+    seekTargetPts_ = HST_TIME_NONE;
     avCodecContext_.reset();
     outBufferQ_.Clear();
+    // the next stream may differ in size or format, and the scaler writes into the planes freed below
+    scale_.reset();
     if (scaleData_[0] != nullptr) {
         if (isAllocScaleData_) {
             av_free(scaleData_[0]);
@@ -473,6 +484,9 @@ Status VideoFfmpegDecoderPlugin::SendBufferLocked(const std::shared_ptr<Buffer>&
         avPacket_->data = const_cast<uint8_t*>(ptr);
         avPacket_->size = static_cast<int32_t>(bufferLength);
         avPacket_->pts = static_cast<int64_t>(inputBuffer->pts);
+        // frames before the seek target are not output, those no other frame references need no decoding at all
+        avCodecContext_->skip_frame = (seekTargetPts_ != HST_TIME_NONE && avPacket_->pts < seekTargetPts_) ?
+            AVDISCARD_NONREF : AVDISCARD_DEFAULT;
     }
     auto ret = avcodec_send_packet(avCodecContext_.get(), avPacket_.get());
     av_packet_unref(avPacket_.get());
@@ -730,7 +744,17 @@ Status VideoFfmpegDecoderPlugin::ReceiveBufferLocked(const std::shared_ptr<Buffe
     }
     Status status;
     auto ret = avcodec_receive_frame(avCodecContext_.get(), cachedFrame_.get());
-    if (ret >= 0) {
+    if (ret >= 0 && seekTargetPts_ != HST_TIME_NONE && cachedFrame_->pts != AV_NOPTS_VALUE &&
+        cachedFrame_->pts < seekTargetPts_) {
+        // a reference frame on the way to the seek target, nobody renders it so it is neither scaled nor copied
+        MEDIA_LOG_DD("skip frame with pts " PUBLIC_LOG_D64 " before seek target", cachedFrame_->pts);
+        status = Status::ERROR_AGAIN;
+    } else if (ret >= 0) {
+        if (seekTargetPts_ != HST_TIME_NONE) {
+            // the target is reached, GetParameter no longer reports it as pending
+            seekTargetPts_ = HST_TIME_NONE;
+            videoDecParams_.erase(Tag::MEDIA_SEEK_TARGET);
+        }
         status = FillFrameBuffer(frameBuffer);
     } else if (ret == AVERROR_EOF) {
         MEDIA_LOG_I("eos received");
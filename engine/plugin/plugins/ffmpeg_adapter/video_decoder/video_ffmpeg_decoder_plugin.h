@@ -22,6 +22,7 @@
 #include <map>
 #include "foundation/osal/thread/task.h"
 #include "foundation/utils/blocking_queue.h"
+#include "plugin/common/plugin_time.h"
 #include "plugin/convert/ffmpeg_convert.h"
 #include "plugin/interface/codec_plugin.h"
 
@@ -134,6 +135,8 @@ private:
     int32_t scaleLineSize_[AV_NUM_DATA_POINTERS];
     bool isAllocScaleData_ {false};
     std::shared_ptr<Ffmpeg::Scale> scale_ {nullptr};
+    // frames before it are skipped rather than output, set for an accurate seek
+    int64_t seekTargetPts_ {HST_TIME_NONE};
 
     DataCallback* dataCb_ {};
     uint32_t width_;
@@ -474,6 +474,9 @@ Status VideoFfmpegEncoderPlugin::FillFrameBuffer(const std::shared_ptr<Buffer>&
             static_cast<uint64_t>(ConvertTimeFromFFmpeg(cachedPacket_->pts, avCodecContext_->time_base));
     packetBuffer->dts =
             static_cast<uint64_t>(ConvertTimeFromFFmpeg(cachedPacket_->dts, avCodecContext_->time_base));
+    if (cachedPacket_->dts != AV_NOPTS_VALUE) {
+        packetBuffer->flag |= BUFFER_FLAG_DTS_VALID;
+    }
 #ifdef DUMP_RAW_DATA
     if (dumpFd_) {
         std::fwrite(reinterpret_cast<const char *>(cachedPacket_->data), 1, cachedPacket_->size, dumpFd_);
@@ -39,10 +39,10 @@ constexpr uint32_t MAX_RANK                = 100;
 constexpr uint32_t MEDIA_IO_SIZE           = 4 * 1024;
 constexpr uint32_t MAX_FRAME_SIZE          = MEDIA_IO_SIZE;
 constexpr uint32_t AUDIO_DEMUXER_SOURCE_ONCE_LENGTH_MAX = 1024;
-uint32_t durationMs = 0;
-uint32_t fileSize = 0;
-AudioDemuxerMp3Attr mp3ProbeAttr;
-AudioDemuxerRst mp3ProbeRst;
+constexpr uint32_t MP3_HEADER_SIZE         = 4;
+constexpr size_t SCAN_CHUNK_SIZE           = 32 * 1024;
+constexpr size_t SCAN_CHUNK_MIN_AVAILABLE  = MAX_FRAME_SIZE + MP3_HEADER_SIZE;
+constexpr uint64_t MAX_SCAN_DISTANCE       = 2 * 1024 * 1024;
 std::vector<uint32_t> infoLayer         = {1, 2, 3};
 std::vector<uint32_t> infoSampleRate    = {8000, 11025, 12000, 16000, 22050, 24000, 32000, 44100, 48000};
 std::vector<uint32_t> infoBitrateKbps   = {8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176,
@@ -55,6 +55,7 @@ int AudioDemuxerMp3IterateCallbackForProbe(void *userData, const uint8_t *frame,
                                            size_t bufSize, uint64_t offset, Mp3DemuxerFrameInfo *info);
 Status AudioDemuxerMp3Probe(AudioDemuxerMp3Attr *mp3DemuxerAttr, uint8_t *inputBuffer, uint32_t inputLength,
                             AudioDemuxerRst *mp3DemuxerRst);
+bool ParseFrameAt(const uint8_t *data, size_t available, uint64_t remaining, bool confirm, Mp3FrameHeader& header);
 int Sniff(const std::string& pluginName, std::shared_ptr<DataSource> dataSource);
 Status RegisterPlugin(const std::shared_ptr<Register>& reg);
 }
@@ -71,8 +72,6 @@ Minimp3DemuxerPlugin::Minimp3DemuxerPlugin(std::string name)
 {
     FALSE_LOG(memset_s(&mp3DemuxerAttr_, sizeof(mp3DemuxerAttr_), 0x00, sizeof(AudioDemuxerMp3Attr)) == 0);
     FALSE_LOG(memset_s(&mp3DemuxerRst_, sizeof(mp3DemuxerRst_), 0x00, sizeof(AudioDemuxerRst)) == 0);
-    FALSE_LOG(memset_s(&mp3ProbeAttr, sizeof(mp3ProbeAttr), 0x00, sizeof(AudioDemuxerMp3Attr)) == 0);
-    FALSE_LOG(memset_s(&mp3ProbeRst, sizeof(mp3ProbeRst), 0x00, sizeof(AudioDemuxerRst)) == 0);
     FALSE_LOG(memset_s(&minimp3DemuxerImpl_, sizeof(minimp3DemuxerImpl_), 0x00, sizeof(Minimp3DemuxerOp)) == 0);
     MEDIA_LOG_I("Minimp3DemuxerPlugin, plugin name: " PUBLIC_LOG_S, pluginName_.c_str());
 }
@@ -89,7 +88,6 @@ Status Minimp3DemuxerPlugin::SetDataSource(const std::shared_ptr<DataSource>& so
         ioContext_.dataSource->GetSize(fileSize_);
     }
     mp3DemuxerAttr_.fileSize = fileSize_;
-    fileSize = fileSize_;
     seekable_ = source->GetSeekable();
     MEDIA_LOG_I("fileSize_ " PUBLIC_LOG_ZU, fileSize_);
     return Status::OK;
@@ -167,7 +165,7 @@ void Minimp3DemuxerPlugin::FillInMediaInfo(MediaInfo& mediaInfo) const
         mediaInfo.tracks[0].Set<Tag::AUDIO_CHANNEL_LAYOUT>(AudioChannelLayout::STEREO);
     }
     int64_t durationHst;
-    Ms2HstTime(durationMs, durationHst);
+    Ms2HstTime(durationMs_, durationHst);
     mediaInfo.tracks[0].Set<Tag::MEDIA_TYPE>(MediaType::AUDIO);
     mediaInfo.tracks[0].Set<Tag::AUDIO_SAMPLE_RATE>(mp3DemuxerRst_.frameSampleRate);
     mediaInfo.tracks[0].Set<Tag::MEDIA_BITRATE>(mp3DemuxerRst_.frameBitrateKbps);
@@ -202,6 +200,7 @@ Status Minimp3DemuxerPlugin::GetMediaInfo(MediaInfo& mediaInfo)
                 MEDIA_LOG_D("GetMediaInfo: OK usedInputLength " PUBLIC_LOG_U64, mp3DemuxerRst_.usedInputLength);
                 ioDataRemainSize_ -= mp3DemuxerRst_.usedInputLength;
                 currentDemuxerPos_ += mp3DemuxerRst_.usedInputLength;
+                InitSeekTable();
                 FillInMediaInfo(mediaInfo);
                 processLoop = 0;
                 break;
@@ -215,8 +214,8 @@ Status Minimp3DemuxerPlugin::GetMediaInfo(MediaInfo& mediaInfo)
     }
 
     mp3DemuxerAttr_.bitRate = mp3DemuxerRst_.frameBitrateKbps;
-    MEDIA_LOG_D("mp3DemuxerAttr_.bitRate " PUBLIC_LOG_U32 "kbps durationMs " PUBLIC_LOG_U32 " ms",
-                mp3DemuxerRst_.frameBitrateKbps, durationMs);
+    MEDIA_LOG_D("mp3DemuxerAttr_.bitRate " PUBLIC_LOG_U32 "kbps durationMs " PUBLIC_LOG_U64 " ms",
+                mp3DemuxerRst_.frameBitrateKbps, durationMs_);
     return Status::OK;
 }
 
@@ -227,7 +226,7 @@ uint64_t Minimp3DemuxerPlugin::GetCurrentPositionTimeS(void)
     return currentTime;
 }
 
-void Minimp3DemuxerPlugin::WriteMp3Data(Buffer& outBuffer)
+void Minimp3DemuxerPlugin::WriteMp3Data(Buffer& outBuffer, uint64_t inputOffset)
 {
     std::shared_ptr<Memory> mp3FrameData;
     if (outBuffer.IsEmpty()) {
@@ -237,8 +236,22 @@ void Minimp3DemuxerPlugin::WriteMp3Data(Buffer& outBuffer)
     }
     MEDIA_LOG_DD("ReadFrame: success usedInputLength " PUBLIC_LOG_D32 " ioDataRemainSize_ " PUBLIC_LOG_D32,
                  (uint32_t)mp3DemuxerRst_.usedInputLength, ioDataRemainSize_);
+    outBuffer.pts = SampleToTime(currentSample_, sampleRate_);
     if (mp3DemuxerRst_.frameLength) {
         mp3FrameData->Write(mp3DemuxerRst_.frameBuffer, mp3DemuxerRst_.frameLength);
+        Mp3FrameHeader header;
+        uint64_t frameOffset = inputOffset + mp3DemuxerRst_.frameOffset;
+        // the frame carrying the vbr header holds no audio
+        if (frameOffset >= seekTable_.GetDataOffset() && mp3DemuxerRst_.frameLength >= MP3_HEADER_SIZE &&
+            ParseMp3FrameHeader(mp3DemuxerRst_.frameBuffer, header)) {
+            if (frameNumberKnown_) {
+                seekTable_.AddFrame({frameNumber_, currentSample_, frameOffset}, mp3DemuxerRst_.frameLength,
+                                    header.samplesPerFrame);
+            }
+            outBuffer.duration = SampleToTime(currentSample_ + header.samplesPerFrame, sampleRate_) - outBuffer.pts;
+            frameNumber_++;
+            currentSample_ += header.samplesPerFrame;
+        }
         ioDataRemainSize_ -= mp3DemuxerRst_.usedInputLength;
         currentDemuxerPos_ += mp3DemuxerRst_.usedInputLength;
     } else if (mp3DemuxerRst_.usedInputLength == 0) {
@@ -253,7 +266,6 @@ void Minimp3DemuxerPlugin::WriteMp3Data(Buffer& outBuffer)
         ioDataRemainSize_ -= mp3DemuxerRst_.usedInputLength;
         currentDemuxerPos_ += mp3DemuxerRst_.usedInputLength;
     }
-    outBuffer.pts = GetCurrentPositionTimeS();
     MEDIA_LOG_DD("ReadFrame: mp3DemuxerRst_.frameLength " PUBLIC_LOG_U32 ", pts " PUBLIC_LOG_U64,
                  mp3DemuxerRst_.frameLength, outBuffer.pts);
     if (mp3DemuxerRst_.frameBuffer) {
@@ -266,13 +278,18 @@ Status Minimp3DemuxerPlugin::ReadFrame(Buffer& outBuffer, int32_t timeOutMs)
 {
     int  status  = -1;
     Status retResult = Status::OK;
-    NOK_RETURN(GetDataFromSource());
+    auto ret = GetDataFromSource();
+    if (ret == Status::END_OF_STREAM && frameNumberKnown_) {
+        seekTable_.SetComplete(frameNumber_);
+    }
+    NOK_RETURN(ret);
+    uint64_t inputOffset = static_cast<uint64_t>(ioContext_.offset) - ioDataRemainSize_;
     MEDIA_LOG_DD("ioDataRemainSize_ = " PUBLIC_LOG_D32, ioDataRemainSize_);
     status = AudioDemuxerMp3Process(inIoBuffer_, ioDataRemainSize_);
     MEDIA_LOG_DD("status = " PUBLIC_LOG_D32, status);
     switch (status) {
         case AUDIO_DEMUXER_SUCCESS:
-            WriteMp3Data(outBuffer);
+            WriteMp3Data(outBuffer, inputOffset);
             break;
         case AUDIO_DEMUXER_PROCESS_NEED_MORE_DATA:
             ioDataRemainSize_ -= mp3DemuxerRst_.usedInputLength;
@@ -295,20 +312,141 @@ Status Minimp3DemuxerPlugin::ReadFrame(Buffer& outBuffer, int32_t timeOutMs)
 
 Status Minimp3DemuxerPlugin::SeekTo(int32_t trackId, int64_t seekTime, SeekMode mode, int64_t& realSeekTime)
 {
-    uint64_t pos = 0;
-    uint32_t targetTimeMs = static_cast<uint32_t>(HstTime2Ms(seekTime));
-    if (AudioDemuxerMp3GetSeekPosition(targetTimeMs, &pos) == 0) {
-        ioContext_.offset = pos;
-        ioDataRemainSize_ = 0;
-        currentDemuxerPos_ = pos;
-        MEDIA_LOG_D("ioContext_.offset " PUBLIC_LOG_D32, static_cast<uint32_t>(ioContext_.offset));
-        (void)memset_s(inIoBuffer_, inIoBufferSize_, 0x00, inIoBufferSize_);
-    } else {
+    FALSE_RETURN_V_MSG_E(seekable_ == Seekable::SEEKABLE && sampleRate_ > 0, Status::ERROR_INVALID_OPERATION,
+                         "mp3 stream is not seekable");
+    uint64_t targetSample = TimeToSample(seekTime, sampleRate_);
+    FramePosition framePos;
+    bool exact = true;
+    if (!FindFrame(targetSample, framePos, exact)) {
         return Status::ERROR_INVALID_PARAMETER;
     }
+    // the target frame is located by its header, no need to discard frames to resync
+    ioContext_.offset = static_cast<int64_t>(framePos.offset);
+    ioContext_.eos = false;
+    ioDataRemainSize_ = 0;
+    currentDemuxerPos_ = framePos.offset;
+    (void)memset_s(inIoBuffer_, inIoBufferSize_, 0x00, inIoBufferSize_);
+    frameNumber_ = framePos.frameNumber;
+    currentSample_ = framePos.sampleIndex;
+    frameNumberKnown_ = exact;
+    realSeekTime = SampleToTime(framePos.sampleIndex, sampleRate_);
+    MEDIA_LOG_D("seek to offset " PUBLIC_LOG_U64 ", sample " PUBLIC_LOG_U64 ", exact " PUBLIC_LOG_D32,
+                framePos.offset, framePos.sampleIndex, exact);
     return Status::OK;
 }
 
+void Minimp3DemuxerPlugin::InitSeekTable()
+{
+    if (mp3DemuxerRst_.frameBitrateKbps != 0) {
+        durationMs_ = static_cast<uint64_t>(mp3DemuxerAttr_.fileSize) * 8 / mp3DemuxerRst_.frameBitrateKbps; // 8 bits
+    }
+    sampleRate_ = mp3DemuxerRst_.frameSampleRate;
+    frameNumber_ = 0;
+    currentSample_ = 0;
+    frameNumberKnown_ = true;
+    seekTable_.Reset(mp3DemuxerAttr_.id3v2Size, fileSize_);
+    FramePosition firstFrame;
+    if (seekable_ != Seekable::SEEKABLE || !ResyncFrame(mp3DemuxerAttr_.id3v2Size, firstFrame)) {
+        return;
+    }
+    seekTable_.Reset(firstFrame.offset, fileSize_);
+    auto buffer = std::make_shared<Buffer>();
+    auto bufData = buffer->AllocMemory(nullptr, MAX_FRAME_SIZE);
+    auto ret = ioContext_.dataSource->ReadAt(static_cast<int64_t>(firstFrame.offset), buffer, MAX_FRAME_SIZE);
+    if (ret == Status::OK && seekTable_.ParseVbrHeader(bufData->GetReadOnlyData(), bufData->GetSize(),
+                                                       firstFrame.offset)) {
+        // the frame count of the vbr header is exact, while the bitrate of the first frame is not
+        if (seekTable_.GetTotalSamples() > 0 && sampleRate_ > 0) {
+            durationMs_ = seekTable_.GetTotalSamples() * 1000 / sampleRate_; // 1000: ms
+        }
+    }
+}
+
+bool Minimp3DemuxerPlugin::FindFrame(uint64_t targetSample, FramePosition& framePos, bool& exact)
+{
+    exact = true;
+    auto end = seekTable_.GetEndPosition();
+    if (targetSample < end.sampleIndex || seekTable_.IsComplete()) {
+        return ScanFrames(seekTable_.Lookup(targetSample), targetSample, framePos);
+    }
+    // far beyond the indexed region, the toc gets close enough without reading all the frames in between
+    if (seekTable_.HasToc()) {
+        uint64_t estimatedOffset = seekTable_.EstimateOffset(targetSample);
+        if (estimatedOffset > end.offset + MAX_SCAN_DISTANCE && ResyncFrame(estimatedOffset, framePos)) {
+            framePos.frameNumber = 0;
+            framePos.sampleIndex = seekTable_.EstimateSample(framePos.offset);
+            exact = false;
+            return true;
+        }
+    }
+    return ScanFrames(end, targetSample, framePos);
+}
+
+bool Minimp3DemuxerPlugin::ScanFrames(const FramePosition& start, uint64_t targetSample,
+                                      FramePosition& framePos)
+{
+    auto buffer = std::make_shared<Buffer>();
+    auto bufData = buffer->AllocMemory(nullptr, SCAN_CHUNK_SIZE);
+    FramePosition cur = start;
+    uint64_t chunkOffset = 0;
+    size_t chunkSize = 0;
+    bool synced = true;
+    bool found = false;
+    while (cur.offset + MP3_HEADER_SIZE <= fileSize_) {
+        uint64_t remaining = fileSize_ - cur.offset;
+        if (cur.offset < chunkOffset ||
+            cur.offset + std::min<uint64_t>(SCAN_CHUNK_MIN_AVAILABLE, remaining) > chunkOffset + chunkSize) {
+            bufData->Reset();
+            auto ret = ioContext_.dataSource->ReadAt(static_cast<int64_t>(cur.offset), buffer, SCAN_CHUNK_SIZE);
+            chunkOffset = cur.offset;
+            chunkSize = bufData->GetSize();
+            if (ret != Status::OK || chunkSize < MP3_HEADER_SIZE) {
+                break;
+            }
+        }
+        Mp3FrameHeader header;
+        size_t available = static_cast<size_t>(chunkOffset + chunkSize - cur.offset);
+        if (!ParseFrameAt(bufData->GetReadOnlyData() + (cur.offset - chunkOffset), available, remaining, !synced,
+                          header)) {
+            synced = false;
+            cur.offset++; // lost sync, search for the next frame header
+            continue;
+        }
+        synced = true;
+        seekTable_.AddFrame(cur, header.frameLength, header.samplesPerFrame);
+        framePos = cur;
+        found = true;
+        if (cur.sampleIndex + header.samplesPerFrame > targetSample) {
+            return true;
+        }
+        cur.frameNumber++;
+        cur.sampleIndex += header.samplesPerFrame;
+        cur.offset += header.frameLength;
+    }
+    // reach the end of stream, seeking beyond the duration stops at the last frame
+    seekTable_.SetComplete(cur.frameNumber);
+    return found;
+}
+
+bool Minimp3DemuxerPlugin::ResyncFrame(uint64_t offset, FramePosition& framePos)
+{
+    FALSE_RETURN_V(ioContext_.dataSource != nullptr && offset < fileSize_, false);
+    auto buffer = std::make_shared<Buffer>();
+    auto bufData = buffer->AllocMemory(nullptr, SCAN_CHUNK_SIZE);
+    auto ret = ioContext_.dataSource->ReadAt(static_cast<int64_t>(offset), buffer, SCAN_CHUNK_SIZE);
+    FALSE_RETURN_V(ret == Status::OK, false);
+    const uint8_t *data = bufData->GetReadOnlyData();
+    size_t size = bufData->GetSize();
+    Mp3FrameHeader header;
+    for (size_t pos = 0; pos + MP3_HEADER_SIZE <= size; ++pos) {
+        if (ParseFrameAt(data + pos, size - pos, fileSize_ - offset - pos, true, header)) {
+            framePos.offset = offset + pos;
+            return true;
+        }
+    }
+    return false;
+}
+
 Status Minimp3DemuxerPlugin::Init()
 {
     minimp3DemuxerImpl_ = MiniMp3GetOpt();
@@ -338,6 +476,9 @@ Status Minimp3DemuxerPlugin::Prepare()
 
 Status Minimp3DemuxerPlugin::Reset()
 {
+    frameNumber_ = 0;
+    currentSample_ = 0;
+    frameNumberKnown_ = true;
     ioContext_.eos = false;
     ioContext_.dataSource.reset();
     ioContext_.offset = 0;
@@ -457,6 +598,7 @@ int Minimp3DemuxerPlugin::AudioDemuxerMp3IterateCallback(void *userData, const u
     rst->frameChannels    = info->channels;
     rst->frameSampleRate  = info->hz;
     rst->usedInputLength  = usedInputLength;
+    rst->frameOffset      = offset;
     return 1;
 }
 
@@ -532,22 +674,6 @@ int Minimp3DemuxerPlugin::AudioDemuxerMp3Seek(uint32_t pos, uint8_t *buf, uint32
     return 0;
 }
 
-int Minimp3DemuxerPlugin::AudioDemuxerMp3GetSeekPosition(uint32_t targetTimeMs, uint64_t *pos)
-{
-    if (!pos) {
-        MEDIA_LOG_I("pos nullptr error");
-        return AUDIO_DEMUXER_ERROR;
-    }
-    uint32_t targetPos = targetTimeMs * mp3DemuxerAttr_.bitRate / 8 + mp3DemuxerAttr_.id3v2Size;
-    if (targetPos > mp3DemuxerAttr_.fileSize) {
-        *pos = 0;
-        return -1;
-    }
-    *pos = static_cast<uint64_t>(targetPos);
-    mp3DemuxerAttr_.mp3SeekFlag = 1;
-    return 0;
-}
-
 namespace {
 size_t AudioDecmuxerMp3Id3v2SizeCalculate(const uint8_t *buf)
 {
@@ -661,15 +787,26 @@ Status AudioDemuxerMp3Probe(AudioDemuxerMp3Attr* mp3DemuxerAttr, uint8_t* inputB
         }
         return Status::ERROR_UNSUPPORTED_FORMAT;
     }
-    if (mp3DemuxerRst->frameBitrateKbps != 0) {
-        durationMs = static_cast<uint64_t>(fileSize * 8 / mp3DemuxerRst->frameBitrateKbps); // 8
-    }
     MEDIA_LOG_I("bitrate_kbps = " PUBLIC_LOG_U32 " info->channels = " PUBLIC_LOG_U8 " info->hz = "
                 PUBLIC_LOG_U32, mp3DemuxerRst->frameBitrateKbps, mp3DemuxerRst->frameChannels,
                 mp3DemuxerRst->frameSampleRate);
     return Status::OK;
 }
 
+bool ParseFrameAt(const uint8_t *data, size_t available, uint64_t remaining, bool confirm, Mp3FrameHeader& header)
+{
+    if (!ParseMp3FrameHeader(data, header) || header.frameLength > remaining) {
+        return false;
+    }
+    if (!confirm || header.frameLength + MP3_HEADER_SIZE > remaining) {
+        return true;
+    }
+    // a frame found after a lost sync is confirmed by the header of the next one
+    Mp3FrameHeader next;
+    return header.frameLength + MP3_HEADER_SIZE <= available && ParseMp3FrameHeader(data + header.frameLength, next) &&
+        next.sampleRate == header.sampleRate && next.layer == header.layer;
+}
+
 int Sniff(const std::string& name, std::shared_ptr<DataSource> dataSource)
 {
     MEDIA_LOG_I("Sniff in");
@@ -682,6 +819,9 @@ int Sniff(const std::string& name, std::shared_ptr<DataSource> dataSource)
     int readSize = PROBE_READ_LENGTH;
     uint64_t sourceSize = 0;
     dataSource->GetSize(sourceSize);
+    // probe state lives on the stack, sniffers of several sources may run at the same time
+    AudioDemuxerMp3Attr probeAttr {};
+    AudioDemuxerRst probeRst {};
     while (processLoop) {
         if (sourceSize < PROBE_READ_LENGTH && sourceSize != 0) {
             readSize = sourceSize;
@@ -693,11 +833,11 @@ int Sniff(const std::string& name, std::shared_ptr<DataSource> dataSource)
         }
         inputDataPtr = const_cast<uint8_t *>(bufData->GetReadOnlyData());
 
-        status = AudioDemuxerMp3Probe(&mp3ProbeAttr, inputDataPtr, bufData->GetSize(), &mp3ProbeRst);
+        status = AudioDemuxerMp3Probe(&probeAttr, inputDataPtr, bufData->GetSize(), &probeRst);
         switch (status) {
             case Status::ERROR_NOT_ENOUGH_DATA:
                 OSAL::SleepFor(100); // 100
-                offset += mp3ProbeRst.usedInputLength;
+                offset += probeRst.usedInputLength;
                 MEDIA_LOG_D("offset " PUBLIC_LOG_D32, offset);
                 processLoop = 1;
                 break;
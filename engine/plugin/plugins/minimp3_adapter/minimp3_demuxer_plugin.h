@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include "minimp3_wrapper.h"
+#include "mp3_seek_table.h"
 #include "plugin/interface/demuxer_plugin.h"
 
 using Mp3DemuxerHandle     = Minimp3WrapperMp3dec;
@@ -51,6 +52,7 @@ struct AudioDemuxerRst {
     uint8_t  frameChannels;
     uint8_t  audioLayer;
     uint32_t samplesPerFrame;
+    uint64_t frameOffset;
 };
 
 struct AudioDemuxerMp3Attr {
@@ -125,13 +127,18 @@ private:
     int AudioDemuxerMp3Process(uint8_t *buf, uint32_t len);
     int AudioDemuxerMp3FreeFrame(uint8_t *frame);
     int AudioDemuxerMp3Seek(uint32_t pos, uint8_t *buf, uint32_t len, AudioDemuxerRst *rst);
-    int AudioDemuxerMp3GetSeekPosition(uint32_t targetTimeMs, uint64_t *pos);
 
     Status DoReadFromSource(uint32_t readSize);
 
     void FillInMediaInfo(MediaInfo& mediaInfo) const;
 
-    void WriteMp3Data(Buffer& outBuffer);
+    void WriteMp3Data(Buffer& outBuffer, uint64_t inputOffset);
+
+    void InitSeekTable();
+    bool FindFrame(uint64_t targetSample, FramePosition& framePos, bool& exact);
+    bool ScanFrames(const FramePosition& start, uint64_t targetSample, FramePosition& framePos);
+    bool ResyncFrame(uint64_t offset, FramePosition& framePos);
+
     Seekable            seekable_;
     int                 inIoBufferSize_;
     size_t              fileSize_;
@@ -143,6 +150,11 @@ private:
     AudioDemuxerRst     mp3DemuxerRst_ {};
     Minimp3DemuxerOp    minimp3DemuxerImpl_ {};
     AudioDemuxerMp3Attr mp3DemuxerAttr_ {};
+    Mp3SeekTable        seekTable_ {};
+    uint32_t            sampleRate_ {0};
+    uint64_t            frameNumber_ {0};
+    uint64_t            currentSample_ {0};
+    bool                frameNumberKnown_ {true};
 };
 } // namespace Minimp3
 } // namespace Plugin
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "Mp3SeekTable"
+
+#include "mp3_seek_table.h"
+#include <algorithm>
+#include <cstring>
+#include "foundation/log.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace Minimp3 {
+namespace {
+constexpr size_t MP3_HEADER_SIZE = 4;
+constexpr uint32_t XING_FRAMES_FLAG = 0x01;
+constexpr uint32_t XING_BYTES_FLAG = 0x02;
+constexpr uint32_t XING_TOC_FLAG = 0x04;
+constexpr size_t XING_TOC_SIZE = 100;
+constexpr uint32_t XING_TOC_SCALE = 256;
+constexpr size_t VBRI_TAG_OFFSET = MP3_HEADER_SIZE + 32; // 32: always follows 32 bytes of side info
+constexpr size_t VBRI_TOC_OFFSET = 26;
+constexpr uint32_t VBRI_MAX_ENTRY_SIZE = 4;
+constexpr uint32_t SAMPLES_PER_FRAME_LAYER1 = 384;
+constexpr uint32_t SAMPLES_PER_FRAME_LAYER2 = 1152;
+constexpr uint32_t SAMPLES_PER_FRAME_LAYER3_LSF = 576;
+constexpr uint32_t SAMPLE_RATES[] = {44100, 48000, 32000};
+constexpr uint32_t BITRATES_KBPS[5][15] = {
+    {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448}, // mpeg1 layer1
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},    // mpeg1 layer2
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},     // mpeg1 layer3
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},    // mpeg2/2.5 layer1
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},         // mpeg2/2.5 layer2 and layer3
+};
+
+uint32_t ReadBigEndian(const uint8_t* data, size_t len)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < len; ++i) {
+        value = (value << 8) | data[i]; // 8: bits per byte
+    }
+    return value;
+}
+
+size_t GetSideInfoSize(const Mp3FrameHeader& header)
+{
+    if (header.isMpeg1) {
+        return header.channels == 1 ? 17 : 32; // 17, 32: side info size of mpeg1
+    }
+    return header.channels == 1 ? 9 : 17; // 9, 17: side info size of mpeg2/2.5
+}
+
+uint64_t Interpolate(uint64_t x, uint64_t x0, uint64_t x1, uint64_t y0, uint64_t y1)
+{
+    if (x1 <= x0 || y1 <= y0) {
+        return y0;
+    }
+    return y0 + static_cast<uint64_t>(static_cast<double>(y1 - y0) * (x - x0) / (x1 - x0));
+}
+}
+
+bool ParseMp3FrameHeader(const uint8_t* data, Mp3FrameHeader& header)
+{
+    if (data[0] != 0xff || (data[1] & 0xe0) != 0xe0) { // 11 bits frame sync
+        return false;
+    }
+    uint8_t version = (data[1] >> 3) & 0x03; // 3: version bits, 0: mpeg2.5, 1: reserved, 2: mpeg2, 3: mpeg1
+    uint8_t layerBits = (data[1] >> 1) & 0x03; // 1: layer bits, 1: layer3, 2: layer2, 3: layer1
+    uint8_t bitrateIndex = data[2] >> 4; // 4: bitrate index bits
+    uint8_t sampleRateIndex = (data[2] >> 2) & 0x03; // 2: sample rate index bits
+    if (version == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 0x0f || sampleRateIndex == 0x03) {
+        return false;
+    }
+    header.isMpeg1 = version == 0x03;
+    header.layer = 4 - layerBits; // 4: layer bits are stored inverted
+    header.channels = (data[3] >> 6) == 0x03 ? 1 : 2; // 6: channel mode bits, 3: single channel
+    header.sampleRate = SAMPLE_RATES[sampleRateIndex] >> (header.isMpeg1 ? 0 : (version == 0 ? 2 : 1));
+    size_t table = header.isMpeg1 ? header.layer - 1 : (header.layer == 1 ? 3 : 4); // 3, 4: mpeg2 tables
+    header.bitrateKbps = BITRATES_KBPS[table][bitrateIndex];
+    uint32_t padding = (data[2] >> 1) & 0x01;
+    uint64_t bitsPerSecond = static_cast<uint64_t>(header.bitrateKbps) * 1000; // 1000: kbps
+    if (header.layer == 1) {
+        header.samplesPerFrame = SAMPLES_PER_FRAME_LAYER1;
+        header.frameLength = static_cast<uint32_t>((12 * bitsPerSecond / header.sampleRate + padding) * 4); // 12, 4
+    } else {
+        header.samplesPerFrame = (header.layer == 3 && !header.isMpeg1) ? // 3: layer3
+            SAMPLES_PER_FRAME_LAYER3_LSF : SAMPLES_PER_FRAME_LAYER2;
+        // bytes per frame = samples per frame / 8 * bitrate / sample rate
+        header.frameLength = static_cast<uint32_t>(header.samplesPerFrame / 8 * bitsPerSecond / header.sampleRate +
+            padding); // 8: bits per byte
+    }
+    return true;
+}
+
+Mp3SeekTable::Mp3SeekTable(uint32_t framesPerEntry) : frameIndex_(framesPerEntry)
+{
+}
+
+void Mp3SeekTable::Reset(uint64_t firstFrameOffset, uint64_t streamSize)
+{
+    streamSize_ = streamSize;
+    totalSamples_ = 0;
+    toc_.clear();
+    frameIndex_.Reset(firstFrameOffset);
+}
+
+bool Mp3SeekTable::ParseVbrHeader(const uint8_t* frame, size_t size, uint64_t offset)
+{
+    Mp3FrameHeader header;
+    if (size < MP3_HEADER_SIZE || !ParseMp3FrameHeader(frame, header) || header.layer != 3) { // 3: only layer3
+        return false;
+    }
+    size = std::min(size, static_cast<size_t>(header.frameLength));
+    if (!ParseXing(frame, size, offset, header) && !ParseVbri(frame, size, offset, header)) {
+        return false;
+    }
+    frameIndex_.Reset(offset + header.frameLength);
+    MEDIA_LOG_I("vbr header found, total samples " PUBLIC_LOG_U64 ", toc points " PUBLIC_LOG_ZU,
+                totalSamples_, toc_.size());
+    return true;
+}
+
+bool Mp3SeekTable::ParseXing(const uint8_t* frame, size_t size, uint64_t offset, const Mp3FrameHeader& header)
+{
+    size_t tagOffset = MP3_HEADER_SIZE + GetSideInfoSize(header);
+    if (size < tagOffset + 8) { // 8: tag and flags
+        return false;
+    }
+    const uint8_t* ptr = frame + tagOffset;
+    if (memcmp(ptr, "Xing", 4) != 0 && memcmp(ptr, "Info", 4) != 0) { // 4: tag size
+        return false;
+    }
+    uint32_t flags = ReadBigEndian(ptr + 4, 4); // 4: tag size, 4: flags size
+    ptr += 8; // 8: tag and flags
+    const uint8_t* frameEnd = frame + size;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    if ((flags & XING_FRAMES_FLAG) && ptr + 4 <= frameEnd) { // 4: frames field size
+        frames = ReadBigEndian(ptr, 4); // 4: frames field size
+        ptr += 4; // 4: frames field size
+    }
+    if ((flags & XING_BYTES_FLAG) && ptr + 4 <= frameEnd) { // 4: bytes field size
+        bytes = ReadBigEndian(ptr, 4); // 4: bytes field size
+        ptr += 4; // 4: bytes field size
+    }
+    totalSamples_ = frames * header.samplesPerFrame;
+    // the byte count covers the stream from the start of this frame
+    if (bytes == 0 || offset + bytes > streamSize_) {
+        bytes = streamSize_ > offset ? streamSize_ - offset : 0;
+    }
+    if ((flags & XING_TOC_FLAG) && ptr + XING_TOC_SIZE <= frameEnd && totalSamples_ > 0 && bytes > 0) {
+        uint64_t dataOffset = offset + header.frameLength;
+        for (size_t i = 0; i < XING_TOC_SIZE; ++i) {
+            uint64_t pointOffset = std::max(dataOffset, offset + bytes * ptr[i] / XING_TOC_SCALE);
+            if (!toc_.empty()) {
+                pointOffset = std::max(pointOffset, toc_.back().offset);
+            }
+            toc_.push_back({totalSamples_ * i / XING_TOC_SIZE, pointOffset});
+        }
+        toc_.push_back({totalSamples_, offset + bytes});
+    }
+    return true;
+}
+
+bool Mp3SeekTable::ParseVbri(const uint8_t* frame, size_t size, uint64_t offset, const Mp3FrameHeader& header)
+{
+    if (size < VBRI_TAG_OFFSET + VBRI_TOC_OFFSET || memcmp(frame + VBRI_TAG_OFFSET, "VBRI", 4) != 0) { // 4: tag size
+        return false;
+    }
+    const uint8_t* ptr = frame + VBRI_TAG_OFFSET;
+    uint64_t frames = ReadBigEndian(ptr + 14, 4); // 14: frames field offset, 4: field size
+    uint32_t entryCount = ReadBigEndian(ptr + 18, 2); // 18: toc entries field offset, 2: field size
+    uint32_t scale = ReadBigEndian(ptr + 20, 2); // 20: scale field offset, 2: field size
+    uint32_t entrySize = ReadBigEndian(ptr + 22, 2); // 22: entry size field offset, 2: field size
+    uint32_t framesPerEntry = ReadBigEndian(ptr + 24, 2); // 24: frames per entry field offset, 2: field size
+    totalSamples_ = frames * header.samplesPerFrame;
+    if (entrySize == 0 || entrySize > VBRI_MAX_ENTRY_SIZE || framesPerEntry == 0 || totalSamples_ == 0 ||
+        size < VBRI_TAG_OFFSET + VBRI_TOC_OFFSET + static_cast<size_t>(entryCount) * entrySize) {
+        return true;
+    }
+    uint64_t pointOffset = offset + header.frameLength;
+    uint64_t sampleIndex = 0;
+    toc_.push_back({sampleIndex, pointOffset});
+    ptr += VBRI_TOC_OFFSET;
+    for (uint32_t i = 0; i < entryCount && sampleIndex < totalSamples_; ++i) {
+        pointOffset = std::min(pointOffset + static_cast<uint64_t>(ReadBigEndian(ptr, entrySize)) * scale,
+                               streamSize_);
+        sampleIndex = std::min(sampleIndex + static_cast<uint64_t>(framesPerEntry) * header.samplesPerFrame,
+                               totalSamples_);
+        toc_.push_back({sampleIndex, pointOffset});
+        ptr += entrySize;
+    }
+    return true;
+}
+
+bool Mp3SeekTable::HasToc() const
+{
+    return toc_.size() > 1;
+}
+
+uint64_t Mp3SeekTable::GetTotalSamples() const
+{
+    return totalSamples_;
+}
+
+uint64_t Mp3SeekTable::GetDataOffset() const
+{
+    return frameIndex_.GetStartPosition().offset;
+}
+
+uint64_t Mp3SeekTable::EstimateOffset(uint64_t targetSample) const
+{
+    if (!HasToc()) {
+        return GetDataOffset();
+    }
+    auto ite = std::upper_bound(toc_.begin(), toc_.end(), targetSample,
+        [](uint64_t sample, const TocPoint& point) { return sample < point.sampleIndex; });
+    if (ite == toc_.end()) {
+        return toc_.back().offset;
+    }
+    auto prev = ite == toc_.begin() ? ite : ite - 1;
+    return Interpolate(targetSample, prev->sampleIndex, ite->sampleIndex, prev->offset, ite->offset);
+}
+
+uint64_t Mp3SeekTable::EstimateSample(uint64_t offset) const
+{
+    if (!HasToc()) {
+        return 0;
+    }
+    auto ite = std::upper_bound(toc_.begin(), toc_.end(), offset,
+        [](uint64_t pos, const TocPoint& point) { return pos < point.offset; });
+    if (ite == toc_.end()) {
+        return toc_.back().sampleIndex;
+    }
+    auto prev = ite == toc_.begin() ? ite : ite - 1;
+    return Interpolate(offset, prev->offset, ite->offset, prev->sampleIndex, ite->sampleIndex);
+}
+
+void Mp3SeekTable::AddFrame(const FramePosition& pos, uint32_t frameLength, uint32_t samples)
+{
+    frameIndex_.AddFrame(pos, frameLength, samples);
+}
+
+void Mp3SeekTable::SetComplete(uint64_t totalFrames)
+{
+    frameIndex_.SetComplete(totalFrames);
+}
+
+bool Mp3SeekTable::IsComplete() const
+{
+    return frameIndex_.IsComplete();
+}
+
+FramePosition Mp3SeekTable::GetEndPosition() const
+{
+    return frameIndex_.GetEndPosition();
+}
+
+FramePosition Mp3SeekTable::Lookup(uint64_t targetSample) const
+{
+    return frameIndex_.Lookup(targetSample);
+}
+
+size_t Mp3SeekTable::GetEntryCount() const
+{
+    return frameIndex_.GetEntryCount();
+}
+} // namespace Minimp3
+} // namespace Plugin
+} // namespace Media
+} // namespace OHOS
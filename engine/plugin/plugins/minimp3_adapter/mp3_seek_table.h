@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MP3_SEEK_TABLE_H
+#define MP3_SEEK_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "plugin/plugins/common/frame_index.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace Minimp3 {
+struct Mp3FrameHeader {
+    bool isMpeg1 {false};
+    uint8_t layer {0};
+    uint8_t channels {0};
+    uint32_t sampleRate {0};
+    uint32_t bitrateKbps {0};
+    uint32_t frameLength {0};
+    uint32_t samplesPerFrame {0};
+};
+
+/// parse the 4 bytes mpeg audio frame header at data, free format frames are not supported
+bool ParseMp3FrameHeader(const uint8_t* data, Mp3FrameHeader& header);
+
+/**
+ * Seek table of an mp3 stream.
+ *
+ * The toc of a Xing/Info or VBRI header maps any sample to an approximate byte offset without reading the stream.
+ * The sparse frame index keeps the exact position of every N-th frame from the first audio frame on.
+ */
+class Mp3SeekTable {
+public:
+    explicit Mp3SeekTable(uint32_t framesPerEntry = DEFAULT_FRAMES_PER_ENTRY);
+    ~Mp3SeekTable() = default;
+
+    /// drop all the entries, the stream of streamSize bytes has its first frame at firstFrameOffset
+    void Reset(uint64_t firstFrameOffset, uint64_t streamSize);
+
+    /**
+     * Parse the Xing/Info or VBRI header carried by the first frame. The frame holds no audio, so the index starts
+     * from the frame following it once the header is recognized.
+     */
+    bool ParseVbrHeader(const uint8_t* frame, size_t size, uint64_t offset);
+
+    bool HasToc() const;
+    /// samples of the whole stream recorded by the vbr header, 0 if unknown
+    uint64_t GetTotalSamples() const;
+    /// offset of the first audio frame
+    uint64_t GetDataOffset() const;
+
+    /// approximate offset of the frame containing targetSample according to the toc
+    uint64_t EstimateOffset(uint64_t targetSample) const;
+    /// approximate sample index of the frame at offset according to the toc
+    uint64_t EstimateSample(uint64_t offset) const;
+
+    /// record the frame at pos, which is ignored if it does not directly follow the indexed region
+    void AddFrame(const FramePosition& pos, uint32_t frameLength, uint32_t samples);
+    /// mark the end of stream if all the totalFrames frames have been indexed
+    void SetComplete(uint64_t totalFrames);
+    bool IsComplete() const;
+    /// position of the frame following the last indexed one
+    FramePosition GetEndPosition() const;
+    /// the last indexed entry whose sample index is not greater than targetSample, O(log n)
+    FramePosition Lookup(uint64_t targetSample) const;
+    size_t GetEntryCount() const;
+
+    static constexpr uint32_t DEFAULT_FRAMES_PER_ENTRY = FrameIndex::DEFAULT_FRAMES_PER_ENTRY;
+
+private:
+    struct TocPoint {
+        uint64_t sampleIndex;
+        uint64_t offset;
+    };
+
+    bool ParseXing(const uint8_t* frame, size_t size, uint64_t offset, const Mp3FrameHeader& header);
+    bool ParseVbri(const uint8_t* frame, size_t size, uint64_t offset, const Mp3FrameHeader& header);
+
+    uint64_t streamSize_ {0};
+    uint64_t totalSamples_ {0};
+    std::vector<TocPoint> toc_ {};
+    FrameIndex frameIndex_;
+};
+} // namespace Minimp3
+} // namespace Plugin
+} // namespace Media
+} // namespace OHOS
+
+#endif // MP3_SEEK_TABLE_H
@@ -16,6 +16,8 @@
 
 #include "downloader.h"
 
+#include <strings.h>
+#include "http_cache.h"
 #include "http_curl_client.h"
 #include "foundation/utils/steady_clock.h"
 #include "securec.h"
@@ -114,6 +116,12 @@ double DownloadRequest::GetDuration()
     return duration_;
 }
 
+void DownloadRequest::EnableCache(bool immutable)
+{
+    cacheEnabled_ = true;
+    cacheImmutable_ = immutable;
+}
+
 Downloader::Downloader(std::string name) noexcept : name_(std::move(name))
 {
     shouldStartNextRequest = true;
@@ -161,6 +169,7 @@ void Downloader::Pause()
         MEDIA_LOG_I("pause Begin");
         requestQue_->SetActive(false, false);
     }
+    pausedByThrottle_ = false;
     task_->Pause();
     MEDIA_LOG_I("pause End");
 }
@@ -173,6 +182,7 @@ void Downloader::Cancle()
         client_->Close();
         shouldStartNextRequest = true;
     }
+    pausedByThrottle_ = false;
     task_->Pause();
 }
 
@@ -191,10 +201,23 @@ void Downloader::Resume()
     MEDIA_LOG_I("resume End");
 }
 
+// under operatorMutex_, as the check and pause of HttpDownloadLoop, or a release between them is lost
+void Downloader::SetThrottled(bool throttled)
+{
+    OSAL::ScopedLock lock(operatorMutex_);
+    throttled_ = throttled;
+    // only restart a task paused by the throttle, not one paused at the end of the requests or by the user
+    if (!throttled && pausedByThrottle_.exchange(false)) {
+        MEDIA_LOG_D("throttle released");
+        task_->Start();
+    }
+}
+
 void Downloader::Stop(bool isAsync)
 {
     MEDIA_LOG_I("Stop Begin");
     requestQue_->SetActive(false);
+    pausedByThrottle_ = false;
     if (currentRequest_ != nullptr) {
         currentRequest_->Close();
         client_->Close(); 
@@ -265,6 +288,16 @@ bool Downloader::BeginDownload()
     currentRequest_->isEos_ = false;
     currentRequest_->retryTimes_ = 0;
 
+    size_t fileLength = 0;
+    if (currentRequest_->cacheEnabled_ && currentRequest_->cacheImmutable_ &&
+        HttpCache::GetInstance().GetFileLength(url, fileLength) && fileLength > 0) {
+        HeaderInfo header {};
+        header.fileContentLen = fileLength;
+        header.contentLen = static_cast<long>(fileLength);
+        currentRequest_->SaveHeader(&header);
+        currentRequest_->cacheValidated_ = true;
+    }
+
     MEDIA_LOG_I("End");
     return true;
 }
@@ -272,6 +305,11 @@ bool Downloader::BeginDownload()
 void Downloader::HttpDownloadLoop()
 {
     OSAL::ScopedLock lock(operatorMutex_);
+    if (throttled_) {
+        pausedByThrottle_ = true;
+        task_->PauseAsync();
+        return;
+    }
     if (shouldStartNextRequest) {
         std::shared_ptr<DownloadRequest> tempRequest = requestQue_->Pop(1000); //1000ms超时限制
         if (!tempRequest) {
@@ -283,10 +321,13 @@ void Downloader::HttpDownloadLoop()
         shouldStartNextRequest = false;
     }
     FALSE_RETURN_W(currentRequest_ != nullptr);
+    if (ReadFromCache()) {
+        return;
+    }
     NetworkClientErrorCode clientCode = NetworkClientErrorCode::ERROR_OK;
     NetworkServerErrorCode serverCode = 0;
     long startPos = currentRequest_->startPos_;
-    if (currentRequest_->requestWholeFile_) {
+    if (currentRequest_->requestWholeFile_ && startPos == 0) { // the rest of a partly cached file is a range
         startPos = -1;
     }
     Status ret = client_->RequestData(startPos, currentRequest_->requestSize_,
@@ -336,6 +377,69 @@ void Downloader::HandleRetOK() {
     }
 }
 
+// serve the block holding startPos_ from the cache, false if it has to be downloaded
+bool Downloader::ReadFromCache()
+{
+    auto& request = currentRequest_;
+    if (!request->cacheEnabled_ || !request->cacheValidated_ || request->IsClosed() ||
+        request->startPos_ >= static_cast<int64_t>(request->headerInfo_.fileContentLen)) {
+        return false;
+    }
+    size_t blockOffset = 0;
+    auto block = HttpCache::GetInstance().GetBlock(request->url_, request->startPos_, blockOffset);
+    if (block == nullptr) {
+        return false;
+    }
+    auto len = static_cast<uint32_t>(block->size() - blockOffset);
+    if (!request->saveData_(block->data() + blockOffset, len)) {
+        MEDIA_LOG_W("Save cached data failed.");
+        OSAL::SleepFor(SLEEP_TIME);
+        return true;
+    }
+    MEDIA_LOG_D("Read " PUBLIC_LOG_U32 " bytes from cache at " PUBLIC_LOG_D64, len, request->startPos_);
+    request->startPos_ += len;
+    HandleRetOK();
+    return true;
+}
+
+// Collect downloaded data into blocks aligned to HttpCache::BLOCK_SIZE, data before the first block boundary of a
+// download started in the middle of a block is not cached.
+void Downloader::SaveToCache(const uint8_t* data, size_t len)
+{
+    auto& request = currentRequest_;
+    auto pos = static_cast<size_t>(request->startPos_);
+    size_t fileLength = request->headerInfo_.fileContentLen;
+    if (request->cacheBlockPos_ < 0 || request->cacheBlockPos_ + request->cacheBlock_.size() != pos) {
+        request->cacheBlock_.clear();
+        request->cacheBlockPos_ = -1;
+    }
+    while (len > 0) {
+        if (request->cacheBlockPos_ < 0) {
+            size_t skip = (HttpCache::BLOCK_SIZE - pos % HttpCache::BLOCK_SIZE) % HttpCache::BLOCK_SIZE;
+            if (skip >= len) {
+                return;
+            }
+            data += skip;
+            len -= skip;
+            pos += skip;
+            request->cacheBlockPos_ = static_cast<int64_t>(pos);
+            request->cacheBlock_.reserve(HttpCache::BLOCK_SIZE);
+        }
+        size_t copyLen = std::min(len, HttpCache::BLOCK_SIZE - request->cacheBlock_.size());
+        request->cacheBlock_.insert(request->cacheBlock_.end(), data, data + copyLen);
+        data += copyLen;
+        len -= copyLen;
+        pos += copyLen;
+        if (request->cacheBlock_.size() == HttpCache::BLOCK_SIZE || pos == fileLength) {
+            HttpCache::GetInstance().PutBlock(request->url_, request->cacheBlockPos_,
+                                              std::move(request->cacheBlock_));
+            request->cacheBlock_ = {};
+            request->cacheBlock_.reserve(HttpCache::BLOCK_SIZE);
+            request->cacheBlockPos_ = static_cast<int64_t>(pos);
+        }
+    }
+}
+
 size_t Downloader::RxBodyData(void* buffer, size_t size, size_t nitems, void* userParam)
 {
     auto mediaDownloader = static_cast<Downloader *>(userParam);
@@ -348,6 +452,9 @@ size_t Downloader::RxBodyData(void* buffer, size_t size, size_t nitems, void* us
         if (header->contentLen > 0) {
             MEDIA_LOG_W("Unsupported range, use content length as content file length");
             header->fileContentLen = header->contentLen;
+            if (mediaDownloader->currentRequest_->startPos_ > 0) { // the body does not start at startPos_
+                mediaDownloader->currentRequest_->cacheEnabled_ = false;
+            }
         } else {
             MEDIA_LOG_E("fileContentLen and contentLen are both zero.");
             return 0;
@@ -356,10 +463,18 @@ size_t Downloader::RxBodyData(void* buffer, size_t size, size_t nitems, void* us
     if (!mediaDownloader->currentRequest_->isDownloading_) {
         mediaDownloader->currentRequest_->isDownloading_ = true;
     }
+    auto& request = mediaDownloader->currentRequest_;
+    if (request->cacheEnabled_ && !request->cacheValidated_ && !header->isChunked) {
+        HttpCache::GetInstance().Validate(request->url_, header->fileContentLen, header->eTag);
+        request->cacheValidated_ = true;
+    }
     if (!mediaDownloader->currentRequest_->saveData_(static_cast<uint8_t *>(buffer), dataLen)) {
         MEDIA_LOG_W("Save data failed.");
         return 0; // save data failed, make perform finished.
     }
+    if (request->cacheEnabled_ && request->cacheValidated_) {
+        mediaDownloader->SaveToCache(static_cast<uint8_t *>(buffer), dataLen);
+    }
     mediaDownloader->currentRequest_->isDownloading_ = false;
     MEDIA_LOG_I("RxBodyData: dataLen " PUBLIC_LOG_ZU ", startPos_ " PUBLIC_LOG_D64, dataLen,
                 mediaDownloader->currentRequest_->startPos_);
@@ -419,6 +534,13 @@ size_t Downloader::RxHeaderData(void* buffer, size_t size, size_t nitems, void*
         }
     }
 
+    if (!strncasecmp(key, "ETag", strlen("ETag")) && next != nullptr) {
+        char* eTag = StringTrim(next);
+        size_t len = std::min(strlen(eTag), sizeof(info->eTag) - 1);
+        (void)memcpy_s(info->eTag, sizeof(info->eTag), eTag, len);
+        info->eTag[len] = '\0';
+    }
+
     if (!strncmp(key, "Content-Range", strlen("Content-Range")) ||
         !strncmp(key, "content-range", strlen("content-range"))) {
         char* token = strtok_s(nullptr, ":", &next);
@@ -16,9 +16,11 @@
 #ifndef HISTREAMER_DOWNLOADER_H
 #define HISTREAMER_DOWNLOADER_H
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 #include "foundation/osal/thread/task.h"
 #include "foundation/osal/thread/mutex.h"
 #include "foundation/utils/blocking_queue.h"
@@ -35,6 +37,7 @@ enum struct DownloadStatus {
 
 struct HeaderInfo {
     char contentType[32]; // 32 chars
+    char eTag[64]; // 64 chars
     size_t fileContentLen {0};
     long contentLen {0};
     bool isChunked {false};
@@ -43,6 +46,7 @@ struct HeaderInfo {
     void Update(const HeaderInfo* info)
     {
         (void)memcpy_s(contentType, sizeof(contentType), info->contentType, sizeof(contentType));
+        (void)memcpy_s(eTag, sizeof(eTag), info->eTag, sizeof(eTag));
         fileContentLen = info->fileContentLen;
         contentLen = info->contentLen;
         isChunked = info->isChunked;
@@ -89,6 +93,9 @@ public:
     bool IsClosed() const;
     void Close();
     double GetDuration();
+    // serve the body from HttpCache when possible, immutable: the url always names the same content (hls fragments),
+    // so cached data may be used before the server has confirmed its length and ETag
+    void EnableCache(bool immutable = false);
 
 private:
     void WaitHeaderUpdated() const;
@@ -110,6 +117,12 @@ private:
     NetworkClientErrorCode clientError_ {NetworkClientErrorCode::ERROR_OK};
     NetworkServerErrorCode serverError_ {0};
 
+    bool cacheEnabled_ {false};
+    bool cacheImmutable_ {false};
+    bool cacheValidated_ {false};
+    std::vector<uint8_t> cacheBlock_ {};
+    int64_t cacheBlockPos_ {-1}; // position of cacheBlock_ in the file, -1 until a block boundary is reached
+
     friend class Downloader;
 };
 
@@ -126,11 +139,15 @@ public:
     bool Seek(int64_t offset);
     void Cancle();
     bool Retry(const std::shared_ptr<DownloadRequest>& request);
+    // hold back the next requests without touching the queue, the one in progress is completed
+    void SetThrottled(bool throttled);
 private:
     bool BeginDownload();
 
     void HttpDownloadLoop();
     void HandleRetOK();
+    bool ReadFromCache();
+    void SaveToCache(const uint8_t* data, size_t len);
     static size_t RxBodyData(void* buffer, size_t size, size_t nitems, void* userParam);
     static size_t RxHeaderData(void* buffer, size_t size, size_t nitems, void* userParam);
 
@@ -142,6 +159,8 @@ private:
 
     std::shared_ptr<DownloadRequest> currentRequest_;
     bool shouldStartNextRequest {false};
+    std::atomic<bool> throttled_ {false};
+    std::atomic<bool> pausedByThrottle_ {false};
 };
 }
 }
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define HST_LOG_TAG "HttpCache"
+
+#include "http_cache.h"
+#include <cstdio>
+#include <unistd.h>
+#include "foundation/log.h"
+#include "foundation/osal/filesystem/file_system.h"
+#include "foundation/osal/thread/scoped_lock.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace HttpPlugin {
+namespace {
+#ifdef OHOS_LITE
+constexpr size_t DEFAULT_MEMORY_LIMIT = 1024 * 1024;
+#else
+constexpr size_t DEFAULT_MEMORY_LIMIT = 16 * 1024 * 1024;
+#endif
+}
+
+HttpCache& HttpCache::GetInstance()
+{
+    static HttpCache instance;
+    return instance;
+}
+
+HttpCache::HttpCache() : memoryLimit_(DEFAULT_MEMORY_LIMIT)
+{
+}
+
+HttpCache::~HttpCache()
+{
+    Clear();
+}
+
+void HttpCache::SetLimits(size_t memoryLimit, size_t diskLimit, const std::string& diskPath)
+{
+    OSAL::ScopedLock lock(mutex_);
+    if (memoryLimit == memoryLimit_ && diskLimit == diskLimit_ && diskPath == diskPath_) {
+        return;
+    }
+    while (!diskBlocks_.empty()) {
+        EraseDiskBlock(diskBlocks_.begin());
+    }
+    memoryLimit_ = memoryLimit;
+    diskLimit_ = diskLimit;
+    diskPath_ = diskPath;
+    if (diskLimit_ > 0 && !diskPath_.empty() && !OSAL::FileSystem::IsDirectory(diskPath_) &&
+        !OSAL::FileSystem::MakeMultipleDir(diskPath_)) {
+        MEDIA_LOG_W("can not create http cache dir " PUBLIC_LOG_S ", disk cache disabled", diskPath_.c_str());
+        diskLimit_ = 0;
+    }
+    Evict();
+}
+
+void HttpCache::GetLimits(size_t& memoryLimit, size_t& diskLimit, std::string& diskPath)
+{
+    OSAL::ScopedLock lock(mutex_);
+    memoryLimit = memoryLimit_;
+    diskLimit = diskLimit_;
+    diskPath = diskPath_;
+}
+
+void HttpCache::Validate(const std::string& url, size_t fileLength, const std::string& eTag)
+{
+    OSAL::ScopedLock lock(mutex_);
+    auto iter = resources_.find(url);
+    if (iter != resources_.end()) {
+        auto& resource = iter->second;
+        if (resource.fileLength == fileLength && (eTag.empty() || resource.eTag.empty() || resource.eTag == eTag)) {
+            if (resource.eTag.empty()) {
+                resource.eTag = eTag;
+            }
+            return;
+        }
+        MEDIA_LOG_I("resource changed, drop its cached blocks, url " PUBLIC_LOG_S, url.c_str());
+        RemoveResource(url);
+    }
+    resources_[url] = {fileLength, eTag, nextResourceId_++};
+}
+
+bool HttpCache::GetFileLength(const std::string& url, size_t& fileLength)
+{
+    OSAL::ScopedLock lock(mutex_);
+    auto iter = resources_.find(url);
+    if (iter == resources_.end()) {
+        return false;
+    }
+    fileLength = iter->second.fileLength;
+    return true;
+}
+
+std::shared_ptr<std::vector<uint8_t>> HttpCache::GetBlock(const std::string& url, size_t offset, size_t& blockOffset)
+{
+    OSAL::ScopedLock lock(mutex_);
+    BlockKey key {url, offset / BLOCK_SIZE * BLOCK_SIZE};
+    blockOffset = offset - key.second;
+    std::shared_ptr<std::vector<uint8_t>> data;
+    auto iter = memoryBlocks_.find(key);
+    if (iter != memoryBlocks_.end()) {
+        memoryLru_.splice(memoryLru_.begin(), memoryLru_, iter->second.lru);
+        data = iter->second.data;
+    } else {
+        data = ReadDiskBlock(key);
+        if (data != nullptr) {
+            PutMemoryBlock(key, data);
+            Evict();
+        }
+    }
+    if (data == nullptr || blockOffset >= data->size()) {
+        statistics_.misses++;
+        return nullptr;
+    }
+    statistics_.hits++;
+    statistics_.bytesSaved += data->size() - blockOffset;
+    return data;
+}
+
+void HttpCache::PutBlock(const std::string& url, size_t offset, std::vector<uint8_t>&& data)
+{
+    OSAL::ScopedLock lock(mutex_);
+    if (offset % BLOCK_SIZE != 0 || data.empty() || data.size() > memoryLimit_ || resources_.count(url) == 0) {
+        return;
+    }
+    PutMemoryBlock({url, offset}, std::make_shared<std::vector<uint8_t>>(std::move(data)));
+    Evict();
+}
+
+HttpCacheStatistics HttpCache::GetStatistics()
+{
+    OSAL::ScopedLock lock(mutex_);
+    return statistics_;
+}
+
+void HttpCache::Clear()
+{
+    OSAL::ScopedLock lock(mutex_);
+    while (!diskBlocks_.empty()) {
+        EraseDiskBlock(diskBlocks_.begin());
+    }
+    memoryBlocks_.clear();
+    memoryLru_.clear();
+    resources_.clear();
+    statistics_ = {};
+}
+
+void HttpCache::PutMemoryBlock(const BlockKey& key, std::shared_ptr<std::vector<uint8_t>> data)
+{
+    auto iter = memoryBlocks_.find(key);
+    if (iter != memoryBlocks_.end()) {
+        statistics_.memoryBytes -= iter->second.data->size();
+        memoryLru_.erase(iter->second.lru);
+        memoryBlocks_.erase(iter);
+    }
+    statistics_.memoryBytes += data->size();
+    memoryLru_.push_front(key);
+    memoryBlocks_[key] = {std::move(data), memoryLru_.begin()};
+}
+
+void HttpCache::PutDiskBlock(const BlockKey& key, const std::vector<uint8_t>& data)
+{
+    if (diskLimit_ == 0 || data.size() > diskLimit_ || diskBlocks_.count(key) != 0) {
+        return;
+    }
+    auto path = GetBlockPath(key);
+    if (path.empty()) {
+        return;
+    }
+    auto file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        MEDIA_LOG_W("can not write http cache file " PUBLIC_LOG_S, path.c_str());
+        return;
+    }
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    std::fclose(file);
+    if (!written) {
+        std::remove(path.c_str());
+        return;
+    }
+    statistics_.diskBytes += data.size();
+    diskLru_.push_front(key);
+    diskBlocks_[key] = {data.size(), diskLru_.begin()};
+}
+
+std::shared_ptr<std::vector<uint8_t>> HttpCache::ReadDiskBlock(const BlockKey& key)
+{
+    auto iter = diskBlocks_.find(key);
+    if (iter == diskBlocks_.end()) {
+        return nullptr;
+    }
+    auto data = std::make_shared<std::vector<uint8_t>>(iter->second.size);
+    auto path = GetBlockPath(key);
+    auto file = path.empty() ? nullptr : std::fopen(path.c_str(), "rb");
+    bool read = file != nullptr && std::fread(data->data(), 1, data->size(), file) == data->size();
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+    if (!read) {
+        EraseDiskBlock(iter);
+        return nullptr;
+    }
+    diskLru_.splice(diskLru_.begin(), diskLru_, iter->second.lru);
+    return data;
+}
+
+void HttpCache::EraseDiskBlock(std::map<BlockKey, DiskBlock>::iterator iter)
+{
+    auto path = GetBlockPath(iter->first);
+    if (!path.empty()) {
+        std::remove(path.c_str());
+    }
+    statistics_.diskBytes -= iter->second.size;
+    diskLru_.erase(iter->second.lru);
+    diskBlocks_.erase(iter);
+}
+
+// blocks evicted from memory go to disk, if they are not there yet
+void HttpCache::Evict()
+{
+    while (statistics_.memoryBytes > memoryLimit_ && !memoryLru_.empty()) {
+        auto iter = memoryBlocks_.find(memoryLru_.back());
+        PutDiskBlock(iter->first, *iter->second.data);
+        statistics_.memoryBytes -= iter->second.data->size();
+        memoryLru_.pop_back();
+        memoryBlocks_.erase(iter);
+    }
+    while (statistics_.diskBytes > diskLimit_ && !diskLru_.empty()) {
+        EraseDiskBlock(diskBlocks_.find(diskLru_.back()));
+    }
+}
+
+void HttpCache::RemoveResource(const std::string& url)
+{
+    for (auto iter = memoryBlocks_.lower_bound({url, 0}); iter != memoryBlocks_.end() && iter->first.first == url;) {
+        statistics_.memoryBytes -= iter->second.data->size();
+        memoryLru_.erase(iter->second.lru);
+        iter = memoryBlocks_.erase(iter);
+    }
+    for (auto iter = diskBlocks_.lower_bound({url, 0}); iter != diskBlocks_.end() && iter->first.first == url;) {
+        EraseDiskBlock(iter++);
+    }
+    resources_.erase(url);
+}
+
+// files are named after the resource id rather than the url, the process id keeps processes sharing a dir apart
+// empty if the resource is not known, blocks are only stored for validated resources
+std::string HttpCache::GetBlockPath(const BlockKey& key)
+{
+    auto iter = resources_.find(key.first);
+    if (iter == resources_.end()) {
+        return "";
+    }
+    return diskPath_ + "/hst_http_" + std::to_string(getpid()) + "_" + std::to_string(iter->second.id) +
+        "_" + std::to_string(key.second / BLOCK_SIZE) + ".blk";
+}
+}
+}
+}
+}
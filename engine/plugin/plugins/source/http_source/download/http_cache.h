@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_HTTP_CACHE_H
+#define HISTREAMER_HTTP_CACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "foundation/osal/thread/mutex.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace HttpPlugin {
+struct HttpCacheStatistics {
+    uint64_t hits {0};        // blocks found in the cache
+    uint64_t misses {0};      // blocks looked up and not found
+    uint64_t bytesSaved {0};  // bytes served from the cache instead of the network
+    uint64_t memoryBytes {0}; // bytes held in memory
+    uint64_t diskBytes {0};   // bytes held on disk
+};
+
+/**
+ * Process wide cache of downloaded http bodies, shared by all the downloaders.
+ *
+ * Bodies are stored in blocks of BLOCK_SIZE bytes keyed by url and block index, so any byte range of a resource
+ * can be served once it has been downloaded. Blocks live in memory and, when a disk path is set, are moved to disk
+ * when evicted from memory. Both tiers are evicted least recently used first. Disk blocks only live as long as the
+ * process, they are not reloaded by a later one.
+ */
+class HttpCache {
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    static HttpCache& GetInstance();
+    HttpCache();
+    ~HttpCache();
+
+    /// size caps of both tiers, an empty disk path or a zero disk limit disables the disk tier
+    void SetLimits(size_t memoryLimit, size_t diskLimit, const std::string& diskPath = "");
+
+    void GetLimits(size_t& memoryLimit, size_t& diskLimit, std::string& diskPath);
+
+    /// record the version of url reported by the server, the blocks of another version are dropped
+    void Validate(const std::string& url, size_t fileLength, const std::string& eTag);
+
+    /// length of url as validated, false if the server has not described it yet
+    bool GetFileLength(const std::string& url, size_t& fileLength);
+
+    /// the block holding offset of url, blockOffset is the position of offset inside it, nullptr if not cached
+    std::shared_ptr<std::vector<uint8_t>> GetBlock(const std::string& url, size_t offset, size_t& blockOffset);
+
+    /// store the block starting at offset, which must be a multiple of BLOCK_SIZE
+    void PutBlock(const std::string& url, size_t offset, std::vector<uint8_t>&& data);
+
+    HttpCacheStatistics GetStatistics();
+
+    /// drop all the blocks and reset the statistics
+    void Clear();
+
+private:
+    using BlockKey = std::pair<std::string, size_t>;
+    struct MemoryBlock {
+        std::shared_ptr<std::vector<uint8_t>> data;
+        std::list<BlockKey>::iterator lru;
+    };
+    struct DiskBlock {
+        size_t size;
+        std::list<BlockKey>::iterator lru;
+    };
+    struct Resource {
+        size_t fileLength {0};
+        std::string eTag;
+        uint64_t id {0};
+    };
+
+    void PutMemoryBlock(const BlockKey& key, std::shared_ptr<std::vector<uint8_t>> data);
+    void PutDiskBlock(const BlockKey& key, const std::vector<uint8_t>& data);
+    std::shared_ptr<std::vector<uint8_t>> ReadDiskBlock(const BlockKey& key);
+    void EraseDiskBlock(std::map<BlockKey, DiskBlock>::iterator iter);
+    void Evict();
+    void RemoveResource(const std::string& url);
+    std::string GetBlockPath(const BlockKey& key);
+
+    OSAL::Mutex mutex_ {};
+    size_t memoryLimit_;
+    size_t diskLimit_ {0};
+    std::string diskPath_ {};
+    std::map<std::string, Resource> resources_ {};
+    uint64_t nextResourceId_ {0};
+    std::map<BlockKey, MemoryBlock> memoryBlocks_ {};
+    std::list<BlockKey> memoryLru_ {};
+    std::map<BlockKey, DiskBlock> diskBlocks_ {};
+    std::list<BlockKey> diskLru_ {};
+    HttpCacheStatistics statistics_ {};
+};
+}
+}
+}
+}
+#endif
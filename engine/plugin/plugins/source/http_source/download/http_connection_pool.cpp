@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define HST_LOG_TAG "HttpConnectionPool"
+
+#include "http_connection_pool.h"
+#include "foundation/log.h"
+#include "foundation/osal/thread/scoped_lock.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace HttpPlugin {
+HttpConnectionPool& HttpConnectionPool::GetInstance()
+{
+    static HttpConnectionPool instance;
+    return instance;
+}
+
+HttpConnectionPool::HttpConnectionPool()
+{
+    // the share handle outlives the clients, keep the library initialized as long as it exists
+    FALSE_LOG(curl_global_init(CURL_GLOBAL_ALL) == CURLE_OK);
+    share_ = curl_share_init();
+    FALSE_RETURN_MSG(share_ != nullptr, "curl share init failed, connections are not shared");
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, LockShare);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+}
+
+HttpConnectionPool::~HttpConnectionPool()
+{
+    if (share_ != nullptr) {
+        curl_share_cleanup(share_);
+        share_ = nullptr;
+    }
+    curl_global_cleanup();
+}
+
+void HttpConnectionPool::Attach(CURL* handle)
+{
+    if (share_ != nullptr) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    }
+}
+
+void HttpConnectionPool::OnTransferDone(const std::string& url, CURL* handle)
+{
+    long connections = 0;
+    curl_off_t ttfbUs = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connections);
+    curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME_T, &ttfbUs);
+    auto host = GetHost(url);
+    MEDIA_LOG_D("host " PUBLIC_LOG_S ", new connections " PUBLIC_LOG_D32 ", ttfb " PUBLIC_LOG_D64 " us",
+        host.c_str(), static_cast<int32_t>(connections), static_cast<int64_t>(ttfbUs));
+    OSAL::ScopedLock lock(mutex_);
+    auto& statistics = statistics_[host];
+    statistics.requests++;
+    statistics.connections += static_cast<uint64_t>(connections);
+    statistics.totalTtfbUs += static_cast<int64_t>(ttfbUs);
+    statistics.lastTtfbUs = static_cast<int64_t>(ttfbUs);
+}
+
+HostStatistics HttpConnectionPool::GetStatistics(const std::string& host)
+{
+    OSAL::ScopedLock lock(mutex_);
+    auto iter = statistics_.find(host);
+    return iter == statistics_.end() ? HostStatistics {} : iter->second;
+}
+
+std::string HttpConnectionPool::GetHost(const std::string& url)
+{
+    auto begin = url.find("://");
+    begin = (begin == std::string::npos) ? 0 : begin + 3; // 3: length of "://"
+    auto end = url.find_first_of("/?#", begin);
+    auto host = url.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    auto userInfo = host.rfind('@');
+    if (userInfo != std::string::npos) {
+        host.erase(0, userInfo + 1);
+    }
+    return host;
+}
+
+void HttpConnectionPool::LockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* userPtr)
+{
+    (void)handle;
+    (void)access;
+    static_cast<HttpConnectionPool*>(userPtr)->shareMutexes_[data].Lock();
+}
+
+void HttpConnectionPool::UnlockShare(CURL* handle, curl_lock_data data, void* userPtr)
+{
+    (void)handle;
+    static_cast<HttpConnectionPool*>(userPtr)->shareMutexes_[data].Unlock();
+}
+}
+}
+}
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_HTTP_CONNECTION_POOL_H
+#define HISTREAMER_HTTP_CONNECTION_POOL_H
+
+#include <map>
+#include <string>
+#include "curl/curl.h"
+#include "foundation/osal/thread/mutex.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace HttpPlugin {
+struct HostStatistics {
+    uint64_t requests {0};
+    uint64_t connections {0}; // requests which had to open a new connection
+    int64_t totalTtfbUs {0};  // time to first byte, summed over the requests
+    int64_t lastTtfbUs {0};
+};
+
+/**
+ * Process wide network state shared by the curl clients of all the downloaders.
+ *
+ * A curl share handle holds the dns cache, the open connections and the tls sessions, so that a fragment or range
+ * request reuses the connection another downloader left open to the same host instead of connecting and
+ * handshaking again. Connections are looked up by host inside curl, transfer timings are kept here per host.
+ */
+class HttpConnectionPool {
+public:
+    static HttpConnectionPool& GetInstance();
+    HttpConnectionPool();
+    ~HttpConnectionPool();
+
+    /// make handle use the shared caches, after curl_easy_init or curl_easy_reset
+    void Attach(CURL* handle);
+
+    /// record the timings of the transfer handle has just performed for url
+    void OnTransferDone(const std::string& url, CURL* handle);
+
+    HostStatistics GetStatistics(const std::string& host);
+
+    /// host and port of url, the key of the statistics
+    static std::string GetHost(const std::string& url);
+
+private:
+    static void LockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* userPtr);
+    static void UnlockShare(CURL* handle, curl_lock_data data, void* userPtr);
+
+    CURLSH* share_ {nullptr};
+    OSAL::Mutex shareMutexes_[CURL_LOCK_DATA_LAST] {};
+    OSAL::Mutex mutex_ {};
+    std::map<std::string, HostStatistics> statistics_ {};
+};
+}
+}
+}
+}
+#endif
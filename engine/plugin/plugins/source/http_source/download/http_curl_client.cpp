@@ -21,6 +21,7 @@
 #include "foundation/log.h"
 #include <foundation/osal/thread/scoped_lock.h>
 #include "foundation/utils/hitrace_utils.h"
+#include "http_connection_pool.h"
 #include "securec.h"
 
 #ifndef CA_DIR
@@ -48,10 +49,17 @@ Status HttpCurlClient::Init()
     return Status::OK;
 }
 
+// a handle left open by the previous request is reset rather than replaced, it keeps its connection alive
 Status HttpCurlClient::Open(const std::string& url)
 {
-    easyHandle_ = curl_easy_init();
+    OSAL::ScopedLock lock(mutex_);
+    if (easyHandle_ != nullptr) {
+        curl_easy_reset(easyHandle_);
+    } else {
+        easyHandle_ = curl_easy_init();
+    }
     FALSE_RETURN_V(easyHandle_ != nullptr, Status::ERROR_NULL_POINTER);
+    url_ = url;
     InitCurlEnvironment(url);
     return Status::OK;
 }
@@ -81,6 +89,7 @@ Status HttpCurlClient::Deinit()
 void HttpCurlClient::InitCurlEnvironment(const std::string& url)
 {
     curl_easy_setopt(easyHandle_, CURLOPT_URL, UrlParse(url).c_str());
+    HttpConnectionPool::GetInstance().Attach(easyHandle_);
     curl_easy_setopt(easyHandle_, CURLOPT_CONNECTTIMEOUT, 5); // 5
 
     curl_easy_setopt(easyHandle_, CURLOPT_SSL_VERIFYPEER, 0L);
@@ -130,6 +139,8 @@ Status HttpCurlClient::RequestData(long startPos, int len, NetworkServerErrorCod
         }
         MEDIA_LOG_DD("RequestData: requestRange " PUBLIC_LOG_S, requestRange);
         curl_easy_setopt(easyHandle_, CURLOPT_RANGE, requestRange);
+    } else {
+        curl_easy_setopt(easyHandle_, CURLOPT_RANGE, nullptr);
     }
     curl_slist *headers {nullptr};
     headers = curl_slist_append(headers, "Connection: Keep-alive");
@@ -163,6 +174,7 @@ Status HttpCurlClient::RequestData(long startPos, int len, NetworkServerErrorCod
             serverCode = httpCode;
             return Status::ERROR_SERVER;
         }
+        HttpConnectionPool::GetInstance().OnTransferDone(url_, easyHandle_);
     }
     return Status::OK;
 }
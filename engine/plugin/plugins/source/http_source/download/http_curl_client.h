@@ -49,6 +49,7 @@ private:
     RxBody rxBody_;
     void *userParam_;
     CURL* easyHandle_ {nullptr};
+    std::string url_ {};
     mutable OSAL::Mutex mutex_;
 };
 }
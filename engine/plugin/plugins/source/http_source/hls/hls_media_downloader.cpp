@@ -71,6 +71,7 @@ void HlsMediaDownloader::PutRequestIntoDownloader(const PlayInfo& playInfo)
     };
     // TO DO: If the fragment file is too large, should not requestWholeFile.
     downloadRequest_ = std::make_shared<DownloadRequest>(playInfo.url_, playInfo.duration_, dataSave_, realStatusCallback, true);
+    downloadRequest_->EnableCache(true); // fragments do not change, seeking back reads them from the cache
     // push request to back queue for seek
     backPlayList_.push_back(downloadRequest_);
     downloader_->Download(downloadRequest_, -1); // -1
@@ -171,6 +172,16 @@ bool HlsMediaDownloader::GetStartedStatus()
     return playListDownloader_->GetPlayListDownloadStatus() && startedPlayStatus_;
 }
 
+size_t HlsMediaDownloader::GetBufferSize() const
+{
+    return buffer_->GetSize();
+}
+
+void HlsMediaDownloader::SetDownloadPaused(bool paused)
+{
+    downloader_->SetThrottled(paused);
+}
+
 bool HlsMediaDownloader::SaveData(uint8_t* data, uint32_t len)
 {
     startedPlayStatus_ = true;
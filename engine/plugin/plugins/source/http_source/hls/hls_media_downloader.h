@@ -42,6 +42,8 @@ public:
     void OnPlayListChanged(const std::vector<PlayInfo>& playList) override;
     void SetStatusCallback(StatusCallbackFunc cb) override;
     bool GetStartedStatus() override;
+    size_t GetBufferSize() const override;
+    void SetDownloadPaused(bool paused) override;
     std::vector<uint32_t> GetBitRates() override;
     bool SelectBitRate(uint32_t bitRate) override;
     void FindSeekRequest(int64_t offset);
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 #define HST_LOG_TAG "HlsPlayListDownloader"
+#include <algorithm>
+#include <iterator>
 #include <mutex>
 #include "hls_playlist_downloader.h"
 #include "plugin/common/plugin_time.h"
@@ -23,7 +25,12 @@ namespace Plugin {
 namespace HttpPlugin {
 void HlsPlayListDownloader::PlayListUpdateLoop()
 {
-    OSAL::SleepFor(5000); // 5000 how often is playlist updated
+    int64_t interval = reloadInterval_.load();
+    if (interval <= 0) { // vod playlist is complete, there is nothing to refresh
+        updateTask_->PauseAsync();
+        return;
+    }
+    OSAL::SleepFor(interval);
     UpdateManifest();
 }
 
@@ -76,15 +83,24 @@ Seekable HlsPlayListDownloader::GetSeekable() const
     return master_->bLive_ ? Seekable::UNSEEKABLE : Seekable::SEEKABLE;
 }
 
+// Only the fragments added by the last update are notified, unless the variant has just been switched to, in which
+// case the media downloader has dropped its queue and needs all of them.
 void HlsPlayListDownloader::NotifyListChange()
 {
-    auto files = currentVariant_->m3u8_->files_;
+    auto& m3u8 = currentVariant_->m3u8_;
+    auto& files = m3u8->files_;
+    bool notifyFullList = notifyFullList_.exchange(false);
+    size_t count = notifyFullList ? files.size() : std::min<size_t>(m3u8->newFragments_, files.size());
+    reloadInterval_ = m3u8->IsLive() ? m3u8->GetReloadInterval() : 0;
+    if (count == 0) {
+        return;
+    }
     auto playList = std::vector<PlayInfo>();
-    playList.reserve(files.size());
-    for (auto &file: files) {
+    playList.reserve(count);
+    for (auto it = std::prev(files.end(), static_cast<std::ptrdiff_t>(count)); it != files.end(); ++it) {
         PlayInfo palyInfo;
-        palyInfo.url_ = file->uri_;
-        palyInfo.duration_ = file->duration_;
+        palyInfo.url_ = (*it)->uri_;
+        palyInfo.duration_ = (*it)->duration_;
         playList.push_back(palyInfo);
     }
     callback_->OnPlayListChanged(playList);
@@ -114,6 +130,7 @@ void HlsPlayListDownloader::ParseManifest()
             if (ret) {
                 master_->isSimple_ = true;
                 master_->duration_ = currentVariant_->m3u8_->GetDuration();
+                master_->bLive_ = currentVariant_->m3u8_->IsLive();
                 NotifyListChange();
             }
         }
@@ -124,6 +141,9 @@ void HlsPlayListDownloader::SelectBitRate(uint32_t bitRate)
 {   
     for (const auto &item : master_->variants_) {
         if (item->bandWidth_ == bitRate) {   
+            if (item != currentVariant_) {
+                notifyFullList_ = true;
+            }
             currentVariant_ = item;
             break;
         }
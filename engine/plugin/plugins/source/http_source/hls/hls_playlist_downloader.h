@@ -16,6 +16,7 @@
 #ifndef HISTREAMER_HLS_PLAYLIST_DOWNLOADER_H
 #define HISTREAMER_HLS_PLAYLIST_DOWNLOADER_H
 
+#include <atomic>
 #include "playlist_downloader.h"
 #include "m3u8.h"
 
@@ -46,6 +47,8 @@ private:
     std::shared_ptr<M3U8MasterPlaylist> master_;
     std::shared_ptr<M3U8VariantStream> currentVariant_;
     std::shared_ptr<M3U8VariantStream> previousVariant_;
+    std::atomic<int64_t> reloadInterval_ {5000}; // 5000: ms, until the target duration is known, 0 for vod
+    std::atomic<bool> notifyFullList_ {false}; // set by SelectBitRate, consumed by the update task
 };
 }
 }
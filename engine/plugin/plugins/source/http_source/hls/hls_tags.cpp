@@ -14,15 +14,19 @@
  */
 
 #include "hls_tags.h"
-#include <cstring>
+#include <algorithm>
+#include <charconv>
 #include <sstream>
-#include <stack>
 #include <utility>
 
 namespace OHOS {
 namespace Media {
 namespace Plugin {
 namespace HttpPlugin {
+namespace {
+constexpr int MAX_FRACTION_DIGITS = 18; // 18: keeps the fraction within uint64_t
+}
+
 struct {
     const char* name;
     HlsTag type;
@@ -55,20 +59,39 @@ Attribute::Attribute(std::string name, std::string value)
 
 uint64_t Attribute::Decimal() const
 {
-    std::istringstream is(value_);
-    is.imbue(std::locale("C"));
-    uint64_t ret;
-    is >> ret;
+    auto begin = value_.data() + std::min(value_.find_first_not_of(' '), value_.size());
+    uint64_t ret = 0;
+    if (std::from_chars(begin, value_.data() + value_.size(), ret).ec != std::errc()) {
+        return 0;
+    }
     return ret;
 }
 
+// parsed by hand instead of through a stream, it is done for every fragment and must not depend on the locale
 double Attribute::FloatingPoint() const
 {
-    std::istringstream is(value_);
-    is.imbue(std::locale("C"));
-    double ret;
-    is >> ret;
-    return ret;
+    size_t pos = std::min(value_.find_first_not_of(' '), value_.size());
+    bool negative = pos < value_.size() && value_[pos] == '-';
+    if (pos < value_.size() && (value_[pos] == '-' || value_[pos] == '+')) {
+        pos++;
+    }
+    double ret = 0;
+    for (; pos < value_.size() && value_[pos] >= '0' && value_[pos] <= '9'; pos++) {
+        ret = ret * 10 + (value_[pos] - '0'); // 10: decimal
+    }
+    if (pos < value_.size() && value_[pos] == '.') {
+        uint64_t fraction = 0;
+        uint64_t divisor = 1;
+        int digits = 0;
+        for (pos++; pos < value_.size() && value_[pos] >= '0' && value_[pos] <= '9'; pos++) {
+            if (digits++ < MAX_FRACTION_DIGITS) {
+                fraction = fraction * 10 + (value_[pos] - '0'); // 10: decimal
+                divisor *= 10; // 10: decimal
+            }
+        }
+        ret += static_cast<double>(fraction) / static_cast<double>(divisor);
+    }
+    return negative ? -ret : ret;
 }
 
 std::vector<uint8_t> Attribute::HexSequence() const
@@ -139,18 +162,19 @@ std::string Attribute::QuotedString() const
     if (value_.length() < 2) { // 2
         return "";
     }
-    std::istringstream is(value_.substr(1, value_.length() - 2)); // 2
-    std::ostringstream os;
-    char c;
-    while (is.get(c)) {
+    std::string ret;
+    ret.reserve(value_.length() - 2); // 2: quotes
+    for (size_t i = 1; i + 1 < value_.length(); i++) {
+        char c = value_[i];
         if (c == '\\') {
-            if (!is.get(c)) {
+            if (++i + 1 >= value_.length()) {
                 break;
             }
+            c = value_[i];
         }
-        os << c;
+        ret.push_back(c);
     }
-    return os.str();
+    return ret;
 }
 
 Tag::Tag(HlsTag type)
@@ -163,8 +187,8 @@ HlsTag Tag::GetType() const
     return type_;
 }
 
-SingleValueTag::SingleValueTag(HlsTag type, const std::string& v)
-    : Tag(type), attr_("", v)
+SingleValueTag::SingleValueTag(HlsTag type, std::string_view v)
+    : Tag(type), attr_("", std::string(v))
 {
 }
 
@@ -173,7 +197,11 @@ const Attribute& SingleValueTag::GetValue() const
     return attr_;
 }
 
-AttributesTag::AttributesTag(HlsTag type, const std::string& v) : Tag(type)
+AttributesTag::AttributesTag(HlsTag type) : Tag(type)
+{
+}
+
+AttributesTag::AttributesTag(HlsTag type, std::string_view v) : Tag(type)
 {
     AttributesTag::ParseAttributes(v);
 }
@@ -193,15 +221,11 @@ void AttributesTag::AddAttribute(std::shared_ptr<Attribute>& attr)
     attributes.push_back(attr);
 }
 
-void AttributesTag::ParseAttributes(const std::string& field)
+void AttributesTag::ParseAttributes(std::string_view field)
 {
-    std::istringstream iss(field);
-    std::ostringstream oss;
-    while (!iss.eof()) {
-        std::string attrName = ParseAttributeName(iss, oss);
-        oss.str("");
-        std::string attrValue = ParseAttributeValue(iss, oss);
-        oss.str("");
+    while (!field.empty()) {
+        std::string attrName = ParseAttributeName(field);
+        std::string attrValue = ParseAttributeValue(field);
         if (!attrName.empty())  {
             auto attribute = std::make_shared<Attribute>(attrName, attrValue);
             attributes.push_back(attribute);
@@ -209,164 +233,177 @@ void AttributesTag::ParseAttributes(const std::string& field)
     }
 }
 
-std::string AttributesTag::ParseAttributeValue(std::istringstream &iss, std::ostringstream &oss)
+std::string AttributesTag::ParseAttributeValue(std::string_view& field) const
 {
+    std::string value;
     bool bQuoted = false;
-    while (!iss.eof()) {
-        char c = static_cast<char>(iss.peek());
+    while (!field.empty()) {
+        char c = field.front();
+        field.remove_prefix(1);
         if (c == '\\' && bQuoted) {
-            iss.get();
+            if (field.empty()) {
+                break;
+            }
+            c = field.front();
+            field.remove_prefix(1);
         } else if (c == ',' && !bQuoted) {
-            iss.get();
             break;
         } else if (c == '"') {
             bQuoted = !bQuoted;
             if (!bQuoted) {
-                oss.put(static_cast<char>(iss.get()));
+                value.push_back(c);
                 break;
             }
         } else if (!bQuoted && (c < '-' || c > 'z'))  { /* out of range */
-            iss.get();
             continue;
         }
-        if (!iss.eof()) {
-            oss.put(static_cast<char>(iss.get()));
-        }
+        value.push_back(c);
     }
-    return oss.str();
+    return value;
 }
 
-std::string AttributesTag::ParseAttributeName(std::istringstream& iss, std::ostringstream& oss) const
+std::string AttributesTag::ParseAttributeName(std::string_view& field) const
 {
-    while (!iss.eof()) {
-        char c = static_cast<char>(iss.peek());
+    std::string name;
+    while (!field.empty()) {
+        char c = field.front();
+        field.remove_prefix(1);
         if ((c >= 'A' && c <= 'Z') || c == '-') {
-            oss.put(static_cast<char>(iss.get()));
+            name.push_back(c);
         } else if (c == '=') {
-            iss.get();
             break;
-        } else { /* out of range */
-            iss.get();
-        }
+        } /* else out of range */
     }
-    return oss.str();
+    return name;
 }
 
-ValuesListTag::ValuesListTag(HlsTag type, const std::string& v) : AttributesTag(type, v)
+// the values list is not made of attributes, skip the attribute parsing of the base class
+ValuesListTag::ValuesListTag(HlsTag type, std::string_view v) : AttributesTag(type)
 {
     ValuesListTag::ParseAttributes(v);
 }
 
-void ValuesListTag::ParseAttributes(const std::string& field)
+void ValuesListTag::ParseAttributes(std::string_view field)
 {
     auto pos = field.find(',');
     std::shared_ptr<Attribute> attr;
-    if (pos != std::string::npos) {
-        attr = std::make_shared<Attribute>("DURATION", field.substr(0, pos));
+    if (pos != std::string_view::npos) {
+        attr = std::make_shared<Attribute>("DURATION", std::string(field.substr(0, pos)));
         if (attr) {
             AddAttribute(attr);
         }
-        attr = std::make_shared<Attribute>("TITLE", field.substr(pos));
+        attr = std::make_shared<Attribute>("TITLE", std::string(field.substr(pos)));
         if (attr) {
             AddAttribute(attr);
         }
     } else { /* broken EXTINF without mandatory comma */
-        attr = std::make_shared<Attribute>("DURATION", field);
+        attr = std::make_shared<Attribute>("DURATION", std::string(field));
         if (attr) {
             AddAttribute(attr);
         }
     }
 }
 
-std::shared_ptr<Tag> TagFactory::CreateTagByName(const std::string& name, const std::string& value)
+std::shared_ptr<Tag> TagFactory::CreateTagByName(std::string_view name, std::string_view value)
 {
-    auto size = sizeof(g_exttagmapping) / sizeof(g_exttagmapping[0]);
-    for (unsigned int i = 0; i < size; i++) {
-        if (name != g_exttagmapping[i].name) {
-            continue;
-        }
-        switch (g_exttagmapping[i].type) {
-            case HlsTag::EXTXDISCONTINUITY:
-            case HlsTag::EXTXENDLIST:
-            case HlsTag::EXTXIFRAMESONLY:
-                return std::make_shared<Tag>(g_exttagmapping[i].type);
-            case HlsTag::URI:
-            case HlsTag::EXTXVERSION:
-            case HlsTag::EXTXBYTERANGE:
-            case HlsTag::EXTXPROGRAMDATETIME:
-            case HlsTag::EXTXTARGETDURATION:
-            case HlsTag::EXTXMEDIASEQUENCE:
-            case HlsTag::EXTXDISCONTINUITYSEQUENCE:
-            case HlsTag::EXTXPLAYLISTTYPE:
-                return std::make_shared<SingleValueTag>(g_exttagmapping[i].type, value);
-            case HlsTag::EXTINF:
-                return std::make_shared<ValuesListTag>(g_exttagmapping[i].type, value);
-            case HlsTag::EXTXKEY:
-            case HlsTag::EXTXSESSIONKEY:
-            case HlsTag::EXTXMAP:
-            case HlsTag::EXTXMEDIA:
-            case HlsTag::EXTXSTART:
-            case HlsTag::EXTXSTREAMINF:
-            case HlsTag::EXTXIFRAMESTREAMINF:
-                return std::make_shared<AttributesTag>(g_exttagmapping[i].type, value);
-            default:
-                return nullptr;
+    for (const auto& mapping : g_exttagmapping) {
+        if (name == mapping.name) {
+            return CreateTag(mapping.type, value);
         }
     }
     return nullptr;
 }
 
-static std::vector<std::string> Split(const std::string& s, const char* delim)
+std::shared_ptr<Tag> TagFactory::CreateTag(HlsTag type, std::string_view value)
 {
-    std::vector<std::string> ret;
-    std::string::size_type last = 0;
-    auto index = s.find(delim, last);
-    while (index != std::string::npos) {
-        if (index - last > 0) {
-            ret.push_back(s.substr(last, index - last));
-        }
-        last = index + strlen(delim);
-        index = s.find(delim, last);
+    switch (type) {
+        case HlsTag::EXTXDISCONTINUITY:
+        case HlsTag::EXTXENDLIST:
+        case HlsTag::EXTXIFRAMESONLY:
+            return std::make_shared<Tag>(type);
+        case HlsTag::URI:
+        case HlsTag::EXTXVERSION:
+        case HlsTag::EXTXBYTERANGE:
+        case HlsTag::EXTXPROGRAMDATETIME:
+        case HlsTag::EXTXTARGETDURATION:
+        case HlsTag::EXTXMEDIASEQUENCE:
+        case HlsTag::EXTXDISCONTINUITYSEQUENCE:
+        case HlsTag::EXTXPLAYLISTTYPE:
+            return std::make_shared<SingleValueTag>(type, value);
+        case HlsTag::EXTINF:
+            return std::make_shared<ValuesListTag>(type, value);
+        case HlsTag::EXTXKEY:
+        case HlsTag::EXTXSESSIONKEY:
+        case HlsTag::EXTXMAP:
+        case HlsTag::EXTXMEDIA:
+        case HlsTag::EXTXSTART:
+        case HlsTag::EXTXSTREAMINF:
+        case HlsTag::EXTXIFRAMESTREAMINF:
+            return std::make_shared<AttributesTag>(type, value);
+        default:
+            return nullptr;
     }
-    if (s.empty() || s.size() - last > 0) {
-        ret.push_back(s.substr(last));
+}
+
+bool GetNextLine(std::string_view& text, std::string_view& line)
+{
+    if (text.empty()) {
+        return false;
     }
-    return ret;
+    auto pos = text.find('\n');
+    line = text.substr(0, pos);
+    text.remove_prefix(pos == std::string_view::npos ? text.size() : pos + 1);
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return true;
 }
 
-static void ParseTag(std::list<std::shared_ptr<Tag>>& entriesList, std::shared_ptr<Tag>& lastTag, std::string& line)
+bool ParseTagLine(std::string_view line, HlsTag& type, std::string_view& value)
 {
-    if (line.find("#EXT") != std::string::npos) { // tag
-        line = line.substr(1);
-        std::string key;
-        std::string value;
-        auto keyValue = Split(line, ":");
-        key = keyValue[0];
-        if (keyValue.size() == 2) { // 2
-            value = keyValue[1];
-        }
-        if (!key.empty()) {
-            auto tag = TagFactory::CreateTagByName(key, value);
-            if (tag) {
-                entriesList.push_back(tag);
-            }
-            lastTag = tag;
+    if (line.size() < 4 || line.compare(0, 4, "#EXT") != 0) { // 4: "#EXT", other lines are comments
+        return false;
+    }
+    line.remove_prefix(1);
+    auto pos = line.find(':');
+    auto name = line.substr(0, pos);
+    value = pos == std::string_view::npos ? std::string_view() : line.substr(pos + 1);
+    for (const auto& mapping : g_exttagmapping) {
+        if (name == mapping.name) {
+            type = mapping.type;
+            return mapping.type != HlsTag::URI;
         }
     }
+    return false;
+}
+
+static void ParseTag(std::list<std::shared_ptr<Tag>>& entriesList, std::shared_ptr<Tag>& lastTag,
+                     std::string_view line)
+{
+    HlsTag type;
+    std::string_view value;
+    std::shared_ptr<Tag> tag = nullptr;
+    if (ParseTagLine(line, type, value)) {
+        tag = TagFactory::CreateTag(type, value);
+    }
+    if (tag) {
+        entriesList.push_back(tag);
+    }
+    lastTag = tag;
 }
 
 static void ParseURI(std::list<std::shared_ptr<Tag>>& entriesList,
-                     std::shared_ptr<Tag>& lastTag, const std::string& line)
+                     std::shared_ptr<Tag>& lastTag, std::string_view line)
 {
     if (lastTag && lastTag->GetType() == HlsTag::EXTXSTREAMINF) {
         auto streaminftag = std::static_pointer_cast<AttributesTag>(lastTag);
         /* master playlist uri, merge as attribute */
-        auto uriAttr = std::make_shared<Attribute>("URI", line);
+        auto uriAttr = std::make_shared<Attribute>("URI", std::string(line));
         if (uriAttr) {
             streaminftag->AddAttribute(uriAttr);
         }
     } else {  /* playlist tag, will take modifiers */
-        auto tag = TagFactory::CreateTagByName("", line);
+        auto tag = TagFactory::CreateTag(HlsTag::URI, line);
         if (tag) {
             entriesList.push_back(tag);
         }
@@ -374,23 +411,20 @@ static void ParseURI(std::list<std::shared_ptr<Tag>>& entriesList,
     lastTag = nullptr;
 }
 
-std::list<std::shared_ptr<Tag>> ParseEntries(std::string& s)
+std::list<std::shared_ptr<Tag>> ParseEntries(std::string_view s)
 {
     std::list<std::shared_ptr<Tag>> list;
     std::shared_ptr<Tag> lastTag = nullptr;
-    auto lines = Split(s, "\r\n");
-    if (lines.size() == 1) {  // 1
-        lines = Split(s, "\n");
-    }
-    for (auto line : lines) {
-        if (line[0] == '#') {
-            ParseTag(list, lastTag, line);
-        } else if (!line.empty()) {
+    std::string_view line;
+    while (GetNextLine(s, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] != '#') {
             /* URI */
             ParseURI(list, lastTag, line);
-        } else {
-            // drop
-            lastTag = nullptr;
+        } else if (line.compare(0, 4, "#EXT") == 0) { // 4: "#EXT", other lines are comments
+            ParseTag(list, lastTag, line);
         }
     }
     return list;
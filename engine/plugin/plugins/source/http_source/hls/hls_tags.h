@@ -19,6 +19,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace OHOS {
@@ -89,7 +90,7 @@ private:
 
 class SingleValueTag : public Tag {
 public:
-    SingleValueTag(HlsTag type, const std::string& v);
+    SingleValueTag(HlsTag type, std::string_view v);
     ~SingleValueTag() override = default;
     const Attribute& GetValue() const;
 private:
@@ -98,32 +99,46 @@ private:
 
 class AttributesTag : public Tag {
 public:
-    AttributesTag(HlsTag type, const std::string& v);
+    AttributesTag(HlsTag type, std::string_view v);
     ~AttributesTag() override = default;
     std::shared_ptr<Attribute> GetAttributeByName(const char* name) const;
     void AddAttribute(std::shared_ptr<Attribute>& attr);
 protected:
-    virtual void ParseAttributes(const std::string& field);
+    explicit AttributesTag(HlsTag type);
+    virtual void ParseAttributes(std::string_view field);
     std::list<std::shared_ptr<Attribute>> attributes;
 private:
-    std::string ParseAttributeName(std::istringstream& iss, std::ostringstream& oss) const;
-    std::string ParseAttributeValue(std::istringstream& iss, std::ostringstream& oss);
+    std::string ParseAttributeName(std::string_view& field) const;
+    std::string ParseAttributeValue(std::string_view& field) const;
 };
 
 class ValuesListTag : public AttributesTag {
 public:
-    ValuesListTag(HlsTag type, const std::string& v);
+    ValuesListTag(HlsTag type, std::string_view v);
     ~ValuesListTag() override = default;
 protected:
-    void ParseAttributes(const std::string& field) override;
+    void ParseAttributes(std::string_view field) override;
 };
 
 class TagFactory {
 public:
-    static std::shared_ptr<Tag> CreateTagByName(const std::string& name, const std::string& value);
+    static std::shared_ptr<Tag> CreateTagByName(std::string_view name, std::string_view value);
+    static std::shared_ptr<Tag> CreateTag(HlsTag type, std::string_view value);
 };
 
-std::list<std::shared_ptr<Tag>> ParseEntries(std::string& s);
+/**
+ * Split the first line off text, the line break ("\n" or "\r\n") belongs to neither of them.
+ * The line refers to the memory of text, nothing is copied.
+ */
+bool GetNextLine(std::string_view& text, std::string_view& line);
+
+/**
+ * Split a "#EXT..." line into the tag type and its value.
+ * Returns false for comments and tags which are not supported.
+ */
+bool ParseTagLine(std::string_view line, HlsTag& type, std::string_view& value);
+
+std::list<std::shared_ptr<Tag>> ParseEntries(std::string_view s);
 }
 }
 }
@@ -24,6 +24,10 @@ namespace Media {
 namespace Plugin {
 namespace HttpPlugin {
 namespace {
+constexpr uint64_t DEFAULT_MEDIA_SEQUENCE = 1;
+constexpr int64_t DEFAULT_RELOAD_INTERVAL_MS = 5000; // 5000: target duration not known yet
+constexpr double MS_PER_SECOND = 1000.0;
+
 bool StrHasPrefix(std::string& str, const std::string& prefix)
 {
     return str.find(prefix) == 0;
@@ -40,9 +44,16 @@ std::string UriJoin(std::string& baseUrl, const std::string& uri)
         return baseUrl.substr(0, pos + 1) + uri;
     }
 }
+
+// tags which only apply to the fragment following them
+bool IsFragmentTag(HlsTag tag)
+{
+    return tag == HlsTag::URI || tag == HlsTag::EXTINF || tag == HlsTag::EXTXBYTERANGE ||
+        tag == HlsTag::EXTXDISCONTINUITY || tag == HlsTag::EXTXPROGRAMDATETIME;
+}
 }
 
-M3U8Fragment::M3U8Fragment(std::string uri, std::string title, double duration, int sequence, bool discont)
+M3U8Fragment::M3U8Fragment(std::string uri, std::string title, double duration, uint64_t sequence, bool discont)
     : uri_(std::move(uri)), title_(std::move(title)), duration_(duration), sequence_(sequence), discont_(discont)
 {
 }
@@ -54,6 +65,7 @@ M3U8::M3U8(std::string uri, std::string name) : uri_(std::move(uri)), name_(std:
 
 bool M3U8::Update(std::string& playList)
 {
+    newFragments_ = 0;
     if (playList_ == playList) {
         MEDIA_LOG_I("playlist does not change ");
         return true;
@@ -66,19 +78,22 @@ bool M3U8::Update(std::string& playList)
         MEDIA_LOG_I("Not a media playlist, but a master playlist! " PUBLIC_LOG_S, playList.c_str());
         return false;
     }
-    files_.clear();
-    MEDIA_LOG_I("media playlist " PUBLIC_LOG_S, playList.c_str());
-    auto tags = ParseEntries(playList);
-    UpdateFromTags(tags);
-    tags.clear();
+    MEDIA_LOG_D("media playlist " PUBLIC_LOG_S, playList.c_str());
+    UpdateFromPlayList(playList);
     playList_ = playList;
     return true;
 }
 
 void M3U8::InitTagUpdatersMap()
 {
-    tagUpdatersMap_[HlsTag::EXTXPLAYLISTTYPE] = [this](std::shared_ptr<Tag> &tag, M3U8Info &info) {
-        bLive_ = !info.bVod && (std::static_pointer_cast<SingleValueTag>(tag)->GetValue().QuotedString() != "VOD");
+    tagUpdatersMap_[HlsTag::EXTXPLAYLISTTYPE] = [](std::shared_ptr<Tag> &tag, M3U8Info &info) {
+        if (std::static_pointer_cast<SingleValueTag>(tag)->GetValue().QuotedString() == "VOD") {
+            info.bVod = true;
+        }
+    };
+    tagUpdatersMap_[HlsTag::EXTXENDLIST] = [](std::shared_ptr<Tag> &tag, M3U8Info &info) {
+        std::ignore = tag;
+        info.bVod = true;
     };
 
     tagUpdatersMap_[HlsTag::EXTXTARGETDURATION] = [this](std::shared_ptr<Tag> &tag, M3U8Info &info) {
@@ -129,25 +144,54 @@ void M3U8::InitTagUpdatersMap()
     };
 }
 
-void M3U8::UpdateFromTags(std::list<std::shared_ptr<Tag>>& tags)
+// Fragments already in files_ are recognized by their media sequence number and skipped without building their
+// tags, so a live reload only costs a scan of the lines plus the parsing of the fragments it adds.
+void M3U8::UpdateFromPlayList(std::string_view playList)
 {
+    uint64_t nextSequence = files_.empty() ? 0 : files_.back()->sequence_ + 1;
+    bool firstFragment = true;
     M3U8Info info;
-    info.bVod = !tags.empty() && tags.back()->GetType() == HlsTag::EXTXENDLIST;
-    bLive_ = !info.bVod;
-    for (auto& tag : tags) {
-        HlsTag hlsTag = tag->GetType();
+    sequence_ = DEFAULT_MEDIA_SEQUENCE;
+    std::string_view line;
+    while (GetNextLine(playList, line)) {
+        HlsTag hlsTag = HlsTag::URI;
+        std::string_view value = line;
+        if (line.empty() || (line[0] == '#' && !ParseTagLine(line, hlsTag, value))) {
+            continue;
+        }
+        if (hlsTag == HlsTag::URI && firstFragment) {
+            firstFragment = false;
+            if (!files_.empty() && sequence_ < files_.front()->sequence_) {
+                MEDIA_LOG_I("media sequence restarted at " PUBLIC_LOG_U64, sequence_);
+                files_.clear();
+                nextSequence = 0;
+            }
+            while (!files_.empty() && files_.front()->sequence_ < sequence_) {
+                files_.pop_front();
+            }
+        }
+        if (sequence_ < nextSequence && IsFragmentTag(hlsTag)) {
+            if (hlsTag == HlsTag::URI) {
+                sequence_++;
+                info.title = "", info.duration = 0, info.discontinuity = false;
+            }
+            continue;
+        }
         auto iter = tagUpdatersMap_.find(hlsTag);
         if (iter != tagUpdatersMap_.end()) {
-            auto updater = iter->second;
-            updater(tag, info);
+            auto tag = TagFactory::CreateTag(hlsTag, value);
+            if (tag) {
+                iter->second(tag, info);
+            }
         }
-
         if (!info.uri.empty()) {
             files_.emplace_back(std::make_shared<M3U8Fragment>(info.uri, info.title, info.duration, sequence_++,
                                                                info.discontinuity));
+            newFragments_++;
             info.uri = "", info.title = "", info.duration = 0, info.discontinuity = false;
         }
     }
+    bLive_ = !info.bVod;
 }
 
 void M3U8::GetExtInf(const std::shared_ptr<Tag>& tag, double& duration, std::string& title) const
@@ -171,6 +215,16 @@ bool M3U8::IsLive() const
     return bLive_;
 }
 
+// RFC 8216 6.3.4: reload after the target duration, or after half of it when the last reload brought nothing new
+int64_t M3U8::GetReloadInterval() const
+{
+    if (targetDuration_ <= 0) {
+        return DEFAULT_RELOAD_INTERVAL_MS;
+    }
+    auto interval = static_cast<int64_t>(targetDuration_ * MS_PER_SECOND);
+    return newFragments_ > 0 ? interval : interval / 2; // 2: half of the target duration
+}
+
 M3U8VariantStream::M3U8VariantStream(std::string name, std::string uri, std::shared_ptr<M3U8> m3u8)
     : name_(std::move(name)), uri_(std::move(uri)), m3u8_(std::move(m3u8))
 {
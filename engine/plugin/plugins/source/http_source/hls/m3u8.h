@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <list>
 #include <unordered_map>
 #include <functional>
@@ -43,11 +44,11 @@ struct M3U8InitFile {
 };
 
 struct M3U8Fragment {
-    M3U8Fragment(std::string uri, std::string title, double duration, int sequence, bool discont);
+    M3U8Fragment(std::string uri, std::string title, double duration, uint64_t sequence, bool discont);
     std::string uri_;
     std::string title_;
     double duration_;
-    int64_t sequence_;
+    uint64_t sequence_;
     bool discont_ {false};
     std::string key_ {};
     int iv_[16] {0};
@@ -60,17 +61,18 @@ struct M3U8Info {
     std::string title;
     double duration = 0;
     bool discontinuity = false;
-    bool bVod;
+    bool bVod = false;
 };
 
 struct M3U8 {
     M3U8(std::string uri, std::string name);
     void InitTagUpdatersMap();
     bool Update(std::string& playList);
-    void UpdateFromTags(std::list<std::shared_ptr<Tag>>& tags);
+    void UpdateFromPlayList(std::string_view playList);
     void GetExtInf(const std::shared_ptr<Tag>& tag, double& duration, std::string& title) const;
     double GetDuration() const;
     bool IsLive() const;
+    int64_t GetReloadInterval() const;
 
     std::string uri_;
     std::string name_;
@@ -82,6 +84,7 @@ struct M3U8 {
     uint64_t sequence_ {1}; // default 1
     int discontSequence_ {0};
     std::string playList_;
+    uint32_t newFragments_ {0}; // fragments appended to files_ by the last update
 };
 
 struct M3U8Media {
@@ -56,6 +56,7 @@ bool HttpMediaDownloader::Open(const std::string& url)
         statusCallback_(status, downloader_, std::forward<decltype(request)>(request));
     };
     downloadRequest_ = std::make_shared<DownloadRequest>(url, saveData, realStatusCallback);
+    downloadRequest_->EnableCache();
     downloader_->Download(downloadRequest_, -1); // -1
     buffer_->SetMediaOffset(0);
     downloader_->Start();
@@ -163,6 +164,16 @@ bool HttpMediaDownloader::GetStartedStatus()
     return startedPlayStatus_;
 }
 
+size_t HttpMediaDownloader::GetBufferSize() const
+{
+    return buffer_->GetSize();
+}
+
+void HttpMediaDownloader::SetDownloadPaused(bool paused)
+{
+    downloader_->SetThrottled(paused);
+}
+
 bool HttpMediaDownloader::SaveData(uint8_t* data, uint32_t len)
 {
     FALSE_RETURN_V(buffer_->WriteBuffer(data, len), false);
@@ -42,6 +42,8 @@ public:
     void SetCallback(Callback* cb) override;
     void SetStatusCallback(StatusCallbackFunc cb) override;
     bool GetStartedStatus() override;
+    size_t GetBufferSize() const override;
+    void SetDownloadPaused(bool paused) override;
 
 private:
     bool SaveData(uint8_t* data, uint32_t len);
@@ -15,6 +15,7 @@
 #define HST_LOG_TAG "HttpSourcePlugin"
 
 #include "http_source_plugin.h"
+#include "download/http_cache.h"
 #include "download/http_curl_client.h"
 #include "foundation/log.h"
 #include "hls/hls_media_downloader.h"
@@ -117,6 +118,13 @@ Status HttpSourcePlugin::GetParameter(Tag tag, ValueType& value)
         case Tag::WATERLINE_HIGH:
             value = waterline_;
             return Status::OK;
+        case Tag::HTTP_CACHE_MEMORY_LIMIT:
+        case Tag::HTTP_CACHE_DISK_LIMIT:
+        case Tag::HTTP_CACHE_DISK_PATH:
+            return GetCacheLimit(tag, value);
+        case Tag::HTTP_CACHE_BYTES_SAVED:
+            value = HttpCache::GetInstance().GetStatistics().bytesSaved;
+            return Status::OK;
         default:
             return Status::ERROR_INVALID_PARAMETER;
     }
@@ -132,11 +140,55 @@ Status HttpSourcePlugin::SetParameter(Tag tag, const ValueType& value)
         case Tag::WATERLINE_HIGH:
             waterline_ = AnyCast<uint32_t>(value);
             return Status::OK;
+        case Tag::HTTP_CACHE_MEMORY_LIMIT:
+        case Tag::HTTP_CACHE_DISK_LIMIT:
+        case Tag::HTTP_CACHE_DISK_PATH:
+            return SetCacheLimit(tag, value);
         default:
             return Status::ERROR_INVALID_PARAMETER;
     }
 }
 
+// the cache is shared by the process, its limits are read and changed as a whole
+Status HttpSourcePlugin::GetCacheLimit(Tag tag, ValueType& value)
+{
+    size_t memoryLimit = 0;
+    size_t diskLimit = 0;
+    std::string diskPath;
+    HttpCache::GetInstance().GetLimits(memoryLimit, diskLimit, diskPath);
+    if (tag == Tag::HTTP_CACHE_DISK_PATH) {
+        value = diskPath;
+    } else {
+        value = static_cast<uint64_t>(tag == Tag::HTTP_CACHE_MEMORY_LIMIT ? memoryLimit : diskLimit);
+    }
+    return Status::OK;
+}
+
+Status HttpSourcePlugin::SetCacheLimit(Tag tag, const ValueType& value)
+{
+    size_t memoryLimit = 0;
+    size_t diskLimit = 0;
+    std::string diskPath;
+    auto& cache = HttpCache::GetInstance();
+    cache.GetLimits(memoryLimit, diskLimit, diskPath);
+    if (tag == Tag::HTTP_CACHE_DISK_PATH) {
+        FALSE_RETURN_V_MSG_E(Any::IsSameTypeWith<std::string>(value), Status::ERROR_MISMATCHED_TYPE,
+                             "http cache disk path should be string");
+        diskPath = AnyCast<std::string>(value);
+    } else {
+        FALSE_RETURN_V_MSG_E(Any::IsSameTypeWith<uint64_t>(value), Status::ERROR_MISMATCHED_TYPE,
+                             "http cache limit should be uint64_t");
+        auto limit = static_cast<size_t>(AnyCast<uint64_t>(value));
+        if (tag == Tag::HTTP_CACHE_MEMORY_LIMIT) {
+            memoryLimit = limit;
+        } else {
+            diskLimit = limit;
+        }
+    }
+    cache.SetLimits(memoryLimit, diskLimit, diskPath);
+    return Status::OK;
+}
+
 Status HttpSourcePlugin::SetCallback(Callback* cb)
 {
     MEDIA_LOG_D("SetCallback enter.");
@@ -248,6 +300,10 @@ void HttpSourcePlugin::CloseUri()
         MEDIA_LOG_D("Close uri");
         downloader_->Close(false);
         downloader_ = nullptr;
+        auto statistics = HttpCache::GetInstance().GetStatistics();
+        MEDIA_LOG_I("http cache hits " PUBLIC_LOG_U64 ", misses " PUBLIC_LOG_U64 ", bytes saved " PUBLIC_LOG_U64
+            ", memory " PUBLIC_LOG_U64 ", disk " PUBLIC_LOG_U64, statistics.hits, statistics.misses,
+            statistics.bytesSaved, statistics.memoryBytes, statistics.diskBytes);
     }
 }
 
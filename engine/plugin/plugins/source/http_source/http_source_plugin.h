@@ -51,6 +51,8 @@ public:
 
 private:
     void CloseUri();
+    Status GetCacheLimit(Tag tag, ValueType& value);
+    Status SetCacheLimit(Tag tag, const ValueType& value);
 
     uint32_t bufferSize_;
     uint32_t waterline_;
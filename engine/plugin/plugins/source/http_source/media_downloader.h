@@ -54,6 +54,15 @@ public:
     {
         return 0;
     }
+    // bytes downloaded and not read yet
+    virtual size_t GetBufferSize() const
+    {
+        return 0;
+    }
+    // hold back the network while far ahead of the reader, unlike Pause the buffered data can still be read
+    virtual void SetDownloadPaused(bool paused)
+    {
+    }
 };
 }
 }
@@ -16,6 +16,7 @@
 
 #include "download_monitor.h"
 #include "foundation/cpp_ext/algorithm_ext.h"
+#include "foundation/utils/steady_clock.h"
 
 namespace OHOS {
 namespace Media {
@@ -23,9 +24,17 @@ namespace Plugin {
 namespace HttpPlugin {
 namespace {
     constexpr int RETRY_TIMES_TO_REPORT_ERROR = 5;
+    constexpr int64_t READ_AHEAD_MIN_MS = 8000; // 8000: resume the download with 8s of media left at the latest
+    constexpr int64_t READ_AHEAD_MAX_MS = 20000; // 20000: pause the download with 20s of media buffered
 }
 DownloadMonitor::DownloadMonitor(std::shared_ptr<MediaDownloader> downloader) noexcept
-    : downloader_(std::move(downloader))
+    : DownloadMonitor(std::move(downloader), READ_AHEAD_MIN_MS, READ_AHEAD_MAX_MS)
+{
+}
+
+DownloadMonitor::DownloadMonitor(std::shared_ptr<MediaDownloader> downloader, int64_t readAheadMinMs,
+                                 int64_t readAheadMaxMs) noexcept
+    : downloader_(std::move(downloader)), readAhead_(readAheadMinMs, readAheadMaxMs)
 {
     auto statusCallback = [this] (DownloadStatus&& status, std::shared_ptr<Downloader>& downloader,
         std::shared_ptr<DownloadRequest>& request) {
@@ -45,6 +54,8 @@ void DownloadMonitor::HttpMonitorLoop()
         if ((lastReadTime_ != 0) && (nowTime - lastReadTime_ >= 60)) {  // 60
             MEDIA_LOG_D("HttpMonitorLoop : too long without reading data, paused");
             Pause();
+        } else {
+            UpdateReadAhead();
         }
     }
     RetryRequest task;
@@ -61,10 +72,29 @@ void DownloadMonitor::HttpMonitorLoop()
     OSAL::SleepFor(50); // 50
 }
 
+void DownloadMonitor::UpdateReadAhead()
+{
+    bool paused = !readAhead_.Update(downloader_->GetBufferSize(), SteadyClock::GetCurrentTimeMs());
+    if (paused != downloadPaused_) {
+        downloadPaused_ = paused;
+        downloader_->SetDownloadPaused(paused);
+    }
+}
+
+void DownloadMonitor::ResetReadAhead()
+{
+    readAhead_.Reset(SteadyClock::GetCurrentTimeMs());
+    if (downloadPaused_) {
+        downloadPaused_ = false;
+        downloader_->SetDownloadPaused(false);
+    }
+}
+
 bool DownloadMonitor::Open(const std::string& url)
 {
     isPlaying_ = true;
     retryTasks_.clear();
+    ResetReadAhead();
     return downloader_->Open(url);
 }
 
@@ -95,7 +125,10 @@ bool DownloadMonitor::Read(unsigned char *buff, unsigned int wantReadLength,
     if (!isPlaying_) {
         Resume();
     }
+    bool starved = downloader_->GetBufferSize() == 0;
+    int64_t startMs = SteadyClock::GetCurrentTimeMs();
     bool ret = downloader_->Read(buff, wantReadLength, realReadLength, isEos);
+    readAhead_.OnRead(realReadLength, starved, startMs, SteadyClock::GetCurrentTimeMs());
     time(&lastReadTime_);
     return ret;
 }
@@ -107,6 +140,7 @@ bool DownloadMonitor::SeekToPos(int64_t offset)
         OSAL::ScopedLock lock(taskMutex_);
         retryTasks_.clear();
     }
+    ResetReadAhead();
     return downloader_->SeekToPos(offset);
 }
 
@@ -132,6 +166,7 @@ bool DownloadMonitor::SeekToTime(int64_t offset)
         OSAL::ScopedLock lock(taskMutex_);
         retryTasks_.clear();
     }
+    ResetReadAhead();
     return downloader_->SeekToTime(offset);
 }
 
@@ -145,6 +180,16 @@ bool DownloadMonitor::SelectBitRate(uint32_t bitRate)
     return downloader_->SelectBitRate(bitRate);
 }
 
+size_t DownloadMonitor::GetBufferSize() const
+{
+    return downloader_->GetBufferSize();
+}
+
+void DownloadMonitor::SetReadAheadObserver(BufferSampleFunc onSample, RebufferFunc onRebuffer)
+{
+    readAhead_.SetObserver(std::move(onSample), std::move(onRebuffer));
+}
+
 void DownloadMonitor::SetCallback(Callback* cb)
 {
     callback_ = cb;
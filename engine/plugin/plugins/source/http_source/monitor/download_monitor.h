@@ -27,6 +27,7 @@
 #include "plugin/interface/plugin_base.h"
 #include "plugin/plugins/source/http_source/download/downloader.h"
 #include "plugin/plugins/source/http_source/media_downloader.h"
+#include "read_ahead_controller.h"
 
 namespace OHOS {
 namespace Media {
@@ -40,6 +41,9 @@ struct RetryRequest {
 class DownloadMonitor : public MediaDownloader {
 public:
     explicit DownloadMonitor(std::shared_ptr<MediaDownloader> downloader) noexcept;
+    // readAheadMinMs, readAheadMaxMs: media time buffered ahead of the reader, see ReadAheadController
+    DownloadMonitor(std::shared_ptr<MediaDownloader> downloader, int64_t readAheadMinMs,
+                    int64_t readAheadMaxMs) noexcept;
     ~DownloadMonitor() override = default;
     bool Open(const std::string& url) override;
     void Close(bool isAsync) override;
@@ -56,9 +60,13 @@ public:
     bool SeekToTime(int64_t offset) override;
     std::vector<uint32_t> GetBitRates() override;
     bool SelectBitRate(uint32_t bitRate) override;
+    size_t GetBufferSize() const override;
+    void SetReadAheadObserver(BufferSampleFunc onSample, RebufferFunc onRebuffer);
 
 private:
     void HttpMonitorLoop();
+    void UpdateReadAhead();
+    void ResetReadAhead();
     void OnDownloadStatus(std::shared_ptr<Downloader>& downloader, std::shared_ptr<DownloadRequest>& request);
     bool NeedRetry(const std::shared_ptr<DownloadRequest>& request);
 
@@ -69,6 +77,8 @@ private:
     time_t lastReadTime_ {0};
     Callback* callback_ {nullptr};
     OSAL::Mutex taskMutex_ {};
+    ReadAheadController readAhead_;
+    std::atomic<bool> downloadPaused_ {false};
 };
 }
 }
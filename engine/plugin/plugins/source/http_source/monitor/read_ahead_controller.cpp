@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define HST_LOG_TAG "ReadAheadController"
+
+#include "read_ahead_controller.h"
+#include <algorithm>
+#include "foundation/log.h"
+#include "foundation/osal/thread/scoped_lock.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace HttpPlugin {
+namespace {
+constexpr int64_t MS_PER_SECOND = 1000;
+constexpr int64_t RATE_WINDOW_MS = 1000; // 1000: rates are measured over windows of one second
+
+// moving average which follows a change of rate within a few windows
+uint64_t Smooth(uint64_t average, uint64_t sample)
+{
+    return average == 0 ? sample : (average * 7 + sample * 3) / 10; // 7, 3, 10: weights of the old and new rate
+}
+}
+
+ReadAheadController::ReadAheadController(int64_t minMs, int64_t maxMs) : minMs_(minMs), maxMs_(maxMs)
+{
+}
+
+void ReadAheadController::SetObserver(BufferSampleFunc onSample, RebufferFunc onRebuffer)
+{
+    OSAL::ScopedLock lock(mutex_);
+    onSample_ = std::move(onSample);
+    onRebuffer_ = std::move(onRebuffer);
+}
+
+void ReadAheadController::Reset(int64_t nowMs)
+{
+    OSAL::ScopedLock lock(mutex_);
+    downloading_ = true;
+    reading_ = false;
+    rebase_ = true;
+    networkWindowBytes_ = 0;
+    networkWindowMs_ = 0;
+    lastUpdateMs_ = nowMs;
+}
+
+void ReadAheadController::OnRead(size_t bytes, bool starved, int64_t startMs, int64_t endMs)
+{
+    RebufferFunc onRebuffer;
+    RebufferEvent event {startMs, endMs - startMs};
+    {
+        OSAL::ScopedLock lock(mutex_);
+        readBytes_ += bytes;
+        readWindowBytes_ += bytes;
+        if (bytes == 0) {
+            return;
+        }
+        if (starved && reading_) {
+            MEDIA_LOG_I("rebuffer for " PUBLIC_LOG_D64 " ms", event.durationMs);
+            onRebuffer = onRebuffer_;
+        }
+        reading_ = true;
+    }
+    if (onRebuffer) {
+        onRebuffer(event);
+    }
+}
+
+bool ReadAheadController::Update(size_t bufferedBytes, int64_t nowMs)
+{
+    BufferSampleFunc onSample;
+    BufferSample sample;
+    {
+        OSAL::ScopedLock lock(mutex_);
+        uint64_t received = readBytes_ + bufferedBytes;
+        if (rebase_) {
+            rebase_ = false;
+            readWindowStartMs_ = nowMs;
+            readWindowBytes_ = 0;
+        } else if (downloading_) {
+            networkWindowBytes_ += received > lastReceived_ ? received - lastReceived_ : 0;
+            networkWindowMs_ += nowMs - lastUpdateMs_;
+            if (networkWindowMs_ >= RATE_WINDOW_MS) {
+                networkRate_ = Smooth(networkRate_, networkWindowBytes_ * MS_PER_SECOND / networkWindowMs_);
+                networkWindowBytes_ = 0;
+                networkWindowMs_ = 0;
+            }
+        }
+        lastReceived_ = received;
+        lastUpdateMs_ = nowMs;
+        // a window without any read means playback is paused, the rate it had is kept
+        if (nowMs - readWindowStartMs_ >= RATE_WINDOW_MS) {
+            if (readWindowBytes_ > 0) {
+                readRate_ = Smooth(readRate_, readWindowBytes_ * MS_PER_SECOND / (nowMs - readWindowStartMs_));
+            }
+            readWindowStartMs_ = nowMs;
+            readWindowBytes_ = 0;
+        }
+        int64_t bufferedMs = readRate_ == 0 ? -1 : static_cast<int64_t>(bufferedBytes * MS_PER_SECOND / readRate_);
+        bool downloading = downloading_;
+        if (bufferedMs < 0) {
+            downloading = true;
+        } else if (downloading_ && bufferedMs >= maxMs_) {
+            downloading = false;
+        } else if (!downloading_ && bufferedMs <= GetResumeLevel()) {
+            downloading = true;
+        }
+        if (downloading != downloading_) {
+            MEDIA_LOG_D(PUBLIC_LOG_S " download, buffered " PUBLIC_LOG_D64 " ms, read rate " PUBLIC_LOG_U64
+                ", network rate " PUBLIC_LOG_U64, downloading ? "resume" : "pause", bufferedMs, readRate_,
+                networkRate_);
+            downloading_ = downloading;
+        }
+        sample = {nowMs, bufferedBytes, bufferedMs, readRate_, networkRate_, downloading_};
+        onSample = onSample_;
+    }
+    if (onSample) {
+        onSample(sample);
+    }
+    return sample.downloading;
+}
+
+// resume at minMs while the network is at least twice as fast as the player, closer to maxMs when it is slower
+int64_t ReadAheadController::GetResumeLevel() const
+{
+    if (networkRate_ == 0 || readRate_ == 0) {
+        return minMs_;
+    }
+    int64_t highest = maxMs_ - (maxMs_ - minMs_) / 4; // 4: keep a quarter of the range between pause and resume
+    if (networkRate_ <= readRate_) {
+        return highest;
+    }
+    uint64_t headroom = networkRate_ - readRate_;
+    if (headroom >= readRate_) {
+        return minMs_;
+    }
+    int64_t level = maxMs_ - static_cast<int64_t>(static_cast<uint64_t>(maxMs_ - minMs_) * headroom / readRate_);
+    return std::min(level, highest);
+}
+}
+}
+}
+}
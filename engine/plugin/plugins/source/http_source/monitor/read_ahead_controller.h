@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_READ_AHEAD_CONTROLLER_H
+#define HISTREAMER_READ_AHEAD_CONTROLLER_H
+
+#include <cstdint>
+#include <functional>
+#include "foundation/osal/thread/mutex.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugin {
+namespace HttpPlugin {
+struct BufferSample {
+    int64_t timeMs {0};
+    size_t bufferedBytes {0};
+    int64_t bufferedMs {-1};  // media time held in the buffer, -1 while the read rate is unknown
+    uint64_t readRate {0};    // bytes per second read by the player
+    uint64_t networkRate {0}; // bytes per second received while downloading
+    bool downloading {true};
+};
+
+struct RebufferEvent {
+    int64_t startMs {0};
+    int64_t durationMs {0};
+};
+
+using BufferSampleFunc = std::function<void(const BufferSample&)>;
+using RebufferFunc = std::function<void(const RebufferEvent&)>;
+
+/**
+ * Decides when the download may run ahead of the player.
+ *
+ * The buffer is sized in media time, from the rate the player reads at. After open and seek the download runs at
+ * full speed until maxMs are buffered, so the first frame is not held back by a rate that is not known yet. Above
+ * maxMs the download is paused, and it is resumed below a level between minMs and maxMs which rises as the network
+ * gets closer to the read rate, so that a slow network has time to refill the buffer.
+ */
+class ReadAheadController {
+public:
+    ReadAheadController(int64_t minMs, int64_t maxMs);
+    ~ReadAheadController() = default;
+
+    void SetObserver(BufferSampleFunc onSample, RebufferFunc onRebuffer);
+
+    /// open and seek, the buffer is empty again and has to be filled at full speed
+    void Reset(int64_t nowMs);
+
+    /// starved: the read found an empty buffer and waited for the network from startMs to endMs
+    void OnRead(size_t bytes, bool starved, int64_t startMs, int64_t endMs);
+
+    /// sample the buffer level, true if the download should run until the next update
+    bool Update(size_t bufferedBytes, int64_t nowMs);
+
+private:
+    int64_t GetResumeLevel() const;
+
+    const int64_t minMs_;
+    const int64_t maxMs_;
+    OSAL::Mutex mutex_ {};
+    BufferSampleFunc onSample_ {};
+    RebufferFunc onRebuffer_ {};
+    bool downloading_ {true};
+    bool reading_ {false}; // a read returned data since the last reset, later waits are rebuffers
+    bool rebase_ {true};   // the next update only takes the network baseline
+    uint64_t readBytes_ {0};
+    uint64_t readRate_ {0};
+    int64_t readWindowStartMs_ {0};
+    uint64_t readWindowBytes_ {0};
+    uint64_t networkRate_ {0};
+    uint64_t networkWindowBytes_ {0};
+    int64_t networkWindowMs_ {0};
+    uint64_t lastReceived_ {0};
+    int64_t lastUpdateMs_ {0};
+};
+}
+}
+}
+}
+#endif
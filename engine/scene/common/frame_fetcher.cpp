@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "FrameFetcher"
+
+#include "frame_fetcher.h"
+#include <algorithm>
+#include "foundation/log.h"
+#include "foundation/osal/thread/condition_variable.h"
+#include "foundation/osal/thread/scoped_lock.h"
+#include "foundation/osal/utils/util.h"
+#include "pipeline/core/compatible_check.h"
+#include "pipeline/filters/common/plugin_utils.h"
+#include "pipeline/filters/demux/type_finder.h"
+#include "plugin/common/media_source.h"
+#include "plugin/common/plugin_attr_desc.h"
+#include "plugin/common/plugin_time.h"
+#include "plugin/core/plugin_info.h"
+
+namespace OHOS {
+namespace Media {
+using namespace Plugin;
+
+namespace {
+constexpr int32_t DECODE_TIMEOUT_MS = 3000;
+constexpr size_t ROW_ALIGN = 64; // 64: covers the row alignment of the decoders and of simd scalers
+constexpr uint32_t RGBA_BYTES = 4;
+constexpr uint32_t RGB_BYTES = 3;
+
+const std::map<std::string, ProtocolType> PROTOCOL_TYPES = {
+    {"http", ProtocolType::HTTP},
+    {"https", ProtocolType::HTTPS},
+    {"file", ProtocolType::FILE},
+    {"fd", ProtocolType::FD},
+};
+
+size_t AlignUp(size_t value, size_t align)
+{
+    return (value + align - 1) / align * align;
+}
+
+bool IsProtocolSupported(const PluginInfo& info, ProtocolType protocol)
+{
+    auto ite = info.extra.find(PLUGIN_INFO_EXTRA_PROTOCOL);
+    if (ite == info.extra.end() || !Any::IsSameTypeWith<std::vector<ProtocolType>>(ite->second)) {
+        return false;
+    }
+    auto protocols = AnyCast<std::vector<ProtocolType>>(ite->second);
+    return std::find(protocols.begin(), protocols.end(), protocol) != protocols.end();
+}
+
+bool FindVideoTrack(const MediaInfoHelper& mediaInfo, Meta& videoMeta)
+{
+    for (const auto& trackMeta : mediaInfo.trackMeta) {
+        std::string mime;
+        if (trackMeta.Get<Tag::MIME>(mime) && mime.compare(0, 6, "video/") == 0) { // 6: length of "video/"
+            videoMeta = trackMeta;
+            return true;
+        }
+    }
+    return false;
+}
+
+void GetOutputSize(const Meta& videoMeta, const FrameFetchOptions& options, uint32_t& width, uint32_t& height)
+{
+    uint32_t videoWidth = 0;
+    uint32_t videoHeight = 0;
+    (void)videoMeta.Get<Tag::VIDEO_WIDTH>(videoWidth);
+    (void)videoMeta.Get<Tag::VIDEO_HEIGHT>(videoHeight);
+    width = options.width;
+    height = options.height;
+    if (width == 0 && height == 0) {
+        width = videoWidth;
+        height = videoHeight;
+    } else if (width == 0 && videoHeight != 0) {
+        width = std::max(static_cast<uint32_t>(static_cast<uint64_t>(videoWidth) * height / videoHeight), 1u);
+    } else if (height == 0 && videoWidth != 0) {
+        height = std::max(static_cast<uint32_t>(static_cast<uint64_t>(videoHeight) * width / videoWidth), 1u);
+    }
+}
+} // namespace
+
+class FrameFetcher::SourceReader : public DataSourceHelper {
+public:
+    explicit SourceReader(std::shared_ptr<Source> source) : source_(std::move(source)) {}
+
+    ErrorCode Open(const std::string& uri)
+    {
+        FAIL_RETURN(Pipeline::TranslatePluginStatus(source_->SetSource(std::make_shared<MediaSource>(uri))));
+        FAIL_RETURN(Pipeline::TranslatePluginStatus(source_->Prepare()));
+        FAIL_RETURN(Pipeline::TranslatePluginStatus(source_->Start()));
+        FALSE_RETURN_V_MSG_E(source_->GetSeekable() == Seekable::SEEKABLE, ErrorCode::ERROR_INVALID_OPERATION,
+                             "source of " PUBLIC_LOG_S " is not seekable", uri.c_str());
+        if (source_->GetSize(size_) != Status::OK) {
+            size_ = 0;
+        }
+        return ErrorCode::SUCCESS;
+    }
+
+    /// closes the file, the pooled source is opened again by the next fetch
+    void Close()
+    {
+        (void)source_->Stop();
+        (void)source_->Reset();
+    }
+
+    Status ReadAt(int64_t offset, std::shared_ptr<Buffer>& buffer, size_t expectedLen) override
+    {
+        if (offset < 0 || (size_ > 0 && static_cast<uint64_t>(offset) >= size_)) {
+            return Status::END_OF_STREAM;
+        }
+        if (static_cast<uint64_t>(offset) != position_) {
+            auto ret = source_->SeekToPos(offset);
+            FALSE_RETURN_V_MSG_E(ret == Status::OK, ret, "seek source to " PUBLIC_LOG_D64 " failed", offset);
+            position_ = static_cast<uint64_t>(offset);
+        }
+        auto ret = source_->Read(buffer, expectedLen);
+        if (ret == Status::OK && buffer != nullptr && buffer->GetMemory() != nullptr) {
+            position_ += buffer->GetMemory()->GetSize();
+        }
+        return ret;
+    }
+
+    Status GetSize(uint64_t& size) override
+    {
+        size = size_;
+        return (size_ > 0) ? Status::OK : Status::ERROR_UNKNOWN;
+    }
+
+    Seekable GetSeekable() override
+    {
+        return source_->GetSeekable();
+    }
+
+private:
+    std::shared_ptr<Source> source_;
+    uint64_t size_ {0};
+    uint64_t position_ {0};
+};
+
+class FrameFetcher::DecodeCallback : public DataCallbackHelper {
+public:
+    void OnInputBufferDone(const std::shared_ptr<Buffer>& input) override
+    {
+        (void)input;
+    }
+
+    void OnOutputBufferDone(const std::shared_ptr<Buffer>& output) override
+    {
+        OSAL::ScopedLock lock(mutex_);
+        output_ = output;
+        cond_.NotifyAll();
+    }
+
+    void Reset()
+    {
+        OSAL::ScopedLock lock(mutex_);
+        output_.reset();
+    }
+
+    std::shared_ptr<Buffer> WaitOutput(int32_t timeoutMs)
+    {
+        OSAL::ScopedLock lock(mutex_);
+        (void)cond_.WaitFor(lock, timeoutMs, [this] { return output_ != nullptr; });
+        return output_;
+    }
+
+private:
+    OSAL::Mutex mutex_ {};
+    OSAL::ConditionVariable cond_ {};
+    std::shared_ptr<Buffer> output_ {};
+};
+
+FrameFetcher::~FrameFetcher()
+{
+    ReleasePlugins();
+}
+
+size_t FrameFetcher::GetFrameCapacity(uint32_t width, uint32_t height, VideoPixelFormat pixelFormat)
+{
+    size_t lumaStride = AlignUp(width, ROW_ALIGN);
+    size_t chromaHeight = (height + 1) / 2; // 2: chroma is subsampled
+    switch (pixelFormat) {
+        case VideoPixelFormat::YUV420P:
+            return lumaStride * height + AlignUp((width + 1) / 2, ROW_ALIGN) * chromaHeight * 2; // 2: u and v planes
+        case VideoPixelFormat::NV12:
+        case VideoPixelFormat::NV21:
+            return lumaStride * height + AlignUp(width + 1, ROW_ALIGN) * chromaHeight;
+        case VideoPixelFormat::RGB24:
+        case VideoPixelFormat::BGR24:
+            return AlignUp(static_cast<size_t>(width) * RGB_BYTES, ROW_ALIGN) * height;
+        case VideoPixelFormat::RGBA:
+        case VideoPixelFormat::ARGB:
+        case VideoPixelFormat::ABGR:
+        case VideoPixelFormat::BGRA:
+            return AlignUp(static_cast<size_t>(width) * RGBA_BYTES, ROW_ALIGN) * height;
+        default:
+            return 0;
+    }
+}
+
+ErrorCode FrameFetcher::FetchFrame(const std::string& uri, const FrameFetchOptions& options, uint8_t* data,
+                                   size_t capacity, FetchedFrame& frame)
+{
+    FALSE_RETURN_V_MSG_E(data != nullptr && capacity > 0, ErrorCode::ERROR_INVALID_PARAMETER_VALUE,
+                         "no memory to fetch the frame into");
+    OSAL::ScopedLock lock(mutex_);
+    std::shared_ptr<SourceReader> reader;
+    auto ret = OpenSource(uri, reader);
+    std::shared_ptr<Demuxer> demuxer;
+    Meta videoMeta;
+    if (ret == ErrorCode::SUCCESS) {
+        ret = OpenDemuxer(uri, reader, demuxer, videoMeta);
+    }
+    std::shared_ptr<Buffer> packet;
+    if (ret == ErrorCode::SUCCESS) {
+        ret = ReadSyncFrame(*demuxer, videoMeta, options.timeMs, packet);
+    }
+    std::shared_ptr<Codec> decoder;
+    if (ret == ErrorCode::SUCCESS) {
+        ret = StartDecoder(videoMeta, options, decoder);
+    }
+    if (ret == ErrorCode::SUCCESS) {
+        ret = DecodeFrame(*decoder, packet, data, capacity, frame);
+    }
+    // the decoder drops the caller's memory before returning, demuxer and source let go of the file
+    if (decoder != nullptr) {
+        (void)decoder->Stop();
+        (void)decoder->Reset();
+    }
+    if (demuxer != nullptr) {
+        (void)demuxer->Reset();
+    }
+    if (reader != nullptr) {
+        reader->Close();
+    }
+    MEDIA_LOG_I("fetch frame at " PUBLIC_LOG_D64 " ms of " PUBLIC_LOG_S " ret: " PUBLIC_LOG_S, options.timeMs,
+                uri.c_str(), GetErrorName(ret));
+    return ret;
+}
+
+void FrameFetcher::ReleasePlugins()
+{
+    OSAL::ScopedLock lock(mutex_);
+    for (const auto& decoder : decoders_) {
+        (void)decoder.second->Deinit();
+    }
+    for (const auto& demuxer : demuxers_) {
+        (void)demuxer.second->Deinit();
+    }
+    for (const auto& source : sources_) {
+        (void)source.second->Deinit();
+    }
+    decoders_.clear();
+    demuxers_.clear();
+    sources_.clear();
+}
+
+ErrorCode FrameFetcher::OpenSource(const std::string& uri, std::shared_ptr<SourceReader>& reader)
+{
+    std::string protocol = "file";
+    std::string sourceUri = uri;
+    auto pos = uri.find("://");
+    if (pos != std::string::npos) {
+        protocol = uri.substr(0, pos);
+    } else {
+        FALSE_RETURN_V_MSG_E(OSAL::ConvertFullPath(uri, sourceUri), ErrorCode::ERROR_INVALID_PARAMETER_VALUE,
+                             "invalid path " PUBLIC_LOG_S, uri.c_str());
+    }
+    auto protocolType = PROTOCOL_TYPES.find(protocol);
+    FALSE_RETURN_V_MSG_E(protocolType != PROTOCOL_TYPES.end(), ErrorCode::ERROR_UNSUPPORTED_FORMAT,
+                         "unsupported protocol " PUBLIC_LOG_S, protocol.c_str());
+    auto& manager = PluginManager::Instance();
+    std::shared_ptr<Source> source;
+    for (const auto& name : manager.ListPlugins(PluginType::SOURCE)) {
+        auto info = manager.GetPluginInfo(PluginType::SOURCE, name);
+        if (info == nullptr || !IsProtocolSupported(*info, protocolType->second)) {
+            continue;
+        }
+        auto ite = sources_.find(name);
+        if (ite != sources_.end()) {
+            source = ite->second;
+            break;
+        }
+        source = manager.CreateSourcePlugin(name);
+        if (source != nullptr && source->Init() == Status::OK) {
+            sources_[name] = source;
+            break;
+        }
+        source.reset();
+    }
+    FALSE_RETURN_V_MSG_E(source != nullptr, ErrorCode::ERROR_UNSUPPORTED_FORMAT,
+                         "no source plugin for " PUBLIC_LOG_S, protocol.c_str());
+    reader = std::make_shared<SourceReader>(source);
+    return reader->Open(sourceUri);
+}
+
+ErrorCode FrameFetcher::OpenDemuxer(const std::string& uri, const std::shared_ptr<SourceReader>& reader,
+                                    std::shared_ptr<Demuxer>& demuxer, Meta& videoMeta)
+{
+    uint64_t size = 0;
+    (void)reader->GetSize(size);
+    auto typeFinder = std::make_shared<Pipeline::TypeFinder>();
+    typeFinder->Init(uri, size, [size](uint64_t offset, size_t) { return size == 0 || offset < size; },
+                     [reader](uint64_t offset, size_t len, AVBufferPtr& buffer) {
+                         return reader->ReadAt(static_cast<int64_t>(offset), buffer, len) == Status::OK;
+                     });
+    auto name = typeFinder->FindMediaType();
+    FALSE_RETURN_V_MSG_E(!name.empty(), ErrorCode::ERROR_UNSUPPORTED_FORMAT,
+                         "no demuxer for " PUBLIC_LOG_S, uri.c_str());
+    auto ite = demuxers_.find(name);
+    if (ite != demuxers_.end() && ite->second->Reset() == Status::OK) {
+        demuxer = ite->second;
+    } else {
+        demuxer = PluginManager::Instance().CreateDemuxerPlugin(name);
+        FALSE_RETURN_V_MSG_E(demuxer != nullptr && demuxer->Init() == Status::OK, ErrorCode::ERROR_UNKNOWN,
+                             "create demuxer " PUBLIC_LOG_S " failed", name.c_str());
+        demuxers_[name] = demuxer;
+    }
+    (void)demuxer->SetParameter(Tag::MEDIA_FILE_URI, uri); // lets the plugin find the seek index of the file
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(demuxer->SetDataSource(reader)));
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(demuxer->Prepare()));
+    MediaInfoHelper mediaInfo;
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(demuxer->GetMediaInfo(mediaInfo)));
+    FALSE_RETURN_V_MSG_E(FindVideoTrack(mediaInfo, videoMeta), ErrorCode::ERROR_UNSUPPORTED_FORMAT,
+                         "no video track in " PUBLIC_LOG_S, uri.c_str());
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode FrameFetcher::ReadSyncFrame(Demuxer& demuxer, const Meta& videoMeta, int64_t timeMs,
+                                      std::shared_ptr<Buffer>& packet)
+{
+    uint32_t trackId = 0;
+    FALSE_RETURN_V_MSG_E(videoMeta.Get<Tag::TRACK_ID>(trackId), ErrorCode::ERROR_UNSUPPORTED_FORMAT,
+                         "video track has no id");
+    int64_t seekTime = 0;
+    FALSE_RETURN_V(Ms2HstTime(std::max<int64_t>(timeMs, 0), seekTime), ErrorCode::ERROR_INVALID_PARAMETER_VALUE);
+    int64_t realSeekTime = 0;
+    auto ret = demuxer.SeekTo(static_cast<int32_t>(trackId), seekTime, SeekMode::SEEK_PREVIOUS_SYNC, realSeekTime);
+    // the demuxer starts at the first frame anyway, a stream without index may only fail to seek there
+    FALSE_RETURN_V_MSG_E(ret == Status::OK || seekTime == 0, Pipeline::TranslatePluginStatus(ret),
+                         "seek to " PUBLIC_LOG_D64 " ms failed", timeMs);
+    while (true) {
+        packet = std::make_shared<Buffer>();
+        ret = demuxer.ReadFrame(*packet, 0);
+        FALSE_RETURN_V_MSG_E(ret == Status::OK, Pipeline::TranslatePluginStatus(ret),
+                             "no video frame at " PUBLIC_LOG_D64 " ms", timeMs);
+        if (packet->trackID == trackId) {
+            return ErrorCode::SUCCESS;
+        }
+    }
+}
+
+ErrorCode FrameFetcher::StartDecoder(const Meta& videoMeta, const FrameFetchOptions& options,
+                                     std::shared_ptr<Codec>& decoder)
+{
+    auto capability = Pipeline::MetaToCapability(videoMeta);
+    FALSE_RETURN_V(capability != nullptr, ErrorCode::ERROR_UNSUPPORTED_FORMAT);
+    // software decoders write into the caller's memory, hardware ones into their own surfaces
+    auto candidates = Pipeline::FindAvailablePlugins(*capability, PluginType::VIDEO_DECODER, CodecMode::SOFTWARE);
+    FALSE_RETURN_V_MSG_E(!candidates.empty(), ErrorCode::ERROR_UNSUPPORTED_FORMAT,
+                         "no decoder for " PUBLIC_LOG_S, capability->mime.c_str());
+    const auto& name = candidates.front().first->name;
+    auto ite = decoders_.find(name);
+    if (ite != decoders_.end()) {
+        decoder = ite->second;
+    } else {
+        decoder = PluginManager::Instance().CreateCodecPlugin(name, PluginType::VIDEO_DECODER);
+        FALSE_RETURN_V_MSG_E(decoder != nullptr && decoder->Init() == Status::OK, ErrorCode::ERROR_UNKNOWN,
+                             "create decoder " PUBLIC_LOG_S " failed", name.c_str());
+        decoders_[name] = decoder;
+    }
+    std::vector<Tag> keys;
+    videoMeta.GetKeys(keys);
+    for (auto key : keys) {
+        ValueType value;
+        if (videoMeta.GetData(key, value) && decoder->SetParameter(key, value) != Status::OK) {
+            MEDIA_LOG_W("decoder " PUBLIC_LOG_S " ignores " PUBLIC_LOG_S, name.c_str(), GetTagStrName(key));
+        }
+    }
+    // the decoder scales and converts to these while it writes the frame, a downscale costs no extra pass
+    uint32_t width = 0;
+    uint32_t height = 0;
+    GetOutputSize(videoMeta, options, width, height);
+    FALSE_RETURN_V_MSG_E(width > 0 && height > 0, ErrorCode::ERROR_INVALID_PARAMETER_VALUE, "no output size");
+    (void)decoder->SetParameter(Tag::VIDEO_WIDTH, width);
+    (void)decoder->SetParameter(Tag::VIDEO_HEIGHT, height);
+    (void)decoder->SetParameter(Tag::VIDEO_PIXEL_FORMAT, options.pixelFormat);
+    (void)decoder->SetParameter(Tag::OUTPUT_MEMORY_TYPE, Plugin::MemoryType::VIRTUAL_ADDR);
+    if (decodeCallback_ == nullptr) {
+        decodeCallback_ = std::make_shared<DecodeCallback>();
+    }
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(decoder->SetDataCallback(decodeCallback_.get())));
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(decoder->Prepare()));
+    return Pipeline::TranslatePluginStatus(decoder->Start());
+}
+
+ErrorCode FrameFetcher::DecodeFrame(Codec& decoder, const std::shared_ptr<Buffer>& packet, uint8_t* data,
+                                    size_t capacity, FetchedFrame& frame)
+{
+    auto output = std::make_shared<Buffer>(BufferMetaType::VIDEO);
+    (void)output->WrapMemory(data, capacity, 0);
+    decodeCallback_->Reset();
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(decoder.QueueOutputBuffer(output, 0)));
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(decoder.QueueInputBuffer(packet, 0)));
+    // draining right after the sync frame outputs it without reading or decoding any other frame
+    auto eos = std::make_shared<Buffer>();
+    eos->flag |= BUFFER_FLAG_EOS;
+    FAIL_RETURN(Pipeline::TranslatePluginStatus(decoder.QueueInputBuffer(eos, 0)));
+    auto decoded = decodeCallback_->WaitOutput(DECODE_TIMEOUT_MS);
+    FALSE_RETURN_V_MSG_E(decoded != nullptr, ErrorCode::ERROR_TIMED_OUT, "decode frame timeout");
+    FALSE_RETURN_V_MSG_E((decoded->flag & BUFFER_FLAG_EOS) == 0, ErrorCode::ERROR_NO_MEMORY,
+                         "no frame decoded, capacity " PUBLIC_LOG_ZU " may be too small", capacity);
+    auto bufferMeta = decoded->GetBufferMeta();
+    FALSE_RETURN_V(bufferMeta != nullptr && bufferMeta->GetType() == BufferMetaType::VIDEO, ErrorCode::ERROR_UNKNOWN);
+    auto videoMeta = ReinterpretPointerCast<VideoBufferMeta>(bufferMeta);
+    frame.ptsMs = HstTime2Ms(static_cast<int64_t>(decoded->pts));
+    frame.width = videoMeta->width;
+    frame.height = videoMeta->height;
+    frame.pixelFormat = videoMeta->videoPixelFormat;
+    frame.stride = videoMeta->stride;
+    frame.size = decoded->GetMemory()->GetSize();
+    return ErrorCode::SUCCESS;
+}
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_SCENE_FRAME_FETCHER_H
+#define HISTREAMER_SCENE_FRAME_FETCHER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "foundation/osal/thread/mutex.h"
+#include "pipeline/core/error_code.h"
+#include "plugin/common/plugin_meta.h"
+#include "plugin/common/plugin_video_tags.h"
+#include "plugin/core/plugin_manager.h"
+
+namespace OHOS {
+namespace Media {
+struct FrameFetchOptions {
+    int64_t timeMs {0};     // the sync frame at or before this time is fetched
+    uint32_t width {0};     // 0 keeps the width of the video, or follows the aspect ratio if only height is set
+    uint32_t height {0};    // 0 keeps the height of the video, or follows the aspect ratio if only width is set
+    Plugin::VideoPixelFormat pixelFormat {Plugin::VideoPixelFormat::RGBA};
+};
+
+struct FetchedFrame {
+    int64_t ptsMs {0};
+    uint32_t width {0};
+    uint32_t height {0};
+    Plugin::VideoPixelFormat pixelFormat {Plugin::VideoPixelFormat::UNKNOWN};
+    std::vector<uint32_t> stride {}; // bytes per row of each plane
+    size_t size {0};                 // bytes written to the caller's memory
+};
+
+/**
+ * Headless extraction of single video frames, for thumbnails and metadata, without a pipeline.
+ *
+ * A fetch drives the source, demuxer and video decoder plugins directly: it seeks the demuxer to the sync frame at or
+ * before the requested time, hands that one packet to the decoder and drains it, so exactly one frame is decoded. The
+ * decoder scales the frame to the requested size while converting it, into the memory supplied by the caller. Plugin
+ * instances are kept per plugin name and reused by later fetches, which keeps batch extraction across files from
+ * creating and initializing plugins for every file. Fetches are serialized, use one fetcher per thread to run them in
+ * parallel.
+ */
+class FrameFetcher {
+public:
+    FrameFetcher() = default;
+    ~FrameFetcher();
+    FrameFetcher(const FrameFetcher&) = delete;
+    FrameFetcher& operator=(const FrameFetcher&) = delete;
+
+    /// bytes that are enough for a frame of this size and format whatever rows the decoder aligns to
+    static size_t GetFrameCapacity(uint32_t width, uint32_t height, Plugin::VideoPixelFormat pixelFormat);
+
+    /// decode the frame chosen by options of the video of uri into the capacity bytes at data
+    ErrorCode FetchFrame(const std::string& uri, const FrameFetchOptions& options, uint8_t* data, size_t capacity,
+                         FetchedFrame& frame);
+
+    /// deinit and drop the pooled plugin instances
+    void ReleasePlugins();
+
+private:
+    class SourceReader;
+    class DecodeCallback;
+
+    ErrorCode OpenSource(const std::string& uri, std::shared_ptr<SourceReader>& reader);
+    ErrorCode OpenDemuxer(const std::string& uri, const std::shared_ptr<SourceReader>& reader,
+                          std::shared_ptr<Plugin::Demuxer>& demuxer, Plugin::Meta& videoMeta);
+    ErrorCode ReadSyncFrame(Plugin::Demuxer& demuxer, const Plugin::Meta& videoMeta, int64_t timeMs,
+                            std::shared_ptr<Plugin::Buffer>& packet);
+    ErrorCode StartDecoder(const Plugin::Meta& videoMeta, const FrameFetchOptions& options,
+                           std::shared_ptr<Plugin::Codec>& decoder);
+    ErrorCode DecodeFrame(Plugin::Codec& decoder, const std::shared_ptr<Plugin::Buffer>& packet, uint8_t* data,
+                          size_t capacity, FetchedFrame& frame);
+
+    OSAL::Mutex mutex_ {};
+    std::map<std::string, std::shared_ptr<Plugin::Source>> sources_ {};
+    std::map<std::string, std::shared_ptr<Plugin::Demuxer>> demuxers_ {};
+    std::map<std::string, std::shared_ptr<Plugin::Codec>> decoders_ {};
+    std::shared_ptr<DecodeCallback> decodeCallback_ {};
+};
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_SCENE_FRAME_FETCHER_H
@@ -398,7 +398,15 @@ ErrorCode HiPlayerImpl::DoSeek(int64_t hstTime, Plugin::SeekMode mode, bool appT
         int64_t realSeekTime = hstTime;
         rtv = demuxer_->SeekTo(hstTime, mode, realSeekTime);
         if (rtv == ErrorCode::SUCCESS) {
-            syncManager_->Seek(realSeekTime);
+            // decoding restarts at the gop start, an accurate seek resumes playing at the target itself
+            bool accurate = mode == Plugin::SeekMode::SEEK_CLOSEST && realSeekTime < hstTime;
+#ifdef VIDEO_SUPPORT
+            if (videoDecoder) {
+                (void)videoDecoder->SetParameter(static_cast<int32_t>(Plugin::Tag::MEDIA_SEEK_TARGET),
+                                                 accurate ? hstTime : HST_TIME_NONE);
+            }
+#endif
+            syncManager_->Seek(accurate ? hstTime : realSeekTime);
         }
         PROFILE_END("SeekTo");
 
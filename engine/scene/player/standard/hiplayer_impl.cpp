@@ -81,6 +81,8 @@ HiPlayerImpl::HiPlayerImpl(int32_t appUid, int32_t appPid)
     audioSink_->SetSyncCenter(syncManager_);
     pipeline_ = std::make_shared<PipelineCore>();
     callbackLooper_.SetPlayEngine(this);
+    spliceTask_ = std::make_shared<OSAL::Task>("spliceThread", OSAL::ThreadPriority::NORMAL);
+    spliceTask_->RegisterHandler([this] { SpliceNextItem(); });
 }
 
 HiPlayerImpl::~HiPlayerImpl()
@@ -90,6 +92,7 @@ HiPlayerImpl::~HiPlayerImpl()
         DoStop();
         HiPlayerImpl::OnStateChanged(StateId::STOPPED);
     }
+    spliceTask_->Stop();
     callbackLooper_.Stop();
     audioSink_.reset();
 #ifdef VIDEO_SUPPORT
@@ -530,6 +533,10 @@ void HiPlayerImpl::OnEvent(const Event& event)
     }
     switch (event.type) {
         case EventType::EVENT_ERROR: {
+            if (IsNextItemFilter(event.srcFilter)) {
+                MEDIA_LOG_W("next item failed in " PUBLIC_LOG_S ", the current one completes", event.srcFilter.c_str());
+                break;
+            }
             HandleErrorEvent(event);
             break;
         }
@@ -563,6 +570,10 @@ void HiPlayerImpl::OnEvent(const Event& event)
             callbackLooper_.OnInfo(INFO_TYPE_IS_LIVE_STREAM, 0, format);
             break;
         }
+        case EventType::EVENT_AUDIO_SPLICED: {
+            HandleAudioSplicedEvent(event);
+            break;
+        }
         default:
             MEDIA_LOG_E("Unknown event(" PUBLIC_LOG_U32 ")", event.type);
     }
@@ -624,8 +635,17 @@ ErrorCode HiPlayerImpl::DoStop()
     if (demuxer_) {
         demuxer_->StopTask(false);
     }
+    // a splice in progress completes first, one which is pending is dropped with the next item
+    spliceTask_->Pause();
+    {
+        OSAL::ScopedLock lock(nextItemMutex_);
+        splicePending_ = false;
+    }
+    CancelNextItem();
+    ReleaseRetiredItem();
     auto ret = pipeline_->Stop();
     syncManager_->Reset();
+    itemOffset_ = 0;
     if (ret != ErrorCode::SUCCESS) {
         UpdateStateNoLock(PlayerStates::PLAYER_STATE_ERROR);
     }
@@ -657,7 +677,15 @@ ErrorCode HiPlayerImpl::DoSeek(int64_t hstTime, Plugin::SeekMode mode)
             rtv = demuxer_->SeekTo(seekTime, seekMode, realSeekTime);
         }
         if (rtv == ErrorCode::SUCCESS) {
-            syncManager_->Seek(realSeekTime);
+            // decoding restarts at the gop start, an accurate seek resumes playing at the target itself
+            bool accurate = seekMode == Plugin::SeekMode::SEEK_CLOSEST && realSeekTime < seekTime;
+#ifdef VIDEO_SUPPORT
+            if (videoDecoder_) {
+                (void)videoDecoder_->SetParameter(static_cast<int32_t>(Plugin::Tag::MEDIA_SEEK_TARGET),
+                                                  accurate ? seekTime : HST_TIME_NONE);
+            }
+#endif
+            syncManager_->Seek((accurate ? seekTime : realSeekTime) + itemOffset_.load());
         }
         PROFILE_END("SeekTo");
 
@@ -828,7 +856,8 @@ int32_t HiPlayerImpl::Reset()
 
 int32_t HiPlayerImpl::GetCurrentTime(int32_t& currentPositionMs)
 {
-    currentPositionMs = Plugin::HstTime2Ms(syncManager_->GetMediaTimeNow());
+    // items spliced in gaplessly play on the timeline of the first one
+    currentPositionMs = Plugin::HstTime2Ms(std::max<int64_t>(syncManager_->GetMediaTimeNow() - itemOffset_, 0));
     return TransErrorCode(ErrorCode::SUCCESS);
 }
 
@@ -916,6 +945,9 @@ ErrorCode HiPlayerImpl::NewAudioPortFound(Filter* filter, const Plugin::Any& par
     }
     ErrorCode rtv = ErrorCode::ERROR_INVALID_PARAMETER_VALUE;
     auto param = Plugin::AnyCast<PortInfo>(parameter);
+    if (filter != demuxer_.get() && param.type == PortType::OUT) {
+        return NextAudioPortFound(filter, param);
+    }
     if (filter == demuxer_.get() && param.type == PortType::OUT) {
         MEDIA_LOG_I("new port found on demuxer " PUBLIC_LOG_ZU, param.ports.size());
         for (const auto& portDesc : param.ports) {
@@ -926,14 +958,14 @@ ErrorCode HiPlayerImpl::NewAudioPortFound(Filter* filter, const Plugin::Any& par
             auto fromPort = filter->GetOutPort(portDesc.name);
             if (portDesc.isPcm) {
                 pipeline_->AddFilters({audioSink_.get()});
-                FAIL_LOG(pipeline_->LinkPorts(fromPort, audioSink_->GetInPort(PORT_NAME_DEFAULT)));
+                FAIL_LOG(pipeline_->LinkPorts(fromPort, audioSink_->GetActiveInPort()));
                 ActiveFilters({audioSink_.get()});
             } else {
                 auto newAudioDecoder = CreateAudioDecoder(portDesc.name);
                 pipeline_->AddFilters({newAudioDecoder.get(), audioSink_.get()});
                 FAIL_LOG(pipeline_->LinkPorts(fromPort, newAudioDecoder->GetInPort(PORT_NAME_DEFAULT)));
                 FAIL_LOG(pipeline_->LinkPorts(newAudioDecoder->GetOutPort(PORT_NAME_DEFAULT),
-                                              audioSink_->GetInPort(PORT_NAME_DEFAULT)));
+                                              audioSink_->GetActiveInPort()));
                 ActiveFilters({newAudioDecoder.get(), audioSink_.get()});
             }
             mediaStats_.Append(audioSink_->GetName());
@@ -1144,5 +1176,231 @@ void HiPlayerImpl::HandlePluginEvent(const Event& event)
             break;
     }
 }
+
+int32_t HiPlayerImpl::SetNextSource(const std::string& uri)
+{
+    MEDIA_LOG_I("SetNextSource entered source uri: " PUBLIC_LOG_S, uri.c_str());
+    auto state = pipelineStates_.load();
+    if (state != PlayerStates::PLAYER_PREPARED && state != PlayerStates::PLAYER_STARTED &&
+        state != PlayerStates::PLAYER_PAUSED) {
+        MEDIA_LOG_E("SetNextSource in invalid state " PUBLIC_LOG_S, StringnessPlayerState(state).c_str());
+        return TransErrorCode(ErrorCode::ERROR_INVALID_STATE);
+    }
+    // an item the audio sink spliced in already is swapped in first, it is not the next one anymore
+    OSAL::ScopedLock stateLock(stateMutex_);
+    SwapInSplicedItem();
+    std::string mime;
+    for (const auto& trackInfo : demuxer_->GetStreamMetaInfo()) {
+        if (trackInfo->Get<Plugin::Tag::MIME>(mime) && IsVideoMime(mime)) {
+            MEDIA_LOG_E("gapless playback splices audio only, the current item has video");
+            return TransErrorCode(ErrorCode::ERROR_UNIMPLEMENTED);
+        }
+    }
+    CancelNextItem();
+    ReleaseRetiredItem();
+    auto index = std::to_string(++itemCount_);
+    auto source = FilterFactory::Instance().CreateFilterWithType<MediaSourceFilter>("builtin.player.mediasource",
+                                                                                     "mediaSource-" + index);
+    auto demuxer =
+        FilterFactory::Instance().CreateFilterWithType<DemuxerFilter>("builtin.player.demuxer", "demuxer-" + index);
+    if (source == nullptr || demuxer == nullptr) {
+        return TransErrorCode(ErrorCode::ERROR_NO_MEMORY);
+    }
+    // initialized by the pipeline to be linked to the audio sink, but left out of it until the item is spliced in
+    pipeline_->InitStandbyFilters({source.get(), demuxer.get()});
+    {
+        OSAL::ScopedLock lock(nextItemMutex_);
+        nextUrl_ = uri;
+        nextSource_ = source;
+        nextDemuxer_ = demuxer;
+        nextItemSetMs_ = SteadyClock::GetCurrentTimeMs();
+    }
+    audioSink_->SetSpliceEnabled(true);
+    auto ret = pipeline_->LinkFilters({source.get(), demuxer.get()});
+    if (ret == ErrorCode::SUCCESS) {
+        ret = source->SetSource(std::make_shared<MediaSource>(uri));
+    }
+    if (ret != ErrorCode::SUCCESS) {
+        MEDIA_LOG_E("SetNextSource error: " PUBLIC_LOG_S, GetErrorName(ret));
+        CancelNextItem();
+        return TransErrorCode(ret);
+    }
+    // the demuxer prepares in its own thread and reports its ports to NextAudioPortFound
+    ActiveFilters({source.get(), demuxer.get()});
+    return TransErrorCode(ErrorCode::SUCCESS);
+}
+
+ErrorCode HiPlayerImpl::NextAudioPortFound(Filter* filter, const PortInfo& param)
+{
+    if (!IsNextItemFilter(filter->GetName())) {
+        return ErrorCode::ERROR_INVALID_PARAMETER_VALUE;
+    }
+    for (const auto& portDesc : param.ports) {
+        if (portDesc.name.compare(0, 5, "audio") != 0) { // 5 is length of "audio"
+            continue;
+        }
+        MEDIA_LOG_I("next item port name " PUBLIC_LOG_S, portDesc.name.c_str());
+        std::shared_ptr<AudioDecoderFilter> decoder;
+        if (!portDesc.isPcm) {
+            decoder = FilterFactory::Instance().CreateFilterWithType<AudioDecoderFilter>(
+                "builtin.player.audiodecoder", "audiodecoder-" + portDesc.name + "-" + std::to_string(itemCount_));
+            FALSE_RETURN_V(decoder != nullptr, ErrorCode::ERROR_NO_MEMORY);
+            pipeline_->InitStandbyFilters({decoder.get()});
+        }
+        {
+            OSAL::ScopedLock lock(nextItemMutex_);
+            // canceled meanwhile
+            if (filter != nextDemuxer_.get()) {
+                return ErrorCode::ERROR_INVALID_PARAMETER_VALUE;
+            }
+            nextAudioDecoder_ = decoder;
+            nextAudioPort_ = portDesc.name;
+        }
+        auto fromPort = filter->GetOutPort(portDesc.name);
+        if (decoder != nullptr) {
+            FAIL_RETURN(pipeline_->LinkPorts(fromPort, decoder->GetInPort(PORT_NAME_DEFAULT)));
+            fromPort = decoder->GetOutPort(PORT_NAME_DEFAULT);
+        }
+        FAIL_RETURN(pipeline_->LinkPorts(fromPort, audioSink_->GetStandbyInPort()));
+        if (decoder != nullptr) {
+            ActiveFilters({decoder.get()});
+        }
+        return ErrorCode::SUCCESS;
+    }
+    return ErrorCode::ERROR_INVALID_PARAMETER_VALUE;
+}
+
+bool HiPlayerImpl::IsNextItemFilter(const std::string& name)
+{
+    OSAL::ScopedLock lock(nextItemMutex_);
+    return (nextSource_ != nullptr && nextSource_->GetName() == name) ||
+        (nextDemuxer_ != nullptr && nextDemuxer_->GetName() == name) ||
+        (nextAudioDecoder_ != nullptr && nextAudioDecoder_->GetName() == name);
+}
+
+void HiPlayerImpl::HandleAudioSplicedEvent(const Event& event)
+{
+    // the streaming thread of the audio sink reports it, the filters are swapped on the splice task
+    {
+        OSAL::ScopedLock lock(nextItemMutex_);
+        splicePending_ = true;
+        splicedItemOffset_ = Plugin::AnyCast<int64_t>(event.param);
+    }
+    spliceTask_->Start();
+}
+
+void HiPlayerImpl::SpliceNextItem()
+{
+    spliceTask_->PauseAsync();
+    OSAL::ScopedLock stateLock(stateMutex_);
+    SwapInSplicedItem();
+}
+
+void HiPlayerImpl::SwapInSplicedItem()
+{
+    std::shared_ptr<MediaSourceFilter> source;
+    std::shared_ptr<DemuxerFilter> demuxer;
+    std::shared_ptr<AudioDecoderFilter> decoder;
+    std::string audioPort;
+    std::string url;
+    int64_t setMs = -1;
+    int64_t offset = 0;
+    {
+        OSAL::ScopedLock lock(nextItemMutex_);
+        FALSE_RETURN(splicePending_);
+        splicePending_ = false;
+        FALSE_RETURN_MSG(nextDemuxer_ != nullptr, "no next item to splice in");
+        source = std::move(nextSource_);
+        demuxer = std::move(nextDemuxer_);
+        decoder = std::move(nextAudioDecoder_);
+        audioPort = std::move(nextAudioPort_);
+        url = std::move(nextUrl_);
+        setMs = nextItemSetMs_;
+        offset = splicedItemOffset_;
+        nextSource_.reset();
+        nextDemuxer_.reset();
+        nextAudioDecoder_.reset();
+    }
+    // the filters of the ended item leave the pipeline, the audio sink and the clock stay
+    auto endedInPort = audioSink_->GetStandbyInPort();
+    auto endedOutPort = endedInPort->GetPeerPort();
+    endedInPort->Disconnect();
+    if (endedOutPort) {
+        endedOutPort->Disconnect();
+    }
+    std::vector<PFilter> retired {audioSource_, demuxer_};
+    for (const auto& entry : audioDecoderMap_) {
+        retired.push_back(entry.second);
+    }
+    for (const auto& filter : retired) {
+        (void)pipeline_->RemoveFilter(filter.get());
+    }
+    audioDecoderMap_.clear();
+    FAIL_LOG(pipeline_->AdoptFilters({source.get(), demuxer.get()}));
+    std::vector<PFilter> started {source, demuxer};
+    if (decoder != nullptr) {
+        audioDecoderMap_[audioPort] = decoder;
+        FAIL_LOG(pipeline_->AdoptFilters({decoder.get()}));
+        started.push_back(decoder);
+    }
+    for (auto it = started.rbegin(); it != started.rend(); ++it) {
+        FAIL_LOG((*it)->Start());
+    }
+    {
+        OSAL::ScopedLock lock(nextItemMutex_);
+        retiredFilters_.insert(retiredFilters_.end(), retired.begin(), retired.end());
+    }
+    audioSource_ = source;
+    demuxer_ = demuxer;
+    url_ = url;
+    itemOffset_ = offset;
+    MEDIA_LOG_I("next item " PUBLIC_LOG_S " spliced in with offset " PUBLIC_LOG_D64 ", set " PUBLIC_LOG_D64
+                " ms before", url.c_str(), itemOffset_.load(), SteadyClock::GetCurrentTimeMs() - setMs);
+    (void)DoOnReady();
+    Format format;
+    callbackLooper_.OnInfo(INFO_TYPE_POSITION_UPDATE, 0, format);
+}
+
+void HiPlayerImpl::CancelNextItem()
+{
+    std::vector<PFilter> next;
+    {
+        OSAL::ScopedLock lock(nextItemMutex_);
+        FALSE_RETURN(nextDemuxer_ != nullptr);
+        next = {nextSource_, nextDemuxer_};
+        if (nextAudioDecoder_ != nullptr) {
+            next.push_back(nextAudioDecoder_);
+        }
+        nextSource_.reset();
+        nextDemuxer_.reset();
+        nextAudioDecoder_.reset();
+        nextUrl_.clear();
+    }
+    MEDIA_LOG_I("cancel the next item");
+    // its buffers waiting in the audio sink are dropped first, so that the threads pushing them can stop
+    audioSink_->SetSpliceEnabled(false);
+    for (auto it = next.rbegin(); it != next.rend(); ++it) {
+        (void)(*it)->Stop();
+        (void)pipeline_->RemoveFilter(it->get());
+    }
+    auto standbyInPort = audioSink_->GetStandbyInPort();
+    auto peerPort = standbyInPort->GetPeerPort();
+    standbyInPort->Disconnect();
+    if (peerPort) {
+        peerPort->Disconnect();
+    }
+}
+
+void HiPlayerImpl::ReleaseRetiredItem()
+{
+    std::vector<PFilter> retired;
+    {
+        OSAL::ScopedLock lock(nextItemMutex_);
+        retired.swap(retiredFilters_);
+    }
+    for (auto it = retired.rbegin(); it != retired.rend(); ++it) {
+        (void)(*it)->Stop();
+    }
+}
 }  // namespace Media
 }  // namespace OHOS
@@ -23,6 +23,7 @@
 #include <i_player_engine.h>
 #include "foundation/osal/thread/condition_variable.h"
 #include "foundation/osal/thread/mutex.h"
+#include "foundation/osal/thread/task.h"
 #include "hiplayer_callback_looper.h"
 #include "internal/state_machine.h"
 #include "pipeline/core/error_code.h"
@@ -84,6 +85,14 @@ public:
     int32_t SetAudioInterruptMode(const int32_t interruptMode) override;
     int32_t SelectBitRate(uint32_t bitRate) override;
 
+    /**
+     * Prepare uri in the background as the next item of a gapless playlist, while the current one plays. Its source,
+     * demuxer and decoder are linked to the standby in port of the audio sink, which splices the decoded audio in at
+     * the end of the current item, sample by sample, without stopping the sink or the clock. Audio items only, in the
+     * sample format, rate and channels of the current one: otherwise the current item completes as usual.
+     */
+    int32_t SetNextSource(const std::string& uri);
+
     // internal interfaces
     void OnEvent(const Event& event) override;
     void OnStateChanged(StateId state) override;
@@ -122,6 +131,13 @@ private:
     void NotifyBufferingUpdate(const std::string_view& type, int32_t param);
     void HandleResolutionChangeEvent(const Event& event);
     void HandlePluginEvent(const Event& event);
+    ErrorCode NextAudioPortFound(Pipeline::Filter* filter, const Pipeline::PortInfo& param);
+    bool IsNextItemFilter(const std::string& name);
+    void HandleAudioSplicedEvent(const Event& event);
+    void SpliceNextItem();
+    void SwapInSplicedItem(); // with stateMutex_ held
+    void CancelNextItem();
+    void ReleaseRetiredItem();
     
     OSAL::Mutex stateMutex_ {};
     OSAL::ConditionVariable cond_ {};
@@ -155,6 +171,22 @@ private:
     int32_t videoWidth_ {0};
     int32_t videoHeight_ {0};
     std::string url_;
+
+    // next item of a gapless playlist, initialized by pipeline_ but out of its filters until it is spliced in
+    OSAL::Mutex nextItemMutex_ {};
+    std::string nextUrl_ {};
+    std::shared_ptr<Pipeline::MediaSourceFilter> nextSource_ {};
+    std::shared_ptr<Pipeline::DemuxerFilter> nextDemuxer_ {};
+    std::shared_ptr<Pipeline::AudioDecoderFilter> nextAudioDecoder_ {};
+    std::string nextAudioPort_ {};
+    int64_t nextItemSetMs_ {-1};
+    std::atomic<uint32_t> itemCount_ {0}; // names the filters of the next items
+    // filters of the items spliced out, stopped later out of the streaming thread that spliced the next item in
+    std::vector<Pipeline::PFilter> retiredFilters_ {};
+    std::shared_ptr<OSAL::Task> spliceTask_ {}; // swaps the filters of the items once the audio sink spliced
+    bool splicePending_ {false};
+    int64_t splicedItemOffset_ {0};
+    std::atomic<int64_t> itemOffset_ {0}; // pts offset of the current item in the timeline of the audio sink
 };
 }  // namespace Media
 }  // namespace OHOS
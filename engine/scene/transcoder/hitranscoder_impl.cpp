@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef RECORDER_SUPPORT
+#define HST_LOG_TAG "HiTranscoderImpl"
+
+#include "hitranscoder_impl.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "foundation/log.h"
+#include "foundation/utils/steady_clock.h"
+#include "pipeline/factory/filter_factory.h"
+#include "plugin/common/media_sink.h"
+#include "plugin/common/media_source.h"
+
+namespace OHOS {
+namespace Media {
+namespace Transcode {
+using namespace Pipeline;
+
+namespace {
+constexpr int32_t PREPARE_TIMEOUT_MS = 5000;
+constexpr int64_t NS_PER_MS = 1000000;
+constexpr double MS_PER_SECOND = 1000.0;
+}
+
+/**
+ * Stands in for the in port of a stage on the out port of the previous one. It forwards to the same filter and port
+ * name, so negotiation and data flow are unchanged, and counts what is pushed through it.
+ */
+class HiTranscoderImpl::StageProbe : public InPort {
+public:
+    StageProbe(Filter* filter, const std::string& portName)
+        : InPort(filter, portName),
+          stageName_(portName == PORT_NAME_DEFAULT ? filter->GetName() : filter->GetName() + "." + portName)
+    {
+    }
+    ~StageProbe() override = default;
+
+    void PushData(const AVBufferPtr& buffer, int64_t offset) override
+    {
+        auto start = SteadyClock::GetCurrentTimeNanoSec();
+        InPort::PushData(buffer, offset);
+        pushTimeNs_ += SteadyClock::GetCurrentTimeNanoSec() - start;
+        auto memory = buffer->GetMemory();
+        if (memory != nullptr && memory->GetSize() > 0) {
+            buffers_++;
+            bytes_ += memory->GetSize();
+        }
+    }
+
+    StageStats GetStats(int64_t elapsedMs) const
+    {
+        StageStats stats;
+        stats.name = stageName_;
+        stats.buffers = buffers_.load();
+        stats.bytes = bytes_.load();
+        stats.pushTimeMs = pushTimeNs_.load() / NS_PER_MS;
+        if (elapsedMs > 0) {
+            stats.buffersPerSecond = static_cast<double>(stats.buffers) * MS_PER_SECOND / elapsedMs;
+        }
+        return stats;
+    }
+
+private:
+    const std::string stageName_;
+    std::atomic<uint64_t> buffers_ {0};
+    std::atomic<uint64_t> bytes_ {0};
+    std::atomic<int64_t> pushTimeNs_ {0};
+};
+
+HiTranscoderImpl::HiTranscoderImpl()
+{
+    MEDIA_LOG_I("hiTranscoderImpl ctor");
+    FilterFactory::Instance().Init();
+    source_ = FilterFactory::Instance().CreateFilterWithType<MediaSourceFilter>(
+            "builtin.player.mediasource", "mediaSource");
+    demuxer_ = FilterFactory::Instance().CreateFilterWithType<DemuxerFilter>(
+            "builtin.player.demuxer", "demuxer");
+    muxer_ = FilterFactory::Instance().CreateFilterWithType<MuxerFilter>(
+            "builtin.recorder.muxer", "muxer");
+    outputSink_ = FilterFactory::Instance().CreateFilterWithType<OutputSinkFilter>(
+            "builtin.recorder.output_sink", "output_sink");
+    FALSE_RETURN(source_ != nullptr);
+    FALSE_RETURN(demuxer_ != nullptr);
+    FALSE_RETURN(muxer_ != nullptr);
+    FALSE_RETURN(outputSink_ != nullptr);
+    pipeline_ = std::make_shared<PipelineCore>();
+}
+
+HiTranscoderImpl::~HiTranscoderImpl()
+{
+    Stop();
+    if (outputFd_ >= 0) {
+        close(outputFd_);
+        outputFd_ = -1;
+    }
+    MEDIA_LOG_D("dtor called.");
+}
+
+ErrorCode HiTranscoderImpl::Init()
+{
+    if (initialized_.load()) {
+        return ErrorCode::SUCCESS;
+    }
+    FALSE_RETURN_V_MSG_E(pipeline_ != nullptr, ErrorCode::ERROR_NULL_POINTER, "create filters fail");
+    pipeline_->Init(this, this);
+    ErrorCode ret = pipeline_->AddFilters({source_.get(), demuxer_.get()});
+    if (ret == ErrorCode::SUCCESS) {
+        ret = pipeline_->LinkFilters({source_.get(), demuxer_.get()});
+    }
+    FALSE_LOG(ret == ErrorCode::SUCCESS);
+    if (ret == ErrorCode::SUCCESS) {
+        initialized_ = true;
+    } else {
+        pipeline_->RemoveFilterChain(source_.get());
+    }
+    return ret;
+}
+
+ErrorCode HiTranscoderImpl::SetSource(const std::string& uri)
+{
+    MEDIA_LOG_I("SetSource entered source uri: " PUBLIC_LOG_S, uri.c_str());
+    FALSE_RETURN_V(initialized_ && state_ == State::INIT, ErrorCode::ERROR_INVALID_OPERATION);
+    return source_->SetSource(std::make_shared<MediaSource>(uri));
+}
+
+ErrorCode HiTranscoderImpl::SetOutput(const std::string& path, const std::string& containerMime)
+{
+    MEDIA_LOG_I("SetOutput entered, path: " PUBLIC_LOG_S ", container: " PUBLIC_LOG_S, path.c_str(),
+                containerMime.c_str());
+    FALSE_RETURN_V(initialized_ && state_ == State::INIT, ErrorCode::ERROR_INVALID_OPERATION);
+    FAIL_RETURN(muxer_->SetOutputFormat(containerMime));
+    int32_t fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644); // 0644: rw-r--r--
+    FALSE_RETURN_V_MSG_E(fd >= 0, ErrorCode::ERROR_PERMISSION_DENIED, "open " PUBLIC_LOG_S " fail", path.c_str());
+    MediaSink mediaSink {Plugin::ProtocolType::FD};
+    mediaSink.SetFd(fd);
+    auto ret = outputSink_->SetSink(mediaSink);
+    if (ret != ErrorCode::SUCCESS) {
+        close(fd);
+        return ret;
+    }
+    if (outputFd_ >= 0) {
+        close(outputFd_);
+    }
+    outputFd_ = fd;
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode HiTranscoderImpl::SetAudioEncoder(const std::shared_ptr<Plugin::Meta>& encoderMeta)
+{
+    FALSE_RETURN_V(state_ == State::INIT, ErrorCode::ERROR_INVALID_OPERATION);
+    std::string mime;
+    FALSE_RETURN_V_MSG_E(encoderMeta == nullptr || encoderMeta->Get<Plugin::Tag::MIME>(mime),
+                         ErrorCode::ERROR_INVALID_PARAMETER_VALUE, "Encoder meta must contains mime");
+    audioEncoderMeta_ = encoderMeta;
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode HiTranscoderImpl::SetVideoEncoder(const std::shared_ptr<Plugin::Meta>& encoderMeta)
+{
+#ifdef VIDEO_SUPPORT
+    FALSE_RETURN_V(state_ == State::INIT, ErrorCode::ERROR_INVALID_OPERATION);
+    std::string mime;
+    FALSE_RETURN_V_MSG_E(encoderMeta == nullptr || encoderMeta->Get<Plugin::Tag::MIME>(mime),
+                         ErrorCode::ERROR_INVALID_PARAMETER_VALUE, "Encoder meta must contains mime");
+    videoEncoderMeta_ = encoderMeta;
+    return ErrorCode::SUCCESS;
+#else
+    return encoderMeta == nullptr ? ErrorCode::SUCCESS : ErrorCode::ERROR_UNIMPLEMENTED;
+#endif
+}
+
+ErrorCode HiTranscoderImpl::SetForceEncode(bool forceEncode)
+{
+    FALSE_RETURN_V(state_ == State::INIT, ErrorCode::ERROR_INVALID_OPERATION);
+    forceEncode_ = forceEncode;
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode HiTranscoderImpl::Prepare()
+{
+    MEDIA_LOG_I("Prepare entered");
+    {
+        OSAL::ScopedLock lock(stateMutex_);
+        FALSE_RETURN_V_MSG_E(initialized_ && state_ == State::INIT, ErrorCode::ERROR_INVALID_OPERATION,
+                             "transcoder is not initialized or prepared already");
+        FALSE_RETURN_V_MSG_E(outputFd_ >= 0, ErrorCode::ERROR_INVALID_OPERATION, "no output set");
+        state_ = State::PREPARING;
+    }
+    // the output sink plugin owns the fd from now on
+    outputFd_ = -1;
+    auto ret = pipeline_->Prepare();
+    if (ret != ErrorCode::SUCCESS) {
+        MEDIA_LOG_E("Prepare failed with error " PUBLIC_LOG_S, GetErrorName(ret));
+        UpdateState(State::ERROR);
+        return ret;
+    }
+    OSAL::ScopedLock lock(stateMutex_);
+    if (!cond_.WaitFor(lock, PREPARE_TIMEOUT_MS, [this] { return state_ != State::PREPARING; })) {
+        MEDIA_LOG_E("Prepare timed out");
+        state_ = State::ERROR;
+        errorCode_ = ErrorCode::ERROR_TIMED_OUT;
+    }
+    if (state_ == State::READY) {
+        return ErrorCode::SUCCESS;
+    }
+    return errorCode_ != ErrorCode::SUCCESS ? errorCode_ : ErrorCode::ERROR_UNKNOWN;
+}
+
+ErrorCode HiTranscoderImpl::Start()
+{
+    MEDIA_LOG_I("Start entered");
+    {
+        OSAL::ScopedLock lock(stateMutex_);
+        FALSE_RETURN_V_MSG_E(state_ == State::READY, ErrorCode::ERROR_INVALID_OPERATION, "transcoder is not ready");
+        state_ = State::RUNNING;
+    }
+    startTimeMs_ = SteadyClock::GetCurrentTimeMs();
+    auto ret = pipeline_->Start();
+    if (ret != ErrorCode::SUCCESS) {
+        MEDIA_LOG_E("Start failed with error " PUBLIC_LOG_S, GetErrorName(ret));
+        UpdateState(State::ERROR);
+    }
+    return ret;
+}
+
+ErrorCode HiTranscoderImpl::WaitForCompletion(int32_t timeoutMs)
+{
+    OSAL::ScopedLock lock(stateMutex_);
+    FALSE_RETURN_V(state_ == State::RUNNING || state_ == State::COMPLETED || state_ == State::ERROR,
+                   ErrorCode::ERROR_INVALID_OPERATION);
+    if (!cond_.WaitFor(lock, timeoutMs, [this] { return state_ != State::RUNNING; })) {
+        return ErrorCode::ERROR_TIMED_OUT;
+    }
+    if (state_ == State::COMPLETED) {
+        return ErrorCode::SUCCESS;
+    }
+    return errorCode_ != ErrorCode::SUCCESS ? errorCode_ : ErrorCode::ERROR_UNKNOWN;
+}
+
+ErrorCode HiTranscoderImpl::Stop()
+{
+    {
+        OSAL::ScopedLock lock(stateMutex_);
+        if (state_ == State::INIT || state_ == State::STOPPED) {
+            return ErrorCode::SUCCESS;
+        }
+    }
+    MEDIA_LOG_I("Stop entered");
+    if (endTimeMs_ == 0) {
+        endTimeMs_ = SteadyClock::GetCurrentTimeMs();
+    }
+    auto ret = pipeline_->Stop();
+    ReportStageStats();
+    UpdateState(State::STOPPED);
+    return ret;
+}
+
+std::vector<StageStats> HiTranscoderImpl::GetStageStats() const
+{
+    int64_t elapsedMs = 0;
+    if (startTimeMs_ > 0) {
+        elapsedMs = (endTimeMs_ > 0 ? endTimeMs_.load() : SteadyClock::GetCurrentTimeMs()) - startTimeMs_;
+    }
+    std::vector<StageStats> stats;
+    OSAL::ScopedLock lock(probeMutex_);
+    stats.reserve(probes_.size());
+    for (const auto& probe : probes_) {
+        stats.emplace_back(probe->GetStats(elapsedMs));
+    }
+    return stats;
+}
+
+void HiTranscoderImpl::OnEvent(const Event& event)
+{
+    MEDIA_LOG_D("OnEvent (" PUBLIC_LOG_S ")", GetEventName(event.type));
+    switch (event.type) {
+        case EventType::EVENT_READY: {
+            OSAL::ScopedLock lock(stateMutex_);
+            if (state_ == State::PREPARING) {
+                state_ = State::READY;
+                cond_.NotifyAll();
+            }
+            break;
+        }
+        case EventType::EVENT_COMPLETE: {
+            endTimeMs_ = SteadyClock::GetCurrentTimeMs();
+            OSAL::ScopedLock lock(stateMutex_);
+            if (state_ == State::RUNNING) {
+                state_ = State::COMPLETED;
+                cond_.NotifyAll();
+            }
+            break;
+        }
+        case EventType::EVENT_ERROR: {
+            OSAL::ScopedLock lock(stateMutex_);
+            errorCode_ = Plugin::Any::IsSameTypeWith<ErrorCode>(event.param) ?
+                Plugin::AnyCast<ErrorCode>(event.param) : ErrorCode::ERROR_UNKNOWN;
+            MEDIA_LOG_E("error " PUBLIC_LOG_S " from " PUBLIC_LOG_S, GetErrorName(errorCode_),
+                        event.srcFilter.c_str());
+            if (state_ != State::STOPPED) {
+                state_ = State::ERROR;
+                cond_.NotifyAll();
+            }
+            break;
+        }
+        default:
+            MEDIA_LOG_D("ignore event (" PUBLIC_LOG_S ")", GetEventName(event.type));
+    }
+}
+
+ErrorCode HiTranscoderImpl::OnCallback(const FilterCallbackType& type, Filter* filter, const Plugin::Any& parameter)
+{
+    ErrorCode ret = ErrorCode::SUCCESS;
+    switch (type) {
+        case FilterCallbackType::PORT_ADDED:
+            ret = NewPortsFound(filter, parameter);
+            break;
+        case FilterCallbackType::PORT_REMOVE:
+        default:
+            break;
+    }
+    return ret;
+}
+
+ErrorCode HiTranscoderImpl::NewPortsFound(Filter* filter, const Plugin::Any& parameter)
+{
+    if (!Plugin::Any::IsSameTypeWith<PortInfo>(parameter)) {
+        return ErrorCode::ERROR_INVALID_PARAMETER_TYPE;
+    }
+    auto param = Plugin::AnyCast<PortInfo>(parameter);
+    if (filter != demuxer_.get() || param.type != PortType::OUT) {
+        return ErrorCode::ERROR_INVALID_PARAMETER_VALUE;
+    }
+    MEDIA_LOG_I("new port found on demuxer " PUBLIC_LOG_ZU, param.ports.size());
+    // the muxer only takes tracks before it is prepared, so it joins the pipeline once the tracks are known
+    FAIL_RETURN(pipeline_->AddFilters({muxer_.get(), outputSink_.get()}));
+    std::vector<Filter*> newFilters;
+    for (const auto& portDesc : param.ports) {
+        FAIL_RETURN_MSG(LinkTrack(portDesc, newFilters), "link port " PUBLIC_LOG_S " fail", portDesc.name.c_str());
+    }
+    FAIL_RETURN(LinkStage(muxer_->GetOutPort(PORT_NAME_DEFAULT), outputSink_.get(),
+                          outputSink_->GetInPort(PORT_NAME_DEFAULT)));
+    newFilters.emplace_back(muxer_.get());
+    newFilters.emplace_back(outputSink_.get());
+    // downstream first, the demuxer negotiates with them when this returns
+    for (auto it = newFilters.rbegin(); it != newFilters.rend(); ++it) {
+        FAIL_RETURN((*it)->Prepare());
+    }
+    return ErrorCode::SUCCESS;
+}
+
+ErrorCode HiTranscoderImpl::LinkTrack(const PortDesc& portDesc, std::vector<Filter*>& newFilters)
+{
+    auto trackMeta = FindTrackMeta(portDesc.name);
+    std::string mime;
+    FALSE_RETURN_V_MSG_E(trackMeta != nullptr && trackMeta->Get<Plugin::Tag::MIME>(mime),
+                         ErrorCode::ERROR_NOT_EXISTED, "no track meta for port " PUBLIC_LOG_S, portDesc.name.c_str());
+    bool isAudio = portDesc.name.compare(0, 5, "audio") == 0; // 5 is length of "audio"
+    bool isVideo = portDesc.name.compare(0, 5, "video") == 0; // 5 is length of "video"
+    auto encoderMeta = isAudio ? audioEncoderMeta_ : (isVideo ? videoEncoderMeta_ : nullptr);
+    std::string encoderMime;
+    bool transcode = encoderMeta != nullptr && encoderMeta->Get<Plugin::Tag::MIME>(encoderMime) &&
+        (forceEncode_ || encoderMime != mime);
+    std::shared_ptr<InPort> muxerInPort {nullptr};
+    FAIL_RETURN_MSG(muxer_->AddTrack(muxerInPort), "muxer AddTrack fail");
+    auto fromPort = demuxer_->GetOutPort(portDesc.name);
+    if (!transcode) {
+        MEDIA_LOG_I("remux " PUBLIC_LOG_S " of port " PUBLIC_LOG_S, mime.c_str(), portDesc.name.c_str());
+        return LinkStage(fromPort, muxer_.get(), muxerInPort);
+    }
+    MEDIA_LOG_I("transcode " PUBLIC_LOG_S " of port " PUBLIC_LOG_S " to " PUBLIC_LOG_S, mime.c_str(),
+                portDesc.name.c_str(), encoderMime.c_str());
+    std::shared_ptr<Filter> decoder {nullptr};
+    std::shared_ptr<Filter> encoder {nullptr};
+    if (isAudio) {
+        auto audioEncoder = FilterFactory::Instance().CreateFilterWithType<AudioEncoderFilter>(
+                "builtin.recorder.audioencoder", "audioencoder-" + portDesc.name);
+        FALSE_RETURN_V_MSG_E(audioEncoder != nullptr, ErrorCode::ERROR_UNKNOWN, "create audioEncoder filter fail");
+        FAIL_RETURN(audioEncoder->SetAudioEncoder(0, std::make_shared<Plugin::Meta>(*encoderMeta)));
+        encoder = audioEncoder;
+        if (!portDesc.isPcm) {
+            decoder = FilterFactory::Instance().CreateFilterWithType<AudioDecoderFilter>(
+                    "builtin.player.audiodecoder", "audiodecoder-" + portDesc.name);
+        }
+    } else {
+#ifdef VIDEO_SUPPORT
+        auto videoEncoder = FilterFactory::Instance().CreateFilterWithType<VideoEncoderFilter>(
+                "builtin.recorder.videoencoder", "videoencoder-" + portDesc.name);
+        FALSE_RETURN_V_MSG_E(videoEncoder != nullptr, ErrorCode::ERROR_UNKNOWN, "create videoEncoder filter fail");
+        FAIL_RETURN(videoEncoder->SetVideoEncoder(0, std::make_shared<Plugin::Meta>(*encoderMeta)));
+        encoder = videoEncoder;
+        decoder = FilterFactory::Instance().CreateFilterWithType<VideoDecoderFilter>(
+                "builtin.player.videodecoder", "videodecoder-" + portDesc.name);
+#else
+        return ErrorCode::ERROR_UNIMPLEMENTED;
+#endif
+    }
+    if (!portDesc.isPcm) {
+        FALSE_RETURN_V_MSG_E(decoder != nullptr, ErrorCode::ERROR_UNKNOWN, "create decoder filter fail");
+        FAIL_RETURN(pipeline_->AddFilters({decoder.get()}));
+        FAIL_RETURN(LinkStage(fromPort, decoder.get(), decoder->GetInPort(PORT_NAME_DEFAULT)));
+        fromPort = decoder->GetOutPort(PORT_NAME_DEFAULT);
+        newFilters.emplace_back(decoder.get());
+        codecs_.emplace_back(decoder);
+    }
+    FAIL_RETURN(pipeline_->AddFilters({encoder.get()}));
+    FAIL_RETURN(LinkStage(fromPort, encoder.get(), encoder->GetInPort(PORT_NAME_DEFAULT)));
+    newFilters.emplace_back(encoder.get());
+    codecs_.emplace_back(encoder);
+    return LinkStage(encoder->GetOutPort(PORT_NAME_DEFAULT), muxer_.get(), muxerInPort);
+}
+
+ErrorCode HiTranscoderImpl::LinkStage(const std::shared_ptr<OutPort>& from, Filter* to,
+                                      const std::shared_ptr<InPort>& toPort)
+{
+    FALSE_RETURN_V(from != nullptr && toPort != nullptr, ErrorCode::ERROR_INVALID_PARAMETER_VALUE);
+    FAIL_RETURN_MSG(pipeline_->LinkPorts(from, toPort), "LinkPorts to " PUBLIC_LOG_S " fail", to->GetName().c_str());
+    // the in port keeps its peer for activation, buffers go through the probe
+    auto probe = std::make_shared<StageProbe>(to, toPort->GetName());
+    FAIL_RETURN(from->Connect(probe));
+    OSAL::ScopedLock lock(probeMutex_);
+    probes_.emplace_back(probe);
+    return ErrorCode::SUCCESS;
+}
+
+std::shared_ptr<Plugin::Meta> HiTranscoderImpl::FindTrackMeta(const std::string& portName) const
+{
+    // demuxer ports are named <type>_<n> after the n-th track with a mime of that type, see FilterBase::NamePort
+    auto pos = portName.find_last_of('_');
+    FALSE_RETURN_V(pos != std::string::npos, nullptr);
+    auto prefix = portName.substr(0, pos + 1);
+    prefix.back() = '/';
+    auto index = std::strtol(portName.c_str() + pos + 1, nullptr, 10); // 10: decimal
+    for (const auto& meta : demuxer_->GetStreamMetaInfo()) {
+        std::string mime;
+        if (meta == nullptr || !meta->Get<Plugin::Tag::MIME>(mime) || mime.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        if (--index == 0) {
+            return meta;
+        }
+    }
+    return nullptr;
+}
+
+void HiTranscoderImpl::ReportStageStats() const
+{
+    for (const auto& stats : GetStageStats()) {
+        MEDIA_LOG_I("stage " PUBLIC_LOG_S ": " PUBLIC_LOG_U64 " buffers, " PUBLIC_LOG_U64 " bytes, " PUBLIC_LOG_F
+                    " buffers/s, " PUBLIC_LOG_D64 " ms in push", stats.name.c_str(), stats.buffers, stats.bytes,
+                    stats.buffersPerSecond, stats.pushTimeMs);
+    }
+}
+
+void HiTranscoderImpl::UpdateState(State state)
+{
+    OSAL::ScopedLock lock(stateMutex_);
+    state_ = state;
+    cond_.NotifyAll();
+}
+} // namespace Transcode
+} // namespace Media
+} // namespace OHOS
+#endif // RECORDER_SUPPORT
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_HITRANSCODER_IMPL_H
+#define HISTREAMER_HITRANSCODER_IMPL_H
+#ifdef RECORDER_SUPPORT
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "foundation/osal/thread/condition_variable.h"
+#include "foundation/osal/thread/mutex.h"
+#include "pipeline/core/error_code.h"
+#include "pipeline/core/pipeline.h"
+#include "pipeline/core/pipeline_core.h"
+#include "pipeline/filters/codec/audio_decoder/audio_decoder_filter.h"
+#include "pipeline/filters/codec/audio_encoder/audio_encoder_filter.h"
+#include "pipeline/filters/demux/demuxer_filter.h"
+#include "pipeline/filters/muxer/muxer_filter.h"
+#include "pipeline/filters/sink/output_sink/output_sink_filter.h"
+#include "pipeline/filters/source/media_source/media_source_filter.h"
+#ifdef VIDEO_SUPPORT
+#include "pipeline/filters/codec/video_decoder/video_decoder_filter.h"
+#include "pipeline/filters/codec/video_encoder/video_encoder_filter.h"
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace Transcode {
+struct StageStats {
+    std::string name;        // filter the buffers are pushed into, with the track port for the muxer
+    uint64_t buffers {0};
+    uint64_t bytes {0};
+    int64_t pushTimeMs {0};  // time the upstream stage spent in PushData, waiting for room in bounded queues included
+    double buffersPerSecond {0};
+};
+
+/**
+ * Offline transcoding of a media file into another one, as fast as the cpu allows.
+ *
+ * The pipeline links the source and demuxer filters to the muxer and output sink filters like a player followed by a
+ * recorder, but without sinks that synchronize to a clock: each stage pushes into the bounded queue of the next one
+ * and blocks only while that queue is full. A track whose codec differs from the encoder set for its media type is
+ * decoded and encoded again. Other tracks are remuxed: their packets go from the demuxer to the muxer as they are,
+ * with their timestamps, and only the bit stream format the muxer negotiates is converted by the demuxer. Buffers
+ * and bytes entering every stage are counted for the throughput report. One transcode per instance.
+ */
+class HiTranscoderImpl : public Pipeline::EventReceiver, public Pipeline::FilterCallback {
+public:
+    HiTranscoderImpl();
+    ~HiTranscoderImpl() override;
+    HiTranscoderImpl(const HiTranscoderImpl& other) = delete;
+    HiTranscoderImpl& operator=(const HiTranscoderImpl& other) = delete;
+    ErrorCode Init();
+
+    ErrorCode SetSource(const std::string& uri);
+    /// the file at path is created or truncated, containerMime picks the muxer
+    ErrorCode SetOutput(const std::string& path, const std::string& containerMime);
+    /// audio tracks of another codec than the mime of encoderMeta are transcoded, nullptr passes all of them through
+    ErrorCode SetAudioEncoder(const std::shared_ptr<Plugin::Meta>& encoderMeta);
+    ErrorCode SetVideoEncoder(const std::shared_ptr<Plugin::Meta>& encoderMeta);
+    /// encode tracks again even if they are of the codec of the encoder already, to change their bit rate say
+    ErrorCode SetForceEncode(bool forceEncode);
+
+    ErrorCode Prepare();
+    ErrorCode Start();
+    /// wait until the output sink has written the end of stream, or an error occurred
+    ErrorCode WaitForCompletion(int32_t timeoutMs);
+    ErrorCode Stop();
+
+    std::vector<StageStats> GetStageStats() const;
+
+    // internal interfaces from Pipeline::EventReceiver
+    void OnEvent(const Event& event) override;
+    // internal interfaces from Pipeline::FilterCallback
+    ErrorCode OnCallback(const Pipeline::FilterCallbackType& type, Pipeline::Filter* filter,
+                         const Plugin::Any& parameter) override;
+
+private:
+    enum class State { INIT, PREPARING, READY, RUNNING, COMPLETED, STOPPED, ERROR };
+    class StageProbe;
+
+    ErrorCode NewPortsFound(Pipeline::Filter* filter, const Plugin::Any& parameter);
+    ErrorCode LinkTrack(const Pipeline::PortDesc& portDesc, std::vector<Pipeline::Filter*>& newFilters);
+    ErrorCode LinkStage(const std::shared_ptr<Pipeline::OutPort>& from, Pipeline::Filter* to,
+                        const std::shared_ptr<Pipeline::InPort>& toPort);
+    std::shared_ptr<Plugin::Meta> FindTrackMeta(const std::string& portName) const;
+    void ReportStageStats() const;
+    void UpdateState(State state);
+
+    OSAL::Mutex stateMutex_ {};
+    OSAL::ConditionVariable cond_ {};
+    std::atomic<State> state_ {State::INIT};
+    ErrorCode errorCode_ {ErrorCode::SUCCESS};
+    std::atomic<bool> initialized_ {false};
+    std::atomic<int64_t> startTimeMs_ {0};
+    std::atomic<int64_t> endTimeMs_ {0};
+    int32_t outputFd_ {-1}; // owned until the output sink plugin takes it in Prepare
+
+    std::shared_ptr<Plugin::Meta> audioEncoderMeta_ {};
+    std::shared_ptr<Plugin::Meta> videoEncoderMeta_ {};
+    bool forceEncode_ {false};
+
+    std::shared_ptr<Pipeline::PipelineCore> pipeline_;
+    std::shared_ptr<Pipeline::MediaSourceFilter> source_;
+    std::shared_ptr<Pipeline::DemuxerFilter> demuxer_;
+    std::shared_ptr<Pipeline::MuxerFilter> muxer_;
+    std::shared_ptr<Pipeline::OutputSinkFilter> outputSink_;
+    std::vector<std::shared_ptr<Pipeline::Filter>> codecs_ {};
+
+    mutable OSAL::Mutex probeMutex_ {};
+    std::vector<std::shared_ptr<StageProbe>> probes_ {};
+};
+} // namespace Transcode
+} // namespace Media
+} // namespace OHOS
+#endif
+#endif // HISTREAMER_HITRANSCODER_IMPL_H
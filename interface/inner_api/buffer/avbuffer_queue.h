@@ -27,7 +27,8 @@ namespace Media {
 class AVBufferQueue {
 public:
     static std::shared_ptr<AVBufferQueue> Create(uint32_t size, MemoryType type = MemoryType::UNKNOWN_MEMORY,
-        const std::string& name = "", bool disableAlloc = false);
+        const std::string& name = "", bool disableAlloc = false,
+        AVBufferQueueTransport transport = AVBufferQueueTransport::BINDER);
     static std::shared_ptr<AVBufferQueue> CreateAsSurfaceProducer(
             sptr<Surface>& surface, const std::string& name = "");
     static std::shared_ptr<AVBufferQueue> CreateAsSurfaceConsumer(
@@ -25,6 +25,14 @@ namespace Media {
 
 constexpr uint32_t AVBUFFER_QUEUE_MAX_QUEUE_SIZE = 32;
 
+// How the producer of another process passes buffers to the queue.
+enum class AVBufferQueueTransport : uint8_t {
+    BINDER,      // every request and push of a buffer is a binder transaction
+    // Buffers cycle through a ring in shared memory, binder only maps them and serves what the ring can not.
+    // The ring belongs to the first remote producer, the buffers it releases are handed to that producer directly.
+    SHARED_RING,
+};
+
 class AVBufferQueueProducer;
 class AVBufferQueueConsumer;
 
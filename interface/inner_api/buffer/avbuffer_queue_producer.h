@@ -16,6 +16,7 @@
 #ifndef HISTREAMER_FOUNDATION_AVBUFFER_QUEUE_PRODUCER_H
 #define HISTREAMER_FOUNDATION_AVBUFFER_QUEUE_PRODUCER_H
 
+#include <vector>
 #include "buffer/avbuffer_queue_define.h"
 #include "iremote_stub.h"
 #include "surface.h"
@@ -33,6 +34,12 @@ public:
     virtual Status PushBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available) = 0;
     virtual Status ReturnBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available) = 0;
 
+    // Request up to count buffers, only the first one waits for timeoutMs. Returns OK if any buffer was obtained.
+    virtual Status RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers, uint32_t count,
+                                  const AVBufferConfig& config, int32_t timeoutMs) = 0;
+    // Push the buffers in order, stops at the first one that fails.
+    virtual Status PushBuffers(const std::vector<std::shared_ptr<AVBuffer>>& inBuffers, bool available) = 0;
+
     virtual Status AttachBuffer(std::shared_ptr<AVBuffer>& inBuffer, bool isFilled) = 0;
     virtual Status DetachBuffer(const std::shared_ptr<AVBuffer>& outBuffer) = 0;
 
@@ -51,7 +58,11 @@ protected:
         PRODUCER_ATTACH_BUFFER = 5,
         PRODUCER_DETACH_BUFFER = 6,
         PRODUCER_SET_FILLED_LISTENER = 7,
-        PRODUCER_SET_AVAILABLE_LISTENER = 8
+        PRODUCER_SET_AVAILABLE_LISTENER = 8,
+        PRODUCER_REQUEST_BUFFERS = 9,
+        PRODUCER_PUSH_BUFFERS = 10,
+        PRODUCER_OPEN_RING = 11,
+        PRODUCER_CLOSE_RING = 12
     };
 };
 
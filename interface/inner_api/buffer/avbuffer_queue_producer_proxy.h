@@ -34,6 +34,10 @@ public:
     Status PushBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool cancel) override = 0;
     Status ReturnBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool cancel) override = 0;
 
+    Status RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers, uint32_t count,
+                          const AVBufferConfig& config, int32_t timeoutMs) override = 0;
+    Status PushBuffers(const std::vector<std::shared_ptr<AVBuffer>>& inBuffers, bool available) override = 0;
+
     Status AttachBuffer(std::shared_ptr<AVBuffer>& inBuffer, bool isFilled) override = 0;
     Status DetachBuffer(const std::shared_ptr<AVBuffer>& outBuffer) override = 0;
 
@@ -16,11 +16,13 @@
 #ifndef AVSHAREDMEMORYPOOL_H
 #define AVSHAREDMEMORYPOOL_H
 
+#include <array>
 #include <condition_variable>
 #include <functional>
-#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include "nocopyable.h"
 #include "buffer/avsharedmemorybase.h"
 
@@ -40,6 +42,11 @@ namespace Media {
  *                  satisfy the acqiured size and reallocate a new memory block with the acquired size.
  * @notifier: the callback will be called to notify there are any available memory. It will be useful for
  *            non-blocking memory acquisition.
+ *
+ * Idle memory blocks are indexed by size, so an acquire takes the smallest block that fits, and busy blocks are
+ * tracked by the index carried by their shared_ptr deleter, so acquiring and releasing do not scan the pool.
+ * Waiters block on the condition of their power-of-two size class and are only woken by releases which may
+ * satisfy them.
  */
 class AVSharedMemoryPool : public std::enable_shared_from_this<AVSharedMemoryPool>, public NoCopyable {
 public:
@@ -88,17 +95,49 @@ public:
         return name_;
     }
 
+    struct Metrics {
+        uint64_t acquireCount = 0; // AcquireMemory calls with a valid size
+        uint64_t hitCount = 0;     // served by an idle memory block
+        uint64_t allocCount = 0;   // served by a newly allocated memory block
+        uint64_t failCount = 0;    // returned with nullptr
+        uint64_t waitCount = 0;    // blocked at least once
+        uint64_t totalWaitUs = 0;
+        uint64_t maxWaitUs = 0;
+    };
+
+    /**
+     * @brief Get the statistics of the pool since it was created, the hit rate is hitCount / acquireCount.
+     */
+    Metrics GetMetrics();
+
 private:
+    static constexpr uint32_t SIZE_CLASS_NUM = 32;
+
+    struct BusyEntry {
+        AVSharedMemory *memory = nullptr;
+        uint32_t generation = 0;
+    };
+
     bool DoAcquireMemory(int32_t size, AVSharedMemory **outMemory);
     AVSharedMemory *AllocMemory(int32_t size);
-    void ReleaseMemory(AVSharedMemory *memory);
+    void ReleaseMemory(AVSharedMemory *memory, uint32_t index);
     bool CheckSize(int32_t size);
+    AVSharedMemory *PopIdle(int32_t size);
+    AVSharedMemory *PopSmallestIdle();
+    void PushIdle(AVSharedMemory *memory);
+    uint32_t TrackBusy(AVSharedMemory *memory);
+    void NotifyWaiters(int32_t releasedSize);
 
     InitializeOption option_ {};
-    std::list<AVSharedMemory *> idleList_;
-    std::list<AVSharedMemory *> busyList_;
+    std::multimap<int32_t, AVSharedMemory *> idleMems_;
+    std::vector<BusyEntry> busyEntries_;
+    std::vector<uint32_t> freeBusyIndexes_;
+    size_t busyCnt_ = 0; // busy blocks of the current generation, older ones are deleted on release
+    uint32_t generation_ = 0;
     std::mutex mutex_;
-    std::condition_variable cond_;
+    std::array<std::condition_variable, SIZE_CLASS_NUM> conds_ {};
+    std::array<uint32_t, SIZE_CLASS_NUM> waiterCnts_ {};
+    Metrics metrics_ {};
     bool inited_ = false;
     std::string name_;
     MemoryAvailableNotifier notifier_;
@@ -182,6 +182,17 @@ struct PluginDefBase {
         return extensions;
     }
 
+    /// the source must hold magic at offset for the plugin to be sniffed, checked before its library is loaded
+    virtual void AddSniffHint(uint64_t offset, const std::string& magic)
+    {
+        sniffHints.emplace_back(std::to_string(offset) + ":" + magic);
+    }
+
+    virtual std::vector<std::string> GetSniffHints() const
+    {
+        return sniffHints;
+    }
+
     virtual CapabilitySet GetInCaps() const
     {
         return inCaps;
@@ -214,6 +225,7 @@ struct PluginDefBase {
 
 private:
     std::vector<std::string> extensions;      ///< File extensions
+    std::vector<std::string> sniffHints;      ///< "<offset>:<magic bytes>", see AddSniffHint
     CapabilitySet inCaps;                     ///< Plug-in input capability, For details, @see Capability.
     CapabilitySet outCaps;                    ///< Plug-in output capability, For details, @see Capability.
     PluginCreatorFunc<PluginBase> creator {nullptr}; ///< plugin create function.
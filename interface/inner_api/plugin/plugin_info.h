@@ -95,6 +95,15 @@ struct MediaInfo {
  */
 #define PLUGIN_INFO_EXTRA_EXTENSIONS        "extensions" // NOLINT: macro constant
 
+/**
+ * Extra information about the plugin.
+ * Describes the magic bytes the Demuxer plugin sniffs, as "<offset>:<magic bytes>". A source matching none of them
+ * is not sniffed by the plugin, so its library is not loaded for it. Absent if the plugin sniffs any source.
+ *
+ * ValueType: std::vector<std::string>
+ */
+#define PLUGIN_INFO_EXTRA_SNIFF_HINTS       "sniffHints" // NOLINT: macro constant
+
 /**
  * Extra information about the plugin.
  * Describes the CodecMode supported by the Codec plugin.
@@ -16,8 +16,10 @@
 #ifndef HISTREAMER_PLUGIN_REGISTER_H
 #define HISTREAMER_PLUGIN_REGISTER_H
 
+#include <atomic>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <set>
 #include <utility>
 #include "meta/any.h"
@@ -30,12 +32,26 @@ namespace Media {
 namespace Plugins {
 struct DataSource;
 using DemuxerPluginSnifferFunc = int (*)(const std::string& name, std::shared_ptr<DataSource> dataSource);
+
+/// Shared object providing dynamic plugins. When registered from the manifest, it is opened on first use only.
+struct PluginLibrary {
+    std::string name;
+    std::string path;
+    int64_t fileSize {0};
+    int64_t modifyTime {0};
+    std::vector<std::pair<PluginType, std::string>> plugins {}; ///< in registration order
+    std::mutex mutex {};
+    std::atomic<bool> loaded {false};
+    bool failed {false};
+};
+
 struct PluginRegInfo {
     std::shared_ptr<PackageDef> packageDef;
     std::shared_ptr<PluginInfo> info;
     PluginCreatorFunc<PluginBase> creator;
     DemuxerPluginSnifferFunc sniffer;
     std::shared_ptr<PluginLoader> loader;
+    std::shared_ptr<PluginLibrary> library;
 };
 
 class PluginRegister {
@@ -48,10 +64,22 @@ public:
     std::vector<std::string> ListPlugins(PluginType type, CodecMode preferredCodecMode = CodecMode::HARDWARE);
     int GetAllRegisteredPluginCount();
 
+    /// reg info ready to create the plugin, the library of a plugin registered from the manifest is opened here
     std::shared_ptr<PluginRegInfo> GetPluginRegInfo(PluginType type, const std::string& name);
 
+    /// reg info without opening the library, creator and sniffer may not be available yet
+    std::shared_ptr<PluginRegInfo> FindPluginRegInfo(PluginType type, const std::string& name);
+
     void RegisterPlugins();
 
+    /// write the manifest of the dynamic plugins registered so far, which is read at startup instead of the libraries.
+    /// A prebuilt manifest leaves out the size and mtime of the libraries, see PluginManifestLibrary.
+    bool WritePluginManifest(const std::string& path, bool prebuilt = false);
+
+    /// open every plugin library in libDirPath and write their manifest to manifestPath, used at build time, the
+    /// registration never writes the manifest since the plugin directory is read-only on a device
+    bool GeneratePluginManifest(const char* libDirPath, const std::string& manifestPath);
+
     void RegisterGenericPlugin(const GenericPluginDef& pluginDef);
 
     void RegisterGenericPlugins(const std::vector<GenericPluginDef>& vecPluginDef);
@@ -59,6 +87,8 @@ private:
     void RegisterStaticPlugins();
     void RegisterDynamicPlugins();
     void RegisterPluginsFromPath(const char* libDirPath);
+    void RegisterPluginsFromPath(const char* libDirPath, const std::string& manifestPath);
+    bool LoadPluginLibrary(const std::shared_ptr<PluginLibrary>& library);
     void UnregisterAllPlugins();
     void EraseRegisteredPluginsByLoader(const std::shared_ptr<PluginLoader>& loader);
 
@@ -72,8 +102,9 @@ private:
     };
 
     struct RegisterImpl : PackageRegister {
-        explicit RegisterImpl(std::shared_ptr<RegisterData> data, std::shared_ptr<PluginLoader> loader = nullptr)
-            : pluginLoader(std::move(loader)), registerData(std::move(data)) {}
+        explicit RegisterImpl(std::shared_ptr<RegisterData> data, std::shared_ptr<PluginLoader> loader = nullptr,
+            std::shared_ptr<PluginLibrary> lib = nullptr)
+            : pluginLoader(std::move(loader)), registerData(std::move(data)), library(std::move(lib)) {}
 
         ~RegisterImpl() override = default;
 
@@ -85,6 +116,14 @@ private:
 
         void UpdateRegisterTableAndRegisterNames(const PluginDefBase& def);
 
+        std::shared_ptr<PluginRegInfo> CreateRegInfo(const PluginDefBase& def);
+
+        void InsertRegInfo(const std::shared_ptr<PluginRegInfo>& regInfo);
+
+        Status AddPluginInfo(const std::shared_ptr<PluginInfo>& info);
+
+        Status BindPlugin(const PluginDefBase& def);
+
         void SetPluginInfo(std::shared_ptr<PluginInfo>& info, const PluginDefBase& def);
 
         Status InitSourceInfo(std::shared_ptr<PluginRegInfo>& reg, const PluginDefBase& def);
@@ -112,11 +151,15 @@ private:
         std::shared_ptr<PluginLoader> pluginLoader;
         std::shared_ptr<RegisterData> registerData;
         std::shared_ptr<PackageDef> packageDef {nullptr};
+        std::shared_ptr<PluginLibrary> library {nullptr};
+        bool bindRegistered {false}; ///< only attach creators to the plugins registered from the manifest
     };
     void DeletePlugin(std::map<std::string, std::shared_ptr<PluginRegInfo>>& plugins,
         std::map<std::string, std::shared_ptr<PluginRegInfo>>::iterator& info);
     std::shared_ptr<RegisterData> registerData_ = std::make_shared<RegisterData>();
     std::vector<std::shared_ptr<PluginLoader>> registeredLoaders_;
+    std::vector<std::shared_ptr<PluginLibrary>> libraries_;
+    std::mutex loaderMutex_;
     std::shared_ptr<RegisterImpl> staticPluginRegister_ = std::make_shared<RegisterImpl>(registerData_);
 public:
     std::shared_ptr<RegisterImpl> GetStaticPluginRegister()
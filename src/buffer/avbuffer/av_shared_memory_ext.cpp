@@ -14,6 +14,7 @@
  */
 
 #include "av_shared_memory_ext.h"
+#include <mutex>
 #include <unistd.h>
 #include "ashmem.h"
 #include "av_shared_allocator.h"
@@ -32,9 +33,16 @@ namespace OHOS {
 namespace Media {
 std::shared_ptr<AVAllocator> AVAllocatorFactory::CreateSharedAllocator(MemoryFlag memFlag)
 {
-    auto allocator = std::shared_ptr<AVSharedAllocator>(new AVSharedAllocator());
-    FALSE_RETURN_V_MSG_E(allocator != nullptr, nullptr, "Create AVSharedAllocator failed, no memory");
-    allocator->memFlag_ = memFlag;
+    // the flag is the only state of the allocator, buffers with the same flag share one instance
+    static std::mutex mutex;
+    static std::shared_ptr<AVSharedAllocator> allocators[UINT8_MAX + 1]; // UINT8_MAX + 1: all the MemoryFlag values
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &allocator = allocators[static_cast<uint8_t>(memFlag)];
+    if (allocator == nullptr) {
+        allocator = std::shared_ptr<AVSharedAllocator>(new AVSharedAllocator());
+        FALSE_RETURN_V_MSG_E(allocator != nullptr, nullptr, "Create AVSharedAllocator failed, no memory");
+        allocator->memFlag_ = memFlag;
+    }
     return allocator;
 }
 
@@ -25,7 +25,8 @@ namespace OHOS {
 namespace Media {
 std::shared_ptr<AVAllocator> AVAllocatorFactory::CreateVirtualAllocator()
 {
-    auto allocator = std::shared_ptr<AVVirtualAllocator>(new AVVirtualAllocator());
+    // the allocator keeps no state, all the virtual buffers share one instance
+    static const auto allocator = std::shared_ptr<AVVirtualAllocator>(new AVVirtualAllocator());
     FALSE_RETURN_V_MSG_E(allocator != nullptr, nullptr, "Create AVVirtualAllocator failed, no memory");
     return allocator;
 }
@@ -150,8 +150,8 @@ std::shared_ptr<AVBuffer> AVBuffer::CreateAVBuffer()
 
 Status AVBuffer::Init(std::shared_ptr<AVAllocator> allocator, int32_t capacity, int32_t align)
 {
-    std::string uidName = std::to_string(GetUniqueId());
-    memory_ = AVMemory::CreateAVMemory(uidName, allocator, capacity, align);
+    // named after the unique id only when the memory is written to a parcel, creating a buffer formats no string
+    memory_ = AVMemory::CreateAVMemory("", allocator, capacity, align);
     FALSE_RETURN_V_MSG_E(memory_ != nullptr, Status::ERROR_UNKNOWN, "Create memory failed");
     return Status::OK;
 }
@@ -206,6 +206,9 @@ bool AVBuffer::WriteToMessageParcel(MessageParcel &parcel)
     if (memory_ != nullptr) {
         MemoryType type = memory_->GetMemoryType();
         FALSE_RETURN_V_MSG_E(type != MemoryType::VIRTUAL_MEMORY, false, "Virtual memory not support");
+        if (memory_->name_.empty()) {
+            memory_->name_ = std::to_string(GetUniqueId());
+        }
 
         ret = ret && bufferParcel.WriteUint8(static_cast<uint8_t>(type)) &&
               memory_->WriteCommonToMessageParcel(bufferParcel) && memory_->WriteToMessageParcel(bufferParcel);
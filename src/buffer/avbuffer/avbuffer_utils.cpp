@@ -82,5 +82,47 @@ bool UnmarshallingConfig(MessageParcel &parcel, AVBufferConfig &config)
 #endif
     return true;
 }
+
+bool MarshallingBufferAttr(MessageParcel &parcel, const std::shared_ptr<AVBuffer> &buffer)
+{
+#ifdef MEDIA_OHOS
+    AVBufferAttr attr;
+    GetBufferAttr(buffer, attr);
+    return parcel.WriteInt64(attr.pts) && parcel.WriteInt64(attr.dts) && parcel.WriteInt64(attr.duration) &&
+           parcel.WriteUint32(attr.flag) && parcel.WriteInt32(attr.size);
+#else
+    return false;
+#endif
+}
+
+bool UnmarshallingBufferAttr(MessageParcel &parcel, AVBufferAttr &attr)
+{
+#ifdef MEDIA_OHOS
+    return parcel.ReadInt64(attr.pts) && parcel.ReadInt64(attr.dts) && parcel.ReadInt64(attr.duration) &&
+           parcel.ReadUint32(attr.flag) && parcel.ReadInt32(attr.size);
+#else
+    return false;
+#endif
+}
+
+void GetBufferAttr(const std::shared_ptr<AVBuffer> &buffer, AVBufferAttr &attr)
+{
+    attr.pts = buffer->pts_;
+    attr.dts = buffer->dts_;
+    attr.duration = buffer->duration_;
+    attr.flag = buffer->flag_;
+    attr.size = buffer->memory_ == nullptr ? -1 : buffer->memory_->GetSize();
+}
+
+void SetBufferAttr(const std::shared_ptr<AVBuffer> &buffer, const AVBufferAttr &attr)
+{
+    buffer->pts_ = attr.pts;
+    buffer->dts_ = attr.dts;
+    buffer->duration_ = attr.duration;
+    buffer->flag_ = attr.flag;
+    if (buffer->memory_ != nullptr && attr.size >= 0) {
+        buffer->memory_->SetSize(attr.size);
+    }
+}
 } // namespace Media
 } // namespace OHOS
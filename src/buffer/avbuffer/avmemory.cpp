@@ -38,19 +38,19 @@ std::shared_ptr<AVMemory> AVMemory::CreateAVMemory(const std::string &name, std:
     std::shared_ptr<AVMemory> mem = nullptr;
     switch (type) {
         case MemoryType::VIRTUAL_MEMORY: {
-            mem = std::shared_ptr<AVMemory>(new AVVirtualMemory());
+            mem = std::make_shared<AVVirtualMemory>();
             break;
         }
         case MemoryType::SURFACE_MEMORY: {
-            mem = std::shared_ptr<AVMemory>(new AVSurfaceMemory());
+            mem = std::make_shared<AVSurfaceMemory>();
             break;
         }
         case MemoryType::SHARED_MEMORY: {
-            mem = std::shared_ptr<AVMemory>(new AVSharedMemoryExt());
+            mem = std::make_shared<AVSharedMemoryExt>();
             break;
         }
         case MemoryType::HARDWARE_MEMORY: {
-            mem = std::shared_ptr<AVMemory>(new AVHardwareMemory());
+            mem = std::make_shared<AVHardwareMemory>();
             break;
         }
         default:
@@ -69,7 +69,7 @@ std::shared_ptr<AVMemory> AVMemory::CreateAVMemory(const std::string &name, std:
 
 std::shared_ptr<AVMemory> AVMemory::CreateAVMemory(uint8_t *ptr, int32_t capacity, int32_t size)
 {
-    std::shared_ptr<AVMemory> mem = std::shared_ptr<AVMemory>(new AVVirtualMemory());
+    std::shared_ptr<AVMemory> mem = std::make_shared<AVVirtualMemory>();
     FALSE_RETURN_V_MSG_E(mem != nullptr, nullptr, "Create AVVirtualMemory failed, no memory");
     mem->name_ = "virtualMemory";
     mem->allocator_ = nullptr;
@@ -83,7 +83,7 @@ std::shared_ptr<AVMemory> AVMemory::CreateAVMemory(MessageParcel &parcel, bool i
 {
 #ifdef MEDIA_OHOS
     if (isSurfaceBuffer) {
-        auto mem = std::shared_ptr<AVMemory>(new AVSurfaceMemory());
+        std::shared_ptr<AVMemory> mem = std::make_shared<AVSurfaceMemory>();
         Status ret = mem->InitSurfaceBuffer(parcel);
         FALSE_RETURN_V_MSG_E(ret == Status::OK, nullptr, "Init AVSurfaceMemory failed");
         return mem;
@@ -95,15 +95,15 @@ std::shared_ptr<AVMemory> AVMemory::CreateAVMemory(MessageParcel &parcel, bool i
             return nullptr;
         }
         case MemoryType::SURFACE_MEMORY: {
-            mem = std::shared_ptr<AVMemory>(new AVSurfaceMemory());
+            mem = std::make_shared<AVSurfaceMemory>();
             break;
         }
         case MemoryType::SHARED_MEMORY: {
-            mem = std::shared_ptr<AVMemory>(new AVSharedMemoryExt());
+            mem = std::make_shared<AVSharedMemoryExt>();
             break;
         }
         case MemoryType::HARDWARE_MEMORY: {
-            mem = std::shared_ptr<AVMemory>(new AVHardwareMemory());
+            mem = std::make_shared<AVHardwareMemory>();
             break;
         }
         default:
@@ -16,6 +16,7 @@
 #ifndef AVBUFFER_UTILS_H
 #define AVBUFFER_UTILS_H
 
+#include <memory>
 #include <unistd.h>
 #include "message_parcel.h"
 #include "buffer/avbuffer_common.h"
@@ -23,8 +24,26 @@
 
 namespace OHOS {
 namespace Media {
+class AVBuffer;
+
+/**
+ * @brief The attributes of a buffer that change every time it is filled. A buffer whose memory the remote side has
+ * already mapped is transferred as its unique id and these attributes instead of the whole buffer.
+ */
+struct AVBufferAttr {
+    int64_t pts = 0;
+    int64_t dts = 0;
+    int64_t duration = 0;
+    uint32_t flag = 0;
+    int32_t size = -1; // -1: the buffer has no memory
+};
+
 [[maybe_unused]] bool MarshallingConfig(MessageParcel &parcel, const AVBufferConfig &config);
 [[maybe_unused]] bool UnmarshallingConfig(MessageParcel &parcel, AVBufferConfig &config);
+[[maybe_unused]] bool MarshallingBufferAttr(MessageParcel &parcel, const std::shared_ptr<AVBuffer> &buffer);
+[[maybe_unused]] bool UnmarshallingBufferAttr(MessageParcel &parcel, AVBufferAttr &attr);
+[[maybe_unused]] void GetBufferAttr(const std::shared_ptr<AVBuffer> &buffer, AVBufferAttr &attr);
+[[maybe_unused]] void SetBufferAttr(const std::shared_ptr<AVBuffer> &buffer, const AVBufferAttr &attr);
 
 template <typename T>
 using MakeUnsigned = typename std::make_unsigned<T>::type;
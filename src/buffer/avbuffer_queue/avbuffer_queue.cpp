@@ -21,13 +21,16 @@
 
 namespace OHOS {
 namespace Media {
+namespace {
+constexpr int32_t RING_POP_TIMEOUT_MS = 100; // 100: bounds how long stopping the ring task takes
+}
 
 std::shared_ptr<AVBufferQueue> AVBufferQueue::Create(
-    uint32_t size, MemoryType type, const std::string& name, bool disableAlloc)
+    uint32_t size, MemoryType type, const std::string& name, bool disableAlloc, AVBufferQueueTransport transport)
 {
-    MEDIA_LOG_D("AVBufferQueue::Create size = %u, type = %u, name = %s",
-                size, static_cast<uint32_t>(type), name.c_str());
-    return std::make_shared<AVBufferQueueImpl>(size, type, name, disableAlloc);
+    MEDIA_LOG_D("AVBufferQueue::Create size = %u, type = %u, name = %s, transport = %u",
+                size, static_cast<uint32_t>(type), name.c_str(), static_cast<uint32_t>(transport));
+    return std::make_shared<AVBufferQueueImpl>(size, type, name, disableAlloc, transport);
 }
 
 std::shared_ptr<AVBufferQueue> AVBufferQueue::CreateAsSurfaceProducer(
@@ -106,14 +109,20 @@ sptr<AVBufferQueueConsumer> AVBufferQueueImpl::GetConsumer()
 AVBufferQueueImpl::AVBufferQueueImpl(const std::string &name)
     : AVBufferQueue(), name_(name), size_(0), memoryType_(MemoryType::UNKNOWN_MEMORY), disableAlloc_(false) {}
 
-AVBufferQueueImpl::AVBufferQueueImpl(uint32_t size, MemoryType type, const std::string &name, bool disableAlloc)
-    : AVBufferQueue(), name_(name), size_(size), memoryType_(type), disableAlloc_(disableAlloc)
+AVBufferQueueImpl::AVBufferQueueImpl(uint32_t size, MemoryType type, const std::string &name, bool disableAlloc,
+                                     AVBufferQueueTransport transport)
+    : AVBufferQueue(), name_(name), size_(size), memoryType_(type), disableAlloc_(disableAlloc), transport_(transport)
 {
     if (size_ > AVBUFFER_QUEUE_MAX_QUEUE_SIZE) {
         size_ = AVBUFFER_QUEUE_MAX_QUEUE_SIZE;
     }
 }
 
+AVBufferQueueImpl::~AVBufferQueueImpl()
+{
+    StopRingTask(ring_, ringTask_);
+}
+
 uint32_t AVBufferQueueImpl::GetQueueSize()
 {
     return size_;
@@ -259,6 +268,8 @@ void AVBufferQueueImpl::DeleteCachedBufferById(uint64_t uniqueId)
     if (it != cachedBufferMap_.end()) {
         cachedBufferMap_.erase(it);
     }
+    remoteBufferIds_.erase(uniqueId);
+    ringBufferIds_.erase(uniqueId);
 }
 
 Status AVBufferQueueImpl::CheckConfig(const AVBufferConfig& config)
@@ -287,6 +298,12 @@ bool AVBufferQueueImpl::wait_for(std::unique_lock<std::mutex>& lock, int32_t tim
 
 Status AVBufferQueueImpl::RequestBuffer(
     std::shared_ptr<AVBuffer>& buffer, const AVBufferConfig& config, int32_t timeoutMs)
+{
+    return RequestBuffer(buffer, config, timeoutMs, false);
+}
+
+Status AVBufferQueueImpl::RequestBuffer(std::shared_ptr<AVBuffer>& buffer, const AVBufferConfig& config,
+                                        int32_t timeoutMs, bool isRingProducer)
 {
     auto configCopy = config;
     if (config.memoryType == MemoryType::UNKNOWN_MEMORY) {
@@ -307,7 +324,13 @@ Status AVBufferQueueImpl::RequestBuffer(
 
     // check queue size
     if (GetCachedBufferCount() >= GetQueueSize()) {
-        FALSE_RETURN_V(wait_for(lock, timeoutMs), Status::ERROR_WAIT_TIMEOUT);
+        // the ring producer has buffers to take from the ring, waiting here would not get it another one
+        FALSE_RETURN_V(!isRingProducer || ring_ == nullptr || ring_->GetCount(AVBufferRing::TO_PRODUCER) == 0,
+                       Status::ERROR_AGAIN);
+        requestWaitCount_++;
+        bool waited = wait_for(lock, timeoutMs);
+        requestWaitCount_--;
+        FALSE_RETURN_V(waited, Status::ERROR_WAIT_TIMEOUT);
 
         // 被条件唤醒后，再次尝试从freeBufferList中取buffer
         ret = PopFromFreeBufferList(buffer, configCopy);
@@ -377,6 +400,7 @@ Status AVBufferQueueImpl::PushBuffer(uint64_t uniqueId, bool available)
                        Status::ERROR_INVALID_BUFFER_STATE);
 
         ele.state = AVBUFFER_STATE_PUSHED;
+        ringBufferIds_.erase(uniqueId);
         buffer = cachedBufferMap_[uniqueId].buffer;
     }
 
@@ -450,6 +474,17 @@ Status AVBufferQueueImpl::ReturnBuffer(const std::shared_ptr<AVBuffer>& buffer,
     return ReturnBuffer(buffer->GetUniqueId(), available);
 }
 
+Status AVBufferQueueImpl::SetBufferAttr(uint64_t uniqueId, const AVBufferAttr& attr)
+{
+    std::lock_guard<std::mutex> lockGuard(queueMutex_);
+    auto it = cachedBufferMap_.find(uniqueId);
+    FALSE_RETURN_V(it != cachedBufferMap_.end(), Status::ERROR_INVALID_BUFFER_ID);
+    FALSE_RETURN_V(it->second.state == AVBUFFER_STATE_REQUESTED || it->second.state == AVBUFFER_STATE_ATTACHED,
+                   Status::ERROR_INVALID_BUFFER_STATE);
+    Media::SetBufferAttr(it->second.buffer, attr);
+    return Status::OK;
+}
+
 Status AVBufferQueueImpl::AttachBuffer(std::shared_ptr<AVBuffer>& buffer, bool isFilled)
 {
     FALSE_RETURN_V(buffer != nullptr, Status::ERROR_NULL_POINT_BUFFER);
@@ -522,6 +557,8 @@ Status AVBufferQueueImpl::DetachBuffer(uint64_t uniqueId, bool force)
     }
 
     cachedBufferMap_.erase(uniqueId);
+    remoteBufferIds_.erase(uniqueId);
+    ringBufferIds_.erase(uniqueId);
 
     return Status::OK;
 }
@@ -568,7 +605,9 @@ Status AVBufferQueueImpl::ReleaseBuffer(uint64_t uniqueId)
             return Status::OK;
         }
 
-        InsertFreeBufferInOrder(uniqueId);
+        if (!PushToRing(uniqueId)) {
+            InsertFreeBufferInOrder(uniqueId);
+        }
 
         requestCondition.notify_all();
     }
@@ -613,5 +652,150 @@ Status AVBufferQueueImpl::SetConsumerListener(sptr<IConsumerListener>& listener)
     return Status::OK;
 }
 
+Status AVBufferQueueImpl::OpenRing(std::shared_ptr<AVBufferRing>& ring)
+{
+    std::lock_guard<std::mutex> lockGuard(queueMutex_);
+    // the channels of the ring have a single writer and reader each
+    FALSE_RETURN_V(transport_ == AVBufferQueueTransport::SHARED_RING && ring_ == nullptr,
+                   Status::ERROR_INVALID_OPERATION);
+    ring_ = AVBufferRing::Create(AVBUFFER_QUEUE_MAX_QUEUE_SIZE);
+    FALSE_RETURN_V(ring_ != nullptr, Status::ERROR_NO_MEMORY);
+    ringTask_ = std::make_shared<Task>(name_ + "RingPush", [this, ring = ring_] { PopFromRing(ring); });
+    ringTask_->Start();
+    ring = ring_;
+    return Status::OK;
+}
+
+Status AVBufferQueueImpl::CloseRing()
+{
+    std::shared_ptr<AVBufferRing> ring = nullptr;
+    std::shared_ptr<Task> ringTask = nullptr;
+    {
+        std::lock_guard<std::mutex> lockGuard(queueMutex_);
+        FALSE_RETURN_V(ring_ != nullptr, Status::ERROR_INVALID_OPERATION);
+        ring = ring_;
+        ringTask = ringTask_;
+        ring_ = nullptr;
+        ringTask_ = nullptr;
+    }
+    StopRingTask(ring, ringTask);
+    // what the producer pushed before it went away still reaches the consumer
+    DrainRing(ring);
+    {
+        std::lock_guard<std::mutex> lockGuard(queueMutex_);
+        size_t count = 0;
+        for (auto uniqueId : ringBufferIds_) {
+            auto it = cachedBufferMap_.find(uniqueId);
+            if (it != cachedBufferMap_.end() && it->second.state == AVBUFFER_STATE_REQUESTED &&
+                CancelBuffer(uniqueId) == Status::OK) {
+                count++;
+            }
+        }
+        MEDIA_LOG_I("ring closed, " PUBLIC_LOG_ZU " buffers given back", count);
+        ringBufferIds_.clear();
+        remoteBufferIds_.clear();
+    }
+
+    std::lock_guard<std::mutex> lockGuard(producerListenerMutex_);
+    if (producerListener_ != nullptr) {
+        producerListener_->OnBufferAvailable();
+    }
+    return Status::OK;
+}
+
+void AVBufferQueueImpl::StopRingTask(const std::shared_ptr<AVBufferRing>& ring, const std::shared_ptr<Task>& ringTask)
+{
+    if (ringTask == nullptr) {
+        return;
+    }
+    ringTask->StopAsync();
+    ring->Wakeup(AVBufferRing::TO_QUEUE);
+    ringTask->Stop();
+}
+
+void AVBufferQueueImpl::AddRemoteBuffer(uint64_t uniqueId)
+{
+    FALSE_RETURN(transport_ == AVBufferQueueTransport::SHARED_RING);
+    std::lock_guard<std::mutex> lockGuard(queueMutex_);
+    if (cachedBufferMap_.find(uniqueId) != cachedBufferMap_.end()) {
+        remoteBufferIds_.insert(uniqueId);
+    }
+}
+
+bool AVBufferQueueImpl::PushToRing(uint64_t uniqueId)
+{
+    // a producer blocked in RequestBuffer is served first, it may not be the producer of the ring
+    if (ring_ == nullptr || requestWaitCount_ > 0 || remoteBufferIds_.count(uniqueId) == 0) {
+        return false;
+    }
+    auto& ele = cachedBufferMap_[uniqueId];
+    AVBufferRingEntry entry;
+    entry.uniqueId = uniqueId;
+    GetBufferAttr(ele.buffer, entry.attr);
+    // called with queueMutex_ held, the queue is the only writer of the channel
+    FALSE_RETURN_V(ring_->Push(AVBufferRing::TO_PRODUCER, entry), false);
+    ele.state = AVBUFFER_STATE_REQUESTED;
+    ringBufferIds_.insert(uniqueId);
+    return true;
+}
+
+void AVBufferQueueImpl::PopFromRing(const std::shared_ptr<AVBufferRing>& ring)
+{
+    // waits without ringPopMutex_, a push over binder flushing the ring meanwhile is not held up
+    if (ring->Wait(AVBufferRing::TO_QUEUE, RING_POP_TIMEOUT_MS)) {
+        DrainRing(ring);
+    }
+}
+
+void AVBufferQueueImpl::FlushRing()
+{
+    std::shared_ptr<AVBufferRing> ring = nullptr;
+    {
+        std::lock_guard<std::mutex> lockGuard(queueMutex_);
+        ring = ring_;
+    }
+    if (ring != nullptr) {
+        DrainRing(ring);
+    }
+}
+
+void AVBufferQueueImpl::DrainRing(const std::shared_ptr<AVBufferRing>& ring)
+{
+    std::lock_guard<std::mutex> ringLock(ringPopMutex_);
+    AVBufferRingEntry entry;
+    while (ring->GetCount(AVBufferRing::TO_QUEUE) > 0 && ring->Pop(AVBufferRing::TO_QUEUE, entry, 0)) {
+        PushFromRing(ring, entry);
+    }
+}
+
+void AVBufferQueueImpl::PushFromRing(const std::shared_ptr<AVBufferRing>& ring, const AVBufferRingEntry& entry)
+{
+    // same as a push over binder, but the producer has already returned, it takes the error with its next push
+    auto ret = SetBufferAttr(entry.uniqueId, entry.attr);
+    if (ret == Status::OK) {
+        ret = PushBuffer(entry.uniqueId, entry.available);
+    }
+    if (ret == Status::OK) {
+        return;
+    }
+    MEDIA_LOG_E("push buffer(%llu) from ring failed, ret = %d", entry.uniqueId, static_cast<int32_t>(ret));
+    ring->SetError(static_cast<int32_t>(ret));
+    {
+        // the producer has let go of the buffer, it would stay requested for good
+        std::lock_guard<std::mutex> lockGuard(queueMutex_);
+        auto it = cachedBufferMap_.find(entry.uniqueId);
+        if (it == cachedBufferMap_.end() || it->second.state != AVBUFFER_STATE_REQUESTED) {
+            return;
+        }
+        ringBufferIds_.erase(entry.uniqueId);
+        CancelBuffer(entry.uniqueId);
+    }
+
+    std::lock_guard<std::mutex> lockGuard(producerListenerMutex_);
+    if (producerListener_ != nullptr) {
+        producerListener_->OnBufferAvailable();
+    }
+}
+
 } // namespace Media
 } // namespace OHOS
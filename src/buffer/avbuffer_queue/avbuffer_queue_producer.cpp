@@ -14,6 +14,7 @@
  */
 
 #include "avbuffer_queue_producer_impl.h"
+#include "common/log.h"
 
 
 namespace OHOS {
@@ -39,6 +40,15 @@ Status AVBufferQueueProducerImpl::RequestBuffer(std::shared_ptr<AVBuffer>& buffe
     return bufferQueue_->RequestBuffer(buffer, config, timeoutMs);
 }
 
+Status AVBufferQueueProducerImpl::RequestBuffer(std::shared_ptr<AVBuffer>& buffer, const AVBufferConfig& config,
+                                                int32_t timeoutMs, bool isRingProducer)
+{
+    if (isRingProducer) {
+        return bufferQueue_->RequestBuffer(buffer, config, timeoutMs, true);
+    }
+    return bufferQueue_->RequestBuffer(buffer, config, timeoutMs);
+}
+
 Status AVBufferQueueProducerImpl::PushBuffer(uint64_t uniqueId, bool available)
 {
     return bufferQueue_->PushBuffer(uniqueId, available);
@@ -59,6 +69,44 @@ Status AVBufferQueueProducerImpl::ReturnBuffer(const std::shared_ptr<AVBuffer>&
     return bufferQueue_->ReturnBuffer(buffer, available);
 }
 
+Status AVBufferQueueProducerImpl::PushBuffer(uint64_t uniqueId, const AVBufferAttr& attr, bool available)
+{
+    // a push over binder comes after whatever its producer has pushed to the ring
+    bufferQueue_->FlushRing();
+    NOK_RETURN(bufferQueue_->SetBufferAttr(uniqueId, attr));
+    return bufferQueue_->PushBuffer(uniqueId, available);
+}
+
+Status AVBufferQueueProducerImpl::RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& buffers, uint32_t count,
+                                                 const AVBufferConfig& config, int32_t timeoutMs)
+{
+    return RequestBuffers(buffers, count, config, timeoutMs, false);
+}
+
+Status AVBufferQueueProducerImpl::RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& buffers, uint32_t count,
+                                                 const AVBufferConfig& config, int32_t timeoutMs, bool isRingProducer)
+{
+    buffers.clear();
+    Status ret = Status::OK;
+    while (buffers.size() < count) {
+        std::shared_ptr<AVBuffer> buffer = nullptr;
+        ret = RequestBuffer(buffer, config, buffers.empty() ? timeoutMs : 0, isRingProducer);
+        if (ret != Status::OK) {
+            break;
+        }
+        buffers.emplace_back(buffer);
+    }
+    return buffers.empty() ? ret : Status::OK;
+}
+
+Status AVBufferQueueProducerImpl::PushBuffers(const std::vector<std::shared_ptr<AVBuffer>>& buffers, bool available)
+{
+    for (auto& buffer : buffers) {
+        NOK_RETURN(bufferQueue_->PushBuffer(buffer, available));
+    }
+    return Status::OK;
+}
+
 Status AVBufferQueueProducerImpl::AttachBuffer(std::shared_ptr<AVBuffer>& buffer, bool isFilled)
 {
     return bufferQueue_->AttachBuffer(buffer, isFilled);
@@ -74,6 +122,21 @@ Status AVBufferQueueProducerImpl::DetachBuffer(const std::shared_ptr<AVBuffer>&
     return bufferQueue_->DetachBuffer(buffer);
 }
 
+Status AVBufferQueueProducerImpl::OpenRing(std::shared_ptr<AVBufferRing>& ring)
+{
+    return bufferQueue_->OpenRing(ring);
+}
+
+Status AVBufferQueueProducerImpl::CloseRing()
+{
+    return bufferQueue_->CloseRing();
+}
+
+void AVBufferQueueProducerImpl::AddRemoteBuffer(uint64_t uniqueId)
+{
+    bufferQueue_->AddRemoteBuffer(uniqueId);
+}
+
 Status AVBufferQueueProducerImpl::SetBufferFilledListener(sptr<IBrokerListener>& listener)
 {
     return bufferQueue_->SetBrokerListener(listener);
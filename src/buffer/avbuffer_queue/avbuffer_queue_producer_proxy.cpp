@@ -14,8 +14,13 @@
  */
 
 #include "buffer/avbuffer_queue_producer_proxy.h"
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include "avbuffer_ring.h"
 #include "avbuffer_utils.h"
 #include "common/log.h"
+#include "ipc_object_stub.h"
 
 namespace OHOS {
 namespace Media {
@@ -39,7 +44,7 @@ class AVBufferQueueProducerProxyImpl : public AVBufferQueueProducerProxy {
 public:
     explicit AVBufferQueueProducerProxyImpl(const sptr<IRemoteObject>& object)
         : AVBufferQueueProducerProxy(object) { }
-    ~AVBufferQueueProducerProxyImpl() override = default;
+    ~AVBufferQueueProducerProxyImpl() override;
     AVBufferQueueProducerProxyImpl(const AVBufferQueueProducerProxyImpl&) = delete;
     AVBufferQueueProducerProxyImpl operator=(const AVBufferQueueProducerProxyImpl&) = delete;
 
@@ -51,6 +56,10 @@ public:
     Status PushBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available) override;
     Status ReturnBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available) override;
 
+    Status RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers, uint32_t count,
+        const AVBufferConfig& config, int32_t timeoutMs) override;
+    Status PushBuffers(const std::vector<std::shared_ptr<AVBuffer>>& inBuffers, bool available) override;
+
     Status AttachBuffer(std::shared_ptr<AVBuffer>& inBuffer, bool isFilled) override;
     Status DetachBuffer(const std::shared_ptr<AVBuffer>& outBuffer) override;
 
@@ -59,6 +68,37 @@ public:
 
 private:
     static inline BrokerDelegator<AVBufferQueueProducerProxyImpl> delegator_;
+
+    using KnownBuffers = std::vector<std::shared_ptr<AVBuffer>>;
+    void WriteKnownIds(MessageParcel& arguments, KnownBuffers& knownBuffers);
+    Status ReadBuffer(MessageParcel& reply, uint64_t uniqueId, const KnownBuffers& knownBuffers,
+                      std::shared_ptr<AVBuffer>& outBuffer);
+    void ReleaseBinderBuffers(const std::vector<uint64_t>& uniqueIds);
+    Status ReturnBinderBuffer(uint64_t uniqueId, bool available);
+    void CacheBuffer(const std::shared_ptr<AVBuffer>& buffer);
+    void UncacheBuffer(uint64_t uniqueId);
+    std::shared_ptr<AVBuffer> FindCachedBuffer(uint64_t uniqueId);
+
+    Status RequestBinderBuffer(std::shared_ptr<AVBuffer>& outBuffer, const AVBufferConfig& config, int32_t timeoutMs);
+    Status RequestBinderBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers, uint32_t count,
+                                const AVBufferConfig& config, int32_t timeoutMs);
+    Status PushBinderBuffers(const std::vector<std::shared_ptr<AVBuffer>>& inBuffers, size_t start, bool available);
+
+    std::shared_ptr<AVBufferRing> GetRing();
+    bool HasRing();
+    bool RequestRingBuffer(std::shared_ptr<AVBuffer>& outBuffer, const AVBufferConfig& config);
+    bool PushRingBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available);
+    Status TakeRingError();
+
+    std::mutex cacheMutex_;
+    // buffers whose memory is mapped in this process, most recently requested first
+    std::list<std::shared_ptr<AVBuffer>> cachedBuffers_;
+
+    std::mutex ringMutex_;
+    bool isRingOpened_ = false;
+    std::shared_ptr<AVBufferRing> ring_ = nullptr;
+    // the queue watches it to close the ring if this process dies
+    sptr<IRemoteObject> ringToken_ = nullptr;
 };
 
 std::shared_ptr<AVBufferQueueProducerProxy> AVBufferQueueProducerProxy::Create(const sptr<IRemoteObject>& object)
@@ -70,6 +110,20 @@ std::shared_ptr<AVBufferQueueProducerProxy> AVBufferQueueProducerProxy::Create(c
 AVBufferQueueProducerProxy::AVBufferQueueProducerProxy(const sptr<IRemoteObject>& object)
     : IRemoteProxy<AVBufferQueueProducer>(object) { }
 
+AVBufferQueueProducerProxyImpl::~AVBufferQueueProducerProxyImpl()
+{
+    // the buffers the queue has handed to the ring go back to it, another producer would wait for them for good
+    if (!HasRing()) {
+        return;
+    }
+    MessageParcel arguments;
+    MessageParcel reply;
+    MessageOption option;
+    if (arguments.WriteInterfaceToken(GetDescriptor())) {
+        (void)Remote()->SendRequest(PRODUCER_CLOSE_RING, arguments, reply, option);
+    }
+}
+
 uint32_t AVBufferQueueProducerProxyImpl::GetQueueSize()
 {
     MessageParcel arguments;
@@ -92,43 +146,312 @@ Status AVBufferQueueProducerProxyImpl::SetQueueSize(uint32_t size)
     return Status::OK;
 }
 
+// the ids sent are kept with their buffers until the reply is read, a buffer evicted from the cache by another
+// request meanwhile is still found when the stub answers with its attributes only
+void AVBufferQueueProducerProxyImpl::WriteKnownIds(MessageParcel& arguments, KnownBuffers& knownBuffers)
+{
+    std::lock_guard<std::mutex> lockGuard(cacheMutex_);
+    knownBuffers.assign(cachedBuffers_.begin(), cachedBuffers_.end());
+    arguments.WriteUint32(static_cast<uint32_t>(knownBuffers.size()));
+    for (auto& buffer : knownBuffers) {
+        arguments.WriteUint64(buffer->GetUniqueId());
+    }
+}
+
+Status AVBufferQueueProducerProxyImpl::ReadBuffer(MessageParcel& reply, uint64_t uniqueId,
+                                                  const KnownBuffers& knownBuffers,
+                                                  std::shared_ptr<AVBuffer>& outBuffer)
+{
+    if (!reply.ReadBool()) {
+        outBuffer = AVBuffer::CreateAVBuffer();
+        FALSE_RETURN_V(outBuffer != nullptr, Status::ERROR_CREATE_BUFFER);
+        FALSE_RETURN_V(outBuffer->ReadFromMessageParcel(reply), Status::ERROR_CREATE_BUFFER);
+        FALSE_RETURN_V(outBuffer->GetUniqueId() == uniqueId, Status::ERROR_INVALID_BUFFER_ID);
+        CacheBuffer(outBuffer);
+        return Status::OK;
+    }
+
+    AVBufferAttr attr;
+    FALSE_RETURN_V(UnmarshallingBufferAttr(reply, attr), Status::ERROR_INVALID_PARAMETER);
+    auto it = std::find_if(knownBuffers.begin(), knownBuffers.end(),
+        [uniqueId](const std::shared_ptr<AVBuffer>& buffer) { return buffer->GetUniqueId() == uniqueId; });
+    FALSE_RETURN_V(it != knownBuffers.end(), Status::ERROR_INVALID_BUFFER_ID);
+    outBuffer = *it;
+    CacheBuffer(outBuffer);
+    SetBufferAttr(outBuffer, attr);
+    // a requested buffer comes back empty, what the producer wrote the last time is not passed on
+    outBuffer->meta_->Clear();
+    return Status::OK;
+}
+
+void AVBufferQueueProducerProxyImpl::CacheBuffer(const std::shared_ptr<AVBuffer>& buffer)
+{
+    std::lock_guard<std::mutex> lockGuard(cacheMutex_);
+    auto uniqueId = buffer->GetUniqueId();
+    cachedBuffers_.remove_if(
+        [uniqueId](const std::shared_ptr<AVBuffer>& cached) { return cached->GetUniqueId() == uniqueId; });
+    cachedBuffers_.emplace_front(buffer);
+    // the queue holds no more buffers than this, older entries are buffers it has deleted
+    if (cachedBuffers_.size() > AVBUFFER_QUEUE_MAX_QUEUE_SIZE) {
+        cachedBuffers_.pop_back();
+    }
+}
+
+void AVBufferQueueProducerProxyImpl::UncacheBuffer(uint64_t uniqueId)
+{
+    std::lock_guard<std::mutex> lockGuard(cacheMutex_);
+    cachedBuffers_.remove_if(
+        [uniqueId](const std::shared_ptr<AVBuffer>& buffer) { return buffer->GetUniqueId() == uniqueId; });
+}
+
+std::shared_ptr<AVBuffer> AVBufferQueueProducerProxyImpl::FindCachedBuffer(uint64_t uniqueId)
+{
+    std::lock_guard<std::mutex> lockGuard(cacheMutex_);
+    auto it = std::find_if(cachedBuffers_.begin(), cachedBuffers_.end(),
+        [uniqueId](const std::shared_ptr<AVBuffer>& buffer) { return buffer->GetUniqueId() == uniqueId; });
+    FALSE_RETURN_V(it != cachedBuffers_.end(), nullptr);
+    cachedBuffers_.splice(cachedBuffers_.begin(), cachedBuffers_, it);
+    return cachedBuffers_.front();
+}
+
+std::shared_ptr<AVBufferRing> AVBufferQueueProducerProxyImpl::GetRing()
+{
+    // asked for once, a queue using binder or whose ring another producer has taken refuses it
+    if (!isRingOpened_) {
+        isRingOpened_ = true;
+        ringToken_ = new IPCObjectStub(u"Media.AVBufferQueueRingToken");
+        MessageParcel arguments;
+        MessageParcel reply;
+        MessageOption option;
+        if (arguments.WriteInterfaceToken(GetDescriptor()) && arguments.WriteRemoteObject(ringToken_) &&
+            Remote()->SendRequest(PRODUCER_OPEN_RING, arguments, reply, option) == 0 &&
+            static_cast<Status>(reply.ReadInt32()) == Status::OK) {
+            ring_ = AVBufferRing::ReadFromMessageParcel(reply);
+        }
+        if (ring_ == nullptr) {
+            ringToken_ = nullptr;
+        }
+        MEDIA_LOG_I("producer ring opened: %d", ring_ != nullptr);
+    }
+    return ring_;
+}
+
+bool AVBufferQueueProducerProxyImpl::HasRing()
+{
+    std::lock_guard<std::mutex> lockGuard(ringMutex_);
+    return ring_ != nullptr;
+}
+
+bool AVBufferQueueProducerProxyImpl::RequestRingBuffer(std::shared_ptr<AVBuffer>& outBuffer,
+                                                       const AVBufferConfig& config)
+{
+    std::lock_guard<std::mutex> lockGuard(ringMutex_);
+    auto ring = GetRing();
+    FALSE_RETURN_V(ring != nullptr, false);
+    AVBufferRingEntry entry;
+    while (ring->Pop(AVBufferRing::TO_PRODUCER, entry, 0)) {
+        auto buffer = FindCachedBuffer(entry.uniqueId);
+        auto configCopy = config;
+        if (buffer != nullptr && configCopy.memoryType == MemoryType::UNKNOWN_MEMORY) {
+            configCopy.memoryType = buffer->GetConfig().memoryType;
+        }
+        if (buffer != nullptr && configCopy <= buffer->GetConfig()) {
+            SetBufferAttr(buffer, entry.attr);
+            buffer->meta_->Clear();
+            outBuffer = buffer;
+            return true;
+        }
+        // too small or not mapped here, cancelled so that a request over binder gets a fitting buffer
+        entry.available = false;
+        FALSE_RETURN_V(ring->Push(AVBufferRing::TO_QUEUE, entry), false);
+    }
+    return false;
+}
+
+bool AVBufferQueueProducerProxyImpl::PushRingBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available)
+{
+    std::lock_guard<std::mutex> lockGuard(ringMutex_);
+    auto ring = GetRing();
+    FALSE_RETURN_V(ring != nullptr, false);
+    AVBufferRingEntry entry;
+    entry.uniqueId = inBuffer->GetUniqueId();
+    GetBufferAttr(inBuffer, entry.attr);
+    entry.available = available;
+    return ring->Push(AVBufferRing::TO_QUEUE, entry);
+}
+
+// the queue takes the pushes from the ring on its own thread, one it failed is reported by a later push
+Status AVBufferQueueProducerProxyImpl::TakeRingError()
+{
+    std::lock_guard<std::mutex> lockGuard(ringMutex_);
+    return ring_ == nullptr ? Status::OK : static_cast<Status>(ring_->TakeError());
+}
+
 Status AVBufferQueueProducerProxyImpl::RequestBuffer(std::shared_ptr<AVBuffer>& outBuffer,
                                                      const AVBufferConfig& config, int32_t timeoutMs)
+{
+    Status ret;
+    do {
+        if (RequestRingBuffer(outBuffer, config)) {
+            return Status::OK;
+        }
+        // the queue has handed a buffer to the ring meanwhile
+        ret = RequestBinderBuffer(outBuffer, config, timeoutMs);
+    } while (ret == Status::ERROR_AGAIN && HasRing());
+    return ret;
+}
+
+Status AVBufferQueueProducerProxyImpl::RequestBinderBuffer(std::shared_ptr<AVBuffer>& outBuffer,
+                                                           const AVBufferConfig& config, int32_t timeoutMs)
 {
     ABQ_IPC_DEFINE_VARIABLES;
 
     MarshallingConfig(arguments, config);
+    arguments.WriteInt32(timeoutMs);
+    KnownBuffers knownBuffers;
+    WriteKnownIds(arguments, knownBuffers);
+    // only the producer of the ring is sent back to take the buffers handed to it, any other one waits here
+    arguments.WriteBool(HasRing());
 
     ABQ_IPC_SEND_REQUEST(PRODUCER_REQUEST_BUFFER);
 
-    outBuffer = AVBuffer::CreateAVBuffer();
-    FALSE_RETURN_V(outBuffer != nullptr, Status::ERROR_CREATE_BUFFER);
-    outBuffer->ReadFromMessageParcel(reply);
-
-    return Status::OK;
+    auto uniqueId = reply.ReadUint64();
+    auto ret = ReadBuffer(reply, uniqueId, knownBuffers, outBuffer);
+    if (ret != Status::OK) {
+        outBuffer = nullptr;
+        ReleaseBinderBuffers({uniqueId});
+    }
+    return ret;
 }
 
 Status AVBufferQueueProducerProxyImpl::PushBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available)
 {
     FALSE_RETURN_V(inBuffer != nullptr, Status::ERROR_NULL_POINT_BUFFER);
+    if (PushRingBuffer(inBuffer, available)) {
+        return TakeRingError();
+    }
 
     ABQ_IPC_DEFINE_VARIABLES;
 
-    arguments.WriteUint64(inBuffer->GetUniqueId());
     arguments.WriteBool(available);
+    arguments.WriteUint64(inBuffer->GetUniqueId());
+    MarshallingBufferAttr(arguments, inBuffer);
 
+    // the queue takes what is left in the ring first, a failure of those is known once it returns
     ABQ_IPC_SEND_REQUEST(PRODUCER_PUSH_BUFFER);
 
+    return TakeRingError();
+}
+
+Status AVBufferQueueProducerProxyImpl::RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers,
+                                                      uint32_t count, const AVBufferConfig& config, int32_t timeoutMs)
+{
+    Status ret;
+    do {
+        outBuffers.clear();
+        std::shared_ptr<AVBuffer> buffer = nullptr;
+        while (outBuffers.size() < count && RequestRingBuffer(buffer, config)) {
+            outBuffers.emplace_back(buffer);
+        }
+        if (!outBuffers.empty()) {
+            return Status::OK;
+        }
+        ret = RequestBinderBuffers(outBuffers, count, config, timeoutMs);
+    } while (ret == Status::ERROR_AGAIN && HasRing());
+    return ret;
+}
+
+Status AVBufferQueueProducerProxyImpl::RequestBinderBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers,
+    uint32_t count, const AVBufferConfig& config, int32_t timeoutMs)
+{
+    ABQ_IPC_DEFINE_VARIABLES;
+
+    MarshallingConfig(arguments, config);
+    arguments.WriteInt32(timeoutMs);
+    arguments.WriteUint32(count);
+    KnownBuffers knownBuffers;
+    WriteKnownIds(arguments, knownBuffers);
+    arguments.WriteBool(HasRing());
+
+    ABQ_IPC_SEND_REQUEST(PRODUCER_REQUEST_BUFFERS);
+
+    // the ids come first, so that all the buffers requested can be given back if one of them can not be read
+    outBuffers.clear();
+    std::vector<uint64_t> uniqueIds(std::min(reply.ReadUint32(), AVBUFFER_QUEUE_MAX_QUEUE_SIZE));
+    for (auto& uniqueId : uniqueIds) {
+        uniqueId = reply.ReadUint64();
+    }
+    for (auto uniqueId : uniqueIds) {
+        std::shared_ptr<AVBuffer> buffer = nullptr;
+        auto ret = ReadBuffer(reply, uniqueId, knownBuffers, buffer);
+        if (ret != Status::OK) {
+            outBuffers.clear();
+            ReleaseBinderBuffers(uniqueIds);
+            return ret;
+        }
+        outBuffers.emplace_back(buffer);
+    }
+
+    return Status::OK;
+}
+
+// buffers requested but not handed to the caller go back to the queue, or they stay requested for good
+void AVBufferQueueProducerProxyImpl::ReleaseBinderBuffers(const std::vector<uint64_t>& uniqueIds)
+{
+    for (auto uniqueId : uniqueIds) {
+        auto ret = ReturnBinderBuffer(uniqueId, false);
+        if (ret != Status::OK) {
+            MEDIA_LOG_E("release buffer uniqueId(%llu) failed: %d", uniqueId, static_cast<int32_t>(ret));
+        }
+    }
+}
+
+Status AVBufferQueueProducerProxyImpl::PushBuffers(const std::vector<std::shared_ptr<AVBuffer>>& inBuffers,
+                                                   bool available)
+{
+    size_t start = 0;
+    for (; start < inBuffers.size(); start++) {
+        FALSE_RETURN_V(inBuffers[start] != nullptr, Status::ERROR_NULL_POINT_BUFFER);
+        if (!PushRingBuffer(inBuffers[start], available)) {
+            break;
+        }
+    }
+    if (start == inBuffers.size()) {
+        return TakeRingError();
+    }
+    NOK_RETURN(PushBinderBuffers(inBuffers, start, available));
+    return TakeRingError();
+}
+
+Status AVBufferQueueProducerProxyImpl::PushBinderBuffers(const std::vector<std::shared_ptr<AVBuffer>>& inBuffers,
+                                                         size_t start, bool available)
+{
+    ABQ_IPC_DEFINE_VARIABLES;
+
+    arguments.WriteBool(available);
+    arguments.WriteUint32(static_cast<uint32_t>(inBuffers.size() - start));
+    for (auto it = inBuffers.begin() + start; it != inBuffers.end(); it++) {
+        FALSE_RETURN_V(*it != nullptr, Status::ERROR_NULL_POINT_BUFFER);
+        arguments.WriteUint64((*it)->GetUniqueId());
+        MarshallingBufferAttr(arguments, *it);
+    }
+
+    ABQ_IPC_SEND_REQUEST(PRODUCER_PUSH_BUFFERS);
+
     return Status::OK;
 }
 
 Status AVBufferQueueProducerProxyImpl::ReturnBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available)
 {
     FALSE_RETURN_V(inBuffer != nullptr, Status::ERROR_NULL_POINT_BUFFER);
+    return ReturnBinderBuffer(inBuffer->GetUniqueId(), available);
+}
 
+Status AVBufferQueueProducerProxyImpl::ReturnBinderBuffer(uint64_t uniqueId, bool available)
+{
     ABQ_IPC_DEFINE_VARIABLES;
 
-    arguments.WriteUint64(inBuffer->GetUniqueId());
+    arguments.WriteUint64(uniqueId);
     arguments.WriteBool(available);
 
     ABQ_IPC_SEND_REQUEST(PRODUCER_RETURN_BUFFER);
@@ -146,6 +469,7 @@ Status AVBufferQueueProducerProxyImpl::AttachBuffer(std::shared_ptr<AVBuffer>& i
     arguments.WriteBool(isFilled);
 
     ABQ_IPC_SEND_REQUEST(PRODUCER_ATTACH_BUFFER);
+    CacheBuffer(inBuffer);
 
     return Status::OK;
 }
@@ -159,6 +483,7 @@ Status AVBufferQueueProducerProxyImpl::DetachBuffer(const std::shared_ptr<AVBuff
     arguments.WriteUint64(outBuffer->GetUniqueId());
 
     ABQ_IPC_SEND_REQUEST(PRODUCER_DETACH_BUFFER);
+    UncacheBuffer(outBuffer->GetUniqueId());
 
     return Status::OK;
 }
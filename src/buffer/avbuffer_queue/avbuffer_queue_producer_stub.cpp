@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include "avbuffer_utils.h"
 #include "avbuffer_queue_producer_impl.h"
 #include "common/log.h"
@@ -21,6 +22,23 @@
 namespace OHOS {
 namespace Media {
 
+class AVBufferQueueProducerStub::RingDeathRecipient : public IRemoteObject::DeathRecipient {
+public:
+    explicit RingDeathRecipient(const wptr<AVBufferQueueProducerStub>& producer) : producer_(producer) { }
+
+    void OnRemoteDied(const wptr<IRemoteObject>& object) override
+    {
+        auto producer = producer_.promote();
+        FALSE_RETURN(producer != nullptr);
+        MEDIA_LOG_W("the producer of the ring died");
+        producer->ReleaseRingToken();
+        (void)producer->CloseRing();
+    }
+
+private:
+    wptr<AVBufferQueueProducerStub> producer_;
+};
+
 AVBufferQueueProducerStub::AVBufferQueueProducerStub()
 {
     stubFuncMap_[PRODUCER_GET_QUEUE_SIZE] = &AVBufferQueueProducerStub::OnGetQueueSize;
@@ -32,6 +50,10 @@ AVBufferQueueProducerStub::AVBufferQueueProducerStub()
     stubFuncMap_[PRODUCER_DETACH_BUFFER] = &AVBufferQueueProducerStub::OnDetachBuffer;
     stubFuncMap_[PRODUCER_SET_FILLED_LISTENER] = &AVBufferQueueProducerStub::OnSetBufferFilledListener;
     stubFuncMap_[PRODUCER_SET_AVAILABLE_LISTENER] = &AVBufferQueueProducerStub::OnSetBufferAvailableListener;
+    stubFuncMap_[PRODUCER_REQUEST_BUFFERS] = &AVBufferQueueProducerStub::OnRequestBuffers;
+    stubFuncMap_[PRODUCER_PUSH_BUFFERS] = &AVBufferQueueProducerStub::OnPushBuffers;
+    stubFuncMap_[PRODUCER_OPEN_RING] = &AVBufferQueueProducerStub::OnOpenRing;
+    stubFuncMap_[PRODUCER_CLOSE_RING] = &AVBufferQueueProducerStub::OnCloseRing;
 }
 
 int AVBufferQueueProducerStub::OnRemoteRequest(
@@ -67,6 +89,37 @@ int32_t AVBufferQueueProducerStub::OnSetQueueSize(
     return 0;
 }
 
+void AVBufferQueueProducerStub::ReadKnownIds(MessageParcel& arguments, std::vector<uint64_t>& knownIds)
+{
+    auto count = std::min(arguments.ReadUint32(), AVBUFFER_QUEUE_MAX_QUEUE_SIZE);
+    for (uint32_t i = 0; i < count; i++) {
+        knownIds.emplace_back(arguments.ReadUint64());
+    }
+}
+
+void AVBufferQueueProducerStub::WriteBuffer(MessageParcel& reply, const std::shared_ptr<AVBuffer>& buffer,
+                                            const std::vector<uint64_t>& knownIds)
+{
+    // the proxy has mapped the memory of a buffer it has seen before, only the attributes are sent again
+    auto uniqueId = buffer->GetUniqueId();
+    bool isKnown = std::find(knownIds.begin(), knownIds.end(), uniqueId) != knownIds.end();
+    reply.WriteBool(isKnown);
+    if (isKnown) {
+        MarshallingBufferAttr(reply, buffer);
+    } else if (buffer->WriteToMessageParcel(reply)) {
+        AddRemoteBuffer(uniqueId);
+    }
+}
+
+Status AVBufferQueueProducerStub::ReadPushBuffer(MessageParcel& arguments, bool available)
+{
+    auto uniqueId = arguments.ReadUint64();
+    AVBufferAttr attr;
+    FALSE_RETURN_V(UnmarshallingBufferAttr(arguments, attr), Status::ERROR_INVALID_PARAMETER);
+
+    return PushBuffer(uniqueId, attr, available);
+}
+
 int32_t AVBufferQueueProducerStub::OnRequestBuffer(
     MessageParcel& arguments, MessageParcel& reply, MessageOption& option)
 {
@@ -74,12 +127,16 @@ int32_t AVBufferQueueProducerStub::OnRequestBuffer(
     AVBufferConfig config;
     UnmarshallingConfig(arguments, config);
     auto timeoutMs = arguments.ReadInt32();
+    std::vector<uint64_t> knownIds;
+    ReadKnownIds(arguments, knownIds);
+    auto isRingProducer = arguments.ReadBool();
 
-    auto ret = RequestBuffer(buffer, config, timeoutMs);
+    auto ret = RequestBuffer(buffer, config, timeoutMs, isRingProducer);
 
     reply.WriteInt32(static_cast<int32_t>(ret));
     if (ret == Status::OK) {
-        buffer->WriteToMessageParcel(reply);
+        reply.WriteUint64(buffer->GetUniqueId());
+        WriteBuffer(reply, buffer, knownIds);
     }
 
     return 0;
@@ -88,10 +145,52 @@ int32_t AVBufferQueueProducerStub::OnRequestBuffer(
 int32_t AVBufferQueueProducerStub::OnPushBuffer(
     MessageParcel& arguments, MessageParcel& reply, MessageOption& option)
 {
-    auto uniqueId = arguments.ReadUint64();
     auto available = arguments.ReadBool();
 
-    auto ret = PushBuffer(uniqueId, available);
+    auto ret = ReadPushBuffer(arguments, available);
+    reply.WriteInt32(static_cast<int32_t>(ret));
+
+    return 0;
+}
+
+int32_t AVBufferQueueProducerStub::OnRequestBuffers(
+    MessageParcel& arguments, MessageParcel& reply, MessageOption& option)
+{
+    std::vector<std::shared_ptr<AVBuffer>> buffers;
+    AVBufferConfig config;
+    UnmarshallingConfig(arguments, config);
+    auto timeoutMs = arguments.ReadInt32();
+    auto count = std::min(arguments.ReadUint32(), AVBUFFER_QUEUE_MAX_QUEUE_SIZE);
+    std::vector<uint64_t> knownIds;
+    ReadKnownIds(arguments, knownIds);
+    auto isRingProducer = arguments.ReadBool();
+
+    auto ret = RequestBuffers(buffers, count, config, timeoutMs, isRingProducer);
+
+    reply.WriteInt32(static_cast<int32_t>(ret));
+    if (ret == Status::OK) {
+        reply.WriteUint32(static_cast<uint32_t>(buffers.size()));
+        for (auto& buffer : buffers) {
+            reply.WriteUint64(buffer->GetUniqueId());
+        }
+        for (auto& buffer : buffers) {
+            WriteBuffer(reply, buffer, knownIds);
+        }
+    }
+
+    return 0;
+}
+
+int32_t AVBufferQueueProducerStub::OnPushBuffers(
+    MessageParcel& arguments, MessageParcel& reply, MessageOption& option)
+{
+    auto available = arguments.ReadBool();
+    auto count = std::min(arguments.ReadUint32(), AVBUFFER_QUEUE_MAX_QUEUE_SIZE);
+
+    auto ret = Status::OK;
+    for (uint32_t i = 0; i < count && ret == Status::OK; i++) {
+        ret = ReadPushBuffer(arguments, available);
+    }
     reply.WriteInt32(static_cast<int32_t>(ret));
 
     return 0;
@@ -156,5 +255,52 @@ int32_t AVBufferQueueProducerStub::OnSetBufferAvailableListener(
     return 0;
 }
 
+int32_t AVBufferQueueProducerStub::OnOpenRing(
+    MessageParcel& arguments, MessageParcel& reply, MessageOption& option)
+{
+    auto token = arguments.ReadRemoteObject();
+    std::shared_ptr<AVBufferRing> ring = nullptr;
+    auto ret = token != nullptr ? OpenRing(ring) : Status::ERROR_INVALID_PARAMETER;
+    // a producer in this process can not die on its own, it closes the ring when it is destroyed
+    if (ret == Status::OK && token->IsProxyObject()) {
+        std::lock_guard<std::mutex> lockGuard(ringTokenMutex_);
+        ringDeathRecipient_ = new RingDeathRecipient(this);
+        ringToken_ = token;
+        if (!ringToken_->AddDeathRecipient(ringDeathRecipient_)) {
+            // a producer which may die unnoticed would keep the buffers handed to the ring for good
+            ringToken_ = nullptr;
+            ringDeathRecipient_ = nullptr;
+            (void)CloseRing();
+            ret = Status::ERROR_INVALID_OPERATION;
+        }
+    }
+    reply.WriteInt32(static_cast<int32_t>(ret));
+    if (ret == Status::OK) {
+        ring->WriteToMessageParcel(reply);
+    }
+
+    return 0;
+}
+
+int32_t AVBufferQueueProducerStub::OnCloseRing(
+    MessageParcel& arguments, MessageParcel& reply, MessageOption& option)
+{
+    ReleaseRingToken();
+    auto ret = CloseRing();
+    reply.WriteInt32(static_cast<int32_t>(ret));
+
+    return 0;
+}
+
+void AVBufferQueueProducerStub::ReleaseRingToken()
+{
+    std::lock_guard<std::mutex> lockGuard(ringTokenMutex_);
+    if (ringToken_ != nullptr) {
+        (void)ringToken_->RemoveDeathRecipient(ringDeathRecipient_);
+    }
+    ringToken_ = nullptr;
+    ringDeathRecipient_ = nullptr;
+}
+
 } // namespace Media
 } // namespace OHOS
@@ -173,6 +173,14 @@ Status AVBufferQueueSurfaceWrapper::ReturnBuffer(const std::shared_ptr<AVBuffer>
     return ReturnBuffer(buffer->GetUniqueId(), available);
 }
 
+Status AVBufferQueueSurfaceWrapper::SetBufferAttr(uint64_t uniqueId, const AVBufferAttr& attr)
+{
+    auto it = cachedBufferMap_.find(uniqueId);
+    FALSE_RETURN_V(it != cachedBufferMap_.end(), Status::ERROR_INVALID_BUFFER_ID);
+    Media::SetBufferAttr(it->second, attr);
+    return Status::OK;
+}
+
 Status AVBufferQueueSurfaceWrapper::AttachBuffer(std::shared_ptr<AVBuffer>& buffer, bool isFilled)
 {
     FALSE_RETURN_V(buffer != nullptr, Status::ERROR_NULL_POINT_BUFFER);
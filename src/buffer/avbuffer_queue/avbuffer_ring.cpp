@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avbuffer_ring.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include "common/log.h"
+// ashmem only exists on the device, __OHOS__ is set by its toolchain whatever the build defines
+#ifdef __OHOS__
+#include "ashmem.h"
+#endif
+
+namespace OHOS {
+namespace Media {
+namespace {
+constexpr uint32_t RING_MAGIC = 0x41564252; // 0x41564252: "AVBR"
+constexpr size_t CACHE_LINE_SIZE = 64;
+} // namespace
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring indexes are shared between processes");
+static_assert(std::is_trivially_copyable<AVBufferRingEntry>::value, "ring entries are copied between processes");
+
+struct AVBufferRing::ChannelHeader {
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head; // entries pushed, written by the writer only
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail; // entries popped, written by the reader only
+    std::atomic<uint32_t> waiting;                        // the reader is blocked on the eventfd
+    std::atomic<uint32_t> wakeups;                        // calls to Wakeup, a blocked reader returns on a change
+};
+
+struct AVBufferRing::RingHeader {
+    uint32_t magic;
+    uint32_t slotCount;
+    std::atomic<int32_t> error; // last push from the ring the queue failed, 0 once the producer has taken it
+    ChannelHeader channels[CHANNEL_COUNT];
+};
+
+size_t AVBufferRing::GetMemSize(uint32_t slotCount)
+{
+    return sizeof(RingHeader) + CHANNEL_COUNT * slotCount * sizeof(AVBufferRingEntry);
+}
+
+std::shared_ptr<AVBufferRing> AVBufferRing::Create(uint32_t slotCount)
+{
+    FALSE_RETURN_V_MSG_E(slotCount > 0, nullptr, "slot count is invalid");
+    auto ring = std::shared_ptr<AVBufferRing>(new AVBufferRing());
+    size_t size = GetMemSize(slotCount);
+#ifdef __OHOS__
+    int32_t memFd = AshmemCreate("avbuffer_ring", size);
+#else
+    int32_t memFd = memfd_create("avbuffer_ring", MFD_CLOEXEC);
+    if (memFd >= 0 && ftruncate(memFd, static_cast<off_t>(size)) != 0) {
+        (void)::close(memFd);
+        memFd = -1;
+    }
+#endif
+    FALSE_RETURN_V_MSG_E(memFd >= 0, nullptr, "create ring memory failed, size " PUBLIC_LOG_ZU, size);
+    FALSE_RETURN_V(ring->Map(memFd, size), nullptr);
+    for (auto& fd : ring->eventFds_) {
+        fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        FALSE_RETURN_V_MSG_E(fd >= 0, nullptr, "create ring eventfd failed");
+    }
+    ring->header_->slotCount = slotCount;
+    ring->slotCount_ = slotCount;
+    new (&ring->header_->error) std::atomic<int32_t> {0};
+    for (auto& channel : ring->header_->channels) {
+        new (&channel) ChannelHeader {};
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    ring->header_->magic = RING_MAGIC;
+    return ring;
+}
+
+std::shared_ptr<AVBufferRing> AVBufferRing::Open(int32_t memFd, const int32_t (&eventFds)[CHANNEL_COUNT])
+{
+    auto ring = std::shared_ptr<AVBufferRing>(new AVBufferRing());
+    for (uint32_t i = 0; i < CHANNEL_COUNT; i++) {
+        ring->eventFds_[i] = eventFds[i];
+    }
+    int64_t memSize = -1;
+    if (memFd >= 0) {
+#ifdef __OHOS__
+        memSize = AshmemGetSize(memFd);
+#else
+        struct stat memStat {};
+        memSize = fstat(memFd, &memStat) == 0 ? memStat.st_size : -1;
+#endif
+    }
+    if (memSize < static_cast<int64_t>(sizeof(RingHeader))) {
+        MEDIA_LOG_E("ring memory is invalid, size " PUBLIC_LOG_D64, memSize);
+        if (memFd >= 0) {
+            (void)::close(memFd);
+        }
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(memSize);
+    FALSE_RETURN_V(ring->Map(memFd, size), nullptr);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t slotCount = ring->header_->slotCount;
+    FALSE_RETURN_V_MSG_E(ring->header_->magic == RING_MAGIC && slotCount > 0 && GetMemSize(slotCount) <= size,
+        nullptr, "ring header is invalid");
+    ring->slotCount_ = slotCount;
+    for (auto fd : ring->eventFds_) {
+        FALSE_RETURN_V_MSG_E(fd >= 0, nullptr, "ring eventfd is invalid");
+    }
+    return ring;
+}
+
+AVBufferRing::~AVBufferRing()
+{
+    if (header_ != nullptr) {
+        (void)::munmap(header_, memSize_);
+        header_ = nullptr;
+    }
+    if (memFd_ >= 0) {
+        (void)::close(memFd_);
+        memFd_ = -1;
+    }
+    for (auto& fd : eventFds_) {
+        if (fd >= 0) {
+            (void)::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+bool AVBufferRing::Map(int32_t memFd, size_t size)
+{
+    memFd_ = memFd;
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memFd, 0);
+    FALSE_RETURN_V_MSG_E(addr != MAP_FAILED, false, "map ring memory failed, size " PUBLIC_LOG_ZU, size);
+    header_ = static_cast<RingHeader*>(addr);
+    memSize_ = size;
+    return true;
+}
+
+AVBufferRingEntry* AVBufferRing::GetSlots(Channel channel)
+{
+    auto slots = reinterpret_cast<AVBufferRingEntry*>(reinterpret_cast<uint8_t*>(header_) + sizeof(RingHeader));
+    return slots + channel * slotCount_;
+}
+
+bool AVBufferRing::Push(Channel channel, const AVBufferRingEntry& entry)
+{
+    FALSE_RETURN_V(channel < CHANNEL_COUNT, false);
+    auto& header = header_->channels[channel];
+    uint32_t head = header.head.load(std::memory_order_relaxed);
+    if (head - header.tail.load(std::memory_order_acquire) >= slotCount_) {
+        return false;
+    }
+    GetSlots(channel)[head % slotCount_] = entry;
+    // the reader sets waiting before it checks head a last time, one of both sees the other
+    header.head.store(head + 1, std::memory_order_seq_cst);
+    if (header.waiting.load(std::memory_order_seq_cst) != 0) {
+        Signal(channel);
+    }
+    return true;
+}
+
+bool AVBufferRing::Pop(Channel channel, AVBufferRingEntry& entry, int32_t timeoutMs)
+{
+    FALSE_RETURN_V(channel < CHANNEL_COUNT, false);
+    auto& header = header_->channels[channel];
+    uint32_t tail = header.tail.load(std::memory_order_relaxed);
+    if (header.head.load(std::memory_order_acquire) == tail) {
+        FALSE_RETURN_V(timeoutMs != 0, false);
+        FALSE_RETURN_V(Wait(channel, timeoutMs), false);
+    }
+    entry = GetSlots(channel)[tail % slotCount_];
+    header.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool AVBufferRing::Wait(Channel channel, int32_t timeoutMs)
+{
+    FALSE_RETURN_V(channel < CHANNEL_COUNT, false);
+    auto& header = header_->channels[channel];
+    uint32_t tail = header.tail.load(std::memory_order_relaxed);
+    uint32_t wakeups = header.wakeups.load(std::memory_order_acquire);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        header.waiting.store(1, std::memory_order_seq_cst);
+        if (header.head.load(std::memory_order_seq_cst) != tail) {
+            break;
+        }
+        int32_t waitMs = timeoutMs;
+        if (timeoutMs > 0) {
+            auto leftMs = std::chrono::ceil<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            waitMs = static_cast<int32_t>(std::max<int64_t>(leftMs, 0));
+        }
+        pollfd event = {eventFds_[channel], POLLIN, 0};
+        int ret = ::poll(&event, 1, waitMs);
+        // drained whoever wrote it, a signal of a push the reader has already taken wakes it for nothing
+        uint64_t count = 0;
+        (void)::read(eventFds_[channel], &count, sizeof(count));
+        if (header.head.load(std::memory_order_acquire) != tail) {
+            break;
+        }
+        if (ret == 0 || header.wakeups.load(std::memory_order_acquire) != wakeups) {
+            header.waiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    header.waiting.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void AVBufferRing::Signal(Channel channel)
+{
+    uint64_t count = 1;
+    (void)::write(eventFds_[channel], &count, sizeof(count));
+}
+
+void AVBufferRing::Wakeup(Channel channel)
+{
+    FALSE_RETURN(channel < CHANNEL_COUNT);
+    header_->channels[channel].wakeups.fetch_add(1, std::memory_order_release);
+    Signal(channel);
+}
+
+void AVBufferRing::SetError(int32_t error)
+{
+    header_->error.store(error, std::memory_order_release);
+}
+
+int32_t AVBufferRing::TakeError()
+{
+    return header_->error.exchange(0, std::memory_order_acq_rel);
+}
+
+uint32_t AVBufferRing::GetCount(Channel channel) const
+{
+    FALSE_RETURN_V(channel < CHANNEL_COUNT, 0);
+    auto& header = header_->channels[channel];
+    return header.head.load(std::memory_order_acquire) - header.tail.load(std::memory_order_acquire);
+}
+
+uint32_t AVBufferRing::GetSlotCount() const
+{
+    return slotCount_;
+}
+
+int32_t AVBufferRing::GetMemFd() const
+{
+    return memFd_;
+}
+
+int32_t AVBufferRing::GetEventFd(Channel channel) const
+{
+    return channel < CHANNEL_COUNT ? eventFds_[channel] : -1;
+}
+
+bool AVBufferRing::WriteToMessageParcel(MessageParcel& parcel)
+{
+    return parcel.WriteFileDescriptor(memFd_) && parcel.WriteFileDescriptor(eventFds_[TO_QUEUE]) &&
+           parcel.WriteFileDescriptor(eventFds_[TO_PRODUCER]);
+}
+
+std::shared_ptr<AVBufferRing> AVBufferRing::ReadFromMessageParcel(MessageParcel& parcel)
+{
+    int32_t memFd = parcel.ReadFileDescriptor();
+    int32_t eventFds[CHANNEL_COUNT] = {parcel.ReadFileDescriptor(), parcel.ReadFileDescriptor()};
+    return Open(memFd, eventFds);
+}
+} // namespace Media
+} // namespace OHOS
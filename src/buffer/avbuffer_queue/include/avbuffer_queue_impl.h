@@ -18,10 +18,14 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <mutex>
 #include <condition_variable>
+#include "avbuffer_ring.h"
+#include "avbuffer_utils.h"
 #include "buffer/avbuffer_queue.h"
+#include "osal/task/task.h"
 
 namespace OHOS {
 namespace Media {
@@ -49,8 +53,9 @@ class AVBufferQueueConsumerImpl;
 class AVBufferQueueImpl : public AVBufferQueue, public std::enable_shared_from_this<AVBufferQueueImpl> {
 public:
     explicit AVBufferQueueImpl(const std::string &name);
-    AVBufferQueueImpl(uint32_t size, MemoryType type, const std::string &name, bool disableAlloc = false);
-    ~AVBufferQueueImpl() override = default;
+    AVBufferQueueImpl(uint32_t size, MemoryType type, const std::string &name, bool disableAlloc = false,
+                      AVBufferQueueTransport transport = AVBufferQueueTransport::BINDER);
+    ~AVBufferQueueImpl() override;
     AVBufferQueueImpl(const AVBufferQueueImpl&) = delete;
     AVBufferQueueImpl operator=(const AVBufferQueueImpl&) = delete;
 
@@ -69,10 +74,15 @@ public:
 
     virtual Status RequestBuffer(std::shared_ptr<AVBuffer>& buffer,
                           const AVBufferConfig& config, int32_t timeoutMs);
+    // the producer of the ring is told to take the buffers handed to the ring instead of waiting for one here
+    Status RequestBuffer(std::shared_ptr<AVBuffer>& buffer, const AVBufferConfig& config, int32_t timeoutMs,
+                         bool isRingProducer);
     virtual Status PushBuffer(uint64_t uniqueId, bool available);
     virtual Status PushBuffer(const std::shared_ptr<AVBuffer>& buffer, bool available);
     virtual Status ReturnBuffer(uint64_t uniqueId, bool available);
     virtual Status ReturnBuffer(const std::shared_ptr<AVBuffer>& buffer, bool available);
+    // update the buffer a remote producer has filled, before it is pushed
+    virtual Status SetBufferAttr(uint64_t uniqueId, const AVBufferAttr& attr);
 
     virtual Status AttachBuffer(std::shared_ptr<AVBuffer>& buffer, bool isFilled);
     virtual Status DetachBuffer(uint64_t uniqueId);
@@ -85,6 +95,15 @@ public:
     virtual Status SetProducerListener(sptr<IProducerListener>& listener);
     virtual Status SetConsumerListener(sptr<IConsumerListener>& listener);
 
+    // hand the shared ring to a remote producer, only the first one gets it
+    virtual Status OpenRing(std::shared_ptr<AVBufferRing>& ring);
+    // the producer of the ring is gone, the buffers handed to the ring are given back to the queue
+    virtual Status CloseRing();
+    // take what the ring producer pushed to the ring before a push over binder, so that its pushes keep their order
+    virtual void FlushRing();
+    // the memory of the buffer has been mapped by a remote producer
+    virtual void AddRemoteBuffer(uint64_t uniqueId);
+
 protected:
     std::string name_;
 
@@ -118,6 +137,14 @@ private:
     std::list<uint64_t> dirtyBufferList_;
 
     std::condition_variable requestCondition;
+    uint32_t requestWaitCount_ {0};
+
+    AVBufferQueueTransport transport_ {AVBufferQueueTransport::BINDER};
+    std::shared_ptr<AVBufferRing> ring_;
+    std::shared_ptr<Task> ringTask_;
+    std::set<uint64_t> remoteBufferIds_;
+    std::set<uint64_t> ringBufferIds_; // handed to the ring and not pushed back yet
+    std::mutex ringPopMutex_;          // entries are popped and pushed to the queue one reader at a time
 
     Status CheckConfig(const AVBufferConfig& config);
 
@@ -135,6 +162,12 @@ private:
 
     void DeleteBuffers(uint32_t count);
     void DeleteCachedBufferById(uint64_t uniqueId_);
+
+    bool PushToRing(uint64_t uniqueId);
+    void PopFromRing(const std::shared_ptr<AVBufferRing>& ring);
+    void DrainRing(const std::shared_ptr<AVBufferRing>& ring);
+    void PushFromRing(const std::shared_ptr<AVBufferRing>& ring, const AVBufferRingEntry& entry);
+    static void StopRingTask(const std::shared_ptr<AVBufferRing>& ring, const std::shared_ptr<Task>& ringTask);
 };
 
 class AVBufferQueueSurfaceWrapper : public AVBufferQueueImpl {
@@ -162,6 +195,7 @@ public:
     Status PushBuffer(const std::shared_ptr<AVBuffer>& buffer, bool available) override;
     Status ReturnBuffer(uint64_t uniqueId, bool available) override;
     Status ReturnBuffer(const std::shared_ptr<AVBuffer>& buffer, bool available) override;
+    Status SetBufferAttr(uint64_t uniqueId, const AVBufferAttr& attr) override;
 
     Status AttachBuffer(std::shared_ptr<AVBuffer>& buffer, bool isFilled) override;
     Status DetachBuffer(uint64_t uniqueId) override;
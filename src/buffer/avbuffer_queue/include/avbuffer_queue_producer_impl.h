@@ -36,21 +36,40 @@ public:
     Status PushBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available) override = 0;
     Status ReturnBuffer(const std::shared_ptr<AVBuffer>& inBuffer, bool available) override = 0;
 
+    Status RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers, uint32_t count,
+                          const AVBufferConfig& config, int32_t timeoutMs) override = 0;
+    Status PushBuffers(const std::vector<std::shared_ptr<AVBuffer>>& inBuffers, bool available) override = 0;
+
     Status AttachBuffer(std::shared_ptr<AVBuffer>& inBuffer, bool isFilled) override = 0;
     Status DetachBuffer(const std::shared_ptr<AVBuffer>& outBuffer) override = 0;
 
     Status SetBufferFilledListener(sptr<IBrokerListener>& listener) override = 0;
     Status SetBufferAvailableListener(sptr<IProducerListener>& listener) override = 0;
 
+    virtual Status RequestBuffer(std::shared_ptr<AVBuffer>& outBuffer, const AVBufferConfig& config,
+                                 int32_t timeoutMs, bool isRingProducer) = 0;
+    virtual Status RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& outBuffers, uint32_t count,
+                                  const AVBufferConfig& config, int32_t timeoutMs, bool isRingProducer) = 0;
     virtual Status PushBuffer(uint64_t uniqueId, bool available) = 0;
+    virtual Status PushBuffer(uint64_t uniqueId, const AVBufferAttr& attr, bool available) = 0;
     virtual Status ReturnBuffer(uint64_t uniqueId, bool available) = 0;
     virtual Status DetachBuffer(uint64_t uniqueId) = 0;
+    virtual Status OpenRing(std::shared_ptr<AVBufferRing>& ring) = 0;
+    virtual Status CloseRing() = 0;
+    virtual void AddRemoteBuffer(uint64_t uniqueId) = 0;
 
 private:
+    class RingDeathRecipient;
     using StubFunc = int32_t (AVBufferQueueProducerStub::*)(MessageParcel&, MessageParcel&, MessageOption&);
 
     std::map<uint32_t, StubFunc>  stubFuncMap_;
 
+    static void ReadKnownIds(MessageParcel& arguments, std::vector<uint64_t>& knownIds);
+    void WriteBuffer(MessageParcel& reply, const std::shared_ptr<AVBuffer>& buffer,
+                     const std::vector<uint64_t>& knownIds);
+    Status ReadPushBuffer(MessageParcel& arguments, bool available);
+    void ReleaseRingToken();
+
     int32_t OnGetQueueSize(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
     int32_t OnSetQueueSize(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
 
@@ -58,11 +77,22 @@ private:
     int32_t OnPushBuffer(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
     int32_t OnReturnBuffer(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
 
+    int32_t OnRequestBuffers(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
+    int32_t OnPushBuffers(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
+
     int32_t OnAttachBuffer(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
     int32_t OnDetachBuffer(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
 
     int32_t OnSetBufferFilledListener(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
     int32_t OnSetBufferAvailableListener(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
+
+    int32_t OnOpenRing(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
+    int32_t OnCloseRing(MessageParcel& arguments, MessageParcel& reply, MessageOption& option);
+
+    std::mutex ringTokenMutex_;
+    // held by the producer of the ring, the ring is closed when its process dies
+    sptr<IRemoteObject> ringToken_;
+    sptr<IRemoteObject::DeathRecipient> ringDeathRecipient_;
 };
 
 class AVBufferQueueProducerImpl : public AVBufferQueueProducerStub {
@@ -80,6 +110,10 @@ public:
     Status PushBuffer(const std::shared_ptr<AVBuffer>& buffer, bool available) override;
     Status ReturnBuffer(const std::shared_ptr<AVBuffer>& buffer, bool available) override;
 
+    Status RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& buffers, uint32_t count,
+                          const AVBufferConfig& config, int32_t timeoutMs) override;
+    Status PushBuffers(const std::vector<std::shared_ptr<AVBuffer>>& buffers, bool available) override;
+
     Status AttachBuffer(std::shared_ptr<AVBuffer>& buffer, bool isFilled) override;
     Status DetachBuffer(const std::shared_ptr<AVBuffer>& buffer) override;
 
@@ -89,9 +123,17 @@ public:
 protected:
     std::shared_ptr<AVBufferQueueImpl> bufferQueue_;
 
+    Status RequestBuffer(std::shared_ptr<AVBuffer>& buffer, const AVBufferConfig& config, int32_t timeoutMs,
+                         bool isRingProducer) override;
+    Status RequestBuffers(std::vector<std::shared_ptr<AVBuffer>>& buffers, uint32_t count,
+                          const AVBufferConfig& config, int32_t timeoutMs, bool isRingProducer) override;
     Status PushBuffer(uint64_t uniqueId, bool available) override;
+    Status PushBuffer(uint64_t uniqueId, const AVBufferAttr& attr, bool available) override;
     Status ReturnBuffer(uint64_t uniqueId, bool available) override;
     Status DetachBuffer(uint64_t uniqueId) override;
+    Status OpenRing(std::shared_ptr<AVBufferRing>& ring) override;
+    Status CloseRing() override;
+    void AddRemoteBuffer(uint64_t uniqueId) override;
 };
 
 } // namespace Media
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_FOUNDATION_AVBUFFER_RING_H
+#define HISTREAMER_FOUNDATION_AVBUFFER_RING_H
+
+#include <memory>
+#include "avbuffer_utils.h"
+
+namespace OHOS {
+namespace Media {
+
+using AVBufferRingEntry = struct AVBufferRingEntry {
+    uint64_t uniqueId = 0;
+    AVBufferAttr attr;
+    bool available = true;
+};
+
+/**
+ * @brief Control ring shared by the queue process and the process of a remote producer.
+ *
+ * Each channel is a single producer single consumer ring of buffer ids with their attributes, held in shared memory
+ * (ashmem, memfd on plain linux). Passing a buffer is a copy into the slot and an atomic index store, the eventfd of
+ * the channel is only written when its reader is blocked waiting for an entry. The buffer memory itself is shared
+ * beforehand through the parcel of the buffer.
+ */
+class AVBufferRing {
+public:
+    enum Channel : uint32_t {
+        TO_QUEUE = 0,    // buffers pushed by the remote producer
+        TO_PRODUCER = 1, // buffers the queue has requested on behalf of the remote producer
+        CHANNEL_COUNT = 2,
+    };
+
+    static std::shared_ptr<AVBufferRing> Create(uint32_t slotCount);
+    // map a ring created by the peer, takes the ownership of the file descriptors
+    static std::shared_ptr<AVBufferRing> Open(int32_t memFd, const int32_t (&eventFds)[CHANNEL_COUNT]);
+
+    ~AVBufferRing();
+    AVBufferRing(const AVBufferRing&) = delete;
+    AVBufferRing operator=(const AVBufferRing&) = delete;
+
+    // returns false if the channel is full
+    bool Push(Channel channel, const AVBufferRingEntry& entry);
+    // returns false if no entry arrives within timeoutMs, a negative timeout waits forever
+    bool Pop(Channel channel, AVBufferRingEntry& entry, int32_t timeoutMs);
+    // returns true once channel has an entry, false on timeout or Wakeup, does not pop it
+    bool Wait(Channel channel, int32_t timeoutMs);
+    // make a Pop or Wait blocked on channel return false, to stop its reader
+    void Wakeup(Channel channel);
+
+    // the queue reports a pushed entry it could not take, the producer takes the last error with a later push
+    void SetError(int32_t error);
+    int32_t TakeError();
+
+    // entries pushed to channel that its reader has not popped yet
+    uint32_t GetCount(Channel channel) const;
+    uint32_t GetSlotCount() const;
+    int32_t GetMemFd() const;
+    int32_t GetEventFd(Channel channel) const;
+
+    bool WriteToMessageParcel(MessageParcel& parcel);
+    static std::shared_ptr<AVBufferRing> ReadFromMessageParcel(MessageParcel& parcel);
+
+private:
+    struct ChannelHeader;
+    struct RingHeader;
+
+    AVBufferRing() = default;
+    bool Map(int32_t memFd, size_t size);
+    AVBufferRingEntry* GetSlots(Channel channel);
+    void Signal(Channel channel);
+    static size_t GetMemSize(uint32_t slotCount);
+
+    int32_t memFd_ {-1};
+    int32_t eventFds_[CHANNEL_COUNT] {-1, -1};
+    size_t memSize_ {0};
+    // validated once, the copy in the shared memory is writable by the peer
+    uint32_t slotCount_ {0};
+    RingHeader* header_ {nullptr};
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // HISTREAMER_FOUNDATION_AVBUFFER_RING_H
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
 #include "buffer/avsharedmemorybase.h"
 #include "common/avsharedmemorypool.h"
 #include "common/log.h"
@@ -20,6 +22,13 @@
 
 namespace {
     constexpr int32_t MAX_MEM_SIZE = 100 * 1024 * 1024;
+    constexpr uint32_t SIZE_BITS = 32;
+
+    // class k holds the sizes in (2^(k-1), 2^k]
+    uint32_t SizeClass(int32_t size)
+    {
+        return (size <= 1) ? 0 : SIZE_BITS - static_cast<uint32_t>(__builtin_clz(static_cast<uint32_t>(size - 1)));
+    }
 }
 
 namespace OHOS {
@@ -53,7 +62,7 @@ int32_t AVSharedMemoryPool::Init(const InitializeOption &option)
     for (uint32_t i = 0; i < option_.preAllocMemCnt; ++i) {
         auto memory = AllocMemory(option_.memSize);
         FALSE_RETURN_V_MSG_E(memory != nullptr, -1, "failed to AllocMemory");
-        idleList_.push_back(memory);
+        PushIdle(memory);
     }
 
     inited_ = true;
@@ -66,7 +75,6 @@ AVSharedMemory *AVSharedMemoryPool::AllocMemory(int32_t size)
     AVSharedMemoryBase *memory = new (std::nothrow) AVSharedMemoryBase(size, option_.flags, name_);
     FALSE_RETURN_V_MSG_E(memory != nullptr, nullptr, "create object failed");
     ON_SCOPE_EXIT(0) { delete memory; };
-    memory->Init();
     int32_t ret = memory->Init();
     FALSE_RETURN_V_MSG_E(ret == 0, nullptr, "init avsharedmemorybase failed");
 
@@ -74,70 +82,115 @@ AVSharedMemory *AVSharedMemoryPool::AllocMemory(int32_t size)
     return memory;
 }
 
-void AVSharedMemoryPool::ReleaseMemory(AVSharedMemory *memory)
+void AVSharedMemoryPool::PushIdle(AVSharedMemory *memory)
 {
-    FALSE_LOG_MSG(memory != nullptr, "memory is nullptr");
-    std::unique_lock<std::mutex> lock(mutex_);
+    // ahead of the blocks of the same size, the most recently used block is handed out first
+    int32_t size = memory->GetSize();
+    idleMems_.emplace_hint(idleMems_.lower_bound(size), size, memory);
+}
 
-    for (auto iter = busyList_.begin(); iter != busyList_.end(); ++iter) {
-        if (*iter != memory) {
-            continue;
-        }
+AVSharedMemory *AVSharedMemoryPool::PopIdle(int32_t size)
+{
+    // the smallest idle block which is large enough
+    auto iter = idleMems_.lower_bound(size);
+    if (iter == idleMems_.end()) {
+        return nullptr;
+    }
+    AVSharedMemory *memory = iter->second;
+    idleMems_.erase(iter);
+    return memory;
+}
+
+AVSharedMemory *AVSharedMemoryPool::PopSmallestIdle()
+{
+    if (idleMems_.empty()) {
+        return nullptr;
+    }
+    AVSharedMemory *memory = idleMems_.begin()->second;
+    idleMems_.erase(idleMems_.begin());
+    return memory;
+}
 
-        busyList_.erase(iter);
-        idleList_.push_back(memory);
-        cond_.notify_all();
-        MEDIA_LOG_D("0x%{public}06" PRIXPTR " released back to pool %{public}s",
-                    FAKE_POINTER(memory), name_.c_str());
+uint32_t AVSharedMemoryPool::TrackBusy(AVSharedMemory *memory)
+{
+    uint32_t index;
+    if (freeBusyIndexes_.empty()) {
+        index = static_cast<uint32_t>(busyEntries_.size());
+        busyEntries_.emplace_back();
+    } else {
+        index = freeBusyIndexes_.back();
+        freeBusyIndexes_.pop_back();
+    }
+    busyEntries_[index].memory = memory;
+    busyEntries_[index].generation = generation_;
+    busyCnt_++;
+    return index;
+}
 
-        lock.unlock();
-        if (notifier_ != nullptr) {
-            notifier_();
+void AVSharedMemoryPool::NotifyWaiters(int32_t releasedSize)
+{
+    // waiters up to the class of the released block may be satisfied by it, while without fixed size any idle
+    // block can be reallocated for any waiter
+    uint32_t topClass = option_.enableFixedSize ? SizeClass(releasedSize) : SIZE_CLASS_NUM - 1;
+    for (uint32_t i = 0; i <= topClass; ++i) {
+        if (waiterCnts_[i] > 0) {
+            conds_[i].notify_one();
         }
-        return;
     }
-
-    MEDIA_LOG_E("0x%{public}06" PRIXPTR " is no longer managed by this pool", FAKE_POINTER(memory));
-    delete memory;
 }
 
-bool AVSharedMemoryPool::DoAcquireMemory(int32_t size, AVSharedMemory **outMemory)
+void AVSharedMemoryPool::ReleaseMemory(AVSharedMemory *memory, uint32_t index)
 {
-    MEDIA_LOG_D("busylist size " PUBLIC_LOG_ZU ", idlelist size " PUBLIC_LOG_ZU, busyList_.size(), idleList_.size());
+    FALSE_RETURN_MSG(memory != nullptr, "memory is nullptr");
+    std::unique_lock<std::mutex> lock(mutex_);
 
-    AVSharedMemory *result = nullptr;
-    std::list<AVSharedMemory *>::iterator minSizeIdleMem = idleList_.end();
-    int32_t minIdleSize = std::numeric_limits<int32_t>::max();
+    if (index >= busyEntries_.size() || busyEntries_[index].memory != memory) {
+        MEDIA_LOG_E("0x%{public}06" PRIXPTR " is no longer managed by this pool", FAKE_POINTER(memory));
+        delete memory;
+        return;
+    }
+    bool acquiredBeforeReset = busyEntries_[index].generation != generation_;
+    busyEntries_[index] = BusyEntry {};
+    freeBusyIndexes_.push_back(index);
+    if (acquiredBeforeReset) {
+        MEDIA_LOG_D("0x%{public}06" PRIXPTR " released after pool %{public}s reset", FAKE_POINTER(memory),
+                    name_.c_str());
+        delete memory;
+        return;
+    }
 
-    for (auto iter = idleList_.begin(); iter != idleList_.end(); ++iter) {
-        if ((*iter)->GetSize() >= size) {
-            result = *iter;
-            idleList_.erase(iter);
-            break;
-        }
+    busyCnt_--;
+    PushIdle(memory);
+    NotifyWaiters(memory->GetSize());
+    MEDIA_LOG_D("0x%{public}06" PRIXPTR " released back to pool %{public}s", FAKE_POINTER(memory), name_.c_str());
 
-        if ((*iter)->GetSize() < minIdleSize) {
-            minIdleSize = (*iter)->GetSize();
-            minSizeIdleMem = iter;
-        }
+    lock.unlock();
+    if (notifier_ != nullptr) {
+        notifier_();
     }
+}
 
-    if (result == nullptr) {
-        auto totalCnt = busyList_.size() + idleList_.size();
-        if (totalCnt < option_.maxMemCnt) {
-            result = AllocMemory(size);
-            FALSE_RETURN_V_MSG_E(result != nullptr, false, "result is nullptr");
-            FALSE_RETURN_V(result != nullptr, false);
-        }
+bool AVSharedMemoryPool::DoAcquireMemory(int32_t size, AVSharedMemory **outMemory)
+{
+    MEDIA_LOG_D("busy count " PUBLIC_LOG_ZU ", idle count " PUBLIC_LOG_ZU, busyCnt_, idleMems_.size());
 
-        if (!option_.enableFixedSize && minSizeIdleMem != idleList_.end()) {
-            delete *minSizeIdleMem;
-            *minSizeIdleMem = nullptr;
-            idleList_.erase(minSizeIdleMem);
-            result = AllocMemory(size);
-            FALSE_RETURN_V_MSG_E(result != nullptr, false, "result is nullptr");
-            FALSE_RETURN_V(result != nullptr, false);
-        }
+    AVSharedMemory *result = PopIdle(size);
+    if (result != nullptr) {
+        metrics_.hitCount++;
+        *outMemory = result;
+        return true;
+    }
+
+    if (busyCnt_ + idleMems_.size() < option_.maxMemCnt) {
+        result = AllocMemory(size);
+        FALSE_RETURN_V_MSG_E(result != nullptr, false, "result is nullptr");
+    } else if (!option_.enableFixedSize && !idleMems_.empty()) {
+        delete PopSmallestIdle();
+        result = AllocMemory(size);
+        FALSE_RETURN_V_MSG_E(result != nullptr, false, "result is nullptr");
+    }
+    if (result != nullptr) {
+        metrics_.allocCount++;
     }
 
     *outMemory = result;
@@ -179,7 +232,11 @@ std::shared_ptr<AVSharedMemory> AVSharedMemoryPool::AcquireMemory(int32_t size,
         size = option_.memSize;
     }
 
+    metrics_.acquireCount++;
+    uint32_t sizeClass = SizeClass(size);
     AVSharedMemory *memory = nullptr;
+    bool waited = false;
+    auto waitStart = std::chrono::steady_clock::now();
     do {
         if (!DoAcquireMemory(size, &memory) || memory != nullptr) {
             break;
@@ -189,21 +246,40 @@ std::shared_ptr<AVSharedMemory> AVSharedMemoryPool::AcquireMemory(int32_t size,
             break;
         }
 
-        cond_.wait(lock);
+        if (!waited) {
+            waited = true;
+            waitStart = std::chrono::steady_clock::now();
+            metrics_.waitCount++;
+        }
+        waiterCnts_[sizeClass]++;
+        conds_[sizeClass].wait(lock);
+        waiterCnts_[sizeClass]--;
     } while (inited_ && !forceNonBlocking_);
 
-    FALSE_RETURN_V_MSG_E(memory != nullptr, nullptr, "acquire memory failed for size: %{public}d", size);
-    busyList_.push_back(memory);
-
-    auto result = std::shared_ptr<AVSharedMemory>(memory, [weakPool = weak_from_this()](AVSharedMemory *memory) {
-        std::shared_ptr<AVSharedMemoryPool> pool = weakPool.lock();
-        if (pool != nullptr) {
-            pool->ReleaseMemory(memory);
-        } else {
-            MEDIA_LOG_I("release memory 0x%{public}06" PRIXPTR ", but the pool is destroyed", FAKE_POINTER(memory));
-            delete memory;
-        }
-    });
+    if (waited) {
+        auto waitUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - waitStart).count());
+        metrics_.totalWaitUs += waitUs;
+        metrics_.maxWaitUs = std::max(metrics_.maxWaitUs, waitUs);
+    }
+    if (memory == nullptr) {
+        metrics_.failCount++;
+        MEDIA_LOG_E("acquire memory failed for size: %{public}d", size);
+        return nullptr;
+    }
+    uint32_t index = TrackBusy(memory);
+
+    auto result = std::shared_ptr<AVSharedMemory>(memory,
+        [weakPool = weak_from_this(), index](AVSharedMemory *memory) {
+            std::shared_ptr<AVSharedMemoryPool> pool = weakPool.lock();
+            if (pool != nullptr) {
+                pool->ReleaseMemory(memory, index);
+            } else {
+                MEDIA_LOG_I("release memory 0x%{public}06" PRIXPTR ", but the pool is destroyed",
+                            FAKE_POINTER(memory));
+                delete memory;
+            }
+        });
 
     MEDIA_LOG_D("0x%{public}06" PRIXPTR " acquired from pool", FAKE_POINTER(memory));
     return result;
@@ -215,7 +291,9 @@ void AVSharedMemoryPool::SetNonBlocking(bool enable)
     MEDIA_LOG_D("SetNonBlocking: %{public}d", enable);
     forceNonBlocking_ = enable;
     if (forceNonBlocking_) {
-        cond_.notify_all();
+        for (auto &cond : conds_) {
+            cond.notify_all();
+        }
     }
 }
 
@@ -224,16 +302,25 @@ void AVSharedMemoryPool::Reset()
     MEDIA_LOG_D("Reset");
 
     std::unique_lock<std::mutex> lock(mutex_);
-    for (auto &memory : idleList_) {
-        delete memory;
-        memory = nullptr;
+    for (auto &idle : idleMems_) {
+        delete idle.second;
     }
-    idleList_.clear();
+    idleMems_.clear();
     inited_ = false;
     forceNonBlocking_ = false;
     notifier_ = nullptr;
-    cond_.notify_all();
-    // for busylist, the memory will be released when the refcount of shared_ptr is zero.
+    for (auto &cond : conds_) {
+        cond.notify_all();
+    }
+    // for busy memory, it will be deleted when the refcount of shared_ptr is zero, and no longer counts as busy.
+    generation_++;
+    busyCnt_ = 0;
+}
+
+AVSharedMemoryPool::Metrics AVSharedMemoryPool::GetMetrics()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return metrics_;
 }
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
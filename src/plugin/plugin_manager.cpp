@@ -14,12 +14,57 @@
  */
 
 #include "plugin/plugin_manager.h"
+#include <cstdlib>
+#include <cstring>
 #include <utility>
+#include "plugin/plugin_info.h"
 #include "plugin/plugin_register.h"
 
 namespace OHOS {
 namespace Media {
 namespace Plugins {
+namespace {
+bool MatchSniffHint(const std::string& hint, const std::shared_ptr<DataSource>& source)
+{
+    auto pos = hint.find(':');
+    if (pos == std::string::npos || pos + 1 == hint.size()) {
+        return true; // a hint that can not be checked never keeps the plugin from sniffing
+    }
+    char* end = nullptr;
+    auto offset = std::strtoull(hint.c_str(), &end, 10); // 10: decimal offset
+    if (end != hint.c_str() + pos) {
+        return true;
+    }
+    auto magicLen = hint.size() - pos - 1;
+    auto buffer = std::make_shared<Buffer>();
+    auto memory = buffer->AllocMemory(nullptr, magicLen);
+    if (memory == nullptr || source->ReadAt(static_cast<int64_t>(offset), buffer, magicLen) != Status::OK) {
+        return false;
+    }
+    return memory->GetSize() == magicLen &&
+        std::memcmp(memory->GetReadOnlyData(), hint.data() + pos + 1, magicLen) == 0;
+}
+
+// checked on the reg info of the manifest, so the library of a demuxer is only loaded for a source it may accept
+bool MatchSniffHints(const std::shared_ptr<PluginInfo>& info, const std::shared_ptr<DataSource>& source)
+{
+    auto it = info->extra.find(PLUGIN_INFO_EXTRA_SNIFF_HINTS);
+    if (it == info->extra.end()) {
+        return true;
+    }
+    auto hints = AnyCast<std::vector<std::string>>(&it->second);
+    if (hints == nullptr || hints->empty()) {
+        return true;
+    }
+    for (const auto& hint : *hints) {
+        if (MatchSniffHint(hint, source)) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
 PluginManager::PluginManager()
 {
     Init();
@@ -32,7 +77,7 @@ std::vector<std::string> PluginManager::ListPlugins(PluginType pluginType, Codec
 
 std::shared_ptr<PluginInfo> PluginManager::GetPluginInfo(PluginType type, const std::string& name)
 {
-    auto regInfo = pluginRegister_->GetPluginRegInfo(type, name);
+    auto regInfo = pluginRegister_->FindPluginRegInfo(type, name);
     if (regInfo && regInfo->info && regInfo->info->pluginType == type) {
         return regInfo->info;
     }
@@ -44,7 +89,11 @@ int32_t PluginManager::Sniffer(const std::string& name, std::shared_ptr<DataSour
     if (!source) {
         return 0;
     }
-    auto regInfo = pluginRegister_->GetPluginRegInfo(PluginType::DEMUXER, name);
+    auto regInfo = pluginRegister_->FindPluginRegInfo(PluginType::DEMUXER, name);
+    if (!regInfo || !regInfo->info || !MatchSniffHints(regInfo->info, source)) {
+        return 0;
+    }
+    regInfo = pluginRegister_->GetPluginRegInfo(PluginType::DEMUXER, name);
     if (!regInfo) {
         return 0;
     }
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define HST_LOG_TAG "PluginManifest"
+
+#include "plugin/plugin_manifest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+
+#include "common/log.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugins {
+namespace {
+constexpr int32_t MANIFEST_VERSION = 1;
+constexpr char MANIFEST_MAGIC[] = "MEDIA_PLUGIN_MANIFEST";
+constexpr char EMPTY_TOKEN[] = "~";
+constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+constexpr uint32_t HEX_SHIFT = 4;
+constexpr uint32_t HEX_MASK = 0x0F;
+constexpr int32_t HEX_BASE = 16;
+constexpr int32_t DECIMAL_BASE = 10;
+constexpr size_t ESCAPED_CHAR_LEN = 3; // %XX
+
+// tokens are separated by spaces, so spaces, controls and the escape characters themselves are written as %XX
+std::string Escape(const std::string& str)
+{
+    if (str.empty()) {
+        return EMPTY_TOKEN;
+    }
+    std::string out;
+    out.reserve(str.size());
+    for (unsigned char ch : str) {
+        if (ch <= ' ' || ch == '%' || ch == EMPTY_TOKEN[0] || ch >= 0x7F) { // 0x7F: DEL and non ascii bytes
+            out += '%';
+            out += HEX_DIGITS[ch >> HEX_SHIFT];
+            out += HEX_DIGITS[ch & HEX_MASK];
+        } else {
+            out += static_cast<char>(ch);
+        }
+    }
+    return out;
+}
+
+bool Unescape(const std::string& token, std::string& out)
+{
+    out.clear();
+    if (token == EMPTY_TOKEN) {
+        return true;
+    }
+    for (size_t i = 0; i < token.size(); ++i) {
+        if (token[i] != '%') {
+            out += token[i];
+            continue;
+        }
+        if (i + ESCAPED_CHAR_LEN > token.size()) {
+            return false;
+        }
+        char* end = nullptr;
+        std::string hex = token.substr(i + 1, ESCAPED_CHAR_LEN - 1);
+        auto ch = std::strtoul(hex.c_str(), &end, HEX_BASE);
+        if (end != hex.c_str() + hex.size()) {
+            return false;
+        }
+        out += static_cast<char>(ch);
+        i += ESCAPED_CHAR_LEN - 1;
+    }
+    return true;
+}
+
+template <typename T, bool = std::is_enum<T>::value>
+struct IntegerOf {
+    using Type = T;
+};
+
+template <typename T>
+struct IntegerOf<T, true> {
+    using Type = typename std::underlying_type<T>::type;
+};
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, std::string>::type EncodeScalar(
+    const T& value)
+{
+    using Integer = typename IntegerOf<T>::Type;
+    if (std::is_signed<Integer>::value) {
+        return std::to_string(static_cast<int64_t>(value));
+    }
+    return std::to_string(static_cast<uint64_t>(value));
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, std::string>::type EncodeScalar(const T& value)
+{
+    std::ostringstream stream;
+    stream << std::setprecision(std::numeric_limits<T>::max_digits10) << value;
+    return stream.str();
+}
+
+std::string EncodeScalar(const std::string& value)
+{
+    return Escape(value);
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, bool>::type DecodeScalar(
+    const std::string& token, T& value)
+{
+    using Integer = typename IntegerOf<T>::Type;
+    char* end = nullptr;
+    if (std::is_signed<Integer>::value) {
+        value = static_cast<T>(std::strtoll(token.c_str(), &end, DECIMAL_BASE));
+    } else {
+        value = static_cast<T>(std::strtoull(token.c_str(), &end, DECIMAL_BASE));
+    }
+    return !token.empty() && end == token.c_str() + token.size();
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type DecodeScalar(const std::string& token, T& value)
+{
+    char* end = nullptr;
+    value = static_cast<T>(std::strtod(token.c_str(), &end));
+    return !token.empty() && end == token.c_str() + token.size();
+}
+
+bool DecodeScalar(const std::string& token, std::string& value)
+{
+    return Unescape(token, value);
+}
+
+using Tokens = std::vector<std::string>;
+
+// Fixed, interval and discrete values of T, see FixedCapability, IntervalCapability and DiscreteCapability
+template <typename T>
+struct FixedCodec {
+    static bool Match(const Any& value)
+    {
+        return Any::IsSameTypeWith<T>(value);
+    }
+    static void Encode(const Any& value, Tokens& tokens)
+    {
+        tokens.emplace_back(EncodeScalar(*AnyCast<T>(&value)));
+    }
+    static bool Decode(const Tokens& tokens, Any& value)
+    {
+        T val {};
+        if (tokens.size() != 1 || !DecodeScalar(tokens[0], val)) {
+            return false;
+        }
+        value = val;
+        return true;
+    }
+};
+
+template <typename T>
+struct IntervalCodec {
+    static bool Match(const Any& value)
+    {
+        return Any::IsSameTypeWith<IntervalCapability<T>>(value);
+    }
+    static void Encode(const Any& value, Tokens& tokens)
+    {
+        auto interval = AnyCast<IntervalCapability<T>>(&value);
+        tokens.emplace_back(EncodeScalar(interval->first));
+        tokens.emplace_back(EncodeScalar(interval->second));
+    }
+    static bool Decode(const Tokens& tokens, Any& value)
+    {
+        IntervalCapability<T> interval {};
+        if (tokens.size() != 2 || !DecodeScalar(tokens[0], interval.first) || // 2: start and end
+            !DecodeScalar(tokens[1], interval.second)) {
+            return false;
+        }
+        value = interval;
+        return true;
+    }
+};
+
+template <typename T>
+struct DiscreteCodec {
+    static bool Match(const Any& value)
+    {
+        return Any::IsSameTypeWith<DiscreteCapability<T>>(value);
+    }
+    static void Encode(const Any& value, Tokens& tokens)
+    {
+        for (const auto& item : *AnyCast<DiscreteCapability<T>>(&value)) {
+            tokens.emplace_back(EncodeScalar(item));
+        }
+    }
+    static bool Decode(const Tokens& tokens, Any& value)
+    {
+        DiscreteCapability<T> values;
+        values.reserve(tokens.size());
+        for (const auto& token : tokens) {
+            T val {};
+            if (!DecodeScalar(token, val)) {
+                return false;
+            }
+            values.push_back(val);
+        }
+        value = std::move(values);
+        return true;
+    }
+};
+
+struct ValueCodec {
+    std::string tag;
+    bool (*match)(const Any& value);
+    void (*encode)(const Any& value, Tokens& tokens);
+    bool (*decode)(const Tokens& tokens, Any& value);
+};
+
+template <typename T>
+void AddValueCodecs(std::vector<ValueCodec>& codecs, const std::string& typeTag)
+{
+    codecs.push_back({"F:" + typeTag, FixedCodec<T>::Match, FixedCodec<T>::Encode, FixedCodec<T>::Decode});
+    codecs.push_back({"I:" + typeTag, IntervalCodec<T>::Match, IntervalCodec<T>::Encode, IntervalCodec<T>::Decode});
+    codecs.push_back({"D:" + typeTag, DiscreteCodec<T>::Match, DiscreteCodec<T>::Encode, DiscreteCodec<T>::Decode});
+}
+
+// the types plugins put into capabilities and extra info, tags are part of the file format and must not change
+const std::vector<ValueCodec>& GetValueCodecs()
+{
+    static const std::vector<ValueCodec> codecs([]() {
+        std::vector<ValueCodec> table;
+        AddValueCodecs<bool>(table, "bool");
+        AddValueCodecs<int32_t>(table, "i32");
+        AddValueCodecs<uint32_t>(table, "u32");
+        AddValueCodecs<int64_t>(table, "i64");
+        AddValueCodecs<uint64_t>(table, "u64");
+        AddValueCodecs<float>(table, "f32");
+        AddValueCodecs<double>(table, "f64");
+        AddValueCodecs<std::string>(table, "str");
+        AddValueCodecs<AudioSampleFormat>(table, "AudioSampleFormat");
+        AddValueCodecs<AudioChannelLayout>(table, "AudioChannelLayout");
+        AddValueCodecs<AudioAacProfile>(table, "AudioAacProfile");
+        AddValueCodecs<AudioAacStreamFormat>(table, "AudioAacStreamFormat");
+        AddValueCodecs<VideoPixelFormat>(table, "VideoPixelFormat");
+        AddValueCodecs<VideoH264Profile>(table, "VideoH264Profile");
+        AddValueCodecs<VideoBitStreamFormat>(table, "VideoBitStreamFormat");
+        AddValueCodecs<CodecMode>(table, "CodecMode");
+        AddValueCodecs<ProtocolType>(table, "ProtocolType");
+        AddValueCodecs<SrcInputType>(table, "SrcInputType");
+        AddValueCodecs<MediaType>(table, "MediaType");
+        return table;
+    }());
+    return codecs;
+}
+
+const ValueCodec* FindCodecByTag(const std::string& tag)
+{
+    static const std::unordered_map<std::string, const ValueCodec*> tagMap([]() {
+        std::unordered_map<std::string, const ValueCodec*> table;
+        for (const auto& codec : GetValueCodecs()) {
+            table[codec.tag] = &codec;
+        }
+        return table;
+    }());
+    auto ite = tagMap.find(tag);
+    return ite == tagMap.end() ? nullptr : ite->second;
+}
+
+// <tag> <count> <value>...
+bool EncodeValue(const Any& value, std::string& out)
+{
+    for (const auto& codec : GetValueCodecs()) {
+        if (!codec.match(value)) {
+            continue;
+        }
+        Tokens tokens;
+        codec.encode(value, tokens);
+        out += codec.tag + " " + std::to_string(tokens.size());
+        for (const auto& token : tokens) {
+            out += " " + token;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool DecodeValue(const Tokens& tokens, size_t pos, Any& value)
+{
+    if (pos + 2 > tokens.size()) { // 2: tag and count
+        return false;
+    }
+    auto codec = FindCodecByTag(tokens[pos]);
+    uint64_t count = 0;
+    if (codec == nullptr || !DecodeScalar(tokens[pos + 1], count) || pos + 2 + count != tokens.size()) { // 2
+        return false;
+    }
+    return codec->decode(Tokens(tokens.begin() + pos + 2, tokens.end()), value); // 2: tag and count
+}
+
+bool EncodeCaps(const char* section, const CapabilitySet& caps, std::string& out)
+{
+    for (const auto& cap : caps) {
+        out += std::string(section) + " " + Escape(cap.mime) + "\n";
+        for (const auto& key : cap.keys) {
+            out += "key " + Escape(key.first) + " ";
+            if (!EncodeValue(key.second, out)) {
+                MEDIA_LOG_W("capability " PUBLIC_LOG_S " of " PUBLIC_LOG_S " has an unsupported type",
+                    key.first.c_str(), cap.mime.c_str());
+                return false;
+            }
+            out += "\n";
+        }
+    }
+    return true;
+}
+
+Tokens Split(const std::string& line)
+{
+    Tokens tokens;
+    std::istringstream stream(line);
+    std::string token;
+    while (stream >> token) {
+        tokens.emplace_back(std::move(token));
+    }
+    return tokens;
+}
+
+struct ParseState {
+    PluginManifestLibrary* library {nullptr};
+    std::shared_ptr<PluginInfo> plugin {nullptr};
+    Capability* capability {nullptr};
+};
+
+bool ParseLibrary(const Tokens& tokens, std::map<std::string, PluginManifestLibrary>& libraries, ParseState& state)
+{
+    // library <file> <size> <mtime> <pkgVersion> <license> <pkgName>
+    PluginManifestLibrary library;
+    if (tokens.size() != 7 || !Unescape(tokens[1], library.fileName) || // 7: tokens of a library line
+        !DecodeScalar(tokens[2], library.fileSize) || !DecodeScalar(tokens[3], library.modifyTime) || // 2, 3
+        !DecodeScalar(tokens[4], library.package.pkgVersion) || // 4: package version
+        !DecodeScalar(tokens[5], library.package.licenseType) || !Unescape(tokens[6], library.package.name)) { // 5, 6
+        return false;
+    }
+    auto fileName = library.fileName;
+    state.library = &(libraries[fileName] = std::move(library));
+    state.plugin = nullptr;
+    state.capability = nullptr;
+    return true;
+}
+
+bool ParsePlugin(const Tokens& tokens, ParseState& state)
+{
+    // plugin <type> <apiVersion> <rank> <name> <description>
+    auto info = std::make_shared<PluginInfo>();
+    if (state.library == nullptr || tokens.size() != 6 || // 6: tokens of a plugin line
+        !DecodeScalar(tokens[1], info->pluginType) || !DecodeScalar(tokens[2], info->apiVersion) || // 2: api version
+        !DecodeScalar(tokens[3], info->rank) || !Unescape(tokens[4], info->name) || // 3: rank, 4: name
+        !Unescape(tokens[5], info->description)) { // 5: description
+        return false;
+    }
+    state.library->plugins.emplace_back(info);
+    state.plugin = info;
+    state.capability = nullptr;
+    return true;
+}
+
+bool ParseLine(const Tokens& tokens, std::map<std::string, PluginManifestLibrary>& libraries, ParseState& state)
+{
+    const auto& kind = tokens[0];
+    if (kind == "library") {
+        return ParseLibrary(tokens, libraries, state);
+    }
+    if (kind == "plugin") {
+        return ParsePlugin(tokens, state);
+    }
+    if (state.plugin == nullptr || tokens.size() < 2) { // 2: kind and name
+        return false;
+    }
+    std::string name;
+    if (!Unescape(tokens[1], name)) {
+        return false;
+    }
+    if (kind == "in" || kind == "out") {
+        auto& caps = (kind == "in") ? state.plugin->inCaps : state.plugin->outCaps;
+        caps.emplace_back(name);
+        state.capability = &caps.back();
+        return tokens.size() == 2; // 2: kind and mime
+    }
+    Any value;
+    if (!DecodeValue(tokens, 2, value)) { // 2: value follows the kind and the name
+        return false;
+    }
+    if (kind == "extra") {
+        state.plugin->extra[name] = std::move(value);
+        return true;
+    }
+    if (kind == "key" && state.capability != nullptr) {
+        state.capability->keys[name] = std::move(value);
+        return true;
+    }
+    return false;
+}
+} // namespace
+
+bool PluginManifest::Encode(const PluginManifestLibrary& library, std::string& out)
+{
+    std::string text = "library " + Escape(library.fileName) + " " + EncodeScalar(library.fileSize) + " " +
+        EncodeScalar(library.modifyTime) + " " + EncodeScalar(library.package.pkgVersion) + " " +
+        EncodeScalar(library.package.licenseType) + " " + Escape(library.package.name) + "\n";
+    for (const auto& info : library.plugins) {
+        text += "plugin " + EncodeScalar(info->pluginType) + " " + EncodeScalar(info->apiVersion) + " " +
+            EncodeScalar(info->rank) + " " + Escape(info->name) + " " + Escape(info->description) + "\n";
+        for (const auto& extra : info->extra) {
+            text += "extra " + Escape(extra.first) + " ";
+            if (!EncodeValue(extra.second, text)) {
+                MEDIA_LOG_W("extra " PUBLIC_LOG_S " of " PUBLIC_LOG_S " has an unsupported type",
+                    extra.first.c_str(), info->name.c_str());
+                return false;
+            }
+            text += "\n";
+        }
+        if (!EncodeCaps("in", info->inCaps, text) || !EncodeCaps("out", info->outCaps, text)) {
+            return false;
+        }
+    }
+    out += text;
+    return true;
+}
+
+bool PluginManifest::Save(const std::string& path, const std::vector<PluginManifestLibrary>& libraries)
+{
+    std::string text = std::string(MANIFEST_MAGIC) + " " + std::to_string(MANIFEST_VERSION) + "\n";
+    for (const auto& library : libraries) {
+        FALSE_LOG_MSG_W(Encode(library, text), "library " PUBLIC_LOG_S " is left out of the manifest",
+            library.fileName.c_str());
+    }
+    // written through a temporary file of its own, a reader never sees a partial manifest
+    std::string tmpPath = path + "." + std::to_string(getpid()) + ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        FALSE_RETURN_V_MSG_E(file.is_open(), false, "open " PUBLIC_LOG_S " failed", tmpPath.c_str());
+        file << text;
+        file.flush();
+        written = file.good();
+    }
+    if (!written || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        MEDIA_LOG_E("write " PUBLIC_LOG_S " failed", path.c_str());
+        (void)std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool PluginManifest::Load(const std::string& path, std::map<std::string, PluginManifestLibrary>& libraries)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        MEDIA_LOG_D("no plugin manifest at " PUBLIC_LOG_S, path.c_str());
+        return false;
+    }
+    std::string line;
+    auto header = std::getline(file, line) ? Split(line) : Tokens();
+    int32_t version = 0;
+    FALSE_RETURN_V_MSG_W(header.size() == 2 && header[0] == MANIFEST_MAGIC && // 2: magic and version
+        DecodeScalar(header[1], version) && version == MANIFEST_VERSION, false,
+        "unknown plugin manifest " PUBLIC_LOG_S, path.c_str());
+    std::map<std::string, PluginManifestLibrary> parsed;
+    ParseState state;
+    size_t lineNumber = 1;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        auto tokens = Split(line);
+        if (tokens.empty() || tokens[0][0] == '#') {
+            continue;
+        }
+        FALSE_RETURN_V_MSG_E(ParseLine(tokens, parsed, state), false,
+            "malformed plugin manifest " PUBLIC_LOG_S " at line " PUBLIC_LOG_ZU, path.c_str(), lineNumber);
+    }
+    libraries.swap(parsed);
+    return true;
+}
+
+bool PluginManifest::StatLibrary(const std::string& path, int64_t& fileSize, int64_t& modifyTime)
+{
+    struct stat fileStat {};
+    if (stat(path.c_str(), &fileStat) != 0) {
+        return false;
+    }
+    fileSize = static_cast<int64_t>(fileStat.st_size);
+    modifyTime = static_cast<int64_t>(fileStat.st_mtime);
+    return true;
+}
+
+bool PluginManifest::IsUpToDate(const PluginManifestLibrary& library, const std::string& path)
+{
+    int64_t fileSize = 0;
+    int64_t modifyTime = 0;
+    if (!StatLibrary(path, fileSize, modifyTime)) {
+        return false;
+    }
+    if (library.fileSize == 0 && library.modifyTime == 0) {
+        return true;
+    }
+    return fileSize == library.fileSize && modifyTime == library.modifyTime;
+}
+} // namespace Plugins
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HISTREAMER_PLUGIN_MANIFEST_H
+#define HISTREAMER_PLUGIN_MANIFEST_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "plugin/plugin_info.h"
+
+namespace OHOS {
+namespace Media {
+namespace Plugins {
+/**
+ * Everything the registry needs to know about a plugin library without opening it.
+ *
+ * A manifest generated at build time is installed in the read-only image together with the libraries it describes,
+ * its entries have neither size nor modification time, which change when the image is packaged.
+ */
+struct PluginManifestLibrary {
+    std::string fileName;       ///< file name of the library inside the plugin directory
+    int64_t fileSize {0};       ///< size of the library when the manifest was written, 0 if prebuilt
+    int64_t modifyTime {0};     ///< modification time (seconds) of the library when the manifest was written
+    PackageDef package {PLUGIN_INTERFACE_VERSION, "", LicenseType::UNKNOWN};
+    std::vector<std::shared_ptr<PluginInfo>> plugins; ///< in the order the library registers them
+};
+
+/**
+ * Plugin manifest, a text file listing the plugins of each dynamic library together with their type, rank,
+ * capabilities and extra info, so the registry can be populated without dlopen'ing the libraries.
+ *
+ * Capability and extra values are stored with their exact type, a library holding a value of a type unknown to
+ * the manifest can not be written and is left to be registered by loading it.
+ */
+class PluginManifest {
+public:
+    /// load the manifest at path, the libraries are keyed by file name
+    static bool Load(const std::string& path, std::map<std::string, PluginManifestLibrary>& libraries);
+
+    /// write the libraries which can be described to path, returns false if the file can not be written
+    static bool Save(const std::string& path, const std::vector<PluginManifestLibrary>& libraries);
+
+    /// serialize one library, false if any of its values is of an unsupported type
+    static bool Encode(const PluginManifestLibrary& library, std::string& out);
+
+    /// fill size and modification time of the file at path
+    static bool StatLibrary(const std::string& path, int64_t& fileSize, int64_t& modifyTime);
+
+    /// whether the library at path is still the one described by the manifest, a prebuilt entry only needs it to exist
+    static bool IsUpToDate(const PluginManifestLibrary& library, const std::string& path);
+};
+} // namespace Plugins
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_PLUGIN_MANIFEST_H
@@ -21,6 +21,11 @@
 #include "common/status.h"
 #include "meta/meta_key.h"
 #include "plugin/plugin_caps.h"
+#include "plugin/plugin_manifest.h"
+
+#ifndef HST_PLUGIN_MANIFEST_NAME
+#define HST_PLUGIN_MANIFEST_NAME "media_plugins.manifest"
+#endif
 
 namespace OHOS {
 namespace Media {
@@ -51,6 +56,9 @@ Status PluginRegister::RegisterImpl::AddPlugin(const PluginDefBase& def)
     if (!VersionMatched(def)) {
         return Status::ERROR_UNKNOWN;
     }
+    if (bindRegistered) {
+        return BindPlugin(def);
+    }
     if (registerData->IsPluginExist(def.pluginType, def.name)) {
         if (MoreAcceptable(registerData->registerTable[def.pluginType][def.name], def)) {
             registerData->registerTable[def.pluginType].erase(def.name);
@@ -63,6 +71,17 @@ Status PluginRegister::RegisterImpl::AddPlugin(const PluginDefBase& def)
 }
 
 void PluginRegister::RegisterImpl::UpdateRegisterTableAndRegisterNames(const PluginDefBase& def)
+{
+    auto regInfo = CreateRegInfo(def);
+    if (regInfo == nullptr) {
+        return;
+    }
+    regInfo->loader = pluginLoader;
+    regInfo->library = library;
+    InsertRegInfo(regInfo);
+}
+
+std::shared_ptr<PluginRegInfo> PluginRegister::RegisterImpl::CreateRegInfo(const PluginDefBase& def)
 {
     auto regInfo = std::make_shared<PluginRegInfo>();
     regInfo->packageDef = packageDef;
@@ -95,18 +114,57 @@ void PluginRegister::RegisterImpl::UpdateRegisterTableAndRegisterNames(const Plu
             InitGenericPlugin(regInfo, def);
             break;
         default:
-            return;
+            return nullptr;
     }
-    regInfo->loader = std::move(pluginLoader);
-    registerData->registerTable[def.pluginType][def.name] = regInfo;
-    if ((def.pluginType == PluginType::AUDIO_DECODER || def.pluginType == PluginType::VIDEO_DECODER
-        || def.pluginType == PluginType::AUDIO_ENCODER || def.pluginType == PluginType::VIDEO_ENCODER)
+    return regInfo->info == nullptr ? nullptr : regInfo;
+}
+
+void PluginRegister::RegisterImpl::InsertRegInfo(const std::shared_ptr<PluginRegInfo>& regInfo)
+{
+    auto type = regInfo->info->pluginType;
+    const auto& name = regInfo->info->name;
+    registerData->registerTable[type][name] = regInfo;
+    if ((type == PluginType::AUDIO_DECODER || type == PluginType::VIDEO_DECODER
+        || type == PluginType::AUDIO_ENCODER || type == PluginType::VIDEO_ENCODER)
         && AnyCast<CodecMode>(regInfo->info->extra[PLUGIN_INFO_EXTRA_CODEC_MODE]) == CodecMode::HARDWARE) {
-        registerData->registerNames[def.pluginType].insert(registerData->registerNames[def.pluginType].begin(),
-            def.name);
+        registerData->registerNames[type].insert(registerData->registerNames[type].begin(), name);
     } else {
-        registerData->registerNames[def.pluginType].push_back(def.name);
+        registerData->registerNames[type].push_back(name);
+    }
+    if (library != nullptr) {
+        library->plugins.emplace_back(type, name);
+    }
+}
+
+Status PluginRegister::RegisterImpl::AddPluginInfo(const std::shared_ptr<PluginInfo>& info)
+{
+    if (info->rank > 100 || info->pluginType == PluginType::INVALID_TYPE) { // 100
+        return Status::ERROR_INVALID_DATA;
+    }
+    if (registerData->IsPluginExist(info->pluginType, info->name)) {
+        return Status::ERROR_PLUGIN_ALREADY_EXISTS;
     }
+    auto regInfo = std::make_shared<PluginRegInfo>();
+    regInfo->packageDef = packageDef;
+    regInfo->info = info;
+    regInfo->library = library;
+    InsertRegInfo(regInfo);
+    return Status::OK;
+}
+
+Status PluginRegister::RegisterImpl::BindPlugin(const PluginDefBase& def)
+{
+    // the registry is not modified here, it may be read concurrently while the library is opened
+    FALSE_RETURN_V_MSG_W(registerData->IsPluginExist(def.pluginType, def.name), Status::ERROR_UNKNOWN,
+        "plugin " PUBLIC_LOG_S " is not in the manifest, regenerate it", def.name.c_str());
+    auto& regInfo = registerData->registerTable[def.pluginType][def.name];
+    FALSE_RETURN_V(regInfo->library == library, Status::ERROR_PLUGIN_ALREADY_EXISTS);
+    auto created = CreateRegInfo(def);
+    FALSE_RETURN_V(created != nullptr, Status::ERROR_INVALID_DATA);
+    regInfo->creator = created->creator;
+    regInfo->sniffer = created->sniffer;
+    regInfo->loader = pluginLoader;
+    return Status::OK;
 }
 
 bool PluginRegister::RegisterImpl::Verification(const PluginDefBase& definition)
@@ -172,6 +230,9 @@ Status PluginRegister::RegisterImpl::InitDemuxerInfo(std::shared_ptr<PluginRegIn
     auto info = std::make_shared<PluginInfo>();
     SetPluginInfo(info, def);
     info->extra.insert({PLUGIN_INFO_EXTRA_EXTENSIONS, def.GetExtensions()});
+    if (!def.GetSniffHints().empty()) {
+        info->extra.insert({PLUGIN_INFO_EXTRA_SNIFF_HINTS, def.GetSniffHints()});
+    }
     info->inCaps = def.GetInCaps();
     info->outCaps = def.GetOutCaps();
     reg->info = info;
@@ -286,6 +347,18 @@ int PluginRegister::GetAllRegisteredPluginCount()
 }
 
 std::shared_ptr<PluginRegInfo> PluginRegister::GetPluginRegInfo(PluginType type, const std::string& name)
+{
+    auto regInfo = FindPluginRegInfo(type, name);
+    if (regInfo == nullptr || regInfo->library == nullptr ||
+        regInfo->library->loaded.load(std::memory_order_acquire)) {
+        return regInfo;
+    }
+    FALSE_RETURN_V_MSG_E(LoadPluginLibrary(regInfo->library) && regInfo->creator, {},
+        "plugin " PUBLIC_LOG_S " is not available", name.c_str());
+    return regInfo;
+}
+
+std::shared_ptr<PluginRegInfo> PluginRegister::FindPluginRegInfo(PluginType type, const std::string& name)
 {
     if (registerData_->IsPluginExist(type, name)) {
         return registerData_->registerTable[type][name];
@@ -325,6 +398,11 @@ void PluginRegister::RegisterDynamicPlugins()
 }
 
 void PluginRegister::RegisterPluginsFromPath(const char* libDirPath)
+{
+    RegisterPluginsFromPath(libDirPath, std::string(libDirPath) + "/" HST_PLUGIN_MANIFEST_NAME);
+}
+
+void PluginRegister::RegisterPluginsFromPath(const char* libDirPath, const std::string& manifestPath)
 {
 #ifdef DYNAMIC_PLUGINS
     static std::string libFileHead = "libmedia_plugin_";
@@ -335,6 +413,10 @@ void PluginRegister::RegisterPluginsFromPath(const char* libDirPath)
     #endif
     static std::string libFileTail = HST_PLUGIN_FILE_TAIL;
     MEDIA_LOG_D("plugin path %{public}s", libDirPath);
+    std::map<std::string, PluginManifestLibrary> manifest;
+    (void)PluginManifest::Load(manifestPath, manifest);
+    size_t manifestHits = 0;
+    size_t eagerLoads = 0;
     DIR* libDir = opendir(libDirPath);
     if (libDir) {
         struct dirent* lib = nullptr;
@@ -352,17 +434,107 @@ void PluginRegister::RegisterPluginsFromPath(const char* libDirPath)
             std::string pluginName =
                 libName.substr(libFileHead.size(), libName.size() - libFileHead.size() - libFileTail.size());
             std::string libPath = libDirPath + fileSeparator + lib->d_name;
+            auto library = std::make_shared<PluginLibrary>();
+            library->name = pluginName;
+            library->path = libPath;
+            auto entry = manifest.find(libName);
+            if (entry != manifest.end() && PluginManifest::IsUpToDate(entry->second, libPath)) {
+                // registered from the manifest, the library is opened on first CreatePlugin or Sniffer
+                library->fileSize = entry->second.fileSize;
+                library->modifyTime = entry->second.modifyTime;
+                auto impl = std::make_shared<RegisterImpl>(registerData_, nullptr, library);
+                (void)impl->SetPackageDef(entry->second.package);
+                for (const auto& info : entry->second.plugins) {
+                    FALSE_LOG_MSG(impl->AddPluginInfo(info) == Status::OK,
+                        "Plugin %{public}s register fail.", info->name.c_str());
+                }
+                libraries_.push_back(library);
+                manifestHits++;
+                continue;
+            }
+            (void)PluginManifest::StatLibrary(libPath, library->fileSize, library->modifyTime);
             loader = PluginLoader::Create(pluginName, libPath);
             if (loader) {
-                loader->FetchRegisterFunction()(std::make_shared<RegisterImpl>(registerData_, loader));
+                library->loaded = true;
+                loader->FetchRegisterFunction()(std::make_shared<RegisterImpl>(registerData_, loader, library));
                 registeredLoaders_.push_back(loader);
+                libraries_.push_back(library);
+                eagerLoads++;
             }
         }
         closedir(libDir);
     }
+    // the manifest is generated with the libraries at build time, the plugin directory can not be written here
+    if (eagerLoads > 0 && !manifestPath.empty()) {
+        MEDIA_LOG_W("plugin manifest %{public}s is missing or stale, " PUBLIC_LOG_ZU " libraries are opened at "
+            "startup, regenerate it with the plugins", manifestPath.c_str(), eagerLoads);
+    }
+    MEDIA_LOG_D("plugin libraries registered from the manifest: " PUBLIC_LOG_ZU, manifestHits);
+#endif
+}
+
+bool PluginRegister::GeneratePluginManifest(const char* libDirPath, const std::string& manifestPath)
+{
+    RegisterPluginsFromPath(libDirPath, "");
+    FALSE_RETURN_V_MSG_E(!libraries_.empty(), false, "no plugin library in %{public}s", libDirPath);
+    return WritePluginManifest(manifestPath, true);
+}
+
+bool PluginRegister::LoadPluginLibrary(const std::shared_ptr<PluginLibrary>& library)
+{
+#ifdef DYNAMIC_PLUGINS
+    std::lock_guard<std::mutex> lock(library->mutex);
+    if (library->loaded.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    FALSE_RETURN_V(!library->failed, false);
+    auto loader = PluginLoader::Create(library->name, library->path);
+    if (loader == nullptr) {
+        library->failed = true;
+        MEDIA_LOG_E("open plugin library %{public}s failed", library->path.c_str());
+        return false;
+    }
+    auto impl = std::make_shared<RegisterImpl>(registerData_, loader, library);
+    impl->bindRegistered = true;
+    loader->FetchRegisterFunction()(impl);
+    {
+        std::lock_guard<std::mutex> loaderLock(loaderMutex_);
+        registeredLoaders_.push_back(loader);
+    }
+    library->loaded.store(true, std::memory_order_release);
+    MEDIA_LOG_I("plugin library %{public}s opened on first use", library->name.c_str());
+    return true;
+#else
+    (void)library;
+    return false;
 #endif
 }
 
+bool PluginRegister::WritePluginManifest(const std::string& path, bool prebuilt)
+{
+    std::vector<PluginManifestLibrary> entries;
+    for (const auto& library : libraries_) {
+        PluginManifestLibrary entry;
+        entry.fileName = library->path.substr(library->path.find_last_of("/\\") + 1);
+        entry.fileSize = prebuilt ? 0 : library->fileSize;
+        entry.modifyTime = prebuilt ? 0 : library->modifyTime;
+        for (const auto& plugin : library->plugins) {
+            auto regInfo = FindPluginRegInfo(plugin.first, plugin.second);
+            if (regInfo == nullptr || regInfo->library != library) {
+                continue;
+            }
+            if (regInfo->packageDef != nullptr) {
+                entry.package = *regInfo->packageDef;
+            }
+            entry.plugins.push_back(regInfo->info);
+        }
+        if (!entry.plugins.empty()) {
+            entries.emplace_back(std::move(entry));
+        }
+    }
+    return PluginManifest::Save(path, entries);
+}
+
 void PluginRegister::UnregisterAllPlugins()
 {
 #ifdef DYNAMIC_PLUGINS
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <memory>
+#include "plugin/plugin_register.h"
+
+/**
+ * Build step writing the manifest of the plugin libraries in a directory, which is installed next to them so the
+ * registry reads it at startup instead of opening every library.
+ *
+ * usage: media_plugin_manifest <plugin directory> <manifest path>
+ */
+int main(int argc, char* argv[])
+{
+    if (argc != 3) { // 3: tool, plugin directory and manifest path
+        std::fprintf(stderr, "usage: %s <plugin directory> <manifest path>\n", argc > 0 ? argv[0] : "");
+        return 1;
+    }
+    auto pluginRegister = std::make_shared<OHOS::Media::Plugins::PluginRegister>();
+    if (!pluginRegister->GeneratePluginManifest(argv[1], argv[2])) { // 1: plugin directory, 2: manifest path
+        std::fprintf(stderr, "no plugin manifest written for %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
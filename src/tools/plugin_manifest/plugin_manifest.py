@@ -0,0 +1,36 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+#
+# Copyright (c) 2023 Huawei Device Co., Ltd.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import os
+import sys
+import subprocess
+
+
+def main(argv):
+    if len(argv) != 4:
+        print("usage: plugin_manifest.py <tool> <plugin directory> <manifest path>")
+        return 1
+    tool, plugin_dir, manifest = argv[1], argv[2], argv[3]
+    output_dir = os.path.dirname(manifest)
+    if output_dir and not os.path.exists(output_dir):
+        os.makedirs(output_dir)
+    return subprocess.call([tool, plugin_dir, manifest])
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -224,6 +224,42 @@ namespace Test {
         }
     }
 
+    void TestSinglePlayerNextSourceGapless(std::string url, std::string nextUrl)
+    {
+        std::unique_ptr<TestPlayer> player = TestPlayer::Create();
+        ASSERT_EQ(0, player->SetSource(TestSource(url)));
+        ASSERT_EQ(0, player->Prepare());
+        int64_t duration {0};
+        ASSERT_EQ(0, player->GetDuration(duration));
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_EQ(0, player->Play());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000)); // 1000 MS
+        ASSERT_EQ(0, player->SetNextSource(nextUrl));
+        int64_t lastMs {0};
+        int64_t currentMs {0};
+        std::chrono::steady_clock::time_point splicedAt {};
+        while (player->IsPlaying()) {
+            ASSERT_EQ(0, player->GetCurrentTime(currentMs));
+            if (currentMs + 1000 < lastMs) { // 1000 MS, the position restarts from 0 with the next item
+                splicedAt = std::chrono::steady_clock::now();
+                break;
+            }
+            lastMs = currentMs;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 10 MS
+        }
+        ASSERT_TRUE(player->IsPlaying()); // the first item must not complete on its own
+        // the wall time until the next item reaches currentMs, beyond the media time of the first item, is the gap
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(splicedAt - start).count();
+        int64_t gapMs = elapsedMs - duration - currentMs;
+        MEDIA_LOG_I("duration: " PUBLIC_LOG_D64 ", spliced after: " PUBLIC_LOG_D64 " ms, gap: " PUBLIC_LOG_D64 " ms",
+                    duration, static_cast<int64_t>(elapsedMs), gapMs);
+        EXPECT_LT(gapMs, 100); // 100 MS, covers the polling interval and the start of the sink
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000)); // 1000 MS
+        ASSERT_EQ(0, player->GetCurrentTime(currentMs));
+        EXPECT_GT(currentMs, 0);
+        ASSERT_EQ(0, player->Stop());
+    }
+
     HST_TEST(UtTestFastPlayer, TestSinglePlayerFinishedAutomatically, TestSize.Level1)
     {
         std::vector<std::string> vecSource;
@@ -377,6 +413,17 @@ namespace Test {
         }
     }
 
+    HST_TEST(UtTestFastPlayer, TestSinglePlayerNextSourceGapless, TestSize.Level1)
+    {
+        std::vector<std::string> vecSource;
+        vecSource.push_back(std::string(RESOURCE_DIR "/MP3/MP3_48000_32_SHORT.mp3"));
+        vecSource.push_back(std::string(RESOURCE_DIR "/M4A/MPEG-4_48000_32_SHORT.m4a"));
+        for (auto url : vecSource)
+        {
+            TestSinglePlayerNextSourceGapless(url, url);
+        }
+    }
+
     } // namespace Test
 } // namespace Media
 } // namespace OHOS
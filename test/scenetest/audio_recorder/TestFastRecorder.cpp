@@ -240,6 +240,50 @@ HWTEST(TestFastAudioRecorder, Test_single_audio_fd_recorder_5, TestSize.Level1)
     ASSERT_EQ(0, close(fd));
 }
 
+HWTEST(TestFastAudioRecorder, Test_single_audio_fd_recorder_throughput, TestSize.Level1)
+{
+    std::string filePath = std::string(std::string(HST_WORKING_DIR) + "/test.m4a");
+    OHOS::Media::OSAL::FileSystem::MakeMultipleDir(std::string(HST_WORKING_DIR));
+    OHOS::Media::OSAL::FileSystem::RemoveFilesInDir(std::string(HST_WORKING_DIR));
+    int fd;
+    fd = open(filePath.c_str(), O_RDWR | O_CREAT | O_BINARY, 0644); // 0644, permission;
+    ASSERT_TRUE(fd >= 0);
+    auto recorder = CreateRecorder();
+    int32_t audioSourceId = 0;
+    recorder->SetAudioSource(AudioSourceType::AUDIO_MIC, audioSourceId);
+    recorder->SetOutputFormat(OutputFormatType::FORMAT_M4A);
+    auto audSampleRate = AudSampleRate{44100};
+    auto audChannel = AudChannel{2};
+    auto audBitRate = AudBitRate{320000};
+    auto auEncoder = AudEnc{AudioCodecFormat::AAC_LC};
+    recorder->Configure(audioSourceId, audSampleRate);
+    recorder->Configure(audioSourceId, audChannel);
+    recorder->Configure(audioSourceId, audBitRate);
+    recorder->Configure(audioSourceId, auEncoder);
+    auto outFileFD = OutFd {fd};
+    recorder->Configure(DUMMY_SOURCE_ID, outFileFD);
+    ASSERT_EQ(0, recorder->Prepare());
+    auto startTime = std::chrono::steady_clock::now();
+    ASSERT_EQ(0, recorder->Start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2000)); // 2000 MS
+    auto stopTime = std::chrono::steady_clock::now();
+    ASSERT_EQ(0, recorder->Stop());
+    auto stopCost = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - stopTime).count();
+    auto recordCost = std::chrono::duration_cast<std::chrono::milliseconds>(stopTime - startTime).count();
+    auto fileSize = lseek(fd, 0, SEEK_END);
+    ASSERT_GT(fileSize, 0);
+    auto throughput = fileSize * 1000 / (recordCost > 0 ? recordCost : 1); // 1000: ms to s
+    std::cout << "recorded " << fileSize << " bytes in " << recordCost << " ms, throughput "
+              << throughput << " bytes/s, stop cost " << stopCost << " ms" << std::endl;
+    // 8: bits per byte, aac keeps well above an eighth of the configured bit rate even for silence
+    EXPECT_GT(throughput, 320000 / 8 / 8);
+    // draining the interleaver must not wait for the max interleave delta of a track that never produced
+    EXPECT_LT(stopCost, 1000); // 1000: ms
+    CheckAudio(filePath);
+    ASSERT_EQ(0, close(fd));
+}
+
 } // namespace Test
 } // namespace Media
 } // namespace OHOS
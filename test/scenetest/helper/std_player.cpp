@@ -82,6 +82,7 @@ public:
     int32_t GetVideoTrackInfo(std::vector<Format> &videoTrack) override;
     int32_t SetPlaybackSpeed(PlaybackRateMode mode) override;
     int32_t GetPlaybackSpeed(PlaybackRateMode &mode) override;
+    int32_t SetNextSource(const std::string& url) override;
 private:
     std::unique_ptr<IPlayerEngine> player_;
     std::atomic<PlayerStates> pipelineStates_ {PlayerStates::PLAYER_IDLE};
@@ -244,6 +245,12 @@ int32_t TestPlayerImpl::GetPlaybackSpeed(PlaybackRateMode& mode)
     return player_->GetPlaybackSpeed(mode);
 }
 
+int32_t TestPlayerImpl::SetNextSource(const std::string& url)
+{
+    // gapless playback is not part of IPlayerEngine, the engine is always created as HiPlayerImpl
+    return static_cast<HiPlayerImpl*>(player_.get())->SetNextSource(url);
+}
+
 int32_t TestPlayerImpl::SetVolume(float leftVolume, float rightVolume)
 {
     int32_t ret = player_->SetVolume(leftVolume, rightVolume);
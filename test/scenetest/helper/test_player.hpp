@@ -69,6 +69,7 @@ public:
     virtual int32_t GetVideoTrackInfo(std::vector<Format> &videoTrack) = 0;
     virtual int32_t SetPlaybackSpeed(PlaybackRateMode mode)  = 0;
     virtual int32_t GetPlaybackSpeed(PlaybackRateMode &mode) = 0;
+    virtual int32_t SetNextSource(const std::string& url) = 0;
 };
 }
 #endif
\ No newline at end of file
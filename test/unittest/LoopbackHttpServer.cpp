@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LoopbackHttpServer.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "openssl/ec.h"
+#include "openssl/evp.h"
+#include "openssl/x509.h"
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+namespace {
+constexpr int POLL_MS = 50;              // 50: ms, how often the server threads check running_
+constexpr size_t PACED_CHUNK = 8 * 1024; // 8: KB sent at a time by a paced server
+}
+
+LoopbackHttpServer::LoopbackHttpServer(Options options) : options_(std::move(options))
+{
+    if (options_.tls) {
+        SSL_library_init();
+        if (!MakeTlsContext()) {
+            return;
+        }
+    }
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(listenFd_, 8) != 0 || // 8: backlog
+        getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return;
+    }
+    port_ = ntohs(addr.sin_port);
+    acceptThread_ = std::thread([this] { AcceptLoop(); });
+}
+
+LoopbackHttpServer::~LoopbackHttpServer()
+{
+    running_ = false;
+    if (acceptThread_.joinable()) {
+        acceptThread_.join();
+    }
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+    }
+    SSL_CTX_free(context_);
+}
+
+std::string LoopbackHttpServer::Url(const std::string& path) const
+{
+    return (options_.tls ? "https://" : "http://") + Host() + path;
+}
+
+std::string LoopbackHttpServer::Host() const
+{
+    return "127.0.0.1:" + std::to_string(port_);
+}
+
+bool LoopbackHttpServer::MakeTlsContext()
+{
+    EVP_PKEY* key = nullptr;
+    EVP_PKEY_CTX* keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    if (keyContext == nullptr || EVP_PKEY_keygen_init(keyContext) <= 0 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1) <= 0 ||
+        EVP_PKEY_keygen(keyContext, &key) <= 0) {
+        EVP_PKEY_CTX_free(keyContext);
+        return false;
+    }
+    EVP_PKEY_CTX_free(keyContext);
+    X509* cert = X509_new();
+    X509_set_version(cert, 2); // 2: v3
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600); // 24 * 3600: valid for a day
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("127.0.0.1"),
+        -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+    context_ = SSL_CTX_new(TLS_server_method());
+    bool ready = context_ != nullptr && SSL_CTX_use_certificate(context_, cert) == 1 &&
+        SSL_CTX_use_PrivateKey(context_, key) == 1;
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ready;
+}
+
+void LoopbackHttpServer::AcceptLoop()
+{
+    while (running_) {
+        pollfd pfd {listenFd_, POLLIN, 0};
+        if (poll(&pfd, 1, POLL_MS) <= 0) {
+            continue;
+        }
+        int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd >= 0) {
+            connections_++;
+            workers_.emplace_back([this, fd] { Serve(fd); });
+        }
+    }
+}
+
+void LoopbackHttpServer::Serve(int fd)
+{
+    if (!options_.tls) {
+        ServeRequests(fd, nullptr);
+        close(fd);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(options_.handshakeDelayMs));
+    SSL* ssl = SSL_new(context_);
+    SSL_set_fd(ssl, fd);
+    if (SSL_accept(ssl) == 1) {
+        resumedSessions_ += SSL_session_reused(ssl) ? 1 : 0;
+        ServeRequests(fd, ssl);
+        SSL_shutdown(ssl);
+    }
+    SSL_free(ssl);
+    close(fd);
+}
+
+void LoopbackHttpServer::ServeRequests(int fd, SSL* ssl)
+{
+    std::string request;
+    char buf[1024]; // 1024: request header chunk
+    while (running_) {
+        if (ssl == nullptr || SSL_pending(ssl) == 0) {
+            pollfd pfd {fd, POLLIN, 0};
+            if (poll(&pfd, 1, POLL_MS) <= 0) {
+                continue;
+            }
+        }
+        auto len = ssl == nullptr ? read(fd, buf, sizeof(buf)) : SSL_read(ssl, buf, sizeof(buf));
+        if (len <= 0) {
+            return;
+        }
+        request.append(buf, len);
+        auto end = request.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            continue;
+        }
+        if (!Respond(fd, ssl, request.substr(0, end)) || options_.closeAfterResponse) {
+            return;
+        }
+        request.erase(0, end + 4); // 4: header terminator
+    }
+}
+
+bool LoopbackHttpServer::Respond(int fd, SSL* ssl, const std::string& header)
+{
+    requests_++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(options_.responseDelayMs));
+    const auto& body = options_.body;
+    size_t start = 0;
+    size_t end = body.size() - 1;
+    auto pos = header.find("Range: bytes=");
+    bool ranged = pos != std::string::npos;
+    if (ranged) {
+        unsigned long first = 0;
+        unsigned long last = 0;
+        int fields = sscanf(header.c_str() + pos, "Range: bytes=%lu-%lu", &first, &last);
+        start = first;
+        end = fields == 2 ? std::min<size_t>(last, end) : end; // 2: both ends given
+    }
+    std::string response = ranged ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+    response += options_.closeAfterResponse ? "Connection: close\r\n" : "";
+    response += options_.eTag.empty() ? "" : "ETag: \"" + options_.eTag + "\"\r\n";
+    response += "Content-Type: " + options_.contentType + "\r\nContent-Length: " + std::to_string(end - start + 1) +
+        "\r\n";
+    if (ranged) {
+        response += "Content-Range: bytes " + std::to_string(start) + "-" + std::to_string(end) + "/" +
+            std::to_string(body.size()) + "\r\n";
+    }
+    response += "\r\n";
+    response.append(reinterpret_cast<const char*>(body.data()) + start, end - start + 1);
+    return Send(fd, ssl, response);
+}
+
+bool LoopbackHttpServer::Send(int fd, SSL* ssl, const std::string& response)
+{
+    size_t chunk = options_.bytesPerSecond == 0 ? response.size() : PACED_CHUNK;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t sent = 0; sent < response.size() && running_;) {
+        size_t size = std::min(chunk, response.size() - sent);
+        auto len = ssl == nullptr ? write(fd, response.data() + sent, size) :
+            SSL_write(ssl, response.data() + sent, static_cast<int>(size));
+        if (len <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(len);
+        sentBytes_ += static_cast<uint64_t>(len);
+        if (options_.bytesPerSecond != 0) {
+            std::this_thread::sleep_until(begin +
+                std::chrono::microseconds(sent * 1000000 / options_.bytesPerSecond)); // 1000000: us per second
+        }
+    }
+    return running_;
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
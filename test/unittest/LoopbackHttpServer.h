@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HISTREAMER_TEST_LOOPBACK_HTTP_SERVER_H
+#define HISTREAMER_TEST_LOOPBACK_HTTP_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "openssl/ssl.h"
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+/**
+ * Local stand-in for a web server, used by the http source tests.
+ *
+ * Serves one body for any path, with range support, over http or https with a self signed certificate made at
+ * start. Latency, bandwidth and connection handling are configurable to stand in for a remote server.
+ */
+class LoopbackHttpServer {
+public:
+    struct Options {
+        std::vector<uint8_t> body {};
+        std::string contentType {"video/mp4"};
+        std::string eTag {};              // no ETag header if empty
+        int responseDelayMs {0};          // before each response, the latency of the server
+        int handshakeDelayMs {0};         // before the tls handshake of each connection
+        uint64_t bytesPerSecond {0};      // pace of the responses, 0 is unlimited
+        bool tls {false};
+        bool closeAfterResponse {false};  // one response per connection
+    };
+
+    explicit LoopbackHttpServer(Options options);
+    ~LoopbackHttpServer();
+
+    std::string Url(const std::string& path) const;
+    std::string Host() const;
+
+    int Requests() const
+    {
+        return requests_;
+    }
+
+    int Connections() const
+    {
+        return connections_;
+    }
+
+    int ResumedSessions() const
+    {
+        return resumedSessions_;
+    }
+
+    uint64_t SentBytes() const
+    {
+        return sentBytes_;
+    }
+
+private:
+    bool MakeTlsContext();
+    void AcceptLoop();
+    void Serve(int fd);
+    void ServeRequests(int fd, SSL* ssl);
+    bool Respond(int fd, SSL* ssl, const std::string& header);
+    bool Send(int fd, SSL* ssl, const std::string& response);
+
+    Options options_;
+    SSL_CTX* context_ {nullptr};
+    int listenFd_ {-1};
+    uint16_t port_ {0};
+    std::atomic<bool> running_ {true};
+    std::atomic<int> requests_ {0};
+    std::atomic<int> connections_ {0};
+    std::atomic<int> resumedSessions_ {0};
+    std::atomic<uint64_t> sentBytes_ {0};
+    std::thread acceptThread_;
+    std::vector<std::thread> workers_;
+};
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
+#endif // HISTREAMER_TEST_LOOPBACK_HTTP_SERVER_H
@@ -13,9 +13,19 @@
  * limitations under the License.
  */
 
+#include <fstream>
+#include <iostream>
+#include <iterator>
 #include "gtest/gtest.h"
+#include "foundation/utils/constants.h"
+#include "foundation/utils/steady_clock.h"
+#include "plugin/common/plugin_time.h"
 #include "plugin/plugins/demuxer/aac_demuxer/aac_demuxer_plugin.h"
 
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "/data/test/media"
+#endif
+
 using namespace testing::ext;
 using namespace OHOS::Media::Plugin;
 using namespace OHOS::Media::Plugin::AacDemuxer;
@@ -23,6 +33,98 @@ using namespace OHOS::Media::Plugin::AacDemuxer;
 namespace OHOS {
 namespace Media {
 namespace Test {
+namespace {
+constexpr int64_t AAC_FRAME_DURATION_US = (1024 * 1000000 + 44100 - 1) / 44100; // 1024 samples per frame at 44100 Hz
+constexpr int SEEK_TIMES = 100;
+
+class MemoryDataSource : public DataSource {
+public:
+    explicit MemoryDataSource(std::vector<uint8_t> data) : data_(std::move(data)) {}
+    Status ReadAt(int64_t offset, std::shared_ptr<Buffer>& buffer, size_t expectedLen) override
+    {
+        if (offset < 0 || static_cast<size_t>(offset) >= data_.size()) {
+            return Status::END_OF_STREAM;
+        }
+        auto memory = buffer->IsEmpty() ? buffer->AllocMemory(nullptr, expectedLen) : buffer->GetMemory();
+        size_t length = std::min({expectedLen, data_.size() - static_cast<size_t>(offset), memory->GetCapacity()});
+        memory->Write(data_.data() + offset, length, 0);
+        readTimes++;
+        return Status::OK;
+    }
+    Status GetSize(uint64_t& size) override
+    {
+        size = data_.size();
+        return Status::OK;
+    }
+    Seekable GetSeekable() override
+    {
+        return Seekable::SEEKABLE;
+    }
+    size_t readTimes {0};
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+class TestCallback : public Callback {
+public:
+    void OnEvent(const PluginEvent& event) override {}
+};
+
+std::vector<uint8_t> LoadFile(const std::string& path, int repeatTimes = 1)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> data;
+    for (int i = 0; i < repeatTimes; ++i) {
+        data.insert(data.end(), content.begin(), content.end());
+    }
+    return data;
+}
+
+std::shared_ptr<AACDemuxerPlugin> PrepareDemuxer(const std::shared_ptr<DataSource>& source)
+{
+    auto demuxer = std::make_shared<AACDemuxerPlugin>("seek");
+    if (demuxer->Init() != Status::OK || demuxer->SetDataSource(source) != Status::OK) {
+        return nullptr;
+    }
+    MediaInfo mediaInfo;
+    if (demuxer->GetMediaInfo(mediaInfo) != Status::OK) {
+        return nullptr;
+    }
+    return demuxer;
+}
+
+void CheckSeek(const std::shared_ptr<AACDemuxerPlugin>& demuxer, int64_t seekUs)
+{
+    int64_t realSeekTime = -1;
+    ASSERT_EQ(Status::OK, demuxer->SeekTo(0, seekUs * HST_USECOND, SeekMode::SEEK_PREVIOUS_SYNC, realSeekTime));
+    ASSERT_LE(realSeekTime, seekUs * HST_USECOND);
+    ASSERT_LE(seekUs * HST_USECOND - realSeekTime, AAC_FRAME_DURATION_US * HST_USECOND);
+    Buffer frame;
+    ASSERT_EQ(Status::OK, demuxer->ReadFrame(frame, 0));
+    ASSERT_EQ(realSeekTime, frame.pts);
+}
+
+void BenchmarkSeek(const std::string& name, std::vector<uint8_t> data, int64_t durationUs)
+{
+    auto source = std::make_shared<MemoryDataSource>(std::move(data));
+    auto demuxer = PrepareDemuxer(source);
+    ASSERT_TRUE(demuxer != nullptr);
+    SteadyClock clock;
+    CheckSeek(demuxer, durationUs * 9 / 10); // 9 / 10: near the end, forces a header scan
+    auto firstSeekUs = clock.ElapsedMicroseconds();
+    auto firstReadTimes = source->readTimes;
+    clock.Reset();
+    for (int i = 0; i < SEEK_TIMES; ++i) {
+        CheckSeek(demuxer, durationUs * ((i * 37) % SEEK_TIMES) / SEEK_TIMES); // 37: scatter the seek positions
+    }
+    std::cout << name << ": first seek " << firstSeekUs << " us with " << firstReadTimes << " reads, indexed seek "
+              << clock.ElapsedMicroseconds() / SEEK_TIMES << " us on average" << std::endl;
+    ASSERT_TRUE(demuxer->Deinit() == Status::OK);
+}
+}
+
 std::shared_ptr<AACDemuxerPlugin> AacDemuxerPluginCreate(const std::string& name)
 {
     return std::make_shared<AACDemuxerPlugin>(name);
@@ -108,8 +210,8 @@ HWTEST(TestAacDemuxerPlugin, find_aac_demuxer_plugins_set_callback, TestSize.Lev
 {
     std::shared_ptr<AACDemuxerPlugin> aacDemuxerPlugin = AacDemuxerPluginCreate("set callback");
     ASSERT_TRUE(aacDemuxerPlugin != nullptr);
-    Callback* cb = new Callback();
-    auto status = aacDemuxerPlugin->SetCallback(cb);
+    TestCallback cb;
+    auto status = aacDemuxerPlugin->SetCallback(&cb);
     ASSERT_TRUE(status == Status::OK);
 }
 
@@ -140,11 +242,40 @@ HWTEST(TestAacDemuxerPlugin, find_aac_demuxer_plugins_get_select_track, TestSize
 {
     std::shared_ptr<AACDemuxerPlugin> aacDemuxerPlugin = AacDemuxerPluginCreate("get select track");
     ASSERT_TRUE(aacDemuxerPlugin != nullptr);
-    std::vector<int32_t> trackIds = new std::vector<int32_t>[1];
+    std::vector<int32_t> trackIds;
     auto selectStatus = aacDemuxerPlugin->GetSelectedTracks(trackIds);
     ASSERT_TRUE(selectStatus == Status::OK);
 }
 
+HWTEST(TestAacDemuxerPlugin, aac_demuxer_seek_short_file, TestSize.Level1)
+{
+    auto data = LoadFile(RESOURCE_DIR "/AAC/AAC_48000_32_SHORT.aac");
+    ASSERT_FALSE(data.empty());
+    // 131 frames of 1024 samples
+    BenchmarkSeek("AAC_48000_32_SHORT", std::move(data), 131 * AAC_FRAME_DURATION_US);
+}
+
+HWTEST(TestAacDemuxerPlugin, aac_demuxer_seek_long_synthetic_file, TestSize.Level1)
+{
+    auto data = LoadFile(RESOURCE_DIR "/AAC/AAC_48000_32_SHORT.aac", 200); // 200: about 10 minutes
+    ASSERT_FALSE(data.empty());
+    BenchmarkSeek("synthetic long aac", std::move(data), 131 * 200 * AAC_FRAME_DURATION_US); // 131 frames, 200 times
+}
+
+HWTEST(TestAacDemuxerPlugin, aac_demuxer_index_is_shared_per_data_source, TestSize.Level1)
+{
+    auto source = std::make_shared<MemoryDataSource>(LoadFile(RESOURCE_DIR "/AAC/AAC_48000_32_SHORT.aac"));
+    auto first = PrepareDemuxer(source);
+    ASSERT_TRUE(first != nullptr);
+    CheckSeek(first, 2000000); // 2000000: 2s, indexes the stream up to there
+    auto second = PrepareDemuxer(source);
+    ASSERT_TRUE(second != nullptr);
+    auto readTimes = source->readTimes;
+    CheckSeek(second, 1000000); // 1000000: 1s, inside the indexed region
+    // one read for the frames between the index entry and the target, one for the frame itself
+    ASSERT_LE(source->readTimes - readTimes, 2u);
+}
+
 } // namespace Test
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
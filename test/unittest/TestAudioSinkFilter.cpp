@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+
+#include <memory>   // NOLINT
+#include <mutex>    // NOLINT
+#include <vector>   // NOLINT
+#include "pipeline/filters/sink/audio_sink/audio_sink_filter.h"
+#include "plugin/common/plugin_buffer.h"
+#include "plugin/common/plugin_time.h"
+#include "plugin/core/audio_sink.h"
+#include "plugin/interface/audio_sink_plugin.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace Pipeline;
+using namespace Plugin;
+
+namespace {
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr uint32_t CHANNELS = 2;
+constexpr size_t BYTES_PER_FRAME = CHANNELS * 2; // 2: bytes of a s16 sample
+constexpr int64_t FRAMES_PER_PACKET = 1152;      // 1152: mp3 frame
+constexpr int64_t ENCODER_DELAY = 576;           // 576: frames the decoder trims from the start of an item
+constexpr int64_t ENCODER_PADDING = 704;         // 704: frames the decoder trims from the end of an item
+
+int64_t FramesToHst(int64_t frames)
+{
+    return frames * HST_SECOND / SAMPLE_RATE;
+}
+
+class FakeAudioSinkPlugin : public AudioSinkPlugin {
+public:
+    struct Written {
+        int64_t pts;
+        int64_t frames;
+    };
+
+    explicit FakeAudioSinkPlugin(std::string name) : AudioSinkPlugin(std::move(name))
+    {
+    }
+
+    Status GetMute(bool& mute) override
+    {
+        mute = false;
+        return Status::OK;
+    }
+    Status SetMute(bool mute) override
+    {
+        return Status::OK;
+    }
+    Status GetVolume(float& volume) override
+    {
+        volume = 1.0f;
+        return Status::OK;
+    }
+    Status SetVolume(float volume) override
+    {
+        return Status::OK;
+    }
+    Status GetSpeed(float& speed) override
+    {
+        speed = 1.0f;
+        return Status::OK;
+    }
+    Status SetSpeed(float speed) override
+    {
+        return Status::OK;
+    }
+    Status Pause() override
+    {
+        return Status::OK;
+    }
+    Status Resume() override
+    {
+        return Status::OK;
+    }
+    Status GetLatency(uint64_t& hstTime) override
+    {
+        hstTime = 0;
+        return Status::OK;
+    }
+    Status GetFrameSize(size_t& size) override
+    {
+        return Status::ERROR_UNIMPLEMENTED;
+    }
+    Status GetFrameCount(uint32_t& count) override
+    {
+        return Status::ERROR_UNIMPLEMENTED;
+    }
+    Status Write(const std::shared_ptr<Buffer>& input) override
+    {
+        if ((input->flag & BUFFER_FLAG_EOS) == 0) {
+            written.push_back({input->pts, static_cast<int64_t>(input->GetMemory()->GetSize() / BYTES_PER_FRAME)});
+        }
+        return Status::OK;
+    }
+    Status Flush() override
+    {
+        return Status::OK;
+    }
+    Status Drain() override
+    {
+        drains++;
+        return Status::OK;
+    }
+    Status SetCallback(Callback* cb) override
+    {
+        return Status::OK;
+    }
+
+    std::vector<Written> written;
+    int drains {0};
+};
+
+class EventRecorder : public EventReceiver {
+public:
+    void OnEvent(const Event& event) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back(event);
+    }
+
+    std::vector<Event> Events(EventType type)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Event> events;
+        for (const auto& event : events_) {
+            if (event.type == type) {
+                events.push_back(event);
+            }
+        }
+        return events;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<Event> events_;
+};
+
+std::shared_ptr<Buffer> PcmBuffer(int64_t pts, int64_t frames)
+{
+    auto size = static_cast<size_t>(frames) * BYTES_PER_FRAME;
+    auto buffer = Buffer::CreateDefaultBuffer(BufferMetaType::AUDIO, size);
+    std::vector<uint8_t> pcm(size, 0);
+    buffer->GetMemory()->Write(pcm.data(), size);
+    buffer->pts = pts;
+    return buffer;
+}
+
+std::shared_ptr<Buffer> EosBuffer()
+{
+    auto buffer = std::make_shared<Buffer>(BufferMetaType::AUDIO);
+    buffer->flag |= BUFFER_FLAG_EOS;
+    return buffer;
+}
+
+std::shared_ptr<Meta> ItemMeta(uint32_t trackId)
+{
+    auto meta = std::make_shared<Meta>();
+    meta->Set<Tag::AUDIO_SAMPLE_RATE>(SAMPLE_RATE);
+    meta->Set<Tag::AUDIO_CHANNELS>(CHANNELS);
+    meta->Set<Tag::AUDIO_SAMPLE_FORMAT>(AudioSampleFormat::S16);
+    meta->Set<Tag::TRACK_ID>(trackId);
+    meta->Set<Tag::MEDIA_DURATION>(FramesToHst(FRAMES_PER_PACKET * 2)); // 2: packets of an item
+    return meta;
+}
+} // namespace
+
+class TestAudioSinkFilter : public ::testing::Test {
+public:
+    void SetUp() override
+    {
+        filter = std::make_shared<AudioSinkFilter>("audioSink");
+        filter->Init(&receiver, nullptr);
+        sink = std::make_shared<FakeAudioSinkPlugin>("fakeAudioSink");
+        filter->plugin_ = std::shared_ptr<AudioSink>(new AudioSink(0, 0, sink));
+        ASSERT_EQ(Status::OK, filter->plugin_->Init());
+        filter->pluginInfo_ = std::make_shared<PluginInfo>();
+        filter->pluginInfo_->name = sink->GetName();
+    }
+
+    void TearDown() override
+    {
+        filter.reset();
+    }
+
+    // configures the item on the default in port and the next one on the standby in port, then starts
+    void PrepareSplice()
+    {
+        Meta upstreamParams;
+        Meta downstreamParams;
+        ASSERT_TRUE(filter->Configure(PORT_NAME_DEFAULT, ItemMeta(0), upstreamParams, downstreamParams));
+        filter->SetSpliceEnabled(true);
+        auto standby = filter->GetStandbyInPort();
+        ASSERT_NE(PORT_NAME_DEFAULT, standby->GetName());
+        ASSERT_TRUE(filter->Configure(standby->GetName(), ItemMeta(1), upstreamParams, downstreamParams));
+        ASSERT_EQ(ErrorCode::SUCCESS, filter->Start());
+    }
+
+    // the decoded frames of an mp3 item of two packets, with the encoder delay and padding trimmed by the decoder
+    void PushItem(const std::string& inPort)
+    {
+        auto firstFrames = FRAMES_PER_PACKET - ENCODER_DELAY;
+        auto lastFrames = FRAMES_PER_PACKET - ENCODER_PADDING;
+        // the decoder moves the pts forward by the delay it trims
+        ASSERT_EQ(ErrorCode::SUCCESS, filter->PushData(inPort, PcmBuffer(FramesToHst(ENCODER_DELAY), firstFrames), 0));
+        ASSERT_EQ(ErrorCode::SUCCESS,
+                  filter->PushData(inPort, PcmBuffer(FramesToHst(FRAMES_PER_PACKET), lastFrames), 0));
+        ASSERT_EQ(ErrorCode::SUCCESS, filter->PushData(inPort, EosBuffer(), 0));
+    }
+
+    EventRecorder receiver;
+    std::shared_ptr<AudioSinkFilter> filter;
+    std::shared_ptr<FakeAudioSinkPlugin> sink;
+};
+
+HWTEST_F(TestAudioSinkFilter, splice_retimes_the_next_item_to_the_end_of_the_current_one, TestSize.Level1)
+{
+    PrepareSplice();
+    auto standby = filter->GetStandbyInPort()->GetName();
+    PushItem(PORT_NAME_DEFAULT);
+    // the end of stream of the first item neither drains nor completes, the next item takes over
+    EXPECT_EQ(0, sink->drains);
+    EXPECT_TRUE(receiver.Events(EventType::EVENT_COMPLETE).empty());
+    EXPECT_EQ(standby, filter->GetActiveInPort()->GetName());
+    int64_t itemEndPts = filter->itemEndPts_;
+    ASSERT_EQ(2u, sink->written.size()); // 2: buffers of the first item
+    EXPECT_EQ(sink->written.back().pts + FramesToHst(sink->written.back().frames), itemEndPts);
+
+    PushItem(standby);
+    ASSERT_EQ(4u, sink->written.size()); // 4: buffers of both items
+    EXPECT_EQ(itemEndPts, sink->written[2].pts); // 2: first buffer of the next item
+    auto spliced = receiver.Events(EventType::EVENT_AUDIO_SPLICED);
+    ASSERT_EQ(1u, spliced.size());
+    EXPECT_EQ(itemEndPts - FramesToHst(ENCODER_DELAY), AnyCast<int64_t>(spliced[0].param));
+    EXPECT_EQ(1, sink->drains);
+    EXPECT_EQ(1u, receiver.Events(EventType::EVENT_COMPLETE).size());
+}
+
+HWTEST_F(TestAudioSinkFilter, splice_leaves_no_delay_or_padding_on_the_timeline, TestSize.Level1)
+{
+    PrepareSplice();
+    auto standby = filter->GetStandbyInPort()->GetName();
+    PushItem(PORT_NAME_DEFAULT);
+    PushItem(standby);
+    ASSERT_EQ(4u, sink->written.size()); // 4: buffers of both items
+    int64_t frames = 0;
+    for (size_t i = 0; i < sink->written.size(); i++) {
+        frames += sink->written[i].frames;
+        if (i == 0) {
+            continue;
+        }
+        // the trimmed delay leaves no gap and the trimmed padding no overlap, up to the rounding of the pts
+        auto expected = sink->written[i - 1].pts + FramesToHst(sink->written[i - 1].frames);
+        EXPECT_NEAR(static_cast<double>(expected), static_cast<double>(sink->written[i].pts), 1.0);
+    }
+    // 2: items, all of the samples played are the ones left by the decoder
+    EXPECT_EQ(2 * (2 * FRAMES_PER_PACKET - ENCODER_DELAY - ENCODER_PADDING), frames);
+    EXPECT_EQ(FramesToHst(ENCODER_DELAY), sink->written[0].pts);
+}
+
+HWTEST_F(TestAudioSinkFilter, stop_returns_to_the_default_in_port, TestSize.Level1)
+{
+    PrepareSplice();
+    auto standby = filter->GetStandbyInPort()->GetName();
+    PushItem(PORT_NAME_DEFAULT);
+    ASSERT_EQ(standby, filter->GetActiveInPort()->GetName());
+    ASSERT_TRUE(filter->retimeNextBuffer_);
+
+    ASSERT_EQ(ErrorCode::SUCCESS, filter->Stop());
+    EXPECT_EQ(PORT_NAME_DEFAULT, filter->GetActiveInPort()->GetName());
+    EXPECT_NE(PORT_NAME_DEFAULT, filter->GetStandbyInPort()->GetName());
+    EXPECT_FALSE(filter->retimeNextBuffer_);
+    EXPECT_EQ(0, filter->itemOffset_);
+    EXPECT_EQ(HST_TIME_NONE, filter->itemEndPts_);
+    EXPECT_FALSE(filter->spliceArmed_);
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
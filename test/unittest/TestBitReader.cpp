@@ -13,6 +13,10 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
 #include "gtest/gtest.h"
 #include "plugin/common/any.h"
 #define private public
@@ -104,6 +108,184 @@ HWTEST_F(TestBitReader, test_seek_bits, TestSize.Level1)
     EXPECT_EQ(bitReader.ReadBits(4, val), true);
     EXPECT_EQ(val, 0xf);
 }
+
+HWTEST_F(TestBitReader, test_seek_mid_byte, TestSize.Level1)
+{
+    const uint8_t data[] = {0xff, 0x11, 0x22, 0x33};
+    bitReader.Reset(data, sizeof(data));
+    uint32_t val = 0;
+    EXPECT_EQ(bitReader.SeekTo(3), true);
+    EXPECT_EQ(bitReader.GetAvailableBits(), 29);
+    EXPECT_EQ(bitReader.ReadBits(9, val), true);
+    EXPECT_EQ(val, 0x1f1);
+    EXPECT_EQ(bitReader.SeekTo(13), true);
+    EXPECT_EQ(bitReader.ReadBits(3, val), true);
+    EXPECT_EQ(val, 0x1);
+    EXPECT_EQ(bitReader.GetCurrentPtr(), data + 2);
+    EXPECT_EQ(bitReader.SeekTo(32), false);
+}
+
+HWTEST_F(TestBitReader, test_long_reads_and_skip, TestSize.Level1)
+{
+    const uint8_t data[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0xfe, 0xdc, 0xba, 0x98};
+    bitReader.Reset(data, sizeof(data));
+    uint64_t val = 0;
+    EXPECT_EQ(bitReader.ReadBits(4, val), true);
+    EXPECT_EQ(bitReader.ReadBits(64, val), true);
+    EXPECT_EQ(val, 0x123456789abcdeffULL);
+    EXPECT_EQ(bitReader.GetCurrentPtr(), data + 8);
+    EXPECT_EQ(bitReader.PeekBits(12, val), true);
+    EXPECT_EQ(val, 0xedc);
+    EXPECT_EQ(bitReader.GetAvailableBits(), 28);
+    EXPECT_EQ(bitReader.ReadBits(29, val), false);
+    EXPECT_EQ(bitReader.GetAvailableBits(), 28);
+    bitReader.SkipBits(20);
+    EXPECT_EQ(bitReader.ReadBits(8, val), true);
+    EXPECT_EQ(val, 0x98);
+    bitReader.Reset(data, sizeof(data));
+    bitReader.SkipBits(1000);
+    EXPECT_EQ(bitReader.GetAvailableBits(), 0);
+    EXPECT_EQ(bitReader.ReadBits(1, val), false);
+}
+
+HWTEST_F(TestBitReader, test_exp_golomb, TestSize.Level1)
+{
+    // ue: 1 | 010 | 011 | 00100 | 0001000, 5 bits padding, se: 1 | 010 | 011 | 00100 | 00101
+    const uint8_t data[] = {0xa6, 0x41, 0x00, 0xa6, 0x42, 0x80};
+    bitReader.Reset(data, sizeof(data));
+    uint32_t ue = 0;
+    for (uint32_t expected : {0u, 1u, 2u, 3u, 7u}) {
+        EXPECT_EQ(bitReader.ReadUe(ue), true);
+        EXPECT_EQ(ue, expected);
+    }
+    bitReader.SkipBits(5);
+    int32_t se = 0;
+    for (int32_t expected : {0, 1, -1, 2, -2}) {
+        EXPECT_EQ(bitReader.ReadSe(se), true);
+        EXPECT_EQ(se, expected);
+    }
+    EXPECT_EQ(bitReader.ReadUe(ue), false);
+
+    // 31 leading zeros is the largest 32 bits code, 32 leading zeros is rejected without consuming
+    const uint8_t big[] = {0x00, 0x00, 0x00, 0x01, 0xff, 0xff, 0xff, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x80};
+    bitReader.Reset(big, sizeof(big));
+    EXPECT_EQ(bitReader.ReadUe(ue), true);
+    EXPECT_EQ(ue, 0xfffffffe);
+    bitReader.Reset(big + 8, sizeof(big) - 8); // 8: second code
+    EXPECT_EQ(bitReader.ReadUe(ue), false);
+    EXPECT_EQ(bitReader.GetAvailableBits(), 40);
+}
+
+HWTEST_F(TestBitReader, test_rbsp_mode, TestSize.Level1)
+{
+    // 00 00 03 01 unescapes to 00 00 01, 00 00 03 03 to 00 00 03 and 00 00 00 03 25 to 00 00 00 25
+    const uint8_t data[] = {0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x00, 0x03, 0x25};
+    bitReader.Reset(data, sizeof(data));
+    bitReader.SetRbspMode(true);
+    uint32_t val = 0;
+    EXPECT_EQ(bitReader.ReadBits(24, val), true);
+    EXPECT_EQ(val, 0x000001);
+    EXPECT_EQ(bitReader.ReadBits(24, val), true);
+    EXPECT_EQ(val, 0x000003);
+    EXPECT_EQ(bitReader.ReadBits(16, val), true);
+    EXPECT_EQ(val, 0x0000);
+    EXPECT_EQ(bitReader.ReadBits(8, val), true);
+    EXPECT_EQ(val, 0x00);
+    EXPECT_EQ(bitReader.ReadBits(8, val), true);
+    EXPECT_EQ(val, 0x25);
+    EXPECT_EQ(bitReader.ReadBits(1, val), false);
+
+    // a code straddling an emulation prevention byte: aa | 23 zeros, 1, 23 info bits | 0
+    const uint8_t nal[] = {0xaa, 0x00, 0x00, 0x03, 0x01, 0x80, 0x00, 0x00};
+    bitReader.Reset(nal, sizeof(nal));
+    bitReader.SetRbspMode(true);
+    bitReader.SkipBits(8); // 8: aa
+    uint32_t ue = 0;
+    EXPECT_EQ(bitReader.ReadUe(ue), true);
+    EXPECT_EQ(ue, 12582911);
+    EXPECT_EQ(bitReader.SeekTo(32), true);
+    EXPECT_EQ(bitReader.ReadBits(16, val), true);
+    EXPECT_EQ(val, 0x0180);
+    // seeking onto the emulation prevention byte still drops it
+    EXPECT_EQ(bitReader.SeekTo(24), true);
+    EXPECT_EQ(bitReader.ReadBits(8, val), true);
+    EXPECT_EQ(val, 0x01);
+}
+
+namespace {
+// the reader before the reservoir, kept as the reference of the benchmark
+class LegacyBitReader {
+public:
+    LegacyBitReader(const uint8_t* begin, const uint8_t* end) : cur_(begin), end_(end) {}
+
+    size_t GetAvailableBits() const
+    {
+        return (cur_ != end_) ? static_cast<std::size_t>(((end_ - cur_ - 1) * 8) + availBits_) : 0; // 8
+    }
+
+    bool ReadBits(uint8_t bits, uint32_t& val)
+    {
+        if (GetAvailableBits() < bits) {
+            return false;
+        }
+        val = 0;
+        uint8_t remainBits = bits;
+        for (uint8_t toRead = 0; remainBits; remainBits -= toRead) {
+            if (availBits_ == 0) {
+                ++cur_;
+                availBits_ = 8; // 8
+            }
+            toRead = std::min(remainBits, availBits_);
+            uint8_t shift = availBits_ - toRead;
+            uint64_t mask = 0xFF >> (0x08 - toRead);
+            val = static_cast<uint32_t>((val << toRead) | static_cast<uint32_t>(((*cur_) >> shift) & mask));
+            availBits_ -= toRead;
+        }
+        return true;
+    }
+
+private:
+    const uint8_t* cur_;
+    const uint8_t* end_;
+    uint8_t availBits_ {8};
+};
+} // namespace
+
+HWTEST_F(TestBitReader, test_read_bits_benchmark, TestSize.Level1)
+{
+    constexpr size_t dataSize = 64 * 1024; // 64 * 1024: a large access unit
+    std::vector<uint8_t> data(dataSize);
+    std::mt19937 random(0);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(random());
+    }
+    // field widths typical of slice and ADTS headers
+    const uint8_t widths[] = {1, 3, 5, 8, 2, 12, 13, 1, 4, 16, 7};
+    constexpr int32_t rounds = 20; // 20: passes over the data
+    uint64_t legacySum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t round = 0; round < rounds; ++round) {
+        LegacyBitReader legacy(data.data(), data.data() + data.size());
+        for (uint32_t val = 0, i = 0; legacy.ReadBits(widths[i % sizeof(widths)], val); ++i) {
+            legacySum += val;
+        }
+    }
+    auto legacyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count() / rounds;
+    uint64_t sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int32_t round = 0; round < rounds; ++round) {
+        bitReader.Reset(data.data(), data.size());
+        for (uint32_t val = 0, i = 0; bitReader.ReadBits(widths[i % sizeof(widths)], val); ++i) {
+            sum += val;
+        }
+    }
+    auto reservoirUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count() / rounds;
+    std::cout << "read " << dataSize << " bytes: byte loop " << legacyUs << "us, reservoir " << reservoirUs << "us"
+              << std::endl;
+    EXPECT_EQ(sum, legacySum);
+}
 } // namespace Test
 } // namespace Media
 } // namespace OHOS
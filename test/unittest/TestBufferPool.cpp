@@ -19,8 +19,12 @@
 #define protected public
 #define UNIT_TEST 1
 
+#include <atomic>
+#include <iostream>
+#include <thread>
 #include <vector>
 
+#include "allocation_counter.h"
 #include "foundation/utils/buffer_pool.h"
 #include "pipeline/core/type_define.h"
 
@@ -67,4 +71,86 @@ HWTEST_F(BufferPoolTest, buffer_pool_return_nullptr_after_buffer_exhausted, Test
     EXPECT_EQ(true, pool->Empty());
     EXPECT_EQ(nullptr, pool->AllocateBufferNonBlocking());
 }
+HWTEST_F(BufferPoolTest, buffer_pool_handout_does_not_allocate, TestSize.Level1)
+{
+    constexpr int cycles = 10000;
+    pool->AllocateBuffer().reset();
+    size_t allocations = 0;
+    {
+        AllocationCounter counter;
+        for (int i = 0; i < cycles; ++i) {
+            auto buffer = pool->AllocateBuffer();
+            auto another = pool->AllocateBufferNonBlocking();
+            ASSERT_TRUE(buffer != nullptr && another != nullptr);
+        }
+        allocations = counter.Count();
+    }
+    std::cout << "allocations per " << cycles << " acquire/release cycles: " << allocations << std::endl;
+    EXPECT_EQ(0u, allocations);
+    EXPECT_EQ(DEFAULT_POOL_SIZE, pool->Size());
+}
+
+HWTEST_F(BufferPoolTest, buffer_pool_weak_ref_outliving_buffer, TestSize.Level1)
+{
+    std::weak_ptr<AVBuffer> weak;
+    {
+        auto buffer = pool->AllocateBuffer();
+        weak = buffer;
+    }
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(DEFAULT_POOL_SIZE, pool->Size());
+    std::vector<std::shared_ptr<AVBuffer>> buffers;
+    for (size_t i = 0; i < DEFAULT_POOL_SIZE; ++i) {
+        buffers.emplace_back(pool->AllocateBuffer()); // one control block is placed on the heap
+    }
+    EXPECT_TRUE(pool->Empty());
+    buffers.clear();
+    EXPECT_EQ(DEFAULT_POOL_SIZE, pool->Size());
+}
+
+HWTEST_F(BufferPoolTest, buffer_pool_buffer_keeps_pool_alive, TestSize.Level1)
+{
+    auto buffer = pool->AllocateBuffer();
+    std::weak_ptr<BufferPool<AVBuffer>> weakPool = pool;
+    pool.reset();
+    EXPECT_FALSE(weakPool.expired());
+    buffer.reset();
+    EXPECT_TRUE(weakPool.expired());
+}
+
+HWTEST_F(BufferPoolTest, buffer_pool_concurrent_acquire_release, TestSize.Level1)
+{
+    constexpr int threadNum = 4;
+    constexpr int cycles = 10000;
+    std::vector<std::thread> threads;
+    std::atomic<int> handouts {0};
+    for (int i = 0; i < threadNum; ++i) {
+        threads.emplace_back([this, &handouts] {
+            for (int j = 0; j < cycles; ++j) {
+                auto buffer = pool->AllocateBuffer();
+                if (buffer != nullptr) {
+                    buffer->pts = j;
+                    handouts++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(threadNum * cycles, handouts.load());
+    EXPECT_EQ(DEFAULT_POOL_SIZE, pool->Size());
+}
+
+HWTEST_F(BufferPoolTest, buffer_pool_append_buffer_when_exhausted, TestSize.Level1)
+{
+    std::vector<std::shared_ptr<AVBuffer>> buffers;
+    for (size_t i = 0; i < DEFAULT_POOL_SIZE + 2; ++i) { // 2 more than the pool holds
+        buffers.emplace_back(pool->AllocateAppendBufferNonBlocking());
+        ASSERT_TRUE(buffers.back() != nullptr);
+    }
+    EXPECT_EQ(DEFAULT_POOL_SIZE + 2, pool->Capacity()); // 2 buffers appended
+    buffers.clear();
+    EXPECT_EQ(DEFAULT_POOL_SIZE + 2, pool->Size()); // 2 buffers appended
+}
 } // namespace
\ No newline at end of file
@@ -14,6 +14,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
 
 #define private public
 #define protected public
@@ -604,4 +606,62 @@ HWTEST(TestMergeMetaWithCapability, Merge_meta_with_capability_failed_Test, Test
     Meta out3;
     ASSERT_FALSE(Pipeline::MergeMetaWithCapability(meta, cap2, out3));
 }
+
+HWTEST(TestApplyCapability, ApplyCapabilitySet_Benchmark, TestSize.Level1)
+{
+    // upstream of an audio decoder link against the input capabilities of a typical decoder
+    Capability upstream(MEDIA_MIME_AUDIO_RAW);
+    upstream.AppendFixedKey<uint32_t>(CapabilityID::AUDIO_SAMPLE_RATE, 44100); // 44100: sample rate
+    upstream.AppendFixedKey<uint32_t>(CapabilityID::AUDIO_CHANNELS, 2); // 2: channels
+    upstream.AppendFixedKey<Plugin::AudioChannelLayout>(CapabilityID::AUDIO_CHANNEL_LAYOUT,
+                                                        Plugin::AudioChannelLayout::STEREO);
+    upstream.AppendFixedKey<Plugin::AudioSampleFormat>(CapabilityID::AUDIO_SAMPLE_FORMAT,
+                                                       Plugin::AudioSampleFormat::S16);
+    upstream.AppendFixedKey<int64_t>(CapabilityID::MEDIA_BITRATE, 128000); // 128000: bitrate
+    Capability rejected(MEDIA_MIME_AUDIO_RAW);
+    rejected.AppendDiscreteKeys<uint32_t>(CapabilityID::AUDIO_SAMPLE_RATE, {8000, 16000}); // 8000, 16000: rates
+    Capability accepted(MEDIA_MIME_AUDIO_RAW);
+    accepted.AppendIntervalKey<uint32_t>(CapabilityID::AUDIO_SAMPLE_RATE, 8000, 96000); // 8000, 96000: rates
+    accepted.AppendIntervalKey<uint32_t>(CapabilityID::AUDIO_CHANNELS, 1, 8); // 1, 8: channels
+    accepted.AppendDiscreteKeys<Plugin::AudioChannelLayout>(CapabilityID::AUDIO_CHANNEL_LAYOUT, {
+        Plugin::AudioChannelLayout::MONO, Plugin::AudioChannelLayout::STEREO,
+        Plugin::AudioChannelLayout::CH_5POINT1, Plugin::AudioChannelLayout::CH_7POINT1,
+    });
+    accepted.AppendDiscreteKeys<Plugin::AudioSampleFormat>(CapabilityID::AUDIO_SAMPLE_FORMAT, {
+        Plugin::AudioSampleFormat::U8, Plugin::AudioSampleFormat::S16, Plugin::AudioSampleFormat::S32,
+        Plugin::AudioSampleFormat::F32,
+    });
+    accepted.AppendIntervalKey<int64_t>(CapabilityID::MEDIA_BITRATE, 8000, 320000); // 8000, 320000: bitrates
+    CapabilitySet capSet = {rejected, accepted};
+
+    constexpr int32_t rounds = 10000; // 10000: negotiations
+    Capability out;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < rounds; ++i) {
+        ASSERT_TRUE(Pipeline::ApplyCapabilitySet(upstream, capSet, out));
+    }
+    auto costNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count() / rounds;
+    std::cout << "ApplyCapabilitySet: " << costNs << "ns per link of " << upstream.keys.size() << " keys" << std::endl;
+    ASSERT_TRUE(out.keys.size() == upstream.keys.size());
+    ASSERT_TRUE(Plugin::AnyCast<uint32_t>(out.keys[CapabilityID::AUDIO_SAMPLE_RATE]) == 44100);
+    ASSERT_TRUE(Plugin::AnyCast<Plugin::AudioSampleFormat>(out.keys[CapabilityID::AUDIO_SAMPLE_FORMAT]) ==
+                Plugin::AudioSampleFormat::S16);
+    ASSERT_TRUE(Plugin::AnyCast<int64_t>(out.keys[CapabilityID::MEDIA_BITRATE]) == 128000);
+}
+
+HWTEST(TestMergeCapabilityKeys, MergeCapabilityKeys_WideValues, TestSize.Level1)
+{
+    // values differing beyond the low 32 bits must not compare equal
+    Capability cap1;
+    cap1.AppendFixedKey<int64_t>(CapabilityID::MEDIA_BITRATE, 0x100000000);
+    Capability cap2;
+    cap2.AppendFixedKey<int64_t>(CapabilityID::MEDIA_BITRATE, 0);
+    Capability out;
+    ASSERT_FALSE(Pipeline::MergeCapabilityKeys(cap1, cap2, out));
+    cap2.AppendIntervalKey<int64_t>(CapabilityID::MEDIA_BITRATE, 0, 0x200000000);
+    ASSERT_TRUE(Pipeline::MergeCapabilityKeys(cap1, cap2, out));
+    ASSERT_TRUE(Plugin::AnyCast<int64_t>(out.keys[CapabilityID::MEDIA_BITRATE]) == 0x100000000);
+}
+
 }
\ No newline at end of file
@@ -13,11 +13,26 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 #include "plugin/core/plugin_register.h"
 #include "plugin/plugins/ffmpeg_adapter/video_decoder/video_ffmpeg_decoder_plugin.h"
 #include "plugin/common/plugin_caps_builder.h"
 #include "plugin/core/plugin_manager.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "libavutil/opt.h"
+#ifdef __cplusplus
+};
+#endif
 
 namespace OHOS {
 namespace Media {
@@ -30,6 +45,194 @@ namespace Test {
         return std::make_shared<VideoFfmpegDecoderPlugin>(name);
     }
 
+namespace {
+constexpr int32_t WIDTH = 640;
+constexpr int32_t HEIGHT = 360;
+constexpr int32_t FPS = 30;
+constexpr int32_t FRAME_COUNT = 150;  // 150: 5 s in one gop
+constexpr int32_t TARGET_FRAME = 120; // 120: far into the gop, as after a seek to its end
+constexpr int64_t FRAME_DURATION = HST_SECOND / FPS;
+constexpr size_t FRAME_SIZE = WIDTH * HEIGHT * 3 / 2; // 3 / 2: yuv420p
+constexpr int32_t OUT_BUFFER_CNT = 4;
+constexpr int32_t ROUNDS = 3;         // 3: the fastest round is taken, against scheduling noise
+constexpr int32_t DECODE_TIMEOUT_S = 10;
+
+struct EncodedFrame {
+    std::vector<uint8_t> data;
+    int64_t pts;
+};
+
+void FillPicture(AVFrame* frame, int32_t index, uint32_t& seed)
+{
+    for (int32_t plane = 0; plane < 3; plane++) { // 3: y, u, v
+        int32_t shift = plane == 0 ? 0 : 1;
+        for (int32_t y = 0; y < (HEIGHT >> shift); y++) {
+            uint8_t* row = frame->data[plane] + y * frame->linesize[plane];
+            for (int32_t x = 0; x < (WIDTH >> shift); x++) {
+                seed = seed * 1103515245 + 12345; // 1103515245, 12345: lcg, noise keeps the encoder busy
+                row[x] = static_cast<uint8_t>(x + y + index * 4 + ((seed >> 24) & 0x1f)); // 4: moving, 24: top bits
+            }
+        }
+    }
+}
+
+// one gop of h264 with b frames that are not referenced, in decoding order
+std::vector<EncodedFrame> EncodeGop()
+{
+    std::vector<EncodedFrame> frames;
+    AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    AVCodecContext* context = codec == nullptr ? nullptr : avcodec_alloc_context3(codec);
+    if (context == nullptr) {
+        return frames;
+    }
+    context->width = WIDTH;
+    context->height = HEIGHT;
+    context->pix_fmt = AV_PIX_FMT_YUV420P;
+    context->time_base = {1, FPS};
+    context->framerate = {FPS, 1};
+    context->gop_size = FRAME_COUNT * 2; // 2: no key frame but the first
+    context->max_b_frames = 2;           // 2: two of three frames need no decoding before the target
+    (void)av_opt_set(context->priv_data, "x264-params", "b-pyramid=none", 0);
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    if (avcodec_open2(context, codec, nullptr) == 0 && frame != nullptr && packet != nullptr) {
+        frame->format = AV_PIX_FMT_YUV420P;
+        frame->width = WIDTH;
+        frame->height = HEIGHT;
+        uint32_t seed = 1;
+        bool ok = av_frame_get_buffer(frame, 0) == 0;
+        for (int32_t i = 0; ok && i <= FRAME_COUNT; i++) {
+            if (i < FRAME_COUNT) {
+                ok = av_frame_make_writable(frame) == 0;
+                FillPicture(frame, i, seed);
+                frame->pts = i;
+            }
+            ok = ok && avcodec_send_frame(context, i < FRAME_COUNT ? frame : nullptr) == 0;
+            while (ok && avcodec_receive_packet(context, packet) == 0) {
+                frames.push_back({std::vector<uint8_t>(packet->data, packet->data + packet->size),
+                                  packet->pts * FRAME_DURATION});
+                av_packet_unref(packet);
+            }
+        }
+    }
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+    return frames;
+}
+
+class DecodeCallback : public DataCallback {
+public:
+    DecodeCallback(CodecPlugin& plugin, int64_t renderFrom) : plugin_(plugin), renderFrom_(renderFrom)
+    {
+    }
+
+    void OnInputBufferDone(const std::shared_ptr<Buffer>& input) override
+    {
+    }
+
+    void OnOutputBufferDone(const std::shared_ptr<Buffer>& output) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (output->flag & BUFFER_FLAG_EOS) {
+            eos_ = true;
+            cond_.notify_all();
+            return;
+        }
+        pts.push_back(output->pts);
+        if (firstRenderUs < 0 && output->pts >= renderFrom_) {
+            firstRenderUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        output->GetMemory()->Reset();
+        (void)plugin_.QueueOutputBuffer(output, 0);
+    }
+
+    bool WaitEos()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::seconds(DECODE_TIMEOUT_S), [this] { return eos_; });
+    }
+
+    std::chrono::steady_clock::time_point start;
+    std::vector<int64_t> pts;
+    int64_t firstRenderUs {-1};
+
+private:
+    CodecPlugin& plugin_;
+    int64_t renderFrom_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool eos_ {false};
+};
+
+struct DecodeResult {
+    std::vector<int64_t> pts;
+    int64_t firstRenderUs {-1}; // from the first input to the first output at or after the render start
+    bool targetCleared {false};
+};
+
+// decodes the gop like after a seek to its start, the frames before renderFrom are not rendered
+DecodeResult Decode(const std::vector<EncodedFrame>& frames, int64_t seekTarget, int64_t renderFrom)
+{
+    DecodeResult result;
+    auto plugin = std::make_shared<VideoFfmpegDecoderPlugin>("videodecoder_h264");
+    DecodeCallback callback(*plugin, renderFrom);
+    if (plugin->Init() != Status::OK) {
+        return result;
+    }
+    (void)plugin->SetParameter(Tag::VIDEO_WIDTH, static_cast<uint32_t>(WIDTH));
+    (void)plugin->SetParameter(Tag::VIDEO_HEIGHT, static_cast<uint32_t>(HEIGHT));
+    (void)plugin->SetParameter(Tag::VIDEO_PIXEL_FORMAT, VideoPixelFormat::YUV420P);
+    (void)plugin->SetDataCallback(&callback);
+    if (seekTarget != HST_TIME_NONE) {
+        (void)plugin->SetParameter(Tag::MEDIA_SEEK_TARGET, seekTarget);
+    }
+    if (plugin->Prepare() != Status::OK || plugin->Start() != Status::OK) {
+        return result;
+    }
+    for (int32_t i = 0; i < OUT_BUFFER_CNT; i++) {
+        (void)plugin->QueueOutputBuffer(Buffer::CreateDefaultBuffer(BufferMetaType::VIDEO, FRAME_SIZE), 0);
+    }
+    callback.start = std::chrono::steady_clock::now();
+    auto deadline = callback.start + std::chrono::seconds(DECODE_TIMEOUT_S);
+    for (const auto& frame : frames) {
+        auto input = Buffer::CreateDefaultBuffer(BufferMetaType::VIDEO, frame.data.size());
+        input->GetMemory()->Write(frame.data.data(), frame.data.size());
+        input->pts = frame.pts;
+        // the decoder refuses input until the task has taken its frames
+        while (plugin->QueueInputBuffer(input, 0) == Status::ERROR_NO_MEMORY &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+    auto eos = std::make_shared<Buffer>(BufferMetaType::VIDEO);
+    eos->flag |= BUFFER_FLAG_EOS;
+    (void)plugin->QueueInputBuffer(eos, 0);
+    if (callback.WaitEos()) {
+        ValueType value;
+        result.targetCleared = plugin->GetParameter(Tag::MEDIA_SEEK_TARGET, value) != Status::OK;
+    }
+    (void)plugin->Stop();
+    (void)plugin->Deinit();
+    result.pts = callback.pts;
+    result.firstRenderUs = callback.firstRenderUs;
+    return result;
+}
+
+int64_t FastestFirstRenderUs(const std::vector<EncodedFrame>& frames, int64_t seekTarget, int64_t renderFrom)
+{
+    int64_t fastest = INT64_MAX;
+    for (int32_t i = 0; i < ROUNDS; i++) {
+        auto result = Decode(frames, seekTarget, renderFrom);
+        if (result.firstRenderUs >= 0) {
+            fastest = std::min(fastest, result.firstRenderUs);
+        }
+    }
+    return fastest;
+}
+} // namespace
+
 HWTEST(VideoFfmpegDecoderPluginTest, test_State, TestSize.Level1)
 {
     std::shared_ptr<CodecPlugin> videoDecoderPlugin = VideoFfmpegDecoderCreator("VideoFfmpegDecoderPluginTest");
@@ -67,6 +270,58 @@ HWTEST(VideoFfmpegDecoderPluginTest, test_Parameter, TestSize.Level1)
     ASSERT_TRUE(prepareStatus == Status::OK);
 }
 
+HWTEST(VideoFfmpegDecoderPluginTest, test_SeekTarget, TestSize.Level1)
+{
+    std::shared_ptr<CodecPlugin> videoDecoderPlugin = VideoFfmpegDecoderCreator("VideoFfmpegDecoderPluginTest");
+    ASSERT_TRUE(videoDecoderPlugin != nullptr);
+
+    int64_t seekTarget = 2 * HST_SECOND; // 2: any time after the gop start
+    ASSERT_EQ(Status::OK, videoDecoderPlugin->SetParameter(Tag::MEDIA_SEEK_TARGET, seekTarget));
+    ValueType parameterValue;
+    ASSERT_EQ(Status::OK, videoDecoderPlugin->GetParameter(Tag::MEDIA_SEEK_TARGET, parameterValue));
+    ASSERT_EQ(seekTarget, AnyCast<int64_t>(parameterValue));
+
+    // not an accurate seek any more
+    ASSERT_EQ(Status::OK, videoDecoderPlugin->SetParameter(Tag::MEDIA_SEEK_TARGET, HST_TIME_NONE));
+    ASSERT_EQ(Status::ERROR_INVALID_PARAMETER, videoDecoderPlugin->GetParameter(Tag::MEDIA_SEEK_TARGET,
+                                                                                parameterValue));
+}
+
+HWTEST(VideoFfmpegDecoderPluginTest, test_SeekTargetDecode, TestSize.Level1)
+{
+    auto decoders = PluginManager::Instance().ListPlugins(PluginType::VIDEO_DECODER);
+    if (std::find(decoders.begin(), decoders.end(), "videodecoder_h264") == decoders.end()) {
+        GTEST_SKIP() << "no ffmpeg h264 decoder";
+    }
+    auto frames = EncodeGop();
+    if (frames.empty()) {
+        GTEST_SKIP() << "no h264 encoder to make the stream";
+    }
+    ASSERT_EQ(static_cast<size_t>(FRAME_COUNT), frames.size());
+    int64_t target = TARGET_FRAME * FRAME_DURATION;
+
+    // SEEK_CLOSEST: nothing before the target is output, and the target is forgotten once reached
+    auto closest = Decode(frames, target, target);
+    ASSERT_EQ(static_cast<size_t>(FRAME_COUNT - TARGET_FRAME), closest.pts.size());
+    EXPECT_EQ(target, closest.pts.front());
+    EXPECT_TRUE(std::all_of(closest.pts.begin(), closest.pts.end(), [target](int64_t pts) { return pts >= target; }));
+    EXPECT_TRUE(closest.targetCleared);
+
+    // SEEK_PREVIOUS_SYNC: every frame from the key frame on is output
+    auto previousSync = Decode(frames, HST_TIME_NONE, 0);
+    ASSERT_EQ(static_cast<size_t>(FRAME_COUNT), previousSync.pts.size());
+    EXPECT_EQ(0, previousSync.pts.front());
+
+    // the same first frame through a decoder which can't skip: all is decoded and output, the sink drops it
+    int64_t previousSyncUs = FastestFirstRenderUs(frames, HST_TIME_NONE, 0);
+    int64_t closestUs = FastestFirstRenderUs(frames, target, target);
+    int64_t sinkDropUs = FastestFirstRenderUs(frames, HST_TIME_NONE, target);
+    std::cout << "first frame after a seek, SEEK_PREVIOUS_SYNC: " << previousSyncUs << " us, SEEK_CLOSEST: " <<
+        closestUs << " us, SEEK_CLOSEST dropped in the sink: " << sinkDropUs << " us" << std::endl;
+    // skip_frame leaves the b frames before the target undecoded, and the reference frames are not copied
+    EXPECT_LT(closestUs, sinkDropUs);
+}
+
 HWTEST(VideoFfmpegDecoderPluginTest, test_QueueInputBuffer, TestSize.Level1)
 {
     std::shared_ptr<CodecPlugin> videoDecoderPlugin = VideoFfmpegDecoderCreator("VideoFfmpegDecoderPluginTest");
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "gtest/gtest.h"
+#include "scene/common/frame_fetcher.h"
+
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "/data/test/media"
+#endif
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace Plugin;
+namespace {
+const std::string VIDEO_FILE = RESOURCE_DIR "/MP4/MPEG2_MP3.mp4";
+const std::string AUDIO_FILE = RESOURCE_DIR "/MP3/MP3_48000_32_SHORT.mp3";
+constexpr uint32_t THUMBNAIL_WIDTH = 160;
+
+// the resources of test/resources, pushed to RESOURCE_DIR by ohos_test.xml
+bool HasResource(const std::string& path)
+{
+    return std::ifstream(path).is_open();
+}
+} // namespace
+
+HWTEST(TestFrameFetcher, frame_capacity_covers_aligned_rows, TestSize.Level1)
+{
+    EXPECT_EQ(64u * 90 * 4, FrameFetcher::GetFrameCapacity(16, 90, VideoPixelFormat::RGBA)); // 64: one aligned row
+    EXPECT_GE(FrameFetcher::GetFrameCapacity(161, 91, VideoPixelFormat::YUV420P), 161u * 91 * 3 / 2); // 3 2: 12 bpp
+    EXPECT_GE(FrameFetcher::GetFrameCapacity(161, 91, VideoPixelFormat::NV12), 161u * 91 * 3 / 2);    // 3 2: 12 bpp
+    EXPECT_EQ(0u, FrameFetcher::GetFrameCapacity(160, 90, VideoPixelFormat::UNKNOWN));
+}
+
+HWTEST(TestFrameFetcher, fetch_downscaled_sync_frames, TestSize.Level1)
+{
+    if (!HasResource(VIDEO_FILE)) {
+        GTEST_SKIP() << "missing resource " << VIDEO_FILE;
+    }
+    FrameFetcher fetcher;
+    FrameFetchOptions options;
+    options.width = THUMBNAIL_WIDTH;
+    std::vector<uint8_t> memory(FrameFetcher::GetFrameCapacity(THUMBNAIL_WIDTH, THUMBNAIL_WIDTH * 4, // 4: any height
+                                                               options.pixelFormat));
+    for (int64_t timeMs : {0, 1000, 3000}) { // 1000 3000: later sync frames
+        options.timeMs = timeMs;
+        FetchedFrame frame;
+        ASSERT_EQ(ErrorCode::SUCCESS, fetcher.FetchFrame(VIDEO_FILE, options, memory.data(), memory.size(), frame));
+        EXPECT_EQ(THUMBNAIL_WIDTH, frame.width);
+        EXPECT_GT(frame.height, 0u);
+        EXPECT_EQ(VideoPixelFormat::RGBA, frame.pixelFormat);
+        ASSERT_FALSE(frame.stride.empty());
+        EXPECT_GE(frame.stride[0], THUMBNAIL_WIDTH * 4); // 4: bytes per rgba pixel
+        EXPECT_EQ(static_cast<size_t>(frame.stride[0]) * frame.height, frame.size);
+        EXPECT_LE(frame.ptsMs, timeMs);
+    }
+
+    // too small a buffer fails without writing past it
+    std::vector<uint8_t> small(16, 0); // 16: far less than a frame
+    FetchedFrame frame;
+    options.timeMs = 0;
+    EXPECT_NE(ErrorCode::SUCCESS, fetcher.FetchFrame(VIDEO_FILE, options, small.data(), small.size(), frame));
+    if (HasResource(AUDIO_FILE)) {
+        EXPECT_EQ(ErrorCode::ERROR_UNSUPPORTED_FORMAT,
+                  fetcher.FetchFrame(AUDIO_FILE, options, memory.data(), memory.size(), frame));
+    }
+    // the pooled plugins still work after failures
+    EXPECT_EQ(ErrorCode::SUCCESS, fetcher.FetchFrame(VIDEO_FILE, options, memory.data(), memory.size(), frame));
+}
+
+HWTEST(TestFrameFetcher, benchmark_pooled_plugins, TestSize.Level1)
+{
+    if (!HasResource(VIDEO_FILE)) {
+        GTEST_SKIP() << "missing resource " << VIDEO_FILE;
+    }
+    constexpr int32_t files = 20;
+    FrameFetchOptions options;
+    options.width = THUMBNAIL_WIDTH;
+    std::vector<uint8_t> memory(FrameFetcher::GetFrameCapacity(THUMBNAIL_WIDTH, THUMBNAIL_WIDTH * 4, // 4: any height
+                                                               options.pixelFormat));
+    FetchedFrame frame;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < files; i++) {
+        FrameFetcher fetcher;
+        ASSERT_EQ(ErrorCode::SUCCESS, fetcher.FetchFrame(VIDEO_FILE, options, memory.data(), memory.size(), frame));
+    }
+    auto fresh = std::chrono::steady_clock::now() - start;
+
+    FrameFetcher fetcher;
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < files; i++) {
+        ASSERT_EQ(ErrorCode::SUCCESS, fetcher.FetchFrame(VIDEO_FILE, options, memory.data(), memory.size(), frame));
+    }
+    auto pooled = std::chrono::steady_clock::now() - start;
+    using Ms = std::chrono::duration<double, std::milli>;
+    std::cout << "thumbnails/sec, plugins per file: " << files * 1000 / Ms(fresh).count() // 1000: ms per second
+              << ", pooled plugins: " << files * 1000 / Ms(pooled).count() << std::endl;  // 1000: ms per second
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
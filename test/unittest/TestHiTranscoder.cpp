@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef RECORDER_SUPPORT
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "foundation/utils/constants.h"
+#include "scene/transcoder/hitranscoder_impl.h"
+#ifdef VIDEO_SUPPORT
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/opt.h"
+#ifdef __cplusplus
+};
+#endif
+#endif
+
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "/data/test/media"
+#endif
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace Transcode;
+namespace {
+const std::string AAC_FILE = RESOURCE_DIR "/M4A/MPEG-4_48000_32_SHORT.m4a";
+const std::string MP3_FILE = RESOURCE_DIR "/MP3/MP3_48000_32_SHORT.mp3";
+const std::string MP4_FILE = RESOURCE_DIR "/MP4/h264_aac_128x72_30r_voiced.mp4";
+const std::string OUTPUT_FILE = "/data/test/transcoded.mp4";
+const std::string TS_OUTPUT_FILE = "/data/test/remuxed.ts";
+constexpr size_t TS_PACKET_SIZE = 188;
+constexpr char TS_SYNC_BYTE = 0x47;
+constexpr int32_t COMPLETION_TIMEOUT_MS = 120000; // 120000: a decode and encode round trip of the large file
+
+// the resources of test/resources, pushed to RESOURCE_DIR by ohos_test.xml
+bool HasResource(const std::string& path)
+{
+    return std::ifstream(path).is_open();
+}
+
+std::streamoff GetFileSize(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file.is_open() ? static_cast<std::streamoff>(file.tellg()) : 0;
+}
+
+const StageStats* FindStage(const std::vector<StageStats>& stats, const std::string& prefix)
+{
+    for (const auto& stage : stats) {
+        if (stage.name.compare(0, prefix.size(), prefix) == 0) {
+            return &stage;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Plugin::Meta> AacEncoderMeta()
+{
+    auto encoderMeta = std::make_shared<Plugin::Meta>();
+    encoderMeta->Set<Plugin::Tag::MIME>(MEDIA_MIME_AUDIO_AAC);
+    encoderMeta->Set<Plugin::Tag::AUDIO_AAC_PROFILE>(Plugin::AudioAacProfile::LC);
+    return encoderMeta;
+}
+
+std::vector<StageStats> Transcode(const std::string& uri, const std::shared_ptr<Plugin::Meta>& audioEncoder,
+                                  const std::string& output = OUTPUT_FILE,
+                                  const std::string& containerMime = MEDIA_MIME_CONTAINER_MP4, bool forceEncode = false,
+                                  const std::shared_ptr<Plugin::Meta>& videoEncoder = nullptr)
+{
+    HiTranscoderImpl transcoder;
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.Init());
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.SetSource(uri));
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.SetOutput(output, containerMime));
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.SetAudioEncoder(audioEncoder));
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.SetVideoEncoder(videoEncoder));
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.SetForceEncode(forceEncode));
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.Prepare());
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.Start());
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.WaitForCompletion(COMPLETION_TIMEOUT_MS));
+    EXPECT_EQ(ErrorCode::SUCCESS, transcoder.Stop());
+    auto stats = transcoder.GetStageStats();
+    for (const auto& stage : stats) {
+        std::cout << stage.name << ": " << stage.buffers << " buffers, " << stage.bytes << " bytes, "
+                  << stage.buffersPerSecond << " buffers/s, " << stage.pushTimeMs << " ms in push" << std::endl;
+    }
+    return stats;
+}
+
+#ifdef VIDEO_SUPPORT
+const std::string H264_FILE = "/data/test/h264_source.mp4";
+const std::string LARGE_H264_FILE = "/data/test/h264_large_source.mp4";
+constexpr int32_t FPS = 30;
+constexpr int64_t TIME_TOLERANCE_US = 1000; // 1000: 1 ms, a tick of the coarsest time base on the way
+
+struct H264Spec {
+    int32_t width;
+    int32_t height;
+    int32_t frames;
+    int64_t bitRate;
+};
+constexpr H264Spec SMALL_SPEC {320, 240, 90, 1000000};        // 90: 3 gops, 1000000: 1 Mbps
+constexpr H264Spec LARGE_SPEC {640, 360, 20 * FPS, 20000000}; // 20: s, 20000000: 20 Mbps, about 50 MB
+
+struct VideoPacket {
+    int64_t ptsUs;
+    int64_t dtsUs;
+    bool key;
+    std::vector<uint8_t> head; // first bytes, a start code in annex-b, a nal length in avcc
+};
+
+struct VideoTrack {
+    std::vector<VideoPacket> packets;
+    std::vector<uint8_t> extradata;
+};
+
+std::shared_ptr<Plugin::Meta> H264EncoderMeta()
+{
+    auto encoderMeta = std::make_shared<Plugin::Meta>();
+    encoderMeta->Set<Plugin::Tag::MIME>(MEDIA_MIME_VIDEO_H264);
+    encoderMeta->Set<Plugin::Tag::VIDEO_H264_PROFILE>(Plugin::VideoH264Profile::BASELINE);
+    encoderMeta->Set<Plugin::Tag::VIDEO_H264_LEVEL>(32); // 32: level 3.2
+    return encoderMeta;
+}
+
+void FillPicture(AVFrame* frame, int32_t index, uint32_t& seed)
+{
+    for (int32_t plane = 0; plane < 3; plane++) { // 3: y, u, v
+        int32_t shift = plane == 0 ? 0 : 1;
+        for (int32_t y = 0; y < (frame->height >> shift); y++) {
+            uint8_t* row = frame->data[plane] + y * frame->linesize[plane];
+            for (int32_t x = 0; x < (frame->width >> shift); x++) {
+                seed = seed * 1103515245 + 12345; // 1103515245, 12345: lcg, noise keeps the bit rate up
+                row[x] = static_cast<uint8_t>(x + y + index * 4 + ((seed >> 24) & 0x1f)); // 4: moving, 24: top bits
+            }
+        }
+    }
+}
+
+bool EncodeFrames(AVCodecContext* encoder, AVFormatContext* output, const H264Spec& spec)
+{
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    bool ok = frame != nullptr && packet != nullptr;
+    if (ok) {
+        frame->format = AV_PIX_FMT_YUV420P;
+        frame->width = spec.width;
+        frame->height = spec.height;
+        ok = av_frame_get_buffer(frame, 0) == 0;
+    }
+    uint32_t seed = 1;
+    for (int32_t i = 0; ok && i <= spec.frames; i++) {
+        if (i < spec.frames) {
+            ok = av_frame_make_writable(frame) == 0;
+            FillPicture(frame, i, seed);
+            frame->pts = i;
+        }
+        ok = ok && avcodec_send_frame(encoder, i < spec.frames ? frame : nullptr) == 0;
+        while (ok && avcodec_receive_packet(encoder, packet) == 0) {
+            av_packet_rescale_ts(packet, encoder->time_base, output->streams[0]->time_base);
+            packet->stream_index = 0;
+            ok = av_interleaved_write_frame(output, packet) == 0;
+        }
+    }
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    return ok;
+}
+
+// an mp4 with one h264 track with b frames, made by ffmpeg itself, false if it has no h264 encoder
+bool WriteH264File(const std::string& path, const H264Spec& spec)
+{
+    auto codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    AVFormatContext* output = nullptr;
+    if (codec == nullptr || avformat_alloc_output_context2(&output, nullptr, nullptr, path.c_str()) < 0) {
+        return false;
+    }
+    AVCodecContext* encoder = avcodec_alloc_context3(codec);
+    AVStream* stream = avformat_new_stream(output, nullptr);
+    bool ok = encoder != nullptr && stream != nullptr;
+    if (ok) {
+        encoder->width = spec.width;
+        encoder->height = spec.height;
+        encoder->pix_fmt = AV_PIX_FMT_YUV420P;
+        encoder->time_base = {1, FPS};
+        encoder->framerate = {FPS, 1};
+        encoder->gop_size = FPS;
+        encoder->max_b_frames = 2; // 2: pts and dts differ
+        encoder->bit_rate = spec.bitRate;
+        encoder->flags |= (output->oformat->flags & AVFMT_GLOBALHEADER) ? AV_CODEC_FLAG_GLOBAL_HEADER : 0;
+        (void)av_opt_set(encoder->priv_data, "preset", "veryfast", 0);
+        ok = avcodec_open2(encoder, codec, nullptr) == 0 &&
+            avcodec_parameters_from_context(stream->codecpar, encoder) >= 0;
+    }
+    if (ok) {
+        stream->time_base = {1, 90000}; // 90000: the clock of mpeg-ts, so no rounding on the way
+        ok = avio_open(&output->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0 && avformat_write_header(output, nullptr) >= 0;
+    }
+    ok = ok && EncodeFrames(encoder, output, spec) && av_write_trailer(output) == 0;
+    if (output->pb != nullptr) {
+        (void)avio_closep(&output->pb);
+    }
+    avcodec_free_context(&encoder);
+    avformat_free_context(output);
+    if (!ok) {
+        (void)std::remove(path.c_str());
+    }
+    return ok;
+}
+
+int32_t FindH264Stream(AVFormatContext* context)
+{
+    if (avformat_find_stream_info(context, nullptr) < 0) {
+        return -1;
+    }
+    int32_t index = av_find_best_stream(context, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    return (index >= 0 && context->streams[index]->codecpar->codec_id == AV_CODEC_ID_H264) ? index : -1;
+}
+
+// the h264 track of a file as ffmpeg demuxes it
+bool ReadH264Track(const std::string& path, VideoTrack& track)
+{
+    AVFormatContext* context = nullptr;
+    if (avformat_open_input(&context, path.c_str(), nullptr, nullptr) != 0) {
+        return false;
+    }
+    int32_t index = FindH264Stream(context);
+    AVPacket* packet = av_packet_alloc();
+    bool ok = index >= 0 && packet != nullptr;
+    while (ok && av_read_frame(context, packet) == 0) {
+        if (packet->stream_index == index) {
+            auto timeBase = context->streams[index]->time_base;
+            track.packets.push_back({av_rescale_q(packet->pts, timeBase, {1, 1000000}), // 1000000: us
+                                     av_rescale_q(packet->dts, timeBase, {1, 1000000}), // 1000000: us
+                                     (packet->flags & AV_PKT_FLAG_KEY) != 0,
+                                     std::vector<uint8_t>(packet->data, packet->data + std::min(packet->size, 4))});
+        }
+        av_packet_unref(packet);
+    }
+    if (ok) {
+        auto codecpar = context->streams[index]->codecpar;
+        track.extradata.assign(codecpar->extradata, codecpar->extradata + codecpar->extradata_size);
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&context);
+    return ok;
+}
+
+bool ReceiveFrames(AVCodecContext* decoder, AVFrame* frame, int32_t& frames)
+{
+    int ret = 0;
+    while ((ret = avcodec_receive_frame(decoder, frame)) == 0) {
+        frames++;
+    }
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+}
+
+// frames decoded from the h264 track of a file, -1 on any decoding error
+int32_t DecodeH264Track(const std::string& path)
+{
+    AVFormatContext* context = nullptr;
+    if (avformat_open_input(&context, path.c_str(), nullptr, nullptr) != 0) {
+        return -1;
+    }
+    int32_t index = FindH264Stream(context);
+    auto codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+    AVCodecContext* decoder = codec == nullptr ? nullptr : avcodec_alloc_context3(codec);
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    bool ok = index >= 0 && decoder != nullptr && packet != nullptr && frame != nullptr &&
+        avcodec_parameters_to_context(decoder, context->streams[index]->codecpar) >= 0;
+    if (ok) {
+        decoder->err_recognition |= AV_EF_EXPLODE;
+        ok = avcodec_open2(decoder, codec, nullptr) == 0;
+    }
+    int32_t frames = 0;
+    while (ok && av_read_frame(context, packet) == 0) {
+        if (packet->stream_index == index) {
+            ok = avcodec_send_packet(decoder, packet) == 0 && ReceiveFrames(decoder, frame, frames);
+        }
+        av_packet_unref(packet);
+    }
+    ok = ok && avcodec_send_packet(decoder, nullptr) == 0 && ReceiveFrames(decoder, frame, frames);
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&decoder);
+    avformat_close_input(&context);
+    return ok ? frames : -1;
+}
+
+// same timing relative to the first dts, containers may shift all timestamps, and same sync frames
+void ExpectSamePackets(const VideoTrack& expected, const VideoTrack& actual)
+{
+    ASSERT_FALSE(expected.packets.empty());
+    ASSERT_EQ(expected.packets.size(), actual.packets.size());
+    int64_t expectedStart = expected.packets.front().dtsUs;
+    int64_t actualStart = actual.packets.front().dtsUs;
+    for (size_t i = 0; i < expected.packets.size(); i++) {
+        const auto& left = expected.packets[i];
+        const auto& right = actual.packets[i];
+        EXPECT_LE(std::llabs((left.ptsUs - expectedStart) - (right.ptsUs - actualStart)), TIME_TOLERANCE_US)
+            << "pts of packet " << i;
+        EXPECT_LE(std::llabs((left.dtsUs - expectedStart) - (right.dtsUs - actualStart)), TIME_TOLERANCE_US)
+            << "dts of packet " << i;
+        EXPECT_EQ(left.key, right.key) << "key flag of packet " << i;
+    }
+}
+
+bool IsAnnexB(const std::vector<uint8_t>& head)
+{
+    return head.size() >= 3 && head[0] == 0 && head[1] == 0 && // 3: shortest start code
+        (head[2] == 1 || (head.size() >= 4 && head[2] == 0 && head[3] == 1)); // 2 3 4: 00 00 01 or 00 00 00 01
+}
+#endif
+} // namespace
+
+HWTEST(TestHiTranscoder, remux_without_encoder_passes_tracks_through, TestSize.Level1)
+{
+    if (!HasResource(AAC_FILE)) {
+        GTEST_SKIP() << "missing resource " << AAC_FILE;
+    }
+    auto stats = Transcode(AAC_FILE, nullptr);
+    EXPECT_GT(GetFileSize(OUTPUT_FILE), 0);
+    auto muxer = FindStage(stats, "muxer.default0");
+    ASSERT_NE(nullptr, muxer);
+    EXPECT_GT(muxer->buffers, 0u);
+    EXPECT_EQ(nullptr, FindStage(stats, "audiodecoder"));
+    EXPECT_EQ(nullptr, FindStage(stats, "audioencoder"));
+}
+
+HWTEST(TestHiTranscoder, transcode_mp3_to_aac, TestSize.Level1)
+{
+    if (!HasResource(MP3_FILE)) {
+        GTEST_SKIP() << "missing resource " << MP3_FILE;
+    }
+    auto stats = Transcode(MP3_FILE, AacEncoderMeta());
+    EXPECT_GT(GetFileSize(OUTPUT_FILE), 0);
+    auto decoder = FindStage(stats, "audiodecoder");
+    auto encoder = FindStage(stats, "audioencoder");
+    ASSERT_NE(nullptr, decoder);
+    ASSERT_NE(nullptr, encoder);
+    EXPECT_GT(decoder->buffers, 0u);
+    EXPECT_GT(encoder->buffers, 0u);
+    // decoded samples take more bytes than the mp3 frames they came from
+    EXPECT_GT(encoder->bytes, decoder->bytes);
+    auto muxer = FindStage(stats, "muxer.default0");
+    ASSERT_NE(nullptr, muxer);
+    EXPECT_GT(muxer->buffers, 0u);
+}
+
+HWTEST(TestHiTranscoder, remux_mp4_to_mpegts, TestSize.Level1)
+{
+    if (!HasResource(MP4_FILE)) {
+        GTEST_SKIP() << "missing resource " << MP4_FILE;
+    }
+    // an aac encoder of the codec of the track keeps it remuxed
+    auto stats = Transcode(MP4_FILE, AacEncoderMeta(), TS_OUTPUT_FILE, MEDIA_MIME_CONTAINER_MPEGTS);
+    EXPECT_EQ(nullptr, FindStage(stats, "audiodecoder"));
+    EXPECT_EQ(nullptr, FindStage(stats, "videodecoder"));
+    auto size = GetFileSize(TS_OUTPUT_FILE);
+    ASSERT_GT(size, 0);
+    EXPECT_EQ(0, size % static_cast<std::streamoff>(TS_PACKET_SIZE));
+    std::ifstream file(TS_OUTPUT_FILE, std::ios::binary);
+    std::vector<char> packet(TS_PACKET_SIZE);
+    ASSERT_TRUE(file.read(packet.data(), packet.size()));
+    EXPECT_EQ(TS_SYNC_BYTE, packet[0]);
+}
+
+HWTEST(TestHiTranscoder, benchmark_remux_against_reencode, TestSize.Level1)
+{
+    if (!HasResource(AAC_FILE)) {
+        GTEST_SKIP() << "missing resource " << AAC_FILE;
+    }
+    using Ms = std::chrono::duration<double, std::milli>;
+    auto inputMb = static_cast<double>(GetFileSize(AAC_FILE)) / (1024 * 1024); // 1024: bytes per kb, kb per mb
+    auto start = std::chrono::steady_clock::now();
+    auto stats = Transcode(AAC_FILE, AacEncoderMeta());
+    auto remux = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(nullptr, FindStage(stats, "audioencoder"));
+
+    start = std::chrono::steady_clock::now();
+    stats = Transcode(AAC_FILE, AacEncoderMeta(), OUTPUT_FILE, MEDIA_MIME_CONTAINER_MP4, true);
+    auto reencode = std::chrono::steady_clock::now() - start;
+    EXPECT_NE(nullptr, FindStage(stats, "audioencoder"));
+    std::cout << "MB/s, remux: " << inputMb * 1000 / Ms(remux).count()                 // 1000: ms per second
+              << ", decode and encode: " << inputMb * 1000 / Ms(reencode).count() << std::endl; // 1000: ms per second
+}
+
+#ifdef VIDEO_SUPPORT
+HWTEST(TestHiTranscoder, remux_h264_through_mpegts_and_back, TestSize.Level1)
+{
+    if (!WriteH264File(H264_FILE, SMALL_SPEC)) {
+        GTEST_SKIP() << "no h264 encoder to make the media";
+    }
+    VideoTrack source;
+    ASSERT_TRUE(ReadH264Track(H264_FILE, source));
+    ASSERT_EQ(static_cast<size_t>(SMALL_SPEC.frames), source.packets.size());
+
+    // avcc to annex-b: every packet is kept with its timing and sync flag
+    auto stats = Transcode(H264_FILE, nullptr, TS_OUTPUT_FILE, MEDIA_MIME_CONTAINER_MPEGTS, false, H264EncoderMeta());
+    EXPECT_EQ(nullptr, FindStage(stats, "videodecoder"));
+    VideoTrack remuxed;
+    ASSERT_TRUE(ReadH264Track(TS_OUTPUT_FILE, remuxed));
+    ExpectSamePackets(source, remuxed);
+    EXPECT_TRUE(IsAnnexB(remuxed.packets.front().head));
+
+    // annex-b back to avcc: an avc config record and a track every frame of which decodes
+    stats = Transcode(TS_OUTPUT_FILE, nullptr, OUTPUT_FILE, MEDIA_MIME_CONTAINER_MP4, false, H264EncoderMeta());
+    EXPECT_EQ(nullptr, FindStage(stats, "videodecoder"));
+    VideoTrack restored;
+    ASSERT_TRUE(ReadH264Track(OUTPUT_FILE, restored));
+    ExpectSamePackets(source, restored);
+    ASSERT_FALSE(restored.extradata.empty());
+    EXPECT_EQ(1, restored.extradata[0]); // 1: configurationVersion of an AVCDecoderConfigurationRecord
+    EXPECT_FALSE(IsAnnexB(restored.packets.front().head));
+    EXPECT_EQ(SMALL_SPEC.frames, DecodeH264Track(OUTPUT_FILE));
+}
+
+HWTEST(TestHiTranscoder, benchmark_video_remux_against_reencode, TestSize.Level1)
+{
+    if (!WriteH264File(LARGE_H264_FILE, LARGE_SPEC)) {
+        GTEST_SKIP() << "no h264 encoder to make the media";
+    }
+    using Seconds = std::chrono::duration<double>;
+    auto inputBytes = GetFileSize(LARGE_H264_FILE);
+    auto start = std::chrono::steady_clock::now();
+    auto stats = Transcode(LARGE_H264_FILE, nullptr, OUTPUT_FILE, MEDIA_MIME_CONTAINER_MP4, false, H264EncoderMeta());
+    auto remux = Seconds(std::chrono::steady_clock::now() - start).count();
+    auto remuxBytes = inputBytes + GetFileSize(OUTPUT_FILE);
+    EXPECT_EQ(nullptr, FindStage(stats, "videoencoder"));
+
+    start = std::chrono::steady_clock::now();
+    stats = Transcode(LARGE_H264_FILE, nullptr, OUTPUT_FILE, MEDIA_MIME_CONTAINER_MP4, true, H264EncoderMeta());
+    auto reencode = Seconds(std::chrono::steady_clock::now() - start).count();
+    auto reencodeBytes = inputBytes + GetFileSize(OUTPUT_FILE);
+    EXPECT_NE(nullptr, FindStage(stats, "videodecoder"));
+    EXPECT_NE(nullptr, FindStage(stats, "videoencoder"));
+    (void)std::remove(LARGE_H264_FILE.c_str());
+
+    constexpr double mb = 1024 * 1024; // 1024: bytes per kb, kb per mb
+    std::cout << inputBytes / mb << " MB of video, disk MB/s read and written, remux: " << remuxBytes / mb / remux
+              << " in " << remux << " s, decode and encode: " << reencodeBytes / mb / reencode << " in " << reencode
+              << " s" << std::endl;
+    EXPECT_LT(remux, reencode);
+}
+#endif
+
+HWTEST(TestHiTranscoder, start_before_prepare_fails, TestSize.Level1)
+{
+    HiTranscoderImpl transcoder;
+    ASSERT_EQ(ErrorCode::SUCCESS, transcoder.Init());
+    EXPECT_EQ(ErrorCode::ERROR_INVALID_OPERATION, transcoder.Start());
+    EXPECT_EQ(ErrorCode::ERROR_INVALID_OPERATION, transcoder.Prepare());
+    EXPECT_EQ(ErrorCode::ERROR_INVALID_OPERATION, transcoder.WaitForCompletion(0));
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
+#endif
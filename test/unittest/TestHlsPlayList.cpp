@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "gtest/gtest.h"
+#include "plugin/plugins/source/http_source/hls/m3u8.h"
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace OHOS::Media::Plugin::HttpPlugin;
+using namespace testing::ext;
+
+namespace {
+const std::string PLAYLIST_URI = "http://127.0.0.1/live/index.m3u8";
+constexpr int TARGET_DURATION = 2; // 2: seconds, a typical low latency live stream
+constexpr int64_t MS_PER_SECOND = 1000;
+
+// stand-in for a live server: fragment n is published at n * target duration, the last count ones are listed
+std::string MakePlayList(uint64_t first, uint64_t count, bool ended = false)
+{
+    std::string playList = "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:" + std::to_string(TARGET_DURATION) +
+        "\n#EXT-X-MEDIA-SEQUENCE:" + std::to_string(first) + "\n";
+    for (uint64_t i = first; i < first + count; i++) {
+        playList += "#EXTINF:" + std::to_string(TARGET_DURATION) + ".000,\nfragment_" + std::to_string(i) + ".ts\n";
+    }
+    if (ended) {
+        playList += "#EXT-X-ENDLIST\n";
+    }
+    return playList;
+}
+
+std::string PlayListAt(int64_t timeMs, uint64_t window)
+{
+    uint64_t published = static_cast<uint64_t>(timeMs / (TARGET_DURATION * MS_PER_SECOND)) + 1;
+    uint64_t first = published > window ? published - window : 0;
+    return MakePlayList(first, published - first);
+}
+
+// average time between the publication of a fragment and the reload which finds it
+int64_t MeasureLiveEdgeLatency(bool targetDurationPolling, int64_t startMs)
+{
+    constexpr int64_t fixedIntervalMs = 5000; // 5000: the former fixed reload interval
+    constexpr int64_t durationMs = 120 * MS_PER_SECOND; // 120: seconds of playback
+    M3U8 m3u8(PLAYLIST_URI, "");
+    int64_t latency = 0;
+    int64_t found = 0;
+    for (int64_t now = startMs; now < startMs + durationMs;) {
+        auto playList = PlayListAt(now, 6); // 6: fragments in the window
+        m3u8.Update(playList);
+        if (now != startMs) {
+            auto it = m3u8.files_.end();
+            for (uint32_t i = 0; i < m3u8.newFragments_; i++) {
+                --it;
+                latency += now - static_cast<int64_t>((*it)->sequence_) * TARGET_DURATION * MS_PER_SECOND;
+                found++;
+            }
+        }
+        now += targetDurationPolling ? m3u8.GetReloadInterval() : fixedIntervalMs;
+    }
+    return found == 0 ? 0 : latency / found;
+}
+}
+
+HWTEST(HlsPlayListTest, live_playlist_is_updated_incrementally, TestSize.Level1)
+{
+    M3U8 m3u8(PLAYLIST_URI, "");
+    auto playList = MakePlayList(10, 5); // 10: first sequence, 5: fragments
+    ASSERT_TRUE(m3u8.Update(playList));
+    EXPECT_TRUE(m3u8.IsLive());
+    EXPECT_EQ(m3u8.newFragments_, 5u);
+    ASSERT_EQ(m3u8.files_.size(), 5u);
+    EXPECT_EQ(m3u8.files_.front()->sequence_, 10u);
+    EXPECT_EQ(m3u8.files_.front()->uri_, "http://127.0.0.1/live/fragment_10.ts");
+    EXPECT_DOUBLE_EQ(m3u8.files_.front()->duration_, 2.0);
+    EXPECT_EQ(m3u8.GetReloadInterval(), TARGET_DURATION * MS_PER_SECOND);
+    auto firstFragment = m3u8.files_.back();
+
+    playList = MakePlayList(12, 5); // 12: two fragments dropped and two published
+    ASSERT_TRUE(m3u8.Update(playList));
+    EXPECT_EQ(m3u8.newFragments_, 2u);
+    ASSERT_EQ(m3u8.files_.size(), 5u);
+    EXPECT_EQ(m3u8.files_.front()->sequence_, 12u);
+    EXPECT_EQ(m3u8.files_.back()->uri_, "http://127.0.0.1/live/fragment_16.ts");
+    EXPECT_EQ(m3u8.files_.back()->sequence_, 16u);
+    auto it = m3u8.files_.begin();
+    std::advance(it, 2); // 2: fragment 14 is kept from the first update
+    EXPECT_EQ(*it, firstFragment);
+
+    ASSERT_TRUE(m3u8.Update(playList));
+    EXPECT_EQ(m3u8.newFragments_, 0u);
+    EXPECT_EQ(m3u8.GetReloadInterval(), TARGET_DURATION * MS_PER_SECOND / 2); // 2: half after an unchanged reload
+
+    playList = MakePlayList(3, 2); // 3: the stream restarted with lower sequence numbers
+    ASSERT_TRUE(m3u8.Update(playList));
+    EXPECT_EQ(m3u8.newFragments_, 2u);
+    ASSERT_EQ(m3u8.files_.size(), 2u);
+    EXPECT_EQ(m3u8.files_.front()->sequence_, 3u);
+
+    playList = MakePlayList(3, 3, true); // 3: one more fragment, then the stream ended
+    ASSERT_TRUE(m3u8.Update(playList));
+    EXPECT_EQ(m3u8.newFragments_, 1u);
+    EXPECT_FALSE(m3u8.IsLive());
+}
+
+HWTEST(HlsPlayListTest, tag_lines_are_parsed_without_copy, TestSize.Level1)
+{
+    std::string text = "#EXTM3U\r\n#EXT-X-KEY:METHOD=AES-128,URI=\"http://k/a,b\",IV=0x0102\r\n# comment\r\n"
+        "#EXT-X-STREAM-INF:BANDWIDTH=1280000,RESOLUTION=1280x720,CODECS=\"avc1.4d401f,mp4a.40.2\"\r\n\r\n"
+        "hd/index.m3u8";
+    std::string_view rest = text;
+    std::string_view line;
+    ASSERT_TRUE(GetNextLine(rest, line));
+    EXPECT_EQ(line, "#EXTM3U");
+    EXPECT_EQ(line.data(), text.data());
+    ASSERT_TRUE(GetNextLine(rest, line));
+    HlsTag type;
+    std::string_view value;
+    ASSERT_TRUE(ParseTagLine(line, type, value));
+    EXPECT_EQ(type, HlsTag::EXTXKEY);
+    EXPECT_EQ(value, "METHOD=AES-128,URI=\"http://k/a,b\",IV=0x0102");
+    auto key = std::static_pointer_cast<AttributesTag>(TagFactory::CreateTag(type, value));
+    EXPECT_EQ(key->GetAttributeByName("URI")->QuotedString(), "http://k/a,b");
+    EXPECT_EQ(key->GetAttributeByName("IV")->HexSequence(), std::vector<uint8_t>({1, 2}));
+    ASSERT_TRUE(GetNextLine(rest, line));
+    EXPECT_FALSE(ParseTagLine(line, type, value));
+
+    auto tags = ParseEntries(text);
+    ASSERT_EQ(tags.size(), 2u);
+    auto streamInf = std::static_pointer_cast<AttributesTag>(tags.back());
+    EXPECT_EQ(streamInf->GetAttributeByName("BANDWIDTH")->Decimal(), 1280000u);
+    EXPECT_EQ(streamInf->GetAttributeByName("RESOLUTION")->GetResolution(), std::make_pair(1280, 720));
+    EXPECT_EQ(streamInf->GetAttributeByName("CODECS")->QuotedString(), "avc1.4d401f,mp4a.40.2");
+    EXPECT_EQ(streamInf->GetAttributeByName("URI")->QuotedString(), "hd/index.m3u8");
+
+    auto extInf = std::static_pointer_cast<ValuesListTag>(TagFactory::CreateTagByName("EXTINF", "9.009,title"));
+    EXPECT_DOUBLE_EQ(extInf->GetAttributeByName("DURATION")->FloatingPoint(), 9.009);
+}
+
+HWTEST(HlsPlayListTest, live_edge_latency_follows_target_duration, TestSize.Level1)
+{
+    constexpr int64_t startMs = 60 * MS_PER_SECOND + 300; // 300: reload phase behind the publication
+    auto fixed = MeasureLiveEdgeLatency(false, startMs);
+    auto polled = MeasureLiveEdgeLatency(true, startMs);
+    std::cout << "live edge latency, fixed 5s reload: " << fixed << "ms, target duration reload: " << polled << "ms"
+              << std::endl;
+    EXPECT_LT(polled, fixed);
+    EXPECT_LE(polled, TARGET_DURATION * MS_PER_SECOND);
+}
+
+HWTEST(HlsPlayListTest, live_reload_parses_new_fragments_only, TestSize.Level1)
+{
+    constexpr uint64_t window = 3000; // 3000: fragments in a long dvr window
+    constexpr int reloads = 50; // 50: reloads measured
+    std::string initial = MakePlayList(0, window);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reloads; i++) {
+        M3U8 m3u8(PLAYLIST_URI, "");
+        m3u8.Update(initial);
+    }
+    auto fullUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count() / reloads;
+
+    M3U8 m3u8(PLAYLIST_URI, "");
+    m3u8.Update(initial);
+    std::vector<std::string> playLists;
+    for (int i = 1; i <= reloads; i++) {
+        playLists.push_back(MakePlayList(i, window));
+    }
+    start = std::chrono::steady_clock::now();
+    for (auto& playList : playLists) {
+        m3u8.Update(playList);
+        ASSERT_EQ(m3u8.newFragments_, 1u);
+    }
+    auto incrementalUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count() / reloads;
+    std::cout << "playlist of " << window << " fragments, full parse: " << fullUs << "us, live reload: "
+              << incrementalUs << "us" << std::endl;
+    EXPECT_EQ(m3u8.files_.size(), window);
+    EXPECT_EQ(m3u8.files_.back()->sequence_, window + reloads - 1);
+    EXPECT_LT(incrementalUs, fullUs);
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "LoopbackHttpServer.h"
+#include "foundation/osal/thread/mutex.h"
+#include "foundation/osal/thread/scoped_lock.h"
+#include "plugin/plugins/source/http_source/download/downloader.h"
+#include "plugin/plugins/source/http_source/download/http_cache.h"
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace OHOS::Media::Plugin::HttpPlugin;
+using namespace testing::ext;
+
+namespace {
+constexpr size_t BLOCK = HttpCache::BLOCK_SIZE;
+const std::string CACHE_DIR = "/data/test/http_cache_ut";
+
+std::vector<uint8_t> MakeData(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = static_cast<uint8_t>(i * 31 + seed); // 31: any pattern which differs between blocks
+    }
+    return data;
+}
+
+struct SeekBackResult {
+    int64_t latencyUs {0};
+    int requests {0};
+    bool dataMatches {false};
+};
+
+// download the whole body, seek back to offset and measure how long the first block takes to come back
+SeekBackResult MeasureSeekBack(LoopbackHttpServer& server, const std::string& path, bool enableCache,
+                               const std::vector<uint8_t>& body, int64_t offset)
+{
+    SeekBackResult result;
+    OSAL::Mutex mutex;
+    std::vector<uint8_t> received;
+    auto saveData = [&](uint8_t* data, uint32_t len) {
+        OSAL::ScopedLock lock(mutex);
+        received.insert(received.end(), data, data + len);
+        return true;
+    };
+    auto receivedSize = [&]() {
+        OSAL::ScopedLock lock(mutex);
+        return received.size();
+    };
+    auto statusCallback = [](DownloadStatus, std::shared_ptr<Downloader>&, std::shared_ptr<DownloadRequest>&) {};
+    auto request = std::make_shared<DownloadRequest>(server.Url(path), saveData, statusCallback);
+    if (enableCache) {
+        request->EnableCache();
+    }
+    Downloader downloader("ut");
+    downloader.Download(request, -1);
+    downloader.Start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10); // 10: s, stand-in timeout
+    while (!request->IsEos() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool complete = receivedSize() == body.size();
+
+    downloader.Pause();
+    {
+        OSAL::ScopedLock lock(mutex);
+        received.clear();
+    }
+    int requestsBefore = server.Requests();
+    auto start = std::chrono::steady_clock::now();
+    downloader.Seek(offset);
+    downloader.Resume();
+    while (receivedSize() < BLOCK && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100)); // 100: us
+    }
+    result.latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    while (!request->IsEos() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    downloader.Stop();
+    result.requests = server.Requests() - requestsBefore;
+    OSAL::ScopedLock lock(mutex);
+    result.dataMatches = complete && std::equal(received.begin(), received.end(), body.begin() + offset) &&
+        received.size() == body.size() - static_cast<size_t>(offset);
+    return result;
+}
+}
+
+class HttpCacheTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        HttpCache::GetInstance().Clear();
+    }
+
+    void TearDown() override
+    {
+        HttpCache::GetInstance().SetLimits(16 * 1024 * 1024, 0); // 16: MB, default memory limit
+        HttpCache::GetInstance().Clear();
+    }
+};
+
+HWTEST_F(HttpCacheTest, blocks_are_evicted_least_recently_used_first, TestSize.Level1)
+{
+    auto& cache = HttpCache::GetInstance();
+    cache.SetLimits(3 * BLOCK, 0); // 3: blocks in memory, no disk
+    cache.Validate("http://host/a", 5 * BLOCK, "\"v1\""); // 5: blocks
+    for (size_t i = 0; i < 3; i++) { // 3: fill the memory
+        cache.PutBlock("http://host/a", i * BLOCK, MakeData(BLOCK, i));
+    }
+    size_t blockOffset = 0;
+    ASSERT_NE(cache.GetBlock("http://host/a", 100, blockOffset), nullptr); // 100: touch block 0
+    EXPECT_EQ(blockOffset, 100u);
+    cache.PutBlock("http://host/a", 3 * BLOCK, MakeData(BLOCK, 3)); // 3: evicts block 1
+    EXPECT_NE(cache.GetBlock("http://host/a", 0, blockOffset), nullptr);
+    EXPECT_EQ(cache.GetBlock("http://host/a", BLOCK, blockOffset), nullptr);
+    auto block = cache.GetBlock("http://host/a", 3 * BLOCK + 1, blockOffset); // 3: last put block
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(*block, MakeData(BLOCK, 3)); // 3: seed of the block
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.hits, 3u);
+    EXPECT_EQ(statistics.misses, 1u);
+    EXPECT_EQ(statistics.bytesSaved, 3 * BLOCK - 100 - 1); // 100, 1: offsets inside the blocks
+    EXPECT_EQ(statistics.memoryBytes, 3 * BLOCK);
+
+    cache.PutBlock("http://host/unknown", 0, MakeData(BLOCK, 0));
+    EXPECT_EQ(cache.GetBlock("http://host/unknown", 0, blockOffset), nullptr);
+}
+
+HWTEST_F(HttpCacheTest, evicted_blocks_move_to_disk, TestSize.Level1)
+{
+    auto& cache = HttpCache::GetInstance();
+    cache.SetLimits(BLOCK, 2 * BLOCK, CACHE_DIR); // 2: blocks on disk
+    cache.Validate("http://host/b", 3 * BLOCK, ""); // 3: blocks
+    for (size_t i = 0; i < 3; i++) { // 3: one in memory, two on disk
+        cache.PutBlock("http://host/b", i * BLOCK, MakeData(BLOCK, i));
+    }
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.memoryBytes, BLOCK);
+    EXPECT_EQ(statistics.diskBytes, 2 * BLOCK);
+    size_t blockOffset = 0;
+    auto block = cache.GetBlock("http://host/b", 0, blockOffset);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(*block, MakeData(BLOCK, 0));
+
+    cache.Validate("http://host/b", 3 * BLOCK, "\"v2\""); // 3: same length, first ETag seen
+    EXPECT_NE(cache.GetBlock("http://host/b", 2 * BLOCK, blockOffset), nullptr); // 2: still on disk
+    cache.Validate("http://host/b", 3 * BLOCK, "\"v3\""); // 3: the resource changed on the server
+    EXPECT_EQ(cache.GetBlock("http://host/b", 2 * BLOCK, blockOffset), nullptr); // 2: dropped with the others
+    statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.memoryBytes, 0u);
+    EXPECT_EQ(statistics.diskBytes, 0u);
+}
+
+HWTEST_F(HttpCacheTest, seek_back_is_served_from_cache, TestSize.Level1)
+{
+    constexpr size_t fileSize = 1024 * 1024 + 1000; // 1000: last block is partial
+    constexpr int latencyMs = 20; // 20: ms, response delay of the stand-in server
+    auto body = MakeData(fileSize, 7); // 7: seed
+    LoopbackHttpServer::Options options;
+    options.body = body;
+    options.eTag = "stand-in";
+    options.responseDelayMs = latencyMs;
+    LoopbackHttpServer server(options);
+    auto network = MeasureSeekBack(server, "/plain.mp4", false, body, BLOCK + 10); // 10: inside the second block
+    auto cached = MeasureSeekBack(server, "/cached.mp4", true, body, BLOCK + 10); // 10: inside the second block
+    auto statistics = HttpCache::GetInstance().GetStatistics();
+    std::cout << "seek back, network: " << network.latencyUs << "us " << network.requests << " requests, cache: "
+              << cached.latencyUs << "us " << cached.requests << " requests, hits " << statistics.hits
+              << ", bytes saved " << statistics.bytesSaved << std::endl;
+    EXPECT_TRUE(network.dataMatches);
+    EXPECT_TRUE(cached.dataMatches);
+    EXPECT_GT(network.requests, 0);
+    EXPECT_EQ(cached.requests, 0);
+    EXPECT_EQ(statistics.bytesSaved, fileSize - BLOCK - 10); // 10: offset inside the second block
+    EXPECT_LT(cached.latencyUs, network.latencyUs);
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
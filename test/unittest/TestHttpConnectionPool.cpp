@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "LoopbackHttpServer.h"
+#include "curl/curl.h"
+#include "plugin/plugins/source/http_source/download/downloader.h"
+#include "plugin/plugins/source/http_source/download/http_connection_pool.h"
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace OHOS::Media::Plugin::HttpPlugin;
+using namespace testing::ext;
+
+namespace {
+constexpr size_t FRAGMENT_SIZE = 64 * 1024; // 64: KB, a short fragment
+constexpr int FRAGMENTS = 8;                // 8: fragments of a playlist
+constexpr int HANDSHAKE_DELAY_MS = 20;      // 20: ms, round trips of a tcp and tls handshake on a mobile network
+
+// local https stand-in for a fragment server
+LoopbackHttpServer::Options FragmentServer(bool closeAfterResponse = false)
+{
+    LoopbackHttpServer::Options options;
+    options.body = std::vector<uint8_t>(FRAGMENT_SIZE, 'f');
+    options.contentType = "video/mp2t";
+    options.handshakeDelayMs = HANDSHAKE_DELAY_MS;
+    options.tls = true;
+    options.closeAfterResponse = closeAfterResponse;
+    return options;
+}
+
+std::string FragmentUrl(const LoopbackHttpServer& server, int fragment)
+{
+    return server.Url("/fragment_" + std::to_string(fragment) + ".ts");
+}
+
+// fetch the fragments through one downloader, as hls does, and return the bytes received
+size_t FetchFragments(LoopbackHttpServer& server, int first, int count)
+{
+    std::atomic<size_t> received {0};
+    auto saveData = [&received](uint8_t* data, uint32_t len) {
+        received += len;
+        return true;
+    };
+    auto statusCallback = [](DownloadStatus, std::shared_ptr<Downloader>&, std::shared_ptr<DownloadRequest>&) {};
+    Downloader downloader("ut");
+    std::vector<std::shared_ptr<DownloadRequest>> requests;
+    for (int i = first; i < first + count; i++) {
+        requests.push_back(std::make_shared<DownloadRequest>(FragmentUrl(server, i), saveData, statusCallback, true));
+        downloader.Download(requests.back(), -1);
+    }
+    downloader.Start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10); // 10: s, stand-in timeout
+    while (!requests.back()->IsEos() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    downloader.Stop();
+    return received;
+}
+
+// the former behaviour: every fragment request opened a new easy handle, with its own connection and tls session
+int64_t FetchWithNewHandles(LoopbackHttpServer& server, int count)
+{
+    int64_t totalTtfbUs = 0;
+    for (int i = 0; i < count; i++) {
+        CURL* handle = curl_easy_init();
+        curl_easy_setopt(handle, CURLOPT_URL, FragmentUrl(server, i).c_str());
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, +[](char*, size_t size, size_t nitems, void*) {
+            return size * nitems;
+        });
+        curl_easy_perform(handle);
+        curl_off_t ttfbUs = 0;
+        curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME_T, &ttfbUs);
+        totalTtfbUs += static_cast<int64_t>(ttfbUs);
+        curl_easy_cleanup(handle);
+    }
+    return totalTtfbUs / count;
+}
+}
+
+HWTEST(HttpConnectionPoolTest, host_is_parsed_from_url, TestSize.Level1)
+{
+    EXPECT_EQ(HttpConnectionPool::GetHost("https://cdn.example.com:8443/live/a.ts?t=1"), "cdn.example.com:8443");
+    EXPECT_EQ(HttpConnectionPool::GetHost("http://user:pw@cdn.example.com/a.m3u8"), "cdn.example.com");
+    EXPECT_EQ(HttpConnectionPool::GetHost("http://cdn.example.com"), "cdn.example.com");
+}
+
+HWTEST(HttpConnectionPoolTest, fragments_reuse_a_warm_connection, TestSize.Level1)
+{
+    LoopbackHttpServer server(FragmentServer());
+    auto newHandleTtfbUs = FetchWithNewHandles(server, FRAGMENTS);
+    int newHandleConnections = server.Connections();
+
+    auto& pool = HttpConnectionPool::GetInstance();
+    auto before = pool.GetStatistics(server.Host());
+    int connectionsBefore = server.Connections();
+    EXPECT_EQ(FetchFragments(server, 0, FRAGMENTS), FRAGMENTS * FRAGMENT_SIZE);
+    auto after = pool.GetStatistics(server.Host());
+    auto requests = after.requests - before.requests;
+    ASSERT_GT(requests, 0u);
+    auto pooledTtfbUs = (after.totalTtfbUs - before.totalTtfbUs) / static_cast<int64_t>(requests);
+    std::cout << FRAGMENTS << " fragments, new handle per fragment: " << newHandleConnections << " connections, ttfb "
+              << newHandleTtfbUs << "us, pooled: " << server.Connections() - connectionsBefore << " connections for "
+              << requests << " requests, ttfb " << pooledTtfbUs << "us" << std::endl;
+    EXPECT_EQ(newHandleConnections, FRAGMENTS);
+    EXPECT_LE(server.Connections() - connectionsBefore, 1);
+    EXPECT_LE(after.connections - before.connections, 1u);
+    EXPECT_LT(pooledTtfbUs, newHandleTtfbUs);
+}
+
+HWTEST(HttpConnectionPoolTest, downloaders_share_connections, TestSize.Level1)
+{
+    LoopbackHttpServer server(FragmentServer());
+    EXPECT_EQ(FetchFragments(server, 0, 1), FRAGMENT_SIZE); // the playlist downloader warms the connection
+    EXPECT_EQ(FetchFragments(server, 1, 2), 2 * FRAGMENT_SIZE); // 2: fragments of the media downloader
+    auto statistics = HttpConnectionPool::GetInstance().GetStatistics(server.Host());
+    std::cout << "two downloaders: " << server.Connections() << " connections, " << statistics.requests
+              << " requests, last ttfb " << statistics.lastTtfbUs << "us" << std::endl;
+    EXPECT_EQ(server.Connections(), 1);
+    EXPECT_EQ(statistics.connections, 1u);
+    EXPECT_LT(statistics.lastTtfbUs, HANDSHAKE_DELAY_MS * 1000); // 1000: us, no handshake on the last request
+}
+HWTEST(HttpConnectionPoolTest, tls_sessions_are_resumed_on_new_connections, TestSize.Level1)
+{
+    LoopbackHttpServer server(FragmentServer(true)); // the server closes every connection after its response
+    EXPECT_EQ(FetchFragments(server, 0, 3), 3 * FRAGMENT_SIZE); // 3: fragments
+    std::cout << "closing server: " << server.Connections() << " connections, " << server.ResumedSessions()
+              << " resumed tls sessions" << std::endl;
+    EXPECT_EQ(server.Connections(), 3); // 3: one per fragment
+    EXPECT_GE(server.ResumedSessions(), 2); // 2: all but the first handshake
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
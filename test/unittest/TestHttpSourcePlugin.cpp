@@ -16,6 +16,8 @@
 #include <string>
 #include "gtest/gtest.h"
 #include "plugin/plugins/source/http_source/download/downloader.h"
+#include "plugin/plugins/source/http_source/download/http_cache.h"
+#include "plugin/plugins/source/http_source/http_source_plugin.h"
 
 namespace OHOS {
 namespace Media {
@@ -59,6 +61,29 @@ HWTEST(HttpSourcePluginTest, test_download_request_save_header, TestSize.Level1)
 
     EXPECT_EQ(true, downloadRequest.IsClosed());
 }
+
+HWTEST(HttpSourcePluginTest, test_http_cache_limits_are_parameters, TestSize.Level1)
+{
+    size_t memoryLimit = 0;
+    size_t diskLimit = 0;
+    std::string diskPath;
+    HttpCache::GetInstance().GetLimits(memoryLimit, diskLimit, diskPath);
+
+    HttpSourcePlugin plugin("ut");
+    constexpr uint64_t newMemoryLimit = 2 * 1024 * 1024; // 2: MB
+    EXPECT_EQ(Plugin::Status::OK, plugin.SetParameter(Plugin::Tag::HTTP_CACHE_MEMORY_LIMIT, newMemoryLimit));
+    EXPECT_EQ(Plugin::Status::ERROR_MISMATCHED_TYPE,
+              plugin.SetParameter(Plugin::Tag::HTTP_CACHE_DISK_LIMIT, static_cast<uint32_t>(1)));
+    Plugin::ValueType value;
+    ASSERT_EQ(Plugin::Status::OK, plugin.GetParameter(Plugin::Tag::HTTP_CACHE_MEMORY_LIMIT, value));
+    EXPECT_EQ(newMemoryLimit, Plugin::AnyCast<uint64_t>(value));
+    ASSERT_EQ(Plugin::Status::OK, plugin.GetParameter(Plugin::Tag::HTTP_CACHE_DISK_LIMIT, value));
+    EXPECT_EQ(static_cast<uint64_t>(diskLimit), Plugin::AnyCast<uint64_t>(value));
+    ASSERT_EQ(Plugin::Status::OK, plugin.GetParameter(Plugin::Tag::HTTP_CACHE_BYTES_SAVED, value));
+    EXPECT_EQ(HttpCache::GetInstance().GetStatistics().bytesSaved, Plugin::AnyCast<uint64_t>(value));
+
+    HttpCache::GetInstance().SetLimits(memoryLimit, diskLimit, diskPath);
+}
 } // namespace Test
 } // namespace Media
 } // namespace OHOS
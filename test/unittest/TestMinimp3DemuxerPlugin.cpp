@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "gtest/gtest.h"
+#include "foundation/utils/steady_clock.h"
+#include "plugin/common/plugin_time.h"
+#include "plugin/plugins/minimp3_adapter/minimp3_demuxer_plugin.h"
+
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "/data/test/media"
+#endif
+
+using namespace testing::ext;
+using namespace OHOS::Media::Plugin;
+using namespace OHOS::Media::Plugin::Minimp3;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+namespace {
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr uint32_t SAMPLES_PER_FRAME = 1152;
+constexpr size_t FRAME_NUMBER_OFFSET = 4 + 17; // 4: header, 17: mono side info
+constexpr int SEEK_TIMES = 100;
+
+class MemoryDataSource : public DataSource {
+public:
+    explicit MemoryDataSource(std::vector<uint8_t> data) : data_(std::move(data)) {}
+    Status ReadAt(int64_t offset, std::shared_ptr<Buffer>& buffer, size_t expectedLen) override
+    {
+        if (offset < 0 || static_cast<size_t>(offset) >= data_.size()) {
+            return Status::END_OF_STREAM;
+        }
+        auto memory = buffer->IsEmpty() ? buffer->AllocMemory(nullptr, expectedLen) : buffer->GetMemory();
+        size_t length = std::min({expectedLen, data_.size() - static_cast<size_t>(offset), memory->GetCapacity()});
+        memory->Write(data_.data() + offset, length, 0);
+        return Status::OK;
+    }
+    Status GetSize(uint64_t& size) override
+    {
+        size = data_.size();
+        return Status::OK;
+    }
+    Seekable GetSeekable() override
+    {
+        return Seekable::SEEKABLE;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+struct TestStream {
+    std::vector<uint8_t> data;
+    std::vector<uint64_t> frameOffsets; // offsets of the audio frames
+};
+
+void AppendFrame(TestStream& stream, uint8_t bitrateIndex, uint32_t frameNumber)
+{
+    Mp3FrameHeader header;
+    uint8_t head[] = {0xff, 0xfb, static_cast<uint8_t>((bitrateIndex << 4) | 0x04), 0xc0}; // mpeg1 layer3 48000 mono
+    EXPECT_TRUE(ParseMp3FrameHeader(head, header));
+    size_t offset = stream.data.size();
+    stream.data.resize(offset + header.frameLength);
+    (void)memcpy(stream.data.data() + offset, head, sizeof(head));
+    (void)memcpy(stream.data.data() + offset + FRAME_NUMBER_OFFSET, &frameNumber, sizeof(frameNumber));
+    stream.frameOffsets.push_back(offset);
+}
+
+/// a vbr stand-in whose frames cycle through all the bitrates, with the frame number written in each frame
+TestStream BuildVbrStream(uint32_t frames, bool withXing)
+{
+    TestStream stream;
+    for (uint32_t i = 0; i < frames; ++i) {
+        AppendFrame(stream, static_cast<uint8_t>(1 + (i * 7 + i / 13) % 14), i); // 7, 13: vary the bitrate, 14: indexes
+    }
+    if (!withXing) {
+        return stream;
+    }
+    TestStream xing;
+    AppendFrame(xing, 9, 0); // 9: 128kbps, large enough for the toc
+    uint64_t xingSize = xing.data.size();
+    uint64_t bytes = xingSize + stream.data.size();
+    uint8_t* tag = xing.data.data() + FRAME_NUMBER_OFFSET;
+    uint8_t fields[] = {'X', 'i', 'n', 'g', 0, 0, 0, 0x07, // 0x07: frames, bytes and toc
+                        static_cast<uint8_t>(frames >> 24), static_cast<uint8_t>(frames >> 16), // 24, 16: bytes
+                        static_cast<uint8_t>(frames >> 8), static_cast<uint8_t>(frames), // 8: byte
+                        static_cast<uint8_t>(bytes >> 24), static_cast<uint8_t>(bytes >> 16), // 24, 16: bytes
+                        static_cast<uint8_t>(bytes >> 8), static_cast<uint8_t>(bytes)}; // 8: byte
+    (void)memcpy(tag, fields, sizeof(fields));
+    for (uint32_t i = 0; i < 100; ++i) { // 100: toc entries
+        uint64_t offset = xingSize + stream.frameOffsets[static_cast<uint64_t>(frames) * i / 100]; // 100: percent
+        tag[sizeof(fields) + i] = static_cast<uint8_t>(offset * 256 / bytes); // 256: toc scale
+    }
+    for (auto& offset : stream.frameOffsets) {
+        offset += xingSize;
+    }
+    xing.data.insert(xing.data.end(), stream.data.begin(), stream.data.end());
+    xing.frameOffsets = stream.frameOffsets;
+    return xing;
+}
+
+TestStream LoadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    TestStream stream {{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()}, {}};
+    if (stream.data.size() < 10 || memcmp(stream.data.data(), "ID3", 3) != 0) { // 10: id3v2 header, 3: tag
+        return stream;
+    }
+    uint64_t offset = (((stream.data[6] & 0x7f) << 21) | ((stream.data[7] & 0x7f) << 14) | // 6, 7, 21, 14: size
+        ((stream.data[8] & 0x7f) << 7) | (stream.data[9] & 0x7f)) + 10; // 8, 9, 7: size, 10: id3v2 header
+    Mp3FrameHeader header;
+    bool first = true;
+    while (offset + 4 <= stream.data.size() && ParseMp3FrameHeader(stream.data.data() + offset, header)) { // 4
+        if (!first) { // the first frame carries the Info tag
+            stream.frameOffsets.push_back(offset);
+        }
+        first = false;
+        offset += header.frameLength;
+    }
+    return stream;
+}
+
+std::shared_ptr<Minimp3DemuxerPlugin> PrepareDemuxer(const std::vector<uint8_t>& data)
+{
+    auto demuxer = std::make_shared<Minimp3DemuxerPlugin>("seek");
+    if (demuxer->Init() != Status::OK ||
+        demuxer->SetDataSource(std::make_shared<MemoryDataSource>(data)) != Status::OK) {
+        return nullptr;
+    }
+    MediaInfo mediaInfo;
+    if (demuxer->GetMediaInfo(mediaInfo) != Status::OK) {
+        return nullptr;
+    }
+    return demuxer;
+}
+
+int64_t FrameTime(uint64_t frameNumber)
+{
+    return static_cast<int64_t>(frameNumber * SAMPLES_PER_FRAME * HST_SECOND / SAMPLE_RATE);
+}
+
+/// seek to scattered positions, every read frame is located in the stream to measure the real seek error
+void BenchmarkSeek(const std::string& name, const TestStream& stream, int64_t maxErrorMs)
+{
+    auto demuxer = PrepareDemuxer(stream.data);
+    ASSERT_TRUE(demuxer != nullptr);
+    int64_t duration = FrameTime(stream.frameOffsets.size());
+    int64_t totalErrorMs = 0;
+    int64_t maxSeenErrorMs = 0;
+    int64_t elapsedUs = 0;
+    for (int i = 0; i < SEEK_TIMES; ++i) {
+        // 37: scatter the seek positions, which mostly fall inside a frame
+        int64_t target = duration / SEEK_TIMES * ((i * 37) % SEEK_TIMES) + i * HST_MSECOND;
+        int64_t realSeekTime = -1;
+        SteadyClock clock;
+        ASSERT_EQ(Status::OK, demuxer->SeekTo(0, target, SeekMode::SEEK_PREVIOUS_SYNC, realSeekTime));
+        elapsedUs += clock.ElapsedMicroseconds();
+        Buffer frame;
+        ASSERT_EQ(Status::OK, demuxer->ReadFrame(frame, 0));
+        ASSERT_EQ(realSeekTime, frame.pts);
+        auto memory = frame.GetMemory();
+        auto ite = std::find_if(stream.frameOffsets.begin(), stream.frameOffsets.end(), [&](uint64_t offset) {
+            return offset + memory->GetSize() <= stream.data.size() &&
+                memcmp(stream.data.data() + offset, memory->GetReadOnlyData(), memory->GetSize()) == 0;
+        });
+        ASSERT_TRUE(ite != stream.frameOffsets.end());
+        int64_t realTime = FrameTime(ite - stream.frameOffsets.begin());
+        int64_t errorMs = std::abs(target - realTime) / HST_MSECOND;
+        totalErrorMs += errorMs;
+        maxSeenErrorMs = std::max(maxSeenErrorMs, errorMs);
+        ASSERT_LE(std::abs(realSeekTime - realTime) / HST_MSECOND, maxErrorMs);
+    }
+    std::cout << name << ": seek error " << totalErrorMs / SEEK_TIMES << " ms on average, " << maxSeenErrorMs
+              << " ms at most, " << elapsedUs / SEEK_TIMES << " us per seek" << std::endl;
+    ASSERT_LE(maxSeenErrorMs, maxErrorMs + FrameTime(1) / HST_MSECOND);
+    ASSERT_TRUE(demuxer->Deinit() == Status::OK);
+}
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_frame_header_parse, TestSize.Level1)
+{
+    Mp3FrameHeader header;
+    const uint8_t mpeg1[] = {0xff, 0xfb, 0x54, 0xc0};
+    ASSERT_TRUE(ParseMp3FrameHeader(mpeg1, header));
+    ASSERT_EQ(48000u, header.sampleRate);
+    ASSERT_EQ(64u, header.bitrateKbps);
+    ASSERT_EQ(1, header.channels);
+    ASSERT_EQ(192u, header.frameLength);
+    ASSERT_EQ(1152u, header.samplesPerFrame);
+    const uint8_t mpeg2[] = {0xff, 0xf3, 0x82, 0x00}; // mpeg2 layer3 22050 64kbps padding stereo
+    ASSERT_TRUE(ParseMp3FrameHeader(mpeg2, header));
+    ASSERT_EQ(22050u, header.sampleRate);
+    ASSERT_EQ(2, header.channels);
+    ASSERT_EQ(209u, header.frameLength); // 72 * 64000 / 22050 + 1
+    ASSERT_EQ(576u, header.samplesPerFrame);
+    const uint8_t freeFormat[] = {0xff, 0xfb, 0x04, 0xc0};
+    ASSERT_FALSE(ParseMp3FrameHeader(freeFormat, header));
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_seek_table_xing_toc, TestSize.Level1)
+{
+    auto stream = BuildVbrStream(1000, true); // 1000: frames
+    Mp3SeekTable table;
+    table.Reset(0, stream.data.size());
+    ASSERT_TRUE(table.ParseVbrHeader(stream.data.data(), stream.data.size(), 0));
+    ASSERT_TRUE(table.HasToc());
+    ASSERT_EQ(1000u * SAMPLES_PER_FRAME, table.GetTotalSamples());
+    ASSERT_EQ(stream.frameOffsets[0], table.GetDataOffset());
+    for (uint32_t frame = 0; frame < 1000; frame += 50) { // 1000: frames, 50: step
+        uint64_t estimated = table.EstimateOffset(frame * SAMPLES_PER_FRAME);
+        uint64_t distance = estimated > stream.frameOffsets[frame] ? estimated - stream.frameOffsets[frame] :
+            stream.frameOffsets[frame] - estimated;
+        ASSERT_LE(distance, stream.data.size() / 256 + 1000); // 256: toc scale, 1000: a few frames of interpolation
+    }
+    ASSERT_EQ(0u, table.EstimateSample(table.GetDataOffset()));
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_seek_table_vbri_toc, TestSize.Level1)
+{
+    std::vector<uint8_t> frame(417); // 417: 128kbps at 44100
+    const uint8_t head[] = {0xff, 0xfb, 0x90, 0x00};
+    (void)memcpy(frame.data(), head, sizeof(head));
+    const uint8_t vbri[] = {'V', 'B', 'R', 'I', 0, 1, 0, 0, 0, 0,
+                            0, 0, 0x10, 0, // bytes: 4096
+                            0, 0, 0, 40,   // frames: 40
+                            0, 4,          // entries: 4
+                            0, 2,          // scale: 2
+                            0, 2,          // entry size: 2
+                            0, 10,         // frames per entry: 10
+                            0x01, 0x00, 0x02, 0x00, 0x01, 0x00, 0x02, 0x00};
+    (void)memcpy(frame.data() + 36, vbri, sizeof(vbri)); // 36: vbri tag offset
+    Mp3SeekTable table;
+    table.Reset(100, 100000); // 100: first frame offset, 100000: stream size
+    ASSERT_TRUE(table.ParseVbrHeader(frame.data(), frame.size(), 100)); // 100: first frame offset
+    ASSERT_EQ(517u, table.GetDataOffset()); // 100 + 417
+    ASSERT_EQ(40u * 1152, table.GetTotalSamples()); // 40 frames, 1152 samples per frame
+    ASSERT_TRUE(table.HasToc());
+    ASSERT_EQ(517u + 512, table.EstimateOffset(10 * 1152)); // 10 frames, 512 bytes per 256 * 2
+    ASSERT_EQ(517u + 512 + 512, table.EstimateOffset(15 * 1152)); // halfway to the 1024 bytes of next 10 frames
+    ASSERT_EQ(20u * 1152, table.EstimateSample(517 + 512 + 1024)); // 20 frames
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_seek_table_lazy_index, TestSize.Level1)
+{
+    Mp3SeekTable table(4); // 4: frames per entry
+    table.Reset(10, 10000); // 10: first frame offset, 10000: stream size
+    for (uint64_t i = 0; i < 20; ++i) { // 20: frames
+        table.AddFrame({i, i * SAMPLES_PER_FRAME, 10 + i * 100}, 100, SAMPLES_PER_FRAME); // 10, 100: offset, size
+    }
+    table.AddFrame({30, 0, 0}, 100, SAMPLES_PER_FRAME); // 30: not contiguous, ignored
+    ASSERT_EQ(5u, table.GetEntryCount());
+    ASSERT_EQ(20u, table.GetEndPosition().frameNumber);
+    ASSERT_EQ(2010u, table.GetEndPosition().offset);
+    ASSERT_EQ(8u, table.Lookup(11 * SAMPLES_PER_FRAME + 1).frameNumber);
+    ASSERT_EQ(810u, table.Lookup(11 * SAMPLES_PER_FRAME + 1).offset);
+    ASSERT_EQ(16u, table.Lookup(100 * SAMPLES_PER_FRAME).frameNumber);
+    table.SetComplete(19); // 19: not the indexed frame count
+    ASSERT_FALSE(table.IsComplete());
+    table.SetComplete(20); // 20: frames
+    ASSERT_TRUE(table.IsComplete());
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_demuxer_seek_cbr_file, TestSize.Level1)
+{
+    auto stream = LoadFile(RESOURCE_DIR "/MP3/MP3_LONG_48000_32.mp3");
+    ASSERT_FALSE(stream.frameOffsets.empty());
+    BenchmarkSeek("MP3_LONG_48000_32", stream, 0);
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_demuxer_seek_vbr_without_toc, TestSize.Level1)
+{
+    BenchmarkSeek("vbr without toc", BuildVbrStream(20000, false), 0); // 20000: frames, 8 minutes
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_demuxer_seek_vbr_with_toc, TestSize.Level1)
+{
+    // far seeks land by the toc, whose offsets have a resolution of 1/256 of the stream
+    auto stream = BuildVbrStream(20000, true); // 20000: frames, 8 minutes
+    BenchmarkSeek("vbr with xing toc", stream, FrameTime(stream.frameOffsets.size()) / 128 / HST_MSECOND); // 128
+}
+
+HWTEST(TestMinimp3DemuxerPlugin, mp3_demuxer_duration_from_xing, TestSize.Level1)
+{
+    auto stream = BuildVbrStream(2000, true); // 2000: frames
+    auto demuxer = std::make_shared<Minimp3DemuxerPlugin>("duration");
+    ASSERT_EQ(Status::OK, demuxer->Init());
+    ASSERT_EQ(Status::OK, demuxer->SetDataSource(std::make_shared<MemoryDataSource>(stream.data)));
+    MediaInfo mediaInfo;
+    ASSERT_EQ(Status::OK, demuxer->GetMediaInfo(mediaInfo));
+    int64_t duration = 0;
+    ASSERT_TRUE(mediaInfo.tracks[0].Get<Tag::MEDIA_DURATION>(duration));
+    ASSERT_EQ(FrameTime(2000) / HST_MSECOND, duration / HST_MSECOND); // 2000: frames
+    ASSERT_TRUE(demuxer->Deinit() == Status::OK);
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "foundation/utils/spsc_queue.h"
+#include "foundation/utils/steady_clock.h"
+#include "pipeline/filters/muxer/muxer_interleaver.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace Pipeline;
+
+namespace {
+constexpr int64_t AUDIO_FRAME_DURATION = 23 * HST_MSECOND;
+constexpr int64_t VIDEO_FRAME_DURATION = 33 * HST_MSECOND;
+constexpr int FRAME_COUNT = 2000;
+constexpr size_t FRAME_SIZE = 16;
+
+AVBufferPtr CreateFrame(uint32_t trackId, int64_t pts, bool eos = false)
+{
+    auto buffer = std::make_shared<AVBuffer>();
+    if (!eos) {
+        buffer->AllocMemory(nullptr, FRAME_SIZE);
+        buffer->GetMemory()->Write(std::vector<uint8_t>(FRAME_SIZE).data(), FRAME_SIZE);
+    } else {
+        buffer->flag |= BUFFER_FLAG_EOS;
+    }
+    buffer->trackID = trackId;
+    buffer->pts = pts;
+    return buffer;
+}
+
+void ProduceFrames(MuxerInterleaver& interleaver, size_t index, int64_t frameDuration, bool jitter)
+{
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        interleaver.PushFrame(index, CreateFrame(index, i * frameDuration));
+        if (jitter && (i % 100 == 0)) { // 100: make the producer stall now and then
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    interleaver.PushFrame(index, CreateFrame(index, 0, true));
+}
+}
+
+HWTEST(TestMuxerInterleaver, spsc_queue_keeps_order_and_capacity, TestSize.Level1)
+{
+    SpscQueue<int> queue(3); // 3: rounded up to 4
+    ASSERT_EQ(4u, queue.Capacity());
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.TryPush(i));
+    }
+    ASSERT_FALSE(queue.TryPush(4));
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+    ASSERT_EQ(nullptr, queue.Front());
+}
+
+HWTEST(TestMuxerInterleaver, frames_are_written_in_timestamp_order, TestSize.Level1)
+{
+    std::vector<AVBufferPtr> written;
+    MuxerInterleaver interleaver([&written](const AVBufferPtr& buffer) { written.emplace_back(buffer); });
+    auto audio = interleaver.AddTrack();
+    auto video = interleaver.AddTrack();
+    // the producers run far faster than real encoders, never give up waiting for the other track
+    interleaver.SetMaxInterleaveDelta(100 * HST_SECOND); // 100: s
+    interleaver.Start();
+    SteadyClock clock;
+    std::thread audioThread(ProduceFrames, std::ref(interleaver), audio, AUDIO_FRAME_DURATION, true);
+    std::thread videoThread(ProduceFrames, std::ref(interleaver), video, VIDEO_FRAME_DURATION, false);
+    audioThread.join();
+    videoThread.join();
+    interleaver.Stop();
+    interleaver.Drain();
+    auto elapsedUs = clock.ElapsedMicroseconds();
+
+    auto stats = interleaver.GetStats();
+    std::cout << "interleaved " << stats.framesWritten << " frames in " << elapsedUs << " us, max dts regression "
+              << stats.maxDtsRegression << " ns, producer stalls " << stats.producerStalls << std::endl;
+    ASSERT_EQ(static_cast<uint64_t>(FRAME_COUNT * 2), stats.framesWritten); // 2: two tracks
+    ASSERT_EQ(static_cast<size_t>(FRAME_COUNT * 2 + 2), written.size()); // 2: two eos buffers
+    ASSERT_EQ(0, stats.maxDtsRegression);
+    int64_t last = INT64_MIN;
+    for (const auto& buffer : written) {
+        if (buffer->flag & BUFFER_FLAG_EOS) {
+            continue;
+        }
+        ASSERT_LE(last, buffer->pts);
+        last = buffer->pts;
+    }
+}
+
+HWTEST(TestMuxerInterleaver, lagging_track_does_not_block_beyond_delta, TestSize.Level1)
+{
+    std::vector<AVBufferPtr> written;
+    MuxerInterleaver interleaver([&written](const AVBufferPtr& buffer) { written.emplace_back(buffer); });
+    auto audio = interleaver.AddTrack();
+    interleaver.AddTrack();
+    interleaver.SetMaxInterleaveDelta(100 * HST_MSECOND); // 100: ms
+    interleaver.Start();
+    for (int i = 0; i < 4; ++i) { // 4: frames which span less than the delta
+        interleaver.PushFrame(audio, CreateFrame(audio, i * AUDIO_FRAME_DURATION));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: let the task run
+    // the silent track may still produce earlier frames
+    ASSERT_EQ(0u, interleaver.GetStats().framesWritten);
+    for (int i = 4; i < 10; ++i) { // 10: now the queued frames span more than the delta
+        interleaver.PushFrame(audio, CreateFrame(audio, i * AUDIO_FRAME_DURATION));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: let the task run
+    interleaver.Stop();
+    auto stats = interleaver.GetStats();
+    ASSERT_EQ(10u, stats.framesWritten);
+    ASSERT_GT(stats.forcedWrites, 0u);
+    ASSERT_EQ(10u, written.size());
+}
+
+HWTEST(TestMuxerInterleaver, flagged_dts_of_zero_is_not_replaced_by_pts, TestSize.Level1)
+{
+    std::vector<AVBufferPtr> written;
+    MuxerInterleaver interleaver([&written](const AVBufferPtr& buffer) { written.emplace_back(buffer); });
+    auto video = interleaver.AddTrack();
+    auto audio = interleaver.AddTrack();
+    interleaver.SetMaxInterleaveDelta(100 * HST_SECOND); // 100: s
+    // a reordered video frame decoded first but presented after the audio frame
+    auto videoFrame = CreateFrame(video, 2 * VIDEO_FRAME_DURATION); // 2: presented as the third frame
+    videoFrame->dts = 0;
+    videoFrame->flag |= BUFFER_FLAG_DTS_VALID;
+    interleaver.PushFrame(video, videoFrame);
+    interleaver.PushFrame(audio, CreateFrame(audio, AUDIO_FRAME_DURATION));
+    interleaver.Drain();
+    ASSERT_EQ(2u, written.size()); // 2: one frame per track
+    ASSERT_EQ(videoFrame, written[0]);
+}
+
+HWTEST(TestMuxerInterleaver, stop_releases_a_producer_blocked_on_a_full_queue, TestSize.Level1)
+{
+    MuxerInterleaver interleaver([](const AVBufferPtr&) {}, 2); // 2: frames a track queue holds
+    (void)interleaver.AddTrack(); // a video track which never produces
+    auto audio = interleaver.AddTrack();
+    interleaver.SetMaxInterleaveDelta(100 * HST_SECOND); // 100: s, audio waits for the silent video track
+    interleaver.Start();
+    std::atomic<bool> pushed {true};
+    std::atomic<bool> returned {false};
+    std::thread producer([&]() {
+        for (int i = 0; i < 3 && pushed; ++i) { // 3: one more than the queue holds
+            pushed = interleaver.PushFrame(audio, CreateFrame(audio, i * AUDIO_FRAME_DURATION));
+        }
+        returned = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: ms, long enough to fill the queue
+    EXPECT_FALSE(returned);
+    interleaver.Stop();
+    producer.join();
+    EXPECT_FALSE(pushed);
+    EXPECT_EQ(1u, interleaver.GetStats().producerStalls);
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
@@ -13,7 +13,12 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <iostream>
 #include "gtest/gtest.h"
+#include "foundation/utils/constants.h"
+#include "pipeline/core/compatible_check.h"
+#include "pipeline/filters/common/plugin_utils.h"
 #include "plugin_manager.h"
 #include "plugin_types.h"
 
@@ -201,6 +206,119 @@ HWTEST(TestPluginManager, Sniffer_case4, TestSize.Level1)
 {
     ASSERT_TRUE(PluginManager::Instance().Sniffer("UtDemuxerTest1", nullptr) == 0);
 }
+namespace {
+using AvailablePlugins = std::vector<std::pair<std::shared_ptr<PluginInfo>, Capability>>;
+
+struct GraphLink {
+    Capability caps;
+    PluginType type;
+};
+
+// links of a typical player graph: mp3 and avc decoders, then the audio and video sinks
+std::vector<GraphLink> PlayerGraphLinks()
+{
+    Capability audio(MEDIA_MIME_AUDIO_MPEG);
+    audio.AppendFixedKey<uint32_t>(Capability::Key::AUDIO_MPEG_VERSION, 1);
+    audio.AppendFixedKey<uint32_t>(Capability::Key::AUDIO_MPEG_LAYER, 3); // 3: layer 3
+    audio.AppendFixedKey<uint32_t>(Capability::Key::AUDIO_SAMPLE_RATE, 44100); // 44100: sample rate
+    audio.AppendFixedKey<uint32_t>(Capability::Key::AUDIO_CHANNELS, 2); // 2: channels
+    Capability video(MEDIA_MIME_VIDEO_H264);
+    video.AppendFixedKey<VideoBitStreamFormat>(Capability::Key::VIDEO_BIT_STREAM_FORMAT, VideoBitStreamFormat::AVC1);
+    Capability pcm(MEDIA_MIME_AUDIO_RAW);
+    pcm.AppendFixedKey<AudioSampleFormat>(Capability::Key::AUDIO_SAMPLE_FORMAT, AudioSampleFormat::S16);
+    pcm.AppendFixedKey<uint32_t>(Capability::Key::AUDIO_SAMPLE_RATE, 44100); // 44100: sample rate
+    Capability yuv(MEDIA_MIME_VIDEO_RAW);
+    yuv.AppendFixedKey<VideoPixelFormat>(Capability::Key::VIDEO_PIXEL_FORMAT, VideoPixelFormat::NV12);
+    return {{audio, PluginType::AUDIO_DECODER}, {video, PluginType::VIDEO_DECODER},
+            {pcm, PluginType::AUDIO_SINK}, {yuv, PluginType::VIDEO_SINK}};
+}
+
+// negotiation as done before the mime index: every registered plugin of the type is checked
+AvailablePlugins FindAvailablePluginsByScan(const Capability& upStreamCaps, PluginType type, CodecMode mode)
+{
+    AvailablePlugins infos;
+    for (const auto& name : PluginManager::Instance().ListPlugins(type, mode)) {
+        auto info = PluginManager::Instance().GetPluginInfo(type, name);
+        Capability cap;
+        if (info != nullptr && Pipeline::ApplyCapabilitySet(upStreamCaps, info->inCaps, cap)) {
+            infos.emplace_back(info, cap);
+        }
+    }
+    return infos;
+}
+
+std::vector<std::string> Names(const AvailablePlugins& plugins)
+{
+    std::vector<std::string> names;
+    for (const auto& plugin : plugins) {
+        names.push_back(plugin.first->name);
+    }
+    return names;
+}
+} // namespace
+
+HWTEST(TestPluginManager, ListPluginsByInputMime_case1, TestSize.Level1)
+{
+    for (auto type : {PluginType::AUDIO_DECODER, PluginType::VIDEO_DECODER, PluginType::AUDIO_SINK,
+                      PluginType::VIDEO_SINK, PluginType::MUXER}) {
+        for (auto mode : {CodecMode::HARDWARE, CodecMode::SOFTWARE}) {
+            for (const std::string mime : {MEDIA_MIME_AUDIO_MPEG, MEDIA_MIME_AUDIO_RAW, MEDIA_MIME_VIDEO_H264,
+                                           MEDIA_MIME_VIDEO_RAW, "AUDIO/MPEG", "audio/*", "application/x-ut"}) {
+                std::vector<std::string> expected;
+                for (const auto& name : PluginManager::Instance().ListPlugins(type, mode)) {
+                    auto info = PluginManager::Instance().GetPluginInfo(type, name);
+                    Capability cap;
+                    if (Pipeline::ApplyCapabilitySet(Capability(mime), info->inCaps, cap)) {
+                        expected.push_back(name);
+                    }
+                }
+                ASSERT_EQ(PluginManager::Instance().ListPluginsByInputMime(type, mime, mode), expected);
+            }
+        }
+    }
+    ASSERT_TRUE(PluginManager::Instance().ListPluginsByInputMime(PluginType::AUDIO_DECODER, "mpeg").empty());
+    ASSERT_TRUE(PluginManager::Instance().ListPluginsByInputMime(PluginType(256), MEDIA_MIME_AUDIO_RAW).empty());
+}
+
+HWTEST(TestPluginManager, FindAvailablePlugins_case1, TestSize.Level1)
+{
+    constexpr int32_t rounds = 200; // 200: negotiations per link
+    for (const auto& link : PlayerGraphLinks()) {
+        auto expected = FindAvailablePluginsByScan(link.caps, link.type, CodecMode::HARDWARE);
+        ASSERT_EQ(Names(Pipeline::FindAvailablePlugins(link.caps, link.type)), Names(expected));
+        ASSERT_EQ(Names(Pipeline::FindAvailablePlugins(link.caps, link.type)), Names(expected));
+
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < rounds; ++i) {
+            (void)FindAvailablePluginsByScan(link.caps, link.type, CodecMode::HARDWARE);
+        }
+        auto scanNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count() / rounds;
+        start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < rounds; ++i) {
+            (void)Pipeline::FindAvailablePlugins(link.caps, link.type);
+        }
+        auto cachedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count() / rounds;
+        std::cout << link.caps.mime << " -> " << static_cast<int32_t>(link.type) << ": " << expected.size()
+                  << " candidates, scan " << scanNs << "ns, indexed " << cachedNs << "ns per link" << std::endl;
+    }
+}
+
+HWTEST(TestPluginManager, FindAvailablePlugins_case2, TestSize.Level1)
+{
+    Capability audio(MEDIA_MIME_AUDIO_MPEG);
+    audio.AppendFixedKey<uint32_t>(Capability::Key::AUDIO_SAMPLE_RATE, 44100); // 44100: sample rate
+    auto hardware = Pipeline::FindAvailablePlugins(audio, PluginType::AUDIO_DECODER, CodecMode::HARDWARE);
+    auto software = Pipeline::FindAvailablePlugins(audio, PluginType::AUDIO_DECODER, CodecMode::SOFTWARE);
+    ASSERT_EQ(Names(hardware), Names(FindAvailablePluginsByScan(audio, PluginType::AUDIO_DECODER,
+                                                                CodecMode::HARDWARE)));
+    ASSERT_EQ(Names(software), Names(FindAvailablePluginsByScan(audio, PluginType::AUDIO_DECODER,
+                                                                CodecMode::SOFTWARE)));
+    audio.AppendFixedKey<uint32_t>(Capability::Key::AUDIO_SAMPLE_RATE, 1); // 1: rate no decoder accepts
+    ASSERT_EQ(Names(Pipeline::FindAvailablePlugins(audio, PluginType::AUDIO_DECODER)),
+              Names(FindAvailablePluginsByScan(audio, PluginType::AUDIO_DECODER, CodecMode::HARDWARE)));
+}
 } // namespace Test
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "LoopbackHttpServer.h"
+#include "foundation/osal/thread/mutex.h"
+#include "foundation/osal/thread/scoped_lock.h"
+#include "plugin/plugins/source/http_source/http/http_media_downloader.h"
+#include "plugin/plugins/source/http_source/monitor/download_monitor.h"
+#include "plugin/plugins/source/http_source/monitor/read_ahead_controller.h"
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace OHOS::Media::Plugin::HttpPlugin;
+using namespace testing::ext;
+
+namespace {
+constexpr int64_t TICK_MS = 10;        // 10: ms, step of the simulated playback
+constexpr int64_t UPDATE_MS = 50;      // 50: ms, period of the download monitor
+constexpr uint64_t RANGE_SIZE = 48 * 1024 * 10; // size of a range request of the downloader
+constexpr uint64_t BUFFER_SIZE = 5 * 1024 * 1024; // ring buffer of the http media downloader
+
+struct PlaybackResult {
+    uint64_t peakBufferedBytes {0};
+    uint64_t downloadedBytes {0};
+    uint64_t readBytes {0};
+    int rebuffers {0};
+    int64_t rebufferMs {0};
+    int pauses {0};
+};
+
+// network and player stand-ins: the network fills the buffer range by range and only checks the throttle between
+// ranges, as the downloader does, the player reads at a constant rate and stops at stopMs
+PlaybackResult SimulatePlayback(bool readAhead, uint64_t networkRate, uint64_t readRate, int64_t stopMs)
+{
+    constexpr uint64_t fileSize = 200 * 1024 * 1024; // 200: MB, longer than the playback
+    ReadAheadController controller(8000, 20000); // 8000, 20000: default buffer levels of the download monitor
+    PlaybackResult result;
+    controller.SetObserver([&result](const BufferSample& sample) {
+        result.pauses += sample.downloading ? 0 : 1;
+    }, [&result](const RebufferEvent& event) {
+        result.rebuffers++;
+        result.rebufferMs += event.durationMs;
+    });
+    controller.Reset(0);
+    uint64_t buffered = 0;
+    uint64_t rangeLeft = 0;
+    bool downloading = true;
+    int64_t starvedSinceMs = -1;
+    for (int64_t now = 0; now < stopMs; now += TICK_MS) {
+        if (rangeLeft == 0 && downloading && result.downloadedBytes < fileSize) {
+            rangeLeft = std::min(RANGE_SIZE, fileSize - result.downloadedBytes);
+        }
+        uint64_t received = std::min({rangeLeft, networkRate * TICK_MS / 1000, BUFFER_SIZE - buffered}); // 1000: ms
+        rangeLeft -= received;
+        buffered += received;
+        result.downloadedBytes += received;
+        result.peakBufferedBytes = std::max(result.peakBufferedBytes, buffered);
+
+        uint64_t chunk = readRate * TICK_MS / 1000; // 1000: ms
+        if (buffered >= chunk) {
+            buffered -= chunk;
+            result.readBytes += chunk;
+            controller.OnRead(chunk, starvedSinceMs >= 0, starvedSinceMs >= 0 ? starvedSinceMs : now, now);
+            starvedSinceMs = -1;
+        } else if (starvedSinceMs < 0) {
+            starvedSinceMs = now;
+        }
+        if (now % UPDATE_MS == 0) {
+            bool update = controller.Update(buffered, now);
+            downloading = readAhead ? update : true;
+        }
+    }
+    return result;
+}
+}
+
+HWTEST(ReadAheadTest, buffer_is_bounded_in_media_time, TestSize.Level1)
+{
+    constexpr uint64_t readRate = 128 * 1024; // 128: KB/s, a 1 Mbps stream
+    constexpr uint64_t networkRate = 1024 * 1024; // 1024: KB/s, an 8 Mbps network
+    constexpr int64_t stopMs = 60 * 1000; // 60: s, the user leaves after a minute
+    auto fixed = SimulatePlayback(false, networkRate, readRate, stopMs);
+    auto rated = SimulatePlayback(true, networkRate, readRate, stopMs);
+    std::cout << "fixed watermark: peak " << fixed.peakBufferedBytes / 1024 << "KB, downloaded "
+              << fixed.downloadedBytes / 1024 << "KB, read ahead: peak " << rated.peakBufferedBytes / 1024
+              << "KB, downloaded " << rated.downloadedBytes / 1024 << "KB, read " << rated.readBytes / 1024 << "KB"
+              << std::endl;
+    EXPECT_EQ(fixed.peakBufferedBytes, BUFFER_SIZE);
+    EXPECT_LE(rated.peakBufferedBytes, readRate * 20 + RANGE_SIZE + networkRate); // 20: s, maximum read ahead
+    EXPECT_LT(rated.downloadedBytes, fixed.downloadedBytes);
+    EXPECT_GT(rated.pauses, 0);
+    EXPECT_EQ(rated.rebuffers, 0);
+    EXPECT_EQ(rated.readBytes, fixed.readBytes);
+}
+
+HWTEST(ReadAheadTest, slow_network_is_not_throttled_into_rebuffering, TestSize.Level1)
+{
+    constexpr uint64_t readRate = 256 * 1024; // 256: KB/s, a 2 Mbps stream
+    constexpr uint64_t networkRate = 320 * 1024; // 320: KB/s, only a quarter above the stream
+    constexpr int64_t stopMs = 300 * 1000; // 300: s of playback
+    auto rated = SimulatePlayback(true, networkRate, readRate, stopMs);
+    std::cout << "slow network: peak " << rated.peakBufferedBytes / 1024 << "KB, rebuffers " << rated.rebuffers
+              << ", pauses " << rated.pauses << std::endl;
+    EXPECT_EQ(rated.rebuffers, 0);
+    EXPECT_EQ(rated.readBytes, readRate * TICK_MS / 1000 * (stopMs / TICK_MS)); // 1000: ms, the player never waited
+}
+
+HWTEST(ReadAheadTest, monitor_throttles_a_local_server, TestSize.Level1)
+{
+    constexpr size_t fileSize = 1536 * 1024; // 1536: KB, three seconds of media
+    constexpr uint64_t readRate = 512 * 1024; // 512: KB/s
+    std::vector<uint8_t> body(fileSize);
+    for (size_t i = 0; i < fileSize; i++) {
+        body[i] = static_cast<uint8_t>(i * 13); // 13: any pattern
+    }
+    LoopbackHttpServer::Options options;
+    options.body = body;
+    options.bytesPerSecond = 4 * readRate; // 4: network four times faster than the player
+    LoopbackHttpServer server(options);
+    DownloadMonitor monitor(std::make_shared<HttpMediaDownloader>(), 100, 200); // 100, 200: buffer levels in ms
+    OSAL::Mutex mutex;
+    std::vector<BufferSample> samples;
+    std::vector<RebufferEvent> rebuffers;
+    monitor.SetReadAheadObserver([&](const BufferSample& sample) {
+        OSAL::ScopedLock lock(mutex);
+        samples.push_back(sample);
+    }, [&](const RebufferEvent& event) {
+        OSAL::ScopedLock lock(mutex);
+        rebuffers.push_back(event);
+    });
+    ASSERT_TRUE(monitor.Open(server.Url("/media.mp4")));
+    std::vector<uint8_t> received;
+    constexpr unsigned int chunk = 16 * 1024; // 16: KB per read, paced to readRate
+    std::vector<uint8_t> buff(chunk);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(20); // 20: s, stand-in timeout
+    while (received.size() < fileSize && std::chrono::steady_clock::now() < deadline) {
+        unsigned int realReadLength = 0;
+        bool isEos = false;
+        monitor.Read(buff.data(), chunk, realReadLength, isEos);
+        received.insert(received.end(), buff.begin(), buff.begin() + realReadLength);
+        std::this_thread::sleep_until(start + std::chrono::microseconds(received.size() * 1000000 / readRate));
+    }
+    monitor.Close(false);
+
+    OSAL::ScopedLock lock(mutex);
+    size_t peak = 0;
+    size_t paused = 0;
+    for (const auto& sample : samples) {
+        peak = std::max(peak, sample.bufferedBytes);
+        paused += sample.downloading ? 0 : 1;
+    }
+    std::cout << samples.size() << " buffer samples, peak " << peak / 1024 << "KB, paused in " << paused
+              << ", rebuffers " << rebuffers.size() << std::endl;
+    EXPECT_TRUE(received == body);
+    EXPECT_FALSE(samples.empty());
+    EXPECT_GT(paused, 0u);
+    EXPECT_LT(peak, fileSize);
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
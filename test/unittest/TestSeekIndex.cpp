@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include "gtest/gtest.h"
+#include "foundation/osal/filesystem/file_system.h"
+#include "foundation/utils/seek_index.h"
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace testing::ext;
+
+namespace {
+const std::string INDEX_DIR = "/data/test/seek_index_ut";
+const std::string MEDIA_FILE = "/data/test/seek_index_ut_media.ts";
+constexpr uint32_t VIDEO_TRACK = 0;
+constexpr uint32_t OTHER_TRACK = 1;
+constexpr int32_t KEY_FRAMES = 1000;
+constexpr int64_t GOP_NS = 500000000;     // 500000000: a sync frame every half second
+constexpr int64_t GOP_BYTES = 188 * 1000; // 188 1000: ts packets of a gop
+
+void WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void PrepareMediaFile()
+{
+    ASSERT_TRUE(OSAL::FileSystem::MakeMultipleDir(INDEX_DIR));
+    OSAL::FileSystem::RemoveFilesInDir(INDEX_DIR);
+    std::vector<uint8_t> media(256 * 1024); // 256 * 1024: larger than the hashed head
+    for (size_t i = 0; i < media.size(); i++) {
+        media[i] = static_cast<uint8_t>(i * 7 + 3); // 7 3: any pattern
+    }
+    WriteFile(MEDIA_FILE, media);
+    SeekIndex::SetDirectory(INDEX_DIR);
+}
+
+// index the video track of the media file as a first playback would, and save it
+std::string IndexMediaFile()
+{
+    SeekIndex index;
+    EXPECT_FALSE(index.Open("file://" + MEDIA_FILE));
+    for (int32_t i = KEY_FRAMES - 1; i >= 0; i--) {
+        index.Add(VIDEO_TRACK, i * GOP_NS, i * GOP_BYTES);
+        index.Add(VIDEO_TRACK, i * GOP_NS, i * GOP_BYTES); // known already, ignored
+    }
+    index.Add(OTHER_TRACK, 0, 0);
+    EXPECT_EQ(static_cast<size_t>(KEY_FRAMES + 1), index.GetCount());
+    auto path = index.GetSidecarPath();
+    index.Close();
+    return path;
+}
+
+size_t CountFiles(const std::string& dir)
+{
+    size_t count = 0;
+    DIR* stream = opendir(dir.c_str());
+    if (stream == nullptr) {
+        return count;
+    }
+    for (dirent* entry = readdir(stream); entry != nullptr; entry = readdir(stream)) {
+        count += (entry->d_type == DT_REG) ? 1 : 0;
+    }
+    (void)closedir(stream);
+    return count;
+}
+
+void ExpectIndexed(SeekIndex& index)
+{
+    SeekIndex::Entry entry {};
+    ASSERT_TRUE(index.Find(VIDEO_TRACK, 10 * GOP_NS + 1, true, entry)); // 10: any gop
+    EXPECT_EQ(10 * GOP_NS, entry.pts);                                   // 10: that gop
+    EXPECT_EQ(10 * GOP_BYTES, entry.position);                           // 10: that gop
+    ASSERT_TRUE(index.Find(VIDEO_TRACK, 10 * GOP_NS + 1, false, entry)); // 10: any gop
+    EXPECT_EQ(11 * GOP_NS, entry.pts);                                   // 11: the next gop
+    ASSERT_TRUE(index.Find(VIDEO_TRACK, 10 * GOP_NS, false, entry));     // 10: a sync frame itself
+    EXPECT_EQ(10 * GOP_NS, entry.pts);                                   // 10: that gop
+    EXPECT_FALSE(index.Find(VIDEO_TRACK, KEY_FRAMES * GOP_NS, false, entry));
+    EXPECT_FALSE(index.Find(2, 0, false, entry)); // 2: a track not indexed
+    auto entries = index.GetEntries(VIDEO_TRACK);
+    ASSERT_EQ(static_cast<size_t>(KEY_FRAMES), entries.size());
+    for (int32_t i = 0; i < KEY_FRAMES; i++) {
+        EXPECT_EQ(i * GOP_NS, entries[i].pts);
+    }
+}
+} // namespace
+
+HWTEST(TestSeekIndex, save_and_load, TestSize.Level1)
+{
+    PrepareMediaFile();
+    auto path = IndexMediaFile();
+    ASSERT_FALSE(path.empty());
+    ASSERT_TRUE(OSAL::FileSystem::IsRegularFile(path));
+
+    SeekIndex index;
+    ASSERT_TRUE(index.Open(MEDIA_FILE));
+    EXPECT_EQ(static_cast<size_t>(KEY_FRAMES + 1), index.GetCount());
+    ExpectIndexed(index);
+
+    // entries found later are merged with the loaded ones
+    auto size = ReadFile(path).size();
+    index.Add(VIDEO_TRACK, KEY_FRAMES * GOP_NS, KEY_FRAMES * GOP_BYTES);
+    index.Add(VIDEO_TRACK, 0, 0);
+    index.Close();
+    EXPECT_EQ(size + sizeof(SeekIndex::Entry), ReadFile(path).size());
+    ASSERT_TRUE(index.Open(MEDIA_FILE));
+    EXPECT_EQ(static_cast<size_t>(KEY_FRAMES + 2), index.GetCount()); // 2: the other track and the new frame
+}
+
+HWTEST(TestSeekIndex, disabled_without_directory_or_local_file, TestSize.Level1)
+{
+    PrepareMediaFile();
+    SeekIndex::SetDirectory("");
+    SeekIndex index;
+    EXPECT_FALSE(index.Open(MEDIA_FILE));
+    index.Add(VIDEO_TRACK, 0, 0);
+    EXPECT_EQ(0u, index.GetCount());
+    EXPECT_TRUE(index.GetSidecarPath().empty());
+
+    SeekIndex::SetDirectory(INDEX_DIR);
+    SeekIndex::FileIdentity identity;
+    EXPECT_FALSE(SeekIndex::GetFileIdentity("http://host/media.ts", identity));
+    EXPECT_FALSE(SeekIndex::GetFileIdentity("fd://3?offset=0&size=100", identity));
+    EXPECT_FALSE(SeekIndex::GetFileIdentity(INDEX_DIR, identity));
+    EXPECT_TRUE(SeekIndex::GetFileIdentity(MEDIA_FILE, identity));
+}
+
+HWTEST(TestSeekIndex, ignore_sidecar_of_modified_file, TestSize.Level1)
+{
+    PrepareMediaFile();
+    auto path = IndexMediaFile();
+    auto media = ReadFile(MEDIA_FILE);
+    media[0] ^= 1; // same size, other head
+    WriteFile(MEDIA_FILE, media);
+    SeekIndex index;
+    EXPECT_FALSE(index.Open(MEDIA_FILE));
+    EXPECT_EQ(0u, index.GetCount());
+    EXPECT_NE(path, index.GetSidecarPath());
+}
+
+HWTEST(TestSeekIndex, tolerate_corrupted_sidecar, TestSize.Level1)
+{
+    PrepareMediaFile();
+    auto path = IndexMediaFile();
+    const auto valid = ReadFile(path);
+    const size_t entries = valid.size() - (KEY_FRAMES + 1) * sizeof(SeekIndex::Entry);
+    using Bytes = std::vector<uint8_t>;
+    const std::vector<std::function<void(Bytes&)>> corruptions = {
+        [](Bytes& data) { data.clear(); },
+        [](Bytes& data) { data.resize(10); },                                      // 10: inside the header
+        [](Bytes& data) { data.resize(data.size() - 1); },                         // torn last entry
+        [](Bytes& data) { data.resize(data.size() - sizeof(SeekIndex::Entry)); },  // lost last entry
+        [](Bytes& data) { data.insert(data.end(), sizeof(SeekIndex::Entry), 0); }, // trailing garbage
+        [](Bytes& data) { data[0] ^= 0xff; },                                      // magic
+        [](Bytes& data) { data[4] = SeekIndex::VERSION + 1; },                     // 4: version
+        [](Bytes& data) { data[8] ^= 1; },                                         // 8: file size
+        [entries](Bytes& data) { data[entries + 3] ^= 0x10; },                     // 3: a pts byte
+        [](Bytes& data) { data.back() ^= 0x80; },                                  // reserved of the last
+    };
+    for (size_t i = 0; i < corruptions.size(); i++) {
+        auto data = valid;
+        corruptions[i](data);
+        WriteFile(path, data);
+        SeekIndex index;
+        EXPECT_FALSE(index.Open(MEDIA_FILE)) << "corruption " << i;
+        EXPECT_EQ(0u, index.GetCount()) << "corruption " << i;
+
+        // the damaged sidecar is replaced by what this playback indexes
+        index.Add(VIDEO_TRACK, 0, 0);
+        index.Close();
+        ASSERT_TRUE(index.Open(MEDIA_FILE)) << "corruption " << i;
+        EXPECT_EQ(1u, index.GetCount()) << "corruption " << i;
+    }
+}
+HWTEST(TestSeekIndex, bounded_sidecar, TestSize.Level1)
+{
+    PrepareMediaFile();
+    SeekIndex index;
+    EXPECT_FALSE(index.Open(MEDIA_FILE));
+    for (int64_t i = 0; i <= static_cast<int64_t>(SeekIndex::MAX_ENTRIES); i++) {
+        index.Add(VIDEO_TRACK, i * GOP_NS, i * GOP_BYTES);
+    }
+    EXPECT_EQ(SeekIndex::MAX_ENTRIES, index.GetCount());
+    index.Close();
+    ASSERT_TRUE(index.Open(MEDIA_FILE));
+    EXPECT_EQ(SeekIndex::MAX_ENTRIES, index.GetCount());
+
+    // a full index takes no more sync frames
+    index.Add(OTHER_TRACK, 0, 0);
+    EXPECT_EQ(SeekIndex::MAX_ENTRIES, index.GetCount());
+}
+
+HWTEST(TestSeekIndex, concurrent_writers, TestSize.Level1)
+{
+    PrepareMediaFile();
+    constexpr int32_t writers = 4; // 4: players closing the same file at once
+    std::vector<std::unique_ptr<SeekIndex>> indexes;
+    for (int32_t i = 0; i < writers; i++) {
+        indexes.push_back(std::make_unique<SeekIndex>());
+        EXPECT_FALSE(indexes.back()->Open(MEDIA_FILE));
+        indexes.back()->Add(VIDEO_TRACK, i * GOP_NS, i * GOP_BYTES);
+    }
+    std::vector<std::thread> threads;
+    for (auto& index : indexes) {
+        threads.emplace_back([&index] { index->Close(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // the last rename wins as a whole, and no temp file is left behind
+    SeekIndex index;
+    ASSERT_TRUE(index.Open(MEDIA_FILE));
+    EXPECT_EQ(1u, index.GetCount());
+    EXPECT_EQ(1u, CountFiles(INDEX_DIR));
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "gtest/gtest.h"
+#include "pipeline/filters/demux/type_finder.h"
+
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "/data/test/media"
+#endif
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace Pipeline;
+namespace {
+const char* const RESOURCE_FILES[] = {
+    "/MP3/MP3_48000_32_SHORT.mp3",
+    "/MP3/MP3_LONG_48000_32.mp3",
+    "/AAC/AAC_48000_32_SHORT.aac",
+    "/FLAC/vorbis_48000_32_SHORT.flac",
+    "/M4A/MPEG-4_48000_32_SHORT.m4a",
+    "/M4A/MPEG-4_48000_32_LONG.m4a",
+    "/WAV/vorbis_48000_32_SHORT.wav",
+    "/MP4/MPEG2_MP3.mp4",
+};
+
+struct MediaFile {
+    std::vector<uint8_t> data;
+    uint32_t peekTimes {0};
+};
+
+std::shared_ptr<TypeFinder> CreateTypeFinder(const std::string& uri, MediaFile& file)
+{
+    auto typeFinder = std::make_shared<TypeFinder>();
+    auto checkRange = [&file](uint64_t offset, size_t size) { return offset < file.data.size(); };
+    auto peekRange = [&file](uint64_t offset, size_t size, AVBufferPtr& buffer) {
+        file.peekTimes++;
+        if (offset >= file.data.size()) {
+            return false;
+        }
+        auto memory = buffer->IsEmpty() ? buffer->AllocMemory(nullptr, size) : buffer->GetMemory();
+        memory->Write(file.data.data() + offset, std::min<uint64_t>(size, file.data.size() - offset), 0);
+        return true;
+    };
+    typeFinder->Init(uri, file.data.size(), checkRange, peekRange);
+    return typeFinder;
+}
+}
+
+HWTEST(TestTypeFinder, sniff_resources_with_shared_probe_window, TestSize.Level1)
+{
+    for (auto name : RESOURCE_FILES) {
+        std::string uri = std::string(RESOURCE_DIR) + name;
+        std::ifstream stream(uri, std::ios::binary);
+        if (!stream.is_open()) {
+            std::cout << "skip missing resource " << uri << std::endl;
+            continue;
+        }
+        MediaFile file;
+        file.data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        auto typeFinder = CreateTypeFinder(uri, file);
+        auto pluginName = typeFinder->FindMediaType();
+        auto stats = typeFinder->GetSniffStats();
+        ASSERT_FALSE(pluginName.empty()) << uri;
+        ASSERT_EQ(file.peekTimes, stats.sourceReads);
+        std::cout << name << ": " << pluginName << " selected in " << stats.elapsedUs << " us, "
+                  << stats.sniffedPlugins << " plugins sniffed, " << stats.sourceReads << " source reads"
+                  << (stats.cacheHit ? ", cached" : "") << std::endl;
+
+        // opening the same content again is answered by the cache with the probe window read only
+        file.peekTimes = 0;
+        auto reopened = CreateTypeFinder(uri, file);
+        ASSERT_EQ(pluginName, reopened->FindMediaType());
+        ASSERT_TRUE(reopened->GetSniffStats().cacheHit);
+        ASSERT_EQ(0u, reopened->GetSniffStats().sniffedPlugins);
+        ASSERT_EQ(1u, file.peekTimes);
+        std::cout << name << ": reopened in " << reopened->GetSniffStats().elapsedUs << " us" << std::endl;
+    }
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
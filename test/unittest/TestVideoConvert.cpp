@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2023-2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "plugin/convert/video_convert.h"
+#if defined(VIDEO_SUPPORT)
+#include "plugin/convert/ffmpeg_convert.h"
+#endif
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+using namespace Plugin;
+namespace {
+constexpr int32_t MAX_COUNT = 100; // 100: covers the vector widths of every instruction set and their tails
+constexpr int32_t PIXEL_BYTES = 4;
+
+std::vector<uint8_t> RandomBytes(size_t size, uint32_t seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int32_t> dist(0, UINT8_MAX);
+    std::vector<uint8_t> bytes(size);
+    std::generate(bytes.begin(), bytes.end(), [&]() { return static_cast<uint8_t>(dist(engine)); });
+    return bytes;
+}
+
+// bt.601 limited range in the fixed point the kernels use, rgba
+void RefYuvToRgb(int32_t y, int32_t u, int32_t v, uint8_t (&rgba)[PIXEL_BYTES])
+{
+    auto clip = [](int32_t value) { return static_cast<uint8_t>(std::min(std::max((value + 32) >> 6, 0), 255)); };
+    int32_t yc = (y - 16) * 74;                        // 16 74: luma offset and scale
+    rgba[0] = clip(yc + 102 * (v - 128));              // 102 128: v to red, chroma offset
+    rgba[1] = clip(yc - 25 * (u - 128) - 52 * (v - 128)); // 25 52 128: u and v to green, chroma offset
+    rgba[2] = clip(yc + 129 * (u - 128));              // 2 129 128: blue, u to blue, chroma offset
+    rgba[3] = 0xff;                                     // 3: opaque alpha
+}
+} // namespace
+
+HWTEST(TestVideoConvert, interleave_and_deinterleave, TestSize.Level1)
+{
+    std::cout << "video convert kernels: " << VideoConvert::GetInstructionSet() << std::endl;
+    for (int32_t count = 0; count <= MAX_COUNT; count++) {
+        auto first = RandomBytes(count, count);
+        auto second = RandomBytes(count, count + MAX_COUNT);
+        std::vector<uint8_t> interleaved(count * 2); // 2: two planes
+        VideoConvert::InterleavePlanes(first.data(), second.data(), interleaved.data(), count);
+        for (int32_t i = 0; i < count; i++) {
+            ASSERT_EQ(first[i], interleaved[i * 2]);      // 2: two planes
+            ASSERT_EQ(second[i], interleaved[i * 2 + 1]); // 2: two planes
+        }
+        std::vector<uint8_t> firstOut(count);
+        std::vector<uint8_t> secondOut(count);
+        VideoConvert::DeinterleavePlane(interleaved.data(), firstOut.data(), secondOut.data(), count);
+        ASSERT_EQ(first, firstOut);
+        ASSERT_EQ(second, secondOut);
+    }
+}
+
+HWTEST(TestVideoConvert, shuffle_pixels, TestSize.Level1)
+{
+    const uint8_t orders[][PIXEL_BYTES] = {{2, 1, 0, 3}, {3, 0, 1, 2}, {0, 3, 2, 1}, {1, 2, 3, 0}};
+    for (const auto& order : orders) {
+        for (int32_t count = 0; count <= MAX_COUNT; count++) {
+            auto src = RandomBytes(count * PIXEL_BYTES, count);
+            std::vector<uint8_t> dst(count * PIXEL_BYTES);
+            VideoConvert::ShufflePixels(src.data(), dst.data(), order, count);
+            for (int32_t i = 0; i < count * PIXEL_BYTES; i++) {
+                ASSERT_EQ(dst[i], src[i - i % PIXEL_BYTES + order[i % PIXEL_BYTES]]);
+            }
+            // in place, as a sink swaps its frames
+            VideoConvert::ShufflePixels(src.data(), src.data(), order, count);
+            ASSERT_EQ(dst, src);
+        }
+    }
+}
+
+HWTEST(TestVideoConvert, yuv_row_to_rgb, TestSize.Level1)
+{
+    const uint8_t bgra[PIXEL_BYTES] = {VideoConvert::B, VideoConvert::G, VideoConvert::R, VideoConvert::A};
+    for (int32_t width = 0; width <= MAX_COUNT; width++) {
+        auto y = RandomBytes(width, width);
+        auto u = RandomBytes((width + 1) / 2, width + MAX_COUNT);     // 2: chroma is subsampled
+        auto v = RandomBytes((width + 1) / 2, width + MAX_COUNT * 2); // 2: chroma is subsampled, other seed
+        std::vector<uint8_t> dst(width * PIXEL_BYTES);
+        VideoConvert::YuvRowToRgb(y.data(), u.data(), v.data(), dst.data(), bgra, width);
+        for (int32_t i = 0; i < width; i++) {
+            uint8_t rgba[PIXEL_BYTES];
+            RefYuvToRgb(y[i], u[i / 2], v[i / 2], rgba); // 2: chroma is subsampled
+            for (int32_t j = 0; j < PIXEL_BYTES; j++) {
+                ASSERT_EQ(dst[i * PIXEL_BYTES + j], rgba[bgra[j]]) << "width " << width << " pixel " << i;
+            }
+        }
+    }
+}
+
+HWTEST(TestVideoConvert, copy_plane_repack_stride, TestSize.Level1)
+{
+    constexpr int32_t width = 33;
+    constexpr int32_t height = 5;
+    constexpr int32_t srcStride = 48;
+    auto src = RandomBytes(srcStride * height, 1);
+    std::vector<uint8_t> dst(width * height);
+    VideoConvert::CopyPlane(src.data(), srcStride, dst.data(), width, width, height);
+    for (int32_t row = 0; row < height; row++) {
+        ASSERT_TRUE(std::equal(dst.begin() + row * width, dst.begin() + (row + 1) * width,
+                               src.begin() + row * srcStride));
+    }
+}
+
+#if defined(VIDEO_SUPPORT)
+namespace {
+struct Frame {
+    Frame(int32_t width, int32_t height, AVPixelFormat format)
+    {
+        EXPECT_GE(av_image_alloc(data, lineSize, width, height, format, 16), 0); // 16: align
+    }
+    ~Frame()
+    {
+        av_freep(&data[0]);
+    }
+    uint8_t* data[4] {nullptr};
+    int32_t lineSize[4] {0};
+};
+
+void FillYuv420p(Frame& frame, int32_t width, int32_t height)
+{
+    auto bytes = RandomBytes(frame.lineSize[0] * height, width);
+    std::copy(bytes.begin(), bytes.end(), frame.data[0]);
+    for (int32_t i = 1; i <= 2; i++) { // 2: u and v planes
+        bytes = RandomBytes(frame.lineSize[i] * ((height + 1) / 2), width + i); // 2: chroma is subsampled
+        std::copy(bytes.begin(), bytes.end(), frame.data[i]);
+    }
+}
+
+Ffmpeg::ScalePara MakePara(int32_t width, int32_t height, AVPixelFormat src, AVPixelFormat dst)
+{
+    return {width, height, src, width, height, dst, 16}; // 16: align
+}
+} // namespace
+
+HWTEST(TestVideoConvert, scale_without_resize_skips_sws, TestSize.Level1)
+{
+    constexpr int32_t width = 35;
+    constexpr int32_t height = 17;
+    Frame src(width, height, AV_PIX_FMT_YUV420P);
+    FillYuv420p(src, width, height);
+
+    Frame nv21(width, height, AV_PIX_FMT_NV21);
+    Ffmpeg::Scale toNv21;
+    uint8_t* nv21Data[4] {nullptr};
+    int32_t nv21LineSize[4] {0};
+    ASSERT_EQ(Status::OK, toNv21.Init(MakePara(width, height, AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV21), nv21Data,
+                                      nv21LineSize));
+    ASSERT_EQ(Status::OK, toNv21.Convert(src.data, src.lineSize, nv21Data, nv21LineSize));
+    for (int32_t row = 0; row < (height + 1) / 2; row++) { // 2: chroma is subsampled
+        for (int32_t i = 0; i < (width + 1) / 2; i++) {    // 2: chroma is subsampled
+            ASSERT_EQ(nv21Data[1][row * nv21LineSize[1] + i * 2], src.data[2][row * src.lineSize[2] + i]); // 2: v
+            ASSERT_EQ(nv21Data[1][row * nv21LineSize[1] + i * 2 + 1], src.data[1][row * src.lineSize[1] + i]); // 2
+        }
+    }
+
+    Ffmpeg::Scale back;
+    uint8_t* backData[4] {nullptr};
+    int32_t backLineSize[4] {0};
+    ASSERT_EQ(Status::OK, back.Init(MakePara(width, height, AV_PIX_FMT_NV21, AV_PIX_FMT_YUV420P), backData,
+                                    backLineSize));
+    ASSERT_EQ(Status::OK, back.Convert(nv21Data, nv21LineSize, backData, backLineSize));
+    int32_t widths[3] = {width, (width + 1) / 2, (width + 1) / 2};     // 3 2: planes, chroma is subsampled
+    int32_t heights[3] = {height, (height + 1) / 2, (height + 1) / 2}; // 3 2: planes, chroma is subsampled
+    for (int32_t plane = 0; plane < 3; plane++) { // 3: planes
+        for (int32_t row = 0; row < heights[plane]; row++) {
+            ASSERT_TRUE(std::equal(backData[plane] + row * backLineSize[plane],
+                                   backData[plane] + row * backLineSize[plane] + widths[plane],
+                                   src.data[plane] + row * src.lineSize[plane]));
+        }
+    }
+    av_freep(&nv21Data[0]);
+    av_freep(&backData[0]);
+}
+
+HWTEST(TestVideoConvert, benchmark_against_sws, TestSize.Level1)
+{
+    constexpr int32_t runs = 10;
+    const std::pair<int32_t, int32_t> sizes[] = {{1280, 720}, {1920, 1080}, {3840, 2160}};
+    const AVPixelFormat formats[] = {AV_PIX_FMT_NV12, AV_PIX_FMT_RGBA};
+    for (const auto& size : sizes) {
+        Frame src(size.first, size.second, AV_PIX_FMT_YUV420P);
+        FillYuv420p(src, size.first, size.second);
+        for (auto format : formats) {
+            Ffmpeg::Scale scale;
+            uint8_t* dstData[4] {nullptr};
+            int32_t dstLineSize[4] {0};
+            ASSERT_EQ(Status::OK, scale.Init(MakePara(size.first, size.second, AV_PIX_FMT_YUV420P, format), dstData,
+                                             dstLineSize));
+            auto start = std::chrono::steady_clock::now();
+            for (int32_t i = 0; i < runs; i++) {
+                ASSERT_EQ(Status::OK, scale.Convert(src.data, src.lineSize, dstData, dstLineSize));
+            }
+            auto direct = std::chrono::steady_clock::now() - start;
+
+            auto sws = sws_getContext(size.first, size.second, AV_PIX_FMT_YUV420P, size.first, size.second, format,
+                                      SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+            ASSERT_NE(nullptr, sws);
+            start = std::chrono::steady_clock::now();
+            for (int32_t i = 0; i < runs; i++) {
+                ASSERT_GT(sws_scale(sws, src.data, src.lineSize, 0, size.second, dstData, dstLineSize), 0);
+            }
+            auto swsElapsed = std::chrono::steady_clock::now() - start;
+            sws_freeContext(sws);
+            av_freep(&dstData[0]);
+            using Us = std::chrono::microseconds;
+            std::cout << size.first << "x" << size.second << " to " << av_get_pix_fmt_name(format) << ": kernels "
+                      << std::chrono::duration_cast<Us>(direct).count() / runs << " us, sws "
+                      << std::chrono::duration_cast<Us>(swsElapsed).count() / runs << " us" << std::endl;
+        }
+    }
+}
+#endif
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
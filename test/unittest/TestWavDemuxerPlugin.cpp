@@ -13,7 +13,12 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
 #include "gtest/gtest.h"
+#include "foundation/utils/constants.h"
+#include "plugin/common/plugin_time.h"
 #include "plugin/plugins/demuxer/wav_demuxer/wav_demuxer_plugin.h"
 
 using namespace testing::ext;
@@ -23,6 +28,95 @@ using namespace OHOS::Media::Plugin::WavPlugin;
 namespace OHOS {
 namespace Media {
 namespace Test {
+namespace {
+constexpr uint32_t TEST_SAMPLE_RATE = 48000;
+constexpr uint32_t TEST_BLOCK_ALIGN = 4; // 16 bit stereo
+constexpr uint32_t TEST_WAV_HEAD_LEN = 44;
+constexpr uint32_t TEST_DURATION_SEC = 10;
+
+class TestCallback : public Callback {
+public:
+    void OnEvent(const PluginEvent& event) override
+    {
+    }
+};
+
+class MemoryDataSource : public DataSource {
+public:
+    explicit MemoryDataSource(std::vector<uint8_t> data) : data_(std::move(data)) {}
+    Status ReadAt(int64_t offset, std::shared_ptr<Buffer>& buffer, size_t expectedLen) override
+    {
+        if (offset < 0 || static_cast<size_t>(offset) >= data_.size()) {
+            return Status::END_OF_STREAM;
+        }
+        auto memory = buffer->IsEmpty() ? buffer->AllocMemory(nullptr, expectedLen) : buffer->GetMemory();
+        size_t length = std::min({expectedLen, data_.size() - static_cast<size_t>(offset), memory->GetCapacity()});
+        memory->Write(data_.data() + offset, length, 0);
+        return Status::OK;
+    }
+    Status GetSize(uint64_t& size) override
+    {
+        size = data_.size();
+        return Status::OK;
+    }
+    Seekable GetSeekable() override
+    {
+        return Seekable::SEEKABLE;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+template <typename T>
+void PutLe(std::vector<uint8_t>& data, size_t pos, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++) {
+        data[pos + i] = static_cast<uint8_t>(value >> (8 * i)); // 8 bits per byte
+    }
+}
+
+// pcm wav whose sample n carries n in its 4 bytes, so the content of each frame tells its position
+std::vector<uint8_t> MakeWav(uint32_t samples)
+{
+    std::vector<uint8_t> data(TEST_WAV_HEAD_LEN + samples * TEST_BLOCK_ALIGN);
+    memcpy(data.data(), "RIFF", 4); // 4 bytes id
+    PutLe<uint32_t>(data, 4, data.size() - 8); // 4: chunk size, 8: id and size
+    memcpy(data.data() + 8, "WAVEfmt ", 8); // 8: format and fmt id
+    PutLe<uint32_t>(data, 16, 16); // 16: fmt size, 16 bytes fmt chunk
+    PutLe<uint16_t>(data, 20, 1); // 20: audio format, 1 pcm
+    PutLe<uint16_t>(data, 22, 2); // 22: channels, 2 stereo
+    PutLe<uint32_t>(data, 24, TEST_SAMPLE_RATE); // 24: sample rate
+    PutLe<uint32_t>(data, 28, TEST_SAMPLE_RATE * TEST_BLOCK_ALIGN); // 28: byte rate
+    PutLe<uint16_t>(data, 32, TEST_BLOCK_ALIGN); // 32: block align
+    PutLe<uint16_t>(data, 34, 16); // 34: bits per sample, 16
+    memcpy(data.data() + 36, "data", 4); // 36: data id, 4 bytes
+    PutLe<uint32_t>(data, 40, samples * TEST_BLOCK_ALIGN); // 40: data size
+    for (uint32_t i = 0; i < samples; i++) {
+        PutLe<uint32_t>(data, TEST_WAV_HEAD_LEN + i * TEST_BLOCK_ALIGN, i);
+    }
+    return data;
+}
+
+uint32_t FirstSampleOf(Buffer& buffer)
+{
+    uint32_t value = 0;
+    memcpy(&value, buffer.GetMemory()->GetReadOnlyData(), sizeof(value));
+    return value;
+}
+
+std::shared_ptr<WavDemuxerPlugin> PrepareDemuxer(MediaInfo& mediaInfo, uint32_t frameDurationMs)
+{
+    auto demuxer = std::make_shared<WavDemuxerPlugin>("wav");
+    EXPECT_EQ(Status::OK, demuxer->SetParameter(Tag::MEDIA_FRAME_DURATION,
+                                                static_cast<int64_t>(frameDurationMs) * HST_MSECOND));
+    auto source = std::make_shared<MemoryDataSource>(MakeWav(TEST_SAMPLE_RATE * TEST_DURATION_SEC));
+    EXPECT_EQ(Status::OK, demuxer->SetDataSource(source));
+    EXPECT_EQ(Status::OK, demuxer->GetMediaInfo(mediaInfo));
+    return demuxer;
+}
+}
+
 std::shared_ptr<WavDemuxerPlugin> WavDemuxerPluginCreate(const std::string& name)
 {
     return std::make_shared<WavDemuxerPlugin>(name);
@@ -31,7 +125,7 @@ std::shared_ptr<WavDemuxerPlugin> WavDemuxerPluginCreate(const std::string& name
 HWTEST(TestWavDemuxerPlugin, find_wav_demuxer_plugins_process, TestSize.Level1)
 {
     std::shared_ptr<WavDemuxerPlugin> wavDemuxerPlugin = WavDemuxerPluginCreate("process");
-    ASSERT_TRUE(WavDemuxerPlugin != nullptr);
+    ASSERT_TRUE(wavDemuxerPlugin != nullptr);
     auto resetStatus = wavDemuxerPlugin->Reset();
     ASSERT_TRUE(resetStatus == Status::OK);
     auto initStatus = wavDemuxerPlugin->Init();
@@ -82,7 +176,7 @@ HWTEST(TestWavDemuxerPlugin, find_wav_demuxer_plugins_set_parameter, TestSize.Le
     ASSERT_TRUE(wavDemuxerPlugin->SetParameter(Tag::MEDIA_TYPE, MediaType::AUDIO) == Status::ERROR_UNIMPLEMENTED);
     ASSERT_TRUE(wavDemuxerPlugin->SetParameter(Tag::TRACK_ID, 0) == Status::ERROR_UNIMPLEMENTED);
     ASSERT_TRUE(wavDemuxerPlugin->SetParameter(Tag::MIME, MEDIA_MIME_AUDIO_RAW) == Status::ERROR_UNIMPLEMENTED);
-    ASSERT_TRUE(wavDemuxerPlugin->SetParameter(Tag::AUDIO_SAMPLE_FORMAT, AudioSampleFormat::WAVE_FORMAT_PCM)
+    ASSERT_TRUE(wavDemuxerPlugin->SetParameter(Tag::AUDIO_SAMPLE_FORMAT, AudioSampleFormat::S16)
         == Status::ERROR_UNIMPLEMENTED);
     ASSERT_TRUE(wavDemuxerPlugin->SetParameter(Tag::AUDIO_SAMPLE_PER_FRAME, 8192) // sample per frame: 8192
         == Status::ERROR_UNIMPLEMENTED);
@@ -100,8 +194,8 @@ HWTEST(TestWavDemuxerPlugin, find_wav_demuxer_plugins_set_callback, TestSize.Lev
 {
     std::shared_ptr<WavDemuxerPlugin> wavDemuxerPlugin = WavDemuxerPluginCreate("set callback");
     ASSERT_TRUE(wavDemuxerPlugin != nullptr);
-    Callback* cb = new Callback();
-    auto status = wavDemuxerPlugin->SetCallback(cb);
+    TestCallback cb;
+    auto status = wavDemuxerPlugin->SetCallback(&cb);
     ASSERT_TRUE(status == Status::OK);
 }
 
@@ -132,11 +226,100 @@ HWTEST(TestWavDemuxerPlugin, find_wav_demuxer_plugins_get_select_track, TestSize
 {
     std::shared_ptr<WavDemuxerPlugin> wavDemuxerPlugin = WavDemuxerPluginCreate("get select track");
     ASSERT_TRUE(wavDemuxerPlugin != nullptr);
-    std::vector<int32_t> trackIds = new std::vector<int32_t>[1];
+    std::vector<int32_t> trackIds;
     auto selectStatus = wavDemuxerPlugin->GetSelectedTracks(trackIds);
     ASSERT_TRUE(selectStatus == Status::OK);
 }
 
+HWTEST(TestWavDemuxerPlugin, wav_demuxer_frames_share_read_block, TestSize.Level1)
+{
+    for (uint32_t frameDurationMs : {10, 20, 40}) { // 10 20 40 ms per frame
+        MediaInfo mediaInfo;
+        auto demuxer = PrepareDemuxer(mediaInfo, frameDurationMs);
+        uint32_t samplesPerFrame = 0;
+        int64_t duration = 0;
+        ASSERT_TRUE(mediaInfo.tracks[0].Get<Tag::AUDIO_SAMPLE_PER_FRAME>(samplesPerFrame));
+        ASSERT_TRUE(mediaInfo.tracks[0].Get<Tag::MEDIA_DURATION>(duration));
+        ASSERT_EQ(TEST_SAMPLE_RATE / 1000 * frameDurationMs, samplesPerFrame); // 1000 ms per second
+        ASSERT_EQ(TEST_DURATION_SEC * HST_SECOND, duration);
+        uint64_t sample = 0;
+        std::vector<std::shared_ptr<Buffer>> frames;
+        while (true) {
+            auto frame = std::make_shared<Buffer>();
+            auto ret = demuxer->ReadFrame(*frame, 0);
+            if (ret == Status::END_OF_STREAM) {
+                break;
+            }
+            ASSERT_EQ(Status::OK, ret);
+            ASSERT_EQ(sample, FirstSampleOf(*frame));
+            ASSERT_EQ(static_cast<int64_t>(sample * HST_SECOND / TEST_SAMPLE_RATE), frame->pts);
+            sample += frame->GetMemory()->GetSize() / TEST_BLOCK_ALIGN;
+            frames.push_back(frame); // keep frames alive, the blocks they alias must not be overwritten
+        }
+        ASSERT_EQ(TEST_SAMPLE_RATE * TEST_DURATION_SEC, sample);
+        for (auto& frame : frames) {
+            ASSERT_EQ(static_cast<uint32_t>(frame->pts * TEST_SAMPLE_RATE / HST_SECOND), FirstSampleOf(*frame));
+        }
+        auto stats = demuxer->GetReadStats();
+        ASSERT_EQ(0u, stats.bytesCopied);
+        ValueType value;
+        ASSERT_EQ(Status::OK, demuxer->GetParameter(Tag::MEDIA_SOURCE_READS, value));
+        ASSERT_EQ(stats.reads, AnyCast<uint64_t>(value));
+        ASSERT_EQ(Status::OK, demuxer->GetParameter(Tag::MEDIA_SOURCE_READ_BYTES, value));
+        ASSERT_EQ(stats.bytesRead, AnyCast<uint64_t>(value));
+        ASSERT_EQ(Status::OK, demuxer->GetParameter(Tag::MEDIA_SOURCE_READS_PER_SECOND, value));
+        ASSERT_DOUBLE_EQ(stats.readsPerSecond, AnyCast<double>(value));
+        ASSERT_EQ(static_cast<uint64_t>(TEST_SAMPLE_RATE * TEST_DURATION_SEC * TEST_BLOCK_ALIGN), stats.bytesRead);
+        ASSERT_LT(stats.reads, stats.framesOut / 16); // 16: a block of 256 KiB carries dozens of frames
+        ASSERT_LT(stats.readsPerSecond, 2.0); // 2: 192 KB per second of media fits in one block
+        std::cout << frameDurationMs << " ms frames: " << stats.framesOut << " frames, " << stats.reads
+                  << " reads, " << stats.readsPerSecond << " reads per second" << std::endl;
+    }
+}
+
+HWTEST(TestWavDemuxerPlugin, wav_demuxer_copies_into_provided_memory, TestSize.Level1)
+{
+    MediaInfo mediaInfo;
+    auto demuxer = PrepareDemuxer(mediaInfo, 20); // 20 ms per frame
+    Buffer frame;
+    frame.AllocMemory(nullptr, 1000); // 1000 bytes holds 250 whole samples
+    ASSERT_EQ(Status::OK, demuxer->ReadFrame(frame, 0));
+    ASSERT_EQ(1000u, frame.GetMemory()->GetSize());
+    ASSERT_EQ(Status::OK, demuxer->ReadFrame(frame, 0));
+    ASSERT_EQ(250u, FirstSampleOf(frame)); // 250 samples handed out before
+    ASSERT_EQ(2000u, demuxer->GetReadStats().bytesCopied); // 2000: two frames of 1000 bytes
+    ASSERT_EQ(Status::ERROR_INVALID_PARAMETER, demuxer->SetFrameDuration(5)); // 5 ms is too short
+    ASSERT_EQ(Status::ERROR_INVALID_PARAMETER,
+              demuxer->SetParameter(Tag::MEDIA_FRAME_DURATION, static_cast<int64_t>(HST_USECOND))); // not whole ms
+    ASSERT_EQ(Status::ERROR_MISMATCHED_TYPE, demuxer->SetParameter(Tag::MEDIA_FRAME_DURATION, 20)); // int32_t
+    ValueType value;
+    ASSERT_EQ(Status::OK, demuxer->GetParameter(Tag::MEDIA_FRAME_DURATION, value));
+    ASSERT_EQ(20 * HST_MSECOND, AnyCast<int64_t>(value)); // 20: unchanged by the rejected values
+}
+
+HWTEST(TestWavDemuxerPlugin, wav_demuxer_seek_is_sample_exact, TestSize.Level1)
+{
+    MediaInfo mediaInfo;
+    auto demuxer = PrepareDemuxer(mediaInfo, 20); // 20 ms per frame
+    int64_t samplePeriod = HST_SECOND / TEST_SAMPLE_RATE + 1;
+    for (int64_t seekTime = 0; seekTime < TEST_DURATION_SEC * HST_SECOND; seekTime += 123456789) { // arbitrary step
+        int64_t realSeekTime = -1;
+        ASSERT_EQ(Status::OK, demuxer->SeekTo(0, seekTime, SeekMode::SEEK_PREVIOUS_SYNC, realSeekTime));
+        ASSERT_LE(realSeekTime, seekTime);
+        ASSERT_GT(realSeekTime, seekTime - samplePeriod);
+        Buffer frame;
+        ASSERT_EQ(Status::OK, demuxer->ReadFrame(frame, 0));
+        ASSERT_EQ(realSeekTime, frame.pts);
+        ASSERT_EQ(static_cast<uint64_t>(seekTime) * TEST_SAMPLE_RATE / HST_SECOND, FirstSampleOf(frame));
+    }
+    int64_t realSeekTime = -1;
+    ASSERT_EQ(Status::OK, demuxer->SeekTo(0, TEST_DURATION_SEC * HST_SECOND * 2, SeekMode::SEEK_PREVIOUS_SYNC,
+                                          realSeekTime)); // 2: beyond the end
+    ASSERT_EQ(TEST_DURATION_SEC * HST_SECOND, realSeekTime);
+    Buffer frame;
+    ASSERT_EQ(Status::END_OF_STREAM, demuxer->ReadFrame(frame, 0));
+}
+
 } // namespace Test
 } // namespace Media
 } // namespace OHOS
\ No newline at end of file
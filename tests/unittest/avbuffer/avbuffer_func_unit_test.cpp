@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include "allocation_counter.h"
 #include "av_hardware_memory.h"
 #include "av_shared_allocator.h"
 #include "av_shared_memory_ext.h"
@@ -283,6 +284,52 @@ HWTEST_F(AVBufferInnerUnitTest, AVBuffer_CreateWithInvalid_003, TestSize.Level1)
     EXPECT_NE(nullptr, buffer_);
 }
 
+/**
+ * @tc.name: AVBuffer_CreateAllocator_001
+ * @tc.desc: allocators without per config state are shared
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferInnerUnitTest, AVBuffer_CreateAllocator_001, TestSize.Level1)
+{
+    EXPECT_EQ(AVAllocatorFactory::CreateVirtualAllocator(), AVAllocatorFactory::CreateVirtualAllocator());
+
+    auto readWrite = AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_WRITE);
+    auto readOnly = AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_ONLY);
+    EXPECT_EQ(readWrite, AVAllocatorFactory::CreateSharedAllocator(MemoryFlag::MEMORY_READ_WRITE));
+    ASSERT_NE(readWrite, readOnly);
+    EXPECT_EQ(std::static_pointer_cast<AVSharedAllocator>(readWrite)->GetMemFlag(), MemoryFlag::MEMORY_READ_WRITE);
+    EXPECT_EQ(std::static_pointer_cast<AVSharedAllocator>(readOnly)->GetMemFlag(), MemoryFlag::MEMORY_READ_ONLY);
+}
+
+/**
+ * @tc.name: AVBuffer_CreateAllocations_001
+ * @tc.desc: count the heap allocations of creating a virtual memory buffer
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferInnerUnitTest, AVBuffer_CreateAllocations_001, TestSize.Level1)
+{
+    AVBufferConfig config;
+    config.size = MEMSIZE;
+    config.memoryType = MemoryType::VIRTUAL_MEMORY;
+    buffer_ = AVBuffer::CreateAVBuffer(config);
+    ASSERT_NE(nullptr, buffer_);
+    buffer_ = nullptr;
+
+    size_t allocations = 0;
+    {
+        Test::AllocationCounter counter;
+        for (int32_t i = 0; i < TEST_LOOP_DEPTH; ++i) {
+            buffer_ = AVBuffer::CreateAVBuffer(config);
+        }
+        allocations = counter.Count();
+    }
+    ASSERT_NE(nullptr, buffer_);
+    ASSERT_NE(nullptr, buffer_->meta_);
+    // 6: buffer, its control block, surface config, memory with its control block, data and meta
+    EXPECT_LE(allocations, static_cast<size_t>(6 * TEST_LOOP_DEPTH));
+    EXPECT_TRUE(buffer_->memory_->name_.empty());
+}
+
 /**
  * @tc.name: AVBuffer_CreateWithInvalid_004
  * @tc.desc: create hardware memory with invalid allocator
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <gtest/gtest.h>
+#include "buffer/avbuffer_queue.h"
+#include "buffer/avbuffer_queue_consumer.h"
+#include "buffer/avbuffer_queue_producer_proxy.h"
+#include "ipc_object_stub.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace AVBufferUT {
+namespace {
+constexpr uint32_t QUEUE_SIZE = 8;
+constexpr int32_t FRAME_SIZE = 1024;      // 1024: a small compressed audio frame
+constexpr int32_t FRAME_COUNT = 4096;
+constexpr int64_t FRAME_DURATION = 21333; // 21333: 1024 samples at 48kHz, us
+constexpr int32_t AVAILABLE_TIMEOUT_MS = 1000;
+
+// in process loopback to the producer stub, counts the transactions and the bytes they carry
+class CountingRemoteObject : public IPCObjectStub {
+public:
+    explicit CountingRemoteObject(const sptr<IRemoteObject>& target)
+        : IPCObjectStub(target->GetObjectDescriptor()), target_(target) {}
+
+    int SendRequest(uint32_t code, MessageParcel& data, MessageParcel& reply, MessageOption& option) override
+    {
+        transactions_++;
+        int ret = target_->SendRequest(code, data, reply, option);
+        bytes_ += data.GetDataSize() + reply.GetDataSize();
+        return ret;
+    }
+
+    sptr<IRemoteObject> target_;
+    uint64_t transactions_ = 0;
+    uint64_t bytes_ = 0;
+};
+
+// buffers pushed through the ring reach the queue on its own thread, the consumer waits for them
+class ConsumerListener : public IConsumerListener {
+public:
+    void OnBufferAvailable() override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        available_++;
+        cond_.notify_all();
+    }
+
+    bool WaitAvailable()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!cond_.wait_for(lock, std::chrono::milliseconds(AVAILABLE_TIMEOUT_MS), [this] { return available_ > 0; })) {
+            return false;
+        }
+        available_--;
+        return true;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    uint32_t available_ = 0;
+};
+
+class AVBufferQueueIpcUnitTest : public testing::Test {
+public:
+    void SetUp(void)
+    {
+        CreateQueue(AVBufferQueueTransport::BINDER);
+        config_.size = FRAME_SIZE;
+        config_.memoryType = MemoryType::SHARED_MEMORY;
+        frame_.resize(FRAME_SIZE, 0x5a); // 0x5a: any payload
+    }
+
+    void TearDown(void)
+    {
+        producer_ = nullptr;
+        remote_ = nullptr;
+        consumer_ = nullptr;
+        listener_ = nullptr;
+        queue_ = nullptr;
+    }
+
+    void CreateQueue(AVBufferQueueTransport transport)
+    {
+        TearDown();
+        queue_ = AVBufferQueue::Create(QUEUE_SIZE, MemoryType::SHARED_MEMORY, "ipc_test", false, transport);
+        ASSERT_NE(nullptr, queue_);
+        consumer_ = queue_->GetLocalConsumer();
+        listener_ = new ConsumerListener();
+        sptr<IConsumerListener> listener = listener_;
+        ASSERT_EQ(Status::OK, consumer_->SetBufferAvailableListener(listener));
+        remote_ = new CountingRemoteObject(queue_->GetProducer()->AsObject());
+        producer_ = AVBufferQueueProducerProxy::Create(remote_);
+        ASSERT_NE(nullptr, producer_);
+    }
+
+    void Transfer(int32_t count)
+    {
+        for (int32_t i = 0; i < count; i++) {
+            std::shared_ptr<AVBuffer> buffer = nullptr;
+            ASSERT_EQ(Status::OK, producer_->RequestBuffer(buffer, config_, AVAILABLE_TIMEOUT_MS));
+            Fill(buffer);
+            ASSERT_EQ(Status::OK, producer_->PushBuffer(buffer, true));
+            Consume(1);
+        }
+    }
+
+    void ResetCount()
+    {
+        remote_->transactions_ = 0;
+        remote_->bytes_ = 0;
+    }
+
+    void Fill(const std::shared_ptr<AVBuffer>& buffer)
+    {
+        buffer->memory_->Write(frame_.data(), FRAME_SIZE, 0);
+        buffer->pts_ = pts_;
+        pts_ += FRAME_DURATION;
+    }
+
+    void Consume(int32_t count)
+    {
+        for (int32_t i = 0; i < count; i++) {
+            std::shared_ptr<AVBuffer> buffer = nullptr;
+            ASSERT_TRUE(listener_->WaitAvailable());
+            ASSERT_EQ(Status::OK, consumer_->AcquireBuffer(buffer));
+            EXPECT_EQ(buffer->pts_, consumed_);
+            EXPECT_EQ(buffer->memory_->GetSize(), FRAME_SIZE);
+            consumed_ += FRAME_DURATION;
+            ASSERT_EQ(Status::OK, consumer_->ReleaseBuffer(buffer));
+        }
+    }
+
+    void Report(const std::string& name, std::chrono::steady_clock::duration elapsed)
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        std::cout << name << ": " << remote_->transactions_ * 1000000 / std::max<int64_t>(us, 1)
+                  << " transactions/s, " << remote_->transactions_ << " transactions, "
+                  << remote_->bytes_ / FRAME_COUNT << " bytes/frame" << std::endl;
+    }
+
+    std::shared_ptr<AVBufferQueue> queue_ = nullptr;
+    std::shared_ptr<AVBufferQueueConsumer> consumer_ = nullptr;
+    sptr<ConsumerListener> listener_ = nullptr;
+    sptr<CountingRemoteObject> remote_ = nullptr;
+    std::shared_ptr<AVBufferQueueProducerProxy> producer_ = nullptr;
+    AVBufferConfig config_;
+    std::vector<uint8_t> frame_;
+    int64_t pts_ = 0;
+    int64_t consumed_ = 0;
+};
+} // namespace
+
+/**
+ * @tc.name: AVBufferQueue_Ipc_Known_Buffer_001
+ * @tc.desc: a buffer the proxy has mapped is requested again with its attributes only
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferQueueIpcUnitTest, AVBufferQueue_Ipc_Known_Buffer_001, TestSize.Level1)
+{
+    std::shared_ptr<AVBuffer> first = nullptr;
+    ASSERT_EQ(Status::OK, producer_->RequestBuffer(first, config_, 0));
+    auto firstBytes = remote_->bytes_;
+    Fill(first);
+    ASSERT_EQ(Status::OK, producer_->PushBuffer(first, true));
+    Consume(1);
+
+    remote_->bytes_ = 0;
+    std::shared_ptr<AVBuffer> second = nullptr;
+    ASSERT_EQ(Status::OK, producer_->RequestBuffer(second, config_, 0));
+    EXPECT_EQ(first, second);
+    EXPECT_LT(remote_->bytes_, firstBytes);
+    Fill(second);
+    ASSERT_EQ(Status::OK, producer_->PushBuffer(second, true));
+    Consume(1);
+}
+
+/**
+ * @tc.name: AVBufferQueue_Ipc_Benchmark_001
+ * @tc.desc: transfer small frames one by one and in batches of the queue size
+ * @tc.type: PERF
+ */
+HWTEST_F(AVBufferQueueIpcUnitTest, AVBufferQueue_Ipc_Benchmark_001, TestSize.Level1)
+{
+    // the first frame also asks for the ring, which a queue using binder refuses
+    Transfer(1);
+    ResetCount();
+    auto start = std::chrono::steady_clock::now();
+    Transfer(FRAME_COUNT);
+    Report("single", std::chrono::steady_clock::now() - start);
+    auto singleTransactions = remote_->transactions_;
+    auto singleBytes = remote_->bytes_;
+
+    ResetCount();
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < FRAME_COUNT; i += static_cast<int32_t>(QUEUE_SIZE)) {
+        std::vector<std::shared_ptr<AVBuffer>> buffers;
+        ASSERT_EQ(Status::OK, producer_->RequestBuffers(buffers, QUEUE_SIZE, config_, 0));
+        ASSERT_EQ(buffers.size(), QUEUE_SIZE);
+        for (auto& buffer : buffers) {
+            Fill(buffer);
+        }
+        ASSERT_EQ(Status::OK, producer_->PushBuffers(buffers, true));
+        Consume(static_cast<int32_t>(QUEUE_SIZE));
+    }
+    Report("batched", std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(remote_->transactions_ * QUEUE_SIZE, singleTransactions);
+    EXPECT_LT(remote_->bytes_, singleBytes);
+}
+
+/**
+ * @tc.name: AVBufferQueue_Ipc_Ring_001
+ * @tc.desc: transfer small frames through the shared ring, binder only maps the buffers
+ * @tc.type: PERF
+ */
+HWTEST_F(AVBufferQueueIpcUnitTest, AVBufferQueue_Ipc_Ring_001, TestSize.Level1)
+{
+    CreateQueue(AVBufferQueueTransport::SHARED_RING);
+    auto start = std::chrono::steady_clock::now();
+    Transfer(FRAME_COUNT);
+    Report("ring", std::chrono::steady_clock::now() - start);
+    // opening the ring and mapping the buffers, no frame takes a transaction of its own
+    EXPECT_LE(remote_->transactions_, QUEUE_SIZE + 1);
+
+    // a second producer gets no ring and keeps using binder
+    auto producer = AVBufferQueueProducerProxy::Create(remote_);
+    ASSERT_NE(nullptr, producer);
+    ResetCount();
+    std::shared_ptr<AVBuffer> buffer = nullptr;
+    ASSERT_EQ(Status::OK, producer->RequestBuffer(buffer, config_, AVAILABLE_TIMEOUT_MS));
+    Fill(buffer);
+    ASSERT_EQ(Status::OK, producer->PushBuffer(buffer, true));
+    Consume(1);
+    EXPECT_GT(remote_->transactions_, 0);
+}
+
+/**
+ * @tc.name: AVBufferQueue_Ipc_Ring_Close_001
+ * @tc.desc: the buffers handed to the ring go back to the queue once its producer is gone, a local producer
+ *           waits for them instead of being sent to the ring
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferQueueIpcUnitTest, AVBufferQueue_Ipc_Ring_Close_001, TestSize.Level1)
+{
+    CreateQueue(AVBufferQueueTransport::SHARED_RING);
+    Transfer(QUEUE_SIZE);
+    auto producer = queue_->GetLocalProducer();
+    ASSERT_NE(nullptr, producer);
+    std::vector<std::shared_ptr<AVBuffer>> buffers;
+    std::shared_ptr<AVBuffer> buffer = nullptr;
+    Status ret = Status::OK;
+    while ((ret = producer->RequestBuffer(buffer, config_, 0)) == Status::OK) {
+        buffers.emplace_back(buffer);
+    }
+    EXPECT_EQ(Status::ERROR_NO_FREE_BUFFER, ret);
+    EXPECT_LT(buffers.size(), QUEUE_SIZE);
+
+    producer_ = nullptr;
+    while (producer->RequestBuffer(buffer, config_, 0) == Status::OK) {
+        buffers.emplace_back(buffer);
+    }
+    EXPECT_EQ(buffers.size(), QUEUE_SIZE);
+}
+} // namespace AVBufferUT
+} // namespace Media
+} // namespace OHOS
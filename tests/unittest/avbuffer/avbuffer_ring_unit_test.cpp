@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "avbuffer_ring.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace AVBufferUT {
+namespace {
+constexpr uint32_t SLOT_COUNT = 8;
+constexpr int32_t ENTRY_COUNT = 100000;
+constexpr int32_t WAIT_TIMEOUT_MS = 20;
+constexpr int32_t CHILD_TIMEOUT_MS = 5000;
+
+class AVBufferRingUnitTest : public testing::Test {
+public:
+    void SetUp(void)
+    {
+        ring_ = AVBufferRing::Create(SLOT_COUNT);
+        ASSERT_NE(nullptr, ring_);
+    }
+
+    void TearDown(void)
+    {
+        ring_ = nullptr;
+    }
+
+    // map the ring a second time, as the process of the peer does
+    std::shared_ptr<AVBufferRing> OpenPeer()
+    {
+        int32_t eventFds[AVBufferRing::CHANNEL_COUNT] = {
+            dup(ring_->GetEventFd(AVBufferRing::TO_QUEUE)), dup(ring_->GetEventFd(AVBufferRing::TO_PRODUCER))};
+        return AVBufferRing::Open(dup(ring_->GetMemFd()), eventFds);
+    }
+
+    std::shared_ptr<AVBufferRing> ring_ = nullptr;
+};
+
+AVBufferRingEntry MakeEntry(uint64_t uniqueId)
+{
+    AVBufferRingEntry entry;
+    entry.uniqueId = uniqueId;
+    entry.attr.pts = static_cast<int64_t>(uniqueId) * 2; // 2: any pts derived from the id
+    entry.attr.size = static_cast<int32_t>(uniqueId % 1024); // 1024: any size derived from the id
+    return entry;
+}
+} // namespace
+
+/**
+ * @tc.name: AVBufferRing_Push_Pop_001
+ * @tc.desc: entries are popped in the order they are pushed, a full channel refuses a push
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferRingUnitTest, AVBufferRing_Push_Pop_001, TestSize.Level1)
+{
+    auto peer = OpenPeer();
+    ASSERT_NE(nullptr, peer);
+    EXPECT_EQ(peer->GetSlotCount(), SLOT_COUNT);
+    for (uint64_t round = 0; round < 3; round++) { // 3: wrap around the slots a few times
+        for (uint64_t i = 0; i < SLOT_COUNT; i++) {
+            EXPECT_TRUE(ring_->Push(AVBufferRing::TO_QUEUE, MakeEntry(round * SLOT_COUNT + i)));
+        }
+        EXPECT_FALSE(ring_->Push(AVBufferRing::TO_QUEUE, MakeEntry(0)));
+        EXPECT_EQ(peer->GetCount(AVBufferRing::TO_QUEUE), SLOT_COUNT);
+        EXPECT_EQ(peer->GetCount(AVBufferRing::TO_PRODUCER), 0);
+        for (uint64_t i = 0; i < SLOT_COUNT; i++) {
+            AVBufferRingEntry entry;
+            ASSERT_TRUE(peer->Pop(AVBufferRing::TO_QUEUE, entry, 0));
+            EXPECT_EQ(entry.uniqueId, round * SLOT_COUNT + i);
+            EXPECT_EQ(entry.attr.pts, MakeEntry(entry.uniqueId).attr.pts);
+            EXPECT_EQ(entry.attr.size, MakeEntry(entry.uniqueId).attr.size);
+        }
+        AVBufferRingEntry entry;
+        EXPECT_FALSE(peer->Pop(AVBufferRing::TO_QUEUE, entry, 0));
+    }
+}
+
+/**
+ * @tc.name: AVBufferRing_Open_001
+ * @tc.desc: memory that is not a ring is refused
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferRingUnitTest, AVBufferRing_Open_001, TestSize.Level1)
+{
+    int32_t eventFds[AVBufferRing::CHANNEL_COUNT] = {-1, -1};
+    EXPECT_EQ(nullptr, AVBufferRing::Open(-1, eventFds));
+    EXPECT_EQ(nullptr, AVBufferRing::Create(0));
+}
+
+/**
+ * @tc.name: AVBufferRing_Error_001
+ * @tc.desc: an error reported by one side is taken once by the other, a later slot count in the memory is ignored
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferRingUnitTest, AVBufferRing_Error_001, TestSize.Level1)
+{
+    auto peer = OpenPeer();
+    ASSERT_NE(nullptr, peer);
+    EXPECT_EQ(0, peer->TakeError());
+    ring_->SetError(-1);
+    EXPECT_EQ(-1, peer->TakeError());
+    EXPECT_EQ(0, peer->TakeError());
+
+    // a peer rewrites the slot count of the header, which follows the magic
+    void* addr = mmap(nullptr, sizeof(uint32_t) * 2, PROT_READ | PROT_WRITE, MAP_SHARED, ring_->GetMemFd(), 0);
+    ASSERT_NE(MAP_FAILED, addr);
+    static_cast<uint32_t*>(addr)[1] = SLOT_COUNT * 1024; // 1024: far beyond the mapped slots
+    (void)munmap(addr, sizeof(uint32_t) * 2);
+    EXPECT_EQ(peer->GetSlotCount(), SLOT_COUNT);
+    for (uint64_t i = 0; i < SLOT_COUNT; i++) {
+        EXPECT_TRUE(peer->Push(AVBufferRing::TO_PRODUCER, MakeEntry(i)));
+    }
+    EXPECT_FALSE(peer->Push(AVBufferRing::TO_PRODUCER, MakeEntry(0)));
+}
+
+/**
+ * @tc.name: AVBufferRing_Timeout_001
+ * @tc.desc: pop from an empty channel returns after the timeout
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferRingUnitTest, AVBufferRing_Timeout_001, TestSize.Level1)
+{
+    AVBufferRingEntry entry;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(ring_->Pop(AVBufferRing::TO_PRODUCER, entry, WAIT_TIMEOUT_MS));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(WAIT_TIMEOUT_MS));
+}
+
+/**
+ * @tc.name: AVBufferRing_Wakeup_001
+ * @tc.desc: a blocked pop returns the entry pushed meanwhile, or false once woken up
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVBufferRingUnitTest, AVBufferRing_Wakeup_001, TestSize.Level1)
+{
+    auto peer = OpenPeer();
+    ASSERT_NE(nullptr, peer);
+    AVBufferRingEntry entry;
+    std::thread writer([this]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_TIMEOUT_MS));
+        ring_->Push(AVBufferRing::TO_QUEUE, MakeEntry(1));
+    });
+    EXPECT_TRUE(peer->Pop(AVBufferRing::TO_QUEUE, entry, -1));
+    EXPECT_EQ(entry.uniqueId, 1);
+    writer.join();
+
+    std::thread waker([&peer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_TIMEOUT_MS));
+        peer->Wakeup(AVBufferRing::TO_QUEUE);
+    });
+    EXPECT_FALSE(peer->Pop(AVBufferRing::TO_QUEUE, entry, -1));
+    waker.join();
+}
+
+/**
+ * @tc.name: AVBufferRing_Process_001
+ * @tc.desc: pass entries to another process and back, without a binder transaction
+ * @tc.type: PERF
+ */
+HWTEST_F(AVBufferRingUnitTest, AVBufferRing_Process_001, TestSize.Level1)
+{
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // the child returns every entry it gets, as a producer requests and pushes the same buffers again
+        auto peer = OpenPeer();
+        int32_t count = 0;
+        AVBufferRingEntry entry;
+        while (peer != nullptr && count < ENTRY_COUNT && peer->Pop(AVBufferRing::TO_QUEUE, entry, CHILD_TIMEOUT_MS)) {
+            entry.attr.pts++;
+            while (!peer->Push(AVBufferRing::TO_PRODUCER, entry)) {
+                std::this_thread::yield();
+            }
+            count++;
+        }
+        _exit(count == ENTRY_COUNT ? 0 : 1);
+    }
+
+    int32_t pushed = 0;
+    int32_t popped = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (popped < ENTRY_COUNT) {
+        // keep half the slots in flight, the way a queue and its producer cycle their buffers
+        while (pushed < ENTRY_COUNT && pushed - popped < static_cast<int32_t>(SLOT_COUNT / 2)) {
+            ASSERT_TRUE(ring_->Push(AVBufferRing::TO_QUEUE, MakeEntry(static_cast<uint64_t>(pushed))));
+            pushed++;
+        }
+        AVBufferRingEntry entry;
+        ASSERT_TRUE(ring_->Pop(AVBufferRing::TO_PRODUCER, entry, CHILD_TIMEOUT_MS));
+        ASSERT_EQ(entry.uniqueId, static_cast<uint64_t>(popped));
+        ASSERT_EQ(entry.attr.pts, MakeEntry(entry.uniqueId).attr.pts + 1);
+        popped++;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    std::cout << "ring: " << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / ENTRY_COUNT
+              << " ns/entry round trip" << std::endl;
+}
+} // namespace AVBufferUT
+} // namespace Media
+} // namespace OHOS
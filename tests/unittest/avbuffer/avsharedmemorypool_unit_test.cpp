@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/avsharedmemorypool.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace OHOS {
+namespace Media {
+namespace AVBufferUT {
+namespace {
+constexpr int32_t MEM_SIZE = 1024;
+constexpr uint32_t MAX_MEM_CNT = 2;
+constexpr int32_t RELEASE_DELAY_MS = 20;
+
+class AVSharedMemoryPoolUnitTest : public testing::Test {
+public:
+    void SetUp(void)
+    {
+        pool_ = std::make_shared<AVSharedMemoryPool>("AVSharedMemoryPoolUnitTest");
+    }
+
+    void TearDown(void)
+    {
+        pool_ = nullptr;
+    }
+
+    AVSharedMemoryPool::InitializeOption FixedSizeOption()
+    {
+        AVSharedMemoryPool::InitializeOption option;
+        option.preAllocMemCnt = MAX_MEM_CNT;
+        option.memSize = MEM_SIZE;
+        option.maxMemCnt = MAX_MEM_CNT;
+        option.enableFixedSize = true;
+        return option;
+    }
+
+    std::shared_ptr<AVSharedMemoryPool> pool_ = nullptr;
+};
+} // namespace
+
+/**
+ * @tc.name: AVSharedMemoryPool_Reuse_001
+ * @tc.desc: released blocks go back to the pool and serve later acquires, as counted by the metrics
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, AVSharedMemoryPool_Reuse_001, TestSize.Level1)
+{
+    ASSERT_EQ(0, pool_->Init(FixedSizeOption()));
+    AVSharedMemory *first = nullptr;
+    {
+        auto memory = pool_->AcquireMemory();
+        ASSERT_NE(nullptr, memory);
+        first = memory.get();
+        EXPECT_EQ(MEM_SIZE, memory->GetSize());
+    }
+    auto memory = pool_->AcquireMemory();
+    EXPECT_EQ(first, memory.get());
+    auto another = pool_->AcquireMemory();
+    ASSERT_NE(nullptr, another);
+    EXPECT_EQ(nullptr, pool_->AcquireMemory(-1, false));
+    EXPECT_EQ(nullptr, pool_->AcquireMemory(MEM_SIZE + 1, false));
+
+    auto metrics = pool_->GetMetrics();
+    EXPECT_EQ(4u, metrics.acquireCount); // 4: the acquire with an invalid size is not counted
+    EXPECT_EQ(3u, metrics.hitCount);     // 3: all served by preallocated blocks
+    EXPECT_EQ(0u, metrics.allocCount);
+    EXPECT_EQ(1u, metrics.failCount);
+    EXPECT_EQ(0u, metrics.waitCount);
+}
+
+/**
+ * @tc.name: AVSharedMemoryPool_BestFit_001
+ * @tc.desc: without fixed size an acquire takes the smallest idle block which is large enough
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, AVSharedMemoryPool_BestFit_001, TestSize.Level1)
+{
+    AVSharedMemoryPool::InitializeOption option;
+    option.maxMemCnt = 3; // 3: one block of each size below
+    option.enableFixedSize = false;
+    ASSERT_EQ(0, pool_->Init(option));
+    {
+        auto small = pool_->AcquireMemory(100);        // 100: smaller than requested below
+        auto middle = pool_->AcquireMemory(1000);      // 1000: the best fit of the request below
+        auto large = pool_->AcquireMemory(10000);      // 10000: fits, but wastes more
+        ASSERT_TRUE(small != nullptr && middle != nullptr && large != nullptr);
+    }
+    auto memory = pool_->AcquireMemory(900); // 900: fits in the block of 1000 and the one of 10000
+    ASSERT_NE(nullptr, memory);
+    EXPECT_EQ(1000, memory->GetSize());
+    // the pool is full and no idle block fits, the smallest idle block is freed for a new one
+    auto huge = pool_->AcquireMemory(20000, false); // 20000: larger than any block
+    ASSERT_NE(nullptr, huge);
+    EXPECT_EQ(20000, huge->GetSize());
+    EXPECT_EQ(1u, pool_->idleMems_.size());
+    EXPECT_EQ(10000, pool_->idleMems_.begin()->first);
+
+    auto metrics = pool_->GetMetrics();
+    EXPECT_EQ(1u, metrics.hitCount);
+    EXPECT_EQ(4u, metrics.allocCount); // 4: three to fill the pool, one to replace the smallest
+}
+
+/**
+ * @tc.name: AVSharedMemoryPool_Reset_001
+ * @tc.desc: blocks still busy at a reset do not count against the reinitialized pool and are freed on release
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, AVSharedMemoryPool_Reset_001, TestSize.Level1)
+{
+    ASSERT_EQ(0, pool_->Init(FixedSizeOption()));
+    std::vector<std::shared_ptr<AVSharedMemory>> oldMemories;
+    for (uint32_t i = 0; i < MAX_MEM_CNT; i++) {
+        oldMemories.push_back(pool_->AcquireMemory());
+        ASSERT_NE(nullptr, oldMemories.back());
+    }
+    pool_->Reset();
+    EXPECT_EQ(0u, pool_->busyCnt_);
+
+    auto option = FixedSizeOption();
+    option.preAllocMemCnt = 0;
+    ASSERT_EQ(0, pool_->Init(option));
+    std::vector<std::shared_ptr<AVSharedMemory>> newMemories;
+    for (uint32_t i = 0; i < MAX_MEM_CNT; i++) {
+        newMemories.push_back(pool_->AcquireMemory(-1, false));
+        ASSERT_NE(nullptr, newMemories.back());
+    }
+    EXPECT_EQ(MAX_MEM_CNT, pool_->busyCnt_);
+
+    oldMemories.clear();
+    EXPECT_EQ(MAX_MEM_CNT, pool_->busyCnt_);
+    EXPECT_TRUE(pool_->idleMems_.empty());
+    newMemories.clear();
+    EXPECT_EQ(0u, pool_->busyCnt_);
+    EXPECT_EQ(MAX_MEM_CNT, pool_->idleMems_.size());
+}
+
+/**
+ * @tc.name: AVSharedMemoryPool_Wait_001
+ * @tc.desc: a blocking acquire on a full pool waits for a release, and the metrics measure the wait
+ * @tc.type: FUNC
+ */
+HWTEST_F(AVSharedMemoryPoolUnitTest, AVSharedMemoryPool_Wait_001, TestSize.Level1)
+{
+    ASSERT_EQ(0, pool_->Init(FixedSizeOption()));
+    auto first = pool_->AcquireMemory();
+    auto second = pool_->AcquireMemory();
+    ASSERT_TRUE(first != nullptr && second != nullptr);
+    AVSharedMemory *released = first.get();
+    std::thread releaser([&first]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(RELEASE_DELAY_MS));
+        first = nullptr;
+    });
+    auto memory = pool_->AcquireMemory();
+    releaser.join();
+    EXPECT_EQ(released, memory.get());
+
+    auto metrics = pool_->GetMetrics();
+    EXPECT_EQ(1u, metrics.waitCount);
+    EXPECT_GE(metrics.maxWaitUs, static_cast<uint64_t>(RELEASE_DELAY_MS / 2) * 1000); // 2: scheduling margin
+    EXPECT_EQ(metrics.maxWaitUs, metrics.totalWaitUs);
+    EXPECT_EQ(0u, metrics.failCount);
+
+    pool_->SetNonBlocking(true);
+    EXPECT_EQ(nullptr, pool_->AcquireMemory());
+    EXPECT_EQ(1u, pool_->GetMetrics().failCount);
+}
+} // namespace AVBufferUT
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local bool g_countAllocations = false;
+thread_local size_t g_allocations = 0;
+} // namespace
+
+// every replaceable form is defined here so that array and sized deletes always pair with these news
+void *operator new(size_t size)
+{
+    if (g_countAllocations) {
+        ++g_allocations;
+    }
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    if (g_countAllocations) {
+        ++g_allocations;
+    }
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+namespace OHOS {
+namespace Media {
+namespace Test {
+AllocationCounter::AllocationCounter()
+{
+    g_allocations = 0;
+    g_countAllocations = true;
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    g_countAllocations = false;
+}
+
+size_t AllocationCounter::Count() const
+{
+    return g_allocations;
+}
+} // namespace Test
+} // namespace Media
+} // namespace OHOS
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "plugin/plugin_manager.h"
+#include "plugin/plugin_manifest.h"
+#include "plugin/plugin_register.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::Media;
+using namespace OHOS::Media::Plugins;
+
+namespace OHOS {
+namespace Media {
+namespace PluginManifestUT {
+namespace {
+const std::string MANIFEST_PATH = "/data/test/media_plugins_ut.manifest";
+
+struct UnknownValue {
+    int32_t value;
+};
+
+std::shared_ptr<PluginInfo> MakeCodecInfo()
+{
+    auto info = std::make_shared<PluginInfo>();
+    info->apiVersion = 1;
+    info->pluginType = PluginType::AUDIO_DECODER;
+    info->name = "ut decoder";
+    info->description = "100% test, ~not real~\n";
+    info->rank = 100; // 100: rank
+    info->extra[PLUGIN_INFO_EXTRA_CODEC_MODE] = CodecMode::HARDWARE;
+    Capability inCap(MimeType::AUDIO_MPEG);
+    inCap.AppendFixedKey<uint32_t>(Tag::AUDIO_MPEG_VERSION, 1);
+    inCap.AppendIntervalKey<uint32_t>(Tag::AUDIO_SAMPLE_RATE, 8000, 48000); // 8000, 48000: sample rate range
+    inCap.AppendDiscreteKeys<AudioSampleFormat>(Tag::AUDIO_SAMPLE_FORMAT,
+        {AudioSampleFormat::SAMPLE_S16LE, AudioSampleFormat::SAMPLE_F32LE});
+    info->inCaps.push_back(inCap);
+    Capability outCap(MimeType::AUDIO_RAW);
+    outCap.AppendFixedKey<std::string>("ut.empty", "");
+    info->outCaps.push_back(outCap);
+    return info;
+}
+
+int64_t GetRssKb()
+{
+    std::ifstream statm("/proc/self/statm");
+    int64_t pages = 0;
+    int64_t residentPages = 0;
+    statm >> pages >> residentPages;
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024); // 1024: kb
+}
+
+int32_t CountMappedPluginLibraries()
+{
+    std::ifstream maps("/proc/self/maps");
+    std::set<std::string> libraries;
+    std::string line;
+    while (std::getline(maps, line)) {
+        auto pos = line.find("libmedia_plugin_");
+        if (pos != std::string::npos) {
+            libraries.insert(line.substr(pos));
+        }
+    }
+    return static_cast<int32_t>(libraries.size());
+}
+
+struct ColdStartResult {
+    int64_t elapsedUs {0};
+    int64_t rssKb {0};
+    int32_t pluginCount {0};
+    int32_t mappedLibraries {0};
+    int32_t mappedAfterCreate {0};
+    bool created {false};
+};
+
+// cold start is measured in a child process so that neither mode benefits from libraries mapped by the other
+ColdStartResult MeasureColdStart(const std::string& manifestPath)
+{
+    ColdStartResult result;
+    int fds[2] = {-1, -1}; // 2: read and write end
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        ColdStartResult child;
+        auto rssBefore = GetRssKb();
+        auto start = std::chrono::steady_clock::now();
+        auto reg = std::make_shared<PluginRegister>();
+        reg->RegisterPluginsFromPath(HST_PLUGIN_PATH, manifestPath);
+        child.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        child.rssKb = GetRssKb() - rssBefore;
+        child.pluginCount = reg->GetAllRegisteredPluginCount();
+        child.mappedLibraries = CountMappedPluginLibraries();
+        auto demuxers = reg->ListPlugins(PluginType::DEMUXER);
+        if (!demuxers.empty()) {
+            auto regInfo = reg->GetPluginRegInfo(PluginType::DEMUXER, demuxers.front());
+            child.created = regInfo != nullptr && regInfo->creator != nullptr && regInfo->sniffer != nullptr;
+            child.mappedAfterCreate = CountMappedPluginLibraries();
+        }
+        (void)write(fds[1], &child, sizeof(child));
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        (void)read(fds[0], &result, sizeof(result));
+        (void)waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return result;
+}
+
+struct MemoryDataSource : DataSource {
+    explicit MemoryDataSource(std::string bytes) : data(std::move(bytes)) {}
+
+    Status ReadAt(int64_t offset, std::shared_ptr<Buffer>& buffer, size_t expectedLen) override
+    {
+        if (buffer == nullptr || buffer->GetMemory() == nullptr || offset < 0 ||
+            static_cast<size_t>(offset) >= data.size()) {
+            return Status::END_OF_STREAM;
+        }
+        auto len = std::min(expectedLen, data.size() - static_cast<size_t>(offset));
+        buffer->GetMemory()->Write(reinterpret_cast<const uint8_t*>(data.data()) + offset, len, 0);
+        return Status::OK;
+    }
+
+    Status GetSize(uint64_t& size) override
+    {
+        size = data.size();
+        return Status::OK;
+    }
+
+    Seekable GetSeekable() override
+    {
+        return Seekable::SEEKABLE;
+    }
+
+    std::string data;
+};
+
+struct SniffHintResult {
+    int32_t hintedDemuxers {0};
+    int32_t loadedOnMismatch {0};
+    int32_t loadedOnMatch {0};
+};
+
+// sniffs every demuxer having hints with a source matching none of them, then with one matching its first hint
+SniffHintResult SniffWithHints(const std::string& manifestPath)
+{
+    SniffHintResult result;
+    int fds[2] = {-1, -1}; // 2: read and write end
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        SniffHintResult child;
+        auto reg = std::make_shared<PluginRegister>();
+        reg->RegisterPluginsFromPath(HST_PLUGIN_PATH, manifestPath);
+        auto& manager = PluginManager::Instance();
+        manager.pluginRegister_ = reg;
+        for (const auto& name : reg->ListPlugins(PluginType::DEMUXER)) {
+            auto regInfo = reg->FindPluginRegInfo(PluginType::DEMUXER, name);
+            auto it = regInfo->info->extra.find(PLUGIN_INFO_EXTRA_SNIFF_HINTS);
+            if (regInfo->library == nullptr || it == regInfo->info->extra.end()) {
+                continue;
+            }
+            auto hint = AnyCast<std::vector<std::string>>(it->second).front();
+            auto pos = hint.find(':');
+            auto offset = std::stoull(hint.substr(0, pos));
+            child.hintedDemuxers++;
+            (void)manager.Sniffer(name, std::make_shared<MemoryDataSource>(std::string(offset + hint.size(), '\0')));
+            child.loadedOnMismatch += regInfo->library->loaded ? 1 : 0;
+            (void)manager.Sniffer(name, std::make_shared<MemoryDataSource>(std::string(offset, '\0') +
+                hint.substr(pos + 1)));
+            child.loadedOnMatch += regInfo->library->loaded ? 1 : 0;
+        }
+        (void)write(fds[1], &child, sizeof(child));
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        (void)read(fds[0], &result, sizeof(result));
+        (void)waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return result;
+}
+
+// the build step, in a child process so that the libraries it opens are not mapped in later children
+bool GenerateManifest(const std::string& manifestPath)
+{
+    pid_t pid = fork();
+    if (pid == 0) {
+        auto reg = std::make_shared<PluginRegister>();
+        _exit(reg->GeneratePluginManifest(HST_PLUGIN_PATH, manifestPath) ? 0 : 1);
+    }
+    int status = -1;
+    return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+} // namespace
+
+class PluginManifestUnitTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+
+    static void TearDownTestCase(void) {}
+
+    void SetUp(void) {}
+
+    void TearDown(void)
+    {
+        (void)remove(MANIFEST_PATH.c_str());
+    }
+};
+
+/**
+ * @tc.name: Manifest_RoundTrip
+ * @tc.desc: plugin info, caps and extra info keep their values and exact types through the manifest
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManifestUnitTest, Manifest_RoundTrip, TestSize.Level1)
+{
+    PluginManifestLibrary library;
+    library.fileName = "libmedia_plugin_ut.z.so";
+    library.fileSize = 4096; // 4096: size
+    library.modifyTime = 1700000000; // 1700000000: mtime
+    library.package = {PLUGIN_INTERFACE_VERSION, "ut", LicenseType::LGPL};
+    library.plugins.push_back(MakeCodecInfo());
+    ASSERT_TRUE(PluginManifest::Save(MANIFEST_PATH, {library}));
+
+    std::map<std::string, PluginManifestLibrary> loaded;
+    ASSERT_TRUE(PluginManifest::Load(MANIFEST_PATH, loaded));
+    ASSERT_EQ(loaded.count(library.fileName), 1u);
+    const auto& entry = loaded[library.fileName];
+    EXPECT_EQ(entry.fileSize, library.fileSize);
+    EXPECT_EQ(entry.modifyTime, library.modifyTime);
+    EXPECT_EQ(entry.package.name, "ut");
+    EXPECT_EQ(entry.package.licenseType, LicenseType::LGPL);
+    ASSERT_EQ(entry.plugins.size(), 1u);
+    auto info = entry.plugins[0];
+    EXPECT_EQ(info->pluginType, PluginType::AUDIO_DECODER);
+    EXPECT_EQ(info->name, "ut decoder");
+    EXPECT_EQ(info->description, "100% test, ~not real~\n");
+    EXPECT_EQ(info->rank, 100u);
+    EXPECT_EQ(AnyCast<CodecMode>(info->extra[PLUGIN_INFO_EXTRA_CODEC_MODE]), CodecMode::HARDWARE);
+    ASSERT_EQ(info->inCaps.size(), 1u);
+    auto& keys = info->inCaps[0].keys;
+    EXPECT_EQ(info->inCaps[0].mime, MimeType::AUDIO_MPEG);
+    EXPECT_EQ(AnyCast<uint32_t>(keys[Tag::AUDIO_MPEG_VERSION]), 1u);
+    auto rates = AnyCast<IntervalCapability<uint32_t>>(keys[Tag::AUDIO_SAMPLE_RATE]);
+    EXPECT_EQ(rates.first, 8000u);
+    EXPECT_EQ(rates.second, 48000u);
+    auto formats = AnyCast<DiscreteCapability<AudioSampleFormat>>(keys[Tag::AUDIO_SAMPLE_FORMAT]);
+    ASSERT_EQ(formats.size(), 2u);
+    EXPECT_EQ(formats[1], AudioSampleFormat::SAMPLE_F32LE);
+    ASSERT_EQ(info->outCaps.size(), 1u);
+    EXPECT_EQ(AnyCast<std::string>(info->outCaps[0].keys["ut.empty"]), "");
+}
+
+/**
+ * @tc.name: Manifest_UnsupportedValue
+ * @tc.desc: a library holding a value of unknown type is left out, and is registered by loading it
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManifestUnitTest, Manifest_UnsupportedValue, TestSize.Level1)
+{
+    PluginManifestLibrary library;
+    library.fileName = "libmedia_plugin_unknown.z.so";
+    auto info = MakeCodecInfo();
+    info->inCaps[0].keys["ut.unknown"] = UnknownValue {1};
+    library.plugins.push_back(info);
+    std::string text;
+    EXPECT_FALSE(PluginManifest::Encode(library, text));
+    EXPECT_TRUE(text.empty());
+
+    ASSERT_TRUE(PluginManifest::Save(MANIFEST_PATH, {library}));
+    std::map<std::string, PluginManifestLibrary> loaded;
+    ASSERT_TRUE(PluginManifest::Load(MANIFEST_PATH, loaded));
+    EXPECT_TRUE(loaded.empty());
+}
+
+/**
+ * @tc.name: Manifest_Malformed
+ * @tc.desc: a corrupted manifest is rejected as a whole
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManifestUnitTest, Manifest_Malformed, TestSize.Level1)
+{
+    {
+        std::ofstream file(MANIFEST_PATH);
+        file << "MEDIA_PLUGIN_MANIFEST 1\nplugin 1 1 1 orphan ~\n";
+    }
+    std::map<std::string, PluginManifestLibrary> loaded;
+    EXPECT_FALSE(PluginManifest::Load(MANIFEST_PATH, loaded));
+    EXPECT_FALSE(PluginManifest::Load("/data/test/not_exist.manifest", loaded));
+}
+
+/**
+ * @tc.name: Manifest_Prebuilt
+ * @tc.desc: an entry generated at build time has no size and mtime, it stays valid as long as the library exists
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManifestUnitTest, Manifest_Prebuilt, TestSize.Level1)
+{
+    {
+        std::ofstream file(MANIFEST_PATH);
+        file << "stands in for a library";
+    }
+    PluginManifestLibrary library;
+    EXPECT_TRUE(PluginManifest::IsUpToDate(library, MANIFEST_PATH));
+    EXPECT_FALSE(PluginManifest::IsUpToDate(library, "/data/test/not_exist.z.so"));
+    library.fileSize = 1; // 1: a size the file does not have
+    EXPECT_FALSE(PluginManifest::IsUpToDate(library, MANIFEST_PATH));
+}
+
+/**
+ * @tc.name: Manifest_ColdStart
+ * @tc.desc: registration never writes the manifest, the one generated by the build step registers the same plugins
+ *           and opens no library until a plugin is used
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManifestUnitTest, Manifest_ColdStart, TestSize.Level1)
+{
+    (void)remove(MANIFEST_PATH.c_str());
+    auto eager = MeasureColdStart(MANIFEST_PATH);
+    if (eager.pluginCount == 0) {
+        GTEST_SKIP() << "no dynamic plugin found in " << HST_PLUGIN_PATH;
+    }
+    EXPECT_NE(access(MANIFEST_PATH.c_str(), F_OK), 0);
+    ASSERT_TRUE(GenerateManifest(MANIFEST_PATH));
+    std::map<std::string, PluginManifestLibrary> written;
+    ASSERT_TRUE(PluginManifest::Load(MANIFEST_PATH, written));
+    ASSERT_FALSE(written.empty());
+    EXPECT_EQ(written.begin()->second.fileSize, 0);
+    auto lazy = MeasureColdStart(MANIFEST_PATH);
+    std::cout << "eager: " << eager.elapsedUs << "us, rss +" << eager.rssKb << "KB, " << eager.mappedLibraries
+              << " libraries mapped" << std::endl;
+    std::cout << "manifest: " << lazy.elapsedUs << "us, rss +" << lazy.rssKb << "KB, " << lazy.mappedLibraries
+              << " libraries mapped" << std::endl;
+    EXPECT_EQ(lazy.pluginCount, eager.pluginCount);
+    EXPECT_GT(eager.mappedLibraries, 0);
+    EXPECT_EQ(lazy.mappedLibraries, 0);
+    EXPECT_EQ(lazy.created, eager.created);
+    if (lazy.created) {
+        EXPECT_GT(lazy.mappedAfterCreate, 0);
+        EXPECT_LE(lazy.mappedAfterCreate, eager.mappedLibraries);
+    }
+}
+
+/**
+ * @tc.name: Manifest_SniffHints
+ * @tc.desc: sniff hints keep their bytes through the manifest, a demuxer is not loaded for a source matching none
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManifestUnitTest, Manifest_SniffHints, TestSize.Level1)
+{
+    PluginDefBase def;
+    def.AddSniffHint(4, "ftyp"); // 4: offset of the box type
+    def.AddSniffHint(0, std::string("\x1A\x45\xDF\xA3 \0", 6)); // 6: magic with a space and a zero byte
+    PluginManifestLibrary library;
+    library.fileName = "libmedia_plugin_hint.z.so";
+    auto info = std::make_shared<PluginInfo>();
+    info->pluginType = PluginType::DEMUXER;
+    info->name = "ut demuxer";
+    info->extra[PLUGIN_INFO_EXTRA_SNIFF_HINTS] = def.GetSniffHints();
+    library.plugins.push_back(info);
+    ASSERT_TRUE(PluginManifest::Save(MANIFEST_PATH, {library}));
+    std::map<std::string, PluginManifestLibrary> loaded;
+    ASSERT_TRUE(PluginManifest::Load(MANIFEST_PATH, loaded));
+    ASSERT_EQ(loaded[library.fileName].plugins.size(), 1u);
+    auto hints = AnyCast<std::vector<std::string>>(loaded[library.fileName].plugins[0]->extra[
+        PLUGIN_INFO_EXTRA_SNIFF_HINTS]);
+    EXPECT_EQ(hints, def.GetSniffHints());
+    EXPECT_EQ(hints[0], "4:ftyp");
+
+    auto result = GenerateManifest(MANIFEST_PATH) ? SniffWithHints(MANIFEST_PATH) : SniffHintResult {};
+    if (result.hintedDemuxers == 0) {
+        GTEST_SKIP() << "no demuxer with sniff hints found in " << HST_PLUGIN_PATH;
+    }
+    EXPECT_EQ(result.loadedOnMismatch, 0);
+    EXPECT_EQ(result.loadedOnMatch, result.hintedDemuxers);
+}
+} // namespace PluginManifestUT
+} // namespace Media
+} // namespace OHOS